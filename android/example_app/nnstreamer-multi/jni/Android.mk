@@ -31,8 +31,14 @@ include $(LOCAL_PATH)/Android-nnstreamer.mk
 #------------------------------------------------------
 include $(CLEAR_VARS)
 
+NNS_EX_COMMON_DIR := $(LOCAL_PATH)/../../../../native/common
+
 LOCAL_MODULE    := nnstreamer-jni
-LOCAL_SRC_FILES := nnstreamer-jni.c nnstreamer-ex.cpp
+LOCAL_SRC_FILES := nnstreamer-jni.c nnstreamer-ex.cpp \
+    $(NNS_EX_COMMON_DIR)/nns_ex_sched.c \
+    $(NNS_EX_COMMON_DIR)/nns_ex_model_sched.c \
+    $(NNS_EX_COMMON_DIR)/nns_ex_pose.c
+LOCAL_C_INCLUDES := $(NNS_EX_COMMON_DIR)
 LOCAL_STATIC_LIBRARIES := nnstreamer tensorflow-lite cpufeatures ahc
 LOCAL_SHARED_LIBRARIES := gstreamer_android
 LOCAL_LDLIBS := -llog -landroid -lcamera2ndk -lmediandk
@@ -18,6 +18,9 @@
 #include <cairo/cairo.h>
 
 #include "nnstreamer-jni.h"
+#include "nns_ex_pose.h"
+#include "nns_ex_sched.h"
+#include "nns_ex_model_sched.h"
 
 #define EX_MODEL_PATH "/sdcard/nnstreamer/tflite_model"
 
@@ -66,6 +69,11 @@
 #define POSE_OUT_W          96
 #define POSE_OUT_H          96
 
+/**
+ * @brief Max distance (in the cells) from the parent keypoint, to group the keypoints of a person.
+ */
+#define POSE_RADIUS         (POSE_OUT_H / 4.0f)
+
 /**
  * @brief Max objects to be displayed in the screen.
  * The application will draw the boxes and labels of detected objects with this limitation.
@@ -112,10 +120,19 @@ static gint launch_option = 0;
 static nns_ex_model_info_s nns_ex_model_info;
 static GMutex res_mutex;
 static gchar *pipeline_description = NULL;
+static nns_ex_sched_s *pipeline_sched = NULL;
+static nns_ex_model_sched_s *pipeline_model_sched = NULL;
 static std::vector<ssd_object_s> detected_face;
 static std::vector<ssd_object_s> detected_hand;
 static std::vector<ssd_object_s> detected_object;
-static std::vector<pose_s> estimated_pose;
+static std::vector<pose_s> estimated_pose; /**< POSE_SIZE keypoints of each person */
+
+/**
+ * @brief Parent of each keypoint, the lines of pose estimation (the root is the neck).
+ */
+static const gint pose_parents[POSE_SIZE] = {
+  1, -1, 1, 2, 3, 1, 5, 6, 1, 8, 9, 1, 11, 12
+};
 
 /**
  * @brief Read strings from file.
@@ -197,6 +214,37 @@ nns_ex_load_labels (void)
   return TRUE;
 }
 
+/**
+ * @brief Log the statistics of each detection model, before the scheduler is released.
+ */
+static void
+nns_ex_log_model_sched (void)
+{
+  static const gchar *models[] = { "face", "hand", "obj" };
+  nns_ex_model_sched_stats_s stats;
+  GstClockTime avg;
+  guint i;
+
+  if (pipeline_model_sched == NULL)
+    return;
+
+  for (i = 0; i < G_N_ELEMENTS (models); i++) {
+    if (!nns_ex_model_sched_get_stats (pipeline_model_sched, models[i], &stats))
+      continue;
+
+    avg = (stats.completed > 0) ? stats.total_latency / stats.completed : 0;
+
+    nns_logi ("[%s] target %.1f fps, achieved %.1f fps, invoked %"
+        G_GUINT64_FORMAT ", completed %" G_GUINT64_FORMAT ", skipped %"
+        G_GUINT64_FORMAT ", deferred %" G_GUINT64_FORMAT ", lost %"
+        G_GUINT64_FORMAT ", latency avg %" G_GUINT64_FORMAT " ms max %"
+        G_GUINT64_FORMAT " ms", models[i], stats.target_fps,
+        stats.achieved_fps, stats.invoked, stats.completed, stats.skipped,
+        stats.deferred, stats.lost, GST_TIME_AS_MSECONDS (avg),
+        GST_TIME_AS_MSECONDS (stats.max_latency));
+  }
+}
+
 /**
  * @brief Free pipeline info.
  */
@@ -218,6 +266,17 @@ nns_ex_free (void)
     nns_ex_model_info.labels_hand = NULL;
   }
 
+  if (pipeline_sched) {
+    nns_ex_sched_free (pipeline_sched);
+    pipeline_sched = NULL;
+  }
+
+  if (pipeline_model_sched) {
+    nns_ex_log_model_sched ();
+    nns_ex_model_sched_free (pipeline_model_sched);
+    pipeline_model_sched = NULL;
+  }
+
   g_mutex_clear (&res_mutex);
   g_free (pipeline_description);
 
@@ -545,11 +604,14 @@ pose_update_result (std::vector<pose_s> &detected)
  * @brief Draw line of pose estimation.
  */
 static void
-pose_draw_line (cairo_t * cr, std::vector<pose_s> &detected,
+pose_draw_line (cairo_t * cr, std::vector<pose_s> &detected, guint base,
     guint start, guint end)
 {
   gdouble xs, ys, xe, ye;
 
+  start += base;
+  end += base;
+
   if (detected[start].valid && detected[end].valid) {
     xs = detected[start].x * MEDIA_WIDTH / POSE_OUT_W;
     ys = detected[start].y * MEDIA_HEIGHT / POSE_OUT_H;
@@ -571,12 +633,13 @@ pose_draw (cairo_t * cr)
 {
   std::vector<pose_s> detected;
   gdouble x, y;
+  guint base;
 
   g_mutex_lock (&res_mutex);
   detected = estimated_pose;
   g_mutex_unlock (&res_mutex);
 
-  if (detected.size () != POSE_SIZE) {
+  if (detected.size () % POSE_SIZE != 0) {
     nns_logd ("Current vector size is %zd", detected.size ());
     return;
   }
@@ -584,29 +647,22 @@ pose_draw (cairo_t * cr)
   cairo_set_source_rgb (cr, 1.0, 1.0, 1.0);
   cairo_set_line_width (cr, 3.0);
 
-  /* line */
-  pose_draw_line (cr, detected, 0, 1);
-  pose_draw_line (cr, detected, 1, 2);
-  pose_draw_line (cr, detected, 2, 3);
-  pose_draw_line (cr, detected, 3, 4);
-  pose_draw_line (cr, detected, 1, 5);
-  pose_draw_line (cr, detected, 5, 6);
-  pose_draw_line (cr, detected, 6, 7);
-  pose_draw_line (cr, detected, 1, 8);
-  pose_draw_line (cr, detected, 8, 9);
-  pose_draw_line (cr, detected, 9, 10);
-  pose_draw_line (cr, detected, 1, 11);
-  pose_draw_line (cr, detected, 11, 12);
-  pose_draw_line (cr, detected, 12, 13);
-
-  /* dot */
-  for (guint i = 0; i < POSE_SIZE; ++i) {
-    if (detected[i].valid) {
-      x = detected[i].x * MEDIA_WIDTH / POSE_OUT_W;
-      y = detected[i].y * MEDIA_HEIGHT / POSE_OUT_H;
-
-      cairo_arc (cr, x, y, 5, 0, 2 * M_PI);
-      cairo_fill (cr);
+  for (base = 0; base < detected.size (); base += POSE_SIZE) {
+    /* line */
+    for (guint i = 0; i < POSE_SIZE; ++i) {
+      if (pose_parents[i] >= 0)
+        pose_draw_line (cr, detected, base, pose_parents[i], i);
+    }
+
+    /* dot */
+    for (guint i = base; i < base + POSE_SIZE; ++i) {
+      if (detected[i].valid) {
+        x = detected[i].x * MEDIA_WIDTH / POSE_OUT_W;
+        y = detected[i].y * MEDIA_HEIGHT / POSE_OUT_H;
+
+        cairo_arc (cr, x, y, 5, 0, 2 * M_PI);
+        cairo_fill (cr);
+      }
     }
   }
 }
@@ -620,9 +676,9 @@ nns_ex_parse_pose (GstBuffer * buffer)
   GstMemory *mem_pose;
   GstMapInfo info_pose;
   gfloat *pose_data;
-  guint index, i, j;
-  guint maxX, maxY;
-  gfloat max, cen;
+  guint index, n_peaks, n_persons, person;
+  nns_ex_pose_peak_s peaks[NNS_EX_POSE_MAX_PEAKS];
+  nns_ex_pose_instance_s persons[NNS_EX_POSE_MAX_INSTANCES];
   std::vector<pose_s> detected;
 
   if (gst_buffer_n_memory (buffer) != 1) {
@@ -635,30 +691,23 @@ nns_ex_parse_pose (GstBuffer * buffer)
 
   pose_data = (gfloat *) info_pose.data;
 
-  for (index = 0; index < POSE_SIZE; ++index) {
-    maxX = maxY = 0;
-    max = .0f;
-
-    for (j = 0; j < POSE_OUT_H; ++j) {
-      for (i = 0; i < POSE_OUT_W; ++i) {
-        cen = pose_data[i * POSE_SIZE + j * POSE_OUT_W * POSE_SIZE + index];
-
-        if (cen > max) {
-          max = cen;
-          maxX = i;
-          maxY = j;
-        }
-      }
-    }
+  /* local peaks of all keypoints in a single pass over the heatmap (HWC), and the persons */
+  n_peaks = nns_ex_pose_find_local_peaks (pose_data, POSE_OUT_W, POSE_OUT_H,
+      POSE_SIZE, .5f, peaks, NNS_EX_POSE_MAX_PEAKS);
+  n_persons = nns_ex_pose_group (peaks, n_peaks, POSE_SIZE, pose_parents,
+      POSE_RADIUS, persons, NNS_EX_POSE_MAX_INSTANCES);
 
-    pose_s p;
+  for (person = 0; person < n_persons; ++person) {
+    for (index = 0; index < POSE_SIZE; ++index) {
+      pose_s p;
 
-    p.valid = FALSE;
-    p.x = maxX;
-    p.y = maxY;
-    p.prob = max;
+      p.valid = FALSE;
+      p.x = persons[person].keypoints[index].x;
+      p.y = persons[person].keypoints[index].y;
+      p.prob = persons[person].keypoints[index].score;
 
-    detected.push_back (p);
+      detected.push_back (p);
+    }
   }
 
   gst_memory_unmap (mem_pose, &info_pose);
@@ -899,6 +948,84 @@ nns_ex_set_description (const gint option)
   pipeline_description = str_desc;
 }
 
+/**
+ * @brief Set the thread scheduling of each branch.
+ * @note The inference branches keep the normal priority and the display runs last (nice 10), like the two tensor stream example,
+ * so rendering the camera cannot starve the models. A late frame of the display is dropped by the sink.
+ */
+static void
+nns_ex_set_sched (GstElement * pipeline, const gint option)
+{
+  /* release the scheduler of previous pipeline */
+  if (pipeline_sched)
+    nns_ex_sched_free (pipeline_sched);
+
+  pipeline_sched = nns_ex_sched_new ();
+
+  nns_ex_sched_add_branch (pipeline_sched, "display", "q_display", "img_sink",
+      NULL, NNS_EX_SCHED_POLICY_OTHER, 10, 33 * GST_MSECOND);
+
+  if (IS_POSE (option))
+    nns_ex_sched_add_branch (pipeline_sched, "pose", "q_pose", "res_pose",
+        NULL, NNS_EX_SCHED_POLICY_OTHER, 0, 200 * GST_MSECOND);
+
+  if (IS_FACE (option) || IS_HAND (option) || IS_OBJ (option))
+    nns_ex_sched_add_branch (pipeline_sched, "ssd", "q_ssd", NULL, NULL,
+        NNS_EX_SCHED_POLICY_OTHER, 0, GST_CLOCK_TIME_NONE);
+
+  if (IS_FACE (option))
+    nns_ex_sched_add_branch (pipeline_sched, "face", "q_face", "res_face",
+        NULL, NNS_EX_SCHED_POLICY_OTHER, 0, 200 * GST_MSECOND);
+
+  if (IS_HAND (option))
+    nns_ex_sched_add_branch (pipeline_sched, "hand", "q_hand", "res_hand",
+        NULL, NNS_EX_SCHED_POLICY_OTHER, 0, 200 * GST_MSECOND);
+
+  if (IS_OBJ (option))
+    nns_ex_sched_add_branch (pipeline_sched, "obj", "q_obj", "res_obj",
+        NULL, NNS_EX_SCHED_POLICY_OTHER, 0, 200 * GST_MSECOND);
+
+  if (!nns_ex_sched_attach (pipeline_sched, pipeline)) {
+    nns_loge ("Failed to set the thread scheduling.");
+  }
+}
+
+/**
+ * @brief Set the frame rate and priority of the detection models sharing the ssd tensor.
+ * @note The models run on 2 workers, and a model starts on a frame at most, so the models are staggered across the frames.
+ */
+static void
+nns_ex_set_model_sched (GstElement * pipeline, const gint option)
+{
+  /* release the scheduler of previous pipeline */
+  if (pipeline_model_sched) {
+    nns_ex_log_model_sched ();
+    nns_ex_model_sched_free (pipeline_model_sched);
+    pipeline_model_sched = NULL;
+  }
+
+  if (!IS_FACE (option) && !IS_HAND (option) && !IS_OBJ (option))
+    return;
+
+  pipeline_model_sched = nns_ex_model_sched_new (2, 1);
+
+  if (IS_FACE (option))
+    nns_ex_model_sched_add_model (pipeline_model_sched, "face", "q_face",
+        "filter_face", 10.0, 3);
+
+  if (IS_HAND (option))
+    nns_ex_model_sched_add_model (pipeline_model_sched, "hand", "q_hand",
+        "filter_hand", 10.0, 2);
+
+  if (IS_OBJ (option))
+    nns_ex_model_sched_add_model (pipeline_model_sched, "obj", "q_obj",
+        "filter_obj", 5.0, 1);
+
+  if (!nns_ex_model_sched_attach (pipeline_model_sched, pipeline, "tssd")) {
+    nns_loge ("Failed to set the model scheduling.");
+  }
+}
+
 /**
  * @brief Start pipeline.
  */
@@ -920,8 +1047,8 @@ nns_ex_launch_pipeline (GstElement ** pipeline, const gint option)
   str_pipeline = g_strdup_printf
       ("ahc2src camera-index=%d ! videoconvert ! video/x-raw,format=RGB,width=640,height=480,framerate=30/1 ! "
       "videoflip method=%s ! videocrop left=0 right=0 top=80 bottom=80 ! tee name=traw "
-      "traw. ! queue min-threshold-buffers=8 ! videoconvert ! "
-      "cairooverlay name=res_cairooverlay ! glimagesink sync=false ",
+      "traw. ! queue name=q_display min-threshold-buffers=8 ! videoconvert ! "
+      "cairooverlay name=res_cairooverlay ! glimagesink name=img_sink sync=false ",
       (front_cam) ? 1 : 0, (front_cam) ? "upper-right-diagonal" : "clockwise");
 
   if (option) {
@@ -932,7 +1059,7 @@ nns_ex_launch_pipeline (GstElement ** pipeline, const gint option)
        * output[0] float32 [14:96:96:1] (POSE_SIZE:POSE_OUT_W:POSE_OUT_H:1)
        */
       extra = g_strdup_printf
-          ("traw. ! queue leaky=2 max-size-buffers=2 ! videoscale ! video/x-raw,format=RGB,width=192,height=192 ! "
+          ("traw. ! queue name=q_pose leaky=2 max-size-buffers=2 ! videoscale ! video/x-raw,format=RGB,width=192,height=192 ! "
           "tensor_converter ! tensor_transform mode=typecast option=float32 ! "
           "tensor_filter framework=tensorflow-lite model=%s ! tensor_sink name=res_pose ",
           EX_POSE_MODEL);
@@ -944,7 +1071,7 @@ nns_ex_launch_pipeline (GstElement ** pipeline, const gint option)
        * object detection base (videoscale 480x480 > 300x300)
        */
       extra = g_strdup_printf
-          ("traw. ! queue ! videoscale ! video/x-raw,format=RGB,width=300,height=300 ! "
+          ("traw. ! queue name=q_ssd ! videoscale ! video/x-raw,format=RGB,width=300,height=300 ! "
           "tensor_converter ! tensor_transform mode=arithmetic option=typecast:float32,add:-127.5,div:127.5 ! "
           "tee name=tssd ", SSD_MODEL_WIDTH, SSD_MODEL_HEIGHT);
       str_pipeline = nns_ex_append_text (str_pipeline, extra);
@@ -957,8 +1084,8 @@ nns_ex_launch_pipeline (GstElement ** pipeline, const gint option)
          * output[1] float32 [2:1917:1:1] (LABEL_SIZE:SSD_DETECTION_MAX:1:1)
          */
         extra = g_strdup_printf
-            ("tssd. ! queue leaky=2 max-size-buffers=2 ! "
-            "tensor_filter framework=tensorflow-lite model=%s ! tensor_sink name=res_face ",
+            ("tssd. ! queue name=q_face leaky=2 max-size-buffers=2 ! "
+            "tensor_filter name=filter_face framework=tensorflow-lite model=%s ! tensor_sink name=res_face ",
             EX_FACE_MODEL);
         str_pipeline = nns_ex_append_text (str_pipeline, extra);
       }
@@ -971,8 +1098,8 @@ nns_ex_launch_pipeline (GstElement ** pipeline, const gint option)
          * output[1] float32 [2:1917:1:1] (LABEL_SIZE:SSD_DETECTION_MAX:1:1)
          */
         extra = g_strdup_printf
-            ("tssd. ! queue leaky=2 max-size-buffers=2 ! "
-            "tensor_filter framework=tensorflow-lite model=%s ! tensor_sink name=res_hand ",
+            ("tssd. ! queue name=q_hand leaky=2 max-size-buffers=2 ! "
+            "tensor_filter name=filter_hand framework=tensorflow-lite model=%s ! tensor_sink name=res_hand ",
             EX_HAND_MODEL);
         str_pipeline = nns_ex_append_text (str_pipeline, extra);
       }
@@ -985,8 +1112,8 @@ nns_ex_launch_pipeline (GstElement ** pipeline, const gint option)
          * output[1] float32 [91:1917:1:1] (LABEL_SIZE:SSD_DETECTION_MAX:1:1)
          */
         extra = g_strdup_printf
-            ("tssd. ! queue leaky=2 max-size-buffers=2 ! "
-            "tensor_filter framework=tensorflow-lite model=%s ! tensor_sink name=res_obj ",
+            ("tssd. ! queue name=q_obj leaky=2 max-size-buffers=2 ! "
+            "tensor_filter name=filter_obj framework=tensorflow-lite model=%s ! tensor_sink name=res_obj ",
             EX_OBJ_MODEL);
         str_pipeline = nns_ex_append_text (str_pipeline, extra);
       }
@@ -1039,6 +1166,12 @@ nns_ex_launch_pipeline (GstElement ** pipeline, const gint option)
   g_signal_connect (element, "draw", G_CALLBACK (nns_ex_draw_overlay_cb), NULL);
   gst_object_unref (element);
 
+  /* thread scheduling of each branch, before the pipeline starts */
+  nns_ex_set_sched (*pipeline, option);
+
+  /* frame rate and priority of each detection model */
+  nns_ex_set_model_sched (*pipeline, option);
+
   return TRUE;
 }
 
@@ -46,8 +46,18 @@ $(foreach item,$(NNSTREAMER_BUILDING_BLOCK_LIST),$(eval $(call shared_lib,$(item
 
 include $(CLEAR_VARS)
 
+NNS_EX_COMMON_DIR := $(LOCAL_PATH)/../../../native/common
+
 LOCAL_MODULE    := nnstreamer_multidevice
-LOCAL_SRC_FILES := nnstreamer-ssd.cpp NNStreamerMultiDevice.c
+LOCAL_SRC_FILES := nnstreamer-ssd.cpp NNStreamerMultiDevice.c \
+    $(NNS_EX_COMMON_DIR)/nns_ex_pose.c \
+    $(NNS_EX_COMMON_DIR)/nns_ex_preprocess.c \
+    $(NNS_EX_COMMON_DIR)/nns_ex_roi.c \
+    $(NNS_EX_COMMON_DIR)/nns_ex_roi_mask.c \
+    $(NNS_EX_COMMON_DIR)/nns_ex_tensorize.c \
+    $(NNS_EX_COMMON_DIR)/nns_ex_transport.c \
+    $(NNS_EX_COMMON_DIR)/nns_ex_tensor_pay.c \
+    $(NNS_EX_COMMON_DIR)/nns_ex_tensor_depay.c
 LOCAL_CFLAGS += -O2 -DGST_USE_UNSTABLE_API -fPIC
 LOCAL_SHARED_LIBRARIES := $(GST_BUILDING_BLOCK_LIST) gstreamer_android ahc2src
 
@@ -58,7 +68,8 @@ LOCAL_C_INCLUDES := \
      $(GSTREAMER_ROOT)/include/gstreamer-1.0 \
      $(GSTREAMER_ROOT)/include/glib-2.0 \
      $(GSTREAMER_ROOT)/lib/glib-2.0/include \
-     $(GSTREAMER_ROOT)/include
+     $(GSTREAMER_ROOT)/include \
+     $(NNS_EX_COMMON_DIR)
 
 
 include $(BUILD_SHARED_LIBRARY)
@@ -67,7 +78,9 @@ include $(BUILD_SHARED_LIBRARY)
 include $(CLEAR_VARS)
 
 LOCAL_MODULE := ahc2src
-LOCAL_SRC_FILES := gstahc2src.c
+LOCAL_SRC_FILES := gstahc2src.c \
+    $(NNS_EX_COMMON_DIR)/nns_ex_capture.c \
+    $(NNS_EX_COMMON_DIR)/nns_ex_tensor_ring.c
 LOCAL_SHARED_LIBRARIES := $(NNSTREAMER_BUILDING_BLOCK_LIST)
 LOCAL_CFLAGS += -O2 -DGST_USE_UNSTABLE_API
 LOCAL_LDLIBS := -llog -landroid -lcamera2ndk -lmediandk -lz
@@ -76,7 +89,8 @@ LOCAL_C_INCLUDES := \
       $(GSTREAMER_ROOT)/include/gstreamer-1.0 \
       $(GSTREAMER_ROOT)/include/glib-2.0 \
       $(GSTREAMER_ROOT)/lib/glib-2.0/include \
-      $(GSTREAMER_ROOT)/include
+      $(GSTREAMER_ROOT)/include \
+      $(NNS_EX_COMMON_DIR)
 
 include $(BUILD_SHARED_LIBRARY)
 
@@ -9,6 +9,18 @@
  * /sdcard/nnstreamer/tflite_model/
  *
  * This example run simple pipeline through Three devices using tcpclientsrc & tcpserversink
+ * The raw frames are sent with the caps, sequence number and timestamp (nns_ex_tensor_pay & nns_ex_tensor_depay),
+ * without the JPEG encoding and decoding in each device. Define MULTI_DEVICE_JPEG to send the JPEG images
+ * (less bandwidth on the slow network).
+ *
+ * Define MULTI_DEVICE_SPLIT_TENSOR to split the pipeline after the preprocessing : Device 1 converts the frame
+ * to the uint8 input tensor of SSD (3:300:300, nns_ex_tensorize) and sends the tensor only,
+ * and Device 2 runs tensor_filter after the dequantization, without the scaling and conversion.
+ * Device 2 shows the tensor as the video (tensor_decoder mode=direct_video) and crops the person from it.
+ * See nnstreamer_benchmark_split for the bytes and CPU time of each split point.
+ *
+ * Device 2 fills the pixels out of the box of the person with black (nns_ex_roi_mask) before sending the frame,
+ * the box is updated with the 'region' property (see nnstreamer_benchmark_roi_mask).
  *
  * [ Device 1 ]
  * Get Camera Input and do preprocessing with input ( videoconvert & videoscale )
@@ -31,6 +43,10 @@
 #include <pthread.h>
 #include <cairo/cairo.h>
 #include "nnstreamer-ssd.h"
+#include "nns_ex_pose.h"
+#include "nns_ex_roi_mask.h"
+#include "nns_ex_tensorize.h"
+#include "nns_ex_transport.h"
 
 GST_DEBUG_CATEGORY_STATIC (debug_category);
 #define GST_CAT_DEFAULT debug_category
@@ -42,6 +58,27 @@ GST_DEBUG_CATEGORY_STATIC (debug_category);
 #define MEDIA_WIDTH 480
 #define MEDIA_HEIGHT 480
 
+/**
+ * @brief Elements to send and receive the frames between the devices.
+ */
+#ifdef MULTI_DEVICE_JPEG
+#define FRAME_SEND "jpegenc qos=true"
+#define FRAME_RECEIVE "image/jpeg, framerate=30/1 ! jpegparse ! jpegdec"
+#else
+#define FRAME_SEND "nns_ex_tensor_pay"
+#define FRAME_RECEIVE "nns_ex_tensor_depay"
+#endif
+
+/**
+ * @brief Split point between Device 1 and Device 2.
+ * The raw frame (Device 2 runs the preprocessing), or the quantized input tensor of SSD.
+ */
+#ifdef MULTI_DEVICE_SPLIT_TENSOR
+#define SPLIT_SEND "nns_ex_tensorize width=300 height=300 type=uint8 ! nns_ex_tensor_pay"
+#else
+#define SPLIT_SEND FRAME_SEND
+#endif
+
 
 /**
  * @brief These macros provide a way to store the native pointer to CustomData,
@@ -352,51 +389,18 @@ draw_overlay_cb (GstElement * overlay, cairo_t * cr, guint64 timestamp,
     cairo_fill_preserve (cr);
 
   }
-  if (new == 15)
+  if (new == 15) {
     new = 0;
-}
 
-/**
- * @brief Callback to draw the overlay.
- */
-static GstPadProbeReturn
-cb_have_data (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
-{
-  gint x, y;
-  GstMapInfo map, newmap;
-  GstMemory *mem;
-  guint8 *ptr, *newptr, t;
-  GstBuffer *buffer, *newbuffer;
-
-  buffer = GST_PAD_PROBE_INFO_BUFFER (info);
-  buffer = gst_buffer_make_writable (buffer);
-
-  if (buffer == NULL)
-    return GST_PAD_PROBE_OK;
-
-  if (gst_buffer_map (buffer, &map, GST_MAP_WRITE)) {
-    ptr = map.data;
-
-    for (y = 0; y < 480; y++) {
-      for (x = 0; x < 480; x++) {
-        if (x < person_x || y < person_y) {
-          ptr[y * 480 * 3 + x * 3] = 0;
-          ptr[y * 480 * 3 + x * 3 + 1] = 0;
-          ptr[y * 480 * 3 + x * 3 + 2] = 0;
-        }
-        if (x > person_x + person_width || y > person_y + person_height) {
-          ptr[y * 480 * 3 + x * 3] = 0;
-          ptr[y * 480 * 3 + x * 3 + 1] = 0;
-          ptr[y * 480 * 3 + x * 3 + 2] = 0;
-        }
-      }
+    /* keep the box of the largest person in the frame sent to Device 3 */
+    if (area > 0 && cropelement) {
+      gchar *region = g_strdup_printf ("%d,%d,%d,%d", MAX (person_x, 0),
+          MAX (person_y, 0), MAX (person_width, 0), MAX (person_height, 0));
+
+      g_object_set (cropelement, "region", region, NULL);
+      g_free (region);
     }
-    gst_buffer_unmap (buffer, &map);
   }
-
-  GST_PAD_PROBE_INFO_DATA (info) = buffer;
-
-  return GST_PAD_PROBE_OK;
 }
 
 /**
@@ -409,11 +413,9 @@ new_pose_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
   GstMemory *mem_pose;
   GstMapInfo info_pose;
   gfloat *pose_data;
-  guint index, i, j;
-  guint maxX, maxY;
-  gfloat max, cen;
+  guint index, i;
+  nns_ex_keypoint_s keypoints[POSE_SIZE];
   pose_s detected[POSE_SIZE];
-  pose_s *p;
   const gfloat threshold_score = .5f;
 
   if (gst_buffer_n_memory (buffer) != 1) {
@@ -425,23 +427,15 @@ new_pose_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
   gst_memory_map (mem_pose, &info_pose, GST_MAP_READ);
   pose_data = (gfloat *) info_pose.data;
 
+  /* single pass over the heatmap (HWC) for all keypoints */
+  nns_ex_pose_find_peaks (pose_data, POSE_OUT_W, POSE_OUT_H, POSE_SIZE, .0f,
+      keypoints);
+
   for (index = 0; index < POSE_SIZE; ++index) {
-    maxX = maxY = 0;
-    max = .0f;
-    for (j = 0; j < POSE_OUT_H; ++j) {
-      for (i = 0; i < POSE_OUT_W; ++i) {
-        cen = pose_data[i * POSE_SIZE + j * POSE_OUT_W * POSE_SIZE + index];
-        if (cen > max) {
-          max = cen;
-          maxX = i;
-          maxY = j;
-        }
-      }
-    }
     detected[index].valid = FALSE;
-    detected[index].x = maxX;
-    detected[index].y = maxY;
-    detected[index].prob = max;
+    detected[index].x = keypoints[index].x;
+    detected[index].y = keypoints[index].y;
+    detected[index].prob = keypoints[index].score;
   }
 
   gst_memory_unmap (mem_pose, &info_pose);
@@ -622,7 +616,6 @@ app_function (void *userdata)
   registry = gst_registry_get ();
   GList *list = gst_registry_get_plugin_list (registry);
   GList *l;
-  GstPad *pad;
   g_list_free (list);
 
   GST_DEBUG ("Creating pipeline in CustomData at %p", data);
@@ -639,34 +632,72 @@ app_function (void *userdata)
 
 
 
+#if !defined (MULTI_DEVICE_JPEG) || defined (MULTI_DEVICE_SPLIT_TENSOR)
+  if (!nns_ex_tensor_pay_register () || !nns_ex_tensor_depay_register ()) {
+    __android_log_print (ANDROID_LOG_ERROR, TAG_NAME,
+        "Failed to register the transport elements");
+    return NULL;
+  }
+#endif
+
+  if (!nns_ex_roi_mask_register ()) {
+    __android_log_print (ANDROID_LOG_ERROR, TAG_NAME,
+        "Failed to register the element %s", NNS_EX_ROI_MASK_NAME);
+    return NULL;
+  }
+
+#ifdef MULTI_DEVICE_SPLIT_TENSOR
+  if (!nns_ex_tensorize_register ()) {
+    __android_log_print (ANDROID_LOG_ERROR, TAG_NAME,
+        "Failed to register the element %s", NNS_EX_TENSORIZE_NAME);
+    return NULL;
+  }
+#endif
+
   switch (data->id) {
     case 0:
       str_pipeline =
           g_strdup_printf
           ("ahc2src camera-index=1 ! videoconvert ! video/x-raw, format=RGB, width=640, height=480, framerate=30/1 ! videoflip method=counterclockwise ! "
           "tee name=t "
-          "t. ! queue ! videocrop top=80 bottom=80 ! jpegenc qos=true ! tcpserversink host=%s port=%d sync=false "
+          "t. ! queue ! videocrop top=80 bottom=80 ! " SPLIT_SEND " ! tcpserversink host=%s port=%d sync=false "
           "t. ! videoconvert ! glimagesink sync=false", data->ipaddr,
           data->portnum);
       break;
     case 1:
+#ifdef MULTI_DEVICE_SPLIT_TENSOR
+      /* the model input arrives, the video (300x300) is only for the overlay and the crop */
       str_pipeline =
           g_strdup_printf
-          ("tcpclientsrc host=%s port=%d ! image/jpeg, framerate=30/1 ! "
-          "jpegparse ! jpegdec ! videoconvert ! video/x-raw, format=RGB, "
+          ("tcpclientsrc host=%s port=%d ! nns_ex_tensor_depay ! tee name=tt "
+          "tt. ! queue leaky=2 max-size-buffers=2 ! "
+          "tensor_transform mode=arithmetic option=typecast:float32,add:-127,div:127.5 qos=true ! "
+          "tensor_filter framework=tensorflow-lite model=/sdcard/nnstreamer/tflite_model/ssd_mobilenet_v2_coco.tflite qos=true ! "
+          "tensor_sink name=res_sink sync=false "
+          "tt. ! queue leaky=2 max-size-buffers=2 ! tensor_decoder mode=direct_video ! videoscale ! "
+          "video/x-raw, format=RGB, width=480, height=480 ! tee name=t t. ! queue ! "
+          "videoconvert ! cairooverlay name=res_overlay ! glimagesink sync=false "
+          "t. ! queue ! videoconvert ! nns_ex_roi_mask name=crop region=\"0,0,0,0\" ! " FRAME_SEND " ! tcpserversink host=%s port=%d sync=false ",
+          data->ipaddr, data->portnum, data->ipaddr_sub, data->portnum_sub);
+#else
+      str_pipeline =
+          g_strdup_printf
+          ("tcpclientsrc host=%s port=%d ! " FRAME_RECEIVE " ! "
+          "videoconvert ! video/x-raw, format=RGB, "
           "width=480, height=480, framerate=30/1 ! tee name=t t. ! queue ! "
           "videoconvert ! cairooverlay name=res_overlay ! glimagesink sync=false "
           "t. ! queue leaky=2 max-size-buffers=2 ! videoscale ! video/x-raw, width=300, height=300, format=RGB "
           "! tensor_converter ! tensor_transform mode=arithmetic option=typecast:float32,add:-127,div:127.5 qos=true ! "
           "tensor_filter framework=tensorflow-lite model=/sdcard/nnstreamer/tflite_model/ssd_mobilenet_v2_coco.tflite qos=true ! "
           "tensor_sink name=res_sink sync=false "
-          "t. ! queue ! videoconvert ! videocrop name=crop ! jpegenc qos=true ! tcpserversink host=%s port=%d sync=false ",
+          "t. ! queue ! videoconvert ! nns_ex_roi_mask name=crop region=\"0,0,0,0\" ! " FRAME_SEND " ! tcpserversink host=%s port=%d sync=false ",
           data->ipaddr, data->portnum, data->ipaddr_sub, data->portnum_sub);
+#endif
       break;
     case 2:
       str_pipeline =
           g_strdup_printf
-          ("tcpclientsrc host=%s port=%d ! image/jpeg, framerate=30/1 ! jpegparse ! jpegdec ! videoconvert ! "
+          ("tcpclientsrc host=%s port=%d ! " FRAME_RECEIVE " ! videoconvert ! "
           "tee name=t t. ! queue ! videoconvert ! cairooverlay name=res_overlay ! glimagesink sync=false "
           "t. ! queue leaky=2 max-size-buffers=2 ! videoscale ! video/x-raw, width=192, height=192, format=RGB ! "
           "tensor_converter ! tensor_transform mode=typecast option=float32 qos=true ! "
@@ -701,10 +732,6 @@ app_function (void *userdata)
     gst_object_unref (element);
 
     cropelement = gst_bin_get_by_name (GST_BIN (data->pipeline), "crop");
-    pad = gst_element_get_static_pad (cropelement, "src");
-    gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
-        (GstPadProbeCallback) cb_have_data, NULL, NULL);
-    gst_object_unref (pad);
   }
   if (data->id == 2) {
     element = gst_bin_get_by_name (GST_BIN (data->pipeline), "res_sink");
@@ -42,6 +42,8 @@
 #include <media/NdkImage.h>
 #include <media/NdkImageReader.h>
 
+#include "nns_ex_capture.h"
+
 #define DEFAULT_MAX_IMAGES 5
 
 static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
@@ -54,11 +56,11 @@ GST_DEBUG_CATEGORY (GST_CAT_DEFAULT);
 
 struct _GstAHC2SrcPrivate
 {
-  GstDataQueue *outbound_queue;
-  GstClockTime previous_ts;
+  nns_ex_capture_s *capture;
   gboolean started;
   GMutex mutex;
   gint max_images;
+  gint capture_max_images;
 
   gint camera_index;
   ACameraDevice *camera_device;
@@ -79,56 +81,14 @@ struct _GstAHC2SrcPrivate
   ACameraCaptureSession_stateCallbacks session_state_cb;
 };
 
-typedef struct
-{
-  gsize refcount;
-  GstAHC2Src *ahc2src;
-  AImage *image;
-} GstWrappedAImage;
-
-#define GST_TYPE_WRAPPED_AIMAGE (gst_wrapped_aimage_get_type ())
-GType gst_wrapped_aimage_get_type (void);
-
-static GstWrappedAImage *
-gst_wrapped_aimage_ref (GstWrappedAImage * self)
-{
-  g_return_val_if_fail (self != NULL, NULL);
-  g_return_val_if_fail (self->ahc2src != NULL, NULL);
-  g_return_val_if_fail (self->image != NULL, NULL);
-  g_return_val_if_fail (self->refcount >= 1, NULL);
-
-  GST_TRACE_OBJECT (self->ahc2src,
-      "ref GstWrappedAImage %p, refcount: %" G_GSIZE_FORMAT, self,
-      self->refcount);
-
-  self->refcount++;
-  return self;
-}
-
-static void
-gst_wrapped_aimage_unref (GstWrappedAImage * self)
-{
-  g_return_if_fail (self != NULL);
-  g_return_if_fail (self->ahc2src != NULL);
-  g_return_if_fail (self->image != NULL);
-  g_return_if_fail (self->refcount >= 1);
-
-  GST_TRACE_OBJECT (self->ahc2src,
-      "unref GstWrappedAImage %p, refcount: %" G_GSIZE_FORMAT, self,
-      self->refcount);
-  if (--self->refcount == 0) {
-    gst_object_unref (self->ahc2src);
-    g_clear_pointer (&self->image, (GDestroyNotify) AImage_delete);
-  }
-}
-
-G_DEFINE_BOXED_TYPE (GstWrappedAImage, gst_wrapped_aimage,
-    gst_wrapped_aimage_ref, gst_wrapped_aimage_unref)
 #define GST_AHC2_SRC_GET_PRIVATE(obj)  \
     (G_TYPE_INSTANCE_GET_PRIVATE ((obj), GST_TYPE_AHC2_SRC, GstAHC2SrcPrivate))
 
 static void gst_ahc2_src_photography_init (gpointer g_iface,
     gpointer iface_data);
+static gboolean image_reader_acquire (gpointer user_data,
+    nns_ex_capture_frame_s * frame);
+static void image_reader_release (gpointer user_data, gpointer handle);
 
 #define gst_ahc2_src_parent_class parent_class
 G_DEFINE_TYPE_WITH_CODE (GstAHC2Src, gst_ahc2_src, GST_TYPE_PUSH_SRC,
@@ -1362,7 +1322,7 @@ gst_ahc2_src_unlock (GstBaseSrc * src)
   GstAHC2SrcPrivate *priv = GST_AHC2_SRC_GET_PRIVATE (self);
 
   GST_DEBUG_OBJECT (self, "unlocking create");
-  gst_data_queue_set_flushing (priv->outbound_queue, TRUE);
+  nns_ex_capture_set_flushing (priv->capture, TRUE);
 
   return TRUE;
 }
@@ -1374,7 +1334,7 @@ gst_ahc2_src_unlock_stop (GstBaseSrc * src)
   GstAHC2SrcPrivate *priv = GST_AHC2_SRC_GET_PRIVATE (self);
 
   GST_DEBUG_OBJECT (self, "stopping unlock");
-  gst_data_queue_set_flushing (priv->outbound_queue, FALSE);
+  nns_ex_capture_set_flushing (priv->capture, FALSE);
 
   return TRUE;
 }
@@ -1384,16 +1344,13 @@ gst_ahc2_src_create (GstPushSrc * src, GstBuffer ** buffer)
 {
   GstAHC2Src *self = GST_AHC2_SRC (src);
   GstAHC2SrcPrivate *priv = GST_AHC2_SRC_GET_PRIVATE (self);
-  GstDataQueueItem *item;
 
-  if (!gst_data_queue_pop (priv->outbound_queue, &item)) {
+  *buffer = nns_ex_capture_pop (priv->capture);
+  if (*buffer == NULL) {
     GST_DEBUG_OBJECT (self, "We're flushing");
     return GST_FLOW_FLUSHING;
   }
 
-  *buffer = GST_BUFFER (item->object);
-  g_free (item);
-
   return GST_FLOW_OK;
 }
 
@@ -1467,6 +1424,32 @@ out:
   return ret;
 }
 
+/* The buffer path of max-images frames, the previous one is freed when all its buffers are freed. */
+static gboolean
+gst_ahc2_src_capture_create (GstAHC2Src * self, gint max_images)
+{
+  GstAHC2SrcPrivate *priv = GST_AHC2_SRC_GET_PRIVATE (self);
+  nns_ex_capture_provider_s provider;
+  nns_ex_capture_s *capture;
+
+  provider.acquire = image_reader_acquire;
+  provider.release = image_reader_release;
+  provider.user_data = self;
+
+  capture = nns_ex_capture_new (&provider, MAX (max_images, 1));
+  if (capture == NULL) {
+    GST_ERROR_OBJECT (self, "Failed to create the buffer path (max-images: %d)",
+        max_images);
+    return FALSE;
+  }
+
+  g_clear_pointer (&priv->capture, (GDestroyNotify) nns_ex_capture_free);
+  priv->capture = capture;
+  priv->capture_max_images = max_images;
+
+  return TRUE;
+}
+
 static gboolean
 gst_ahc2_src_start (GstBaseSrc * src)
 {
@@ -1478,7 +1461,15 @@ gst_ahc2_src_start (GstBaseSrc * src)
     goto out;
   }
 
-  priv->previous_ts = GST_CLOCK_TIME_NONE;
+  /* the queue holds as many frames as the image reader (max-images) */
+  if (priv->capture_max_images != priv->max_images) {
+    if (!gst_ahc2_src_capture_create (self, priv->max_images)) {
+      gst_ahc2_src_camera_close (self);
+      goto out;
+    }
+  }
+
+  nns_ex_capture_start (priv->capture);
   priv->started = TRUE;
 
 out:
@@ -1497,7 +1488,7 @@ gst_ahc2_src_stop (GstBaseSrc * src)
   ACameraCaptureSession_abortCaptures (priv->camera_capture_session);
   gst_ahc2_src_camera_close (self);
 
-  gst_data_queue_flush (priv->outbound_queue);
+  nns_ex_capture_stop (priv->capture);
 
   priv->started = FALSE;
   g_mutex_unlock (&priv->mutex);
@@ -1669,51 +1660,27 @@ gst_ahc2_src_finalize (GObject * object)
   g_clear_pointer (&priv->camera_manager,
       (GDestroyNotify) ACameraManager_delete);
 
-  g_clear_pointer (&priv->outbound_queue, gst_object_unref);
+  g_clear_pointer (&priv->capture, (GDestroyNotify) nns_ex_capture_free);
 
   g_mutex_clear (&priv->mutex);
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
-static void
-data_queue_item_free (GstDataQueueItem * item)
-{
-  g_clear_pointer (&item->object, (GDestroyNotify) gst_mini_object_unref);
-  g_free (item);
-}
-
-static void
-image_reader_on_image_available (void *context, AImageReader * reader)
+/* The frames of AImageReader for nns_ex_capture, each frame holds a reference of the source. */
+static gboolean
+image_reader_acquire (gpointer user_data, nns_ex_capture_frame_s * frame)
 {
-  GstAHC2Src *self = GST_AHC2_SRC (context);
+  GstAHC2Src *self = GST_AHC2_SRC (user_data);
   GstAHC2SrcPrivate *priv = GST_AHC2_SRC_GET_PRIVATE (self);
-
-  GstBuffer *buffer;
-  GstDataQueueItem *item;
-  GstClockTime duration = GST_CLOCK_TIME_NONE;
-  GstClockTime current_ts = GST_CLOCK_TIME_NONE;
-  GstClock *clock;
-
-  GstWrappedAImage *wrapped_aimage;
   AImage *image = NULL;
-  gint n_planes;
+  gint n_planes = 0;
   gint i;
 
-  if ((clock = GST_ELEMENT_CLOCK (self))) {
-    GstClockTime base_time = GST_ELEMENT_CAST (self)->base_time;
-    gst_object_ref (clock);
-    current_ts = gst_clock_get_time (clock) - base_time;
-    gst_object_unref (clock);
-  }
-
-  if (AImageReader_acquireLatestImage (reader, &image) != AMEDIA_OK) {
+  if (AImageReader_acquireLatestImage (priv->image_reader, &image) !=
+      AMEDIA_OK) {
     GST_DEBUG_OBJECT (self, "No image available");
-    return;
+    return FALSE;
   }
-  g_mutex_lock (&priv->mutex);
-
-  GST_TRACE_OBJECT (self, "Acquired an image (ts: %" GST_TIME_FORMAT ")",
-      GST_TIME_ARGS (current_ts));
 
 #ifndef GST_DISABLE_GST_DEBUG
   {
@@ -1725,69 +1692,56 @@ image_reader_on_image_available (void *context, AImageReader * reader)
   }
 #endif
 
-  if (!priv->started || GST_CLOCK_TIME_IS_VALID (priv->previous_ts)) {
-    duration = current_ts - priv->previous_ts;
-    priv->previous_ts = current_ts;
-  } else {
-    priv->previous_ts = current_ts;
-    /* Dropping first image to calculate duration */
-    AImage_delete (image);
-    GST_DEBUG_OBJECT (self, "Droping image (reason: %s)",
-        priv->started ? "first frame" : "not yet started");
-    g_mutex_unlock (&priv->mutex);
-    return;
-  }
-
   AImage_getNumberOfPlanes (image, &n_planes);
 
-  buffer = gst_buffer_new ();
-  GST_BUFFER_DURATION (buffer) = duration;
-  GST_BUFFER_PTS (buffer) = current_ts;
-
-  wrapped_aimage = g_new0 (GstWrappedAImage, 1);
-  wrapped_aimage->refcount = 1;
-  wrapped_aimage->ahc2src = g_object_ref (self);
-  wrapped_aimage->image = image;
+  frame->handle = image;
+  frame->n_planes = CLAMP (n_planes, 0, NNS_EX_CAPTURE_MAX_PLANES);
 
-  for (i = 0; i < n_planes; i++) {
+  for (i = 0; i < (gint) frame->n_planes; i++) {
     guint8 *data;
     gint length;
-    GstMemory *mem;
 
     AImage_getPlaneData (image, i, &data, &length);
+    frame->data[i] = data;
+    frame->size[i] = length;
+  }
 
-    mem = gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY,
-        data, length, 0, length,
-        gst_wrapped_aimage_ref (wrapped_aimage),
-        (GDestroyNotify) gst_wrapped_aimage_unref);
+  gst_object_ref (self);
+  return TRUE;
+}
 
-    GST_TRACE_OBJECT (self, "Created a wrapped memory (ptr: %p, length: %d)",
-        mem, length);
-    gst_buffer_append_memory (buffer, mem);
-  }
+static void
+image_reader_release (gpointer user_data, gpointer handle)
+{
+  AImage_delete ((AImage *) handle);
+  gst_object_unref (user_data);
+}
 
-  item = g_new0 (GstDataQueueItem, 1);
-  item->object = GST_MINI_OBJECT (buffer);
-  item->size = gst_buffer_get_size (buffer);
-  item->visible = TRUE;
-  item->destroy = (GDestroyNotify) data_queue_item_free;
+static void
+image_reader_on_image_available (void *context, AImageReader * reader)
+{
+  GstAHC2Src *self = GST_AHC2_SRC (context);
+  GstAHC2SrcPrivate *priv = GST_AHC2_SRC_GET_PRIVATE (self);
 
-  if (!gst_data_queue_push (priv->outbound_queue, item)) {
-    item->destroy (item);
-    GST_DEBUG_OBJECT (self, "Failed to push item because we're flushing");
+  GstClockTime current_ts = GST_CLOCK_TIME_NONE;
+  GstClock *clock;
+
+  if ((clock = GST_ELEMENT_CLOCK (self))) {
+    GstClockTime base_time = GST_ELEMENT_CAST (self)->base_time;
+    gst_object_ref (clock);
+    current_ts = gst_clock_get_time (clock) - base_time;
+    gst_object_unref (clock);
   }
 
-  gst_wrapped_aimage_unref (wrapped_aimage);
-  g_mutex_unlock (&priv->mutex);
+  /* the wrappers of the frames are pooled, and the queue is lock-free (single producer) */
+  if (!nns_ex_capture_on_frame (priv->capture, current_ts)) {
+    GST_TRACE_OBJECT (self, "No buffer (ts: %" GST_TIME_FORMAT ")",
+        GST_TIME_ARGS (current_ts));
+    return;
+  }
 
-  GST_TRACE_OBJECT (self,
-      "created buffer from image callback %" G_GSIZE_FORMAT ", ts %"
-      GST_TIME_FORMAT ", dur %" GST_TIME_FORMAT
-      ", offset %" G_GINT64_FORMAT ", offset_end %" G_GINT64_FORMAT,
-      gst_buffer_get_size (buffer),
-      GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (buffer)),
-      GST_TIME_ARGS (GST_BUFFER_DURATION (buffer)),
-      GST_BUFFER_OFFSET (buffer), GST_BUFFER_OFFSET_END (buffer));
+  GST_TRACE_OBJECT (self, "created buffer from image callback, ts %"
+      GST_TIME_FORMAT, GST_TIME_ARGS (current_ts));
 }
 
 static void
@@ -2035,13 +1989,6 @@ gst_ahc2_src_class_init (GstAHC2SrcClass * klass)
   klass->get_camera_id_by_index = gst_ahc2_src_get_camera_id_by_index;
 }
 
-static gboolean
-data_queue_check_full_cb (GstDataQueue * queue, guint visible,
-    guint bytes, guint64 time, gpointer checkdata)
-{
-  return FALSE;
-}
-
 static void
 gst_ahc2_src_init (GstAHC2Src * self)
 {
@@ -2049,8 +1996,9 @@ gst_ahc2_src_init (GstAHC2Src * self)
 
   priv->camera_template_type = TEMPLATE_PREVIEW;
   priv->max_images = DEFAULT_MAX_IMAGES;
-  priv->outbound_queue =
-      gst_data_queue_new (data_queue_check_full_cb, NULL, NULL, NULL);
+
+  /* created again when the element starts, if max-images is changed */
+  gst_ahc2_src_capture_create (self, DEFAULT_MAX_IMAGES);
 
   gst_base_src_set_format (GST_BASE_SRC (self), GST_FORMAT_TIME);
   gst_base_src_set_live (GST_BASE_SRC (self), TRUE);
@@ -1,4 +1,6 @@
 #!/usr/bin/env bash
+# nns_ex_sparse_overlay (plugin 'nnsexample' of native/common, in GST_PLUGIN_PATH) draws only the visible pixels
+# of the boxes onto the video, instead of blending the whole RGBA overlay with compositor.
 gst-launch-1.0 \
 	v4l2src name=cam_src ! videoscale ! videoconvert ! video/x-raw,width=640,height=480,format=RGB,framerate=30/1 ! tee name=t \
     t. ! queue leaky=2 max-size-buffers=2 ! videoscale ! tensor_converter ! \
@@ -8,5 +10,5 @@ gst-launch-1.0 \
 			outputname=num_detections,detection_classes,detection_scores,detection_boxes \
 			outputtype=float32,float32,float32,float32 ! \
 		tensor_decoder mode=bounding_boxes option1=tf-ssd option2=tf_model/coco_labels_list.txt option4=640:480 option5=640:480 ! \
-		compositor name=mix sink_0::zorder=2 sink_1::zorder=1 ! videoconvert ! ximagesink \
-	t. ! queue leaky=2 max-size-buffers=10 ! mix.
+		queue leaky=2 max-size-buffers=2 ! mix.overlay_sink \
+	t. ! queue leaky=2 max-size-buffers=10 ! nns_ex_sparse_overlay name=mix ! videoconvert ! ximagesink
@@ -1,9 +1,11 @@
 #!/usr/bin/env bash
+# nns_ex_sparse_overlay (plugin 'nnsexample' of native/common, in GST_PLUGIN_PATH) draws only the visible pixels
+# of the boxes onto the video, instead of blending the whole RGBA overlay with compositor.
 gst-launch-1.0 \
 	v4l2src name=cam_src ! videoconvert ! videoscale ! video/x-raw,width=640,height=480,format=RGB,framerate=30/1 ! tee name=t \
 	t. ! queue leaky=2 max-size-buffers=2 ! videoscale ! video/x-raw,width=300,height=300,format=RGB ! tensor_converter ! \
 		tensor_transform mode=arithmetic option=typecast:float32,add:-127.5,div:127.5 ! \
 		tensor_filter framework=tensorflow-lite model=tflite_model/ssd_mobilenet_v2_coco.tflite ! \
 		tensor_decoder mode=bounding_boxes option1=tflite-ssd option2=tflite_model/coco_labels_list.txt option3=tflite_model/box_priors.txt option4=640:480 option5=300:300 ! \
-		compositor name=mix sink_0::zorder=2 sink_1::zorder=1 ! videoconvert ! ximagesink \
-	t. ! queue leaky=2 max-size-buffers=10 ! mix.
+		queue leaky=2 max-size-buffers=2 ! mix.overlay_sink \
+	t. ! queue leaky=2 max-size-buffers=10 ! nns_ex_sparse_overlay name=mix ! videoconvert ! ximagesink
@@ -0,0 +1,284 @@
+/**
+ * @file	nnstreamer_benchmark_batch.c
+ * @date	19 October 2026
+ * @brief	Throughput and latency of the batched TF detection for the batch sizes
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * Runs the detection model of nnstreamer_example_object_detection_tf with the batch of N frames
+ * (nns_ex_batch, input 3:640:480:N) for N = 1 .. --max-batch, and prints the throughput and
+ * the latency from the frame into the batch to the result, a line for each N.
+ *
+ * Pipeline :
+ * videotestsrc -- tensor_converter -- queue --
+ *   ... (--sources)                            |
+ * videotestsrc -- tensor_converter -- queue -- nns_ex_batch -- tensor_filter (tensorflow) -- tensor_sink
+ *
+ * By default the sources push the frames as fast as the model takes them (the max throughput).
+ * '--live' pushes the frames at '--fps' like the cameras, then the latency includes the time
+ * to wait for the batch (up to '--max-latency'), and the leaky queues drop the frames the model cannot take.
+ *
+ * Get model by
+ * $ cd $NNST_ROOT/bin
+ * $ bash get-model-objet-detection-tf.sh
+ *
+ * Run example :
+ * Before running this example, GST_PLUGIN_PATH should be updated for nnstreamer plug-in.
+ * $ export GST_PLUGIN_PATH=$GST_PLUGIN_PATH:<nnstreamer plugin path>
+ * $ ./nnstreamer_benchmark_batch [--model=./tf_model/ssdlite_mobilenet_v2.pb] [--max-batch=8] [--sources=1]
+ * $ ./nnstreamer_benchmark_batch --live --fps=30 --sources=4 --max-latency=50
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include <gst/gst.h>
+
+#include "nns_ex_batch.h"
+
+/**
+ * @brief Default model of the detection example.
+ */
+#define DEFAULT_MODEL "./tf_model/ssdlite_mobilenet_v2.pb"
+
+/**
+ * @brief Metrics of a run.
+ */
+typedef struct
+{
+  GstElement *batch; /**< the element 'nns_ex_batch' */
+  GArray *latency; /**< time (in microseconds) from the frame into the batch to the result */
+  guint frames; /**< count of the frames detected */
+  guint first_frames; /**< count of the frames in the first batch */
+  gint64 first_time; /**< monotonic time of the first result */
+  gint64 last_time; /**< monotonic time of the last result */
+} BenchData;
+
+/**
+ * @brief Compare the latency.
+ */
+static gint
+_compare_latency (gconstpointer a, gconstpointer b)
+{
+  gint64 x = *(const gint64 *) a;
+  gint64 y = *(const gint64 *) b;
+
+  return (x > y) - (x < y);
+}
+
+/**
+ * @brief Callback for tensor sink signal, the latency of the frames in the batch.
+ */
+static void
+_new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
+{
+  BenchData *data = (BenchData *) user_data;
+  nns_ex_batch_info_s info;
+  gint64 now, latency;
+  guint i;
+
+  if (!nns_ex_batch_lookup (data->batch, GST_BUFFER_PTS (buffer), &info))
+    return;
+
+  now = g_get_monotonic_time ();
+
+  for (i = 0; i < info.frames; i++) {
+    latency = now - info.arrival[i];
+    g_array_append_val (data->latency, latency);
+  }
+
+  /* the first session call includes the initialization of the model */
+  if (data->first_time == 0) {
+    data->first_time = now;
+    data->first_frames = info.frames;
+  }
+
+  data->last_time = now;
+  data->frames += info.frames;
+}
+
+/**
+ * @brief Run the model with the batch size, and print the metrics.
+ */
+static gboolean
+_run (const gchar * model, guint batch_size, guint sources, guint frames,
+    guint max_latency, gboolean live, guint fps)
+{
+  GString *desc;
+  GstElement *pipeline, *sink;
+  GstBus *bus;
+  GstMessage *msg;
+  GError *error = NULL;
+  BenchData data;
+  nns_ex_batch_stats_s stats;
+  gdouble elapsed, throughput = 0.0;
+  gint64 *samples;
+  guint s, n;
+  gboolean ret = TRUE;
+
+  desc = g_string_new (NULL);
+
+  for (s = 0; s < sources; s++) {
+    g_string_append_printf (desc,
+        "videotestsrc num-buffers=%u is-live=%s pattern=ball ! "
+        "video/x-raw,format=RGB,width=640,height=480,framerate=%u/1 ! "
+        "tensor_converter ! queue max-size-buffers=%u %s ! batch.sink_%u ",
+        frames, live ? "true" : "false", fps, 2 * batch_size,
+        live ? "leaky=2" : "", s);
+  }
+
+  g_string_append_printf (desc,
+      "nns_ex_batch name=batch batch-size=%u max-latency=%u ! "
+      "tensor_filter framework=tensorflow model=%s "
+      "input=3:640:480:%u inputname=image_tensor inputtype=uint8 "
+      "output=%u:1:1:1,100:%u:1:1,100:%u:1:1,4:100:%u:1 "
+      "outputname=num_detections,detection_classes,detection_scores,detection_boxes "
+      "outputtype=float32,float32,float32,float32 ! "
+      "tensor_sink name=sink", batch_size, max_latency, model, batch_size,
+      batch_size, batch_size, batch_size, batch_size);
+
+  pipeline = gst_parse_launch (desc->str, &error);
+  g_string_free (desc, TRUE);
+
+  if (pipeline == NULL || error) {
+    g_printerr ("failed to make the pipeline: %s\n",
+        error ? error->message : "unknown");
+    g_clear_error (&error);
+    if (pipeline)
+      gst_object_unref (pipeline);
+    return FALSE;
+  }
+
+  memset (&data, 0, sizeof (BenchData));
+  data.latency = g_array_new (FALSE, FALSE, sizeof (gint64));
+  data.batch = gst_bin_get_by_name (GST_BIN (pipeline), "batch");
+
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  g_signal_connect (sink, "new-data", G_CALLBACK (_new_data_cb), &data);
+  gst_object_unref (sink);
+
+  /* run until the sources are ended */
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+
+  if (msg && GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR) {
+    gst_message_parse_error (msg, &error, NULL);
+    g_printerr ("batch %u : %s\n", batch_size, error->message);
+    g_error_free (error);
+    ret = FALSE;
+  }
+
+  if (msg)
+    gst_message_unref (msg);
+  gst_object_unref (bus);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  nns_ex_batch_get_stats (data.batch, &stats);
+
+  n = data.latency->len;
+  if (ret && n > 0) {
+    g_array_sort (data.latency, _compare_latency);
+    samples = (gint64 *) data.latency->data;
+
+    elapsed = (data.last_time - data.first_time) / 1000000.0;
+    if (elapsed > 0.0)
+      throughput = (data.frames - data.first_frames) / elapsed;
+
+    g_print ("%5u  %8.1f  %8.1f  %8.1f  %8.1f  %8.1f  %7.2f  %6.1f%%\n",
+        batch_size, throughput,
+        samples[n / 2] / 1000.0, samples[n * 95 / 100] / 1000.0,
+        samples[n - 1] / 1000.0, stats.max_wait / 1000.0,
+        stats.batches ? (gdouble) stats.frames / stats.batches : 0.0,
+        (sources * frames) ? 100.0 * (sources * frames - data.frames) /
+        (sources * frames) : 0.0);
+  }
+
+  g_array_free (data.latency, TRUE);
+  gst_object_unref (data.batch);
+  gst_object_unref (pipeline);
+  return ret;
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  gchar *model = NULL;
+  gint max_batch = 8;
+  gint sources = 1;
+  gint frames = 150;
+  gint max_latency = 50;
+  gboolean live = FALSE;
+  gint fps = 30;
+  gint n;
+  GOptionContext *optionctx;
+  GError *error = NULL;
+
+  const GOptionEntry main_entries[] = {
+    {"model", 'm', G_OPTION_FLAG_NONE, G_OPTION_ARG_STRING, &model,
+        "TF model of the detection example", DEFAULT_MODEL},
+    {"max-batch", 'b', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &max_batch,
+        "Run the batch size from 1 to max-batch", "8"},
+    {"sources", 's', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &sources,
+        "Number of the video sources into the batch", "1"},
+    {"frames", 'f', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &frames,
+        "Number of the frames of each source", "150"},
+    {"max-latency", 'l', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &max_latency,
+        "Max time (ms) the first frame waits for the batch", "50"},
+    {"live", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_NONE, &live,
+        "Push the frames at the framerate like the cameras", NULL},
+    {"fps", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &fps,
+        "Framerate of the sources", "30"},
+    {NULL}
+  };
+
+  optionctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (optionctx, main_entries, NULL);
+
+  if (!g_option_context_parse (optionctx, &argc, &argv, &error)) {
+    g_printerr ("option parsing failed: %s\n", error->message);
+    g_error_free (error);
+    g_option_context_free (optionctx);
+    return -1;
+  }
+
+  g_option_context_free (optionctx);
+
+  if (max_batch <= 0 || max_batch > NNS_EX_BATCH_MAX || sources <= 0 ||
+      frames <= 0 || max_latency < 0 || fps <= 0) {
+    g_printerr ("invalid option, 1 <= max-batch <= %d\n", NNS_EX_BATCH_MAX);
+    g_free (model);
+    return -1;
+  }
+
+  if (model == NULL)
+    model = g_strdup (DEFAULT_MODEL);
+
+  if (!g_file_test (model, G_FILE_TEST_IS_REGULAR)) {
+    g_printerr ("the file of model is not valid: %s\n", model);
+    g_free (model);
+    return -1;
+  }
+
+  gst_init (&argc, &argv);
+  nns_ex_batch_register ();
+
+  g_print ("%d source(s), %d frames each, %s, max-latency %d ms\n", sources,
+      frames, live ? "live" : "as fast as possible", max_latency);
+  g_print ("batch  frames/s   p50(ms)   p95(ms)   max(ms)  wait(ms)  "
+      "   fill  dropped\n");
+
+  for (n = 1; n <= max_batch; n++) {
+    if (!_run (model, n, sources, frames, max_latency, live, fps))
+      break;
+  }
+
+  g_free (model);
+  return 0;
+}
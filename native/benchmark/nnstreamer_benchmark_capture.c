@@ -0,0 +1,366 @@
+/**
+ * @file	nnstreamer_benchmark_capture.c
+ * @date	19 October 2026
+ * @brief	Microbenchmark of the buffer path of the camera source (ahc2src) on Linux
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * A producer thread (the camera callback) acquires the synthetic NV12 frames and enqueues the buffers,
+ * and a consumer thread (create() of the source and downstream) dequeues the buffers,
+ * holds the last --hold buffers and frees them.
+ * - legacy : the path of onImageAvailable in ahc2src before nns_ex_capture, a wrapper allocated per frame,
+ *   a queue item allocated per frame, the mutex of the source and GstDataQueue
+ * - capture : nns_ex_capture, the wrappers from the pool and the lock-free SPSC queue
+ *
+ * Run example :
+ * $ ./nnstreamer_benchmark_capture [--frames=200000] [--width=640] [--height=480] [--max-images=5] [--hold=2]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include <gst/gst.h>
+#include <gst/base/gstdataqueue.h>
+
+#include "nns_ex_capture.h"
+
+/**
+ * @brief Data structure for the legacy buffer path.
+ */
+typedef struct
+{
+  nns_ex_capture_provider_s provider; /**< frame provider */
+  GstDataQueue *queue; /**< queue of the buffers */
+  GMutex mutex; /**< lock of the source */
+  GstClockTime previous_ts; /**< timestamp of the previous frame */
+  guint allocations; /**< count of the allocations in the callback */
+} legacy_s;
+
+/**
+ * @brief Data structure for the wrapper of a frame (legacy).
+ */
+typedef struct
+{
+  volatile gint refcount; /**< reference count */
+  legacy_s *legacy; /**< buffer path */
+  gpointer handle; /**< frame of the provider */
+} legacy_wrapper_s;
+
+/**
+ * @brief Data structure for a benchmark run.
+ */
+typedef struct
+{
+  gboolean use_capture; /**< true for nns_ex_capture */
+  legacy_s *legacy; /**< legacy buffer path */
+  nns_ex_capture_s *capture; /**< new buffer path */
+  guint frames; /**< count of the frames to produce */
+  guint hold; /**< count of the buffers held by the consumer */
+  guint received; /**< count of the buffers dequeued */
+  gint64 producer_time; /**< time of the producer loop */
+} bench_s;
+
+/**
+ * @brief Release the reference of the wrapper (legacy).
+ */
+static void
+_legacy_wrapper_unref (gpointer data)
+{
+  legacy_wrapper_s *wrapper = (legacy_wrapper_s *) data;
+
+  if (g_atomic_int_dec_and_test (&wrapper->refcount)) {
+    wrapper->legacy->provider.release (wrapper->legacy->provider.user_data,
+        wrapper->handle);
+    g_free (wrapper);
+  }
+}
+
+/**
+ * @brief Free the queue item (legacy).
+ */
+static void
+_legacy_item_free (GstDataQueueItem * item)
+{
+  if (item->object)
+    gst_mini_object_unref (item->object);
+  g_free (item);
+}
+
+/**
+ * @brief The queue is never full (legacy).
+ */
+static gboolean
+_legacy_check_full (GstDataQueue * queue, guint visible, guint bytes,
+    guint64 time, gpointer checkdata)
+{
+  return FALSE;
+}
+
+/**
+ * @brief The camera callback of ahc2src before nns_ex_capture.
+ */
+static void
+_legacy_on_frame (legacy_s * legacy, GstClockTime current_ts)
+{
+  nns_ex_capture_frame_s frame;
+  legacy_wrapper_s *wrapper;
+  GstDataQueueItem *item;
+  GstBuffer *buffer;
+  guint i;
+
+  memset (&frame, 0, sizeof (frame));
+  if (!legacy->provider.acquire (legacy->provider.user_data, &frame))
+    return;
+
+  g_mutex_lock (&legacy->mutex);
+
+  if (!GST_CLOCK_TIME_IS_VALID (legacy->previous_ts)) {
+    legacy->previous_ts = current_ts;
+    legacy->provider.release (legacy->provider.user_data, frame.handle);
+    g_mutex_unlock (&legacy->mutex);
+    return;
+  }
+
+  buffer = gst_buffer_new ();
+  GST_BUFFER_DURATION (buffer) = current_ts - legacy->previous_ts;
+  GST_BUFFER_PTS (buffer) = current_ts;
+  legacy->previous_ts = current_ts;
+
+  wrapper = g_new0 (legacy_wrapper_s, 1);
+  wrapper->refcount = 1;
+  wrapper->legacy = legacy;
+  wrapper->handle = frame.handle;
+
+  for (i = 0; i < frame.n_planes; i++) {
+    g_atomic_int_inc (&wrapper->refcount);
+    gst_buffer_append_memory (buffer,
+        gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY, frame.data[i],
+            frame.size[i], 0, frame.size[i], wrapper, _legacy_wrapper_unref));
+  }
+
+  item = g_new0 (GstDataQueueItem, 1);
+  item->object = GST_MINI_OBJECT (buffer);
+  item->size = gst_buffer_get_size (buffer);
+  item->visible = TRUE;
+  item->destroy = (GDestroyNotify) _legacy_item_free;
+  legacy->allocations += 2;
+
+  if (!gst_data_queue_push (legacy->queue, item))
+    item->destroy (item);
+
+  _legacy_wrapper_unref (wrapper);
+  g_mutex_unlock (&legacy->mutex);
+}
+
+/**
+ * @brief Dequeue the buffer (legacy create()).
+ */
+static GstBuffer *
+_legacy_pop (legacy_s * legacy)
+{
+  GstDataQueueItem *item;
+  GstBuffer *buffer;
+
+  if (!gst_data_queue_pop (legacy->queue, &item))
+    return NULL;
+
+  buffer = GST_BUFFER (item->object);
+  g_free (item);
+  return buffer;
+}
+
+/**
+ * @brief Producer thread, the camera callback.
+ */
+static gpointer
+_producer_thread (gpointer data)
+{
+  bench_s *bench = (bench_s *) data;
+  GstClockTime pts;
+  gint64 start;
+  guint n;
+
+  start = g_get_monotonic_time ();
+  for (n = 0; n < bench->frames; n++) {
+    pts = (GstClockTime) n * 33 * GST_MSECOND;
+
+    if (bench->use_capture)
+      nns_ex_capture_on_frame (bench->capture, pts);
+    else
+      _legacy_on_frame (bench->legacy, pts);
+  }
+  bench->producer_time = g_get_monotonic_time () - start;
+
+  if (bench->use_capture)
+    nns_ex_capture_set_flushing (bench->capture, TRUE);
+  else
+    gst_data_queue_set_flushing (bench->legacy->queue, TRUE);
+
+  return NULL;
+}
+
+/**
+ * @brief Consumer thread, the streaming thread of the source and downstream.
+ */
+static gpointer
+_consumer_thread (gpointer data)
+{
+  bench_s *bench = (bench_s *) data;
+  GstBuffer **held;
+  GstBuffer *buffer;
+  guint i, n = 0;
+
+  held = g_new0 (GstBuffer *, MAX (bench->hold, 1));
+
+  while (TRUE) {
+    if (bench->use_capture)
+      buffer = nns_ex_capture_pop (bench->capture);
+    else
+      buffer = _legacy_pop (bench->legacy);
+
+    if (buffer == NULL)
+      break;
+
+    bench->received++;
+
+    if (bench->hold == 0) {
+      gst_buffer_unref (buffer);
+      continue;
+    }
+
+    /* downstream keeps the last buffers (e.g., the queue and the converter) */
+    i = n++ % bench->hold;
+    if (held[i])
+      gst_buffer_unref (held[i]);
+    held[i] = buffer;
+  }
+
+  for (i = 0; i < bench->hold; i++) {
+    if (held[i])
+      gst_buffer_unref (held[i]);
+  }
+
+  g_free (held);
+  return NULL;
+}
+
+/**
+ * @brief Run the benchmark of the buffer path.
+ */
+static void
+_run (gboolean use_capture, guint width, guint height, guint max_images,
+    guint frames, guint hold)
+{
+  nns_ex_capture_synthetic_s *synthetic;
+  nns_ex_capture_provider_s provider;
+  nns_ex_capture_stats_s stats;
+  legacy_s legacy;
+  bench_s bench;
+  GThread *producer, *consumer;
+  gint64 start, total;
+
+  synthetic = nns_ex_capture_synthetic_new (width, height, max_images);
+  nns_ex_capture_synthetic_get_provider (synthetic, &provider);
+
+  memset (&bench, 0, sizeof (bench));
+  bench.use_capture = use_capture;
+  bench.frames = frames;
+  bench.hold = hold;
+
+  memset (&legacy, 0, sizeof (legacy));
+  if (use_capture) {
+    bench.capture = nns_ex_capture_new (&provider, max_images);
+    nns_ex_capture_start (bench.capture);
+  } else {
+    legacy.provider = provider;
+    legacy.queue = gst_data_queue_new (_legacy_check_full, NULL, NULL, NULL);
+    legacy.previous_ts = GST_CLOCK_TIME_NONE;
+    g_mutex_init (&legacy.mutex);
+    bench.legacy = &legacy;
+  }
+
+  start = g_get_monotonic_time ();
+  consumer = g_thread_new ("consumer", _consumer_thread, &bench);
+  producer = g_thread_new ("producer", _producer_thread, &bench);
+  g_thread_join (producer);
+  g_thread_join (consumer);
+  total = g_get_monotonic_time () - start;
+
+  if (use_capture) {
+    nns_ex_capture_get_stats (bench.capture, &stats);
+    g_print ("  capture : %6.3f us/callback, %6.3f us/frame received, "
+        "%u received, %u dropped, %u unavailable, %u wrappers allocated\n",
+        (gdouble) bench.producer_time / frames,
+        (gdouble) total / MAX (bench.received, 1), bench.received,
+        stats.dropped, stats.unavailable, stats.wrappers);
+    nns_ex_capture_free (bench.capture);
+  } else {
+    g_print ("  legacy  : %6.3f us/callback, %6.3f us/frame received, "
+        "%u received, %u allocations in the callback\n",
+        (gdouble) bench.producer_time / frames,
+        (gdouble) total / MAX (bench.received, 1), bench.received,
+        legacy.allocations);
+    gst_data_queue_flush (legacy.queue);
+    gst_object_unref (legacy.queue);
+    g_mutex_clear (&legacy.mutex);
+  }
+
+  nns_ex_capture_synthetic_free (synthetic);
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  gint frames = 200000;
+  gint width = 640;
+  gint height = 480;
+  gint max_images = 5;
+  gint hold = 2;
+  GOptionContext *optionctx;
+  GError *error = NULL;
+
+  const GOptionEntry main_entries[] = {
+    {"frames", 'n', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &frames,
+        "Number of the camera callbacks", "200000"},
+    {"width", 'W', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &width,
+        "Width of the frame (even number)", "640"},
+    {"height", 'H', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &height,
+        "Height of the frame (even number)", "480"},
+    {"max-images", 'm', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &max_images,
+        "Max number of the frames held at once (max-images of ahc2src)", "5"},
+    {"hold", 'k', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &hold,
+        "Number of the buffers held by the consumer", "2"},
+    {NULL}
+  };
+
+  optionctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (optionctx, main_entries, NULL);
+
+  if (!g_option_context_parse (optionctx, &argc, &argv, &error)) {
+    g_printerr ("option parsing failed: %s\n", error->message);
+    g_error_free (error);
+    g_option_context_free (optionctx);
+    return -1;
+  }
+
+  g_option_context_free (optionctx);
+
+  if (frames <= 0 || width <= 0 || width % 2 || height <= 0 || height % 2 ||
+      max_images <= 0 || hold < 0 || hold >= max_images) {
+    g_printerr ("invalid frames, size, max-images or hold "
+        "(hold should be less than max-images)\n");
+    return -1;
+  }
+
+  gst_init (&argc, &argv);
+
+  g_print ("%dx%d NV12, %d callbacks, max-images %d, hold %d\n", width,
+      height, frames, max_images, hold);
+  _run (FALSE, width, height, max_images, frames, hold);
+  _run (TRUE, width, height, max_images, frames, hold);
+  return 0;
+}
@@ -0,0 +1,316 @@
+/**
+ * @file	nnstreamer_benchmark_multi_pose.c
+ * @date	19 October 2026
+ * @brief	Microbenchmark of the multi-person pose decoder with the recorded heatmaps
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * Decodes the heatmaps with nns_ex_pose_find_local_peaks() and nns_ex_pose_group(),
+ * and compares the non-max suppression with a pass over the heatmap for each keypoint.
+ * The default size and the skeleton are of detect_pose.tflite (96x96, 14 keypoints, the root is the neck).
+ *
+ * The heatmaps are the raw output of the model (float32, HWC), recorded with filesink, e.g.,
+ * $ gst-launch-1.0 v4l2src ! videoconvert ! videoscale ! video/x-raw,format=RGB,width=192,height=192 ! \
+ *     tensor_converter ! tensor_transform mode=typecast option=float32 ! \
+ *     tensor_filter framework=tensorflow-lite model=detect_pose.tflite ! filesink location=pose.raw
+ * Without '--heatmap', the heatmaps have the synthetic persons ('--persons').
+ * The cost per cell is also printed for the larger heatmaps, to check that it is linear in the size.
+ *
+ * Run example :
+ * $ ./nnstreamer_benchmark_multi_pose [--heatmap=pose.raw] [--width=96] [--height=96] [--persons=4] [--iterations=1000]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+
+#include "nns_ex_pose.h"
+
+/**
+ * @brief Keypoints of detect_pose.tflite.
+ */
+#define POSE_SIZE 14
+
+/**
+ * @brief Parent of each keypoint (detect_pose.tflite, the lines drawn in the pose examples).
+ */
+static const gint pose_parents[POSE_SIZE] = {
+  1, -1, 1, 2, 3, 1, 5, 6, 1, 8, 9, 1, 11, 12
+};
+
+/**
+ * @brief Offset of each keypoint from the neck (in 1/16 of the height of a person).
+ */
+static const gint pose_offsets[POSE_SIZE][2] = {
+  {0, -2}, {0, 0}, {-2, 0}, {-3, 3}, {-3, 6}, {2, 0}, {3, 3}, {3, 6},
+  {-1, 7}, {-1, 11}, {-1, 15}, {1, 7}, {1, 11}, {1, 15}
+};
+
+/**
+ * @brief The non-max suppression of the keypoint at the cell, without the vectors.
+ */
+static gboolean
+_is_local_peak (const gfloat * heatmap, guint width, guint height,
+    guint x, guint y, guint k, gfloat threshold)
+{
+  gfloat v = heatmap[((gsize) y * width + x) * POSE_SIZE + k];
+  gfloat n;
+  gint dx, dy, nx, ny;
+
+  if (!(v > threshold))
+    return FALSE;
+
+  for (dy = -1; dy <= 1; dy++) {
+    for (dx = -1; dx <= 1; dx++) {
+      nx = (gint) x + dx;
+      ny = (gint) y + dy;
+
+      if ((dx == 0 && dy == 0) || nx < 0 || ny < 0 ||
+          nx >= (gint) width || ny >= (gint) height)
+        continue;
+
+      n = heatmap[((gsize) ny * width + nx) * POSE_SIZE + k];
+
+      if ((dy < 0 || (dy == 0 && dx < 0)) ? (n >= v) : (n > v))
+        return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+ * @brief A pass over the heatmap for each keypoint, returns the number of the peaks.
+ */
+static guint
+_find_local_peaks_strided (const gfloat * heatmap, guint width, guint height,
+    gfloat threshold)
+{
+  guint x, y, k;
+  guint count = 0;
+
+  for (k = 0; k < POSE_SIZE; k++) {
+    for (y = 0; y < height; y++) {
+      for (x = 0; x < width; x++) {
+        if (_is_local_peak (heatmap, width, height, x, y, k, threshold))
+          count++;
+      }
+    }
+  }
+
+  return count;
+}
+
+/**
+ * @brief Fill the heatmap with the noise and the gaussian peaks of the persons.
+ */
+static void
+_make_heatmap (gfloat * heatmap, guint width, guint height, guint persons)
+{
+  gsize size = (gsize) width * height * POSE_SIZE;
+  gint scale, cx, cy, px, py, x, y, d2;
+  guint p, k;
+  gfloat v, *cell;
+
+  for (p = 0; p < size; p++)
+    heatmap[p] = (rand () % 1000) / 5000.0f;
+
+  /* the persons side by side */
+  scale = MAX ((gint) height / 32, 1);
+
+  for (p = 0; p < persons; p++) {
+    cx = (gint) ((p + 0.5f) * width / persons);
+    cy = (gint) height / 4;
+
+    for (k = 0; k < POSE_SIZE; k++) {
+      px = cx + pose_offsets[k][0] * scale;
+      py = cy + pose_offsets[k][1] * scale;
+
+      for (y = py - 2; y <= py + 2; y++) {
+        for (x = px - 2; x <= px + 2; x++) {
+          if (x < 0 || y < 0 || x >= (gint) width || y >= (gint) height)
+            continue;
+
+          d2 = (x - px) * (x - px) + (y - py) * (y - py);
+          v = 0.9f / (1 + d2);
+          cell = &heatmap[((gsize) y * width + x) * POSE_SIZE + k];
+          *cell = MAX (*cell, v);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief Decode the heatmaps, returns the time (in microseconds) per heatmap.
+ */
+static gdouble
+_decode (const gfloat * heatmaps, guint frames, guint width, guint height,
+    gint iterations, gfloat radius, guint * persons, guint * peaks)
+{
+  nns_ex_pose_peak_s peak[NNS_EX_POSE_MAX_PEAKS];
+  nns_ex_pose_instance_s instances[NNS_EX_POSE_MAX_INSTANCES];
+  gsize size = (gsize) width * height * POSE_SIZE;
+  gint64 start;
+  guint f, n;
+  gint i;
+
+  *persons = *peaks = 0;
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < iterations; i++) {
+    f = (guint) i % frames;
+
+    n = nns_ex_pose_find_local_peaks (heatmaps + f * size, width, height,
+        POSE_SIZE, 0.5f, peak, NNS_EX_POSE_MAX_PEAKS);
+
+    if (i < (gint) frames)
+      *peaks += n;
+
+    n = nns_ex_pose_group (peak, n, POSE_SIZE, pose_parents, radius,
+        instances, NNS_EX_POSE_MAX_INSTANCES);
+
+    if (i < (gint) frames)
+      *persons += n;
+  }
+
+  return (gdouble) (g_get_monotonic_time () - start) / iterations;
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  gchar *heatmap_file = NULL;
+  gint width = 96;
+  gint height = 96;
+  gint persons = 4;
+  gint iterations = 1000;
+  gdouble radius = 0.0;
+  GOptionContext *optionctx;
+  GError *error = NULL;
+
+  gfloat *heatmaps = NULL;
+  gchar *contents = NULL;
+  gsize length, size;
+  guint frames = 1;
+  guint found, peaks, strided_peaks;
+  gint64 start;
+  gdouble strided_time, single_time, t;
+  gint n, scale;
+
+  const GOptionEntry main_entries[] = {
+    {"heatmap", 'f', G_OPTION_FLAG_NONE, G_OPTION_ARG_FILENAME, &heatmap_file,
+        "Recorded heatmaps (float32 HWC, 14 keypoints)", NULL},
+    {"width", 'W', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &width,
+        "Width of the heatmap", "96"},
+    {"height", 'H', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &height,
+        "Height of the heatmap", "96"},
+    {"persons", 'p', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &persons,
+        "Number of the synthetic persons", "4"},
+    {"radius", 'r', G_OPTION_FLAG_NONE, G_OPTION_ARG_DOUBLE, &radius,
+        "Max distance (cells) of the keypoint from its parent", "height / 4"},
+    {"iterations", 'n', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &iterations,
+        "Number of heatmaps to decode", "1000"},
+    {NULL}
+  };
+
+  optionctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (optionctx, main_entries, NULL);
+
+  if (!g_option_context_parse (optionctx, &argc, &argv, &error)) {
+    g_printerr ("option parsing failed: %s\n", error->message);
+    g_error_free (error);
+    g_option_context_free (optionctx);
+    return -1;
+  }
+
+  g_option_context_free (optionctx);
+
+  if (width < 3 || height < 3 || persons <= 0 || iterations <= 0) {
+    g_printerr ("invalid size or iterations\n");
+    g_free (heatmap_file);
+    return -1;
+  }
+
+  if (radius <= 0.0)
+    radius = height / 4.0;
+
+  size = (gsize) width * height * POSE_SIZE;
+
+  if (heatmap_file) {
+    if (!g_file_get_contents (heatmap_file, &contents, &length, &error)) {
+      g_printerr ("failed to read the heatmaps: %s\n", error->message);
+      g_error_free (error);
+      g_free (heatmap_file);
+      return -1;
+    }
+
+    frames = (guint) (length / (size * sizeof (gfloat)));
+    if (frames == 0) {
+      g_printerr ("the file is smaller than a heatmap %dx%dx%d\n", width,
+          height, POSE_SIZE);
+      g_free (contents);
+      g_free (heatmap_file);
+      return -1;
+    }
+
+    heatmaps = (gfloat *) contents;
+  } else {
+    srand (1);
+    heatmaps = g_new (gfloat, size);
+    _make_heatmap (heatmaps, width, height, persons);
+  }
+
+  /* the number of the peaks (not bounded) to compare */
+  strided_peaks = 0;
+
+  start = g_get_monotonic_time ();
+  for (n = 0; n < iterations; n++)
+    strided_peaks += _find_local_peaks_strided (heatmaps + (n % frames) * size,
+        width, height, 0.5f);
+  strided_time = (gdouble) (g_get_monotonic_time () - start) / iterations;
+
+  single_time = _decode (heatmaps, frames, width, height, iterations,
+      (gfloat) radius, &found, &peaks);
+
+  g_print ("heatmap %dx%dx%d, %u frame(s) from %s, %d iterations\n", width,
+      height, POSE_SIZE, frames, heatmap_file ? heatmap_file : "synthetic",
+      iterations);
+  g_print ("peaks %.1f/frame (%.1f by the strided pass), "
+      "persons %.1f/frame\n", (gdouble) peaks / frames,
+      (gdouble) strided_peaks / iterations, (gdouble) found / frames);
+  g_print ("nms, pass for each keypoint : %.2f us/heatmap\n", strided_time);
+  g_print ("nms single pass + grouping  : %.2f us/heatmap (x%.2f)\n",
+      single_time, strided_time / MAX (single_time, 0.01));
+
+  if (contents)
+    g_free (contents);
+  else
+    g_free (heatmaps);
+
+  /* cost per cell of the larger heatmaps (synthetic) */
+  g_print ("size       us/heatmap  ns/cell\n");
+
+  for (scale = 1; scale <= 4; scale *= 2) {
+    gint w = width * scale;
+    gint h = height * scale;
+
+    srand (1);
+    heatmaps = g_new (gfloat, (gsize) w * h * POSE_SIZE);
+    _make_heatmap (heatmaps, w, h, persons);
+
+    t = _decode (heatmaps, 1, w, h, MAX (iterations / (scale * scale), 1),
+        (gfloat) radius * scale, &found, &peaks);
+    g_print ("%4dx%-4d  %10.2f  %7.2f\n", w, h, t, t * 1000.0 / ((gdouble) w *
+            h));
+
+    g_free (heatmaps);
+  }
+
+  g_free (heatmap_file);
+  return 0;
+}
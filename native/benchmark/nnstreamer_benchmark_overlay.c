@@ -0,0 +1,398 @@
+/**
+ * @file	nnstreamer_benchmark_overlay.c
+ * @date	19 October 2026
+ * @brief	CPU of compositor and the sparse overlay blending the boxes onto the video
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * Compares the RGBA overlay of 'tensor_decoder mode=bounding_boxes' (boxes and label bars)
+ * blended onto RGB video frames at 720p and 1080p.
+ *
+ * Pipelines (CPU time of the process with getrusage, per frame) :
+ * 'videotestsrc' makes the RGB frames, and 'appsrc' pushes the RGBA overlay every --stride frames
+ * (the boxes are drawn like tensor_decoder, the benchmark does not need a model).
+ * - source : the video only, the cost of videotestsrc to subtract
+ * - compositor : 'compositor' mixing the video and the overlay (sink_1::zorder=2)
+ * - sparse : 'nns_ex_sparse_overlay' drawing the spans of the visible pixels onto the video
+ *
+ * Microbenchmark (the blending only, wall time per frame) :
+ * - full : scalar alpha blending of every pixel of the overlay onto every frame
+ *   (a plain C reference, not compositor, which blends with ORC)
+ * - sparse : the spans of the visible pixels are made when a new overlay arrives (every --stride frames),
+ *   and only the spans are blended (nns_ex_overlay)
+ *
+ * Run example :
+ * $ ./nnstreamer_benchmark_overlay [--boxes=5] [--stride=1] [--frames=300] [--iterations=200]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <glib.h>
+#include <gst/gst.h>
+
+#include "nns_ex_overlay.h"
+#include "nns_ex_sparse_overlay.h"
+
+/**
+ * @brief Framerate of the video in the pipelines.
+ */
+#define BENCH_FPS 30
+
+/**
+ * @brief Thickness of the box lines and height of the label bar.
+ */
+#define BOX_LINE 3
+#define LABEL_HEIGHT 24
+
+/**
+ * @brief Fill the rectangle of the RGBA overlay frame.
+ */
+static void
+_fill_rgba (guint8 * rgba, gint width, gint height, gint x, gint y, gint w,
+    gint h, const guint8 color[4])
+{
+  gint i, j;
+
+  for (j = MAX (y, 0); j < MIN (y + h, height); j++) {
+    for (i = MAX (x, 0); i < MIN (x + w, width); i++)
+      memcpy (rgba + ((gsize) j * width + i) * 4, color, 4);
+  }
+}
+
+/**
+ * @brief Draw the boxes like tensor_decoder (the overlay is transparent except the boxes).
+ */
+static void
+_draw_boxes (guint8 * rgba, gint width, gint height, gint boxes)
+{
+  const guint8 line[4] = { 255, 0, 0, 255 };
+  const guint8 label[4] = { 255, 255, 255, 160 };
+  gint b, x, y, w, h;
+
+  memset (rgba, 0, (gsize) width * height * 4);
+
+  for (b = 0; b < boxes; b++) {
+    w = width / 8 + (b * 37) % (width / 6);
+    h = height / 6 + (b * 53) % (height / 5);
+    x = (b * 211) % MAX (width - w, 1);
+    y = (b * 127) % MAX (height - h, 1);
+
+    _fill_rgba (rgba, width, height, x, y, w, BOX_LINE, line);
+    _fill_rgba (rgba, width, height, x, y + h - BOX_LINE, w, BOX_LINE, line);
+    _fill_rgba (rgba, width, height, x, y, BOX_LINE, h, line);
+    _fill_rgba (rgba, width, height, x + w - BOX_LINE, y, BOX_LINE, h, line);
+    _fill_rgba (rgba, width, height, x + BOX_LINE, y + BOX_LINE,
+        MIN (w - 2 * BOX_LINE, 160), LABEL_HEIGHT, label);
+  }
+}
+
+/**
+ * @brief Blend every pixel of the RGBA overlay onto the RGB frame (scalar full-frame blend).
+ */
+static void
+_blend_full (const guint8 * rgba, guint8 * rgb, gsize pixels)
+{
+  guint a, t, c;
+  gsize i;
+
+  for (i = 0; i < pixels; i++, rgba += 4, rgb += 3) {
+    a = rgba[3];
+
+    for (c = 0; c < 3; c++) {
+      t = rgba[c] * a + rgb[c] * (255 - a) + 128;
+      rgb[c] = (guint8) ((t + (t >> 8)) >> 8);
+    }
+  }
+}
+
+/**
+ * @brief Get the CPU time (user and system) of the process in microseconds.
+ */
+static gint64
+_get_cpu_time (void)
+{
+  struct rusage usage;
+
+  getrusage (RUSAGE_SELF, &usage);
+  return (gint64) (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * G_USEC_PER_SEC
+      + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+/**
+ * @brief Run the pipeline to EOS, and push the overlay to appsrc 'overlay' every stride frames.
+ * @param overlay the RGBA overlay, NULL if the pipeline has no overlay
+ * @return the CPU time of the process in microseconds, negative if failed
+ */
+static gint64
+_run_pipeline (const gchar * desc, GstBuffer * overlay, gint frames,
+    gint stride)
+{
+  GstElement *pipeline, *src;
+  GstBuffer *buffer;
+  GstBus *bus;
+  GstMessage *msg;
+  GstFlowReturn flow;
+  GError *error = NULL;
+  gint64 cpu = -1, start;
+  gint n;
+
+  pipeline = gst_parse_launch (desc, &error);
+  if (error) {
+    g_printerr ("failed to make the pipeline: %s\n%s\n", error->message,
+        desc);
+    g_clear_error (&error);
+    if (pipeline)
+      gst_object_unref (pipeline);
+    return -1;
+  }
+
+  start = _get_cpu_time ();
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+
+  if (overlay) {
+    src = gst_bin_get_by_name (GST_BIN (pipeline), "overlay");
+
+    /* a new overlay every stride frames, the copies share the memory */
+    for (n = 0; n < frames; n += stride) {
+      buffer = gst_buffer_copy (overlay);
+      GST_BUFFER_PTS (buffer) =
+          gst_util_uint64_scale_int (n, GST_SECOND, BENCH_FPS);
+      GST_BUFFER_DURATION (buffer) =
+          gst_util_uint64_scale_int (stride, GST_SECOND, BENCH_FPS);
+
+      g_signal_emit_by_name (src, "push-buffer", buffer, &flow);
+      gst_buffer_unref (buffer);
+      if (flow != GST_FLOW_OK)
+        break;
+    }
+
+    g_signal_emit_by_name (src, "end-of-stream", &flow);
+    gst_object_unref (src);
+  }
+
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_timed_pop_filtered (bus, 120 * GST_SECOND,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+
+  if (msg == NULL) {
+    g_printerr ("timeout\n");
+  } else if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR) {
+    gst_message_parse_error (msg, &error, NULL);
+    g_printerr ("%s : %s\n", GST_OBJECT_NAME (GST_MESSAGE_SRC (msg)),
+        error->message);
+    g_clear_error (&error);
+  } else {
+    cpu = _get_cpu_time () - start;
+  }
+
+  if (msg)
+    gst_message_unref (msg);
+  gst_object_unref (bus);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  return cpu;
+}
+
+/**
+ * @brief Run the pipelines of compositor and the sparse overlay for the size.
+ */
+static void
+_run_pipelines (gint width, gint height, gint boxes, gint stride,
+    gint frames)
+{
+  GstBuffer *overlay;
+  GstMapInfo map;
+  gchar *video, *caps, *desc;
+  gint64 source_time, compositor_time, sparse_time;
+
+  overlay = gst_buffer_new_allocate (NULL, (gsize) width * height * 4, NULL);
+  gst_buffer_map (overlay, &map, GST_MAP_WRITE);
+  _draw_boxes (map.data, width, height, boxes);
+  gst_buffer_unmap (overlay, &map);
+
+  video = g_strdup_printf ("videotestsrc num-buffers=%d pattern=ball ! "
+      "video/x-raw,format=RGB,width=%d,height=%d,framerate=%d/1", frames,
+      width, height, BENCH_FPS);
+  caps = g_strdup_printf ("\"video/x-raw,format=RGBA,width=%d,height=%d,"
+      "framerate=%d/1\"", width, height, BENCH_FPS);
+
+  desc = g_strdup_printf ("%s ! fakesink sync=false", video);
+  source_time = _run_pipeline (desc, NULL, frames, stride);
+  g_free (desc);
+
+  desc = g_strdup_printf ("%s ! mix.sink_0 "
+      "appsrc name=overlay format=time caps=%s ! mix.sink_1 "
+      "compositor name=mix sink_0::zorder=1 sink_1::zorder=2 ! "
+      "video/x-raw,format=RGB,width=%d,height=%d ! fakesink sync=false",
+      video, caps, width, height);
+  compositor_time = _run_pipeline (desc, overlay, frames, stride);
+  g_free (desc);
+
+  desc = g_strdup_printf ("%s ! mix.video_sink "
+      "appsrc name=overlay format=time caps=%s ! mix.overlay_sink "
+      "nns_ex_sparse_overlay name=mix ! fakesink sync=false", video, caps);
+  sparse_time = _run_pipeline (desc, overlay, frames, stride);
+  g_free (desc);
+
+  g_print ("%dx%d pipelines, %d boxes, %d frames, new overlay every %d frames "
+      "(CPU time of the process)\n", width, height, boxes, frames, stride);
+
+  if (source_time >= 0) {
+    g_print ("  source only              : %8.1f us/frame\n",
+        (gdouble) source_time / frames);
+  }
+
+  if (compositor_time >= 0 && source_time >= 0) {
+    g_print ("  compositor               : %8.1f us/frame (overlay %.1f us/frame)\n",
+        (gdouble) compositor_time / frames,
+        (gdouble) (compositor_time - source_time) / frames);
+  }
+
+  if (sparse_time >= 0 && source_time >= 0) {
+    g_print ("  nns_ex_sparse_overlay    : %8.1f us/frame (overlay %.1f us/frame)\n",
+        (gdouble) sparse_time / frames,
+        (gdouble) (sparse_time - source_time) / frames);
+  }
+
+  g_free (video);
+  g_free (caps);
+  gst_buffer_unref (overlay);
+}
+
+/**
+ * @brief Run the microbenchmark for the size.
+ */
+static void
+_run (gint width, gint height, gint boxes, gint stride, gint iterations)
+{
+  guint8 *rgba, *video, *frame_full, *frame_sparse;
+  gsize pixels = (gsize) width * height;
+  nns_ex_overlay_s *ov;
+  gint64 start, full_time, sparse_time, extract_time = 0;
+  gint n, diff = 0;
+  gsize i;
+
+  rgba = g_malloc (pixels * 4);
+  video = g_malloc (pixels * 3);
+  frame_full = g_malloc (pixels * 3);
+  frame_sparse = g_malloc (pixels * 3);
+
+  for (i = 0; i < pixels * 3; i++)
+    video[i] = (guint8) (i * 7 + (i / 3) / width);
+
+  _draw_boxes (rgba, width, height, boxes);
+  ov = nns_ex_overlay_new ();
+
+  /* same result */
+  memcpy (frame_full, video, pixels * 3);
+  memcpy (frame_sparse, video, pixels * 3);
+  _blend_full (rgba, frame_full, pixels);
+  nns_ex_overlay_from_rgba (ov, rgba, width, height, width * 4, width, height);
+  nns_ex_overlay_blend (ov, frame_sparse, width, height, width * 3, 3, 0, 1,
+      2);
+
+  for (i = 0; i < pixels * 3; i++)
+    diff += (frame_full[i] != frame_sparse[i]);
+
+  /* the video frame is new for each iteration */
+  start = g_get_monotonic_time ();
+  for (n = 0; n < iterations; n++) {
+    memcpy (frame_full, video, pixels * 3);
+    _blend_full (rgba, frame_full, pixels);
+  }
+  full_time = g_get_monotonic_time () - start;
+
+  start = g_get_monotonic_time ();
+  for (n = 0; n < iterations; n++) {
+    memcpy (frame_sparse, video, pixels * 3);
+
+    if (n % stride == 0) {
+      gint64 t = g_get_monotonic_time ();
+
+      nns_ex_overlay_from_rgba (ov, rgba, width, height, width * 4, width,
+          height);
+      extract_time += g_get_monotonic_time () - t;
+    }
+
+    nns_ex_overlay_blend (ov, frame_sparse, width, height, width * 3, 3, 0,
+        1, 2);
+  }
+  sparse_time = g_get_monotonic_time () - start;
+
+  g_print ("%dx%d, %d boxes, %u visible pixels (%.2f%%), %d mismatches\n",
+      width, height, boxes, nns_ex_overlay_get_pixels (ov),
+      100.0 * nns_ex_overlay_get_pixels (ov) / pixels, diff);
+  g_print ("  scalar full-frame blend  : %8.1f us/frame\n",
+      (gdouble) full_time / iterations);
+  g_print ("  sparse (spans + blend)   : %8.1f us/frame (x%.1f), "
+      "spans %.1f us/overlay\n", (gdouble) sparse_time / iterations,
+      (gdouble) full_time / MAX (sparse_time, 1),
+      (gdouble) extract_time / ((iterations + stride - 1) / stride));
+
+  nns_ex_overlay_free (ov);
+  g_free (rgba);
+  g_free (video);
+  g_free (frame_full);
+  g_free (frame_sparse);
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  gint boxes = 5;
+  gint stride = 1;
+  gint iterations = 200;
+  gint frames = 300;
+  GOptionContext *optionctx;
+  GError *error = NULL;
+
+  const GOptionEntry main_entries[] = {
+    {"boxes", 'b', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &boxes,
+        "Number of the boxes in the overlay", "5"},
+    {"stride", 's', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &stride,
+        "A new overlay every stride frames (the detector stride)", "1"},
+    {"frames", 'f', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &frames,
+        "Number of frames of the pipelines", "300"},
+    {"iterations", 'n', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &iterations,
+        "Number of frames of the microbenchmark", "200"},
+    {NULL}
+  };
+
+  optionctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (optionctx, main_entries, NULL);
+
+  if (!g_option_context_parse (optionctx, &argc, &argv, &error)) {
+    g_printerr ("option parsing failed: %s\n", error->message);
+    g_error_free (error);
+    g_option_context_free (optionctx);
+    return -1;
+  }
+
+  g_option_context_free (optionctx);
+
+  if (boxes < 0 || stride <= 0 || frames <= 0 || iterations <= 0) {
+    g_printerr ("invalid boxes, stride, frames or iterations\n");
+    return -1;
+  }
+
+  gst_init (&argc, &argv);
+
+  if (!nns_ex_sparse_overlay_register ()) {
+    g_printerr ("failed to register the sparse overlay\n");
+    return -1;
+  }
+
+  _run_pipelines (1280, 720, boxes, stride, frames);
+  _run_pipelines (1920, 1080, boxes, stride, frames);
+
+  _run (1280, 720, boxes, stride, iterations);
+  _run (1920, 1080, boxes, stride, iterations);
+  return 0;
+}
@@ -0,0 +1,176 @@
+/**
+ * @file	nnstreamer_benchmark_pose.c
+ * @date	19 October 2026
+ * @brief	Microbenchmark of the single-pass pose heatmap peak extraction
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * Compares nns_ex_pose_find_peaks() with the loops of the pose examples (new_pose_data_cb() and
+ * nns_ex_parse_pose() in the android examples), a strided pass over the whole HWC heatmap
+ * for each keypoint. The default size is the output of detect_pose.tflite (96x96, 14 keypoints).
+ * '--offsets' also refines the peaks with an offset map (PoseNet, e.g., --width=33 --height=33 --keypoints=17).
+ *
+ * Run example :
+ * $ ./nnstreamer_benchmark_pose [--width=96] [--height=96] [--keypoints=14] [--offsets] [--iterations=1000]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <glib.h>
+
+#include "nns_ex_pose.h"
+
+/**
+ * @brief Output stride of the offset map (PoseNet).
+ */
+#define OUTPUT_STRIDE 16.0f
+
+/**
+ * @brief The loops of the pose examples, a pass over the heatmap for each keypoint.
+ */
+static void
+_find_peaks_strided (const gfloat * pose_data, guint width, guint height,
+    guint num, nns_ex_keypoint_s * keypoints)
+{
+  guint index, i, j;
+  guint maxX, maxY;
+  gfloat max, cen;
+
+  for (index = 0; index < num; ++index) {
+    maxX = maxY = 0;
+    max = .0f;
+
+    for (j = 0; j < height; ++j) {
+      for (i = 0; i < width; ++i) {
+        cen = pose_data[i * num + j * width * num + index];
+
+        if (cen > max) {
+          max = cen;
+          maxX = i;
+          maxY = j;
+        }
+      }
+    }
+
+    keypoints[index].x = maxX;
+    keypoints[index].y = maxY;
+    keypoints[index].score = max;
+  }
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  gint width = 96;
+  gint height = 96;
+  gint keypoints = 14;
+  gint iterations = 1000;
+  gboolean use_offsets = FALSE;
+  GOptionContext *optionctx;
+  GError *error = NULL;
+
+  gfloat *heatmap, *offsets = NULL;
+  nns_ex_keypoint_s strided[NNS_EX_POSE_MAX_KEYPOINTS];
+  nns_ex_keypoint_s single[NNS_EX_POSE_MAX_KEYPOINTS];
+  gsize size, i;
+  gint64 start, strided_time, single_time;
+  guint mismatch = 0;
+  gint n, k;
+
+  const GOptionEntry main_entries[] = {
+    {"width", 'W', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &width,
+        "Width of the heatmap", "96"},
+    {"height", 'H', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &height,
+        "Height of the heatmap", "96"},
+    {"keypoints", 'k', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &keypoints,
+        "Number of the keypoints", "14"},
+    {"offsets", 'o', G_OPTION_FLAG_NONE, G_OPTION_ARG_NONE, &use_offsets,
+        "Refine the peaks with the offset map", NULL},
+    {"iterations", 'n', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &iterations,
+        "Number of heatmaps to decode", "1000"},
+    {NULL}
+  };
+
+  optionctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (optionctx, main_entries, NULL);
+
+  if (!g_option_context_parse (optionctx, &argc, &argv, &error)) {
+    g_printerr ("option parsing failed: %s\n", error->message);
+    g_error_free (error);
+    g_option_context_free (optionctx);
+    return -1;
+  }
+
+  g_option_context_free (optionctx);
+
+  if (width <= 0 || height <= 0 || keypoints <= 0 ||
+      keypoints > NNS_EX_POSE_MAX_KEYPOINTS || iterations <= 0) {
+    g_printerr ("invalid size or iterations (1 <= keypoints <= %d)\n",
+        NNS_EX_POSE_MAX_KEYPOINTS);
+    return -1;
+  }
+
+  size = (gsize) width * height * keypoints;
+  heatmap = g_new (gfloat, size);
+
+  /* low scores, and a peak of each keypoint */
+  srand (1);
+  for (i = 0; i < size; i++)
+    heatmap[i] = (rand () % 1000) / 4000.0f;
+
+  for (k = 0; k < keypoints; k++) {
+    i = ((gsize) (rand () % height) * width + rand () % width) * keypoints + k;
+    heatmap[i] = 0.6f + (rand () % 100) / 400.0f;
+  }
+
+  if (use_offsets) {
+    offsets = g_new (gfloat, size * 2);
+    for (i = 0; i < size * 2; i++)
+      offsets[i] = (rand () % 2000) / 100.0f - 10.0f;
+  }
+
+  /* same peaks */
+  _find_peaks_strided (heatmap, width, height, keypoints, strided);
+  nns_ex_pose_find_peaks (heatmap, width, height, keypoints, 0.5f, single);
+
+  for (k = 0; k < keypoints; k++) {
+    if (strided[k].x != single[k].x || strided[k].y != single[k].y ||
+        strided[k].score != single[k].score)
+      mismatch++;
+  }
+
+  start = g_get_monotonic_time ();
+  for (n = 0; n < iterations; n++)
+    _find_peaks_strided (heatmap, width, height, keypoints, strided);
+  strided_time = g_get_monotonic_time () - start;
+
+  start = g_get_monotonic_time ();
+  for (n = 0; n < iterations; n++) {
+    nns_ex_pose_find_peaks (heatmap, width, height, keypoints, 0.5f, single);
+    if (offsets)
+      nns_ex_pose_refine (single, keypoints, offsets, width, height,
+          OUTPUT_STRIDE);
+  }
+  single_time = g_get_monotonic_time () - start;
+
+  g_print ("heatmap %dx%d, %d keypoints, %d iterations, %u mismatches\n",
+      width, height, keypoints, iterations, mismatch);
+  g_print ("pass for each keypoint : %.2f us/heatmap\n",
+      (gdouble) strided_time / iterations);
+  g_print ("single pass%s : %.2f us/heatmap (x%.2f)\n",
+      offsets ? " + offsets" : "           ",
+      (gdouble) single_time / iterations,
+      (gdouble) strided_time / MAX (single_time, 1));
+
+  if (offsets) {
+    g_print ("keypoint 0 : cell (%u, %u), refined (%.2f, %.2f)\n",
+        single[0].x, single[0].y, single[0].fx, single[0].fy);
+  }
+
+  g_free (heatmap);
+  g_free (offsets);
+  return 0;
+}
@@ -0,0 +1,157 @@
+/**
+ * @file	nnstreamer_benchmark_preprocess.c
+ * @date	19 October 2026
+ * @brief	Microbenchmark of the fused transpose and normalization kernel
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * Compares the fused kernel (nnscustom_transpose_normalize) with the two passes of
+ * 'tensor_transform mode=transpose option=1:2:0:3 ! tensor_transform mode=arithmetic option=typecast:float32,add:-123,div:63'.
+ *
+ * Run example :
+ * $ ./nnstreamer_benchmark_preprocess [--width=224] [--height=224] [--iterations=1000]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <glib.h>
+
+#include "nns_ex_preprocess.h"
+
+/**
+ * @brief Channels of the image (RGB).
+ */
+#define CHANNELS 3
+
+/**
+ * @brief Normalization of the caffe2 example.
+ */
+#define NORM_MEAN 123.0f
+#define NORM_STD 63.0f
+
+/**
+ * @brief 1st pass, transpose uint8 HWC to CHW (tensor_transform mode=transpose).
+ */
+static void
+_transpose_hwc_to_chw (const guint8 * src, guint8 * dst, guint width,
+    guint height)
+{
+  guint c, y, x;
+
+  for (y = 0; y < height; y++) {
+    for (x = 0; x < width; x++) {
+      for (c = 0; c < CHANNELS; c++) {
+        dst[(c * height + y) * width + x] = src[(y * width + x) * CHANNELS + c];
+      }
+    }
+  }
+}
+
+/**
+ * @brief 2nd pass, typecast and arithmetic (tensor_transform mode=arithmetic).
+ */
+static void
+_typecast_add_div (const guint8 * src, gfloat * dst, gsize size, gfloat add,
+    gfloat div)
+{
+  gsize i;
+
+  for (i = 0; i < size; i++) {
+    dst[i] = ((gfloat) src[i] + add) / div;
+  }
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  gint width = 224;
+  gint height = 224;
+  gint iterations = 1000;
+  GOptionContext *optionctx;
+  GError *error = NULL;
+
+  guint8 *src, *tmp;
+  gfloat *dst_chain, *dst_fused;
+  nns_ex_normalize_s norm;
+  gsize size, i;
+  gint64 start, chain_time, fused_time;
+  gfloat max_diff = 0.0f;
+  gint n;
+
+  const GOptionEntry main_entries[] = {
+    {"width", 'W', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &width,
+        "Image width", "224"},
+    {"height", 'H', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &height,
+        "Image height", "224"},
+    {"iterations", 'n', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &iterations,
+        "Number of frames to process", "1000"},
+    {NULL}
+  };
+
+  optionctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (optionctx, main_entries, NULL);
+
+  if (!g_option_context_parse (optionctx, &argc, &argv, &error)) {
+    g_printerr ("option parsing failed: %s\n", error->message);
+    g_error_free (error);
+    g_option_context_free (optionctx);
+    return -1;
+  }
+
+  g_option_context_free (optionctx);
+
+  if (width <= 0 || height <= 0 || iterations <= 0) {
+    g_printerr ("invalid width, height or iterations\n");
+    return -1;
+  }
+
+  size = (gsize) width * height * CHANNELS;
+  src = g_malloc (size);
+  tmp = g_malloc (size);
+  dst_chain = g_new (gfloat, size);
+  dst_fused = g_new (gfloat, size);
+
+  for (i = 0; i < size; i++)
+    src[i] = (guint8) g_random_int_range (0, 256);
+
+  nns_ex_normalize_init (&norm, CHANNELS, NORM_MEAN, NORM_STD);
+
+  /* warm up */
+  _transpose_hwc_to_chw (src, tmp, width, height);
+  _typecast_add_div (tmp, dst_chain, size, -NORM_MEAN, NORM_STD);
+  nns_ex_hwc_to_chw_normalize (src, dst_fused, width, height, &norm);
+
+  for (i = 0; i < size; i++)
+    max_diff = MAX (max_diff, fabsf (dst_chain[i] - dst_fused[i]));
+
+  start = g_get_monotonic_time ();
+  for (n = 0; n < iterations; n++) {
+    _transpose_hwc_to_chw (src, tmp, width, height);
+    _typecast_add_div (tmp, dst_chain, size, -NORM_MEAN, NORM_STD);
+  }
+  chain_time = g_get_monotonic_time () - start;
+
+  start = g_get_monotonic_time ();
+  for (n = 0; n < iterations; n++) {
+    nns_ex_hwc_to_chw_normalize (src, dst_fused, width, height, &norm);
+  }
+  fused_time = g_get_monotonic_time () - start;
+
+  g_print ("image %dx%dx%d, %d iterations, max diff %g\n", width, height,
+      CHANNELS, iterations, max_diff);
+  g_print ("transpose + arithmetic : %.2f us/frame\n",
+      (gdouble) chain_time / iterations);
+  g_print ("fused                  : %.2f us/frame (x%.2f)\n",
+      (gdouble) fused_time / iterations,
+      (gdouble) chain_time / MAX (fused_time, 1));
+
+  g_free (src);
+  g_free (tmp);
+  g_free (dst_chain);
+  g_free (dst_fused);
+  return 0;
+}
@@ -0,0 +1,164 @@
+/**
+ * @file	nnstreamer_benchmark_roi_mask.c
+ * @date	19 October 2026
+ * @brief	Microbenchmark of the ROI masking with the row spans and the per-pixel pad probe
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * Compares the masking of the pixels out of the box of a person on RGB frames
+ * (the crop of the multi-device example, 480x480) and 720p :
+ * - probe : the buffer is copied (gst_buffer_make_writable) and each pixel is checked
+ *   with the box in the pad probe
+ * - mask : the region is copied and the rows and spans out of the region are filled with memset
+ *   into the output buffer (nns_ex_roi_mask)
+ * - mask (in place) : only the rows and spans out of the region are filled
+ *
+ * Run example :
+ * $ ./nnstreamer_benchmark_roi_mask [--box=50] [--iterations=500]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+
+#include "nns_ex_roi.h"
+
+/**
+ * @brief Copy the frame and fill the pixels out of the box (the pad probe of the multi-device example).
+ */
+static void
+_mask_probe (const guint8 * src, guint8 * dst, gint width, gint height,
+    gint bx, gint by, gint bw, gint bh)
+{
+  gint x, y;
+
+  memcpy (dst, src, (gsize) width * height * 3);
+
+  for (y = 0; y < height; y++) {
+    for (x = 0; x < width; x++) {
+      if (x < bx || y < by) {
+        dst[y * width * 3 + x * 3] = 0;
+        dst[y * width * 3 + x * 3 + 1] = 0;
+        dst[y * width * 3 + x * 3 + 2] = 0;
+      }
+      if (x > bx + bw || y > by + bh) {
+        dst[y * width * 3 + x * 3] = 0;
+        dst[y * width * 3 + x * 3 + 1] = 0;
+        dst[y * width * 3 + x * 3 + 2] = 0;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Run the benchmark for the size.
+ */
+static void
+_run (gint width, gint height, gint box, gint iterations)
+{
+  guint8 *video, *frame_probe, *frame_mask;
+  gsize size = (gsize) width * height * 3;
+  nns_ex_roi_rect_s rect;
+  gint64 start, probe_time, mask_time, inplace_time;
+  gint bx, by, bw, bh, n, diff = 0;
+  gsize i;
+
+  video = g_malloc (size);
+  frame_probe = g_malloc (size);
+  frame_mask = g_malloc (size);
+
+  for (i = 0; i < size; i++)
+    video[i] = (guint8) (i * 7 + (i / 3) / width + 1);
+
+  /* box in the center, the probe keeps the right and bottom edges of the box */
+  bw = width * box / 100;
+  bh = height * box / 100;
+  bx = (width - bw) / 2;
+  by = (height - bh) / 2;
+  rect.x = bx;
+  rect.y = by;
+  rect.width = bw + 1;
+  rect.height = bh + 1;
+
+  /* same result */
+  _mask_probe (video, frame_probe, width, height, bx, by, bw, bh);
+  nns_ex_roi_mask_plane (video, width * 3, frame_mask, width * 3, width,
+      height, 3, &rect, 0);
+
+  for (i = 0; i < size; i++)
+    diff += (frame_probe[i] != frame_mask[i]);
+
+  start = g_get_monotonic_time ();
+  for (n = 0; n < iterations; n++)
+    _mask_probe (video, frame_probe, width, height, bx, by, bw, bh);
+  probe_time = g_get_monotonic_time () - start;
+
+  start = g_get_monotonic_time ();
+  for (n = 0; n < iterations; n++)
+    nns_ex_roi_mask_plane (video, width * 3, frame_mask, width * 3, width,
+        height, 3, &rect, 0);
+  mask_time = g_get_monotonic_time () - start;
+
+  start = g_get_monotonic_time ();
+  for (n = 0; n < iterations; n++)
+    nns_ex_roi_mask_plane (NULL, 0, frame_mask, width * 3, width, height, 3,
+        &rect, 0);
+  inplace_time = g_get_monotonic_time () - start;
+
+  g_print ("%dx%d RGB, box %dx%d (%d%%), %d mismatches\n", width, height,
+      bw, bh, box, diff);
+  g_print ("  probe (copy + per pixel) : %8.1f us/frame\n",
+      (gdouble) probe_time / iterations);
+  g_print ("  mask (rows + spans)      : %8.1f us/frame (x%.1f)\n",
+      (gdouble) mask_time / iterations,
+      (gdouble) probe_time / MAX (mask_time, 1));
+  g_print ("  mask (in place)          : %8.1f us/frame (x%.1f)\n",
+      (gdouble) inplace_time / iterations,
+      (gdouble) probe_time / MAX (inplace_time, 1));
+
+  g_free (video);
+  g_free (frame_probe);
+  g_free (frame_mask);
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  gint box = 50;
+  gint iterations = 500;
+  GOptionContext *optionctx;
+  GError *error = NULL;
+
+  const GOptionEntry main_entries[] = {
+    {"box", 'b', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &box,
+        "Size of the box (percent of the frame width and height)", "50"},
+    {"iterations", 'n', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &iterations,
+        "Number of frames to process", "500"},
+    {NULL}
+  };
+
+  optionctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (optionctx, main_entries, NULL);
+
+  if (!g_option_context_parse (optionctx, &argc, &argv, &error)) {
+    g_printerr ("option parsing failed: %s\n", error->message);
+    g_error_free (error);
+    g_option_context_free (optionctx);
+    return -1;
+  }
+
+  g_option_context_free (optionctx);
+
+  if (box < 0 || box > 99 || iterations <= 0) {
+    g_printerr ("invalid box or iterations\n");
+    return -1;
+  }
+
+  _run (480, 480, box, iterations);
+  _run (1280, 720, box, iterations);
+  return 0;
+}
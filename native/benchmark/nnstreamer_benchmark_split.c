@@ -0,0 +1,453 @@
+/**
+ * @file	nnstreamer_benchmark_split.c
+ * @date	19 October 2026
+ * @brief	Bytes on the wire and CPU time per frame of each split point between the client and the server
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * The multi-device example (android/multi_device_shared_lib) sends the camera frames to the server,
+ * and the server runs the preprocessing of the model (scale, convert, normalize) before tensor_filter.
+ * This benchmark runs the client and the server part of each split point with the same frames,
+ * and prints the bytes per frame, the bandwidth at the framerate and the CPU time per frame of both sides :
+ *
+ * jpeg   : client 'jpegenc', server 'jpegparse ! jpegdec ! videoconvert ! videoscale ! tensor_converter ! tensor_transform'
+ * raw    : client 'nns_ex_tensor_pay', server 'nns_ex_tensor_depay ! videoconvert ! videoscale ! tensor_converter ! tensor_transform'
+ * tensor : client 'nns_ex_tensorize type=float32 normalize=... ! nns_ex_tensor_pay', server 'nns_ex_tensor_depay'
+ * quant  : client 'nns_ex_tensorize type=uint8 ! nns_ex_tensor_pay', server 'nns_ex_tensor_depay ! tensor_transform' (dequantize)
+ *
+ * The server starts at tensor_filter with the split point 'tensor'. With --uint8-model (quantized model),
+ * the server does not normalize the tensor, and 'quant' is same as 'tensor'.
+ * The client and the server run in turn (appsrc and fakesink), so the CPU time of each side is not mixed.
+ * The stream between them is kept in the memory, the bytes are same as the TCP stream.
+ * The server runs the model with --model, otherwise the CPU time is the preprocessing only.
+ *
+ * Run example :
+ * $ ./nnstreamer_benchmark_split [--frames=300] [--width=480] [--height=480] [--model-width=300] [--model-height=300]
+ *   [--compression=lz4] [--pattern=ball | --file=video.mp4] [--model=ssd_mobilenet_v2_coco.tflite] [--uint8-model]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <glib.h>
+#include <gst/gst.h>
+
+#include "nns_ex_tensorize.h"
+#include "nns_ex_transport.h"
+
+/**
+ * @brief Normalization of the model input, (x - 127.5) / 127.5.
+ */
+#define SPLIT_NORMALIZE "mean:127.5,std:127.5"
+#define SPLIT_DEQUANTIZE "typecast:float32,add:-127.5,div:127.5"
+
+/**
+ * @brief Split points.
+ */
+typedef enum
+{
+  SPLIT_JPEG = 0,
+  SPLIT_RAW,
+  SPLIT_TENSOR,
+  SPLIT_QUANT,
+
+  SPLIT_POINTS
+} split_point_e;
+
+/**
+ * @brief Names of the split points.
+ */
+static const gchar *split_names[SPLIT_POINTS] = {
+  "jpeg", "raw", "tensor", "quant"
+};
+
+/**
+ * @brief Options of the benchmark.
+ */
+typedef struct
+{
+  gint frames; /**< number of the frames */
+  gint width; /**< width of the camera frame */
+  gint height; /**< height of the camera frame */
+  gint fps; /**< framerate to compute the bandwidth */
+  gint model_width; /**< width of the model input */
+  gint model_height; /**< height of the model input */
+  const gchar *compression; /**< compression of nns_ex_tensor_pay */
+  const gchar *model; /**< tflite model of the server, NULL to run the preprocessing only */
+  gboolean uint8_model; /**< true if the model input is uint8 (no normalization) */
+} BenchOptions;
+
+/**
+ * @brief Metrics of a run.
+ */
+typedef struct
+{
+  GPtrArray *buffers; /**< the output buffers, NULL not to keep */
+  guint64 bytes; /**< bytes of the output */
+  guint count; /**< count of the output buffers */
+  gdouble cpu_ms; /**< CPU time of the run */
+} BenchRun;
+
+/**
+ * @brief Handoff of fakesink, keep the output.
+ */
+static void
+_handoff_cb (GstElement * element, GstBuffer * buffer, GstPad * pad,
+    gpointer user_data)
+{
+  BenchRun *run = (BenchRun *) user_data;
+
+  run->bytes += gst_buffer_get_size (buffer);
+  run->count++;
+
+  if (run->buffers)
+    g_ptr_array_add (run->buffers, gst_buffer_ref (buffer));
+}
+
+/**
+ * @brief Wait for the end of the stream or the error.
+ */
+static gboolean
+_wait_eos (GstElement * pipeline)
+{
+  GstBus *bus;
+  GstMessage *msg;
+  GError *error = NULL;
+  gboolean ret = TRUE;
+
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_timed_pop_filtered (bus, 120 * GST_SECOND,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+
+  if (msg == NULL) {
+    g_printerr ("timeout\n");
+    ret = FALSE;
+  } else if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR) {
+    gst_message_parse_error (msg, &error, NULL);
+    g_printerr ("%s : %s\n", GST_OBJECT_NAME (GST_MESSAGE_SRC (msg)),
+        error->message);
+    g_error_free (error);
+    ret = FALSE;
+  }
+
+  if (msg)
+    gst_message_unref (msg);
+  gst_object_unref (bus);
+  return ret;
+}
+
+/**
+ * @brief Run the pipeline to EOS, push the input buffers to appsrc 'in' and keep the output of fakesink 'out'.
+ * @param input the buffers to push, NULL if the pipeline has the source
+ * @param run the metrics (the output buffers are kept if run->buffers is not NULL)
+ */
+static gboolean
+_run_pipeline (const gchar * desc, GPtrArray * input, BenchRun * run)
+{
+  GstElement *pipeline, *element;
+  GstFlowReturn flow;
+  GError *error = NULL;
+  clock_t cpu;
+  guint i;
+  gboolean ret = FALSE;
+
+  pipeline = gst_parse_launch (desc, &error);
+  if (error) {
+    g_printerr ("failed to make the pipeline: %s\n%s\n", error->message,
+        desc);
+    g_clear_error (&error);
+    if (pipeline)
+      gst_object_unref (pipeline);
+    return FALSE;
+  }
+
+  element = gst_bin_get_by_name (GST_BIN (pipeline), "out");
+  g_signal_connect (element, "handoff", G_CALLBACK (_handoff_cb), run);
+  gst_object_unref (element);
+
+  cpu = clock ();
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+
+  if (input) {
+    /* appsrc queues the buffers, the pipeline runs in the streaming thread */
+    element = gst_bin_get_by_name (GST_BIN (pipeline), "in");
+    for (i = 0; i < input->len; i++) {
+      g_signal_emit_by_name (element, "push-buffer",
+          g_ptr_array_index (input, i), &flow);
+      if (flow != GST_FLOW_OK)
+        break;
+    }
+
+    g_signal_emit_by_name (element, "end-of-stream", &flow);
+    gst_object_unref (element);
+  }
+
+  ret = _wait_eos (pipeline);
+  run->cpu_ms = (gdouble) (clock () - cpu) * 1000.0 / CLOCKS_PER_SEC;
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+  return ret;
+}
+
+/**
+ * @brief Make the client part of the split point (from the RGB frames to the stream).
+ */
+static gchar *
+_make_client (split_point_e split, const BenchOptions * opt)
+{
+  switch (split) {
+    case SPLIT_JPEG:
+      return g_strdup ("jpegenc");
+    case SPLIT_RAW:
+      return g_strdup_printf ("nns_ex_tensor_pay compression=%s",
+          opt->compression);
+    case SPLIT_TENSOR:
+      if (!opt->uint8_model) {
+        return g_strdup_printf ("nns_ex_tensorize width=%d height=%d "
+            "type=float32 normalize=" SPLIT_NORMALIZE " ! "
+            "nns_ex_tensor_pay compression=%s", opt->model_width,
+            opt->model_height, opt->compression);
+      }
+      /* fallthrough, the input of the model is the quantized tensor */
+    case SPLIT_QUANT:
+      return g_strdup_printf ("nns_ex_tensorize width=%d height=%d "
+          "type=uint8 ! nns_ex_tensor_pay compression=%s", opt->model_width,
+          opt->model_height, opt->compression);
+    default:
+      break;
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief Make the server part of the split point (from the stream to the model input).
+ */
+static gchar *
+_make_server (split_point_e split, const BenchOptions * opt)
+{
+  const gchar *normalize;
+
+  normalize = opt->uint8_model ? "" :
+      " ! tensor_transform mode=arithmetic option=" SPLIT_DEQUANTIZE;
+
+  switch (split) {
+    case SPLIT_JPEG:
+    case SPLIT_RAW:
+      return g_strdup_printf ("%s ! videoconvert ! videoscale ! "
+          "video/x-raw,format=RGB,width=%d,height=%d ! tensor_converter%s",
+          (split == SPLIT_JPEG) ? "jpegparse ! jpegdec" : "nns_ex_tensor_depay",
+          opt->model_width, opt->model_height, normalize);
+    case SPLIT_TENSOR:
+      return g_strdup ("nns_ex_tensor_depay");
+    case SPLIT_QUANT:
+      return g_strdup_printf ("nns_ex_tensor_depay%s", normalize);
+    default:
+      break;
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief Free the buffers in the array.
+ */
+static void
+_free_buffers (GPtrArray * buffers)
+{
+  if (buffers) {
+    g_ptr_array_foreach (buffers, (GFunc) gst_buffer_unref, NULL);
+    g_ptr_array_free (buffers, TRUE);
+  }
+}
+
+/**
+ * @brief Run the client and the server of the split point, and print the metrics.
+ */
+static gboolean
+_run_split (split_point_e split, GPtrArray * frames, const gchar * caps,
+    const BenchOptions * opt)
+{
+  gchar *client, *server, *desc, *filter, *stream_caps;
+  BenchRun client_run, server_run;
+  gboolean ret = FALSE;
+
+  memset (&client_run, 0, sizeof (BenchRun));
+  memset (&server_run, 0, sizeof (BenchRun));
+
+  client = _make_client (split, opt);
+  server = _make_server (split, opt);
+  filter = opt->model ?
+      g_strdup_printf (" ! tensor_filter framework=tensorflow-lite model=%s",
+      opt->model) : g_strdup ("");
+
+  /* client : the camera frames to the stream */
+  client_run.buffers = g_ptr_array_new ();
+  desc = g_strdup_printf ("appsrc name=in format=time caps=\"%s\" ! %s ! "
+      "fakesink name=out signal-handoffs=true sync=false", caps, client);
+
+  if (!_run_pipeline (desc, frames, &client_run) || client_run.count == 0) {
+    g_printerr ("%s : failed to run the client\n", split_names[split]);
+    goto done;
+  }
+  g_free (desc);
+
+  /* server : the stream to the model input (and the model) */
+  if (split == SPLIT_JPEG)
+    stream_caps = g_strdup_printf ("image/jpeg,framerate=%d/1", opt->fps);
+  else
+    stream_caps = g_strdup (NNS_EX_TRANSPORT_CAPS);
+
+  desc = g_strdup_printf ("appsrc name=in format=time caps=%s ! %s%s ! "
+      "fakesink name=out signal-handoffs=true sync=false", stream_caps,
+      server, filter);
+  g_free (stream_caps);
+
+  if (!_run_pipeline (desc, client_run.buffers, &server_run) ||
+      server_run.count == 0) {
+    g_printerr ("%s : failed to run the server\n", split_names[split]);
+    goto done;
+  }
+
+  g_print ("%-7s %10.1f %9.1f %11.2f %11.2f   %s\n", split_names[split],
+      (gdouble) client_run.bytes / client_run.count / 1024.0,
+      (gdouble) client_run.bytes * 8.0 * opt->fps / client_run.count /
+      1000000.0, client_run.cpu_ms / frames->len,
+      server_run.cpu_ms / server_run.count, server);
+  ret = TRUE;
+
+done:
+  g_free (desc);
+  g_free (client);
+  g_free (server);
+  g_free (filter);
+  _free_buffers (client_run.buffers);
+  return ret;
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  BenchOptions opt;
+  BenchRun source_run;
+  gchar *pattern = NULL;
+  gchar *file = NULL;
+  gchar *compression = NULL;
+  gchar *model = NULL;
+  gchar *caps, *desc;
+  guint i;
+  GOptionContext *optionctx;
+  GError *error = NULL;
+
+  const GOptionEntry main_entries[] = {
+    {"frames", 'f', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &opt.frames,
+        "Number of the frames", "300"},
+    {"width", 'W', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &opt.width,
+        "Width of the camera frame", "480"},
+    {"height", 'H', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &opt.height,
+        "Height of the camera frame", "480"},
+    {"fps", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &opt.fps,
+        "Framerate to compute the bandwidth", "30"},
+    {"model-width", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_INT,
+        &opt.model_width, "Width of the model input", "300"},
+    {"model-height", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_INT,
+        &opt.model_height, "Height of the model input", "300"},
+    {"compression", 'c', G_OPTION_FLAG_NONE, G_OPTION_ARG_STRING,
+        &compression, "Compression of the stream (none, lz4 or zstd)", "none"},
+    {"pattern", 'p', G_OPTION_FLAG_NONE, G_OPTION_ARG_STRING, &pattern,
+        "Pattern of videotestsrc (ball, smpte, snow, ...)", "ball"},
+    {"file", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_FILENAME, &file,
+        "Video file instead of videotestsrc", "file"},
+    {"model", 'm', G_OPTION_FLAG_NONE, G_OPTION_ARG_FILENAME, &model,
+        "tflite model to run in the server", "file"},
+    {"uint8-model", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_NONE,
+        &opt.uint8_model, "The model input is uint8 (no normalization)", NULL},
+    {NULL}
+  };
+
+  memset (&opt, 0, sizeof (BenchOptions));
+  opt.frames = 300;
+  opt.width = 480;
+  opt.height = 480;
+  opt.fps = 30;
+  opt.model_width = 300;
+  opt.model_height = 300;
+
+  optionctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (optionctx, main_entries, NULL);
+
+  if (!g_option_context_parse (optionctx, &argc, &argv, &error)) {
+    g_printerr ("option parsing failed: %s\n", error->message);
+    g_error_free (error);
+    g_option_context_free (optionctx);
+    return -1;
+  }
+
+  g_option_context_free (optionctx);
+
+  opt.compression = compression ? compression : "none";
+  opt.model = model;
+
+  if (opt.frames <= 0 || opt.width <= 0 || opt.height <= 0 || opt.fps <= 0 ||
+      opt.model_width <= 0 || opt.model_height <= 0 ||
+      !nns_ex_transport_codec_supported (nns_ex_transport_codec_from_string
+          (opt.compression))) {
+    g_printerr ("invalid option (or the compression is not built)\n");
+    goto done;
+  }
+
+  gst_init (&argc, &argv);
+  nns_ex_tensorize_register ();
+  nns_ex_tensor_pay_register ();
+  nns_ex_tensor_depay_register ();
+
+  /* the camera frames, kept in the memory */
+  caps = g_strdup_printf ("video/x-raw,format=RGB,width=%d,height=%d,"
+      "framerate=%d/1", opt.width, opt.height, opt.fps);
+
+  if (file) {
+    desc = g_strdup_printf ("filesrc location=\"%s\" ! decodebin ! "
+        "videoconvert ! videoscale ! videorate ! %s ! identity eos-after=%d ! "
+        "fakesink name=out signal-handoffs=true sync=false", file, caps,
+        opt.frames);
+  } else {
+    desc = g_strdup_printf ("videotestsrc num-buffers=%d pattern=%s ! %s ! "
+        "fakesink name=out signal-handoffs=true sync=false", opt.frames,
+        pattern ? pattern : "ball", caps);
+  }
+
+  memset (&source_run, 0, sizeof (BenchRun));
+  source_run.buffers = g_ptr_array_new ();
+
+  if (!_run_pipeline (desc, NULL, &source_run) || source_run.count == 0) {
+    g_printerr ("failed to get the frames\n");
+  } else {
+    g_print ("%u frames %dx%d RGB, model input %dx%d %s, compression %s, "
+        "%s\n", source_run.count, opt.width, opt.height, opt.model_width,
+        opt.model_height, opt.uint8_model ? "uint8" : "float32",
+        opt.compression, model ? model : "preprocessing only");
+    g_print ("split    KiB/frame  Mbit/s  client(ms)  server(ms)   "
+        "server pipeline (before tensor_filter)\n");
+
+    for (i = 0; i < SPLIT_POINTS; i++) {
+      if (!_run_split ((split_point_e) i, source_run.buffers, caps, &opt))
+        break;
+    }
+  }
+
+  g_free (desc);
+  g_free (caps);
+  _free_buffers (source_run.buffers);
+
+done:
+  g_free (pattern);
+  g_free (file);
+  g_free (compression);
+  g_free (model);
+  return 0;
+}
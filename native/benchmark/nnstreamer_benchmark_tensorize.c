@@ -0,0 +1,231 @@
+/**
+ * @file	nnstreamer_benchmark_tensorize.c
+ * @date	19 October 2026
+ * @brief	Microbenchmark of the single-pass video to tensor conversion
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * Compares the frame converter of nns_ex_tensorize with the passes of
+ * 'videoconvert ! videoscale ! video/x-raw,format=RGB ! tensor_converter ! tensor_transform mode=arithmetic'
+ * (I420 to RGB of the full frame, bilinear scaling, then typecast and normalization).
+ *
+ * Run example :
+ * $ ./nnstreamer_benchmark_tensorize [--width=640] [--height=480] [--model-width=300] [--model-height=300] [--iterations=200]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <glib.h>
+
+#include "nns_ex_preprocess.h"
+
+/**
+ * @brief Normalization of the detection example.
+ */
+#define NORM_MEAN 127.5f
+#define NORM_STD 127.5f
+
+/**
+ * @brief 1st pass, I420 to RGB of the full frame (videoconvert).
+ */
+static void
+_i420_to_rgb (const guint8 * y_plane, const guint8 * u_plane,
+    const guint8 * v_plane, guint8 * dst, gint width, gint height)
+{
+  gint x, y, l, u, v;
+
+  for (y = 0; y < height; y++) {
+    for (x = 0; x < width; x++) {
+      l = 298 * (y_plane[y * width + x] - 16);
+      u = u_plane[(y / 2) * (width / 2) + x / 2] - 128;
+      v = v_plane[(y / 2) * (width / 2) + x / 2] - 128;
+
+      dst[0] = CLAMP ((l + 409 * v + 128) >> 8, 0, 255);
+      dst[1] = CLAMP ((l - 208 * v - 100 * u + 128) >> 8, 0, 255);
+      dst[2] = CLAMP ((l + 516 * u + 128) >> 8, 0, 255);
+      dst += 3;
+    }
+  }
+}
+
+/**
+ * @brief 2nd pass, bilinear scaling of RGB image (videoscale).
+ */
+static void
+_scale_rgb (const guint8 * src, gint width, gint height, guint8 * dst,
+    gint out_width, gint out_height)
+{
+  gint x, y, c, sx, sy, x0, x1, y0, y1, fx, fy, top, bottom;
+
+  /* pixel centers aligned, 8-bit fraction */
+  for (y = 0; y < out_height; y++) {
+    sy = MAX ((2 * y + 1) * height * 128 / out_height - 128, 0);
+    y0 = MIN (sy >> 8, height - 1);
+    y1 = MIN (y0 + 1, height - 1);
+    fy = sy & 0xff;
+
+    for (x = 0; x < out_width; x++) {
+      sx = MAX ((2 * x + 1) * width * 128 / out_width - 128, 0);
+      x0 = MIN (sx >> 8, width - 1);
+      x1 = MIN (x0 + 1, width - 1);
+      fx = sx & 0xff;
+
+      for (c = 0; c < 3; c++) {
+        top = src[(y0 * width + x0) * 3 + c] * (256 - fx) +
+            src[(y0 * width + x1) * 3 + c] * fx;
+        bottom = src[(y1 * width + x0) * 3 + c] * (256 - fx) +
+            src[(y1 * width + x1) * 3 + c] * fx;
+        *dst++ = (guint8) ((top * (256 - fy) + bottom * fy) >> 16);
+      }
+    }
+  }
+}
+
+/**
+ * @brief 3rd pass, typecast and arithmetic (tensor_transform mode=arithmetic).
+ */
+static void
+_typecast_add_div (const guint8 * src, gfloat * dst, gsize size, gfloat add,
+    gfloat div)
+{
+  gsize i;
+
+  for (i = 0; i < size; i++) {
+    dst[i] = ((gfloat) src[i] + add) / div;
+  }
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  gint width = 640;
+  gint height = 480;
+  gint model_width = 300;
+  gint model_height = 300;
+  gint iterations = 200;
+  GOptionContext *optionctx;
+  GError *error = NULL;
+
+  guint8 *frame, *rgb, *scaled;
+  gfloat *dst_chain, *dst_fused;
+  const guint8 *planes[NNS_EX_VIDEO_MAX_PLANES];
+  gint strides[NNS_EX_VIDEO_MAX_PLANES];
+  nns_ex_frame_converter_s *conv;
+  nns_ex_normalize_s norm;
+  gsize frame_size, size, i;
+  gint64 start, chain_time, fused_time;
+  gfloat max_diff = 0.0f;
+  gint n, x, y;
+
+  const GOptionEntry main_entries[] = {
+    {"width", 'W', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &width,
+        "Frame width (I420)", "640"},
+    {"height", 'H', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &height,
+        "Frame height (I420)", "480"},
+    {"model-width", 'w', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &model_width,
+        "Width of the model input", "300"},
+    {"model-height", 'h', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &model_height,
+        "Height of the model input", "300"},
+    {"iterations", 'n', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &iterations,
+        "Number of frames to process", "200"},
+    {NULL}
+  };
+
+  optionctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (optionctx, main_entries, NULL);
+
+  if (!g_option_context_parse (optionctx, &argc, &argv, &error)) {
+    g_printerr ("option parsing failed: %s\n", error->message);
+    g_error_free (error);
+    g_option_context_free (optionctx);
+    return -1;
+  }
+
+  g_option_context_free (optionctx);
+
+  if (width < 2 || height < 2 || (width % 2) || (height % 2) ||
+      model_width <= 0 || model_height <= 0 || iterations <= 0) {
+    g_printerr ("invalid size or iterations (the frame size should be even)\n");
+    return -1;
+  }
+
+  frame_size = (gsize) width * height * 3 / 2;
+  size = (gsize) model_width * model_height * 3;
+
+  frame = g_malloc (frame_size);
+  rgb = g_malloc ((gsize) width * height * 3);
+  scaled = g_malloc (size);
+  dst_chain = g_new (gfloat, size);
+  dst_fused = g_new (gfloat, size);
+
+  planes[0] = frame;
+  planes[1] = frame + width * height;
+  planes[2] = planes[1] + (width / 2) * (height / 2);
+  strides[0] = width;
+  strides[1] = strides[2] = width / 2;
+
+  /* smooth gradients, so both scalers give the close values */
+  for (y = 0; y < height; y++) {
+    for (x = 0; x < width; x++) {
+      frame[y * width + x] =
+          (guint8) (128 + 80 * sin (x * 0.02) * cos (y * 0.015));
+    }
+  }
+
+  for (y = 0; y < height / 2; y++) {
+    for (x = 0; x < width / 2; x++) {
+      frame[width * height + y * (width / 2) + x] =
+          (guint8) (128 + 40 * cos (x * 0.03));
+      frame[width * height * 5 / 4 + y * (width / 2) + x] =
+          (guint8) (128 + 40 * sin (y * 0.03));
+    }
+  }
+
+  nns_ex_normalize_init (&norm, 3, NORM_MEAN, NORM_STD);
+  conv = nns_ex_frame_converter_new (NNS_EX_VIDEO_FORMAT_I420, width, height,
+      model_width, model_height, FALSE);
+
+  /* warm up */
+  _i420_to_rgb (planes[0], planes[1], planes[2], rgb, width, height);
+  _scale_rgb (rgb, width, height, scaled, model_width, model_height);
+  _typecast_add_div (scaled, dst_chain, size, -NORM_MEAN, NORM_STD);
+  nns_ex_frame_converter_to_float32 (conv, planes, strides, dst_fused, &norm);
+
+  for (i = 0; i < size; i++)
+    max_diff = MAX (max_diff, fabsf (dst_chain[i] - dst_fused[i]));
+
+  start = g_get_monotonic_time ();
+  for (n = 0; n < iterations; n++) {
+    _i420_to_rgb (planes[0], planes[1], planes[2], rgb, width, height);
+    _scale_rgb (rgb, width, height, scaled, model_width, model_height);
+    _typecast_add_div (scaled, dst_chain, size, -NORM_MEAN, NORM_STD);
+  }
+  chain_time = g_get_monotonic_time () - start;
+
+  start = g_get_monotonic_time ();
+  for (n = 0; n < iterations; n++) {
+    nns_ex_frame_converter_to_float32 (conv, planes, strides, dst_fused,
+        &norm);
+  }
+  fused_time = g_get_monotonic_time () - start;
+
+  g_print ("I420 %dx%d to float32 3:%d:%d, %d iterations, max diff %g\n",
+      width, height, model_width, model_height, iterations, max_diff);
+  g_print ("convert + scale + arithmetic : %.2f us/frame\n",
+      (gdouble) chain_time / iterations);
+  g_print ("single pass                  : %.2f us/frame (x%.2f)\n",
+      (gdouble) fused_time / iterations,
+      (gdouble) chain_time / MAX (fused_time, 1));
+
+  nns_ex_frame_converter_free (conv);
+  g_free (frame);
+  g_free (rgb);
+  g_free (scaled);
+  g_free (dst_chain);
+  g_free (dst_fused);
+  return 0;
+}
@@ -0,0 +1,195 @@
+/**
+ * @file	nnstreamer_benchmark_topk.c
+ * @date	19 October 2026
+ * @brief	Microbenchmark of the top-K decoder of the classification scores
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * Compares the scalar argmax loop of the classification examples with nns_ex_topk,
+ * for uint8 (quantized) and float32 scores of 1001 classes.
+ *
+ * Run example :
+ * $ ./nnstreamer_benchmark_topk [--classes=1001] [--k=5] [--iterations=100000]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <glib.h>
+
+#include "nns_ex_topk.h"
+
+/**
+ * @brief Scalar argmax of the examples (uint8).
+ */
+static gint
+_argmax_uint8_scalar (const guint8 * scores, guint len)
+{
+  guint i;
+  gint index = -1;
+  guint8 max_score = 0;
+
+  for (i = 0; i < len; i++) {
+    if (scores[i] > 0 && scores[i] > max_score) {
+      index = i;
+      max_score = scores[i];
+    }
+  }
+
+  return index;
+}
+
+/**
+ * @brief Scalar argmax of the examples (float32).
+ */
+static gint
+_argmax_float32_scalar (const gfloat * scores, guint len)
+{
+  guint i;
+  gint index = -1;
+  gfloat max_score = 0.0f;
+
+  for (i = 0; i < len; i++) {
+    if (scores[i] > 0 && scores[i] > max_score) {
+      index = i;
+      max_score = scores[i];
+    }
+  }
+
+  return index;
+}
+
+/**
+ * @brief Print the elapsed time per call.
+ */
+static void
+_print_result (const gchar * name, gint64 elapsed, gint iterations,
+    gint64 base)
+{
+  g_print ("%-28s : %8.1f ns/call", name, elapsed * 1000.0 / iterations);
+  if (base > 0)
+    g_print (" (x%.2f)", (gdouble) base / MAX (elapsed, 1));
+  g_print ("\n");
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  gint classes = 1001;
+  gint k = 5;
+  gint iterations = 100000;
+  GOptionContext *optionctx;
+  GError *error = NULL;
+
+  const nns_ex_quant_s quant = { 1.0f / 256.0f, 0 };
+  nns_ex_topk_entry_s top[NNS_EX_TOPK_MAX];
+  guint8 *scores_u8;
+  gfloat *scores_f32;
+  gint64 start, base;
+  gint i, n, index, found = 0;
+  volatile gint sink = 0;
+
+  const GOptionEntry main_entries[] = {
+    {"classes", 'c', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &classes,
+        "Number of classes", "1001"},
+    {"k", 'k', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &k,
+        "Number of the top entries", "5"},
+    {"iterations", 'n', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &iterations,
+        "Number of calls", "100000"},
+    {NULL}
+  };
+
+  optionctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (optionctx, main_entries, NULL);
+
+  if (!g_option_context_parse (optionctx, &argc, &argv, &error)) {
+    g_printerr ("option parsing failed: %s\n", error->message);
+    g_error_free (error);
+    g_option_context_free (optionctx);
+    return -1;
+  }
+
+  g_option_context_free (optionctx);
+
+  if (classes <= 0 || k <= 0 || k > NNS_EX_TOPK_MAX || iterations <= 0) {
+    g_printerr ("invalid classes, k (1 ~ %d) or iterations\n",
+        NNS_EX_TOPK_MAX);
+    return -1;
+  }
+
+  scores_u8 = g_new (guint8, classes);
+  scores_f32 = g_new (gfloat, classes);
+
+  /* softmax-like output, low scores with a few peaks */
+  for (i = 0; i < classes; i++) {
+    scores_u8[i] = (guint8) g_random_int_range (0, 4);
+    scores_f32[i] = (gfloat) g_random_double_range (0.0, 0.001);
+  }
+  for (i = 0; i < 5; i++) {
+    index = g_random_int_range (0, classes);
+    scores_u8[index] = (guint8) g_random_int_range (20, 200);
+    scores_f32[index] = (gfloat) g_random_double_range (0.05, 0.8);
+  }
+
+  /* check the results */
+  if (_argmax_uint8_scalar (scores_u8, classes) !=
+      nns_ex_argmax_uint8 (scores_u8, classes, &quant, 0.0f) ||
+      _argmax_float32_scalar (scores_f32, classes) !=
+      nns_ex_argmax_float32 (scores_f32, classes, 0.0f)) {
+    g_printerr ("the results are different\n");
+    return -1;
+  }
+
+  g_print ("%d classes, top %d, %d iterations\n", classes, k, iterations);
+
+  start = g_get_monotonic_time ();
+  for (n = 0; n < iterations; n++)
+    sink += _argmax_uint8_scalar (scores_u8, classes);
+  base = g_get_monotonic_time () - start;
+  _print_result ("uint8 argmax (scalar)", base, iterations, 0);
+
+  start = g_get_monotonic_time ();
+  for (n = 0; n < iterations; n++)
+    sink += nns_ex_argmax_uint8 (scores_u8, classes, &quant, 0.0f);
+  _print_result ("uint8 argmax", g_get_monotonic_time () - start, iterations,
+      base);
+
+  start = g_get_monotonic_time ();
+  for (n = 0; n < iterations; n++)
+    sink += nns_ex_topk_uint8 (scores_u8, classes, k, &quant, 0.0f, top);
+  _print_result ("uint8 top-k", g_get_monotonic_time () - start, iterations,
+      base);
+
+  start = g_get_monotonic_time ();
+  for (n = 0; n < iterations; n++)
+    sink += nns_ex_topk_uint8 (scores_u8, classes, k, &quant, 0.05f, top);
+  _print_result ("uint8 top-k (threshold 0.05)",
+      g_get_monotonic_time () - start, iterations, base);
+
+  start = g_get_monotonic_time ();
+  for (n = 0; n < iterations; n++)
+    sink += _argmax_float32_scalar (scores_f32, classes);
+  base = g_get_monotonic_time () - start;
+  _print_result ("float32 argmax (scalar)", base, iterations, 0);
+
+  start = g_get_monotonic_time ();
+  for (n = 0; n < iterations; n++)
+    sink += nns_ex_argmax_float32 (scores_f32, classes, 0.0f);
+  _print_result ("float32 argmax", g_get_monotonic_time () - start,
+      iterations, base);
+
+  start = g_get_monotonic_time ();
+  for (n = 0; n < iterations; n++)
+    found = nns_ex_topk_float32 (scores_f32, classes, k, 0.0f, top);
+  _print_result ("float32 top-k", g_get_monotonic_time () - start,
+      iterations, base);
+
+  for (i = 0; i < found; i++)
+    g_print ("  #%d class %u score %f\n", i + 1, top[i].index, top[i].score);
+
+  g_free (scores_u8);
+  g_free (scores_f32);
+  return (sink == -1) ? 1 : 0;
+}
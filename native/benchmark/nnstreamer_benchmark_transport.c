@@ -0,0 +1,418 @@
+/**
+ * @file	nnstreamer_benchmark_transport.c
+ * @date	19 October 2026
+ * @brief	Bandwidth and latency of the frames between the devices, JPEG and the framed raw frames
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * Sends the camera-like frames over localhost with tcpserversink and tcpclientsrc, as the multi-device
+ * example (android/multi_device_shared_lib), and prints a line for each transport :
+ * jpeg (jpegenc, jpegparse ! jpegdec ! videoconvert), raw, lz4 and zstd (nns_ex_tensor_pay, nns_ex_tensor_depay).
+ * The metrics are the bytes per frame, the bandwidth at the framerate, the latency from the sender to
+ * the receiver, the CPU time per frame (both sides, in this process) and the PSNR of the received frames.
+ *
+ * Pipeline :
+ * videotestsrc is-live=true ! video/x-raw,format=RGB,width=480,height=480 ! identity ! (jpegenc | nns_ex_tensor_pay) ! tcpserversink
+ * tcpclientsrc ! (jpegparse ! jpegdec ! videoconvert | nns_ex_tensor_depay) ! video/x-raw,format=RGB ! fakesink
+ *
+ * Run example :
+ * $ ./nnstreamer_benchmark_transport [--frames=300] [--width=480] [--height=480] [--fps=30] [--pattern=ball] [--port=5100]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <glib.h>
+#include <gst/gst.h>
+
+#include "nns_ex_transport.h"
+
+/**
+ * @brief Metrics of a transport.
+ */
+typedef struct
+{
+  GMutex lock; /**< lock of the sent frames */
+  GQueue sent; /**< the frames sent, and the time (in order, TCP does not drop the frames) */
+  GQueue sent_time; /**< monotonic time of the sent frames */
+  GArray *latency; /**< latency (in microseconds) of the received frames */
+  guint64 bytes; /**< bytes of the stream */
+  guint received; /**< count of the received frames */
+  gdouble sq_error; /**< sum of the squared error of the received frames */
+  guint64 samples; /**< count of the compared bytes */
+  gboolean connected; /**< true if the receiver is connected */
+  GCond cond; /**< signal of the connection and the received frames */
+} BenchData;
+
+/**
+ * @brief Compare the latency.
+ */
+static gint
+_compare_latency (gconstpointer a, gconstpointer b)
+{
+  gint64 x = *(const gint64 *) a;
+  gint64 y = *(const gint64 *) b;
+
+  return (x > y) - (x < y);
+}
+
+/**
+ * @brief Probe of the frames to send.
+ */
+static GstPadProbeReturn
+_sent_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  BenchData *data = (BenchData *) user_data;
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+
+  g_mutex_lock (&data->lock);
+  g_queue_push_tail (&data->sent, gst_buffer_ref (buffer));
+  g_queue_push_tail (&data->sent_time,
+      GSIZE_TO_POINTER ((gsize) g_get_monotonic_time ()));
+  g_mutex_unlock (&data->lock);
+
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Probe of the stream, the bytes sent.
+ */
+static GstPadProbeReturn
+_bytes_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  BenchData *data = (BenchData *) user_data;
+
+  data->bytes += gst_buffer_get_size (GST_PAD_PROBE_INFO_BUFFER (info));
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief The receiver is connected.
+ */
+static void
+_client_added_cb (GstElement * element, GObject * socket, gpointer user_data)
+{
+  BenchData *data = (BenchData *) user_data;
+
+  g_mutex_lock (&data->lock);
+  data->connected = TRUE;
+  g_cond_signal (&data->cond);
+  g_mutex_unlock (&data->lock);
+}
+
+/**
+ * @brief Handoff of the received frames, the latency and the error.
+ */
+static void
+_received_cb (GstElement * element, GstBuffer * buffer, GstPad * pad,
+    gpointer user_data)
+{
+  BenchData *data = (BenchData *) user_data;
+  GstBuffer *sent;
+  GstMapInfo a, b;
+  gint64 latency, now = g_get_monotonic_time ();
+  gsize i;
+  gint d;
+
+  g_mutex_lock (&data->lock);
+  sent = (GstBuffer *) g_queue_pop_head (&data->sent);
+  latency = now - (gint64) GPOINTER_TO_SIZE (g_queue_pop_head
+      (&data->sent_time));
+  g_cond_signal (&data->cond);
+  g_mutex_unlock (&data->lock);
+
+  if (sent == NULL)
+    return;
+
+  g_array_append_val (data->latency, latency);
+  data->received++;
+
+  if (gst_buffer_map (sent, &a, GST_MAP_READ)) {
+    if (gst_buffer_map (buffer, &b, GST_MAP_READ)) {
+      for (i = 0; i < MIN (a.size, b.size); i++) {
+        d = (gint) a.data[i] - (gint) b.data[i];
+        data->sq_error += d * d;
+      }
+
+      data->samples += MIN (a.size, b.size);
+      gst_buffer_unmap (buffer, &b);
+    }
+
+    gst_buffer_unmap (sent, &a);
+  }
+
+  gst_buffer_unref (sent);
+}
+
+/**
+ * @brief Wait for the end of the stream or the error of the sender.
+ */
+static gboolean
+_wait_eos (GstElement * pipeline)
+{
+  GstBus *bus;
+  GstMessage *msg;
+  GError *error = NULL;
+  gboolean ret = TRUE;
+
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_timed_pop_filtered (bus, 60 * GST_SECOND,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+
+  if (msg == NULL) {
+    g_printerr ("timeout\n");
+    ret = FALSE;
+  } else if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR) {
+    gst_message_parse_error (msg, &error, NULL);
+    g_printerr ("%s : %s\n", GST_OBJECT_NAME (GST_MESSAGE_SRC (msg)),
+        error->message);
+    g_error_free (error);
+    ret = FALSE;
+  }
+
+  if (msg)
+    gst_message_unref (msg);
+  gst_object_unref (bus);
+  return ret;
+}
+
+/**
+ * @brief Send the frames with the transport, and print the metrics.
+ */
+static gboolean
+_run (const gchar * transport, gint frames, gint width, gint height,
+    gint fps, const gchar * pattern, gint port)
+{
+  const gchar *enc, *dec;
+  gchar *desc;
+  GstElement *sender, *receiver, *element;
+  GstPad *pad;
+  GError *error = NULL;
+  BenchData data;
+  clock_t cpu;
+  gint64 *samples, end_time;
+  gdouble mse, psnr, cpu_ms;
+  guint n;
+  gboolean ret = FALSE;
+
+  if (g_str_equal (transport, "jpeg")) {
+    enc = "jpegenc";
+    dec = "jpegparse ! jpegdec ! videoconvert";
+  } else {
+    enc = NULL;
+    dec = "nns_ex_tensor_depay";
+
+    if (!nns_ex_transport_codec_supported (nns_ex_transport_codec_from_string
+            (g_str_equal (transport, "raw") ? "none" : transport))) {
+      g_print ("%-6s  (not built)\n", transport);
+      return TRUE;
+    }
+  }
+
+  memset (&data, 0, sizeof (BenchData));
+  g_mutex_init (&data.lock);
+  g_cond_init (&data.cond);
+  g_queue_init (&data.sent);
+  g_queue_init (&data.sent_time);
+  data.latency = g_array_new (FALSE, FALSE, sizeof (gint64));
+
+  if (enc) {
+    desc = g_strdup_printf ("videotestsrc is-live=true num-buffers=%d "
+        "pattern=%s ! video/x-raw,format=RGB,width=%d,height=%d,"
+        "framerate=%d/1 ! identity name=in ! %s ! "
+        "tcpserversink name=net host=127.0.0.1 port=%d sync=false",
+        frames, pattern, width, height, fps, enc, port);
+  } else {
+    desc = g_strdup_printf ("videotestsrc is-live=true num-buffers=%d "
+        "pattern=%s ! video/x-raw,format=RGB,width=%d,height=%d,"
+        "framerate=%d/1 ! identity name=in ! "
+        "nns_ex_tensor_pay compression=%s ! "
+        "tcpserversink name=net host=127.0.0.1 port=%d sync=false",
+        frames, pattern, width, height, fps,
+        g_str_equal (transport, "raw") ? "none" : transport, port);
+  }
+
+  sender = gst_parse_launch (desc, &error);
+  g_free (desc);
+
+  if (error) {
+    g_printerr ("%s : failed to make the sender: %s\n", transport,
+        error->message);
+    g_clear_error (&error);
+    goto done;
+  }
+
+  desc = g_strdup_printf ("tcpclientsrc host=127.0.0.1 port=%d ! %s ! "
+      "video/x-raw,format=RGB,width=%d,height=%d ! "
+      "fakesink name=out signal-handoffs=true sync=false",
+      port, dec, width, height);
+  receiver = gst_parse_launch (desc, &error);
+  g_free (desc);
+
+  if (error) {
+    g_printerr ("%s : failed to make the receiver: %s\n", transport,
+        error->message);
+    g_clear_error (&error);
+    gst_object_unref (sender);
+    goto done;
+  }
+
+  element = gst_bin_get_by_name (GST_BIN (sender), "in");
+  pad = gst_element_get_static_pad (element, "src");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, _sent_probe, &data,
+      NULL);
+  gst_object_unref (pad);
+  gst_object_unref (element);
+
+  element = gst_bin_get_by_name (GST_BIN (sender), "net");
+  pad = gst_element_get_static_pad (element, "sink");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, _bytes_probe, &data,
+      NULL);
+  g_signal_connect (element, "client-added", G_CALLBACK (_client_added_cb),
+      &data);
+  gst_object_unref (pad);
+  gst_object_unref (element);
+
+  element = gst_bin_get_by_name (GST_BIN (receiver), "out");
+  g_signal_connect (element, "handoff", G_CALLBACK (_received_cb), &data);
+  gst_object_unref (element);
+
+  /* the server listens (the live source does not push in PAUSED), then the receiver connects */
+  gst_element_set_state (sender, GST_STATE_PAUSED);
+  gst_element_get_state (sender, NULL, NULL, GST_CLOCK_TIME_NONE);
+  gst_element_set_state (receiver, GST_STATE_PLAYING);
+
+  end_time = g_get_monotonic_time () + 5 * G_TIME_SPAN_SECOND;
+  g_mutex_lock (&data.lock);
+  while (!data.connected) {
+    if (!g_cond_wait_until (&data.cond, &data.lock, end_time))
+      break;
+  }
+  g_mutex_unlock (&data.lock);
+
+  if (!data.connected) {
+    g_printerr ("%s : the receiver is not connected (port %d)\n", transport,
+        port);
+  } else {
+    cpu = clock ();
+    gst_element_set_state (sender, GST_STATE_PLAYING);
+
+    /* tcpserversink keeps the connection after EOS, wait for the frames sent */
+    ret = _wait_eos (sender);
+
+    end_time = g_get_monotonic_time () + 5 * G_TIME_SPAN_SECOND;
+    g_mutex_lock (&data.lock);
+    while (ret && !g_queue_is_empty (&data.sent)) {
+      if (!g_cond_wait_until (&data.cond, &data.lock, end_time)) {
+        g_printerr ("%s : %u frames are not received\n", transport,
+            g_queue_get_length (&data.sent));
+        ret = FALSE;
+      }
+    }
+    g_mutex_unlock (&data.lock);
+
+    cpu_ms = (gdouble) (clock () - cpu) * 1000.0 / CLOCKS_PER_SEC;
+
+    n = data.latency->len;
+    if (ret && n > 0) {
+      g_array_sort (data.latency, _compare_latency);
+      samples = (gint64 *) data.latency->data;
+
+      mse = data.samples ? data.sq_error / data.samples : 0.0;
+      psnr = (mse > 0.0) ? 10.0 * log10 (255.0 * 255.0 / mse) : 99.99;
+
+      g_print ("%-6s  %10.1f  %9.1f  %8.2f  %8.2f  %8.2f  %8.2f  %6.2f\n",
+          transport, (gdouble) data.bytes / n / 1024.0,
+          (gdouble) data.bytes * 8.0 * fps / n / 1000000.0,
+          samples[n / 2] / 1000.0, samples[n * 95 / 100] / 1000.0,
+          samples[n - 1] / 1000.0, cpu_ms / n, psnr);
+    }
+  }
+
+  gst_element_set_state (receiver, GST_STATE_NULL);
+  gst_element_set_state (sender, GST_STATE_NULL);
+  gst_object_unref (receiver);
+  gst_object_unref (sender);
+
+done:
+  g_queue_foreach (&data.sent, (GFunc) gst_buffer_unref, NULL);
+  g_queue_clear (&data.sent);
+  g_queue_clear (&data.sent_time);
+  g_array_free (data.latency, TRUE);
+  g_cond_clear (&data.cond);
+  g_mutex_clear (&data.lock);
+  return ret;
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  const gchar *transports[] = { "jpeg", "raw", "lz4", "zstd" };
+  gchar *pattern = NULL;
+  gint frames = 300;
+  gint width = 480;
+  gint height = 480;
+  gint fps = 30;
+  gint port = 5100;
+  guint i;
+  GOptionContext *optionctx;
+  GError *error = NULL;
+
+  const GOptionEntry main_entries[] = {
+    {"frames", 'f', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &frames,
+        "Number of the frames to send", "300"},
+    {"width", 'W', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &width,
+        "Width of the frame", "480"},
+    {"height", 'H', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &height,
+        "Height of the frame", "480"},
+    {"fps", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &fps,
+        "Framerate of the source", "30"},
+    {"pattern", 'p', G_OPTION_FLAG_NONE, G_OPTION_ARG_STRING, &pattern,
+        "Pattern of videotestsrc (ball, smpte, snow, ...)", "ball"},
+    {"port", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &port,
+        "TCP port on localhost", "5100"},
+    {NULL}
+  };
+
+  optionctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (optionctx, main_entries, NULL);
+
+  if (!g_option_context_parse (optionctx, &argc, &argv, &error)) {
+    g_printerr ("option parsing failed: %s\n", error->message);
+    g_error_free (error);
+    g_option_context_free (optionctx);
+    return -1;
+  }
+
+  g_option_context_free (optionctx);
+
+  if (frames <= 0 || width <= 0 || height <= 0 || fps <= 0 || port <= 0) {
+    g_printerr ("invalid option\n");
+    g_free (pattern);
+    return -1;
+  }
+
+  gst_init (&argc, &argv);
+  nns_ex_tensor_pay_register ();
+  nns_ex_tensor_depay_register ();
+
+  g_print ("%d frames %dx%d RGB, %d fps, pattern %s, localhost\n", frames,
+      width, height, fps, pattern ? pattern : "ball");
+  g_print ("        KiB/frame  Mbit/s   p50(ms)   p95(ms)   max(ms)  "
+      "cpu(ms)  psnr(dB)\n");
+
+  for (i = 0; i < G_N_ELEMENTS (transports); i++) {
+    /* a port for each run, the previous socket may be in TIME_WAIT */
+    if (!_run (transports[i], frames, width, height, fps,
+            pattern ? pattern : "ball", port + (gint) i))
+      break;
+  }
+
+  g_free (pattern);
+  return 0;
+}
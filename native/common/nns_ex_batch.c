@@ -0,0 +1,1088 @@
+/**
+ * @file	nns_ex_batch.c
+ * @date	19 October 2026
+ * @brief	Element to collect the frames into a batched tensor within a latency budget
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "nns_ex_batch.h"
+
+GST_DEBUG_CATEGORY_STATIC (nns_ex_batch_debug);
+#define GST_CAT_DEFAULT nns_ex_batch_debug
+
+/**
+ * @brief Default properties.
+ */
+#define DEFAULT_BATCH_SIZE 1
+#define DEFAULT_MAX_LATENCY 33
+
+/**
+ * @brief Count of the batches kept for the lookup.
+ */
+#define BATCH_HISTORY 32
+
+/**
+ * @brief Rank of the tensor, the last dimension is the batch.
+ */
+#define BATCH_RANK 4
+
+/**
+ * @brief Key of the source data in the sink pad.
+ */
+#define BATCH_SOURCE_KEY "nns-ex-batch-source"
+
+/**
+ * @brief Properties.
+ */
+enum
+{
+  PROP_0,
+  PROP_BATCH_SIZE,
+  PROP_MAX_LATENCY
+};
+
+/**
+ * @brief Data of a sink pad.
+ */
+typedef struct
+{
+  guint index; /**< index of the pad (sink_%u) */
+  GstSegment segment; /**< segment of the stream */
+  gboolean eos; /**< true if the stream is ended */
+} _batch_source_s;
+
+/**
+ * @brief Frame waiting for the batch.
+ */
+typedef struct
+{
+  GstBuffer *buffer; /**< tensor of the frame */
+  guint source; /**< index of the sink pad */
+  GstClockTime pts; /**< timestamp of the frame */
+  GstClockTime running_time; /**< running time of the frame */
+  gint64 arrival; /**< monotonic time when the frame arrived */
+} _batch_frame_s;
+
+/**
+ * @brief Data structure for the element.
+ */
+typedef struct
+{
+  GstElement parent; /**< parent object */
+
+  GstPad *srcpad; /**< batched tensor */
+  guint batch_size; /**< max frames in a batch */
+  guint max_latency; /**< max time (in milliseconds) to wait for the batch */
+  guint next_index; /**< index of the next sink pad (object lock) */
+
+  GMutex lock; /**< lock for the frames and the stream */
+  GCond cond; /**< signaled when a frame arrives, or a batch is taken */
+  GQueue frames; /**< frames waiting for the batch (_batch_frame_s) */
+  guint num_sources; /**< count of the sink pads */
+  guint num_eos; /**< count of the sink pads ended */
+  gboolean flushing; /**< true if the src pad is flushing */
+  GstFlowReturn srcresult; /**< last result of the src pad */
+
+  gsize frame_size; /**< size of a frame, 0 until the caps are negotiated */
+  guint dims[BATCH_RANK]; /**< dimension of a frame */
+  gchar *type; /**< type of the tensor */
+  GstCaps *out_caps; /**< caps of the batched tensor */
+  gboolean caps_changed; /**< true to push the caps */
+  gboolean need_stream_start; /**< true to push the stream-start and segment */
+  gboolean eos_sent; /**< true if EOS is pushed */
+  GstClockTime last_pts; /**< timestamp of the last batch */
+
+  nns_ex_batch_info_s history[BATCH_HISTORY]; /**< frames of the last batches (object lock) */
+  GstClockTime history_pts[BATCH_HISTORY]; /**< timestamps of the last batches (object lock) */
+  guint history_index; /**< next slot of the history */
+  nns_ex_batch_stats_s stats; /**< metrics (object lock) */
+} NnsExBatch;
+
+/**
+ * @brief Data structure for the element class.
+ */
+typedef struct
+{
+  GstElementClass parent_class; /**< parent class */
+} NnsExBatchClass;
+
+G_DEFINE_TYPE (NnsExBatch, nns_ex_batch, GST_TYPE_ELEMENT);
+
+static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink_%u",
+    GST_PAD_SINK,
+    GST_PAD_REQUEST,
+    GST_STATIC_CAPS ("other/tensor"));
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("other/tensor"));
+
+/**
+ * @brief Get the size of an element of the tensor type, 0 if unknown.
+ */
+static gsize
+_batch_type_size (const gchar * type)
+{
+  if (g_strcmp0 (type, "uint8") == 0 || g_strcmp0 (type, "int8") == 0)
+    return 1;
+  if (g_strcmp0 (type, "uint16") == 0 || g_strcmp0 (type, "int16") == 0)
+    return 2;
+  if (g_strcmp0 (type, "uint32") == 0 || g_strcmp0 (type, "int32") == 0 ||
+      g_strcmp0 (type, "float32") == 0)
+    return 4;
+  if (g_strcmp0 (type, "uint64") == 0 || g_strcmp0 (type, "int64") == 0 ||
+      g_strcmp0 (type, "float64") == 0)
+    return 8;
+  return 0;
+}
+
+/**
+ * @brief Parse the dimension (e.g., '3:640:480:1'), the rest is 1.
+ */
+static gboolean
+_batch_parse_dimension (const gchar * str, guint * dims)
+{
+  gchar **values;
+  gchar *end;
+  guint64 v;
+  guint i, n;
+  gboolean ret = TRUE;
+
+  if (str == NULL)
+    return FALSE;
+
+  values = g_strsplit (str, ":", -1);
+  n = g_strv_length (values);
+
+  if (n == 0 || n > BATCH_RANK) {
+    g_strfreev (values);
+    return FALSE;
+  }
+
+  for (i = 0; i < BATCH_RANK; i++) {
+    dims[i] = 1;
+
+    if (i < n) {
+      v = g_ascii_strtoull (values[i], &end, 10);
+      if (end == values[i] || *end != '\0' || v == 0 || v > G_MAXUINT16) {
+        ret = FALSE;
+        break;
+      }
+
+      dims[i] = (guint) v;
+    }
+  }
+
+  g_strfreev (values);
+  return ret;
+}
+
+/**
+ * @brief Release the frame.
+ */
+static void
+_batch_frame_free (gpointer data)
+{
+  _batch_frame_s *frame = (_batch_frame_s *) data;
+
+  gst_buffer_unref (frame->buffer);
+  g_free (frame);
+}
+
+/**
+ * @brief Release the frames waiting. Call this with the lock.
+ */
+static void
+_batch_clear_frames (NnsExBatch * self)
+{
+  _batch_frame_s *frame;
+
+  while ((frame = g_queue_pop_head (&self->frames)) != NULL)
+    _batch_frame_free (frame);
+
+  g_cond_broadcast (&self->cond);
+}
+
+/**
+ * @brief Release the stream info.
+ */
+static void
+_batch_reset (NnsExBatch * self)
+{
+  GList *l;
+  _batch_source_s *source;
+
+  g_mutex_lock (&self->lock);
+  _batch_clear_frames (self);
+
+  self->frame_size = 0;
+  g_free (self->type);
+  self->type = NULL;
+  gst_caps_replace (&self->out_caps, NULL);
+  self->caps_changed = FALSE;
+  self->need_stream_start = TRUE;
+  self->eos_sent = FALSE;
+  self->last_pts = GST_CLOCK_TIME_NONE;
+  self->num_eos = 0;
+
+  GST_OBJECT_LOCK (self);
+  for (l = GST_ELEMENT (self)->sinkpads; l; l = l->next) {
+    source = g_object_get_data (G_OBJECT (l->data), BATCH_SOURCE_KEY);
+    source->eos = FALSE;
+    gst_segment_init (&source->segment, GST_FORMAT_TIME);
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  g_mutex_unlock (&self->lock);
+}
+
+/**
+ * @brief Set the tensor of the frames, all sink pads should have the same tensor.
+ */
+static gboolean
+_batch_set_caps (NnsExBatch * self, GstCaps * caps)
+{
+  GstStructure *structure;
+  const gchar *dimension, *type;
+  guint dims[BATCH_RANK];
+  gchar *out_dimension;
+  gsize size;
+  gboolean ret = TRUE;
+
+  structure = gst_caps_get_structure (caps, 0);
+  dimension = gst_structure_get_string (structure, "dimension");
+  type = gst_structure_get_string (structure, "type");
+  size = _batch_type_size (type);
+
+  if (!_batch_parse_dimension (dimension, dims) || size == 0) {
+    GST_ERROR_OBJECT (self, "invalid caps %" GST_PTR_FORMAT, caps);
+    return FALSE;
+  }
+
+  if (dims[BATCH_RANK - 1] != 1) {
+    GST_ERROR_OBJECT (self, "the batch dimension of the frame should be 1 (%s)",
+        dimension);
+    return FALSE;
+  }
+
+  size *= (gsize) dims[0] * dims[1] * dims[2];
+
+  g_mutex_lock (&self->lock);
+  if (self->frame_size == 0) {
+    self->frame_size = size;
+    memcpy (self->dims, dims, sizeof (dims));
+    self->type = g_strdup (type);
+
+    out_dimension = g_strdup_printf ("%u:%u:%u:%u", dims[0], dims[1], dims[2],
+        self->batch_size);
+    gst_caps_replace (&self->out_caps, NULL);
+    self->out_caps = gst_caps_new_simple ("other/tensor",
+        "dimension", G_TYPE_STRING, out_dimension,
+        "type", G_TYPE_STRING, type,
+        "framerate", GST_TYPE_FRACTION, 0, 1, NULL);
+    self->caps_changed = TRUE;
+    g_free (out_dimension);
+  } else if (self->frame_size != size ||
+      memcmp (self->dims, dims, sizeof (dims)) != 0 ||
+      g_strcmp0 (self->type, type) != 0) {
+    GST_ERROR_OBJECT (self, "all sink pads should have the same tensor, %"
+        GST_PTR_FORMAT, caps);
+    ret = FALSE;
+  }
+  g_mutex_unlock (&self->lock);
+
+  return ret;
+}
+
+/**
+ * @brief Push the sticky events before the first batch.
+ */
+static void
+_batch_push_events (NnsExBatch * self)
+{
+  GstCaps *caps = NULL;
+  GstSegment segment;
+  gboolean stream_start;
+  gchar *stream_id;
+
+  g_mutex_lock (&self->lock);
+  stream_start = self->need_stream_start;
+  self->need_stream_start = FALSE;
+
+  if (self->caps_changed) {
+    caps = gst_caps_ref (self->out_caps);
+    self->caps_changed = FALSE;
+  }
+  g_mutex_unlock (&self->lock);
+
+  if (stream_start) {
+    stream_id = gst_pad_create_stream_id (self->srcpad, GST_ELEMENT (self),
+        NULL);
+    gst_pad_push_event (self->srcpad, gst_event_new_stream_start (stream_id));
+    g_free (stream_id);
+  }
+
+  if (caps) {
+    gst_pad_push_event (self->srcpad, gst_event_new_caps (caps));
+    gst_caps_unref (caps);
+  }
+
+  /* the timestamps of the batches are the running time */
+  if (stream_start) {
+    gst_segment_init (&segment, GST_FORMAT_TIME);
+    gst_pad_push_event (self->srcpad, gst_event_new_segment (&segment));
+  }
+}
+
+/**
+ * @brief Make the batch of the frames, and keep the frames for the lookup.
+ */
+static GstBuffer *
+_batch_make (NnsExBatch * self, _batch_frame_s ** frames, guint n,
+    gsize frame_size, gboolean timeout)
+{
+  nns_ex_batch_info_s *info;
+  GstBuffer *buffer;
+  GstMapInfo map;
+  GstClockTime pts = GST_CLOCK_TIME_NONE;
+  gint64 now;
+  guint i;
+
+  buffer = gst_buffer_new_allocate (NULL, frame_size * self->batch_size, NULL);
+  if (buffer == NULL || !gst_buffer_map (buffer, &map, GST_MAP_WRITE)) {
+    if (buffer)
+      gst_buffer_unref (buffer);
+    return NULL;
+  }
+
+  for (i = 0; i < n; i++) {
+    gst_buffer_extract (frames[i]->buffer, 0, map.data + i * frame_size,
+        frame_size);
+
+    if (GST_CLOCK_TIME_IS_VALID (frames[i]->running_time) &&
+        (!GST_CLOCK_TIME_IS_VALID (pts) || frames[i]->running_time > pts))
+      pts = frames[i]->running_time;
+  }
+
+  /* the model takes the fixed batch size */
+  if (n < self->batch_size)
+    memset (map.data + n * frame_size, 0, (self->batch_size - n) * frame_size);
+
+  gst_buffer_unmap (buffer, &map);
+
+  /* unique timestamp to find the batch */
+  if (GST_CLOCK_TIME_IS_VALID (self->last_pts) &&
+      (!GST_CLOCK_TIME_IS_VALID (pts) || pts <= self->last_pts))
+    pts = self->last_pts + 1;
+  else if (!GST_CLOCK_TIME_IS_VALID (pts))
+    pts = 0;
+
+  self->last_pts = pts;
+  GST_BUFFER_PTS (buffer) = pts;
+
+  now = g_get_monotonic_time ();
+
+  GST_OBJECT_LOCK (self);
+  info = &self->history[self->history_index];
+  self->history_pts[self->history_index] = pts;
+  self->history_index = (self->history_index + 1) % BATCH_HISTORY;
+
+  info->frames = n;
+  info->push_time = now;
+
+  for (i = 0; i < n; i++) {
+    info->sources[i] = frames[i]->source;
+    info->pts[i] = frames[i]->pts;
+    info->arrival[i] = frames[i]->arrival;
+
+    self->stats.max_wait = MAX (self->stats.max_wait,
+        now - frames[i]->arrival);
+  }
+
+  self->stats.batches++;
+  self->stats.frames += n;
+  self->stats.padded += self->batch_size - n;
+  if (timeout)
+    self->stats.timeouts++;
+  GST_OBJECT_UNLOCK (self);
+
+  GST_LOG_OBJECT (self, "batch of %u frames%s, pts %" GST_TIME_FORMAT, n,
+      timeout ? " (max-latency)" : "", GST_TIME_ARGS (pts));
+  return buffer;
+}
+
+/**
+ * @brief Task of the src pad, push a batch when it is full or the first frame has waited max-latency.
+ */
+static void
+nns_ex_batch_loop (gpointer user_data)
+{
+  NnsExBatch *self = (NnsExBatch *) user_data;
+  _batch_frame_s *frames[NNS_EX_BATCH_MAX];
+  _batch_frame_s *first;
+  GstBuffer *buffer;
+  GstFlowReturn ret;
+  gboolean eos, timeout = FALSE;
+  gint64 deadline;
+  gsize frame_size;
+  guint n, i;
+
+  g_mutex_lock (&self->lock);
+  for (;;) {
+    if (self->flushing)
+      goto flushing;
+
+    n = g_queue_get_length (&self->frames);
+    eos = (self->num_sources > 0 && self->num_eos == self->num_sources);
+
+    /* the rest of the frames at the end of the streams */
+    if (n >= self->batch_size || (n > 0 && eos))
+      break;
+
+    if (n == 0) {
+      if (eos)
+        goto eos;
+
+      g_cond_wait (&self->cond, &self->lock);
+      continue;
+    }
+
+    if (self->max_latency == 0) {
+      g_cond_wait (&self->cond, &self->lock);
+      continue;
+    }
+
+    first = g_queue_peek_head (&self->frames);
+    deadline = first->arrival + self->max_latency * G_TIME_SPAN_MILLISECOND;
+
+    if (g_get_monotonic_time () >= deadline) {
+      timeout = TRUE;
+      break;
+    }
+
+    g_cond_wait_until (&self->cond, &self->lock, deadline);
+  }
+
+  n = MIN (n, self->batch_size);
+  for (i = 0; i < n; i++)
+    frames[i] = g_queue_pop_head (&self->frames);
+
+  frame_size = self->frame_size;
+
+  /* room for the sink pads */
+  g_cond_broadcast (&self->cond);
+  g_mutex_unlock (&self->lock);
+
+  _batch_push_events (self);
+
+  buffer = _batch_make (self, frames, n, frame_size, timeout);
+
+  for (i = 0; i < n; i++)
+    _batch_frame_free (frames[i]);
+
+  if (buffer == NULL) {
+    GST_ELEMENT_ERROR (self, RESOURCE, FAILED, (NULL),
+        ("failed to allocate the batch"));
+    ret = GST_FLOW_ERROR;
+  } else {
+    ret = gst_pad_push (self->srcpad, buffer);
+  }
+
+  if (ret == GST_FLOW_OK)
+    return;
+
+  g_mutex_lock (&self->lock);
+  self->srcresult = ret;
+  g_cond_broadcast (&self->cond);
+  g_mutex_unlock (&self->lock);
+
+  if (ret == GST_FLOW_FLUSHING) {
+    gst_pad_pause_task (self->srcpad);
+    return;
+  }
+
+  if (ret == GST_FLOW_NOT_LINKED || ret < GST_FLOW_EOS) {
+    GST_ELEMENT_ERROR (self, STREAM, FAILED, ("Internal data flow error."),
+        ("streaming task paused, reason %s (%d)", gst_flow_get_name (ret),
+            ret));
+  }
+
+  gst_pad_push_event (self->srcpad, gst_event_new_eos ());
+  gst_pad_pause_task (self->srcpad);
+  return;
+
+eos:
+  self->srcresult = GST_FLOW_EOS;
+  eos = !self->eos_sent;
+  self->eos_sent = TRUE;
+  g_cond_broadcast (&self->cond);
+  g_mutex_unlock (&self->lock);
+
+  if (eos) {
+    _batch_push_events (self);
+    gst_pad_push_event (self->srcpad, gst_event_new_eos ());
+  }
+
+  gst_pad_pause_task (self->srcpad);
+  return;
+
+flushing:
+  g_mutex_unlock (&self->lock);
+  gst_pad_pause_task (self->srcpad);
+}
+
+/**
+ * @brief Queue the frame for the batch.
+ */
+static GstFlowReturn
+nns_ex_batch_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  NnsExBatch *self = (NnsExBatch *) parent;
+  _batch_source_s *source;
+  _batch_frame_s *frame;
+  GstFlowReturn ret;
+
+  source = g_object_get_data (G_OBJECT (pad), BATCH_SOURCE_KEY);
+
+  frame = g_new0 (_batch_frame_s, 1);
+  frame->buffer = buffer;
+  frame->source = source->index;
+  frame->pts = GST_BUFFER_PTS (buffer);
+  frame->running_time = GST_CLOCK_TIME_NONE;
+  frame->arrival = g_get_monotonic_time ();
+
+  if (GST_CLOCK_TIME_IS_VALID (frame->pts))
+    frame->running_time = gst_segment_to_running_time (&source->segment,
+        GST_FORMAT_TIME, frame->pts);
+
+  g_mutex_lock (&self->lock);
+  if (self->frame_size == 0) {
+    ret = GST_FLOW_NOT_NEGOTIATED;
+    goto done;
+  }
+
+  if (gst_buffer_get_size (buffer) != self->frame_size) {
+    GST_ELEMENT_ERROR (self, STREAM, FORMAT, (NULL),
+        ("invalid frame size %" G_GSIZE_FORMAT ", expected %" G_GSIZE_FORMAT,
+            gst_buffer_get_size (buffer), self->frame_size));
+    ret = GST_FLOW_ERROR;
+    goto done;
+  }
+
+  /* wait for the room, the leaky queue of the live source drops the frames */
+  while (!self->flushing && self->srcresult == GST_FLOW_OK &&
+      g_queue_get_length (&self->frames) >= 2 * self->batch_size)
+    g_cond_wait (&self->cond, &self->lock);
+
+  ret = self->flushing ? GST_FLOW_FLUSHING : self->srcresult;
+  if (ret == GST_FLOW_OK) {
+    g_queue_push_tail (&self->frames, frame);
+    g_cond_broadcast (&self->cond);
+    frame = NULL;
+  }
+
+done:
+  g_mutex_unlock (&self->lock);
+
+  if (frame)
+    _batch_frame_free (frame);
+
+  return ret;
+}
+
+/**
+ * @brief Handle the events of the sink pads.
+ */
+static gboolean
+nns_ex_batch_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
+{
+  NnsExBatch *self = (NnsExBatch *) parent;
+  _batch_source_s *source;
+  GstCaps *caps;
+  gboolean ret;
+
+  source = g_object_get_data (G_OBJECT (pad), BATCH_SOURCE_KEY);
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_CAPS:
+      gst_event_parse_caps (event, &caps);
+      ret = _batch_set_caps (self, caps);
+      gst_event_unref (event);
+      return ret;
+
+    case GST_EVENT_SEGMENT:
+      gst_event_copy_segment (event, &source->segment);
+      if (source->segment.format != GST_FORMAT_TIME)
+        GST_WARNING_OBJECT (pad, "not a time segment, no running time");
+      gst_event_unref (event);
+      return TRUE;
+
+    case GST_EVENT_STREAM_START:
+      /* the src pad starts its own stream */
+      gst_event_unref (event);
+      return TRUE;
+
+    case GST_EVENT_EOS:
+      g_mutex_lock (&self->lock);
+      if (!source->eos) {
+        source->eos = TRUE;
+        self->num_eos++;
+      }
+      g_cond_broadcast (&self->cond);
+      g_mutex_unlock (&self->lock);
+      gst_event_unref (event);
+      return TRUE;
+
+    case GST_EVENT_FLUSH_START:
+      g_mutex_lock (&self->lock);
+      self->flushing = TRUE;
+      g_cond_broadcast (&self->cond);
+      g_mutex_unlock (&self->lock);
+
+      ret = gst_pad_push_event (self->srcpad, event);
+      gst_pad_pause_task (self->srcpad);
+      return ret;
+
+    case GST_EVENT_FLUSH_STOP:
+      g_mutex_lock (&self->lock);
+      _batch_clear_frames (self);
+      self->flushing = FALSE;
+      self->srcresult = GST_FLOW_OK;
+      self->eos_sent = FALSE;
+      if (source->eos) {
+        source->eos = FALSE;
+        self->num_eos--;
+      }
+      gst_segment_init (&source->segment, GST_FORMAT_TIME);
+      g_mutex_unlock (&self->lock);
+
+      ret = gst_pad_push_event (self->srcpad, event);
+      gst_pad_start_task (self->srcpad, nns_ex_batch_loop, self, NULL);
+      return ret;
+
+    default:
+      break;
+  }
+
+  return gst_pad_event_default (pad, parent, event);
+}
+
+/**
+ * @brief Handle the queries of the sink pads, the frames do not have the batch dimension of the src pad.
+ */
+static gboolean
+nns_ex_batch_sink_query (GstPad * pad, GstObject * parent, GstQuery * query)
+{
+  GstCaps *filter, *caps, *tmp;
+
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_CAPS:
+      gst_query_parse_caps (query, &filter);
+      caps = gst_pad_get_pad_template_caps (pad);
+
+      if (filter) {
+        tmp = gst_caps_intersect_full (filter, caps, GST_CAPS_INTERSECT_FIRST);
+        gst_caps_unref (caps);
+        caps = tmp;
+      }
+
+      gst_query_set_caps_result (query, caps);
+      gst_caps_unref (caps);
+      return TRUE;
+
+    case GST_QUERY_ALLOCATION:
+      /* the frames are copied to the batch */
+      return FALSE;
+
+    default:
+      break;
+  }
+
+  return gst_pad_query_default (pad, parent, query);
+}
+
+/**
+ * @brief Handle the queries of the src pad, the latency includes max-latency.
+ */
+static gboolean
+nns_ex_batch_src_query (GstPad * pad, GstObject * parent, GstQuery * query)
+{
+  NnsExBatch *self = (NnsExBatch *) parent;
+  GstCaps *filter, *caps, *tmp;
+  GstClockTime min, max;
+  gboolean live, ret;
+
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_CAPS:
+      gst_query_parse_caps (query, &filter);
+
+      g_mutex_lock (&self->lock);
+      caps = self->out_caps ? gst_caps_ref (self->out_caps) :
+          gst_pad_get_pad_template_caps (pad);
+      g_mutex_unlock (&self->lock);
+
+      if (filter) {
+        tmp = gst_caps_intersect_full (filter, caps, GST_CAPS_INTERSECT_FIRST);
+        gst_caps_unref (caps);
+        caps = tmp;
+      }
+
+      gst_query_set_caps_result (query, caps);
+      gst_caps_unref (caps);
+      return TRUE;
+
+    case GST_QUERY_LATENCY:
+      ret = gst_pad_query_default (pad, parent, query);
+      if (ret) {
+        gst_query_parse_latency (query, &live, &min, &max);
+        min += self->max_latency * GST_MSECOND;
+        if (GST_CLOCK_TIME_IS_VALID (max))
+          max += self->max_latency * GST_MSECOND;
+        gst_query_set_latency (query, live, min, max);
+      }
+      return ret;
+
+    default:
+      break;
+  }
+
+  return gst_pad_query_default (pad, parent, query);
+}
+
+/**
+ * @brief Start or stop the task of the src pad.
+ */
+static gboolean
+nns_ex_batch_src_activate_mode (GstPad * pad, GstObject * parent,
+    GstPadMode mode, gboolean active)
+{
+  NnsExBatch *self = (NnsExBatch *) parent;
+
+  if (mode != GST_PAD_MODE_PUSH)
+    return FALSE;
+
+  g_mutex_lock (&self->lock);
+  self->flushing = !active;
+  self->srcresult = active ? GST_FLOW_OK : GST_FLOW_FLUSHING;
+  g_cond_broadcast (&self->cond);
+  g_mutex_unlock (&self->lock);
+
+  if (active)
+    return gst_pad_start_task (pad, nns_ex_batch_loop, self, NULL);
+
+  return gst_pad_stop_task (pad);
+}
+
+/**
+ * @brief Add a sink pad (sink_%u) for a source.
+ */
+static GstPad *
+nns_ex_batch_request_new_pad (GstElement * element, GstPadTemplate * templ,
+    const gchar * name, const GstCaps * caps)
+{
+  NnsExBatch *self = (NnsExBatch *) element;
+  _batch_source_s *source;
+  GstPad *pad;
+  gchar *pad_name;
+  guint index;
+
+  GST_OBJECT_LOCK (self);
+  if (name && sscanf (name, "sink_%u", &index) == 1) {
+    self->next_index = MAX (self->next_index, index + 1);
+  } else {
+    index = self->next_index++;
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  pad_name = g_strdup_printf ("sink_%u", index);
+  pad = gst_pad_new_from_template (templ, pad_name);
+  g_free (pad_name);
+
+  source = g_new0 (_batch_source_s, 1);
+  source->index = index;
+  gst_segment_init (&source->segment, GST_FORMAT_TIME);
+  g_object_set_data_full (G_OBJECT (pad), BATCH_SOURCE_KEY, source, g_free);
+
+  gst_pad_set_chain_function (pad, nns_ex_batch_chain);
+  gst_pad_set_event_function (pad, nns_ex_batch_sink_event);
+  gst_pad_set_query_function (pad, nns_ex_batch_sink_query);
+
+  g_mutex_lock (&self->lock);
+  self->num_sources++;
+  g_mutex_unlock (&self->lock);
+
+  if (!gst_element_add_pad (element, pad)) {
+    GST_WARNING_OBJECT (self, "failed to add the pad sink_%u", index);
+
+    g_mutex_lock (&self->lock);
+    self->num_sources--;
+    g_mutex_unlock (&self->lock);
+
+    gst_object_unref (pad);
+    return NULL;
+  }
+
+  return pad;
+}
+
+/**
+ * @brief Remove the sink pad.
+ */
+static void
+nns_ex_batch_release_pad (GstElement * element, GstPad * pad)
+{
+  NnsExBatch *self = (NnsExBatch *) element;
+  _batch_source_s *source;
+
+  source = g_object_get_data (G_OBJECT (pad), BATCH_SOURCE_KEY);
+
+  g_mutex_lock (&self->lock);
+  self->num_sources--;
+  if (source->eos)
+    self->num_eos--;
+  g_cond_broadcast (&self->cond);
+  g_mutex_unlock (&self->lock);
+
+  gst_element_remove_pad (element, pad);
+}
+
+/**
+ * @brief Reset the metrics when the element starts, and release the frames when it stops.
+ */
+static GstStateChangeReturn
+nns_ex_batch_change_state (GstElement * element, GstStateChange transition)
+{
+  NnsExBatch *self = (NnsExBatch *) element;
+  GstStateChangeReturn ret;
+  guint i;
+
+  if (transition == GST_STATE_CHANGE_READY_TO_PAUSED) {
+    _batch_reset (self);
+
+    GST_OBJECT_LOCK (self);
+    memset (&self->stats, 0, sizeof (nns_ex_batch_stats_s));
+    for (i = 0; i < BATCH_HISTORY; i++)
+      self->history_pts[i] = GST_CLOCK_TIME_NONE;
+    self->history_index = 0;
+    GST_OBJECT_UNLOCK (self);
+  }
+
+  ret = GST_ELEMENT_CLASS (nns_ex_batch_parent_class)->change_state (element,
+      transition);
+
+  if (transition == GST_STATE_CHANGE_PAUSED_TO_READY)
+    _batch_reset (self);
+
+  return ret;
+}
+
+/**
+ * @brief Set the property.
+ */
+static void
+nns_ex_batch_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  NnsExBatch *self = (NnsExBatch *) object;
+
+  switch (prop_id) {
+    case PROP_BATCH_SIZE:
+      self->batch_size = g_value_get_uint (value);
+      break;
+    case PROP_MAX_LATENCY:
+      self->max_latency = g_value_get_uint (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+/**
+ * @brief Get the property.
+ */
+static void
+nns_ex_batch_get_property (GObject * object, guint prop_id, GValue * value,
+    GParamSpec * pspec)
+{
+  NnsExBatch *self = (NnsExBatch *) object;
+
+  switch (prop_id) {
+    case PROP_BATCH_SIZE:
+      g_value_set_uint (value, self->batch_size);
+      break;
+    case PROP_MAX_LATENCY:
+      g_value_set_uint (value, self->max_latency);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+/**
+ * @brief Finalize the element.
+ */
+static void
+nns_ex_batch_finalize (GObject * object)
+{
+  NnsExBatch *self = (NnsExBatch *) object;
+
+  g_queue_foreach (&self->frames, (GFunc) _batch_frame_free, NULL);
+  g_queue_clear (&self->frames);
+  g_free (self->type);
+  gst_caps_replace (&self->out_caps, NULL);
+  g_mutex_clear (&self->lock);
+  g_cond_clear (&self->cond);
+
+  G_OBJECT_CLASS (nns_ex_batch_parent_class)->finalize (object);
+}
+
+/**
+ * @brief Initialize the element class.
+ */
+static void
+nns_ex_batch_class_init (NnsExBatchClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+
+  GST_DEBUG_CATEGORY_INIT (nns_ex_batch_debug, NNS_EX_BATCH_NAME, 0,
+      "Batching the frames within a latency budget");
+
+  gobject_class->set_property = nns_ex_batch_set_property;
+  gobject_class->get_property = nns_ex_batch_get_property;
+  gobject_class->finalize = nns_ex_batch_finalize;
+
+  g_object_class_install_property (gobject_class, PROP_BATCH_SIZE,
+      g_param_spec_uint ("batch-size", "Batch size",
+          "Max count of the frames in a batch (the last dimension of the output)",
+          1, NNS_EX_BATCH_MAX, DEFAULT_BATCH_SIZE,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_MAX_LATENCY,
+      g_param_spec_uint ("max-latency", "Max latency",
+          "Max time (ms) the first frame waits for the batch, "
+          "0 to wait for the full batch",
+          0, G_MAXUINT16, DEFAULT_MAX_LATENCY,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+
+  element_class->change_state = nns_ex_batch_change_state;
+  element_class->request_new_pad = nns_ex_batch_request_new_pad;
+  element_class->release_pad = nns_ex_batch_release_pad;
+
+  gst_element_class_add_static_pad_template (element_class, &sink_template);
+  gst_element_class_add_static_pad_template (element_class, &src_template);
+
+  gst_element_class_set_static_metadata (element_class,
+      "NNStreamer example batch", "Filter/Tensor",
+      "Collects the frames into a batched tensor within a latency budget",
+      "agent <agent@local>");
+}
+
+/**
+ * @brief Initialize the element.
+ */
+static void
+nns_ex_batch_init (NnsExBatch * self)
+{
+  guint i;
+
+  self->srcpad = gst_pad_new_from_static_template (&src_template, "src");
+  gst_pad_set_activatemode_function (self->srcpad,
+      nns_ex_batch_src_activate_mode);
+  gst_pad_set_query_function (self->srcpad, nns_ex_batch_src_query);
+  gst_pad_use_fixed_caps (self->srcpad);
+  gst_element_add_pad (GST_ELEMENT (self), self->srcpad);
+
+  self->batch_size = DEFAULT_BATCH_SIZE;
+  self->max_latency = DEFAULT_MAX_LATENCY;
+  self->next_index = 0;
+
+  g_mutex_init (&self->lock);
+  g_cond_init (&self->cond);
+  g_queue_init (&self->frames);
+  self->num_sources = self->num_eos = 0;
+  self->flushing = TRUE;
+  self->srcresult = GST_FLOW_FLUSHING;
+
+  self->frame_size = 0;
+  self->type = NULL;
+  self->out_caps = NULL;
+  self->caps_changed = FALSE;
+  self->need_stream_start = TRUE;
+  self->eos_sent = FALSE;
+  self->last_pts = GST_CLOCK_TIME_NONE;
+  for (i = 0; i < BATCH_HISTORY; i++)
+    self->history_pts[i] = GST_CLOCK_TIME_NONE;
+  self->history_index = 0;
+  memset (&self->stats, 0, sizeof (nns_ex_batch_stats_s));
+}
+
+/**
+ * @brief Register the element 'nns_ex_batch' to the application.
+ */
+gboolean
+nns_ex_batch_register (void)
+{
+  return gst_element_register (NULL, NNS_EX_BATCH_NAME, GST_RANK_NONE,
+      nns_ex_batch_get_type ());
+}
+
+/**
+ * @brief Find the frames of the batch.
+ */
+gboolean
+nns_ex_batch_lookup (GstElement * batch, GstClockTime pts,
+    nns_ex_batch_info_s * info)
+{
+  NnsExBatch *self;
+  gboolean found = FALSE;
+  guint i;
+
+  g_return_val_if_fail (G_TYPE_CHECK_INSTANCE_TYPE (batch,
+          nns_ex_batch_get_type ()), FALSE);
+  g_return_val_if_fail (info != NULL, FALSE);
+
+  if (!GST_CLOCK_TIME_IS_VALID (pts))
+    return FALSE;
+
+  self = (NnsExBatch *) batch;
+
+  GST_OBJECT_LOCK (self);
+  for (i = 0; i < BATCH_HISTORY; i++) {
+    if (self->history_pts[i] == pts) {
+      *info = self->history[i];
+      found = TRUE;
+      break;
+    }
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  return found;
+}
+
+/**
+ * @brief Get the metrics of the element.
+ */
+void
+nns_ex_batch_get_stats (GstElement * batch, nns_ex_batch_stats_s * stats)
+{
+  NnsExBatch *self;
+
+  g_return_if_fail (G_TYPE_CHECK_INSTANCE_TYPE (batch,
+          nns_ex_batch_get_type ()));
+  g_return_if_fail (stats != NULL);
+
+  self = (NnsExBatch *) batch;
+
+  GST_OBJECT_LOCK (self);
+  *stats = self->stats;
+  GST_OBJECT_UNLOCK (self);
+}
@@ -0,0 +1,111 @@
+/**
+ * @file	nns_ex_batch.h
+ * @date	19 October 2026
+ * @brief	Element to collect the frames into a batched tensor within a latency budget
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * The element 'nns_ex_batch' stacks up to batch-size frames (e.g., other/tensor 3:640:480:1)
+ * from one or several sink pads along the batch dimension (3:640:480:N), so that tensor_filter
+ * runs the model once for N frames. A batch is pushed when it is full, or when the first frame
+ * of the batch has waited max-latency. The model takes the fixed batch size, so the slots
+ * not filled are zero, and the app splits the output only for the frames in the batch.
+ *
+ * The timestamp of a batch is the running time of the newest frame in the batch,
+ * increased for each batch, and the app finds the frames of the batch with it.
+ *
+ * Usage :
+ *
+ * gst_init (&argc, &argv);
+ * nns_ex_batch_register ();
+ *
+ * v4l2src ! ... ! tensor_converter ! queue leaky=2 ! batch.sink_0
+ * filesrc ! ... ! tensor_converter ! queue ! batch.sink_1
+ * nns_ex_batch name=batch batch-size=4 max-latency=50 ! tensor_filter ... input=3:640:480:4 ... ! tensor_sink
+ *
+ * (new-data callback of tensor_sink)
+ * if (nns_ex_batch_lookup (batch, GST_BUFFER_PTS (buffer), &info)) {
+ *   for (i = 0; i < info.frames; i++)
+ *     (the output i is for the frame info.pts[i] of the sink pad info.sources[i])
+ * }
+ *
+ * Properties :
+ * batch-size : max count of the frames in a batch (the 4th dimension of the output tensor)
+ * max-latency : max time (in milliseconds) the first frame waits for the batch, 0 to wait for the full batch
+ */
+
+#ifndef __NNS_EX_BATCH_H__
+#define __NNS_EX_BATCH_H__
+
+#include <glib.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Name of the element.
+ */
+#define NNS_EX_BATCH_NAME "nns_ex_batch"
+
+/**
+ * @brief Max count of the frames in a batch.
+ */
+#define NNS_EX_BATCH_MAX 16
+
+/**
+ * @brief Frames in a batch.
+ */
+typedef struct
+{
+  guint frames; /**< count of the frames in the batch, the other slots are padding */
+  guint sources[NNS_EX_BATCH_MAX]; /**< index of the sink pad (sink_%u) of each frame */
+  GstClockTime pts[NNS_EX_BATCH_MAX]; /**< timestamp of each frame */
+  gint64 arrival[NNS_EX_BATCH_MAX]; /**< monotonic time when each frame arrived */
+  gint64 push_time; /**< monotonic time when the batch is pushed */
+} nns_ex_batch_info_s;
+
+/**
+ * @brief Metrics of the element.
+ */
+typedef struct
+{
+  guint64 batches; /**< count of the batches pushed */
+  guint64 frames; /**< count of the frames in the batches */
+  guint64 padded; /**< count of the empty slots */
+  guint64 timeouts; /**< count of the batches pushed by max-latency */
+  gint64 max_wait; /**< max time (in microseconds) a frame waited for the batch */
+} nns_ex_batch_stats_s;
+
+/**
+ * @brief Get the type of the element.
+ */
+extern GType
+nns_ex_batch_get_type (void);
+
+/**
+ * @brief Register the element 'nns_ex_batch' to the application.
+ * @return TRUE if the element is registered
+ */
+extern gboolean
+nns_ex_batch_register (void);
+
+/**
+ * @brief Find the frames of the batch.
+ * @param batch the element 'nns_ex_batch'
+ * @param pts timestamp of the output buffer (tensor_filter keeps the timestamp)
+ * @param info the frames of the batch
+ * @return TRUE if found (the element keeps the last 32 batches)
+ */
+extern gboolean
+nns_ex_batch_lookup (GstElement * batch, GstClockTime pts,
+    nns_ex_batch_info_s * info);
+
+/**
+ * @brief Get the metrics of the element, kept until the next start.
+ */
+extern void
+nns_ex_batch_get_stats (GstElement * batch, nns_ex_batch_stats_s * stats);
+
+G_END_DECLS
+
+#endif /* __NNS_EX_BATCH_H__ */
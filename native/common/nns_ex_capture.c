@@ -0,0 +1,439 @@
+/**
+ * @file	nns_ex_capture.c
+ * @date	19 October 2026
+ * @brief	Platform-neutral buffer path of the camera source (frame provider, pooled wrappers and SPSC queue)
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ */
+
+#include <string.h>
+
+#include "nns_ex_capture.h"
+#include "nns_ex_tensor_ring.h"
+
+/**
+ * @brief Data structure for the wrapper of a frame, shared by the memories of the buffer.
+ */
+typedef struct _capture_wrapper_s
+{
+  struct _capture_wrapper_s *next; /**< next wrapper in the pool */
+  volatile gint refcount; /**< count of the memories of the frame */
+  nns_ex_capture_s *capture; /**< buffer path of the frame */
+  gpointer handle; /**< frame of the provider */
+} _capture_wrapper_s;
+
+/**
+ * @brief Data structure for the buffer path.
+ *
+ * The pool is a lock-free stack : the wrappers are returned from any thread (the last memory freed),
+ * and taken by the camera callback only, so the compare-and-exchange of the head is free from ABA.
+ * Each frame in use holds a reference of the buffer path.
+ */
+struct _nns_ex_capture_s
+{
+  nns_ex_capture_provider_s provider; /**< frame provider */
+  nns_ex_tensor_ring_s *ring; /**< queue of the buffers */
+  gpointer pool; /**< free wrappers (lock-free stack) */
+  volatile gint refcount; /**< owner and the frames in use */
+
+  volatile gint started; /**< true to enqueue the frames */
+  volatile gint reset; /**< true to skip the next frame (set by start) */
+  GstClockTime previous_pts; /**< timestamp of the previous frame (camera callback) */
+
+  volatile gint frames; /**< count of the frames enqueued */
+  volatile gint skipped; /**< count of the frames released at once */
+  volatile gint unavailable; /**< count of the callbacks without a frame */
+  volatile gint wrappers; /**< count of the wrappers allocated */
+};
+
+/**
+ * @brief Data structure for the synthetic provider.
+ */
+struct _nns_ex_capture_synthetic_s
+{
+  guint width; /**< width of the frame */
+  guint height; /**< height of the frame */
+  guint max_images; /**< number of the frames */
+  guint8 **images; /**< NV12 frames */
+  volatile gint *in_use; /**< true if the frame is held */
+  guint next; /**< index of the next frame to acquire */
+  guint count; /**< count of the frames acquired */
+};
+
+/**
+ * @brief Return the wrapper to the pool (any thread).
+ */
+static void
+_capture_pool_push (nns_ex_capture_s * capture, _capture_wrapper_s * wrapper)
+{
+  gpointer head;
+
+  do {
+    head = g_atomic_pointer_get (&capture->pool);
+    wrapper->next = (_capture_wrapper_s *) head;
+  } while (!g_atomic_pointer_compare_and_exchange (&capture->pool, head,
+          wrapper));
+}
+
+/**
+ * @brief Take the wrapper from the pool (camera callback only).
+ */
+static _capture_wrapper_s *
+_capture_pool_pop (nns_ex_capture_s * capture)
+{
+  _capture_wrapper_s *head;
+
+  do {
+    head = (_capture_wrapper_s *) g_atomic_pointer_get (&capture->pool);
+    if (head == NULL)
+      return NULL;
+  } while (!g_atomic_pointer_compare_and_exchange (&capture->pool, head,
+          head->next));
+
+  return head;
+}
+
+/**
+ * @brief Release the reference of the buffer path, and free it with the last reference.
+ */
+static void
+_capture_unref (nns_ex_capture_s * capture)
+{
+  _capture_wrapper_s *wrapper;
+
+  if (!g_atomic_int_dec_and_test (&capture->refcount))
+    return;
+
+  nns_ex_tensor_ring_free (capture->ring);
+
+  while ((wrapper = _capture_pool_pop (capture)) != NULL)
+    g_free (wrapper);
+
+  g_free (capture);
+}
+
+/**
+ * @brief Release the frame when the last memory of the buffer is freed.
+ */
+static void
+_capture_wrapper_release (gpointer data)
+{
+  _capture_wrapper_s *wrapper = (_capture_wrapper_s *) data;
+  nns_ex_capture_s *capture = wrapper->capture;
+
+  if (!g_atomic_int_dec_and_test (&wrapper->refcount))
+    return;
+
+  capture->provider.release (capture->provider.user_data, wrapper->handle);
+  wrapper->handle = NULL;
+
+  _capture_pool_push (capture, wrapper);
+  _capture_unref (capture);
+}
+
+/**
+ * @brief Create the buffer path.
+ */
+nns_ex_capture_s *
+nns_ex_capture_new (const nns_ex_capture_provider_s * provider,
+    guint max_frames)
+{
+  nns_ex_capture_s *capture;
+  guint i;
+
+  g_return_val_if_fail (provider != NULL, NULL);
+  g_return_val_if_fail (provider->acquire != NULL, NULL);
+  g_return_val_if_fail (provider->release != NULL, NULL);
+  g_return_val_if_fail (max_frames > 0, NULL);
+
+  capture = g_new0 (nns_ex_capture_s, 1);
+  capture->provider = *provider;
+  capture->ring = nns_ex_tensor_ring_new (max_frames,
+      NNS_EX_TENSOR_RING_DROP_OLDEST);
+  if (capture->ring == NULL) {
+    g_free (capture);
+    return NULL;
+  }
+
+  capture->refcount = 1;
+  capture->previous_pts = GST_CLOCK_TIME_NONE;
+
+  for (i = 0; i < max_frames; i++) {
+    _capture_pool_push (capture, g_new0 (_capture_wrapper_s, 1));
+    capture->wrappers++;
+  }
+
+  return capture;
+}
+
+/**
+ * @brief Release the buffer path.
+ */
+void
+nns_ex_capture_free (nns_ex_capture_s * capture)
+{
+  g_return_if_fail (capture != NULL);
+
+  nns_ex_capture_stop (capture);
+  nns_ex_tensor_ring_set_flushing (capture->ring, TRUE);
+  _capture_unref (capture);
+}
+
+/**
+ * @brief Start to enqueue the frames.
+ */
+void
+nns_ex_capture_start (nns_ex_capture_s * capture)
+{
+  g_return_if_fail (capture != NULL);
+
+  g_atomic_int_set (&capture->reset, 1);
+  g_atomic_int_set (&capture->started, 1);
+}
+
+/**
+ * @brief Stop to enqueue the frames, and release the queued frames.
+ */
+void
+nns_ex_capture_stop (nns_ex_capture_s * capture)
+{
+  GstBuffer *buffer;
+
+  g_return_if_fail (capture != NULL);
+
+  g_atomic_int_set (&capture->started, 0);
+
+  while (nns_ex_tensor_ring_pop_batch (capture->ring, &buffer, 1, 0) > 0)
+    gst_buffer_unref (buffer);
+}
+
+/**
+ * @brief Acquire the latest frame from the provider and enqueue the buffer.
+ */
+gboolean
+nns_ex_capture_on_frame (nns_ex_capture_s * capture, GstClockTime pts)
+{
+  nns_ex_capture_frame_s frame;
+  _capture_wrapper_s *wrapper;
+  GstClockTime duration = GST_CLOCK_TIME_NONE;
+  GstBuffer *buffer;
+  guint i;
+
+  g_return_val_if_fail (capture != NULL, FALSE);
+
+  if (g_atomic_int_compare_and_exchange (&capture->reset, 1, 0))
+    capture->previous_pts = GST_CLOCK_TIME_NONE;
+
+  memset (&frame, 0, sizeof (frame));
+  if (!capture->provider.acquire (capture->provider.user_data, &frame)) {
+    g_atomic_int_inc (&capture->unavailable);
+    return FALSE;
+  }
+
+  /* skip the first frame to get the duration */
+  if (!g_atomic_int_get (&capture->started) || frame.n_planes == 0 ||
+      (GST_CLOCK_TIME_IS_VALID (pts) &&
+          !GST_CLOCK_TIME_IS_VALID (capture->previous_pts))) {
+    capture->previous_pts = pts;
+    capture->provider.release (capture->provider.user_data, frame.handle);
+    g_atomic_int_inc (&capture->skipped);
+    return FALSE;
+  }
+
+  if (GST_CLOCK_TIME_IS_VALID (pts))
+    duration = pts - capture->previous_pts;
+  capture->previous_pts = pts;
+
+  wrapper = _capture_pool_pop (capture);
+  if (wrapper == NULL) {
+    wrapper = g_new0 (_capture_wrapper_s, 1);
+    g_atomic_int_inc (&capture->wrappers);
+  }
+
+  wrapper->capture = capture;
+  wrapper->handle = frame.handle;
+  wrapper->refcount = (gint) MIN (frame.n_planes, NNS_EX_CAPTURE_MAX_PLANES);
+  g_atomic_int_inc (&capture->refcount);
+
+  buffer = gst_buffer_new ();
+  GST_BUFFER_PTS (buffer) = pts;
+  GST_BUFFER_DURATION (buffer) = duration;
+
+  for (i = 0; i < frame.n_planes && i < NNS_EX_CAPTURE_MAX_PLANES; i++) {
+    gst_buffer_append_memory (buffer,
+        gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY, frame.data[i],
+            frame.size[i], 0, frame.size[i], wrapper,
+            _capture_wrapper_release));
+  }
+
+  g_atomic_int_inc (&capture->frames);
+
+  /* the ring drops the oldest frame if the streaming thread is behind */
+  return nns_ex_tensor_ring_push (capture->ring, buffer);
+}
+
+/**
+ * @brief Dequeue the buffer, waiting until a frame is available.
+ */
+GstBuffer *
+nns_ex_capture_pop (nns_ex_capture_s * capture)
+{
+  GstBuffer *buffer;
+
+  g_return_val_if_fail (capture != NULL, NULL);
+
+  if (nns_ex_tensor_ring_pop_batch (capture->ring, &buffer, 1, -1) == 0)
+    return NULL;
+
+  return buffer;
+}
+
+/**
+ * @brief Set the flushing state.
+ */
+void
+nns_ex_capture_set_flushing (nns_ex_capture_s * capture, gboolean flushing)
+{
+  g_return_if_fail (capture != NULL);
+
+  nns_ex_tensor_ring_set_flushing (capture->ring, flushing);
+}
+
+/**
+ * @brief Get the metrics of the buffer path.
+ */
+void
+nns_ex_capture_get_stats (nns_ex_capture_s * capture,
+    nns_ex_capture_stats_s * stats)
+{
+  nns_ex_tensor_ring_stats_s ring_stats;
+
+  g_return_if_fail (capture != NULL);
+  g_return_if_fail (stats != NULL);
+
+  nns_ex_tensor_ring_get_stats (capture->ring, &ring_stats);
+
+  stats->frames = (guint) g_atomic_int_get (&capture->frames);
+  stats->skipped = (guint) g_atomic_int_get (&capture->skipped);
+  stats->unavailable = (guint) g_atomic_int_get (&capture->unavailable);
+  stats->dropped = ring_stats.dropped;
+  stats->popped = ring_stats.popped;
+  stats->wrappers = (guint) g_atomic_int_get (&capture->wrappers);
+  stats->in_use = (guint) g_atomic_int_get (&capture->refcount) - 1;
+}
+
+/**
+ * @brief Acquire the next free frame of the synthetic provider.
+ */
+static gboolean
+_synthetic_acquire (gpointer user_data, nns_ex_capture_frame_s * frame)
+{
+  nns_ex_capture_synthetic_s *synthetic =
+      (nns_ex_capture_synthetic_s *) user_data;
+  gsize luma = (gsize) synthetic->width * synthetic->height;
+  guint i, idx;
+  guint8 *image;
+
+  for (i = 0; i < synthetic->max_images; i++) {
+    idx = (synthetic->next + i) % synthetic->max_images;
+
+    if (g_atomic_int_compare_and_exchange (&synthetic->in_use[idx], 0, 1))
+      break;
+  }
+
+  /* all frames are held, like maxImages of AImageReader */
+  if (i == synthetic->max_images)
+    return FALSE;
+
+  synthetic->next = (idx + 1) % synthetic->max_images;
+  image = synthetic->images[idx];
+
+  /* update a row of the luma, the content changes without the cost of drawing the frame */
+  memset (image + (gsize) (synthetic->count % synthetic->height) *
+      synthetic->width, (guint8) synthetic->count, synthetic->width);
+  synthetic->count++;
+
+  frame->handle = GUINT_TO_POINTER (idx + 1);
+  frame->n_planes = 2;
+  frame->data[0] = image;
+  frame->size[0] = luma;
+  frame->data[1] = image + luma;
+  frame->size[1] = luma / 2;
+  return TRUE;
+}
+
+/**
+ * @brief Release the frame of the synthetic provider.
+ */
+static void
+_synthetic_release (gpointer user_data, gpointer handle)
+{
+  nns_ex_capture_synthetic_s *synthetic =
+      (nns_ex_capture_synthetic_s *) user_data;
+
+  g_atomic_int_set (&synthetic->in_use[GPOINTER_TO_UINT (handle) - 1], 0);
+}
+
+/**
+ * @brief Create the synthetic provider of NV12 frames.
+ */
+nns_ex_capture_synthetic_s *
+nns_ex_capture_synthetic_new (guint width, guint height, guint max_images)
+{
+  nns_ex_capture_synthetic_s *synthetic;
+  gsize size = (gsize) width * height * 3 / 2;
+  guint i;
+
+  g_return_val_if_fail (width > 0 && width % 2 == 0, NULL);
+  g_return_val_if_fail (height > 0 && height % 2 == 0, NULL);
+  g_return_val_if_fail (max_images > 0, NULL);
+
+  synthetic = g_new0 (nns_ex_capture_synthetic_s, 1);
+  synthetic->width = width;
+  synthetic->height = height;
+  synthetic->max_images = max_images;
+  synthetic->images = g_new0 (guint8 *, max_images);
+  synthetic->in_use = g_new0 (gint, max_images);
+
+  for (i = 0; i < max_images; i++) {
+    synthetic->images[i] = g_malloc (size);
+    memset (synthetic->images[i], 16, (gsize) width * height);
+    memset (synthetic->images[i] + (gsize) width * height, 128,
+        size - (gsize) width * height);
+  }
+
+  return synthetic;
+}
+
+/**
+ * @brief Free the synthetic provider.
+ */
+void
+nns_ex_capture_synthetic_free (nns_ex_capture_synthetic_s * synthetic)
+{
+  guint i;
+
+  g_return_if_fail (synthetic != NULL);
+
+  for (i = 0; i < synthetic->max_images; i++)
+    g_free (synthetic->images[i]);
+
+  g_free (synthetic->images);
+  g_free ((gpointer) synthetic->in_use);
+  g_free (synthetic);
+}
+
+/**
+ * @brief Get the functions of the synthetic provider.
+ */
+void
+nns_ex_capture_synthetic_get_provider (nns_ex_capture_synthetic_s * synthetic,
+    nns_ex_capture_provider_s * provider)
+{
+  g_return_if_fail (synthetic != NULL);
+  g_return_if_fail (provider != NULL);
+
+  provider->acquire = _synthetic_acquire;
+  provider->release = _synthetic_release;
+  provider->user_data = synthetic;
+}
@@ -0,0 +1,189 @@
+/**
+ * @file	nns_ex_capture.h
+ * @date	19 October 2026
+ * @brief	Platform-neutral buffer path of the camera source (frame provider, pooled wrappers and SPSC queue)
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * The camera callback (e.g., onImageAvailable of AImageReader in ahc2src) calls nns_ex_capture_on_frame(),
+ * which acquires the latest frame from the provider, wraps each plane as the read-only memory
+ * of a new buffer without the copy, and enqueues the buffer. The streaming thread of the source
+ * dequeues the buffer with nns_ex_capture_pop(). The frame is released to the provider
+ * when the last memory of the buffer is freed.
+ *
+ * Per frame, the camera callback does not allocate the wrapper of the frame (taken from a pool,
+ * a lock-free stack returned from any thread), and does not lock the queue
+ * (the single-producer single-consumer ring nns_ex_tensor_ring, dropping the oldest frame when full).
+ * The lock is taken only when the streaming thread waits for a frame.
+ * The buffer and the memories are still allocated by GStreamer for each frame.
+ *
+ * The provider is the platform part : the camera (AImage of the NDK in ahc2src),
+ * or the synthetic frames (nns_ex_capture_synthetic_s) to run and measure the buffer path on Linux
+ * (see nnstreamer_benchmark_capture).
+ *
+ * Usage :
+ *
+ * capture = nns_ex_capture_new (&provider, max_images);
+ * nns_ex_capture_start (capture);
+ *
+ * (camera callback)
+ * nns_ex_capture_on_frame (capture, running_time);
+ *
+ * (create() of the source, NULL if flushing)
+ * buffer = nns_ex_capture_pop (capture);
+ *
+ * (unlock() and unlock_stop() of the source)
+ * nns_ex_capture_set_flushing (capture, TRUE);
+ */
+
+#ifndef __NNS_EX_CAPTURE_H__
+#define __NNS_EX_CAPTURE_H__
+
+#include <glib.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Max number of the planes of a frame.
+ */
+#define NNS_EX_CAPTURE_MAX_PLANES 4
+
+/**
+ * @brief Data structure for a frame acquired from the provider.
+ */
+typedef struct
+{
+  gpointer handle; /**< frame of the provider, given back to release() */
+  guint n_planes; /**< number of the planes */
+  guint8 *data[NNS_EX_CAPTURE_MAX_PLANES]; /**< data of each plane */
+  gsize size[NNS_EX_CAPTURE_MAX_PLANES]; /**< size of each plane */
+} nns_ex_capture_frame_s;
+
+/**
+ * @brief Data structure for the frame provider.
+ */
+typedef struct
+{
+  /**
+   * @brief Acquire the latest frame (the camera callback).
+   * @return FALSE if no frame is available
+   */
+  gboolean (*acquire) (gpointer user_data, nns_ex_capture_frame_s * frame);
+
+  /**
+   * @brief Release the frame, called from the thread freeing the last memory of the buffer.
+   */
+  void (*release) (gpointer user_data, gpointer handle);
+
+  gpointer user_data; /**< data passed to the functions */
+} nns_ex_capture_provider_s;
+
+/**
+ * @brief Metrics of the buffer path.
+ */
+typedef struct
+{
+  guint frames; /**< count of the frames enqueued */
+  guint skipped; /**< count of the frames released at once (not started, or the first frame) */
+  guint unavailable; /**< count of the callbacks without a frame */
+  guint dropped; /**< count of the frames dropped from the queue (full or flushing) */
+  guint popped; /**< count of the frames dequeued */
+  guint wrappers; /**< count of the wrappers allocated (the pool grows to the frames in use) */
+  guint in_use; /**< count of the frames held by the buffers */
+} nns_ex_capture_stats_s;
+
+/**
+ * @brief Opaque data structure for the buffer path.
+ */
+typedef struct _nns_ex_capture_s nns_ex_capture_s;
+
+/**
+ * @brief Opaque data structure for the synthetic provider.
+ */
+typedef struct _nns_ex_capture_synthetic_s nns_ex_capture_synthetic_s;
+
+/**
+ * @brief Create the buffer path.
+ * @param provider the frame provider (copied)
+ * @param max_frames max number of the frames in the queue, and the wrappers allocated first
+ * @return newly allocated buffer path, NULL if the parameters are invalid
+ */
+extern nns_ex_capture_s *
+nns_ex_capture_new (const nns_ex_capture_provider_s * provider,
+    guint max_frames);
+
+/**
+ * @brief Release the buffer path. The queued frames are released,
+ * and the buffer path is freed when all buffers are freed.
+ */
+extern void
+nns_ex_capture_free (nns_ex_capture_s * capture);
+
+/**
+ * @brief Start to enqueue the frames. The first frame is skipped to get the duration.
+ */
+extern void
+nns_ex_capture_start (nns_ex_capture_s * capture);
+
+/**
+ * @brief Stop to enqueue the frames, and release the queued frames.
+ */
+extern void
+nns_ex_capture_stop (nns_ex_capture_s * capture);
+
+/**
+ * @brief Acquire the latest frame from the provider and enqueue the buffer (the camera callback, single producer).
+ * @param pts running time of the frame (GST_CLOCK_TIME_NONE if unknown)
+ * @return TRUE if the buffer is enqueued
+ */
+extern gboolean
+nns_ex_capture_on_frame (nns_ex_capture_s * capture, GstClockTime pts);
+
+/**
+ * @brief Dequeue the buffer, waiting until a frame is available (the streaming thread, single consumer).
+ * @return the buffer (caller should unref it), NULL if flushing
+ */
+extern GstBuffer *
+nns_ex_capture_pop (nns_ex_capture_s * capture);
+
+/**
+ * @brief Set the flushing state, nns_ex_capture_pop() returns NULL while flushing.
+ */
+extern void
+nns_ex_capture_set_flushing (nns_ex_capture_s * capture, gboolean flushing);
+
+/**
+ * @brief Get the metrics of the buffer path.
+ */
+extern void
+nns_ex_capture_get_stats (nns_ex_capture_s * capture,
+    nns_ex_capture_stats_s * stats);
+
+/**
+ * @brief Create the synthetic provider of NV12 frames (like YUV_420_888 of the camera, 2 planes).
+ * @param width width of the frame (even number)
+ * @param height height of the frame (even number)
+ * @param max_images max number of the frames held at once (like maxImages of AImageReader)
+ * @return newly allocated provider, NULL if the parameters are invalid
+ * @note Free the provider after the buffer path and all buffers are freed.
+ */
+extern nns_ex_capture_synthetic_s *
+nns_ex_capture_synthetic_new (guint width, guint height, guint max_images);
+
+/**
+ * @brief Free the synthetic provider.
+ */
+extern void
+nns_ex_capture_synthetic_free (nns_ex_capture_synthetic_s * synthetic);
+
+/**
+ * @brief Get the functions of the synthetic provider for nns_ex_capture_new().
+ */
+extern void
+nns_ex_capture_synthetic_get_provider (nns_ex_capture_synthetic_s * synthetic,
+    nns_ex_capture_provider_s * provider);
+
+G_END_DECLS
+
+#endif /* __NNS_EX_CAPTURE_H__ */
@@ -0,0 +1,558 @@
+/**
+ * @file	nns_ex_model_sched.c
+ * @date	19 October 2026
+ * @brief	Admission scheduler of the models sharing a tensor stream (per-model frame rate and priority)
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ */
+
+#include <string.h>
+
+#include "nns_ex_model_sched.h"
+
+/**
+ * @brief Max number of the frames admitted to a model and not processed yet.
+ * @note With the bounded worker set, a model runs one frame at once.
+ * The others are for the unbounded mode (the leaky queue of the branch holds 2 frames).
+ */
+#define MODEL_SCHED_MAX_PENDING 4
+
+/**
+ * @brief The frame admitted to a model is lost if no output arrives in this time.
+ */
+#define MODEL_SCHED_STALE_TIME (GST_SECOND)
+
+/**
+ * @brief The model due over this time is admitted before the models of higher priority.
+ */
+#define MODEL_SCHED_STARVE_TIME (500 * GST_MSECOND)
+
+/**
+ * @brief Data structure for a frame admitted to a model.
+ */
+typedef struct
+{
+  GstClockTime pts; /**< timestamp of the frame */
+  GstClockTime time; /**< monotonic time of the admission */
+} nns_ex_model_sched_frame_s;
+
+/**
+ * @brief Data structure for a model.
+ */
+typedef struct
+{
+  gchar *name; /**< model name */
+  gchar *entry_name; /**< name of the first element of the branch */
+  gchar *end_name; /**< name of the element running the model */
+  GstClockTime period; /**< interval of the invocations, 0 for every frame */
+  gdouble target_fps; /**< target rate */
+  gint priority; /**< the higher value is admitted first */
+
+  GstPad *entry_pad; /**< sink pad of the first element of the branch */
+  gulong entry_probe_id; /**< probe to drop the frames not admitted */
+  GstPad *end_pad; /**< src pad of the element running the model */
+  gulong end_probe_id; /**< probe to get the output of the model */
+
+  gboolean admit; /**< true if the current frame at the tee is admitted (only in the thread of the tee) */
+  gboolean due; /**< true if the model is due on the current frame */
+  GstClockTime next_due; /**< monotonic time of the next invocation (the last invocation if the period is 0) */
+  nns_ex_model_sched_frame_s pending[MODEL_SCHED_MAX_PENDING]; /**< frames admitted, oldest first */
+  guint n_pending; /**< number of the frames admitted */
+  GstClockTime first_done; /**< monotonic time of the first output */
+  GstClockTime last_done; /**< monotonic time of the last output */
+  nns_ex_model_sched_stats_s stats; /**< statistics */
+  nns_ex_model_sched_s *sched; /**< scheduler handle */
+} nns_ex_model_sched_model_s;
+
+/**
+ * @brief Data structure for model scheduler.
+ */
+struct _nns_ex_model_sched_s
+{
+  GList *models; /**< list of models */
+  guint workers; /**< max number of the models running at once, 0 for unbounded */
+  guint max_per_frame; /**< max number of the models admitted on a frame, 0 for unbounded */
+
+  GMutex lock; /**< lock for the state of the models */
+  guint running; /**< number of the models running */
+  GstClockTime last_frame; /**< monotonic time of the previous frame at the tee */
+  GstClockTime frame_interval; /**< interval of the frames at the tee */
+
+  GstElement *pipeline; /**< pipeline attached */
+  GstPad *tee_pad; /**< sink pad of the tee */
+  gulong tee_probe_id; /**< probe to admit the models */
+};
+
+/**
+ * @brief Get the monotonic time.
+ */
+static inline GstClockTime
+_model_sched_now (void)
+{
+  return (GstClockTime) g_get_monotonic_time () * GST_USECOND;
+}
+
+/**
+ * @brief Remove the pad probe and release the pad.
+ */
+static void
+_model_sched_release_pad (GstPad ** pad, gulong * probe_id)
+{
+  if (*pad) {
+    if (*probe_id > 0)
+      gst_pad_remove_probe (*pad, *probe_id);
+    gst_object_unref (*pad);
+  }
+
+  *pad = NULL;
+  *probe_id = 0;
+}
+
+/**
+ * @brief Free model data.
+ */
+static void
+_model_sched_free_model (gpointer data)
+{
+  nns_ex_model_sched_model_s *model = (nns_ex_model_sched_model_s *) data;
+
+  _model_sched_release_pad (&model->entry_pad, &model->entry_probe_id);
+  _model_sched_release_pad (&model->end_pad, &model->end_probe_id);
+
+  g_free (model->name);
+  g_free (model->entry_name);
+  g_free (model->end_name);
+  g_free (model);
+}
+
+/**
+ * @brief Remove the first n frames admitted to the model.
+ * @note Caller should hold the lock.
+ */
+static void
+_model_sched_remove_pending (nns_ex_model_sched_model_s * model, guint n)
+{
+  if (n == 0)
+    return;
+
+  model->n_pending -= n;
+  memmove (model->pending, model->pending + n,
+      model->n_pending * sizeof (nns_ex_model_sched_frame_s));
+
+  if (model->n_pending == 0)
+    model->sched->running--;
+}
+
+/**
+ * @brief Check the model can be admitted on the current frame.
+ * @note Caller should hold the lock.
+ */
+static gboolean
+_model_sched_is_ready (nns_ex_model_sched_model_s * model)
+{
+  /* with the bounded worker set, a model runs one frame at once */
+  return model->due && !model->admit &&
+      (model->sched->workers == 0 || model->n_pending == 0);
+}
+
+/**
+ * @brief Check the model is admitted before the other model.
+ * @note Caller should hold the lock.
+ */
+static gboolean
+_model_sched_is_before (nns_ex_model_sched_model_s * model,
+    nns_ex_model_sched_model_s * other, GstClockTime now)
+{
+  gboolean starving, other_starving;
+
+  /* the model waiting too long goes first, not to starve the lower priority */
+  starving = (now >= model->next_due + MODEL_SCHED_STARVE_TIME);
+  other_starving = (now >= other->next_due + MODEL_SCHED_STARVE_TIME);
+
+  if (starving != other_starving)
+    return starving;
+
+  if (model->priority != other->priority)
+    return model->priority > other->priority;
+
+  return model->next_due < other->next_due;
+}
+
+/**
+ * @brief Admit the model on the current frame.
+ * @note Caller should hold the lock.
+ */
+static void
+_model_sched_admit (nns_ex_model_sched_model_s * model, GstClockTime pts,
+    GstClockTime now)
+{
+  /* unbounded mode only, the leaky queue has dropped the oldest frame */
+  if (model->n_pending == MODEL_SCHED_MAX_PENDING) {
+    _model_sched_remove_pending (model, 1);
+    model->stats.lost++;
+  }
+
+  if (model->n_pending == 0)
+    model->sched->running++;
+
+  model->pending[model->n_pending].pts = pts;
+  model->pending[model->n_pending].time = now;
+  model->n_pending++;
+
+  model->admit = TRUE;
+  model->stats.invoked++;
+
+  /* keep the phase of the period, restart it if the model is late over a period */
+  model->next_due += model->period;
+  if (model->next_due <= now)
+    model->next_due = now + model->period;
+}
+
+/**
+ * @brief Pad probe on the sink pad of the tee, decide the models admitted on the frame.
+ */
+static GstPadProbeReturn
+_model_sched_tee_probe (GstPad * pad, GstPadProbeInfo * info,
+    gpointer user_data)
+{
+  nns_ex_model_sched_s *sched = (nns_ex_model_sched_s *) user_data;
+  nns_ex_model_sched_model_s *model, *best;
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  GstClockTime now, tolerance;
+  guint admitted = 0, n;
+  GList *l;
+
+  now = _model_sched_now ();
+
+  g_mutex_lock (&sched->lock);
+
+  if (GST_CLOCK_TIME_IS_VALID (sched->last_frame) && now > sched->last_frame)
+    sched->frame_interval = now - sched->last_frame;
+  sched->last_frame = now;
+
+  /* a model is due on the frame closest to its time */
+  tolerance = sched->frame_interval / 2;
+
+  for (l = sched->models; l != NULL; l = l->next) {
+    model = (nns_ex_model_sched_model_s *) l->data;
+
+    /* the frames without the output for a while are lost (e.g., dropped in the branch) */
+    for (n = 0; n < model->n_pending; n++) {
+      if (model->pending[n].time + MODEL_SCHED_STALE_TIME > now)
+        break;
+    }
+    _model_sched_remove_pending (model, n);
+    model->stats.lost += n;
+
+    if (!GST_CLOCK_TIME_IS_VALID (model->next_due))
+      model->next_due = now;
+
+    model->admit = FALSE;
+    model->due = (now + tolerance >= model->next_due);
+
+    if (!model->due)
+      model->stats.skipped++;
+  }
+
+  /* admit the ready model starving first, then of the highest priority, then waiting longer */
+  while ((sched->max_per_frame == 0 || admitted < sched->max_per_frame) &&
+      (sched->workers == 0 || sched->running < sched->workers)) {
+    best = NULL;
+
+    for (l = sched->models; l != NULL; l = l->next) {
+      model = (nns_ex_model_sched_model_s *) l->data;
+
+      if (!_model_sched_is_ready (model))
+        continue;
+
+      if (best == NULL || _model_sched_is_before (model, best, now))
+        best = model;
+    }
+
+    if (best == NULL)
+      break;
+
+    _model_sched_admit (best, GST_BUFFER_PTS (buffer), now);
+    admitted++;
+  }
+
+  /* the due models not admitted stay due, and run on the next frames */
+  for (l = sched->models; l != NULL; l = l->next) {
+    model = (nns_ex_model_sched_model_s *) l->data;
+
+    if (model->due && !model->admit)
+      model->stats.deferred++;
+  }
+
+  g_mutex_unlock (&sched->lock);
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Pad probe on the sink pad of the first element of the branch, drop the frame not admitted.
+ * @note The tee pushes the frame to the branches in the thread of the tee probe.
+ */
+static GstPadProbeReturn
+_model_sched_entry_probe (GstPad * pad, GstPadProbeInfo * info,
+    gpointer user_data)
+{
+  nns_ex_model_sched_model_s *model = (nns_ex_model_sched_model_s *) user_data;
+
+  return model->admit ? GST_PAD_PROBE_OK : GST_PAD_PROBE_DROP;
+}
+
+/**
+ * @brief Pad probe on the src pad of the element running the model, the model is done with the frame.
+ */
+static GstPadProbeReturn
+_model_sched_end_probe (GstPad * pad, GstPadProbeInfo * info,
+    gpointer user_data)
+{
+  nns_ex_model_sched_model_s *model = (nns_ex_model_sched_model_s *) user_data;
+  nns_ex_model_sched_stats_s *stats = &model->stats;
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  GstClockTime now, pts, latency;
+  guint n;
+
+  now = _model_sched_now ();
+  pts = GST_BUFFER_PTS (buffer);
+
+  g_mutex_lock (&model->sched->lock);
+
+  if (model->n_pending == 0) {
+    /* the frame is already counted as lost */
+    g_mutex_unlock (&model->sched->lock);
+    return GST_PAD_PROBE_OK;
+  }
+
+  /* the frames admitted before this are dropped in the branch (the oldest if not found) */
+  for (n = 0; n < model->n_pending; n++) {
+    if (GST_CLOCK_TIME_IS_VALID (pts) && model->pending[n].pts == pts)
+      break;
+  }
+
+  if (n == model->n_pending)
+    n = 0;
+
+  latency = (now > model->pending[n].time) ? now - model->pending[n].time : 0;
+
+  stats->lost += n;
+  stats->completed++;
+  stats->total_latency += latency;
+  if (latency > stats->max_latency)
+    stats->max_latency = latency;
+
+  if (!GST_CLOCK_TIME_IS_VALID (model->first_done))
+    model->first_done = now;
+  model->last_done = now;
+
+  _model_sched_remove_pending (model, n + 1);
+
+  g_mutex_unlock (&model->sched->lock);
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Get the pad of the element in the pipeline.
+ */
+static GstPad *
+_model_sched_get_pad (GstElement * pipeline, const gchar * element_name,
+    const gchar * pad_name)
+{
+  GstElement *element;
+  GstPad *pad;
+
+  element = gst_bin_get_by_name (GST_BIN (pipeline), element_name);
+  if (element == NULL)
+    return NULL;
+
+  pad = gst_element_get_static_pad (element, pad_name);
+  gst_object_unref (element);
+  return pad;
+}
+
+/**
+ * @brief Create new model scheduler.
+ */
+nns_ex_model_sched_s *
+nns_ex_model_sched_new (guint workers, guint max_per_frame)
+{
+  nns_ex_model_sched_s *sched;
+
+  sched = g_new0 (nns_ex_model_sched_s, 1);
+  sched->workers = workers;
+  sched->max_per_frame = max_per_frame;
+  sched->last_frame = GST_CLOCK_TIME_NONE;
+  g_mutex_init (&sched->lock);
+
+  return sched;
+}
+
+/**
+ * @brief Free the model scheduler.
+ */
+void
+nns_ex_model_sched_free (nns_ex_model_sched_s * sched)
+{
+  g_return_if_fail (sched != NULL);
+
+  _model_sched_release_pad (&sched->tee_pad, &sched->tee_probe_id);
+  g_list_free_full (sched->models, _model_sched_free_model);
+
+  if (sched->pipeline)
+    gst_object_unref (sched->pipeline);
+
+  g_mutex_clear (&sched->lock);
+  g_free (sched);
+}
+
+/**
+ * @brief Add a model to be scheduled.
+ */
+gboolean
+nns_ex_model_sched_add_model (nns_ex_model_sched_s * sched,
+    const gchar * name, const gchar * entry, const gchar * end,
+    gdouble target_fps, gint priority)
+{
+  nns_ex_model_sched_model_s *model;
+
+  g_return_val_if_fail (sched != NULL, FALSE);
+  g_return_val_if_fail (name != NULL && entry != NULL && end != NULL, FALSE);
+  g_return_val_if_fail (target_fps >= 0.0, FALSE);
+  g_return_val_if_fail (sched->pipeline == NULL, FALSE);
+
+  model = g_new0 (nns_ex_model_sched_model_s, 1);
+
+  model->name = g_strdup (name);
+  model->entry_name = g_strdup (entry);
+  model->end_name = g_strdup (end);
+  model->target_fps = target_fps;
+  model->period = (target_fps > 0.0) ?
+      (GstClockTime) (GST_SECOND / target_fps) : 0;
+  model->priority = priority;
+  model->next_due = GST_CLOCK_TIME_NONE;
+  model->first_done = GST_CLOCK_TIME_NONE;
+  model->last_done = GST_CLOCK_TIME_NONE;
+  model->stats.target_fps = target_fps;
+  model->sched = sched;
+
+  sched->models = g_list_append (sched->models, model);
+  return TRUE;
+}
+
+/**
+ * @brief Attach the model scheduler to the pipeline.
+ */
+gboolean
+nns_ex_model_sched_attach (nns_ex_model_sched_s * sched, GstElement * pipeline,
+    const gchar * tee)
+{
+  nns_ex_model_sched_model_s *model;
+  GList *l;
+  gboolean ret = TRUE;
+
+  g_return_val_if_fail (sched != NULL, FALSE);
+  g_return_val_if_fail (GST_IS_BIN (pipeline), FALSE);
+  g_return_val_if_fail (tee != NULL, FALSE);
+  g_return_val_if_fail (sched->pipeline == NULL, FALSE);
+
+  sched->pipeline = gst_object_ref (pipeline);
+
+  /* without the tee, the branches would drop all frames */
+  sched->tee_pad = _model_sched_get_pad (pipeline, tee, "sink");
+  if (sched->tee_pad == NULL) {
+    g_warning ("Cannot find the tee %s", tee);
+    return FALSE;
+  }
+
+  for (l = sched->models; l != NULL; l = l->next) {
+    model = (nns_ex_model_sched_model_s *) l->data;
+
+    model->entry_pad = _model_sched_get_pad (pipeline, model->entry_name,
+        "sink");
+    model->end_pad = _model_sched_get_pad (pipeline, model->end_name, "src");
+
+    if (model->entry_pad == NULL || model->end_pad == NULL) {
+      g_warning ("Cannot find the element %s or %s of model %s",
+          model->entry_name, model->end_name, model->name);
+      _model_sched_release_pad (&model->entry_pad, &model->entry_probe_id);
+      _model_sched_release_pad (&model->end_pad, &model->end_probe_id);
+      ret = FALSE;
+      continue;
+    }
+
+    model->entry_probe_id = gst_pad_add_probe (model->entry_pad,
+        GST_PAD_PROBE_TYPE_BUFFER, _model_sched_entry_probe, model, NULL);
+    model->end_probe_id = gst_pad_add_probe (model->end_pad,
+        GST_PAD_PROBE_TYPE_BUFFER, _model_sched_end_probe, model, NULL);
+  }
+
+  sched->tee_probe_id = gst_pad_add_probe (sched->tee_pad,
+      GST_PAD_PROBE_TYPE_BUFFER, _model_sched_tee_probe, sched, NULL);
+
+  return ret;
+}
+
+/**
+ * @brief Get the statistics of the model.
+ */
+gboolean
+nns_ex_model_sched_get_stats (nns_ex_model_sched_s * sched,
+    const gchar * name, nns_ex_model_sched_stats_s * stats)
+{
+  nns_ex_model_sched_model_s *model;
+  GList *l;
+
+  g_return_val_if_fail (sched != NULL, FALSE);
+  g_return_val_if_fail (name != NULL && stats != NULL, FALSE);
+
+  for (l = sched->models; l != NULL; l = l->next) {
+    model = (nns_ex_model_sched_model_s *) l->data;
+
+    if (g_str_equal (model->name, name)) {
+      g_mutex_lock (&sched->lock);
+      *stats = model->stats;
+
+      if (model->stats.completed > 1 && model->last_done > model->first_done) {
+        stats->achieved_fps = (gdouble) (model->stats.completed - 1) *
+            GST_SECOND / (model->last_done - model->first_done);
+      }
+      g_mutex_unlock (&sched->lock);
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+ * @brief Print the target and achieved rate of all models.
+ */
+void
+nns_ex_model_sched_print_stats (nns_ex_model_sched_s * sched)
+{
+  nns_ex_model_sched_model_s *model;
+  nns_ex_model_sched_stats_s stats;
+  GstClockTime avg;
+  GList *l;
+
+  g_return_if_fail (sched != NULL);
+
+  for (l = sched->models; l != NULL; l = l->next) {
+    model = (nns_ex_model_sched_model_s *) l->data;
+
+    if (!nns_ex_model_sched_get_stats (sched, model->name, &stats))
+      continue;
+
+    avg = (stats.completed > 0) ? stats.total_latency / stats.completed : 0;
+
+    g_print ("[%s] priority %d, target %.1f fps, achieved %.1f fps, invoked %"
+        G_GUINT64_FORMAT ", completed %" G_GUINT64_FORMAT ", skipped %"
+        G_GUINT64_FORMAT ", deferred %" G_GUINT64_FORMAT ", lost %"
+        G_GUINT64_FORMAT ", latency avg %" G_GUINT64_FORMAT " ms max %"
+        G_GUINT64_FORMAT " ms\n", model->name, model->priority,
+        stats.target_fps, stats.achieved_fps, stats.invoked, stats.completed,
+        stats.skipped, stats.deferred, stats.lost, GST_TIME_AS_MSECONDS (avg),
+        GST_TIME_AS_MSECONDS (stats.max_latency));
+  }
+}
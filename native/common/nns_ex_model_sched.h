@@ -0,0 +1,120 @@
+/**
+ * @file	nns_ex_model_sched.h
+ * @date	19 October 2026
+ * @brief	Admission scheduler of the models sharing a tensor stream (per-model frame rate and priority)
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * Several models (e.g., face, hand and object detection) run on the branches of a tee,
+ * each branch starting with a queue (the entry element) and ending with the tensor_filter (the end element).
+ * Without the scheduler, every frame is pushed to every branch and the models compete for the cores,
+ * the leaky queues drop the frames at random and no model reaches a stable rate.
+ *
+ * For each frame at the tee, the scheduler admits the models in the order of the priority
+ * (higher value first, then the model waiting longer, and a model due over 0.5 second goes first not to starve) :
+ * - a model is due when its period (1 / target rate) has passed since the previous invocation
+ * - a model still running the previous frame is not admitted
+ * - at most 'workers' models run at once (the bounded worker set, e.g., the number of big cores)
+ * - at most 'max-per-frame' models are admitted on a frame, so the invocations of the models
+ *   are staggered across the frames instead of bursting on the same frame
+ * The frame is dropped at the entry element of the models not admitted.
+ * A due model not admitted stays due, and is admitted on one of the next frames.
+ *
+ * With 0 workers and 0 max-per-frame, all due models are admitted as the leaky queues allow
+ * (the pipeline without the scheduler), to compare the achieved rates.
+ *
+ * Usage :
+ *
+ * sched = nns_ex_model_sched_new (2, 1);
+ * nns_ex_model_sched_add_model (sched, "face", "q_face", "filter_face", 10.0, 3);
+ * nns_ex_model_sched_add_model (sched, "obj", "q_obj", "filter_obj", 5.0, 1);
+ * nns_ex_model_sched_attach (sched, pipeline, "tssd");
+ * (run the pipeline)
+ * nns_ex_model_sched_print_stats (sched);
+ */
+
+#ifndef __NNS_EX_MODEL_SCHED_H__
+#define __NNS_EX_MODEL_SCHED_H__
+
+#include <glib.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Statistics of a model.
+ */
+typedef struct
+{
+  gdouble target_fps; /**< target rate (0 for every frame) */
+  gdouble achieved_fps; /**< rate of the frames processed by the model */
+  guint64 invoked; /**< count of the frames admitted */
+  guint64 completed; /**< count of the frames processed */
+  guint64 skipped; /**< count of the frames skipped, the model is not due */
+  guint64 deferred; /**< count of the frames deferred, the model is due but running or no worker is free */
+  guint64 lost; /**< count of the frames admitted without the output (dropped in the branch) */
+  GstClockTime total_latency; /**< sum of latency from the tee to the output, to get the average */
+  GstClockTime max_latency; /**< max latency */
+} nns_ex_model_sched_stats_s;
+
+/**
+ * @brief Handle of the model scheduler.
+ */
+typedef struct _nns_ex_model_sched_s nns_ex_model_sched_s;
+
+/**
+ * @brief Create new model scheduler.
+ * @param workers max number of the models running at once (0 for unbounded)
+ * @param max_per_frame max number of the models admitted on a frame (0 for unbounded)
+ */
+extern nns_ex_model_sched_s *
+nns_ex_model_sched_new (guint workers, guint max_per_frame);
+
+/**
+ * @brief Free the model scheduler.
+ * @note Call this after the pipeline is stopped.
+ */
+extern void
+nns_ex_model_sched_free (nns_ex_model_sched_s * sched);
+
+/**
+ * @brief Add a model to be scheduled.
+ * @param name model name
+ * @param entry name of the first element of the branch after the tee (usually a queue)
+ * @param end name of the element running the model (usually a tensor_filter)
+ * @param target_fps target rate of the model (0 for every frame)
+ * @param priority priority of the model, the higher value is admitted first
+ * @return TRUE if the model is added
+ */
+extern gboolean
+nns_ex_model_sched_add_model (nns_ex_model_sched_s * sched,
+    const gchar * name, const gchar * entry, const gchar * end,
+    gdouble target_fps, gint priority);
+
+/**
+ * @brief Attach the model scheduler to the pipeline.
+ * @param tee name of the tee feeding the models
+ * @note Call this before the pipeline starts.
+ * @return TRUE if the tee and all models are found in the pipeline
+ */
+extern gboolean
+nns_ex_model_sched_attach (nns_ex_model_sched_s * sched, GstElement * pipeline,
+    const gchar * tee);
+
+/**
+ * @brief Get the statistics of the model.
+ * @return TRUE if the model exists
+ */
+extern gboolean
+nns_ex_model_sched_get_stats (nns_ex_model_sched_s * sched,
+    const gchar * name, nns_ex_model_sched_stats_s * stats);
+
+/**
+ * @brief Print the target and achieved rate of all models.
+ */
+extern void
+nns_ex_model_sched_print_stats (nns_ex_model_sched_s * sched);
+
+G_END_DECLS
+
+#endif /* __NNS_EX_MODEL_SCHED_H__ */
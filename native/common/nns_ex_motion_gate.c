@@ -0,0 +1,402 @@
+/**
+ * @file	nns_ex_motion_gate.c
+ * @date	19 October 2026
+ * @brief	Motion gate to skip the inference of the static frames
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ */
+
+#include <string.h>
+#include <gst/video/video.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define NNS_EX_HAVE_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define NNS_EX_HAVE_SSE2 1
+#endif
+
+#include "nns_ex_motion_gate.h"
+
+/**
+ * @brief Shift to average a block (log2 of the block area).
+ */
+#define GATE_BLOCK_SHIFT 6
+
+/**
+ * @brief Data structure for the gate.
+ */
+struct _nns_ex_motion_gate_s
+{
+  guint8 cell_threshold; /**< min difference of a changed cell */
+  gfloat area_threshold; /**< min ratio of the changed cells */
+  guint max_skip; /**< max count of the frames dropped in a row */
+  guint skipped_in_row; /**< count of the frames dropped in a row */
+
+  guint8 *thumb; /**< thumbnail of the current frame */
+  guint8 *reference; /**< thumbnail of the last frame passed */
+  guint thumb_width; /**< width of the thumbnail */
+  guint thumb_height; /**< height of the thumbnail */
+  gboolean has_reference; /**< true if the reference is valid */
+
+  GstPad *sink_pad; /**< pad of the gate */
+  gulong sink_probe; /**< probe of the gate */
+  GstPad *src_pad; /**< pad to measure the processing time */
+  gulong src_probe; /**< probe to measure the processing time */
+  GstCaps *caps; /**< current caps of the sink pad */
+  GstVideoInfo vinfo; /**< video info of the caps */
+  gint64 pass_time; /**< time when the last frame is passed, 0 if processed */
+
+  nns_ex_motion_gate_stats_s stats; /**< metrics of the gate */
+};
+
+/**
+ * @brief Average the blocks of a row of cells.
+ */
+static void
+_downsample_row (const guint8 * data, guint thumb_width, gint stride,
+    guint pixel_stride, guint8 * thumb)
+{
+  guint x = 0, r, k, sum;
+
+  if (pixel_stride == 1) {
+#ifdef NNS_EX_HAVE_NEON
+    for (; x + 2 <= thumb_width; x += 2) {
+      uint64x2_t acc = vdupq_n_u64 (0);
+
+      for (r = 0; r < NNS_EX_MOTION_GATE_BLOCK; r++) {
+        uint8x16_t v = vld1q_u8 (data + r * stride + x * NNS_EX_MOTION_GATE_BLOCK);
+        acc = vpadalq_u32 (acc, vpaddlq_u16 (vpaddlq_u8 (v)));
+      }
+
+      thumb[x] = (guint8) ((vgetq_lane_u64 (acc, 0) + 32) >> GATE_BLOCK_SHIFT);
+      thumb[x + 1] = (guint8) ((vgetq_lane_u64 (acc, 1) + 32) >> GATE_BLOCK_SHIFT);
+    }
+#elif defined(NNS_EX_HAVE_SSE2)
+    const __m128i zero = _mm_setzero_si128 ();
+
+    for (; x + 2 <= thumb_width; x += 2) {
+      __m128i acc = _mm_setzero_si128 ();
+
+      for (r = 0; r < NNS_EX_MOTION_GATE_BLOCK; r++) {
+        __m128i v = _mm_loadu_si128 ((const __m128i *) (data + r * stride +
+                x * NNS_EX_MOTION_GATE_BLOCK));
+        acc = _mm_add_epi64 (acc, _mm_sad_epu8 (v, zero));
+      }
+
+      thumb[x] = (guint8) ((_mm_cvtsi128_si32 (acc) + 32) >> GATE_BLOCK_SHIFT);
+      thumb[x + 1] = (guint8) ((_mm_cvtsi128_si32 (_mm_srli_si128 (acc, 8)) +
+              32) >> GATE_BLOCK_SHIFT);
+    }
+#endif
+  }
+
+  /* remained blocks, or the interleaved channel */
+  for (; x < thumb_width; x++) {
+    const guint8 *block = data + x * NNS_EX_MOTION_GATE_BLOCK * pixel_stride;
+
+    sum = 0;
+    for (r = 0; r < NNS_EX_MOTION_GATE_BLOCK; r++) {
+      for (k = 0; k < NNS_EX_MOTION_GATE_BLOCK; k++)
+        sum += block[r * stride + k * pixel_stride];
+    }
+
+    thumb[x] = (guint8) ((sum + 32) >> GATE_BLOCK_SHIFT);
+  }
+}
+
+/**
+ * @brief Count the cells with the difference greater than the threshold.
+ */
+static guint
+_count_changed (const guint8 * a, const guint8 * b, guint len,
+    guint8 threshold)
+{
+  guint i = 0, count = 0;
+  guint8 diff;
+
+#ifdef NNS_EX_HAVE_NEON
+  guint iter = 0;
+  const uint8x16_t thr = vdupq_n_u8 (threshold);
+  uint8x16_t acc = vdupq_n_u8 (0);
+
+  for (; i + 16 <= len; i += 16) {
+    uint8x16_t d = vabdq_u8 (vld1q_u8 (a + i), vld1q_u8 (b + i));
+
+    /* changed cell is 0xFF, add 1 */
+    acc = vsubq_u8 (acc, vcgtq_u8 (d, thr));
+
+    /* flush before the 8-bit counters overflow */
+    if (++iter == 255 || i + 32 > len) {
+      uint64x2_t s = vpaddlq_u32 (vpaddlq_u16 (vpaddlq_u8 (acc)));
+
+      count += (guint) (vgetq_lane_u64 (s, 0) + vgetq_lane_u64 (s, 1));
+      acc = vdupq_n_u8 (0);
+      iter = 0;
+    }
+  }
+#elif defined(NNS_EX_HAVE_SSE2)
+  guint iter = 0;
+  const __m128i zero = _mm_setzero_si128 ();
+  const __m128i one = _mm_set1_epi8 (1);
+  const __m128i thr = _mm_set1_epi8 ((char) threshold);
+  __m128i acc = _mm_setzero_si128 ();
+
+  for (; i + 16 <= len; i += 16) {
+    __m128i va = _mm_loadu_si128 ((const __m128i *) (a + i));
+    __m128i vb = _mm_loadu_si128 ((const __m128i *) (b + i));
+    __m128i d = _mm_or_si128 (_mm_subs_epu8 (va, vb), _mm_subs_epu8 (vb, va));
+
+    /* d - threshold is not zero if changed */
+    __m128i same = _mm_cmpeq_epi8 (_mm_subs_epu8 (d, thr), zero);
+    acc = _mm_add_epi8 (acc, _mm_andnot_si128 (same, one));
+
+    /* flush before the 8-bit counters overflow */
+    if (++iter == 255 || i + 32 > len) {
+      __m128i s = _mm_sad_epu8 (acc, zero);
+
+      count += (guint) (_mm_cvtsi128_si32 (s) +
+          _mm_cvtsi128_si32 (_mm_srli_si128 (s, 8)));
+      acc = _mm_setzero_si128 ();
+      iter = 0;
+    }
+  }
+#endif
+
+  /* remained cells */
+  for (; i < len; i++) {
+    diff = (a[i] > b[i]) ? a[i] - b[i] : b[i] - a[i];
+    if (diff > threshold)
+      count++;
+  }
+
+  return count;
+}
+
+/**
+ * @brief Pad probe to gate the frames.
+ */
+static GstPadProbeReturn
+_gate_sink_probe_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  nns_ex_motion_gate_s *gate = (nns_ex_motion_gate_s *) user_data;
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  GstVideoFrame frame;
+  GstCaps *caps;
+  gint64 start;
+  guint comp;
+  gboolean passed;
+
+  start = g_get_monotonic_time ();
+
+  caps = gst_pad_get_current_caps (pad);
+  if (caps == NULL)
+    return GST_PAD_PROBE_OK;
+
+  if (gate->caps == NULL || !gst_caps_is_equal (caps, gate->caps)) {
+    if (!gst_video_info_from_caps (&gate->vinfo, caps)) {
+      gst_caps_unref (caps);
+      return GST_PAD_PROBE_OK;
+    }
+
+    gst_caps_replace (&gate->caps, caps);
+    gate->has_reference = FALSE;
+  }
+  gst_caps_unref (caps);
+
+  if (!gst_video_frame_map (&frame, &gate->vinfo, buffer, GST_MAP_READ))
+    return GST_PAD_PROBE_OK;
+
+  /* luma, or green of the RGB formats */
+  comp = (GST_VIDEO_INFO_IS_RGB (&gate->vinfo)) ? 1 : 0;
+
+  passed = nns_ex_motion_gate_check (gate,
+      GST_VIDEO_FRAME_COMP_DATA (&frame, comp),
+      GST_VIDEO_FRAME_COMP_WIDTH (&frame, comp),
+      GST_VIDEO_FRAME_COMP_HEIGHT (&frame, comp),
+      GST_VIDEO_FRAME_COMP_STRIDE (&frame, comp),
+      GST_VIDEO_FRAME_COMP_PSTRIDE (&frame, comp));
+
+  gst_video_frame_unmap (&frame);
+
+  gate->pass_time = g_get_monotonic_time ();
+  gate->stats.gate_time += gate->pass_time - start;
+
+  if (!passed) {
+    gate->pass_time = 0;
+    return GST_PAD_PROBE_DROP;
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Pad probe to measure the processing time of the passed frame.
+ */
+static GstPadProbeReturn
+_gate_src_probe_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  nns_ex_motion_gate_s *gate = (nns_ex_motion_gate_s *) user_data;
+
+  if (gate->pass_time > 0) {
+    gate->stats.process_time += g_get_monotonic_time () - gate->pass_time;
+    gate->pass_time = 0;
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Create the gate.
+ */
+nns_ex_motion_gate_s *
+nns_ex_motion_gate_new (guint cell_threshold, gfloat area_threshold,
+    guint max_skip)
+{
+  nns_ex_motion_gate_s *gate;
+
+  gate = g_new0 (nns_ex_motion_gate_s, 1);
+  gate->cell_threshold = (guint8) MIN (cell_threshold, 255);
+  gate->area_threshold = CLAMP (area_threshold, 0.0f, 1.0f);
+  gate->max_skip = max_skip;
+
+  return gate;
+}
+
+/**
+ * @brief Free the gate and remove the probes.
+ */
+void
+nns_ex_motion_gate_free (nns_ex_motion_gate_s * gate)
+{
+  g_return_if_fail (gate != NULL);
+
+  if (gate->sink_pad) {
+    gst_pad_remove_probe (gate->sink_pad, gate->sink_probe);
+    gst_object_unref (gate->sink_pad);
+  }
+
+  if (gate->src_pad) {
+    gst_pad_remove_probe (gate->src_pad, gate->src_probe);
+    gst_object_unref (gate->src_pad);
+  }
+
+  if (gate->caps)
+    gst_caps_unref (gate->caps);
+
+  g_free (gate->thumb);
+  g_free (gate->reference);
+  g_free (gate);
+}
+
+/**
+ * @brief Check the frame is changed from the last frame passed.
+ */
+gboolean
+nns_ex_motion_gate_check (nns_ex_motion_gate_s * gate, const guint8 * data,
+    guint width, guint height, gint stride, guint pixel_stride)
+{
+  guint8 *swap;
+  guint tw, th, y, changed;
+  gboolean passed;
+
+  g_return_val_if_fail (gate != NULL, TRUE);
+  g_return_val_if_fail (data != NULL, TRUE);
+
+  tw = width / NNS_EX_MOTION_GATE_BLOCK;
+  th = height / NNS_EX_MOTION_GATE_BLOCK;
+
+  if (tw != gate->thumb_width || th != gate->thumb_height) {
+    g_free (gate->thumb);
+    g_free (gate->reference);
+
+    gate->thumb = g_malloc (MAX (tw * th, 1));
+    gate->reference = g_malloc (MAX (tw * th, 1));
+    gate->thumb_width = tw;
+    gate->thumb_height = th;
+    gate->has_reference = FALSE;
+  }
+
+  for (y = 0; y < th; y++) {
+    _downsample_row (data + (gsize) y * NNS_EX_MOTION_GATE_BLOCK * stride, tw,
+        stride, pixel_stride, gate->thumb + y * tw);
+  }
+
+  gate->stats.frames++;
+
+  if (!gate->has_reference || tw * th == 0) {
+    passed = TRUE;
+  } else {
+    changed = _count_changed (gate->thumb, gate->reference, tw * th,
+        gate->cell_threshold);
+    passed = (changed > gate->area_threshold * (tw * th));
+
+    /* refresh the result, e.g., the lighting changes slowly */
+    if (!passed && gate->max_skip > 0 && gate->skipped_in_row >= gate->max_skip) {
+      passed = TRUE;
+      gate->stats.forced++;
+    }
+  }
+
+  if (passed) {
+    swap = gate->reference;
+    gate->reference = gate->thumb;
+    gate->thumb = swap;
+    gate->has_reference = TRUE;
+    gate->skipped_in_row = 0;
+    gate->stats.passed++;
+  } else {
+    gate->skipped_in_row++;
+    gate->stats.skipped++;
+  }
+
+  return passed;
+}
+
+/**
+ * @brief Gate the raw video frames to the sink pad of the element.
+ */
+gboolean
+nns_ex_motion_gate_attach (nns_ex_motion_gate_s * gate, GstElement * element,
+    GstElement * last)
+{
+  g_return_val_if_fail (gate != NULL, FALSE);
+  g_return_val_if_fail (GST_IS_ELEMENT (element), FALSE);
+  g_return_val_if_fail (gate->sink_pad == NULL, FALSE);
+
+  gate->sink_pad = gst_element_get_static_pad (element, "sink");
+  if (gate->sink_pad == NULL)
+    return FALSE;
+
+  gate->sink_probe = gst_pad_add_probe (gate->sink_pad,
+      GST_PAD_PROBE_TYPE_BUFFER, _gate_sink_probe_cb, gate, NULL);
+
+  if (last) {
+    gate->src_pad = gst_element_get_static_pad (last, "src");
+    if (gate->src_pad == NULL)
+      return FALSE;
+
+    gate->src_probe = gst_pad_add_probe (gate->src_pad,
+        GST_PAD_PROBE_TYPE_BUFFER, _gate_src_probe_cb, gate, NULL);
+  }
+
+  return TRUE;
+}
+
+/**
+ * @brief Get the metrics of the gate.
+ */
+void
+nns_ex_motion_gate_get_stats (nns_ex_motion_gate_s * gate,
+    nns_ex_motion_gate_stats_s * stats)
+{
+  g_return_if_fail (gate != NULL);
+  g_return_if_fail (stats != NULL);
+
+  *stats = gate->stats;
+
+  stats->saved_time = -stats->gate_time;
+  if (stats->passed > 0)
+    stats->saved_time += stats->process_time * stats->skipped / stats->passed;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file	nns_ex_motion_gate.h
+ * @date	19 October 2026
+ * @brief	Motion gate to skip the inference of the static frames
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * The gate downsamples the luma (or green) channel of a frame to a thumbnail, averaging
+ * the blocks of NNS_EX_MOTION_GATE_BLOCK x NNS_EX_MOTION_GATE_BLOCK pixels, and compares it with
+ * the thumbnail of the last frame passed. A cell is changed if the difference is greater than
+ * the cell threshold, and the frame is passed if the ratio of the changed cells is greater than
+ * the area threshold. Otherwise the frame is dropped, and the app keeps the last result.
+ * The block sums and the comparison use NEON or SSE2.
+ *
+ * Usage :
+ *
+ * gate = nns_ex_motion_gate_new (12, 0.01f, 30);
+ * nns_ex_motion_gate_attach (gate, tensorize, tensor_filter);
+ * (run the pipeline, then stop it)
+ * nns_ex_motion_gate_get_stats (gate, &stats);
+ * nns_ex_motion_gate_free (gate);
+ */
+
+#ifndef __NNS_EX_MOTION_GATE_H__
+#define __NNS_EX_MOTION_GATE_H__
+
+#include <glib.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Size of the block averaged to a cell of the thumbnail.
+ */
+#define NNS_EX_MOTION_GATE_BLOCK 8
+
+/**
+ * @brief Metrics of the gate.
+ */
+typedef struct
+{
+  guint frames; /**< count of the frames checked */
+  guint passed; /**< count of the frames passed */
+  guint skipped; /**< count of the frames dropped */
+  guint forced; /**< count of the static frames passed to refresh the result */
+  gint64 gate_time; /**< time (in microseconds) spent in the gate */
+  gint64 process_time; /**< time (in microseconds) to process the passed frames */
+  gint64 saved_time; /**< estimated time (in microseconds) saved, the skipped frames x average processing time - gate time */
+} nns_ex_motion_gate_stats_s;
+
+/**
+ * @brief Opaque data structure for the gate.
+ */
+typedef struct _nns_ex_motion_gate_s nns_ex_motion_gate_s;
+
+/**
+ * @brief Create the gate.
+ * @param cell_threshold min difference (0 ~ 255) of a changed cell
+ * @param area_threshold min ratio (0 ~ 1) of the changed cells to pass the frame
+ * @param max_skip max count of the frames dropped in a row, 0 not to limit
+ * @return newly allocated gate
+ */
+extern nns_ex_motion_gate_s *
+nns_ex_motion_gate_new (guint cell_threshold, gfloat area_threshold,
+    guint max_skip);
+
+/**
+ * @brief Free the gate and remove the probes.
+ * @note Call this after the pipeline is stopped.
+ */
+extern void
+nns_ex_motion_gate_free (nns_ex_motion_gate_s * gate);
+
+/**
+ * @brief Check the frame is changed from the last frame passed.
+ * @param data first sample of the channel to compare
+ * @param width width of the frame
+ * @param height height of the frame
+ * @param stride bytes per row
+ * @param pixel_stride bytes per pixel of the channel (1 for the Y plane)
+ * @return TRUE to pass the frame (the thumbnail becomes the reference), FALSE if static
+ */
+extern gboolean
+nns_ex_motion_gate_check (nns_ex_motion_gate_s * gate, const guint8 * data,
+    guint width, guint height, gint stride, guint pixel_stride);
+
+/**
+ * @brief Gate the raw video frames to the sink pad of the element.
+ * @param element the first element of the inference (e.g., nns_ex_tensorize)
+ * @param last the last element of the inference (e.g., tensor_filter) to measure the processing time,
+ * which should be in the same streaming thread as the element (no queue between), NULL not to measure
+ */
+extern gboolean
+nns_ex_motion_gate_attach (nns_ex_motion_gate_s * gate, GstElement * element,
+    GstElement * last);
+
+/**
+ * @brief Get the metrics of the gate.
+ * @note Call this after the pipeline is stopped.
+ */
+extern void
+nns_ex_motion_gate_get_stats (nns_ex_motion_gate_s * gate,
+    nns_ex_motion_gate_stats_s * stats);
+
+G_END_DECLS
+
+#endif /* __NNS_EX_MOTION_GATE_H__ */
@@ -0,0 +1,399 @@
+/**
+ * @file	nns_ex_offload.c
+ * @date	19 October 2026
+ * @brief	Controller to route the frames to the local or remote inference by the latency
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ */
+
+#include <string.h>
+
+#include "nns_ex_offload.h"
+
+/**
+ * @brief Data structure for the frame waiting for the result.
+ */
+typedef struct
+{
+  guint64 id; /**< id of the frame */
+  GstClockTime sent; /**< time the frame is routed */
+  nns_ex_offload_route_e route; /**< route of the frame */
+  gboolean done; /**< true if the result arrived */
+} _offload_pending_s;
+
+/**
+ * @brief Data structure for the controller.
+ */
+struct _nns_ex_offload_s
+{
+  GMutex lock; /**< lock for the state */
+  GstClockTime target; /**< target latency */
+  GstClockTime timeout; /**< max time to wait for the result */
+  guint window; /**< number of the frames to keep the route */
+  nns_ex_offload_route_e prefer; /**< route to choose if both meet the target */
+
+  nns_ex_offload_route_e route; /**< current route */
+  guint window_frames; /**< count of the frames since the route is chosen */
+  guint probe_frames; /**< count of the frames since the last probe */
+  guint fails[NNS_EX_OFFLOAD_ROUTES]; /**< count of the failures in a row */
+  GstClockTime backoff_until; /**< time to probe the remote device again after the fallback */
+
+  _offload_pending_s pending[NNS_EX_OFFLOAD_MAX_PENDING]; /**< frames in the order of the route (ring) */
+  guint pending_head; /**< index of the oldest frame */
+  guint pending_count; /**< number of the frames in the ring */
+
+  nns_ex_offload_stats_s stats; /**< metrics of the controller */
+};
+
+/**
+ * @brief Get the other route.
+ */
+#define _offload_other(r) \
+    (((r) == NNS_EX_OFFLOAD_LOCAL) ? NNS_EX_OFFLOAD_REMOTE : NNS_EX_OFFLOAD_LOCAL)
+
+/**
+ * @brief Get the frame in the ring.
+ */
+#define _offload_pending_at(o,i) \
+    (&(o)->pending[((o)->pending_head + (i)) % NNS_EX_OFFLOAD_MAX_PENDING])
+
+/**
+ * @brief Change the route.
+ */
+static void
+_offload_switch (nns_ex_offload_s * offload, nns_ex_offload_route_e route)
+{
+  if (offload->route != route) {
+    offload->route = route;
+    offload->stats.route = route;
+    offload->stats.switches++;
+  }
+
+  offload->window_frames = 0;
+}
+
+/**
+ * @brief Update the latency of the route with the result or the failure.
+ */
+static void
+_offload_update (nns_ex_offload_s * offload, nns_ex_offload_route_e route,
+    GstClockTime latency, gboolean failed, GstClockTime now)
+{
+  nns_ex_offload_stats_s *stats = &offload->stats;
+
+  /* restart the estimate with the first result after the failures */
+  if (!GST_CLOCK_TIME_IS_VALID (stats->latency[route]) ||
+      (!failed && offload->fails[route] >= NNS_EX_OFFLOAD_FAIL_LIMIT))
+    stats->latency[route] = latency;
+  else
+    stats->latency[route] = (stats->latency[route] * 3 + latency) / 4;
+
+  if (failed) {
+    offload->fails[route]++;
+    stats->timeouts[route]++;
+  } else {
+    offload->fails[route] = 0;
+    stats->completed[route]++;
+
+    if (latency > stats->max_latency[route])
+      stats->max_latency[route] = latency;
+  }
+
+  /* fall back to the local inference at once when the remote path degrades,
+   * the remote device does not respond, or it is late and slower than the local inference */
+  if (route == NNS_EX_OFFLOAD_REMOTE && offload->route == NNS_EX_OFFLOAD_REMOTE &&
+      (offload->fails[route] >= NNS_EX_OFFLOAD_FAIL_LIMIT ||
+          (stats->latency[route] > offload->target &&
+              !(stats->latency[route] < stats->latency[NNS_EX_OFFLOAD_LOCAL])))) {
+    _offload_switch (offload, NNS_EX_OFFLOAD_LOCAL);
+    offload->backoff_until = now + NNS_EX_OFFLOAD_BACKOFF;
+    stats->fallbacks++;
+  }
+}
+
+/**
+ * @brief Remove the frames with the result from the head of the ring.
+ */
+static void
+_offload_pop_done (nns_ex_offload_s * offload)
+{
+  while (offload->pending_count > 0 && _offload_pending_at (offload, 0)->done) {
+    offload->pending_head =
+        (offload->pending_head + 1) % NNS_EX_OFFLOAD_MAX_PENDING;
+    offload->pending_count--;
+  }
+}
+
+/**
+ * @brief Fail the frames without the result in the timeout.
+ */
+static void
+_offload_expire (nns_ex_offload_s * offload, GstClockTime now)
+{
+  _offload_pending_s *p;
+
+  _offload_pop_done (offload);
+
+  while (offload->pending_count > 0) {
+    p = _offload_pending_at (offload, 0);
+
+    /* the ring is in the order of the time */
+    if (!p->done && now < p->sent + offload->timeout)
+      break;
+
+    if (!p->done)
+      _offload_update (offload, p->route, offload->timeout, TRUE, now);
+
+    offload->pending_head =
+        (offload->pending_head + 1) % NNS_EX_OFFLOAD_MAX_PENDING;
+    offload->pending_count--;
+  }
+}
+
+/**
+ * @brief Check the route is waiting for the result.
+ */
+static gboolean
+_offload_has_pending (nns_ex_offload_s * offload, nns_ex_offload_route_e route)
+{
+  _offload_pending_s *p;
+  guint i;
+
+  for (i = 0; i < offload->pending_count; i++) {
+    p = _offload_pending_at (offload, i);
+
+    if (!p->done && p->route == route)
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+/**
+ * @brief Check the remote route can be chosen (measured, not failing, not in the backoff).
+ */
+static gboolean
+_offload_remote_available (nns_ex_offload_s * offload, GstClockTime now)
+{
+  return (GST_CLOCK_TIME_IS_VALID (offload->stats.latency[NNS_EX_OFFLOAD_REMOTE])
+      && offload->fails[NNS_EX_OFFLOAD_REMOTE] < NNS_EX_OFFLOAD_FAIL_LIMIT
+      && now >= offload->backoff_until);
+}
+
+/**
+ * @brief Check the route meets the target latency.
+ */
+static gboolean
+_offload_meets_target (nns_ex_offload_s * offload,
+    nns_ex_offload_route_e route, GstClockTime now)
+{
+  GstClockTime latency = offload->stats.latency[route];
+  GstClockTime limit = offload->target;
+
+  if (route == NNS_EX_OFFLOAD_LOCAL) {
+    /* the local inference is the default until it is measured */
+    return (!GST_CLOCK_TIME_IS_VALID (latency) || latency <= limit);
+  }
+
+  if (!_offload_remote_available (offload, now))
+    return FALSE;
+
+  /* hysteresis to go back to the remote device */
+  if (offload->route != NNS_EX_OFFLOAD_REMOTE)
+    limit = limit * NNS_EX_OFFLOAD_RECOVER_PERCENT / 100;
+
+  return (latency <= limit);
+}
+
+/**
+ * @brief Choose the route for the next window.
+ */
+static nns_ex_offload_route_e
+_offload_choose (nns_ex_offload_s * offload, GstClockTime now)
+{
+  nns_ex_offload_route_e other = _offload_other (offload->prefer);
+  GstClockTime *latency = offload->stats.latency;
+
+  if (_offload_meets_target (offload, offload->prefer, now))
+    return offload->prefer;
+
+  if (_offload_meets_target (offload, other, now))
+    return other;
+
+  /* both are late, choose the faster one */
+  if (_offload_remote_available (offload, now) &&
+      GST_CLOCK_TIME_IS_VALID (latency[NNS_EX_OFFLOAD_LOCAL]) &&
+      latency[NNS_EX_OFFLOAD_REMOTE] < latency[NNS_EX_OFFLOAD_LOCAL])
+    return NNS_EX_OFFLOAD_REMOTE;
+
+  return NNS_EX_OFFLOAD_LOCAL;
+}
+
+/**
+ * @brief Create the controller.
+ */
+nns_ex_offload_s *
+nns_ex_offload_new (GstClockTime target, GstClockTime timeout, guint window,
+    nns_ex_offload_route_e prefer)
+{
+  nns_ex_offload_s *offload;
+  guint r;
+
+  g_return_val_if_fail (target > 0 && GST_CLOCK_TIME_IS_VALID (target), NULL);
+  g_return_val_if_fail (prefer < NNS_EX_OFFLOAD_ROUTES, NULL);
+
+  offload = g_new0 (nns_ex_offload_s, 1);
+  g_mutex_init (&offload->lock);
+
+  offload->target = target;
+  offload->timeout = (timeout > 0) ? timeout : target * 2;
+  offload->window = MAX (window, 1);
+  offload->prefer = prefer;
+
+  /* start with the local inference, and probe the remote device with the first frame */
+  offload->route = NNS_EX_OFFLOAD_LOCAL;
+  offload->window_frames = offload->window;
+  offload->probe_frames = NNS_EX_OFFLOAD_PROBE_INTERVAL - 1;
+
+  offload->stats.route = offload->route;
+  for (r = 0; r < NNS_EX_OFFLOAD_ROUTES; r++)
+    offload->stats.latency[r] = GST_CLOCK_TIME_NONE;
+
+  return offload;
+}
+
+/**
+ * @brief Free the controller.
+ */
+void
+nns_ex_offload_free (nns_ex_offload_s * offload)
+{
+  g_return_if_fail (offload != NULL);
+
+  g_mutex_clear (&offload->lock);
+  g_free (offload);
+}
+
+/**
+ * @brief Choose the route of the frame.
+ */
+nns_ex_offload_route_e
+nns_ex_offload_route (nns_ex_offload_s * offload, guint64 id, GstClockTime now)
+{
+  nns_ex_offload_route_e route, other;
+  _offload_pending_s *p;
+
+  g_return_val_if_fail (offload != NULL, NNS_EX_OFFLOAD_LOCAL);
+
+  g_mutex_lock (&offload->lock);
+
+  _offload_expire (offload, now);
+
+  if (offload->window_frames >= offload->window)
+    _offload_switch (offload, _offload_choose (offload, now));
+
+  offload->window_frames++;
+  route = offload->route;
+
+  /* send a probe to update the latency of the other route */
+  if (++offload->probe_frames >= NNS_EX_OFFLOAD_PROBE_INTERVAL) {
+    other = _offload_other (route);
+
+    if ((other == NNS_EX_OFFLOAD_LOCAL || now >= offload->backoff_until) &&
+        !_offload_has_pending (offload, other)) {
+      route = other;
+      offload->probe_frames = 0;
+      offload->stats.probes++;
+    }
+  }
+
+  /* the ring is full, the oldest frame is a failure */
+  if (offload->pending_count == NNS_EX_OFFLOAD_MAX_PENDING) {
+    p = _offload_pending_at (offload, 0);
+
+    if (!p->done)
+      _offload_update (offload, p->route, offload->timeout, TRUE, now);
+
+    p->done = TRUE;
+    _offload_pop_done (offload);
+  }
+
+  p = _offload_pending_at (offload, offload->pending_count);
+  p->id = id;
+  p->sent = now;
+  p->route = route;
+  p->done = FALSE;
+  offload->pending_count++;
+
+  offload->stats.frames[route]++;
+
+  g_mutex_unlock (&offload->lock);
+  return route;
+}
+
+/**
+ * @brief Update the latency of the route when the result arrives.
+ */
+gboolean
+nns_ex_offload_complete (nns_ex_offload_s * offload, guint64 id,
+    GstClockTime now)
+{
+  _offload_pending_s *p;
+  gboolean found = FALSE;
+  guint i;
+
+  g_return_val_if_fail (offload != NULL, FALSE);
+
+  g_mutex_lock (&offload->lock);
+
+  _offload_expire (offload, now);
+
+  for (i = 0; i < offload->pending_count; i++) {
+    p = _offload_pending_at (offload, i);
+
+    if (!p->done && p->id == id) {
+      p->done = TRUE;
+      _offload_update (offload, p->route,
+          (now > p->sent) ? (now - p->sent) : 0, FALSE, now);
+      found = TRUE;
+      break;
+    }
+  }
+
+  _offload_pop_done (offload);
+
+  g_mutex_unlock (&offload->lock);
+  return found;
+}
+
+/**
+ * @brief Get the metrics of the controller.
+ */
+void
+nns_ex_offload_get_stats (nns_ex_offload_s * offload,
+    nns_ex_offload_stats_s * stats)
+{
+  g_return_if_fail (offload != NULL && stats != NULL);
+
+  g_mutex_lock (&offload->lock);
+  memcpy (stats, &offload->stats, sizeof (nns_ex_offload_stats_s));
+  g_mutex_unlock (&offload->lock);
+}
+
+/**
+ * @brief Get the name of the route.
+ */
+const gchar *
+nns_ex_offload_route_to_string (nns_ex_offload_route_e route)
+{
+  switch (route) {
+    case NNS_EX_OFFLOAD_LOCAL:
+      return "local";
+    case NNS_EX_OFFLOAD_REMOTE:
+      return "remote";
+    default:
+      break;
+  }
+
+  return "unknown";
+}
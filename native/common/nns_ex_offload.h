@@ -0,0 +1,155 @@
+/**
+ * @file	nns_ex_offload.h
+ * @date	19 October 2026
+ * @brief	Controller to route the frames to the local or remote inference by the latency
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * The controller measures the latency of each route, from the time the frame is routed
+ * to the time the result arrives: the local inference (tensor_filter in the device)
+ * and the round trip to the remote device (send the frame, run the model, receive the result).
+ * The latency of each route is smoothed (EWMA), and the route is chosen every window of frames :
+ *
+ * - the preferred route if it meets the target latency,
+ * - otherwise the other route if it meets the target,
+ * - otherwise the route with the lower latency.
+ *
+ * The controller sends a probe frame to the other route every NNS_EX_OFFLOAD_PROBE_INTERVAL frames
+ * to update its latency. A frame without the result in the timeout counts as a failure
+ * with the latency of the timeout. When the remote route fails NNS_EX_OFFLOAD_FAIL_LIMIT times in a row,
+ * or its latency exceeds the target, the controller falls back to the local inference at once,
+ * and does not probe the remote device for NNS_EX_OFFLOAD_BACKOFF.
+ * The remote route is chosen again when its latency is under NNS_EX_OFFLOAD_RECOVER_PERCENT
+ * percent of the target (hysteresis, the route does not flap at the boundary).
+ *
+ * Usage :
+ *
+ * offload = nns_ex_offload_new (100 * GST_MSECOND, 200 * GST_MSECOND, 8, NNS_EX_OFFLOAD_REMOTE);
+ *
+ * (before the frame is sent, e.g., the pad probe of output-selector)
+ * route = nns_ex_offload_route (offload, GST_BUFFER_PTS (buffer), now);
+ *
+ * (when the result arrives, tensor_sink of each route)
+ * nns_ex_offload_complete (offload, GST_BUFFER_PTS (buffer), now);
+ */
+
+#ifndef __NNS_EX_OFFLOAD_H__
+#define __NNS_EX_OFFLOAD_H__
+
+#include <glib.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Interval (in frames) to probe the other route.
+ */
+#define NNS_EX_OFFLOAD_PROBE_INTERVAL 30
+
+/**
+ * @brief Count of the failures (timeout) in a row to fall back to the local inference.
+ */
+#define NNS_EX_OFFLOAD_FAIL_LIMIT 3
+
+/**
+ * @brief Duration not to probe the remote device after the fallback.
+ */
+#define NNS_EX_OFFLOAD_BACKOFF (2 * GST_SECOND)
+
+/**
+ * @brief Percentage of the target to choose the remote route again after the fallback.
+ */
+#define NNS_EX_OFFLOAD_RECOVER_PERCENT 75
+
+/**
+ * @brief Max number of the frames waiting for the result.
+ */
+#define NNS_EX_OFFLOAD_MAX_PENDING 64
+
+/**
+ * @brief Route of the inference.
+ */
+typedef enum
+{
+  NNS_EX_OFFLOAD_LOCAL = 0,
+  NNS_EX_OFFLOAD_REMOTE = 1,
+
+  NNS_EX_OFFLOAD_ROUTES
+} nns_ex_offload_route_e;
+
+/**
+ * @brief Metrics of the controller.
+ */
+typedef struct
+{
+  nns_ex_offload_route_e route; /**< current route */
+  guint frames[NNS_EX_OFFLOAD_ROUTES]; /**< count of the frames routed (including the probes) */
+  guint completed[NNS_EX_OFFLOAD_ROUTES]; /**< count of the results */
+  guint timeouts[NNS_EX_OFFLOAD_ROUTES]; /**< count of the frames without the result in the timeout */
+  guint probes; /**< count of the probe frames */
+  guint switches; /**< count of the route changes */
+  guint fallbacks; /**< count of the fallbacks to the local inference */
+  GstClockTime latency[NNS_EX_OFFLOAD_ROUTES]; /**< smoothed latency, GST_CLOCK_TIME_NONE if not measured */
+  GstClockTime max_latency[NNS_EX_OFFLOAD_ROUTES]; /**< max latency of the results */
+} nns_ex_offload_stats_s;
+
+/**
+ * @brief Opaque data structure for the controller.
+ */
+typedef struct _nns_ex_offload_s nns_ex_offload_s;
+
+/**
+ * @brief Create the controller.
+ * @param target target latency (in nanoseconds) of the result
+ * @param timeout max time to wait for the result, a frame without the result is a failure (0 for the double of the target)
+ * @param window number of the frames to keep the route (1 to choose the route every frame)
+ * @param prefer the route to choose if both routes meet the target
+ * @return newly allocated controller, NULL if the parameters are invalid
+ */
+extern nns_ex_offload_s *
+nns_ex_offload_new (GstClockTime target, GstClockTime timeout, guint window,
+    nns_ex_offload_route_e prefer);
+
+/**
+ * @brief Free the controller.
+ */
+extern void
+nns_ex_offload_free (nns_ex_offload_s * offload);
+
+/**
+ * @brief Choose the route of the frame.
+ * @param id id to match the result (e.g., timestamp of the buffer)
+ * @param now current time (in nanoseconds, monotonic)
+ * @return the route to send the frame
+ * @note This is thread-safe.
+ */
+extern nns_ex_offload_route_e
+nns_ex_offload_route (nns_ex_offload_s * offload, guint64 id, GstClockTime now);
+
+/**
+ * @brief Update the latency of the route when the result arrives.
+ * @param id id of the frame given to nns_ex_offload_route()
+ * @param now current time (in nanoseconds, monotonic)
+ * @return TRUE if the frame is found, FALSE if the result is unknown or too late (already a failure)
+ * @note This is thread-safe.
+ */
+extern gboolean
+nns_ex_offload_complete (nns_ex_offload_s * offload, guint64 id,
+    GstClockTime now);
+
+/**
+ * @brief Get the metrics of the controller.
+ */
+extern void
+nns_ex_offload_get_stats (nns_ex_offload_s * offload,
+    nns_ex_offload_stats_s * stats);
+
+/**
+ * @brief Get the name of the route.
+ */
+extern const gchar *
+nns_ex_offload_route_to_string (nns_ex_offload_route_e route);
+
+G_END_DECLS
+
+#endif /* __NNS_EX_OFFLOAD_H__ */
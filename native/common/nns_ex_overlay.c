@@ -0,0 +1,358 @@
+/**
+ * @file	nns_ex_overlay.c
+ * @date	19 October 2026
+ * @brief	Sparse overlay to draw the detection results only on the pixels changed
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ */
+
+#include <string.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define NNS_EX_HAVE_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define NNS_EX_HAVE_SSE2 1
+#endif
+
+#include "nns_ex_overlay.h"
+
+/**
+ * @brief Data structure for a span, the visible pixels in a row.
+ */
+typedef struct
+{
+  guint y; /**< row */
+  guint x; /**< first column */
+  guint len; /**< number of the pixels */
+  guint offset; /**< index of the first pixel in the RGBA pixels */
+} _span_s;
+
+/**
+ * @brief Data structure for the sparse overlay.
+ */
+struct _nns_ex_overlay_s
+{
+  guint width; /**< width of the video frame */
+  guint height; /**< height of the video frame */
+  GArray *spans; /**< spans (_span_s) */
+  GArray *pixels; /**< RGBA pixels of the spans */
+  guint *x_map; /**< column of the overlay frame for each column of the video */
+  guint x_map_size; /**< size of the column map */
+};
+
+/**
+ * @brief Add the span with the pixels (RGBA), or the color if pixels is NULL.
+ */
+static void
+_add_span (nns_ex_overlay_s * ov, guint y, guint x, guint len,
+    const guint8 * pixels, const guint8 * color)
+{
+  _span_s span;
+  guint8 *dst;
+  guint i;
+
+  if (len == 0)
+    return;
+
+  span.y = y;
+  span.x = x;
+  span.len = len;
+  span.offset = ov->pixels->len / 4;
+  g_array_append_val (ov->spans, span);
+
+  g_array_set_size (ov->pixels, ov->pixels->len + len * 4);
+  dst = (guint8 *) ov->pixels->data + (gsize) span.offset * 4;
+
+  if (pixels) {
+    memcpy (dst, pixels, len * 4);
+  } else {
+    for (i = 0; i < len; i++)
+      memcpy (dst + i * 4, color, 4);
+  }
+}
+
+/**
+ * @brief Add the horizontal line [x0, x1) of the color, clipped to the frame.
+ */
+static void
+_add_hline (nns_ex_overlay_s * ov, gint y, gint x0, gint x1,
+    const guint8 * color)
+{
+  if (y < 0 || y >= (gint) ov->height)
+    return;
+
+  x0 = MAX (x0, 0);
+  x1 = MIN (x1, (gint) ov->width);
+
+  if (x0 < x1)
+    _add_span (ov, (guint) y, (guint) x0, (guint) (x1 - x0), NULL, color);
+}
+
+/**
+ * @brief Get the first visible pixel (alpha > 0) from x in the row of RGBA pixels.
+ */
+static guint
+_skip_transparent (const guint8 * row, guint x, guint width)
+{
+#ifdef NNS_EX_HAVE_NEON
+  static const guint8 alpha_mask[16] = {
+    0, 0, 0, 0xff, 0, 0, 0, 0xff, 0, 0, 0, 0xff, 0, 0, 0, 0xff
+  };
+  const uint8x16_t mask = vld1q_u8 (alpha_mask);
+
+  /* 4 pixels at once */
+  for (; x + 4 <= width; x += 4) {
+    uint64x2_t a =
+        vreinterpretq_u64_u8 (vandq_u8 (vld1q_u8 (row + x * 4), mask));
+
+    if ((vgetq_lane_u64 (a, 0) | vgetq_lane_u64 (a, 1)) != 0)
+      break;
+  }
+#elif defined(NNS_EX_HAVE_SSE2)
+  const __m128i mask = _mm_set1_epi32 ((int) 0xff000000);
+  const __m128i zero = _mm_setzero_si128 ();
+
+  /* 4 pixels at once */
+  for (; x + 4 <= width; x += 4) {
+    __m128i a = _mm_and_si128 (_mm_loadu_si128 ((const __m128i *) (row +
+                x * 4)), mask);
+
+    if (_mm_movemask_epi8 (_mm_cmpeq_epi8 (a, zero)) != 0xffff)
+      break;
+  }
+#endif
+
+  /* remained */
+  while (x < width && row[x * 4 + 3] == 0)
+    x++;
+
+  return x;
+}
+
+/**
+ * @brief Blend a color channel, (src * a + dst * (255 - a)) / 255.
+ */
+static inline guint8
+_blend (guint8 src, guint8 dst, guint a)
+{
+  guint t = src * a + dst * (255 - a) + 128;
+
+  return (guint8) ((t + (t >> 8)) >> 8);
+}
+
+/**
+ * @brief Create the empty overlay.
+ */
+nns_ex_overlay_s *
+nns_ex_overlay_new (void)
+{
+  nns_ex_overlay_s *ov;
+
+  ov = g_new0 (nns_ex_overlay_s, 1);
+  ov->spans = g_array_new (FALSE, FALSE, sizeof (_span_s));
+  ov->pixels = g_array_new (FALSE, FALSE, sizeof (guint8));
+
+  return ov;
+}
+
+/**
+ * @brief Free the overlay.
+ */
+void
+nns_ex_overlay_free (nns_ex_overlay_s * ov)
+{
+  g_return_if_fail (ov != NULL);
+
+  g_array_free (ov->spans, TRUE);
+  g_array_free (ov->pixels, TRUE);
+  g_free (ov->x_map);
+  g_free (ov);
+}
+
+/**
+ * @brief Remove all spans and set the size of the video to draw.
+ */
+void
+nns_ex_overlay_reset (nns_ex_overlay_s * ov, guint width, guint height)
+{
+  g_return_if_fail (ov != NULL);
+
+  ov->width = width;
+  ov->height = height;
+  g_array_set_size (ov->spans, 0);
+  g_array_set_size (ov->pixels, 0);
+}
+
+/**
+ * @brief Get the number of the pixels to blend.
+ */
+guint
+nns_ex_overlay_get_pixels (nns_ex_overlay_s * ov)
+{
+  g_return_val_if_fail (ov != NULL, 0);
+
+  return ov->pixels->len / 4;
+}
+
+/**
+ * @brief Make the spans from the RGBA overlay frame.
+ */
+void
+nns_ex_overlay_from_rgba (nns_ex_overlay_s * ov, const guint8 * data,
+    guint width, guint height, gint stride, guint video_width,
+    guint video_height)
+{
+  const guint8 *row;
+  guint8 *buf;
+  guint x, y, k, start, sy;
+
+  g_return_if_fail (ov != NULL);
+  g_return_if_fail (data != NULL);
+
+  nns_ex_overlay_reset (ov, video_width, video_height);
+
+  if (width == 0 || height == 0)
+    return;
+
+  if (width == video_width && height == video_height) {
+    for (y = 0; y < height; y++) {
+      row = data + (gsize) y * stride;
+      x = 0;
+
+      while ((x = _skip_transparent (row, x, width)) < width) {
+        start = x;
+        while (x < width && row[x * 4 + 3] != 0)
+          x++;
+
+        _add_span (ov, y, start, x - start, row + start * 4, NULL);
+      }
+    }
+
+    return;
+  }
+
+  /* nearest pixel of the overlay frame, pixel centers aligned */
+  if (ov->x_map_size != video_width) {
+    g_free (ov->x_map);
+    ov->x_map = g_new (guint, video_width);
+    ov->x_map_size = video_width;
+  }
+
+  for (x = 0; x < video_width; x++)
+    ov->x_map[x] = MIN ((2 * x + 1) * width / (2 * video_width), width - 1);
+
+  for (y = 0; y < video_height; y++) {
+    sy = MIN ((2 * y + 1) * height / (2 * video_height), height - 1);
+    row = data + (gsize) sy * stride;
+    x = 0;
+
+    while (x < video_width) {
+      if (row[ov->x_map[x] * 4 + 3] == 0) {
+        x++;
+        continue;
+      }
+
+      start = x;
+      while (x < video_width && row[ov->x_map[x] * 4 + 3] != 0)
+        x++;
+
+      _add_span (ov, y, start, x - start, NULL, row + ov->x_map[start] * 4);
+
+      /* sample the pixels of the span */
+      buf = (guint8 *) ov->pixels->data + ov->pixels->len - (x - start) * 4;
+      for (k = start; k < x; k++, buf += 4)
+        memcpy (buf, row + ov->x_map[k] * 4, 4);
+    }
+  }
+}
+
+/**
+ * @brief Add the outline of the rectangle.
+ */
+void
+nns_ex_overlay_add_rect (nns_ex_overlay_s * ov, gint x, gint y, gint width,
+    gint height, guint thickness, const guint8 rgba[4])
+{
+  gint t, r;
+
+  g_return_if_fail (ov != NULL);
+  g_return_if_fail (rgba != NULL);
+
+  t = (gint) MAX (thickness, 1);
+
+  if (width <= 2 * t || height <= 2 * t) {
+    nns_ex_overlay_fill_rect (ov, x, y, width, height, rgba);
+    return;
+  }
+
+  for (r = 0; r < t; r++) {
+    _add_hline (ov, y + r, x, x + width, rgba);
+    _add_hline (ov, y + height - 1 - r, x, x + width, rgba);
+  }
+
+  /* left and right lines */
+  for (r = y + t; r < y + height - t; r++) {
+    _add_hline (ov, r, x, x + t, rgba);
+    _add_hline (ov, r, x + width - t, x + width, rgba);
+  }
+}
+
+/**
+ * @brief Add the filled rectangle.
+ */
+void
+nns_ex_overlay_fill_rect (nns_ex_overlay_s * ov, gint x, gint y, gint width,
+    gint height, const guint8 rgba[4])
+{
+  gint r;
+
+  g_return_if_fail (ov != NULL);
+  g_return_if_fail (rgba != NULL);
+
+  for (r = y; r < y + height; r++)
+    _add_hline (ov, r, x, x + width, rgba);
+}
+
+/**
+ * @brief Blend the spans onto the packed RGB video frame in place.
+ */
+gboolean
+nns_ex_overlay_blend (nns_ex_overlay_s * ov, guint8 * data, guint width,
+    guint height, gint stride, guint pixel_stride, guint r_offset,
+    guint g_offset, guint b_offset)
+{
+  const _span_s *span;
+  const guint8 *src;
+  guint8 *dst;
+  guint i, k, a;
+
+  g_return_val_if_fail (ov != NULL, FALSE);
+  g_return_val_if_fail (data != NULL, FALSE);
+
+  if (width != ov->width || height != ov->height)
+    return FALSE;
+
+  for (i = 0; i < ov->spans->len; i++) {
+    span = &g_array_index (ov->spans, _span_s, i);
+    src = (const guint8 *) ov->pixels->data + (gsize) span->offset * 4;
+    dst = data + (gsize) span->y * stride + (gsize) span->x * pixel_stride;
+
+    for (k = 0; k < span->len; k++, src += 4, dst += pixel_stride) {
+      a = src[3];
+
+      if (a == 255) {
+        dst[r_offset] = src[0];
+        dst[g_offset] = src[1];
+        dst[b_offset] = src[2];
+      } else if (a > 0) {
+        dst[r_offset] = _blend (src[0], dst[r_offset], a);
+        dst[g_offset] = _blend (src[1], dst[g_offset], a);
+        dst[b_offset] = _blend (src[2], dst[b_offset], a);
+      }
+    }
+  }
+
+  return TRUE;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file	nns_ex_overlay.h
+ * @date	19 October 2026
+ * @brief	Sparse overlay to draw the detection results only on the pixels changed
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * 'compositor' and 'videomixer' blend the whole overlay frame (e.g., RGBA from 'tensor_decoder mode=bounding_boxes')
+ * onto every video frame, although the boxes cover a few percent of the frame.
+ * The sparse overlay keeps the runs (spans) of the visible pixels in each row, and blends only the spans
+ * onto the video frame in place.
+ *
+ * The spans are made once for each result, from the RGBA overlay frame (the transparent blocks are skipped
+ * with NEON or SSE2) or from the rectangles, and the same spans are blended onto the frames until the next result.
+ *
+ * Usage :
+ *
+ * ov = nns_ex_overlay_new ();
+ * (new result)
+ * nns_ex_overlay_from_rgba (ov, rgba, 640, 480, 640 * 4, 640, 480);
+ * (each video frame, packed RGB)
+ * nns_ex_overlay_blend (ov, frame, 640, 480, 640 * 3, 3, 0, 1, 2);
+ * nns_ex_overlay_free (ov);
+ */
+
+#ifndef __NNS_EX_OVERLAY_H__
+#define __NNS_EX_OVERLAY_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Opaque data structure for the sparse overlay.
+ */
+typedef struct _nns_ex_overlay_s nns_ex_overlay_s;
+
+/**
+ * @brief Create the empty overlay.
+ */
+extern nns_ex_overlay_s *
+nns_ex_overlay_new (void);
+
+/**
+ * @brief Free the overlay.
+ */
+extern void
+nns_ex_overlay_free (nns_ex_overlay_s * ov);
+
+/**
+ * @brief Remove all spans and set the size of the video to draw.
+ * @param width width of the video frame
+ * @param height height of the video frame
+ */
+extern void
+nns_ex_overlay_reset (nns_ex_overlay_s * ov, guint width, guint height);
+
+/**
+ * @brief Get the number of the pixels to blend.
+ */
+extern guint
+nns_ex_overlay_get_pixels (nns_ex_overlay_s * ov);
+
+/**
+ * @brief Make the spans from the RGBA overlay frame (the pixels with alpha 0 are transparent).
+ * @param data RGBA overlay frame
+ * @param width width of the overlay frame
+ * @param height height of the overlay frame
+ * @param stride bytes per row of the overlay frame
+ * @param video_width width of the video frame (the overlay is scaled with the nearest pixel if different)
+ * @param video_height height of the video frame
+ */
+extern void
+nns_ex_overlay_from_rgba (nns_ex_overlay_s * ov, const guint8 * data,
+    guint width, guint height, gint stride, guint video_width,
+    guint video_height);
+
+/**
+ * @brief Add the outline of the rectangle. Call nns_ex_overlay_reset() first.
+ * @param thickness width (in pixels) of the line
+ * @param rgba color of the line, alpha 255 for the opaque line
+ */
+extern void
+nns_ex_overlay_add_rect (nns_ex_overlay_s * ov, gint x, gint y, gint width,
+    gint height, guint thickness, const guint8 rgba[4]);
+
+/**
+ * @brief Add the filled rectangle (e.g., the background of the label). Call nns_ex_overlay_reset() first.
+ * @param rgba color of the rectangle
+ */
+extern void
+nns_ex_overlay_fill_rect (nns_ex_overlay_s * ov, gint x, gint y, gint width,
+    gint height, const guint8 rgba[4]);
+
+/**
+ * @brief Blend the spans onto the packed RGB video frame in place (RGB, BGR, RGBx, xRGB, BGRA, ...).
+ * @param data video frame
+ * @param width width of the video frame
+ * @param height height of the video frame
+ * @param stride bytes per row
+ * @param pixel_stride bytes per pixel (3 or 4)
+ * @param r_offset offset of red in a pixel
+ * @param g_offset offset of green in a pixel
+ * @param b_offset offset of blue in a pixel
+ * @return FALSE if the size of the frame is different from the overlay
+ */
+extern gboolean
+nns_ex_overlay_blend (nns_ex_overlay_s * ov, guint8 * data, guint width,
+    guint height, gint stride, guint pixel_stride, guint r_offset,
+    guint g_offset, guint b_offset);
+
+G_END_DECLS
+
+#endif /* __NNS_EX_OVERLAY_H__ */
@@ -0,0 +1,66 @@
+/**
+ * @file	nns_ex_plugin.c
+ * @date	19 October 2026
+ * @brief	GStreamer plugin of the elements in the common library, for gst-launch scripts
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * The applications register the elements with nns_ex_tensorize_register(),
+ * nns_ex_sparse_overlay_register(), nns_ex_batch_register(), nns_ex_tensor_pay_register(),
+ * nns_ex_tensor_depay_register() and nns_ex_roi_mask_register(). The plugin 'nnsexample' provides the same elements
+ * to gst-launch-1.0 (add the install directory to GST_PLUGIN_PATH).
+ *
+ * $ gst-inspect-1.0 nns_ex_sparse_overlay
+ */
+
+#include <gst/gst.h>
+
+#include "nns_ex_batch.h"
+#include "nns_ex_roi_mask.h"
+#include "nns_ex_sparse_overlay.h"
+#include "nns_ex_tensorize.h"
+#include "nns_ex_transport.h"
+
+#ifndef PACKAGE
+#define PACKAGE "nnstreamer-example"
+#endif
+
+/**
+ * @brief Register the elements of the plugin.
+ */
+static gboolean
+plugin_init (GstPlugin * plugin)
+{
+  if (!gst_element_register (plugin, NNS_EX_TENSORIZE_NAME, GST_RANK_NONE,
+          nns_ex_tensorize_get_type ()))
+    return FALSE;
+
+  if (!gst_element_register (plugin, NNS_EX_SPARSE_OVERLAY_NAME,
+          GST_RANK_NONE, nns_ex_sparse_overlay_get_type ()))
+    return FALSE;
+
+  if (!gst_element_register (plugin, NNS_EX_BATCH_NAME, GST_RANK_NONE,
+          nns_ex_batch_get_type ()))
+    return FALSE;
+
+  if (!gst_element_register (plugin, NNS_EX_TENSOR_PAY_NAME, GST_RANK_NONE,
+          nns_ex_tensor_pay_get_type ()))
+    return FALSE;
+
+  if (!gst_element_register (plugin, NNS_EX_TENSOR_DEPAY_NAME, GST_RANK_NONE,
+          nns_ex_tensor_depay_get_type ()))
+    return FALSE;
+
+  if (!gst_element_register (plugin, NNS_EX_ROI_MASK_NAME, GST_RANK_NONE,
+          nns_ex_roi_mask_get_type ()))
+    return FALSE;
+
+  return TRUE;
+}
+
+GST_PLUGIN_DEFINE (GST_VERSION_MAJOR,
+    GST_VERSION_MINOR,
+    nnsexample,
+    "Elements of the NNStreamer examples",
+    plugin_init, "0.1.0", "LGPL", PACKAGE,
+    "https://github.com/nnsuite/nnstreamer-example")
@@ -0,0 +1,516 @@
+/**
+ * @file	nns_ex_pose.c
+ * @date	19 October 2026
+ * @brief	Pose decoder, the peak of each keypoint in the heatmap
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ */
+
+#include <string.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define NNS_EX_HAVE_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define NNS_EX_HAVE_SSE2 1
+#endif
+
+#include "nns_ex_pose.h"
+
+/**
+ * @brief Number of keypoints compared at once, and the groups of the max keypoints.
+ */
+#define POSE_LANES 4
+#define POSE_GROUPS (NNS_EX_POSE_MAX_KEYPOINTS / POSE_LANES)
+
+/**
+ * @brief Get the number of the first cells, the vectors of the cell can be loaded in the heatmap.
+ * The lanes over the keypoints read the next cell (ignored), the rest of the cells are copied.
+ */
+static inline guint
+_pose_safe_cells (guint cells, guint num, guint groups)
+{
+  gsize total = (gsize) cells * num;
+  gsize span = (gsize) groups * POSE_LANES;
+
+  if (span == num)
+    return cells;
+
+  return (total >= span) ? (guint) ((total - span) / num + 1) : 0;
+}
+
+/**
+ * @brief Find the peak of each keypoint in a single pass over the heatmap.
+ */
+guint
+nns_ex_pose_find_peaks (const gfloat * heatmap, guint width, guint height,
+    guint num, gfloat threshold, nns_ex_keypoint_s * keypoints)
+{
+  gfloat max[NNS_EX_POSE_MAX_KEYPOINTS];
+  guint32 cell[NNS_EX_POSE_MAX_KEYPOINTS];
+  guint cells, k, valid = 0;
+
+  g_return_val_if_fail (heatmap != NULL && keypoints != NULL, 0);
+  g_return_val_if_fail (num > 0 && num <= NNS_EX_POSE_MAX_KEYPOINTS, 0);
+  g_return_val_if_fail (width > 0 && height > 0, 0);
+
+  cells = width * height;
+
+#if defined(NNS_EX_HAVE_NEON) || defined(NNS_EX_HAVE_SSE2)
+  {
+    gfloat padded[NNS_EX_POSE_MAX_KEYPOINTS];
+    const gfloat *p = heatmap;
+    const gfloat *src;
+    guint groups = (num + POSE_LANES - 1) / POSE_LANES;
+    guint safe = _pose_safe_cells (cells, num, groups);
+    guint c, g;
+#ifdef NNS_EX_HAVE_NEON
+    float32x4_t vmax[POSE_GROUPS];
+    uint32x4_t vcell[POSE_GROUPS];
+
+    for (g = 0; g < groups; g++) {
+      vmax[g] = vdupq_n_f32 (-G_MAXFLOAT);
+      vcell[g] = vdupq_n_u32 (0);
+    }
+#else
+    __m128 vmax[POSE_GROUPS];
+    __m128i vcell[POSE_GROUPS];
+
+    for (g = 0; g < groups; g++) {
+      vmax[g] = _mm_set1_ps (-G_MAXFLOAT);
+      vcell[g] = _mm_setzero_si128 ();
+    }
+#endif
+
+    for (k = 0; k < NNS_EX_POSE_MAX_KEYPOINTS; k++)
+      padded[k] = -G_MAXFLOAT;
+
+    for (c = 0; c < cells; c++, p += num) {
+      src = p;
+
+      if (c >= safe) {
+        memcpy (padded, p, num * sizeof (gfloat));
+        src = padded;
+      }
+
+      /* the first cell is kept if the scores are same (greater than, not equal) */
+#ifdef NNS_EX_HAVE_NEON
+      {
+        const uint32x4_t vc = vdupq_n_u32 (c);
+
+        for (g = 0; g < groups; g++) {
+          float32x4_t v = vld1q_f32 (src + g * POSE_LANES);
+          uint32x4_t m = vcgtq_f32 (v, vmax[g]);
+
+          vmax[g] = vbslq_f32 (m, v, vmax[g]);
+          vcell[g] = vbslq_u32 (m, vc, vcell[g]);
+        }
+      }
+#else
+      {
+        const __m128i vc = _mm_set1_epi32 ((gint) c);
+
+        for (g = 0; g < groups; g++) {
+          __m128 v = _mm_loadu_ps (src + g * POSE_LANES);
+          __m128 m = _mm_cmpgt_ps (v, vmax[g]);
+          __m128i mi = _mm_castps_si128 (m);
+
+          vmax[g] = _mm_or_ps (_mm_and_ps (m, v), _mm_andnot_ps (m, vmax[g]));
+          vcell[g] = _mm_or_si128 (_mm_and_si128 (mi, vc),
+              _mm_andnot_si128 (mi, vcell[g]));
+        }
+      }
+#endif
+    }
+
+    for (g = 0; g < groups; g++) {
+#ifdef NNS_EX_HAVE_NEON
+      vst1q_f32 (max + g * POSE_LANES, vmax[g]);
+      vst1q_u32 (cell + g * POSE_LANES, vcell[g]);
+#else
+      _mm_storeu_ps (max + g * POSE_LANES, vmax[g]);
+      _mm_storeu_si128 ((__m128i *) (cell + g * POSE_LANES), vcell[g]);
+#endif
+    }
+  }
+#else
+  {
+    const gfloat *p = heatmap;
+    guint c;
+
+    for (k = 0; k < num; k++) {
+      max[k] = -G_MAXFLOAT;
+      cell[k] = 0;
+    }
+
+    for (c = 0; c < cells; c++, p += num) {
+      for (k = 0; k < num; k++) {
+        if (p[k] > max[k]) {
+          max[k] = p[k];
+          cell[k] = c;
+        }
+      }
+    }
+  }
+#endif
+
+  for (k = 0; k < num; k++) {
+    keypoints[k].x = cell[k] % width;
+    keypoints[k].y = cell[k] / width;
+    keypoints[k].fx = (gfloat) keypoints[k].x;
+    keypoints[k].fy = (gfloat) keypoints[k].y;
+    keypoints[k].score = max[k];
+    keypoints[k].valid = (max[k] > threshold);
+
+    if (keypoints[k].valid)
+      valid++;
+  }
+
+  return valid;
+}
+
+/**
+ * @brief Refine the peaks with the offset map.
+ */
+void
+nns_ex_pose_refine (nns_ex_keypoint_s * keypoints, guint num,
+    const gfloat * offsets, guint width, guint height, gfloat output_stride)
+{
+  const gfloat *o;
+  guint k;
+
+  g_return_if_fail (keypoints != NULL && offsets != NULL);
+  g_return_if_fail (num <= NNS_EX_POSE_MAX_KEYPOINTS);
+  g_return_if_fail (width > 0 && height > 0 && output_stride > 0.0f);
+
+  for (k = 0; k < num; k++) {
+    if (keypoints[k].x >= width || keypoints[k].y >= height)
+      continue;
+
+    o = offsets + ((gsize) keypoints[k].y * width + keypoints[k].x) * 2 * num;
+
+    keypoints[k].fy = CLAMP (keypoints[k].y + o[k] / output_stride, 0.0f,
+        (gfloat) (height - 1));
+    keypoints[k].fx = CLAMP (keypoints[k].x + o[num + k] / output_stride,
+        0.0f, (gfloat) (width - 1));
+  }
+}
+
+/**
+ * @brief Add the local peak, replace the lowest peak if the peaks are full.
+ */
+static void
+_pose_add_peak (nns_ex_pose_peak_s * peaks, guint * count, guint max_peaks,
+    guint x, guint y, guint k, gfloat score)
+{
+  nns_ex_pose_peak_s *peak;
+  guint i, low;
+
+  if (*count < max_peaks) {
+    peak = &peaks[(*count)++];
+  } else {
+    for (low = 0, i = 1; i < max_peaks; i++) {
+      if (peaks[i].score < peaks[low].score)
+        low = i;
+    }
+
+    if (score <= peaks[low].score)
+      return;
+
+    peak = &peaks[low];
+  }
+
+  peak->x = x;
+  peak->y = y;
+  peak->keypoint = k;
+  peak->score = score;
+}
+
+/**
+ * @brief Check the local peak of the keypoint at the cell.
+ * The score is greater than the previous neighbors (in the scan order) and not less than the next neighbors,
+ * so that a plateau has a single peak.
+ */
+static gboolean
+_pose_is_local_peak (const gfloat * heatmap, guint width, guint height,
+    guint num, guint x, guint y, guint k, gfloat threshold)
+{
+  const gfloat *center = heatmap + ((gsize) y * width + x) * num + k;
+  gfloat v = *center;
+  gfloat n;
+  gint dx, dy;
+
+  if (!(v > threshold))
+    return FALSE;
+
+  for (dy = -1; dy <= 1; dy++) {
+    if ((gint) y + dy < 0 || (gint) y + dy >= (gint) height)
+      continue;
+
+    for (dx = -1; dx <= 1; dx++) {
+      if ((dx == 0 && dy == 0) ||
+          (gint) x + dx < 0 || (gint) x + dx >= (gint) width)
+        continue;
+
+      n = center[((gssize) dy * width + dx) * (gssize) num];
+
+      if (dy < 0 || (dy == 0 && dx < 0)) {
+        if (n >= v)
+          return FALSE;
+      } else if (n > v) {
+        return FALSE;
+      }
+    }
+  }
+
+  return TRUE;
+}
+
+#ifdef NNS_EX_HAVE_NEON
+/**
+ * @brief Get the bits of the lanes of the mask.
+ */
+static inline guint
+_pose_mask_bits (uint32x4_t m)
+{
+  return (vgetq_lane_u32 (m, 0) & 1) | (vgetq_lane_u32 (m, 1) & 2) |
+      (vgetq_lane_u32 (m, 2) & 4) | (vgetq_lane_u32 (m, 3) & 8);
+}
+#endif
+
+/**
+ * @brief Find the local peaks of all keypoints (3x3 non-max suppression) in a single pass over the heatmap.
+ */
+guint
+nns_ex_pose_find_local_peaks (const gfloat * heatmap, guint width,
+    guint height, guint num, gfloat threshold, nns_ex_pose_peak_s * peaks,
+    guint max_peaks)
+{
+  guint x, y, k, k0;
+  guint count = 0;
+
+  g_return_val_if_fail (heatmap != NULL && peaks != NULL, 0);
+  g_return_val_if_fail (num > 0 && num <= NNS_EX_POSE_MAX_KEYPOINTS, 0);
+  g_return_val_if_fail (width > 0 && height > 0 && max_peaks > 0, 0);
+
+  for (y = 0; y < height; y++) {
+    for (x = 0; x < width; x++) {
+      k0 = 0;
+
+#if defined(NNS_EX_HAVE_NEON) || defined(NNS_EX_HAVE_SSE2)
+      /* the inner cells compare the full groups of 4 keypoints with the 8 neighbors,
+       * the cells on the border and the rest of the keypoints are checked one by one */
+      if (x > 0 && y > 0 && x + 1 < width && y + 1 < height) {
+        const gfloat *c = heatmap + ((gsize) y * width + x) * num;
+        const gsize s = (gsize) width * num;
+        guint g, l, bits;
+
+        k0 = num - num % POSE_LANES;
+
+        for (g = 0; g < k0; g += POSE_LANES, c += POSE_LANES) {
+#ifdef NNS_EX_HAVE_NEON
+          float32x4_t v = vld1q_f32 (c);
+          uint32x4_t m = vcgtq_f32 (v, vdupq_n_f32 (threshold));
+
+          /* most of the cells are under the threshold */
+          if (_pose_mask_bits (m) == 0)
+            continue;
+
+          m = vandq_u32 (m, vcgtq_f32 (v, vld1q_f32 (c - s - num)));
+          m = vandq_u32 (m, vcgtq_f32 (v, vld1q_f32 (c - s)));
+          m = vandq_u32 (m, vcgtq_f32 (v, vld1q_f32 (c - s + num)));
+          m = vandq_u32 (m, vcgtq_f32 (v, vld1q_f32 (c - num)));
+          m = vandq_u32 (m, vcgeq_f32 (v, vld1q_f32 (c + num)));
+          m = vandq_u32 (m, vcgeq_f32 (v, vld1q_f32 (c + s - num)));
+          m = vandq_u32 (m, vcgeq_f32 (v, vld1q_f32 (c + s)));
+          m = vandq_u32 (m, vcgeq_f32 (v, vld1q_f32 (c + s + num)));
+          bits = _pose_mask_bits (m);
+#else
+          __m128 v = _mm_loadu_ps (c);
+          __m128 m = _mm_cmpgt_ps (v, _mm_set1_ps (threshold));
+
+          /* most of the cells are under the threshold */
+          if (_mm_movemask_ps (m) == 0)
+            continue;
+
+          m = _mm_and_ps (m, _mm_cmpgt_ps (v, _mm_loadu_ps (c - s - num)));
+          m = _mm_and_ps (m, _mm_cmpgt_ps (v, _mm_loadu_ps (c - s)));
+          m = _mm_and_ps (m, _mm_cmpgt_ps (v, _mm_loadu_ps (c - s + num)));
+          m = _mm_and_ps (m, _mm_cmpgt_ps (v, _mm_loadu_ps (c - num)));
+          m = _mm_and_ps (m, _mm_cmpge_ps (v, _mm_loadu_ps (c + num)));
+          m = _mm_and_ps (m, _mm_cmpge_ps (v, _mm_loadu_ps (c + s - num)));
+          m = _mm_and_ps (m, _mm_cmpge_ps (v, _mm_loadu_ps (c + s)));
+          m = _mm_and_ps (m, _mm_cmpge_ps (v, _mm_loadu_ps (c + s + num)));
+          bits = (guint) _mm_movemask_ps (m);
+#endif
+
+          for (l = 0; bits != 0; l++, bits >>= 1) {
+            if (bits & 1)
+              _pose_add_peak (peaks, &count, max_peaks, x, y, g + l, c[l]);
+          }
+        }
+      }
+#endif
+
+      for (k = k0; k < num; k++) {
+        if (_pose_is_local_peak (heatmap, width, height, num, x, y, k,
+                threshold))
+          _pose_add_peak (peaks, &count, max_peaks, x, y, k,
+              heatmap[((gsize) y * width + x) * num + k]);
+      }
+    }
+  }
+
+  return count;
+}
+
+/**
+ * @brief Group the local peaks into the persons along the skeleton tree.
+ */
+guint
+nns_ex_pose_group (const nns_ex_pose_peak_s * peaks, guint n_peaks,
+    guint num, const gint * parents, gfloat radius,
+    nns_ex_pose_instance_s * instances, guint max_instances)
+{
+  guint order[NNS_EX_POSE_MAX_KEYPOINTS];
+  gboolean placed[NNS_EX_POSE_MAX_KEYPOINTS];
+  guint head[NNS_EX_POSE_MAX_KEYPOINTS + 1];
+  guint pos[NNS_EX_POSE_MAX_KEYPOINTS];
+  guint list[NNS_EX_POSE_MAX_PEAKS];
+  gboolean used[NNS_EX_POSE_MAX_PEAKS];
+  nns_ex_pose_instance_s *inst;
+  nns_ex_keypoint_s *kp;
+  const nns_ex_pose_peak_s *peak;
+  guint n_order, root, k, i, j, r, a, t;
+  gint best;
+  gfloat r2, d, best_d, dx, dy, sum;
+  gboolean progress;
+  guint count = 0;
+
+  g_return_val_if_fail (peaks != NULL && parents != NULL, 0);
+  g_return_val_if_fail (instances != NULL, 0);
+  g_return_val_if_fail (num > 0 && num <= NNS_EX_POSE_MAX_KEYPOINTS, 0);
+
+  n_peaks = MIN (n_peaks, NNS_EX_POSE_MAX_PEAKS);
+  r2 = radius * radius;
+
+  /* the root keypoint, and the order of the tree (the parent before the children) */
+  for (root = 0; root < num; root++) {
+    if (parents[root] < 0)
+      break;
+  }
+
+  if (root == num)
+    return 0;
+
+  memset (placed, 0, sizeof (placed));
+  order[0] = root;
+  placed[root] = TRUE;
+  n_order = 1;
+
+  do {
+    progress = FALSE;
+
+    for (k = 0; k < num; k++) {
+      if (!placed[k] && parents[k] >= 0 && (guint) parents[k] < num &&
+          placed[parents[k]]) {
+        order[n_order++] = k;
+        placed[k] = TRUE;
+        progress = TRUE;
+      }
+    }
+  } while (progress);
+
+  /* the peaks of each keypoint (counting sort) */
+  memset (head, 0, sizeof (head));
+  for (i = 0; i < n_peaks; i++) {
+    if (peaks[i].keypoint < num)
+      head[peaks[i].keypoint + 1]++;
+  }
+
+  for (k = 0; k < num; k++) {
+    head[k + 1] += head[k];
+    pos[k] = head[k];
+  }
+
+  for (i = 0; i < n_peaks; i++) {
+    if (peaks[i].keypoint < num)
+      list[pos[peaks[i].keypoint]++] = i;
+    used[i] = FALSE;
+  }
+
+  /* the root peaks in the order of the score */
+  for (i = head[root] + 1; i < head[root + 1]; i++) {
+    t = list[i];
+
+    for (j = i; j > head[root] && peaks[list[j - 1]].score < peaks[t].score;
+        j--)
+      list[j] = list[j - 1];
+
+    list[j] = t;
+  }
+
+  for (r = head[root]; r < head[root + 1] && count < max_instances; r++) {
+    inst = &instances[count++];
+    memset (inst, 0, sizeof (nns_ex_pose_instance_s));
+
+    for (i = 0; i < n_order; i++) {
+      k = order[i];
+
+      if (k == root) {
+        best = (gint) list[r];
+      } else {
+        /* the nearest peak from the parent (or the ancestor if the parent is not found) */
+        a = (guint) parents[k];
+        while (!inst->keypoints[a].valid)
+          a = (guint) parents[a];
+
+        best = -1;
+        best_d = r2;
+
+        for (j = head[k]; j < head[k + 1]; j++) {
+          peak = &peaks[list[j]];
+
+          if (used[list[j]])
+            continue;
+
+          dx = (gfloat) peak->x - (gfloat) inst->keypoints[a].x;
+          dy = (gfloat) peak->y - (gfloat) inst->keypoints[a].y;
+          d = dx * dx + dy * dy;
+
+          if (d < best_d || (d == best_d && (best < 0 ||
+                      peak->score > peaks[best].score))) {
+            best = (gint) list[j];
+            best_d = d;
+          }
+        }
+
+        if (best < 0)
+          continue;
+      }
+
+      used[best] = TRUE;
+      peak = &peaks[best];
+      kp = &inst->keypoints[k];
+
+      kp->x = peak->x;
+      kp->y = peak->y;
+      kp->fx = (gfloat) peak->x;
+      kp->fy = (gfloat) peak->y;
+      kp->score = peak->score;
+      kp->valid = TRUE;
+    }
+
+    for (sum = 0.0f, k = 0; k < num; k++) {
+      if (inst->keypoints[k].valid) {
+        inst->num_valid++;
+        sum += inst->keypoints[k].score;
+      }
+    }
+
+    inst->score = sum / num;
+  }
+
+  return count;
+}
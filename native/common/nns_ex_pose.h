@@ -0,0 +1,155 @@
+/**
+ * @file	nns_ex_pose.h
+ * @date	19 October 2026
+ * @brief	Pose decoder, the peak of each keypoint in the heatmap
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * The heatmap of the pose model is HWC (height x width x keypoints), the scores of all keypoints
+ * of a cell are contiguous. The decoder reads the heatmap once in order, and updates the max
+ * of all keypoints at a cell with the compare and select of NEON or SSE2 (4 keypoints at once),
+ * instead of a strided pass over the whole heatmap for each keypoint.
+ *
+ * The offset map (PoseNet, HWC with 2 x keypoints channels, the y offsets then the x offsets
+ * in the pixels of the model input) refines the peak to the sub-cell position.
+ *
+ * Usage :
+ *
+ * nns_ex_keypoint_s kp[14];
+ * nns_ex_pose_find_peaks (heatmap, 96, 96, 14, 0.5f, kp);
+ * nns_ex_pose_refine (kp, 14, offsets, 96, 96, 16.0f); (optional)
+ * (kp[i].x, kp[i].y : cell of the peak, kp[i].fx, kp[i].fy : refined position in the cells)
+ *
+ * Multi-person :
+ *
+ * The global peak finds a single person. nns_ex_pose_find_local_peaks() finds the local maxima
+ * of all keypoints (3x3 non-max suppression) in a single pass, 4 keypoints at once with NEON or SSE2,
+ * and nns_ex_pose_group() groups the peaks into the persons along the skeleton tree, from the root
+ * keypoint (e.g., neck) to the nearest peak of each child keypoint. The peaks and the persons are bounded,
+ * the cost is linear in the size of the heatmap.
+ *
+ * nns_ex_pose_peak_s peaks[NNS_EX_POSE_MAX_PEAKS];
+ * nns_ex_pose_instance_s persons[NNS_EX_POSE_MAX_INSTANCES];
+ * const gint parents[14] = { 1, -1, 1, 2, 3, 1, 5, 6, 1, 8, 9, 1, 11, 12 };
+ * n = nns_ex_pose_find_local_peaks (heatmap, 96, 96, 14, 0.5f, peaks, NNS_EX_POSE_MAX_PEAKS);
+ * n = nns_ex_pose_group (peaks, n, 14, parents, 24.0f, persons, NNS_EX_POSE_MAX_INSTANCES);
+ */
+
+#ifndef __NNS_EX_POSE_H__
+#define __NNS_EX_POSE_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Max number of the keypoints.
+ */
+#define NNS_EX_POSE_MAX_KEYPOINTS 32
+
+/**
+ * @brief Max number of the local peaks in a heatmap.
+ */
+#define NNS_EX_POSE_MAX_PEAKS 256
+
+/**
+ * @brief Max number of the persons in a heatmap.
+ */
+#define NNS_EX_POSE_MAX_INSTANCES 8
+
+/**
+ * @brief Data structure for a keypoint.
+ */
+typedef struct
+{
+  guint x; /**< column of the peak in the heatmap */
+  guint y; /**< row of the peak in the heatmap */
+  gfloat fx; /**< refined column (x if no offset map) */
+  gfloat fy; /**< refined row (y if no offset map) */
+  gfloat score; /**< score of the peak */
+  gboolean valid; /**< true if the score is greater than the threshold */
+} nns_ex_keypoint_s;
+
+/**
+ * @brief Data structure for a local peak of a keypoint.
+ */
+typedef struct
+{
+  guint x; /**< column of the peak in the heatmap */
+  guint y; /**< row of the peak in the heatmap */
+  guint keypoint; /**< index of the keypoint (channel) */
+  gfloat score; /**< score of the peak */
+} nns_ex_pose_peak_s;
+
+/**
+ * @brief Data structure for a person, the keypoints grouped from the peaks.
+ */
+typedef struct
+{
+  nns_ex_keypoint_s keypoints[NNS_EX_POSE_MAX_KEYPOINTS]; /**< keypoints of the person (invalid if not found) */
+  guint num_valid; /**< number of the valid keypoints */
+  gfloat score; /**< sum of the scores of the valid keypoints / number of the keypoints */
+} nns_ex_pose_instance_s;
+
+/**
+ * @brief Find the peak of each keypoint in a single pass over the heatmap.
+ * @param heatmap HWC heatmap (float32)
+ * @param width width of the heatmap
+ * @param height height of the heatmap
+ * @param num number of the keypoints (channels, 1 ~ NNS_EX_POSE_MAX_KEYPOINTS)
+ * @param threshold the keypoint is valid if the score is greater than threshold
+ * @param keypoints the peaks (the first cell if the scores are same)
+ * @return number of the valid keypoints
+ */
+extern guint
+nns_ex_pose_find_peaks (const gfloat * heatmap, guint width, guint height,
+    guint num, gfloat threshold, nns_ex_keypoint_s * keypoints);
+
+/**
+ * @brief Refine the peaks with the offset map.
+ * @param keypoints the peaks from nns_ex_pose_find_peaks()
+ * @param num number of the keypoints
+ * @param offsets HWC offset map (float32, 2 x num channels, y offsets then x offsets)
+ * @param width width of the offset map (same as the heatmap)
+ * @param height height of the offset map
+ * @param output_stride pixels of the model input per cell (e.g., 16 for PoseNet 257x257 to 17x17)
+ */
+extern void
+nns_ex_pose_refine (nns_ex_keypoint_s * keypoints, guint num,
+    const gfloat * offsets, guint width, guint height, gfloat output_stride);
+
+/**
+ * @brief Find the local peaks of all keypoints (3x3 non-max suppression) in a single pass over the heatmap.
+ * @param heatmap HWC heatmap (float32)
+ * @param width width of the heatmap
+ * @param height height of the heatmap
+ * @param num number of the keypoints (channels, 1 ~ NNS_EX_POSE_MAX_KEYPOINTS)
+ * @param threshold the peak is greater than threshold
+ * @param peaks the local peaks (not sorted)
+ * @param max_peaks size of peaks, the peaks of the highest scores are kept if there are more
+ * @return number of the peaks
+ */
+extern guint
+nns_ex_pose_find_local_peaks (const gfloat * heatmap, guint width,
+    guint height, guint num, gfloat threshold, nns_ex_pose_peak_s * peaks,
+    guint max_peaks);
+
+/**
+ * @brief Group the local peaks into the persons along the skeleton tree.
+ * @param peaks the peaks from nns_ex_pose_find_local_peaks()
+ * @param n_peaks number of the peaks (up to NNS_EX_POSE_MAX_PEAKS)
+ * @param num number of the keypoints
+ * @param parents parent keypoint of each keypoint in the skeleton (-1 for the root keypoint)
+ * @param radius max distance (in the cells) from the parent keypoint to the child keypoint
+ * @param instances the persons, in the order of the score of the root keypoint
+ * @param max_instances size of instances
+ * @return number of the persons
+ */
+extern guint
+nns_ex_pose_group (const nns_ex_pose_peak_s * peaks, guint n_peaks,
+    guint num, const gint * parents, gfloat radius,
+    nns_ex_pose_instance_s * instances, guint max_instances);
+
+G_END_DECLS
+
+#endif /* __NNS_EX_POSE_H__ */
@@ -0,0 +1,848 @@
+/**
+ * @file	nns_ex_preprocess.c
+ * @date	19 October 2026
+ * @brief	Fused preprocessing kernels for tensor filters
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define NNS_EX_HAVE_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define NNS_EX_HAVE_SSE2 1
+#endif
+
+#include "nns_ex_preprocess.h"
+
+/**
+ * @brief Set the same mean and std to all channels.
+ */
+void
+nns_ex_normalize_init (nns_ex_normalize_s * norm, guint channels,
+    gfloat mean, gfloat std)
+{
+  guint c;
+
+  g_return_if_fail (norm != NULL);
+  g_return_if_fail (channels > 0 && channels <= NNS_EX_PREPROCESS_MAX_CHANNELS);
+
+  norm->channels = channels;
+  for (c = 0; c < NNS_EX_PREPROCESS_MAX_CHANNELS; c++) {
+    norm->mean[c] = mean;
+    norm->std[c] = std;
+  }
+}
+
+/**
+ * @brief Parse the values of a key (e.g., '123:117:104').
+ */
+static gboolean
+_normalize_parse_values (gchar ** values, guint channels, gfloat * out)
+{
+  guint c, n;
+  gchar *end;
+  gdouble val;
+
+  n = g_strv_length (values);
+  if (n != 1 && n != channels)
+    return FALSE;
+
+  for (c = 0; c < channels; c++) {
+    val = g_ascii_strtod (values[(n == 1) ? 0 : c], &end);
+    if (*end != '\0')
+      return FALSE;
+
+    out[c] = (gfloat) val;
+  }
+
+  return TRUE;
+}
+
+/**
+ * @brief Parse the normalization option (e.g., 'mean:123:117:104,std:58:57:57').
+ */
+gboolean
+nns_ex_normalize_parse (nns_ex_normalize_s * norm, const gchar * option)
+{
+  gchar **options, **values;
+  guint i, c;
+  gboolean ret = TRUE;
+
+  g_return_val_if_fail (norm != NULL, FALSE);
+  g_return_val_if_fail (norm->channels > 0, FALSE);
+
+  if (option == NULL)
+    return TRUE;
+
+  options = g_strsplit (option, ",", -1);
+  for (i = 0; options[i] != NULL && ret; i++) {
+    g_strstrip (options[i]);
+    if (options[i][0] == '\0')
+      continue;
+
+    values = g_strsplit (options[i], ":", -1);
+
+    if (g_strv_length (values) < 2) {
+      ret = FALSE;
+    } else if (g_ascii_strcasecmp (values[0], "mean") == 0) {
+      ret = _normalize_parse_values (values + 1, norm->channels, norm->mean);
+    } else if (g_ascii_strcasecmp (values[0], "std") == 0) {
+      ret = _normalize_parse_values (values + 1, norm->channels, norm->std);
+    } else {
+      ret = FALSE;
+    }
+
+    g_strfreev (values);
+  }
+  g_strfreev (options);
+
+  for (c = 0; c < norm->channels && ret; c++) {
+    if (norm->std[c] == 0.0f)
+      ret = FALSE;
+  }
+
+  return ret;
+}
+
+#ifdef NNS_EX_HAVE_NEON
+/**
+ * @brief Convert 16 uint8 values to float32 and store (scale * x + bias).
+ */
+static inline void
+_neon_store_u8x16 (uint8x16_t v, float32x4_t scale, float32x4_t bias,
+    gfloat * dst)
+{
+  uint16x8_t lo = vmovl_u8 (vget_low_u8 (v));
+  uint16x8_t hi = vmovl_u8 (vget_high_u8 (v));
+
+  vst1q_f32 (dst, vmlaq_f32 (bias,
+          vcvtq_f32_u32 (vmovl_u16 (vget_low_u16 (lo))), scale));
+  vst1q_f32 (dst + 4, vmlaq_f32 (bias,
+          vcvtq_f32_u32 (vmovl_u16 (vget_high_u16 (lo))), scale));
+  vst1q_f32 (dst + 8, vmlaq_f32 (bias,
+          vcvtq_f32_u32 (vmovl_u16 (vget_low_u16 (hi))), scale));
+  vst1q_f32 (dst + 12, vmlaq_f32 (bias,
+          vcvtq_f32_u32 (vmovl_u16 (vget_high_u16 (hi))), scale));
+}
+#endif
+
+#ifdef NNS_EX_HAVE_SSE2
+/**
+ * @brief Convert 16 uint8 values to 4 float32 vectors.
+ */
+static inline void
+_sse2_u8x16_to_f32 (__m128i v, __m128 * f)
+{
+  const __m128i zero = _mm_setzero_si128 ();
+  __m128i lo = _mm_unpacklo_epi8 (v, zero);
+  __m128i hi = _mm_unpackhi_epi8 (v, zero);
+
+  f[0] = _mm_cvtepi32_ps (_mm_unpacklo_epi16 (lo, zero));
+  f[1] = _mm_cvtepi32_ps (_mm_unpackhi_epi16 (lo, zero));
+  f[2] = _mm_cvtepi32_ps (_mm_unpacklo_epi16 (hi, zero));
+  f[3] = _mm_cvtepi32_ps (_mm_unpackhi_epi16 (hi, zero));
+}
+#endif
+
+/**
+ * @brief Convert a row of 3-channel pixels.
+ */
+static void
+_row_c3 (const guint8 * __restrict src, gfloat * __restrict d0,
+    gfloat * __restrict d1, gfloat * __restrict d2, guint width,
+    const gfloat * scale, const gfloat * bias)
+{
+  const gfloat s0 = scale[0], s1 = scale[1], s2 = scale[2];
+  const gfloat b0 = bias[0], b1 = bias[1], b2 = bias[2];
+  guint x = 0;
+
+#ifdef NNS_EX_HAVE_NEON
+  {
+    const float32x4_t vs0 = vdupq_n_f32 (s0), vb0 = vdupq_n_f32 (b0);
+    const float32x4_t vs1 = vdupq_n_f32 (s1), vb1 = vdupq_n_f32 (b1);
+    const float32x4_t vs2 = vdupq_n_f32 (s2), vb2 = vdupq_n_f32 (b2);
+    uint8x16x3_t px;
+
+    for (; x + 16 <= width; x += 16) {
+      /* de-interleave 16 pixels */
+      px = vld3q_u8 (src + x * 3);
+
+      _neon_store_u8x16 (px.val[0], vs0, vb0, d0 + x);
+      _neon_store_u8x16 (px.val[1], vs1, vb1, d1 + x);
+      _neon_store_u8x16 (px.val[2], vs2, vb2, d2 + x);
+    }
+  }
+#elif defined(NNS_EX_HAVE_SSE2)
+  {
+    /* scale and bias of interleaved values, 4 pixels in 3 vectors */
+    const __m128 sa = _mm_setr_ps (s0, s1, s2, s0);
+    const __m128 sb = _mm_setr_ps (s1, s2, s0, s1);
+    const __m128 sc = _mm_setr_ps (s2, s0, s1, s2);
+    const __m128 ba = _mm_setr_ps (b0, b1, b2, b0);
+    const __m128 bb = _mm_setr_ps (b1, b2, b0, b1);
+    const __m128 bc = _mm_setr_ps (b2, b0, b1, b2);
+    __m128 f[12];
+    __m128 a, b, c, v, w;
+    guint g;
+
+    for (; x + 16 <= width; x += 16) {
+      _sse2_u8x16_to_f32 (_mm_loadu_si128 ((const __m128i *) (src + x * 3)),
+          f);
+      _sse2_u8x16_to_f32 (_mm_loadu_si128 ((const __m128i *) (src + x * 3 +
+                  16)), f + 4);
+      _sse2_u8x16_to_f32 (_mm_loadu_si128 ((const __m128i *) (src + x * 3 +
+                  32)), f + 8);
+
+      for (g = 0; g < 4; g++) {
+        /* a = r0 g0 b0 r1, b = g1 b1 r2 g2, c = b2 r3 g3 b3 */
+        a = _mm_add_ps (_mm_mul_ps (f[g * 3], sa), ba);
+        b = _mm_add_ps (_mm_mul_ps (f[g * 3 + 1], sb), bb);
+        c = _mm_add_ps (_mm_mul_ps (f[g * 3 + 2], sc), bc);
+
+        v = _mm_shuffle_ps (a, a, _MM_SHUFFLE (3, 3, 0, 0));
+        w = _mm_shuffle_ps (b, c, _MM_SHUFFLE (1, 1, 2, 2));
+        _mm_storeu_ps (d0 + x + g * 4,
+            _mm_shuffle_ps (v, w, _MM_SHUFFLE (2, 0, 2, 0)));
+
+        v = _mm_shuffle_ps (a, b, _MM_SHUFFLE (0, 0, 1, 1));
+        w = _mm_shuffle_ps (b, c, _MM_SHUFFLE (2, 2, 3, 3));
+        _mm_storeu_ps (d1 + x + g * 4,
+            _mm_shuffle_ps (v, w, _MM_SHUFFLE (2, 0, 2, 0)));
+
+        v = _mm_shuffle_ps (a, b, _MM_SHUFFLE (1, 1, 2, 2));
+        w = _mm_shuffle_ps (c, c, _MM_SHUFFLE (3, 3, 0, 0));
+        _mm_storeu_ps (d2 + x + g * 4,
+            _mm_shuffle_ps (v, w, _MM_SHUFFLE (2, 0, 2, 0)));
+      }
+    }
+  }
+#endif
+
+  /* remained pixels */
+  src += x * 3;
+  for (; x < width; x++) {
+    d0[x] = src[0] * s0 + b0;
+    d1[x] = src[1] * s1 + b1;
+    d2[x] = src[2] * s2 + b2;
+    src += 3;
+  }
+}
+
+/**
+ * @brief Convert a row of pixels, any number of channels.
+ */
+static void
+_row_generic (const guint8 * __restrict src, gfloat * __restrict dst,
+    gsize plane, guint width, guint channels, const gfloat * scale,
+    const gfloat * bias)
+{
+  guint x, c;
+
+  for (c = 0; c < channels; c++) {
+    const gfloat s = scale[c], b = bias[c];
+    gfloat *d = dst + plane * c;
+
+    for (x = 0; x < width; x++)
+      d[x] = src[x * channels + c] * s + b;
+  }
+}
+
+/**
+ * @brief Convert uint8 HWC image to float32 CHW planes and normalize each channel.
+ *
+ * The image is processed a row at a time, so the source row and the rows of all output planes
+ * stay in the cache while they are written, and no intermediate buffer is needed.
+ */
+void
+nns_ex_hwc_to_chw_normalize (const guint8 * src, gfloat * dst, guint width,
+    guint height, const nns_ex_normalize_s * norm)
+{
+  gfloat scale[NNS_EX_PREPROCESS_MAX_CHANNELS];
+  gfloat bias[NNS_EX_PREPROCESS_MAX_CHANNELS];
+  const guint8 *s;
+  gfloat *d;
+  gsize plane;
+  guint channels, c, y;
+
+  g_return_if_fail (src != NULL && dst != NULL);
+  g_return_if_fail (norm != NULL);
+  g_return_if_fail (norm->channels > 0 &&
+      norm->channels <= NNS_EX_PREPROCESS_MAX_CHANNELS);
+
+  channels = norm->channels;
+  plane = (gsize) width * height;
+
+  /* (x - mean) / std = x * scale + bias */
+  for (c = 0; c < channels; c++) {
+    scale[c] = 1.0f / norm->std[c];
+    bias[c] = -norm->mean[c] * scale[c];
+  }
+
+  for (y = 0; y < height; y++) {
+    s = src + (gsize) y * width * channels;
+    d = dst + (gsize) y * width;
+
+    if (channels == 3)
+      _row_c3 (s, d, d + plane, d + plane * 2, width, scale, bias);
+    else
+      _row_generic (s, d, plane, width, channels, scale, bias);
+  }
+}
+
+/**
+ * @brief Layout of a color component in the frame.
+ */
+typedef struct
+{
+  guint plane; /**< index of the plane */
+  guint offset; /**< bytes to the first sample in a row */
+  guint step; /**< bytes to the next sample in a row */
+  guint x_shift; /**< horizontal subsampling (log2) */
+  guint y_shift; /**< vertical subsampling (log2) */
+} _component_layout_s;
+
+/**
+ * @brief Layout of the supported pixel formats, components are R, G, B or Y, U, V.
+ */
+static const struct
+{
+  const gchar *name; /**< name of the format */
+  gboolean yuv; /**< true if the components are Y, U, V */
+  _component_layout_s comp[3]; /**< layout of the components */
+} video_formats[] = {
+  [NNS_EX_VIDEO_FORMAT_RGB] = {"RGB", FALSE,
+      {{0, 0, 3, 0, 0}, {0, 1, 3, 0, 0}, {0, 2, 3, 0, 0}}},
+  [NNS_EX_VIDEO_FORMAT_BGR] = {"BGR", FALSE,
+      {{0, 2, 3, 0, 0}, {0, 1, 3, 0, 0}, {0, 0, 3, 0, 0}}},
+  [NNS_EX_VIDEO_FORMAT_RGBX] = {"RGBx", FALSE,
+      {{0, 0, 4, 0, 0}, {0, 1, 4, 0, 0}, {0, 2, 4, 0, 0}}},
+  [NNS_EX_VIDEO_FORMAT_BGRX] = {"BGRx", FALSE,
+      {{0, 2, 4, 0, 0}, {0, 1, 4, 0, 0}, {0, 0, 4, 0, 0}}},
+  [NNS_EX_VIDEO_FORMAT_XRGB] = {"xRGB", FALSE,
+      {{0, 1, 4, 0, 0}, {0, 2, 4, 0, 0}, {0, 3, 4, 0, 0}}},
+  [NNS_EX_VIDEO_FORMAT_XBGR] = {"xBGR", FALSE,
+      {{0, 3, 4, 0, 0}, {0, 2, 4, 0, 0}, {0, 1, 4, 0, 0}}},
+  [NNS_EX_VIDEO_FORMAT_RGBA] = {"RGBA", FALSE,
+      {{0, 0, 4, 0, 0}, {0, 1, 4, 0, 0}, {0, 2, 4, 0, 0}}},
+  [NNS_EX_VIDEO_FORMAT_BGRA] = {"BGRA", FALSE,
+      {{0, 2, 4, 0, 0}, {0, 1, 4, 0, 0}, {0, 0, 4, 0, 0}}},
+  [NNS_EX_VIDEO_FORMAT_I420] = {"I420", TRUE,
+      {{0, 0, 1, 0, 0}, {1, 0, 1, 1, 1}, {2, 0, 1, 1, 1}}},
+  [NNS_EX_VIDEO_FORMAT_YV12] = {"YV12", TRUE,
+      {{0, 0, 1, 0, 0}, {2, 0, 1, 1, 1}, {1, 0, 1, 1, 1}}},
+  [NNS_EX_VIDEO_FORMAT_NV12] = {"NV12", TRUE,
+      {{0, 0, 1, 0, 0}, {1, 0, 2, 1, 1}, {1, 1, 2, 1, 1}}},
+  [NNS_EX_VIDEO_FORMAT_NV21] = {"NV21", TRUE,
+      {{0, 0, 1, 0, 0}, {1, 1, 2, 1, 1}, {1, 0, 2, 1, 1}}},
+  [NNS_EX_VIDEO_FORMAT_YUY2] = {"YUY2", TRUE,
+      {{0, 0, 2, 0, 0}, {0, 1, 4, 1, 0}, {0, 3, 4, 1, 0}}},
+  [NNS_EX_VIDEO_FORMAT_UYVY] = {"UYVY", TRUE,
+      {{0, 1, 2, 0, 0}, {0, 0, 4, 1, 0}, {0, 2, 4, 1, 0}}},
+};
+
+/**
+ * @brief Scaling table of a color component.
+ */
+typedef struct
+{
+  gint *x0; /**< bytes to the left sample in a row */
+  gint *x1; /**< bytes to the right sample in a row */
+  guint16 *wx; /**< weight of the right sample (0 ~ 256) */
+  gint *y0; /**< index of the upper row */
+  gint *y1; /**< index of the lower row */
+  guint16 *wy; /**< weight of the lower row (0 ~ 256) */
+} _component_table_s;
+
+/**
+ * @brief Data structure for the frame converter.
+ */
+struct _nns_ex_frame_converter_s
+{
+  nns_ex_video_format_e format; /**< pixel format of the input frame */
+  guint out_width; /**< width of the output tensor */
+  guint out_height; /**< height of the output tensor */
+  guint roi_x; /**< left of the image in the output (letterbox) */
+  guint roi_y; /**< top of the image in the output (letterbox) */
+  guint roi_width; /**< width of the image in the output */
+  guint roi_height; /**< height of the image in the output */
+  _component_table_s table[3]; /**< scaling table of each component */
+  gfloat *rows[3]; /**< a row of each component, scaled */
+};
+
+/**
+ * @brief Get the pixel format from the string (e.g., 'I420').
+ */
+nns_ex_video_format_e
+nns_ex_video_format_from_string (const gchar * str)
+{
+  guint i;
+
+  if (str == NULL)
+    return NNS_EX_VIDEO_FORMAT_UNKNOWN;
+
+  for (i = 0; i < G_N_ELEMENTS (video_formats); i++) {
+    if (g_str_equal (str, video_formats[i].name))
+      return (nns_ex_video_format_e) i;
+  }
+
+  return NNS_EX_VIDEO_FORMAT_UNKNOWN;
+}
+
+/**
+ * @brief Get the string of the pixel format.
+ */
+const gchar *
+nns_ex_video_format_to_string (nns_ex_video_format_e format)
+{
+  if ((guint) format >= G_N_ELEMENTS (video_formats))
+    return NULL;
+
+  return video_formats[format].name;
+}
+
+/**
+ * @brief Compute the bilinear sampling positions (pixel centers aligned).
+ * @param src_start start of the source region in the plane
+ * @param src_size size of the source region
+ * @param plane_size size of the plane, the positions are clamped in the plane
+ */
+static void
+_bilinear_table (gdouble src_start, gdouble src_size, guint plane_size,
+    guint dst_size, gint * i0, gint * i1, guint16 * w)
+{
+  gdouble scale = src_size / dst_size;
+  gdouble pos;
+  guint i;
+  gint idx;
+
+  for (i = 0; i < dst_size; i++) {
+    pos = src_start + (i + 0.5) * scale - 0.5;
+    if (pos < 0.0)
+      pos = 0.0;
+
+    idx = (gint) pos;
+    if (idx >= (gint) plane_size - 1) {
+      i0[i] = i1[i] = (gint) plane_size - 1;
+      w[i] = 0;
+    } else {
+      i0[i] = idx;
+      i1[i] = idx + 1;
+      w[i] = (guint16) ((pos - idx) * 256.0 + 0.5);
+    }
+  }
+}
+
+/**
+ * @brief Create the frame converter.
+ */
+nns_ex_frame_converter_s *
+nns_ex_frame_converter_new (nns_ex_video_format_e format, guint in_width,
+    guint in_height, guint out_width, guint out_height, gboolean letterbox)
+{
+  return nns_ex_frame_converter_new_crop (format, in_width, in_height, 0, 0,
+      in_width, in_height, out_width, out_height, letterbox);
+}
+
+/**
+ * @brief Create the frame converter for a region of the frame.
+ */
+nns_ex_frame_converter_s *
+nns_ex_frame_converter_new_crop (nns_ex_video_format_e format, guint in_width,
+    guint in_height, guint crop_x, guint crop_y, guint crop_width,
+    guint crop_height, guint out_width, guint out_height, gboolean letterbox)
+{
+  nns_ex_frame_converter_s *conv;
+  const _component_layout_s *layout;
+  _component_table_s *table;
+  guint c, x, width, height;
+  gdouble sub_x, sub_y;
+
+  g_return_val_if_fail ((guint) format < G_N_ELEMENTS (video_formats), NULL);
+  g_return_val_if_fail (in_width > 0 && in_height > 0, NULL);
+  g_return_val_if_fail (out_width > 0 && out_height > 0, NULL);
+  g_return_val_if_fail (crop_width > 0 && crop_height > 0, NULL);
+  g_return_val_if_fail (crop_x + crop_width <= in_width, NULL);
+  g_return_val_if_fail (crop_y + crop_height <= in_height, NULL);
+
+  conv = g_new0 (nns_ex_frame_converter_s, 1);
+  conv->format = format;
+  conv->out_width = out_width;
+  conv->out_height = out_height;
+  conv->roi_width = out_width;
+  conv->roi_height = out_height;
+
+  if (letterbox) {
+    /* keep the aspect ratio */
+    if ((guint64) crop_width * out_height > (guint64) crop_height * out_width) {
+      conv->roi_height = MAX (1, (guint) ((guint64) crop_height * out_width /
+              crop_width));
+    } else {
+      conv->roi_width = MAX (1, (guint) ((guint64) crop_width * out_height /
+              crop_height));
+    }
+
+    conv->roi_x = (out_width - conv->roi_width) / 2;
+    conv->roi_y = (out_height - conv->roi_height) / 2;
+  }
+
+  for (c = 0; c < 3; c++) {
+    layout = &video_formats[format].comp[c];
+    table = &conv->table[c];
+
+    /* size of the (subsampled) component plane */
+    width = (in_width + (1U << layout->x_shift) - 1) >> layout->x_shift;
+    height = (in_height + (1U << layout->y_shift) - 1) >> layout->y_shift;
+    sub_x = (gdouble) (1U << layout->x_shift);
+    sub_y = (gdouble) (1U << layout->y_shift);
+
+    table->x0 = g_new (gint, conv->roi_width);
+    table->x1 = g_new (gint, conv->roi_width);
+    table->wx = g_new (guint16, conv->roi_width);
+    table->y0 = g_new (gint, conv->roi_height);
+    table->y1 = g_new (gint, conv->roi_height);
+    table->wy = g_new (guint16, conv->roi_height);
+
+    _bilinear_table (crop_x / sub_x, crop_width / sub_x, width,
+        conv->roi_width, table->x0, table->x1, table->wx);
+    _bilinear_table (crop_y / sub_y, crop_height / sub_y, height,
+        conv->roi_height, table->y0, table->y1, table->wy);
+
+    /* sample index to byte offset */
+    for (x = 0; x < conv->roi_width; x++) {
+      table->x0[x] = table->x0[x] * layout->step + layout->offset;
+      table->x1[x] = table->x1[x] * layout->step + layout->offset;
+    }
+
+    conv->rows[c] = g_new (gfloat, conv->roi_width);
+  }
+
+  return conv;
+}
+
+/**
+ * @brief Free the frame converter.
+ */
+void
+nns_ex_frame_converter_free (nns_ex_frame_converter_s * conv)
+{
+  guint c;
+
+  g_return_if_fail (conv != NULL);
+
+  for (c = 0; c < 3; c++) {
+    g_free (conv->table[c].x0);
+    g_free (conv->table[c].x1);
+    g_free (conv->table[c].wx);
+    g_free (conv->table[c].y0);
+    g_free (conv->table[c].y1);
+    g_free (conv->table[c].wy);
+    g_free (conv->rows[c]);
+  }
+
+  g_free (conv);
+}
+
+/**
+ * @brief Scale a row of a component (bilinear, 8-bit fixed-point weights).
+ */
+static void
+_scale_row (const guint8 * __restrict r0, const guint8 * __restrict r1,
+    guint wy, const _component_table_s * table, gfloat * __restrict dst,
+    guint width)
+{
+  const gint *x0 = table->x0;
+  const gint *x1 = table->x1;
+  const guint16 *wx = table->wx;
+  const gint vy = 256 - (gint) wy;
+  gint top, bottom;
+  guint x;
+
+  /* max 255 * 256 * 256, in range of signed int (faster to convert to float) */
+  for (x = 0; x < width; x++) {
+    top = r0[x0[x]] * (256 - wx[x]) + r0[x1[x]] * wx[x];
+    bottom = r1[x0[x]] * (256 - wx[x]) + r1[x1[x]] * wx[x];
+    dst[x] = (gfloat) (top * vy + bottom * (gint) wy) * (1.0f / 65536.0f);
+  }
+}
+
+/**
+ * @brief Convert a row of Y, U, V components to R, G, B (BT.601, limited range) in place.
+ */
+static void
+_yuv_to_rgb_row (gfloat * __restrict c0, gfloat * __restrict c1,
+    gfloat * __restrict c2, guint width)
+{
+  gfloat y, u, v, r, g, b;
+  guint x;
+
+  for (x = 0; x < width; x++) {
+    y = 1.164f * (c0[x] - 16.0f);
+    u = c1[x] - 128.0f;
+    v = c2[x] - 128.0f;
+
+    r = y + 1.596f * v;
+    g = y - 0.813f * v - 0.391f * u;
+    b = y + 2.018f * u;
+
+    r = (r < 0.0f) ? 0.0f : r;
+    g = (g < 0.0f) ? 0.0f : g;
+    b = (b < 0.0f) ? 0.0f : b;
+    c0[x] = (r > 255.0f) ? 255.0f : r;
+    c1[x] = (g > 255.0f) ? 255.0f : g;
+    c2[x] = (b > 255.0f) ? 255.0f : b;
+  }
+}
+
+#ifdef NNS_EX_HAVE_NEON
+/**
+ * @brief Convert 8 float32 values (0 ~ 255) to uint8.
+ */
+static inline uint8x8_t
+_neon_f32x8_to_u8 (const gfloat * src, float32x4_t half)
+{
+  uint32x4_t lo = vcvtq_u32_f32 (vaddq_f32 (vld1q_f32 (src), half));
+  uint32x4_t hi = vcvtq_u32_f32 (vaddq_f32 (vld1q_f32 (src + 4), half));
+
+  return vmovn_u16 (vcombine_u16 (vmovn_u32 (lo), vmovn_u32 (hi)));
+}
+#endif
+
+#ifdef NNS_EX_HAVE_SSE2
+/**
+ * @brief Interleave 4 pixels of 3 components (r0 g0 b0 r1, g1 b1 r2 g2, b2 r3 g3 b3).
+ */
+static inline void
+_sse2_interleave3 (__m128 r, __m128 g, __m128 b, __m128 * out)
+{
+  __m128 rg_lo = _mm_unpacklo_ps (r, g);
+  __m128 rg_hi = _mm_unpackhi_ps (r, g);
+  __m128 t;
+
+  t = _mm_shuffle_ps (b, rg_lo, _MM_SHUFFLE (2, 2, 0, 0));
+  out[0] = _mm_shuffle_ps (rg_lo, t, _MM_SHUFFLE (2, 0, 1, 0));
+
+  t = _mm_shuffle_ps (rg_lo, b, _MM_SHUFFLE (1, 1, 3, 3));
+  out[1] = _mm_shuffle_ps (t, rg_hi, _MM_SHUFFLE (1, 0, 2, 0));
+
+  t = _mm_shuffle_ps (b, rg_hi, _MM_SHUFFLE (3, 2, 3, 2));
+  out[2] = _mm_shuffle_ps (t, t, _MM_SHUFFLE (1, 3, 2, 0));
+}
+#endif
+
+/**
+ * @brief Write a row of R, G, B to uint8 tensor.
+ */
+static void
+_store_row_uint8 (const gfloat * __restrict c0, const gfloat * __restrict c1,
+    const gfloat * __restrict c2, guint8 * __restrict dst, guint width)
+{
+  guint x = 0;
+
+#ifdef NNS_EX_HAVE_NEON
+  {
+    const float32x4_t half = vdupq_n_f32 (0.5f);
+    uint8x8x3_t px;
+
+    for (; x + 8 <= width; x += 8) {
+      px.val[0] = _neon_f32x8_to_u8 (c0 + x, half);
+      px.val[1] = _neon_f32x8_to_u8 (c1 + x, half);
+      px.val[2] = _neon_f32x8_to_u8 (c2 + x, half);
+      vst3_u8 (dst + x * 3, px);
+    }
+  }
+#elif defined(NNS_EX_HAVE_SSE2)
+  {
+    const __m128 half = _mm_set1_ps (0.5f);
+    __m128 f[3];
+    __m128i lo, hi;
+    gint32 last;
+
+    for (; x + 4 <= width; x += 4) {
+      _sse2_interleave3 (_mm_add_ps (_mm_loadu_ps (c0 + x), half),
+          _mm_add_ps (_mm_loadu_ps (c1 + x), half),
+          _mm_add_ps (_mm_loadu_ps (c2 + x), half), f);
+
+      /* 12 values to uint8 */
+      lo = _mm_packs_epi32 (_mm_cvttps_epi32 (f[0]), _mm_cvttps_epi32 (f[1]));
+      hi = _mm_packs_epi32 (_mm_cvttps_epi32 (f[2]), _mm_setzero_si128 ());
+      lo = _mm_packus_epi16 (lo, hi);
+
+      _mm_storel_epi64 ((__m128i *) (dst + x * 3), lo);
+      last = _mm_cvtsi128_si32 (_mm_srli_si128 (lo, 8));
+      memcpy (dst + x * 3 + 8, &last, 4);
+    }
+  }
+#endif
+
+  /* remained pixels */
+  dst += x * 3;
+  for (; x < width; x++) {
+    dst[0] = (guint8) (c0[x] + 0.5f);
+    dst[1] = (guint8) (c1[x] + 0.5f);
+    dst[2] = (guint8) (c2[x] + 0.5f);
+    dst += 3;
+  }
+}
+
+/**
+ * @brief Write a row of R, G, B to float32 tensor and normalize each channel.
+ */
+static void
+_store_row_float32 (const gfloat * __restrict c0,
+    const gfloat * __restrict c1, const gfloat * __restrict c2,
+    gfloat * __restrict dst, guint width, const gfloat * scale,
+    const gfloat * bias)
+{
+  const gfloat s0 = scale[0], s1 = scale[1], s2 = scale[2];
+  const gfloat b0 = bias[0], b1 = bias[1], b2 = bias[2];
+  guint x = 0;
+
+#ifdef NNS_EX_HAVE_NEON
+  {
+    const float32x4_t vs0 = vdupq_n_f32 (s0), vb0 = vdupq_n_f32 (b0);
+    const float32x4_t vs1 = vdupq_n_f32 (s1), vb1 = vdupq_n_f32 (b1);
+    const float32x4_t vs2 = vdupq_n_f32 (s2), vb2 = vdupq_n_f32 (b2);
+    float32x4x3_t px;
+
+    for (; x + 4 <= width; x += 4) {
+      px.val[0] = vmlaq_f32 (vb0, vld1q_f32 (c0 + x), vs0);
+      px.val[1] = vmlaq_f32 (vb1, vld1q_f32 (c1 + x), vs1);
+      px.val[2] = vmlaq_f32 (vb2, vld1q_f32 (c2 + x), vs2);
+      vst3q_f32 (dst + x * 3, px);
+    }
+  }
+#elif defined(NNS_EX_HAVE_SSE2)
+  {
+    const __m128 vs0 = _mm_set1_ps (s0), vb0 = _mm_set1_ps (b0);
+    const __m128 vs1 = _mm_set1_ps (s1), vb1 = _mm_set1_ps (b1);
+    const __m128 vs2 = _mm_set1_ps (s2), vb2 = _mm_set1_ps (b2);
+    __m128 f[3];
+
+    for (; x + 4 <= width; x += 4) {
+      _sse2_interleave3 (_mm_add_ps (_mm_mul_ps (_mm_loadu_ps (c0 + x), vs0),
+              vb0), _mm_add_ps (_mm_mul_ps (_mm_loadu_ps (c1 + x), vs1), vb1),
+          _mm_add_ps (_mm_mul_ps (_mm_loadu_ps (c2 + x), vs2), vb2), f);
+
+      _mm_storeu_ps (dst + x * 3, f[0]);
+      _mm_storeu_ps (dst + x * 3 + 4, f[1]);
+      _mm_storeu_ps (dst + x * 3 + 8, f[2]);
+    }
+  }
+#endif
+
+  /* remained pixels */
+  dst += x * 3;
+  for (; x < width; x++) {
+    dst[0] = c0[x] * s0 + b0;
+    dst[1] = c1[x] * s1 + b1;
+    dst[2] = c2[x] * s2 + b2;
+    dst += 3;
+  }
+}
+
+/**
+ * @brief Convert the frame a row at a time.
+ *
+ * For each output row, the two source rows of each component are blended into a small float row,
+ * then the color conversion and normalization run on these rows, which stay in the cache.
+ * The source frame is read once and no intermediate frame is allocated.
+ */
+static void
+_frame_converter_process (nns_ex_frame_converter_s * conv,
+    const guint8 * const *planes, const gint * strides, gpointer dst,
+    gboolean to_float, const gfloat * scale, const gfloat * bias)
+{
+  const _component_layout_s *layout;
+  const _component_table_s *table;
+  const guint8 *plane;
+  guint8 *d8 = (guint8 *) dst;
+  gfloat *df = (gfloat *) dst;
+  gsize row_elems, offset, i;
+  guint c, y;
+
+  row_elems = (gsize) conv->out_width * 3;
+
+  /* letterbox, pad with black */
+  if (conv->roi_width != conv->out_width ||
+      conv->roi_height != conv->out_height) {
+    if (to_float) {
+      for (i = 0; i < row_elems * conv->out_height; i += 3) {
+        df[i] = bias[0];
+        df[i + 1] = bias[1];
+        df[i + 2] = bias[2];
+      }
+    } else {
+      memset (d8, 0, row_elems * conv->out_height);
+    }
+  }
+
+  for (y = 0; y < conv->roi_height; y++) {
+    for (c = 0; c < 3; c++) {
+      layout = &video_formats[conv->format].comp[c];
+      table = &conv->table[c];
+      plane = planes[layout->plane];
+
+      _scale_row (plane + (gsize) table->y0[y] * strides[layout->plane],
+          plane + (gsize) table->y1[y] * strides[layout->plane],
+          table->wy[y], table, conv->rows[c], conv->roi_width);
+    }
+
+    if (video_formats[conv->format].yuv)
+      _yuv_to_rgb_row (conv->rows[0], conv->rows[1], conv->rows[2],
+          conv->roi_width);
+
+    offset = (gsize) (conv->roi_y + y) * row_elems + conv->roi_x * 3;
+
+    if (to_float)
+      _store_row_float32 (conv->rows[0], conv->rows[1], conv->rows[2],
+          df + offset, conv->roi_width, scale, bias);
+    else
+      _store_row_uint8 (conv->rows[0], conv->rows[1], conv->rows[2],
+          d8 + offset, conv->roi_width);
+  }
+}
+
+/**
+ * @brief Convert the frame to uint8 RGB tensor.
+ */
+void
+nns_ex_frame_converter_to_uint8 (nns_ex_frame_converter_s * conv,
+    const guint8 * const *planes, const gint * strides, guint8 * dst)
+{
+  g_return_if_fail (conv != NULL);
+  g_return_if_fail (planes != NULL && strides != NULL && dst != NULL);
+
+  _frame_converter_process (conv, planes, strides, dst, FALSE, NULL, NULL);
+}
+
+/**
+ * @brief Convert the frame to float32 RGB tensor and normalize each channel.
+ */
+void
+nns_ex_frame_converter_to_float32 (nns_ex_frame_converter_s * conv,
+    const guint8 * const *planes, const gint * strides, gfloat * dst,
+    const nns_ex_normalize_s * norm)
+{
+  gfloat scale[3] = { 1.0f, 1.0f, 1.0f };
+  gfloat bias[3] = { 0.0f, 0.0f, 0.0f };
+  guint c;
+
+  g_return_if_fail (conv != NULL);
+  g_return_if_fail (planes != NULL && strides != NULL && dst != NULL);
+  g_return_if_fail (norm == NULL || norm->channels == 3);
+
+  if (norm) {
+    /* (x - mean) / std = x * scale + bias */
+    for (c = 0; c < 3; c++) {
+      scale[c] = 1.0f / norm->std[c];
+      bias[c] = -norm->mean[c] * scale[c];
+    }
+  }
+
+  _frame_converter_process (conv, planes, strides, dst, TRUE, scale, bias);
+}
@@ -0,0 +1,168 @@
+/**
+ * @file	nns_ex_preprocess.h
+ * @date	19 October 2026
+ * @brief	Fused preprocessing kernels for tensor filters
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * The kernels do the layout change, typecast and normalization of an image in a single pass,
+ * instead of a chain of tensor_transform elements with an intermediate buffer each.
+ *
+ * The frame converter does the color conversion (YUV to RGB), bilinear scaling, letterbox and
+ * normalization of a video frame in a single pass, from the camera format to the model input tensor
+ * (uint8 or float32, dimension 3:width:height).
+ */
+
+#ifndef __NNS_EX_PREPROCESS_H__
+#define __NNS_EX_PREPROCESS_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Max number of channels for the per-channel normalization.
+ */
+#define NNS_EX_PREPROCESS_MAX_CHANNELS 4
+
+/**
+ * @brief Per-channel normalization, out = (in - mean) / std.
+ */
+typedef struct
+{
+  guint channels; /**< number of channels */
+  gfloat mean[NNS_EX_PREPROCESS_MAX_CHANNELS]; /**< mean of each channel */
+  gfloat std[NNS_EX_PREPROCESS_MAX_CHANNELS]; /**< standard deviation (divisor) of each channel */
+} nns_ex_normalize_s;
+
+/**
+ * @brief Set the same mean and std to all channels.
+ */
+extern void
+nns_ex_normalize_init (nns_ex_normalize_s * norm, guint channels,
+    gfloat mean, gfloat std);
+
+/**
+ * @brief Parse the normalization option (e.g., 'mean:123:117:104,std:58:57:57').
+ * @note A single value is applied to all channels. The keys not given are unchanged.
+ * @return TRUE if the option is valid
+ */
+extern gboolean
+nns_ex_normalize_parse (nns_ex_normalize_s * norm, const gchar * option);
+
+/**
+ * @brief Convert uint8 HWC image to float32 CHW planes and normalize each channel.
+ * @param src uint8 image, interleaved channels (innermost), width, height
+ * @param dst float32 planes, width (innermost), height, channels
+ * @param width image width
+ * @param height image height
+ * @param norm per-channel normalization (norm->channels is the number of channels)
+ */
+extern void
+nns_ex_hwc_to_chw_normalize (const guint8 * src, gfloat * dst, guint width,
+    guint height, const nns_ex_normalize_s * norm);
+
+/**
+ * @brief Pixel formats of the frame converter (same names as GstVideoFormat).
+ */
+typedef enum
+{
+  NNS_EX_VIDEO_FORMAT_RGB = 0,
+  NNS_EX_VIDEO_FORMAT_BGR,
+  NNS_EX_VIDEO_FORMAT_RGBX,
+  NNS_EX_VIDEO_FORMAT_BGRX,
+  NNS_EX_VIDEO_FORMAT_XRGB,
+  NNS_EX_VIDEO_FORMAT_XBGR,
+  NNS_EX_VIDEO_FORMAT_RGBA,
+  NNS_EX_VIDEO_FORMAT_BGRA,
+  NNS_EX_VIDEO_FORMAT_I420,
+  NNS_EX_VIDEO_FORMAT_YV12,
+  NNS_EX_VIDEO_FORMAT_NV12,
+  NNS_EX_VIDEO_FORMAT_NV21,
+  NNS_EX_VIDEO_FORMAT_YUY2,
+  NNS_EX_VIDEO_FORMAT_UYVY,
+  NNS_EX_VIDEO_FORMAT_UNKNOWN
+} nns_ex_video_format_e;
+
+/**
+ * @brief Max number of planes of a video frame.
+ */
+#define NNS_EX_VIDEO_MAX_PLANES 3
+
+/**
+ * @brief Opaque data structure for the frame converter.
+ */
+typedef struct _nns_ex_frame_converter_s nns_ex_frame_converter_s;
+
+/**
+ * @brief Get the pixel format from the string (e.g., 'I420').
+ * @return NNS_EX_VIDEO_FORMAT_UNKNOWN if the format is not supported
+ */
+extern nns_ex_video_format_e
+nns_ex_video_format_from_string (const gchar * str);
+
+/**
+ * @brief Get the string of the pixel format.
+ */
+extern const gchar *
+nns_ex_video_format_to_string (nns_ex_video_format_e format);
+
+/**
+ * @brief Create the frame converter. The scaling tables are computed once here.
+ * @param format pixel format of the input frame
+ * @param in_width width of the input frame
+ * @param in_height height of the input frame
+ * @param out_width width of the output tensor
+ * @param out_height height of the output tensor
+ * @param letterbox TRUE to keep the aspect ratio and pad the borders with black
+ * @return newly allocated converter, NULL if the parameters are invalid
+ */
+extern nns_ex_frame_converter_s *
+nns_ex_frame_converter_new (nns_ex_video_format_e format, guint in_width,
+    guint in_height, guint out_width, guint out_height, gboolean letterbox);
+
+/**
+ * @brief Create the frame converter for a region of the frame (e.g., ROI of the detector).
+ * @param crop_x left of the region in the input frame
+ * @param crop_y top of the region in the input frame
+ * @param crop_width width of the region
+ * @param crop_height height of the region
+ * @return newly allocated converter, NULL if the parameters are invalid
+ * @note Other parameters are same as nns_ex_frame_converter_new().
+ */
+extern nns_ex_frame_converter_s *
+nns_ex_frame_converter_new_crop (nns_ex_video_format_e format, guint in_width,
+    guint in_height, guint crop_x, guint crop_y, guint crop_width,
+    guint crop_height, guint out_width, guint out_height, gboolean letterbox);
+
+/**
+ * @brief Free the frame converter.
+ */
+extern void
+nns_ex_frame_converter_free (nns_ex_frame_converter_s * conv);
+
+/**
+ * @brief Convert the frame to uint8 RGB tensor (dimension 3:out_width:out_height).
+ * @param planes data of each plane of the input frame
+ * @param strides bytes per row of each plane
+ * @param dst output tensor
+ */
+extern void
+nns_ex_frame_converter_to_uint8 (nns_ex_frame_converter_s * conv,
+    const guint8 * const *planes, const gint * strides, guint8 * dst);
+
+/**
+ * @brief Convert the frame to float32 RGB tensor (dimension 3:out_width:out_height) and normalize each channel.
+ * @param planes data of each plane of the input frame
+ * @param strides bytes per row of each plane
+ * @param dst output tensor
+ * @param norm per-channel normalization (3 channels), NULL to typecast only
+ */
+extern void
+nns_ex_frame_converter_to_float32 (nns_ex_frame_converter_s * conv,
+    const guint8 * const *planes, const gint * strides, gfloat * dst,
+    const nns_ex_normalize_s * norm);
+
+G_END_DECLS
+
+#endif /* __NNS_EX_PREPROCESS_H__ */
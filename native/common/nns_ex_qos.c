@@ -0,0 +1,315 @@
+/**
+ * @file	nns_ex_qos.c
+ * @date	19 October 2026
+ * @brief	Adaptive QoS controller to keep the latency of the pipeline under the load
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ */
+
+#include <string.h>
+
+#include "nns_ex_qos.h"
+
+GST_DEBUG_CATEGORY_STATIC (nns_ex_qos_debug);
+#define GST_CAT_DEFAULT nns_ex_qos_debug
+
+/**
+ * @brief Count of the QoS messages in a window to step down, even if the lateness is under the target.
+ */
+#define QOS_DROP_THRESHOLD 3
+
+/**
+ * @brief Data structure for the controller.
+ */
+struct _nns_ex_qos_s
+{
+  GstClockTime target_latency; /**< max lateness of the sinks */
+  nns_ex_qos_level_s *levels; /**< levels (0 for the original quality) */
+  guint num_levels; /**< number of the levels including the level 0 */
+  guint level; /**< current level */
+  volatile gint stride; /**< stride of the current level */
+
+  GstElement *capsfilter; /**< capsfilter to renegotiate */
+  GstCaps *base_caps; /**< original caps of the capsfilter */
+  GstPad *pad; /**< pad to drop the frames by the stride */
+  gulong probe; /**< probe to drop the frames */
+  guint frames_waited; /**< count of the frames since the last frame passed */
+  guint timer_id; /**< timer to evaluate the window */
+
+  guint window_messages; /**< count of the QoS messages in the window */
+  GstClockTimeDiff window_jitter; /**< max lateness in the window */
+  guint late_windows; /**< count of the late windows in a row */
+  guint good_windows; /**< count of the windows with the headroom in a row */
+  gboolean settling; /**< true if the level is changed in the last window */
+
+  nns_ex_qos_stats_s stats; /**< metrics of the controller */
+};
+
+/**
+ * @brief Check the caps of the levels are same.
+ */
+static gboolean
+_qos_same_caps (const nns_ex_qos_level_s * a, const nns_ex_qos_level_s * b)
+{
+  return (a->width == b->width && a->height == b->height &&
+      a->fps_n == b->fps_n && a->fps_d == b->fps_d);
+}
+
+/**
+ * @brief Set the caps of the level to the capsfilter.
+ */
+static void
+_qos_apply_caps (nns_ex_qos_s * qos, const nns_ex_qos_level_s * level)
+{
+  GstCaps *caps;
+
+  caps = gst_caps_copy (qos->base_caps);
+
+  if (level->width > 0 && level->height > 0) {
+    gst_caps_set_simple (caps, "width", G_TYPE_INT, level->width,
+        "height", G_TYPE_INT, level->height, NULL);
+  }
+
+  if (level->fps_n > 0) {
+    gst_caps_set_simple (caps, "framerate", GST_TYPE_FRACTION, level->fps_n,
+        level->fps_d, NULL);
+  }
+
+  /* capsfilter sends the reconfigure event upstream */
+  g_object_set (qos->capsfilter, "caps", caps, NULL);
+  gst_caps_unref (caps);
+}
+
+/**
+ * @brief Change the level.
+ */
+static void
+_qos_set_level (nns_ex_qos_s * qos, guint level)
+{
+  const nns_ex_qos_level_s *prev, *next;
+
+  prev = &qos->levels[qos->level];
+  next = &qos->levels[level];
+
+  qos->level = level;
+  g_atomic_int_set (&qos->stride, (gint) next->stride);
+
+  if (qos->capsfilter && !_qos_same_caps (prev, next))
+    _qos_apply_caps (qos, next);
+
+  GST_INFO ("qos level %u : stride %u, resolution %dx%d, framerate %d/%d",
+      level, next->stride, next->width, next->height, next->fps_n,
+      next->fps_d);
+
+  qos->stats.level = level;
+  qos->stats.max_level = MAX (qos->stats.max_level, level);
+
+  /* the pipeline drops some frames while renegotiating */
+  qos->settling = TRUE;
+  qos->late_windows = qos->good_windows = 0;
+}
+
+/**
+ * @brief Timer to evaluate the QoS messages in the window.
+ */
+static gboolean
+_qos_window_cb (gpointer user_data)
+{
+  nns_ex_qos_s *qos = (nns_ex_qos_s *) user_data;
+  gboolean late, headroom;
+
+  late = (qos->window_messages >= QOS_DROP_THRESHOLD ||
+      (qos->window_messages > 0 &&
+          qos->window_jitter > (GstClockTimeDiff) qos->target_latency));
+  headroom = (qos->window_messages == 0 ||
+      qos->window_jitter < (GstClockTimeDiff) qos->target_latency / 2);
+
+  qos->window_messages = 0;
+  qos->window_jitter = 0;
+
+  if (qos->settling) {
+    qos->settling = FALSE;
+    return G_SOURCE_CONTINUE;
+  }
+
+  if (late) {
+    qos->good_windows = 0;
+
+    if (++qos->late_windows >= NNS_EX_QOS_DEGRADE_WINDOWS &&
+        qos->level + 1 < qos->num_levels) {
+      qos->stats.degraded++;
+      _qos_set_level (qos, qos->level + 1);
+    }
+  } else if (headroom) {
+    qos->late_windows = 0;
+
+    if (++qos->good_windows >= NNS_EX_QOS_RECOVER_WINDOWS && qos->level > 0) {
+      qos->stats.recovered++;
+      _qos_set_level (qos, qos->level - 1);
+    }
+  } else {
+    qos->late_windows = qos->good_windows = 0;
+  }
+
+  return G_SOURCE_CONTINUE;
+}
+
+/**
+ * @brief Pad probe to drop the frames by the stride.
+ */
+static GstPadProbeReturn
+_qos_probe_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  nns_ex_qos_s *qos = (nns_ex_qos_s *) user_data;
+  guint stride = (guint) g_atomic_int_get (&qos->stride);
+
+  qos->stats.frames++;
+
+  if (++qos->frames_waited < stride) {
+    qos->stats.skipped++;
+    return GST_PAD_PROBE_DROP;
+  }
+
+  qos->frames_waited = 0;
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Create the controller.
+ */
+nns_ex_qos_s *
+nns_ex_qos_new (GstClockTime target_latency, const nns_ex_qos_level_s * levels,
+    guint num_levels)
+{
+  nns_ex_qos_s *qos;
+  guint i;
+
+  g_return_val_if_fail (GST_CLOCK_TIME_IS_VALID (target_latency), NULL);
+  g_return_val_if_fail (levels != NULL || num_levels == 0, NULL);
+
+  for (i = 0; i < num_levels; i++) {
+    g_return_val_if_fail (levels[i].stride > 0, NULL);
+    g_return_val_if_fail (levels[i].fps_n == 0 || levels[i].fps_d > 0, NULL);
+  }
+
+  /* the category is created once, and returned for the next controllers */
+  GST_DEBUG_CATEGORY_INIT (nns_ex_qos_debug, "nns_ex_qos", 0,
+      "Adaptive QoS controller");
+
+  qos = g_new0 (nns_ex_qos_s, 1);
+  qos->target_latency = target_latency;
+  qos->num_levels = num_levels + 1;
+  qos->levels = g_new0 (nns_ex_qos_level_s, qos->num_levels);
+  qos->levels[0].stride = 1;
+  if (num_levels > 0)
+    memcpy (qos->levels + 1, levels, sizeof (nns_ex_qos_level_s) * num_levels);
+  qos->stride = 1;
+
+  return qos;
+}
+
+/**
+ * @brief Free the controller, remove the probe and the timer.
+ */
+void
+nns_ex_qos_free (nns_ex_qos_s * qos)
+{
+  g_return_if_fail (qos != NULL);
+
+  if (qos->timer_id > 0)
+    g_source_remove (qos->timer_id);
+
+  if (qos->pad) {
+    gst_pad_remove_probe (qos->pad, qos->probe);
+    gst_object_unref (qos->pad);
+  }
+
+  if (qos->capsfilter)
+    gst_object_unref (qos->capsfilter);
+
+  if (qos->base_caps)
+    gst_caps_unref (qos->base_caps);
+
+  g_free (qos->levels);
+  g_free (qos);
+}
+
+/**
+ * @brief Attach the controller to the pipeline.
+ */
+gboolean
+nns_ex_qos_attach (nns_ex_qos_s * qos, GstElement * capsfilter,
+    GstElement * element)
+{
+  g_return_val_if_fail (qos != NULL, FALSE);
+  g_return_val_if_fail (qos->timer_id == 0, FALSE);
+
+  if (capsfilter) {
+    g_object_get (capsfilter, "caps", &qos->base_caps, NULL);
+
+    /* any caps if the capsfilter is not set */
+    if (qos->base_caps == NULL || gst_caps_is_any (qos->base_caps)) {
+      if (qos->base_caps)
+        gst_caps_unref (qos->base_caps);
+      qos->base_caps = gst_caps_new_empty_simple ("video/x-raw");
+    }
+
+    qos->capsfilter = gst_object_ref (capsfilter);
+  }
+
+  if (element) {
+    qos->pad = gst_element_get_static_pad (element, "sink");
+    g_return_val_if_fail (qos->pad != NULL, FALSE);
+
+    qos->probe = gst_pad_add_probe (qos->pad, GST_PAD_PROBE_TYPE_BUFFER,
+        _qos_probe_cb, qos, NULL);
+  }
+
+  qos->timer_id = g_timeout_add (NNS_EX_QOS_WINDOW, _qos_window_cb, qos);
+  return TRUE;
+}
+
+/**
+ * @brief Handle the QoS message.
+ */
+void
+nns_ex_qos_handle_message (nns_ex_qos_s * qos, GstMessage * message)
+{
+  gint64 jitter;
+  gdouble proportion;
+  gint quality;
+
+  g_return_if_fail (qos != NULL);
+  g_return_if_fail (GST_MESSAGE_TYPE (message) == GST_MESSAGE_QOS);
+
+  gst_message_parse_qos_values (message, &jitter, &proportion, &quality);
+
+  qos->window_messages++;
+  qos->window_jitter = MAX (qos->window_jitter, jitter);
+
+  qos->stats.messages++;
+  qos->stats.max_jitter = MAX (qos->stats.max_jitter, jitter);
+}
+
+/**
+ * @brief Get the stride of the inference at the current level.
+ */
+guint
+nns_ex_qos_get_stride (nns_ex_qos_s * qos)
+{
+  g_return_val_if_fail (qos != NULL, 1);
+
+  return (guint) g_atomic_int_get (&qos->stride);
+}
+
+/**
+ * @brief Get the metrics of the controller.
+ */
+void
+nns_ex_qos_get_stats (nns_ex_qos_s * qos, nns_ex_qos_stats_s * stats)
+{
+  g_return_if_fail (qos != NULL);
+  g_return_if_fail (stats != NULL);
+
+  *stats = qos->stats;
+}
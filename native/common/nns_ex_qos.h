@@ -0,0 +1,137 @@
+/**
+ * @file	nns_ex_qos.h
+ * @date	19 October 2026
+ * @brief	Adaptive QoS controller to keep the latency of the pipeline under the load
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * The sinks post the QoS messages when the buffers are late or dropped. The controller counts
+ * the messages and the max lateness (jitter) in a window of NNS_EX_QOS_WINDOW milliseconds.
+ * If the lateness exceeds the target or the frames are dropped for NNS_EX_QOS_DEGRADE_WINDOWS
+ * windows in a row, the controller steps down to the next level, which lowers the inference
+ * frequency (stride), the camera resolution or the framerate. It steps up again after
+ * NNS_EX_QOS_RECOVER_WINDOWS windows with the headroom (lateness under the half of the target).
+ *
+ * The resolution and framerate are applied to a capsfilter, renegotiating the caps with
+ * the upstream elements (v4l2src, videoscale or videorate).
+ *
+ * Usage :
+ *
+ * static const nns_ex_qos_level_s levels[] = {
+ *   {2, 0, 0, 0, 0}, (inference every 2nd frame)
+ *   {3, 0, 0, 15, 1}, (inference every 3rd frame, 15 fps)
+ * };
+ *
+ * qos = nns_ex_qos_new (100 * GST_MSECOND, levels, G_N_ELEMENTS (levels));
+ * nns_ex_qos_attach (qos, capsfilter, tensor_converter);
+ *
+ * (the bus message callback)
+ * case GST_MESSAGE_QOS:
+ *   nns_ex_qos_handle_message (qos, message);
+ */
+
+#ifndef __NNS_EX_QOS_H__
+#define __NNS_EX_QOS_H__
+
+#include <glib.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Duration (in milliseconds) of the window to evaluate the QoS messages.
+ */
+#define NNS_EX_QOS_WINDOW 1000
+
+/**
+ * @brief Count of the late windows in a row to step down.
+ */
+#define NNS_EX_QOS_DEGRADE_WINDOWS 2
+
+/**
+ * @brief Count of the windows with the headroom in a row to step up.
+ */
+#define NNS_EX_QOS_RECOVER_WINDOWS 5
+
+/**
+ * @brief Data structure for a level of the controller.
+ */
+typedef struct
+{
+  guint stride; /**< run the inference every stride-th frame */
+  gint width; /**< width of the video, 0 to keep the original caps */
+  gint height; /**< height of the video, 0 to keep the original caps */
+  gint fps_n; /**< numerator of the framerate, 0 to keep the original caps */
+  gint fps_d; /**< denominator of the framerate */
+} nns_ex_qos_level_s;
+
+/**
+ * @brief Metrics of the controller.
+ */
+typedef struct
+{
+  guint level; /**< current level, 0 for the original quality */
+  guint max_level; /**< the lowest level reached */
+  guint degraded; /**< count of the steps down */
+  guint recovered; /**< count of the steps up */
+  guint messages; /**< count of the QoS messages */
+  GstClockTimeDiff max_jitter; /**< max lateness reported */
+  guint frames; /**< count of the frames to the inference */
+  guint skipped; /**< count of the frames dropped by the stride */
+} nns_ex_qos_stats_s;
+
+/**
+ * @brief Opaque data structure for the controller.
+ */
+typedef struct _nns_ex_qos_s nns_ex_qos_s;
+
+/**
+ * @brief Create the controller.
+ * @param target_latency max lateness (in nanoseconds) of the sinks
+ * @param levels the levels to step down, the quality is lowered in order (the level 0 is the original pipeline)
+ * @param num_levels number of the levels
+ * @return newly allocated controller, NULL if the parameters are invalid
+ */
+extern nns_ex_qos_s *
+nns_ex_qos_new (GstClockTime target_latency, const nns_ex_qos_level_s * levels,
+    guint num_levels);
+
+/**
+ * @brief Free the controller, remove the probe and the timer.
+ * @note Call this after the pipeline is stopped.
+ */
+extern void
+nns_ex_qos_free (nns_ex_qos_s * qos);
+
+/**
+ * @brief Attach the controller to the pipeline, and start the timer in the default main context.
+ * @param capsfilter capsfilter to renegotiate the resolution and framerate, NULL to change the stride only
+ * @param element the first element of the inference to drop the frames by the stride,
+ * NULL if the app drops the frames with nns_ex_qos_get_stride()
+ */
+extern gboolean
+nns_ex_qos_attach (nns_ex_qos_s * qos, GstElement * capsfilter,
+    GstElement * element);
+
+/**
+ * @brief Handle the QoS message. Call this in the bus message callback (main thread).
+ */
+extern void
+nns_ex_qos_handle_message (nns_ex_qos_s * qos, GstMessage * message);
+
+/**
+ * @brief Get the stride of the inference at the current level.
+ * @note This is thread-safe, the app can call this in the streaming thread.
+ */
+extern guint
+nns_ex_qos_get_stride (nns_ex_qos_s * qos);
+
+/**
+ * @brief Get the metrics of the controller.
+ */
+extern void
+nns_ex_qos_get_stats (nns_ex_qos_s * qos, nns_ex_qos_stats_s * stats);
+
+G_END_DECLS
+
+#endif /* __NNS_EX_QOS_H__ */
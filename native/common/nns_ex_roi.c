@@ -0,0 +1,303 @@
+/**
+ * @file	nns_ex_roi.c
+ * @date	19 October 2026
+ * @brief	Region-of-interest scheduler to run the detector on the active region of the frame
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ */
+
+#include <string.h>
+
+#include "nns_ex_roi.h"
+
+/**
+ * @brief Number of the regions recorded (the frames in the pipeline between the crop and the result).
+ */
+#define ROI_HISTORY 16
+
+/**
+ * @brief Data structure for a region recorded.
+ */
+typedef struct
+{
+  guint64 timestamp; /**< timestamp of the frame */
+  nns_ex_roi_s roi; /**< region of the frame */
+  gboolean valid; /**< true if recorded */
+} _roi_entry_s;
+
+/**
+ * @brief Data structure for the scheduler.
+ */
+struct _nns_ex_roi_scheduler_s
+{
+  GMutex lock; /**< lock for the history */
+  gfloat min_size; /**< min size of the region */
+  gfloat margin; /**< margin around the objects */
+  guint full_interval; /**< interval of the full frame scan */
+  guint count; /**< count of the detections since the last full frame scan */
+  _roi_entry_s history[ROI_HISTORY]; /**< regions of the recent frames */
+  guint head; /**< index of the next entry */
+  guint cropped; /**< count of the detections with the region */
+  guint full; /**< count of the detections with the full frame */
+};
+
+/**
+ * @brief Set the full frame.
+ */
+static void
+_roi_set_full (nns_ex_roi_s * roi)
+{
+  roi->x = roi->y = 0.0f;
+  roi->width = roi->height = 1.0f;
+}
+
+/**
+ * @brief Get the region of the side, centered at c and moved into the frame.
+ */
+static gfloat
+_roi_place (gfloat c, gfloat side)
+{
+  return CLAMP (c - side / 2.0f, 0.0f, 1.0f - side);
+}
+
+/**
+ * @brief Select the region around the boxes.
+ * @return FALSE if the region is too large
+ */
+static gboolean
+_roi_select (nns_ex_roi_scheduler_s * sched, const nns_ex_box_s * boxes,
+    guint num_boxes, nns_ex_roi_s * roi)
+{
+  gfloat x0, y0, x1, y1, side, mx, my;
+  guint i;
+
+  x0 = y0 = 1.0f;
+  x1 = y1 = 0.0f;
+
+  for (i = 0; i < num_boxes; i++) {
+    /* margin for the motion and the context of the objects */
+    mx = boxes[i].width * sched->margin;
+    my = boxes[i].height * sched->margin;
+
+    x0 = MIN (x0, boxes[i].x - mx);
+    y0 = MIN (y0, boxes[i].y - my);
+    x1 = MAX (x1, boxes[i].x + boxes[i].width + mx);
+    y1 = MAX (y1, boxes[i].y + boxes[i].height + my);
+  }
+
+  x0 = MAX (x0, 0.0f);
+  y0 = MAX (y0, 0.0f);
+  x1 = MIN (x1, 1.0f);
+  y1 = MIN (y1, 1.0f);
+
+  if (x1 <= x0 || y1 <= y0)
+    return FALSE;
+
+  /* same ratio to the width and height, the aspect ratio of the frame */
+  side = MAX (MAX (x1 - x0, y1 - y0), sched->min_size);
+  if (side >= NNS_EX_ROI_MAX_SIZE)
+    return FALSE;
+
+  roi->x = _roi_place ((x0 + x1) / 2.0f, side);
+  roi->y = _roi_place ((y0 + y1) / 2.0f, side);
+  roi->width = roi->height = side;
+  return TRUE;
+}
+
+/**
+ * @brief Create the scheduler.
+ */
+nns_ex_roi_scheduler_s *
+nns_ex_roi_scheduler_new (gfloat min_size, gfloat margin, guint full_interval)
+{
+  nns_ex_roi_scheduler_s *sched;
+
+  g_return_val_if_fail (min_size > 0.0f && min_size <= 1.0f, NULL);
+  g_return_val_if_fail (margin >= 0.0f, NULL);
+
+  sched = g_new0 (nns_ex_roi_scheduler_s, 1);
+  g_mutex_init (&sched->lock);
+  sched->min_size = min_size;
+  sched->margin = margin;
+  sched->full_interval = full_interval;
+
+  return sched;
+}
+
+/**
+ * @brief Free the scheduler.
+ */
+void
+nns_ex_roi_scheduler_free (nns_ex_roi_scheduler_s * sched)
+{
+  g_return_if_fail (sched != NULL);
+
+  g_mutex_clear (&sched->lock);
+  g_free (sched);
+}
+
+/**
+ * @brief Select the region of the next detection.
+ */
+gboolean
+nns_ex_roi_scheduler_next (nns_ex_roi_scheduler_s * sched,
+    const nns_ex_box_s * boxes, guint num_boxes, guint64 timestamp,
+    nns_ex_roi_s * roi)
+{
+  gboolean cropped = FALSE;
+
+  g_return_val_if_fail (sched != NULL, FALSE);
+  g_return_val_if_fail (roi != NULL, FALSE);
+
+  g_mutex_lock (&sched->lock);
+
+  if (num_boxes > 0 && sched->full_interval > 0 &&
+      sched->count < sched->full_interval) {
+    cropped = _roi_select (sched, boxes, num_boxes, roi);
+  }
+
+  if (cropped) {
+    sched->count++;
+    sched->cropped++;
+  } else {
+    _roi_set_full (roi);
+    sched->count = 0;
+    sched->full++;
+  }
+
+  sched->history[sched->head].timestamp = timestamp;
+  sched->history[sched->head].roi = *roi;
+  sched->history[sched->head].valid = TRUE;
+  sched->head = (sched->head + 1) % ROI_HISTORY;
+
+  g_mutex_unlock (&sched->lock);
+  return cropped;
+}
+
+/**
+ * @brief Get the region selected for the frame.
+ */
+gboolean
+nns_ex_roi_scheduler_lookup (nns_ex_roi_scheduler_s * sched,
+    guint64 timestamp, nns_ex_roi_s * roi)
+{
+  gboolean found = FALSE;
+  guint i;
+
+  g_return_val_if_fail (sched != NULL, FALSE);
+  g_return_val_if_fail (roi != NULL, FALSE);
+
+  _roi_set_full (roi);
+
+  g_mutex_lock (&sched->lock);
+  for (i = 0; i < ROI_HISTORY; i++) {
+    if (sched->history[i].valid && sched->history[i].timestamp == timestamp) {
+      *roi = sched->history[i].roi;
+      found = TRUE;
+      break;
+    }
+  }
+  g_mutex_unlock (&sched->lock);
+
+  return found;
+}
+
+/**
+ * @brief Get the count of the detections with the region and the full frame.
+ */
+void
+nns_ex_roi_scheduler_get_stats (nns_ex_roi_scheduler_s * sched,
+    guint * cropped, guint * full)
+{
+  g_return_if_fail (sched != NULL);
+
+  g_mutex_lock (&sched->lock);
+  if (cropped)
+    *cropped = sched->cropped;
+  if (full)
+    *full = sched->full;
+  g_mutex_unlock (&sched->lock);
+}
+
+/**
+ * @brief Fill the rows of the plane, with a single memset if the rows are contiguous.
+ */
+static void
+_roi_fill_rows (guint8 * dst, gint stride, gsize row_size, guint first,
+    guint last, guint8 fill)
+{
+  guint y;
+
+  if (first >= last)
+    return;
+
+  dst += (gsize) first * stride;
+  if ((gsize) stride == row_size) {
+    memset (dst, fill, row_size * (last - first));
+    return;
+  }
+
+  for (y = first; y < last; y++, dst += stride)
+    memset (dst, fill, row_size);
+}
+
+/**
+ * @brief Fill the pixels out of the region of the image plane, and copy the pixels in the region.
+ */
+void
+nns_ex_roi_mask_plane (const guint8 * src, gint src_stride, guint8 * dst,
+    gint dst_stride, guint width, guint height, guint pixel_stride,
+    const nns_ex_roi_rect_s * rect, guint8 fill)
+{
+  guint left, top, right, bottom, y;
+  gsize row_size, left_size, span_size, right_size;
+  const guint8 *s;
+  guint8 *d;
+
+  g_return_if_fail (dst != NULL);
+  g_return_if_fail (pixel_stride > 0);
+
+  row_size = (gsize) width * pixel_stride;
+  g_return_if_fail (dst_stride > 0 && (gsize) dst_stride >= row_size);
+  g_return_if_fail (src == NULL || (src_stride > 0
+          && (gsize) src_stride >= row_size));
+
+  /* clip the region to the plane */
+  left = top = right = bottom = 0;
+  if (rect && rect->x < width && rect->y < height) {
+    left = rect->x;
+    top = rect->y;
+    right = (rect->width < width - left) ? left + rect->width : width;
+    bottom = (rect->height < height - top) ? top + rect->height : height;
+  }
+
+  if (left == right || top == bottom) {
+    _roi_fill_rows (dst, dst_stride, row_size, 0, height, fill);
+    return;
+  }
+
+  if (src == dst)
+    src = NULL;
+
+  left_size = (gsize) left * pixel_stride;
+  span_size = (gsize) (right - left) * pixel_stride;
+  right_size = row_size - left_size - span_size;
+
+  _roi_fill_rows (dst, dst_stride, row_size, 0, top, fill);
+
+  d = dst + (gsize) top * dst_stride;
+  s = src ? src + (gsize) top * src_stride : NULL;
+  for (y = top; y < bottom; y++) {
+    if (left_size > 0)
+      memset (d, fill, left_size);
+    if (s) {
+      memcpy (d + left_size, s + left_size, span_size);
+      s += src_stride;
+    }
+    if (right_size > 0)
+      memset (d + left_size + span_size, fill, right_size);
+    d += dst_stride;
+  }
+
+  _roi_fill_rows (dst, dst_stride, row_size, bottom, height, fill);
+}
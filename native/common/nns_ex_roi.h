@@ -0,0 +1,141 @@
+/**
+ * @file	nns_ex_roi.h
+ * @date	19 October 2026
+ * @brief	Region-of-interest scheduler to run the detector on the active region of the frame
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * With the boxes of the previous detections (e.g., the tracks predicted at the next frame),
+ * the scheduler selects the region around the objects, and the detector runs on the region
+ * cropped from the full-resolution frame (nns_ex_tensorize 'crop' property) instead of the
+ * whole frame downscaled. The small objects get more pixels in the model input.
+ *
+ * The region has the same aspect ratio as the frame, so the objects are scaled in the same way
+ * as the full frame. The full frame is scanned periodically (and when there is no object)
+ * to find the new objects out of the region.
+ *
+ * The region is recorded with the timestamp of the frame, and the app maps the result of the
+ * detector back to the frame with nns_ex_roi_scheduler_lookup().
+ *
+ * Usage :
+ *
+ * (the sink pad of the detector, before the frame is converted)
+ * nns_ex_roi_scheduler_next (sched, boxes, n, GST_BUFFER_PTS (buffer), &roi);
+ * g_object_set (tensorize, "crop", roi_string, NULL);
+ *
+ * (the result of the detector)
+ * nns_ex_roi_scheduler_lookup (sched, GST_BUFFER_PTS (buffer), &roi);
+ * x = (roi.x + box.x * roi.width) * VIDEO_WIDTH;
+ *
+ * nns_ex_roi_mask_plane() fills the pixels out of a region (in pixels) of an image plane,
+ * with memset of the whole rows above and below the region and of the spans left and right of it
+ * in each row, with the stride of the plane (e.g., the element 'nns_ex_roi_mask').
+ */
+
+#ifndef __NNS_EX_ROI_H__
+#define __NNS_EX_ROI_H__
+
+#include <glib.h>
+
+#include "nns_ex_tracker.h"
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Max size (ratio to the frame) of the region, the larger region is replaced with the full frame.
+ */
+#define NNS_EX_ROI_MAX_SIZE 0.8f
+
+/**
+ * @brief Data structure for a region, in ratio (0 ~ 1) to the frame size.
+ */
+typedef struct
+{
+  gfloat x; /**< left */
+  gfloat y; /**< top */
+  gfloat width; /**< width */
+  gfloat height; /**< height */
+} nns_ex_roi_s;
+
+/**
+ * @brief Data structure for a region, in pixels.
+ */
+typedef struct
+{
+  guint x; /**< left */
+  guint y; /**< top */
+  guint width; /**< width */
+  guint height; /**< height */
+} nns_ex_roi_rect_s;
+
+/**
+ * @brief Opaque data structure for the scheduler.
+ */
+typedef struct _nns_ex_roi_scheduler_s nns_ex_roi_scheduler_s;
+
+/**
+ * @brief Create the scheduler.
+ * @param min_size min size (ratio to the frame) of the region
+ * @param margin margin (ratio to the size of the objects) around the objects
+ * @param full_interval scan the full frame every full_interval-th detection, 0 to scan the full frame always
+ * @return newly allocated scheduler
+ */
+extern nns_ex_roi_scheduler_s *
+nns_ex_roi_scheduler_new (gfloat min_size, gfloat margin, guint full_interval);
+
+/**
+ * @brief Free the scheduler.
+ */
+extern void
+nns_ex_roi_scheduler_free (nns_ex_roi_scheduler_s * sched);
+
+/**
+ * @brief Select the region of the next detection.
+ * @param boxes boxes of the objects, in ratio to the frame size
+ * @param num_boxes number of the boxes
+ * @param timestamp timestamp (in nanoseconds) of the frame given to the detector
+ * @param roi the region to crop
+ * @return TRUE if the region is a part of the frame, FALSE for the full frame
+ */
+extern gboolean
+nns_ex_roi_scheduler_next (nns_ex_roi_scheduler_s * sched,
+    const nns_ex_box_s * boxes, guint num_boxes, guint64 timestamp,
+    nns_ex_roi_s * roi);
+
+/**
+ * @brief Get the region selected for the frame.
+ * @param timestamp timestamp (in nanoseconds) of the frame
+ * @param roi the region, the full frame if the timestamp is not found
+ * @return TRUE if the region is found
+ */
+extern gboolean
+nns_ex_roi_scheduler_lookup (nns_ex_roi_scheduler_s * sched,
+    guint64 timestamp, nns_ex_roi_s * roi);
+
+/**
+ * @brief Get the count of the detections with the region and the full frame.
+ */
+extern void
+nns_ex_roi_scheduler_get_stats (nns_ex_roi_scheduler_s * sched,
+    guint * cropped, guint * full);
+
+/**
+ * @brief Fill the pixels out of the region of the image plane, and copy the pixels in the region.
+ * @param src source plane, NULL (or same as dst) to fill dst in place
+ * @param src_stride bytes per row of the source plane
+ * @param dst destination plane
+ * @param dst_stride bytes per row of the destination plane
+ * @param width width of the plane (in pixels)
+ * @param height height of the plane (in rows)
+ * @param pixel_stride bytes per pixel
+ * @param rect the region to keep, clipped to the plane, NULL or empty to fill the whole plane
+ * @param fill value of the bytes out of the region
+ */
+extern void
+nns_ex_roi_mask_plane (const guint8 * src, gint src_stride, guint8 * dst,
+    gint dst_stride, guint width, guint height, guint pixel_stride,
+    const nns_ex_roi_rect_s * rect, guint8 fill);
+
+G_END_DECLS
+
+#endif /* __NNS_EX_ROI_H__ */
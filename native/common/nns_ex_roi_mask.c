@@ -0,0 +1,295 @@
+/**
+ * @file	nns_ex_roi_mask.c
+ * @date	19 October 2026
+ * @brief	Element to fill the pixels out of the region of interest (e.g., the box of a person)
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ */
+
+#include <gst/video/video.h>
+#include <gst/video/gstvideofilter.h>
+
+#include "nns_ex_roi.h"
+#include "nns_ex_roi_mask.h"
+
+GST_DEBUG_CATEGORY_STATIC (nns_ex_roi_mask_debug);
+#define GST_CAT_DEFAULT nns_ex_roi_mask_debug
+
+/**
+ * @brief Video formats of the pads.
+ */
+#define ROI_MASK_VIDEO_FORMATS \
+    "{ RGB, BGR, RGBx, BGRx, xRGB, xBGR, RGBA, BGRA, ARGB, ABGR, GRAY8, I420, YV12, NV12, NV21 }"
+
+/**
+ * @brief Black of the luma and chroma planes.
+ */
+#define ROI_MASK_BLACK_Y 16
+#define ROI_MASK_BLACK_UV 128
+
+/**
+ * @brief Properties.
+ */
+enum
+{
+  PROP_0,
+  PROP_REGION
+};
+
+/**
+ * @brief Data structure for the element.
+ */
+typedef struct
+{
+  GstVideoFilter parent; /**< parent object */
+
+  gchar *region; /**< region to keep, NULL to pass the frames as is */
+  nns_ex_roi_rect_s rect; /**< parsed region (protected by the object lock) */
+} NnsExRoiMask;
+
+/**
+ * @brief Data structure for the element class.
+ */
+typedef struct
+{
+  GstVideoFilterClass parent_class; /**< parent class */
+} NnsExRoiMaskClass;
+
+G_DEFINE_TYPE (NnsExRoiMask, nns_ex_roi_mask, GST_TYPE_VIDEO_FILTER);
+
+static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (ROI_MASK_VIDEO_FORMATS)));
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (ROI_MASK_VIDEO_FORMATS)));
+
+/**
+ * @brief Parse the region (e.g., '120,40,200,400'), NULL or empty string to pass the frames.
+ */
+static gboolean
+_roi_mask_parse_region (const gchar * str, nns_ex_roi_rect_s * rect)
+{
+  gchar **values;
+  gchar *end;
+  guint64 v[4];
+  guint i;
+  gboolean ret = TRUE;
+
+  rect->x = rect->y = rect->width = rect->height = 0;
+
+  if (str == NULL || *str == '\0')
+    return TRUE;
+
+  values = g_strsplit (str, ",", -1);
+  if (g_strv_length (values) != 4) {
+    g_strfreev (values);
+    return FALSE;
+  }
+
+  for (i = 0; i < 4 && ret; i++) {
+    v[i] = g_ascii_strtoull (g_strstrip (values[i]), &end, 10);
+    if (end == values[i] || *end != '\0' || v[i] > G_MAXUINT16)
+      ret = FALSE;
+  }
+  g_strfreev (values);
+
+  if (ret) {
+    rect->x = (guint) v[0];
+    rect->y = (guint) v[1];
+    rect->width = (guint) v[2];
+    rect->height = (guint) v[3];
+  }
+
+  return ret;
+}
+
+/**
+ * @brief Set the property.
+ */
+static void
+nns_ex_roi_mask_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  NnsExRoiMask *self = (NnsExRoiMask *) object;
+  const gchar *str;
+  nns_ex_roi_rect_s rect;
+  gboolean passthrough;
+
+  switch (prop_id) {
+    case PROP_REGION:
+      str = g_value_get_string (value);
+      if (!_roi_mask_parse_region (str, &rect)) {
+        GST_WARNING_OBJECT (self, "invalid region %s (x,y,width,height)", str);
+        break;
+      }
+
+      /* applied to the next frame */
+      passthrough = (str == NULL || *str == '\0');
+      GST_OBJECT_LOCK (self);
+      g_free (self->region);
+      self->region = passthrough ? NULL : g_strdup (str);
+      self->rect = rect;
+      GST_OBJECT_UNLOCK (self);
+
+      if (gst_base_transform_is_passthrough (GST_BASE_TRANSFORM (self)) !=
+          passthrough) {
+        gst_base_transform_set_passthrough (GST_BASE_TRANSFORM (self),
+            passthrough);
+        gst_base_transform_reconfigure_src (GST_BASE_TRANSFORM (self));
+      }
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+/**
+ * @brief Get the property.
+ */
+static void
+nns_ex_roi_mask_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  NnsExRoiMask *self = (NnsExRoiMask *) object;
+
+  switch (prop_id) {
+    case PROP_REGION:
+      GST_OBJECT_LOCK (self);
+      g_value_set_string (value, self->region);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+/**
+ * @brief Finalize the element.
+ */
+static void
+nns_ex_roi_mask_finalize (GObject * object)
+{
+  NnsExRoiMask *self = (NnsExRoiMask *) object;
+
+  g_free (self->region);
+
+  G_OBJECT_CLASS (nns_ex_roi_mask_parent_class)->finalize (object);
+}
+
+/**
+ * @brief Copy the region of the input frame to the output frame (from the pool) and fill the others.
+ */
+static GstFlowReturn
+nns_ex_roi_mask_transform_frame (GstVideoFilter * filter,
+    GstVideoFrame * in_frame, GstVideoFrame * out_frame)
+{
+  NnsExRoiMask *self = (NnsExRoiMask *) filter;
+  const GstVideoFormatInfo *finfo = out_frame->info.finfo;
+  nns_ex_roi_rect_s rect, plane_rect;
+  guint p, c, w_sub, h_sub, right, bottom;
+  guint8 fill;
+
+  GST_OBJECT_LOCK (self);
+  rect = self->rect;
+  GST_OBJECT_UNLOCK (self);
+
+  for (p = 0; p < GST_VIDEO_FRAME_N_PLANES (out_frame); p++) {
+    /* first component of the plane, for the size and the pixel stride */
+    for (c = 0; c < GST_VIDEO_FRAME_N_COMPONENTS (out_frame); c++) {
+      if (GST_VIDEO_FORMAT_INFO_PLANE (finfo, c) == p)
+        break;
+    }
+
+    /* region of the subsampled plane, covering the region of the frame */
+    w_sub = GST_VIDEO_FORMAT_INFO_W_SUB (finfo, c);
+    h_sub = GST_VIDEO_FORMAT_INFO_H_SUB (finfo, c);
+    right = rect.x + rect.width;
+    bottom = rect.y + rect.height;
+    plane_rect.x = rect.x >> w_sub;
+    plane_rect.y = rect.y >> h_sub;
+    plane_rect.width = ((right + (1 << w_sub) - 1) >> w_sub) - plane_rect.x;
+    plane_rect.height = ((bottom + (1 << h_sub) - 1) >> h_sub) - plane_rect.y;
+    if (rect.width == 0 || rect.height == 0)
+      plane_rect.width = plane_rect.height = 0;
+
+    if (GST_VIDEO_FORMAT_INFO_IS_YUV (finfo))
+      fill = (c == GST_VIDEO_COMP_Y) ? ROI_MASK_BLACK_Y : ROI_MASK_BLACK_UV;
+    else
+      fill = 0;
+
+    nns_ex_roi_mask_plane (GST_VIDEO_FRAME_PLANE_DATA (in_frame, p),
+        GST_VIDEO_FRAME_PLANE_STRIDE (in_frame, p),
+        GST_VIDEO_FRAME_PLANE_DATA (out_frame, p),
+        GST_VIDEO_FRAME_PLANE_STRIDE (out_frame, p),
+        GST_VIDEO_FRAME_COMP_WIDTH (out_frame, c),
+        GST_VIDEO_FRAME_COMP_HEIGHT (out_frame, c),
+        GST_VIDEO_FRAME_COMP_PSTRIDE (out_frame, c), &plane_rect, fill);
+  }
+
+  return GST_FLOW_OK;
+}
+
+/**
+ * @brief Initialize the element class.
+ */
+static void
+nns_ex_roi_mask_class_init (NnsExRoiMaskClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  GstVideoFilterClass *filter_class = GST_VIDEO_FILTER_CLASS (klass);
+
+  GST_DEBUG_CATEGORY_INIT (nns_ex_roi_mask_debug, NNS_EX_ROI_MASK_NAME, 0,
+      "Masking of the pixels out of the region");
+
+  gobject_class->set_property = nns_ex_roi_mask_set_property;
+  gobject_class->get_property = nns_ex_roi_mask_get_property;
+  gobject_class->finalize = nns_ex_roi_mask_finalize;
+
+  g_object_class_install_property (gobject_class, PROP_REGION,
+      g_param_spec_string ("region", "Region",
+          "Region to keep, x,y,width,height in pixels (e.g., 120,40,200,400), "
+          "empty to pass the frames as is", NULL,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
+  gst_element_class_set_static_metadata (element_class,
+      "NNStreamer example ROI mask", "Filter/Effect/Video",
+      "Fills the pixels out of the region of interest with black",
+      "agent <agent@local>");
+
+  gst_element_class_add_static_pad_template (element_class, &sink_template);
+  gst_element_class_add_static_pad_template (element_class, &src_template);
+
+  filter_class->transform_frame =
+      GST_DEBUG_FUNCPTR (nns_ex_roi_mask_transform_frame);
+}
+
+/**
+ * @brief Initialize the element.
+ */
+static void
+nns_ex_roi_mask_init (NnsExRoiMask * self)
+{
+  self->region = NULL;
+  _roi_mask_parse_region (NULL, &self->rect);
+
+  /* no region until the property is set */
+  gst_base_transform_set_passthrough (GST_BASE_TRANSFORM (self), TRUE);
+}
+
+/**
+ * @brief Register the element 'nns_ex_roi_mask' to the application.
+ */
+gboolean
+nns_ex_roi_mask_register (void)
+{
+  return gst_element_register (NULL, NNS_EX_ROI_MASK_NAME, GST_RANK_NONE,
+      nns_ex_roi_mask_get_type ());
+}
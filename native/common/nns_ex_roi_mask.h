@@ -0,0 +1,63 @@
+/**
+ * @file	nns_ex_roi_mask.h
+ * @date	19 October 2026
+ * @brief	Element to fill the pixels out of the region of interest (e.g., the box of a person)
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * The element 'nns_ex_roi_mask' keeps the pixels in the region and fills the others with black,
+ * instead of the pad probe which makes the buffer writable and checks each pixel.
+ * The element writes the output frame into the buffer from the pool (negotiated with downstream),
+ * with memset of the rows and the spans out of the region (nns_ex_roi_mask_plane()),
+ * and uses the stride of each plane from the video info.
+ *
+ * Usage :
+ *
+ * (application)
+ * gst_init (&argc, &argv);
+ * nns_ex_roi_mask_register ();
+ *
+ * (gst-launch, the plugin 'nnsexample' in GST_PLUGIN_PATH)
+ * videotestsrc ! video/x-raw,format=RGB,width=480,height=480 ! nns_ex_roi_mask region=120,40,200,400 ! videoconvert ! ximagesink
+ *
+ * (the region is changed in PLAYING, e.g., the box of the latest detection)
+ * g_object_set (mask, "region", "120,40,200,400", NULL);
+ *
+ * Properties :
+ * region : x,y,width,height of the region in pixels, the empty string to pass the frames as is (default),
+ * and the region with zero size to fill the whole frame
+ *
+ * Pads :
+ * sink, src : RGB, BGR, RGBx, BGRx, xRGB, xBGR, RGBA, BGRA, ARGB, ABGR, GRAY8, I420, YV12, NV12, NV21
+ * (black is 0 for RGB, and Y 16 and UV 128 for YUV)
+ */
+
+#ifndef __NNS_EX_ROI_MASK_H__
+#define __NNS_EX_ROI_MASK_H__
+
+#include <glib.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Name of the element.
+ */
+#define NNS_EX_ROI_MASK_NAME "nns_ex_roi_mask"
+
+/**
+ * @brief Get the type of the element.
+ */
+extern GType
+nns_ex_roi_mask_get_type (void);
+
+/**
+ * @brief Register the element 'nns_ex_roi_mask' to the application.
+ * @return TRUE if the element is registered
+ */
+extern gboolean
+nns_ex_roi_mask_register (void);
+
+G_END_DECLS
+
+#endif /* __NNS_EX_ROI_MASK_H__ */
@@ -0,0 +1,514 @@
+/**
+ * @file	nns_ex_sched.c
+ * @date	19 October 2026
+ * @brief	Per-branch thread scheduling for multi-branch pipelines
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+#include "nns_ex_sched.h"
+
+/**
+ * @brief Data structure for a branch.
+ */
+typedef struct
+{
+  gchar *name; /**< branch name */
+  gchar *element_name; /**< name of the element owning the streaming thread */
+  gchar *sink_name; /**< name of the element at the end of branch */
+  gboolean pin; /**< true to set the cpu affinity */
+  cpu_set_t cpus; /**< cpu set */
+  nns_ex_sched_policy_e policy; /**< scheduling policy */
+  gint priority; /**< nice value or realtime priority */
+  GstClockTime deadline; /**< latency budget */
+
+  GstElement *element; /**< element owning the streaming thread */
+  GstPad *sink_pad; /**< sink pad of the element at the end of branch */
+  gulong probe_id; /**< probe to measure the latency */
+  GstSegment segment; /**< current segment at the end of branch */
+  nns_ex_sched_stats_s stats; /**< statistics, updated in the streaming thread */
+  nns_ex_sched_s *sched; /**< scheduler handle */
+} nns_ex_sched_branch_s;
+
+/**
+ * @brief Data structure for scheduler.
+ */
+struct _nns_ex_sched_s
+{
+  GList *branches; /**< list of branches */
+  GstElement *pipeline; /**< pipeline attached */
+  GstBus *bus; /**< bus of the pipeline */
+  gulong sync_message_id; /**< handler of the sync message */
+};
+
+/**
+ * @brief Parse cpu list (e.g., '0,2-3').
+ */
+static gboolean
+_sched_parse_cpus (const gchar * str, cpu_set_t * cpus)
+{
+  gchar **tokens;
+  gchar *end;
+  guint i;
+  glong first, last, cpu;
+  gboolean ret = TRUE;
+
+  CPU_ZERO (cpus);
+
+  tokens = g_strsplit (str, ",", -1);
+  for (i = 0; tokens[i] != NULL && ret; i++) {
+    g_strstrip (tokens[i]);
+
+    first = strtol (tokens[i], &end, 10);
+    last = first;
+
+    if (*end == '-')
+      last = strtol (end + 1, &end, 10);
+
+    if (end == tokens[i] || *end != '\0' || first < 0 || last < first ||
+        last >= CPU_SETSIZE) {
+      ret = FALSE;
+      break;
+    }
+
+    for (cpu = first; cpu <= last; cpu++)
+      CPU_SET (cpu, cpus);
+  }
+  g_strfreev (tokens);
+
+  return ret && CPU_COUNT (cpus) > 0;
+}
+
+/**
+ * @brief Parse scheduling policy.
+ */
+static gboolean
+_sched_parse_policy (const gchar * str, nns_ex_sched_policy_e * policy)
+{
+  if (str == NULL || g_ascii_strcasecmp (str, "other") == 0)
+    *policy = NNS_EX_SCHED_POLICY_OTHER;
+  else if (g_ascii_strcasecmp (str, "fifo") == 0)
+    *policy = NNS_EX_SCHED_POLICY_FIFO;
+  else if (g_ascii_strcasecmp (str, "rr") == 0)
+    *policy = NNS_EX_SCHED_POLICY_RR;
+  else
+    return FALSE;
+
+  return TRUE;
+}
+
+/**
+ * @brief Free branch data.
+ */
+static void
+_sched_free_branch (gpointer data)
+{
+  nns_ex_sched_branch_s *branch = (nns_ex_sched_branch_s *) data;
+
+  if (branch->sink_pad) {
+    if (branch->probe_id > 0)
+      gst_pad_remove_probe (branch->sink_pad, branch->probe_id);
+    gst_object_unref (branch->sink_pad);
+  }
+
+  if (branch->element)
+    gst_object_unref (branch->element);
+
+  g_free (branch->name);
+  g_free (branch->element_name);
+  g_free (branch->sink_name);
+  g_free (branch);
+}
+
+/**
+ * @brief Set the cpu affinity and priority of current thread.
+ * @note This is called in the streaming thread of the branch.
+ */
+static void
+_sched_apply (nns_ex_sched_branch_s * branch)
+{
+  pid_t tid = (pid_t) syscall (SYS_gettid);
+  struct sched_param param;
+  gint policy, err;
+
+  if (branch->pin &&
+      sched_setaffinity (tid, sizeof (cpu_set_t), &branch->cpus) != 0) {
+    g_warning ("Failed to set cpu affinity of branch %s (%s)", branch->name,
+        g_strerror (errno));
+  }
+
+  switch (branch->policy) {
+    case NNS_EX_SCHED_POLICY_FIFO:
+    case NNS_EX_SCHED_POLICY_RR:
+      policy = (branch->policy == NNS_EX_SCHED_POLICY_FIFO) ?
+          SCHED_FIFO : SCHED_RR;
+      param.sched_priority = CLAMP (branch->priority,
+          sched_get_priority_min (policy), sched_get_priority_max (policy));
+
+      err = pthread_setschedparam (pthread_self (), policy, &param);
+      if (err != 0) {
+        g_warning ("Failed to set realtime priority of branch %s (%s)",
+            branch->name, g_strerror (err));
+      }
+      break;
+    default:
+      if (setpriority (PRIO_PROCESS, tid, branch->priority) != 0) {
+        g_warning ("Failed to set nice value of branch %s (%s)", branch->name,
+            g_strerror (errno));
+      }
+      break;
+  }
+}
+
+/**
+ * @brief Callback for the sync message to catch the streaming thread when it starts.
+ */
+static void
+_sched_sync_message_cb (GstBus * bus, GstMessage * message,
+    gpointer user_data)
+{
+  nns_ex_sched_s *sched = (nns_ex_sched_s *) user_data;
+  nns_ex_sched_branch_s *branch;
+  GstStreamStatusType type;
+  GstElement *owner;
+  GList *l;
+
+  if (GST_MESSAGE_TYPE (message) != GST_MESSAGE_STREAM_STATUS)
+    return;
+
+  gst_message_parse_stream_status (message, &type, &owner);
+
+  /* the enter message is posted in the new streaming thread */
+  if (type == GST_STREAM_STATUS_TYPE_ENTER) {
+    for (l = sched->branches; l != NULL; l = l->next) {
+      branch = (nns_ex_sched_branch_s *) l->data;
+
+      if (branch->element == owner) {
+        _sched_apply (branch);
+        break;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Pad probe to measure the latency at the end of branch.
+ */
+static GstPadProbeReturn
+_sched_sink_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  nns_ex_sched_branch_s *branch = (nns_ex_sched_branch_s *) user_data;
+  nns_ex_sched_stats_s *stats = &branch->stats;
+  GstBuffer *buffer;
+  GstClock *clock;
+  GstClockTime end, now, latency;
+
+  if (info->type & GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM) {
+    GstEvent *event = GST_PAD_PROBE_INFO_EVENT (info);
+
+    if (GST_EVENT_TYPE (event) == GST_EVENT_SEGMENT)
+      gst_event_copy_segment (event, &branch->segment);
+
+    return GST_PAD_PROBE_OK;
+  }
+
+  buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  if (buffer == NULL || !GST_BUFFER_PTS_IS_VALID (buffer))
+    return GST_PAD_PROBE_OK;
+
+  /* the deadline is measured from the time the last data of buffer is captured */
+  end = GST_BUFFER_PTS (buffer);
+  if (GST_BUFFER_DURATION_IS_VALID (buffer))
+    end += GST_BUFFER_DURATION (buffer);
+
+  if (branch->segment.format == GST_FORMAT_TIME)
+    end = gst_segment_to_running_time (&branch->segment, GST_FORMAT_TIME, end);
+
+  clock = gst_element_get_clock (branch->sched->pipeline);
+  if (clock == NULL || !GST_CLOCK_TIME_IS_VALID (end)) {
+    if (clock)
+      gst_object_unref (clock);
+    return GST_PAD_PROBE_OK;
+  }
+
+  now = gst_clock_get_time (clock) -
+      gst_element_get_base_time (branch->sched->pipeline);
+  gst_object_unref (clock);
+
+  latency = (now > end) ? (now - end) : 0;
+
+  stats->processed++;
+  stats->total_latency += latency;
+  if (latency > stats->max_latency)
+    stats->max_latency = latency;
+
+  if (GST_CLOCK_TIME_IS_VALID (branch->deadline) && latency > branch->deadline)
+    stats->missed++;
+
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Create new scheduler.
+ */
+nns_ex_sched_s *
+nns_ex_sched_new (void)
+{
+  return g_new0 (nns_ex_sched_s, 1);
+}
+
+/**
+ * @brief Free the scheduler.
+ */
+void
+nns_ex_sched_free (nns_ex_sched_s * sched)
+{
+  g_return_if_fail (sched != NULL);
+
+  if (sched->bus) {
+    g_signal_handler_disconnect (sched->bus, sched->sync_message_id);
+    gst_bus_disable_sync_message_emission (sched->bus);
+    gst_object_unref (sched->bus);
+  }
+
+  if (sched->pipeline)
+    gst_object_unref (sched->pipeline);
+
+  g_list_free_full (sched->branches, _sched_free_branch);
+  g_free (sched);
+}
+
+/**
+ * @brief Add a branch to be scheduled.
+ */
+gboolean
+nns_ex_sched_add_branch (nns_ex_sched_s * sched, const gchar * name,
+    const gchar * element, const gchar * sink, const gchar * cpus,
+    nns_ex_sched_policy_e policy, gint priority, GstClockTime deadline)
+{
+  nns_ex_sched_branch_s *branch;
+
+  g_return_val_if_fail (sched != NULL, FALSE);
+  g_return_val_if_fail (name != NULL && element != NULL, FALSE);
+  g_return_val_if_fail (sched->pipeline == NULL, FALSE);
+
+  branch = g_new0 (nns_ex_sched_branch_s, 1);
+
+  if (cpus != NULL) {
+    if (!_sched_parse_cpus (cpus, &branch->cpus)) {
+      g_warning ("Invalid cpu list [%s] of branch %s", cpus, name);
+      g_free (branch);
+      return FALSE;
+    }
+
+    branch->pin = TRUE;
+  }
+
+  branch->name = g_strdup (name);
+  branch->element_name = g_strdup (element);
+  branch->sink_name = g_strdup (sink);
+  branch->policy = policy;
+  branch->priority = priority;
+  branch->deadline = deadline;
+  branch->sched = sched;
+  gst_segment_init (&branch->segment, GST_FORMAT_UNDEFINED);
+
+  sched->branches = g_list_append (sched->branches, branch);
+  return TRUE;
+}
+
+/**
+ * @brief Load the branches from the config file.
+ */
+gboolean
+nns_ex_sched_load_config (nns_ex_sched_s * sched, const gchar * path,
+    GError ** error)
+{
+  GKeyFile *key_file;
+  gchar **groups;
+  gchar *element, *sink, *cpus, *policy_str;
+  nns_ex_sched_policy_e policy;
+  GstClockTime deadline;
+  gint priority, deadline_ms;
+  guint i;
+  gboolean ret = TRUE;
+
+  g_return_val_if_fail (sched != NULL, FALSE);
+  g_return_val_if_fail (path != NULL, FALSE);
+
+  key_file = g_key_file_new ();
+
+  if (!g_key_file_load_from_file (key_file, path, G_KEY_FILE_NONE, error)) {
+    g_key_file_free (key_file);
+    return FALSE;
+  }
+
+  groups = g_key_file_get_groups (key_file, NULL);
+  for (i = 0; groups[i] != NULL && ret; i++) {
+    element = g_key_file_get_string (key_file, groups[i], "element", error);
+    if (element == NULL) {
+      ret = FALSE;
+      break;
+    }
+
+    sink = g_key_file_get_string (key_file, groups[i], "sink", NULL);
+    cpus = g_key_file_get_string (key_file, groups[i], "cpus", NULL);
+    policy_str = g_key_file_get_string (key_file, groups[i], "policy", NULL);
+    priority = g_key_file_get_integer (key_file, groups[i], "priority", NULL);
+
+    deadline = GST_CLOCK_TIME_NONE;
+    if (g_key_file_has_key (key_file, groups[i], "deadline-ms", NULL)) {
+      deadline_ms =
+          g_key_file_get_integer (key_file, groups[i], "deadline-ms", NULL);
+      if (deadline_ms > 0)
+        deadline = deadline_ms * GST_MSECOND;
+    }
+
+    if (!_sched_parse_policy (policy_str, &policy)) {
+      g_set_error (error, G_KEY_FILE_ERROR, G_KEY_FILE_ERROR_INVALID_VALUE,
+          "Invalid policy [%s] of branch %s", policy_str, groups[i]);
+      ret = FALSE;
+    } else if (!nns_ex_sched_add_branch (sched, groups[i], element, sink,
+            cpus, policy, priority, deadline)) {
+      g_set_error (error, G_KEY_FILE_ERROR, G_KEY_FILE_ERROR_INVALID_VALUE,
+          "Failed to add branch %s", groups[i]);
+      ret = FALSE;
+    }
+
+    g_free (element);
+    g_free (sink);
+    g_free (cpus);
+    g_free (policy_str);
+  }
+
+  g_strfreev (groups);
+  g_key_file_free (key_file);
+  return ret;
+}
+
+/**
+ * @brief Attach the scheduler to the pipeline.
+ */
+gboolean
+nns_ex_sched_attach (nns_ex_sched_s * sched, GstElement * pipeline)
+{
+  nns_ex_sched_branch_s *branch;
+  GstElement *sink;
+  GList *l;
+  gboolean ret = TRUE;
+
+  g_return_val_if_fail (sched != NULL, FALSE);
+  g_return_val_if_fail (GST_IS_BIN (pipeline), FALSE);
+  g_return_val_if_fail (sched->pipeline == NULL, FALSE);
+
+  sched->pipeline = gst_object_ref (pipeline);
+
+  for (l = sched->branches; l != NULL; l = l->next) {
+    branch = (nns_ex_sched_branch_s *) l->data;
+
+    branch->element =
+        gst_bin_get_by_name (GST_BIN (pipeline), branch->element_name);
+    if (branch->element == NULL) {
+      g_warning ("Cannot find the element %s of branch %s",
+          branch->element_name, branch->name);
+      ret = FALSE;
+    }
+
+    if (branch->sink_name == NULL)
+      continue;
+
+    sink = gst_bin_get_by_name (GST_BIN (pipeline), branch->sink_name);
+    if (sink == NULL) {
+      g_warning ("Cannot find the element %s of branch %s",
+          branch->sink_name, branch->name);
+      ret = FALSE;
+      continue;
+    }
+
+    branch->sink_pad = gst_element_get_static_pad (sink, "sink");
+    gst_object_unref (sink);
+
+    if (branch->sink_pad) {
+      branch->probe_id = gst_pad_add_probe (branch->sink_pad,
+          GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM,
+          _sched_sink_probe, branch, NULL);
+    }
+  }
+
+  /* the sync message is emitted with the sync handler of the application kept */
+  sched->bus = gst_element_get_bus (pipeline);
+  gst_bus_enable_sync_message_emission (sched->bus);
+  sched->sync_message_id = g_signal_connect (sched->bus,
+      "sync-message::stream-status", (GCallback) _sched_sync_message_cb,
+      sched);
+
+  return ret;
+}
+
+/**
+ * @brief Get the statistics of the branch.
+ */
+gboolean
+nns_ex_sched_get_stats (nns_ex_sched_s * sched, const gchar * name,
+    nns_ex_sched_stats_s * stats)
+{
+  nns_ex_sched_branch_s *branch;
+  GList *l;
+
+  g_return_val_if_fail (sched != NULL, FALSE);
+  g_return_val_if_fail (name != NULL && stats != NULL, FALSE);
+
+  for (l = sched->branches; l != NULL; l = l->next) {
+    branch = (nns_ex_sched_branch_s *) l->data;
+
+    if (g_str_equal (branch->name, name)) {
+      *stats = branch->stats;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+ * @brief Print the deadline misses of all branches.
+ */
+void
+nns_ex_sched_print_stats (nns_ex_sched_s * sched)
+{
+  nns_ex_sched_branch_s *branch;
+  nns_ex_sched_stats_s *stats;
+  GstClockTime avg;
+  GList *l;
+
+  g_return_if_fail (sched != NULL);
+
+  for (l = sched->branches; l != NULL; l = l->next) {
+    branch = (nns_ex_sched_branch_s *) l->data;
+    stats = &branch->stats;
+
+    avg = (stats->processed > 0) ?
+        stats->total_latency / stats->processed : 0;
+
+    g_print ("[%s] processed %" G_GUINT64_FORMAT ", deadline %" G_GINT64_FORMAT
+        " ms, missed %" G_GUINT64_FORMAT ", latency avg %" G_GUINT64_FORMAT
+        " ms max %" G_GUINT64_FORMAT " ms\n", branch->name, stats->processed,
+        GST_CLOCK_TIME_IS_VALID (branch->deadline) ?
+        (gint64) GST_TIME_AS_MSECONDS (branch->deadline) : (gint64) - 1,
+        stats->missed, GST_TIME_AS_MSECONDS (avg),
+        GST_TIME_AS_MSECONDS (stats->max_latency));
+  }
+}
@@ -0,0 +1,136 @@
+/**
+ * @file	nns_ex_sched.h
+ * @date	19 October 2026
+ * @brief	Per-branch thread scheduling for multi-branch pipelines
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * Each branch of a pipeline (e.g., audio inference, image inference, display) is
+ * identified by the element owning its streaming thread (usually a queue) and the
+ * element at the end of the branch (usually a sink).
+ *
+ * When the streaming thread of a branch starts, the scheduler pins the thread to the
+ * given CPU set and sets its scheduling policy and priority.
+ * At the end of the branch, the scheduler measures the latency of each buffer
+ * (current running time - buffer end time) and counts the deadline misses.
+ *
+ * Config file example (GKeyFile, a group per branch) :
+ *
+ * [audio]
+ * element=q_audio
+ * sink=tensor_sink_speech
+ * cpus=0
+ * policy=fifo
+ * priority=10
+ * deadline-ms=300
+ *
+ * [display]
+ * element=q_display
+ * sink=img_sink
+ * cpus=2-3
+ * policy=other
+ * priority=10
+ * deadline-ms=100
+ *
+ * 'policy' is one of 'other', 'fifo' and 'rr'.
+ * 'priority' is the nice value with 'other', and the realtime priority (1~99) with 'fifo' or 'rr'.
+ * Realtime policy needs the privilege (CAP_SYS_NICE), the scheduler only warns if failed.
+ */
+
+#ifndef __NNS_EX_SCHED_H__
+#define __NNS_EX_SCHED_H__
+
+#include <glib.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Scheduling policy of the streaming thread.
+ */
+typedef enum
+{
+  NNS_EX_SCHED_POLICY_OTHER = 0,
+  NNS_EX_SCHED_POLICY_FIFO,
+  NNS_EX_SCHED_POLICY_RR
+} nns_ex_sched_policy_e;
+
+/**
+ * @brief Statistics of a branch.
+ */
+typedef struct
+{
+  guint64 processed; /**< count of buffers reached the end of branch */
+  guint64 missed; /**< count of buffers which missed the deadline */
+  GstClockTime max_latency; /**< max latency */
+  GstClockTime total_latency; /**< sum of latency, to get the average */
+} nns_ex_sched_stats_s;
+
+/**
+ * @brief Handle of the scheduler.
+ */
+typedef struct _nns_ex_sched_s nns_ex_sched_s;
+
+/**
+ * @brief Create new scheduler.
+ */
+extern nns_ex_sched_s *
+nns_ex_sched_new (void);
+
+/**
+ * @brief Free the scheduler.
+ * @note Call this after the pipeline is stopped.
+ */
+extern void
+nns_ex_sched_free (nns_ex_sched_s * sched);
+
+/**
+ * @brief Add a branch to be scheduled.
+ * @param name branch name
+ * @param element name of the element owning the streaming thread of the branch
+ * @param sink name of the element at the end of the branch (NULL to skip measuring deadline)
+ * @param cpus cpu list (e.g., '0,2-3'), NULL not to pin the thread
+ * @param policy scheduling policy
+ * @param priority nice value or realtime priority
+ * @param deadline latency budget of the branch (GST_CLOCK_TIME_NONE to skip)
+ * @return TRUE if the branch is added
+ */
+extern gboolean
+nns_ex_sched_add_branch (nns_ex_sched_s * sched, const gchar * name,
+    const gchar * element, const gchar * sink, const gchar * cpus,
+    nns_ex_sched_policy_e policy, gint priority, GstClockTime deadline);
+
+/**
+ * @brief Load the branches from the config file.
+ * @return TRUE if all branches in the file are added
+ */
+extern gboolean
+nns_ex_sched_load_config (nns_ex_sched_s * sched, const gchar * path,
+    GError ** error);
+
+/**
+ * @brief Attach the scheduler to the pipeline.
+ * @note Call this before the pipeline starts, this enables the sync message emission of the pipeline bus
+ * (the sync handler of the application is kept).
+ * @return TRUE if all branches are found in the pipeline
+ */
+extern gboolean
+nns_ex_sched_attach (nns_ex_sched_s * sched, GstElement * pipeline);
+
+/**
+ * @brief Get the statistics of the branch.
+ * @return TRUE if the branch exists
+ */
+extern gboolean
+nns_ex_sched_get_stats (nns_ex_sched_s * sched, const gchar * name,
+    nns_ex_sched_stats_s * stats);
+
+/**
+ * @brief Print the deadline misses of all branches.
+ */
+extern void
+nns_ex_sched_print_stats (nns_ex_sched_s * sched);
+
+G_END_DECLS
+
+#endif /* __NNS_EX_SCHED_H__ */
@@ -0,0 +1,366 @@
+/**
+ * @file	nns_ex_sparse_overlay.c
+ * @date	19 October 2026
+ * @brief	Element to draw the overlay only on the visible pixels, instead of compositor
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ */
+
+#include <gst/video/video.h>
+
+#include "nns_ex_overlay.h"
+#include "nns_ex_sparse_overlay.h"
+
+GST_DEBUG_CATEGORY_STATIC (nns_ex_sparse_overlay_debug);
+#define GST_CAT_DEFAULT nns_ex_sparse_overlay_debug
+
+/**
+ * @brief Video formats of the video pads.
+ */
+#define SPARSE_OVERLAY_VIDEO_FORMATS \
+    "{ RGB, BGR, RGBx, BGRx, xRGB, xBGR, RGBA, BGRA, ARGB, ABGR }"
+
+/**
+ * @brief Data structure for the element.
+ */
+typedef struct
+{
+  GstElement parent; /**< parent object */
+
+  GstPad *video_sinkpad; /**< video to draw */
+  GstPad *overlay_sinkpad; /**< RGBA overlay */
+  GstPad *srcpad; /**< video with the overlay */
+
+  GstVideoInfo video_info; /**< negotiated video info */
+  gboolean video_valid; /**< true if the video caps are negotiated */
+  GstVideoInfo overlay_info; /**< negotiated overlay info */
+  gboolean overlay_valid; /**< true if the overlay caps are negotiated */
+
+  nns_ex_overlay_s *spans; /**< spans blended onto the video (protected by the object lock) */
+  nns_ex_overlay_s *next; /**< spans made from the new overlay (overlay streaming thread) */
+  GstBuffer *overlay; /**< latest overlay frame, to make the spans again if the video size is changed */
+} NnsExSparseOverlay;
+
+/**
+ * @brief Data structure for the element class.
+ */
+typedef struct
+{
+  GstElementClass parent_class; /**< parent class */
+} NnsExSparseOverlayClass;
+
+G_DEFINE_TYPE (NnsExSparseOverlay, nns_ex_sparse_overlay, GST_TYPE_ELEMENT);
+
+static GstStaticPadTemplate video_sink_template =
+GST_STATIC_PAD_TEMPLATE ("video_sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (SPARSE_OVERLAY_VIDEO_FORMATS)));
+
+static GstStaticPadTemplate overlay_sink_template =
+GST_STATIC_PAD_TEMPLATE ("overlay_sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE ("RGBA")));
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (SPARSE_OVERLAY_VIDEO_FORMATS)));
+
+/**
+ * @brief Make the spans from the overlay frame, for the size of the video.
+ */
+static gboolean
+_sparse_overlay_make_spans (NnsExSparseOverlay * self, GstBuffer * buffer,
+    nns_ex_overlay_s * spans)
+{
+  GstVideoFrame frame;
+  guint width, height;
+
+  if (!gst_video_frame_map (&frame, &self->overlay_info, buffer, GST_MAP_READ)) {
+    GST_WARNING_OBJECT (self, "failed to map the overlay frame");
+    return FALSE;
+  }
+
+  width = GST_VIDEO_FRAME_WIDTH (&frame);
+  height = GST_VIDEO_FRAME_HEIGHT (&frame);
+
+  /* same size as the overlay until the video is negotiated */
+  nns_ex_overlay_from_rgba (spans, GST_VIDEO_FRAME_PLANE_DATA (&frame, 0),
+      width, height, GST_VIDEO_FRAME_PLANE_STRIDE (&frame, 0),
+      self->video_valid ? GST_VIDEO_INFO_WIDTH (&self->video_info) : width,
+      self->video_valid ? GST_VIDEO_INFO_HEIGHT (&self->video_info) : height);
+
+  gst_video_frame_unmap (&frame);
+  return TRUE;
+}
+
+/**
+ * @brief Release the overlay.
+ */
+static void
+_sparse_overlay_reset (NnsExSparseOverlay * self)
+{
+  GST_OBJECT_LOCK (self);
+  nns_ex_overlay_reset (self->spans, 0, 0);
+  gst_buffer_replace (&self->overlay, NULL);
+  GST_OBJECT_UNLOCK (self);
+}
+
+/**
+ * @brief Draw the overlay onto the video frame and push it.
+ */
+static GstFlowReturn
+nns_ex_sparse_overlay_video_chain (GstPad * pad, GstObject * parent,
+    GstBuffer * buffer)
+{
+  NnsExSparseOverlay *self = (NnsExSparseOverlay *) parent;
+  GstVideoFrame frame;
+  guint width, height, pixels;
+
+  if (!self->video_valid) {
+    gst_buffer_unref (buffer);
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+
+  width = GST_VIDEO_INFO_WIDTH (&self->video_info);
+  height = GST_VIDEO_INFO_HEIGHT (&self->video_info);
+
+  GST_OBJECT_LOCK (self);
+  pixels = nns_ex_overlay_get_pixels (self->spans);
+  GST_OBJECT_UNLOCK (self);
+
+  /* nothing to draw, pass the frame as is */
+  if (pixels == 0)
+    return gst_pad_push (self->srcpad, buffer);
+
+  buffer = gst_buffer_make_writable (buffer);
+  if (!gst_video_frame_map (&frame, &self->video_info, buffer,
+          GST_MAP_READWRITE)) {
+    GST_WARNING_OBJECT (self, "failed to map the video frame");
+    return gst_pad_push (self->srcpad, buffer);
+  }
+
+  GST_OBJECT_LOCK (self);
+  if (!nns_ex_overlay_blend (self->spans,
+          GST_VIDEO_FRAME_PLANE_DATA (&frame, 0), width, height,
+          GST_VIDEO_FRAME_PLANE_STRIDE (&frame, 0),
+          GST_VIDEO_FRAME_COMP_PSTRIDE (&frame, 0),
+          GST_VIDEO_FRAME_COMP_POFFSET (&frame, GST_VIDEO_COMP_R),
+          GST_VIDEO_FRAME_COMP_POFFSET (&frame, GST_VIDEO_COMP_G),
+          GST_VIDEO_FRAME_COMP_POFFSET (&frame, GST_VIDEO_COMP_B))) {
+    /* the video size is changed, make the spans again */
+    if (self->overlay && _sparse_overlay_make_spans (self, self->overlay,
+            self->spans)) {
+      nns_ex_overlay_blend (self->spans,
+          GST_VIDEO_FRAME_PLANE_DATA (&frame, 0), width, height,
+          GST_VIDEO_FRAME_PLANE_STRIDE (&frame, 0),
+          GST_VIDEO_FRAME_COMP_PSTRIDE (&frame, 0),
+          GST_VIDEO_FRAME_COMP_POFFSET (&frame, GST_VIDEO_COMP_R),
+          GST_VIDEO_FRAME_COMP_POFFSET (&frame, GST_VIDEO_COMP_G),
+          GST_VIDEO_FRAME_COMP_POFFSET (&frame, GST_VIDEO_COMP_B));
+    }
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  gst_video_frame_unmap (&frame);
+  return gst_pad_push (self->srcpad, buffer);
+}
+
+/**
+ * @brief Make the spans from the new overlay frame.
+ */
+static GstFlowReturn
+nns_ex_sparse_overlay_overlay_chain (GstPad * pad, GstObject * parent,
+    GstBuffer * buffer)
+{
+  NnsExSparseOverlay *self = (NnsExSparseOverlay *) parent;
+  nns_ex_overlay_s *swap;
+
+  if (!self->overlay_valid) {
+    gst_buffer_unref (buffer);
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+
+  /* the video thread blends the current spans meanwhile */
+  if (_sparse_overlay_make_spans (self, buffer, self->next)) {
+    GST_OBJECT_LOCK (self);
+    swap = self->spans;
+    self->spans = self->next;
+    self->next = swap;
+    gst_buffer_replace (&self->overlay, buffer);
+    GST_OBJECT_UNLOCK (self);
+
+    GST_LOG_OBJECT (self, "overlay with %u pixels",
+        nns_ex_overlay_get_pixels (self->spans));
+  }
+
+  gst_buffer_unref (buffer);
+  return GST_FLOW_OK;
+}
+
+/**
+ * @brief Handle the events of the video, forwarded downstream.
+ */
+static gboolean
+nns_ex_sparse_overlay_video_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  NnsExSparseOverlay *self = (NnsExSparseOverlay *) parent;
+  GstCaps *caps;
+
+  if (GST_EVENT_TYPE (event) == GST_EVENT_CAPS) {
+    gst_event_parse_caps (event, &caps);
+    self->video_valid = gst_video_info_from_caps (&self->video_info, caps);
+    if (!self->video_valid) {
+      GST_ERROR_OBJECT (self, "invalid caps %" GST_PTR_FORMAT, caps);
+      gst_event_unref (event);
+      return FALSE;
+    }
+  }
+
+  return gst_pad_push_event (self->srcpad, event);
+}
+
+/**
+ * @brief Handle the events of the overlay, not forwarded (the video stream decides the segment and EOS).
+ */
+static gboolean
+nns_ex_sparse_overlay_overlay_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  NnsExSparseOverlay *self = (NnsExSparseOverlay *) parent;
+  GstCaps *caps;
+  gboolean ret = TRUE;
+
+  if (GST_EVENT_TYPE (event) == GST_EVENT_CAPS) {
+    gst_event_parse_caps (event, &caps);
+    self->overlay_valid = gst_video_info_from_caps (&self->overlay_info, caps);
+    ret = self->overlay_valid;
+  }
+
+  gst_event_unref (event);
+  return ret;
+}
+
+/**
+ * @brief Handle the upstream events, forwarded to the video.
+ */
+static gboolean
+nns_ex_sparse_overlay_src_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  NnsExSparseOverlay *self = (NnsExSparseOverlay *) parent;
+
+  return gst_pad_push_event (self->video_sinkpad, event);
+}
+
+/**
+ * @brief Release the overlay when the element stops.
+ */
+static GstStateChangeReturn
+nns_ex_sparse_overlay_change_state (GstElement * element,
+    GstStateChange transition)
+{
+  NnsExSparseOverlay *self = (NnsExSparseOverlay *) element;
+  GstStateChangeReturn ret;
+
+  ret = GST_ELEMENT_CLASS (nns_ex_sparse_overlay_parent_class)->change_state
+      (element, transition);
+
+  if (transition == GST_STATE_CHANGE_PAUSED_TO_READY) {
+    _sparse_overlay_reset (self);
+    self->video_valid = self->overlay_valid = FALSE;
+  }
+
+  return ret;
+}
+
+/**
+ * @brief Finalize the element.
+ */
+static void
+nns_ex_sparse_overlay_finalize (GObject * object)
+{
+  NnsExSparseOverlay *self = (NnsExSparseOverlay *) object;
+
+  gst_buffer_replace (&self->overlay, NULL);
+  nns_ex_overlay_free (self->spans);
+  nns_ex_overlay_free (self->next);
+
+  G_OBJECT_CLASS (nns_ex_sparse_overlay_parent_class)->finalize (object);
+}
+
+/**
+ * @brief Initialize the element class.
+ */
+static void
+nns_ex_sparse_overlay_class_init (NnsExSparseOverlayClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+
+  GST_DEBUG_CATEGORY_INIT (nns_ex_sparse_overlay_debug,
+      NNS_EX_SPARSE_OVERLAY_NAME, 0, "Sparse overlay of the detection results");
+
+  gobject_class->finalize = nns_ex_sparse_overlay_finalize;
+  element_class->change_state = nns_ex_sparse_overlay_change_state;
+
+  gst_element_class_add_static_pad_template (element_class,
+      &video_sink_template);
+  gst_element_class_add_static_pad_template (element_class,
+      &overlay_sink_template);
+  gst_element_class_add_static_pad_template (element_class, &src_template);
+
+  gst_element_class_set_static_metadata (element_class,
+      "Sparse overlay", "Filter/Editor/Video",
+      "Draws the visible pixels of the RGBA overlay onto the video in place",
+      "agent <agent@local>");
+}
+
+/**
+ * @brief Initialize the element.
+ */
+static void
+nns_ex_sparse_overlay_init (NnsExSparseOverlay * self)
+{
+  self->video_sinkpad =
+      gst_pad_new_from_static_template (&video_sink_template, "video_sink");
+  gst_pad_set_chain_function (self->video_sinkpad,
+      nns_ex_sparse_overlay_video_chain);
+  gst_pad_set_event_function (self->video_sinkpad,
+      nns_ex_sparse_overlay_video_event);
+  GST_PAD_SET_PROXY_CAPS (self->video_sinkpad);
+  GST_PAD_SET_PROXY_ALLOCATION (self->video_sinkpad);
+  gst_element_add_pad (GST_ELEMENT (self), self->video_sinkpad);
+
+  self->overlay_sinkpad =
+      gst_pad_new_from_static_template (&overlay_sink_template,
+      "overlay_sink");
+  gst_pad_set_chain_function (self->overlay_sinkpad,
+      nns_ex_sparse_overlay_overlay_chain);
+  gst_pad_set_event_function (self->overlay_sinkpad,
+      nns_ex_sparse_overlay_overlay_event);
+  gst_element_add_pad (GST_ELEMENT (self), self->overlay_sinkpad);
+
+  self->srcpad = gst_pad_new_from_static_template (&src_template, "src");
+  gst_pad_set_event_function (self->srcpad, nns_ex_sparse_overlay_src_event);
+  GST_PAD_SET_PROXY_CAPS (self->srcpad);
+  gst_element_add_pad (GST_ELEMENT (self), self->srcpad);
+
+  self->video_valid = self->overlay_valid = FALSE;
+  self->spans = nns_ex_overlay_new ();
+  self->next = nns_ex_overlay_new ();
+  self->overlay = NULL;
+}
+
+/**
+ * @brief Register the element 'nns_ex_sparse_overlay' to the application.
+ */
+gboolean
+nns_ex_sparse_overlay_register (void)
+{
+  return gst_element_register (NULL, NNS_EX_SPARSE_OVERLAY_NAME, GST_RANK_NONE,
+      nns_ex_sparse_overlay_get_type ());
+}
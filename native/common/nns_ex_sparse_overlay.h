@@ -0,0 +1,58 @@
+/**
+ * @file	nns_ex_sparse_overlay.h
+ * @date	19 October 2026
+ * @brief	Element to draw the overlay only on the visible pixels, instead of compositor
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * The element 'nns_ex_sparse_overlay' replaces
+ * 'compositor name=mix sink_0::zorder=2 sink_1::zorder=1' (or videomixer) mixing the video
+ * and the RGBA overlay of 'tensor_decoder mode=bounding_boxes'.
+ * When a new overlay frame arrives, the element makes the spans of the visible pixels (see nns_ex_overlay.h),
+ * and blends only the spans onto each video frame in place. The latest overlay is kept until the next one.
+ *
+ * Usage :
+ *
+ * (application)
+ * gst_init (&argc, &argv);
+ * nns_ex_sparse_overlay_register ();
+ *
+ * (gst-launch, the plugin 'nnsexample' in GST_PLUGIN_PATH)
+ * ... ! tensor_decoder mode=bounding_boxes ... option4=640:480 ! queue leaky=2 ! mix.overlay_sink
+ * t. ! queue ! nns_ex_sparse_overlay name=mix ! videoconvert ! ximagesink
+ *
+ * Pads :
+ * video_sink : packed RGB video (RGB, BGR, RGBx, BGRx, xRGB, xBGR, RGBA, BGRA, ARGB, ABGR)
+ * overlay_sink : RGBA overlay, scaled to the video with the nearest pixel if the size is different
+ * src : the video with the overlay
+ */
+
+#ifndef __NNS_EX_SPARSE_OVERLAY_H__
+#define __NNS_EX_SPARSE_OVERLAY_H__
+
+#include <glib.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Name of the element.
+ */
+#define NNS_EX_SPARSE_OVERLAY_NAME "nns_ex_sparse_overlay"
+
+/**
+ * @brief Get the type of the element.
+ */
+extern GType
+nns_ex_sparse_overlay_get_type (void);
+
+/**
+ * @brief Register the element 'nns_ex_sparse_overlay' to the application.
+ * @return TRUE if the element is registered
+ */
+extern gboolean
+nns_ex_sparse_overlay_register (void);
+
+G_END_DECLS
+
+#endif /* __NNS_EX_SPARSE_OVERLAY_H__ */
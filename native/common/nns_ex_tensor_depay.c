@@ -0,0 +1,536 @@
+/**
+ * @file	nns_ex_tensor_depay.c
+ * @date	19 October 2026
+ * @brief	Element to get the buffers with the caps and timestamp from the framed TCP stream
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ */
+
+#include <string.h>
+#include <gst/base/gstadapter.h>
+
+#include "nns_ex_transport.h"
+
+GST_DEBUG_CATEGORY_STATIC (nns_ex_tensor_depay_debug);
+#define GST_CAT_DEFAULT nns_ex_tensor_depay_debug
+
+/**
+ * @brief Max size of the caps string, larger one is an invalid frame.
+ */
+#define DEPAY_MAX_CAPS_SIZE 4096
+
+/**
+ * @brief Default max size of the frame (raw size of the buffer), larger one is an invalid frame.
+ */
+#define DEPAY_DEFAULT_MAX_FRAME_SIZE (64 * 1024 * 1024)
+
+/**
+ * @brief Properties.
+ */
+enum
+{
+  PROP_0,
+  PROP_MAX_FRAME_SIZE,
+  PROP_FRAMES,
+  PROP_LOST,
+  PROP_RESYNC
+};
+
+/**
+ * @brief Data structure for the element.
+ */
+typedef struct
+{
+  GstElement parent; /**< parent object */
+
+  GstPad *sinkpad; /**< sink pad */
+  GstPad *srcpad; /**< src pad */
+
+  GstAdapter *adapter; /**< bytes of the stream */
+  gchar *caps_str; /**< caps string of the last frame */
+  gboolean need_segment; /**< push the time segment before the next frame */
+  gboolean discont; /**< the next frame is discontinuous */
+  gboolean have_seq; /**< true if a frame is received */
+  guint32 next_seq; /**< sequence number of the next frame */
+  guint max_frame_size; /**< max size of the frame (protected by the object lock) */
+
+  guint64 frames; /**< count of the received frames */
+  guint64 lost; /**< count of the lost frames */
+  guint64 resync; /**< bytes skipped to find the next frame */
+} NnsExTensorDepay;
+
+/**
+ * @brief Data structure for the element class.
+ */
+typedef struct
+{
+  GstElementClass parent_class; /**< parent class */
+} NnsExTensorDepayClass;
+
+G_DEFINE_TYPE (NnsExTensorDepay, nns_ex_tensor_depay, GST_TYPE_ELEMENT);
+
+static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (NNS_EX_TRANSPORT_CAPS));
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+/**
+ * @brief Clear the stream.
+ */
+static void
+_tensor_depay_reset (NnsExTensorDepay * self)
+{
+  gst_adapter_clear (self->adapter);
+  g_free (self->caps_str);
+  self->caps_str = NULL;
+  self->need_segment = TRUE;
+  self->discont = TRUE;
+  self->have_seq = FALSE;
+  self->next_seq = 0;
+
+  GST_OBJECT_LOCK (self);
+  self->frames = self->lost = self->resync = 0;
+  GST_OBJECT_UNLOCK (self);
+}
+
+/**
+ * @brief Skip the invalid frame to the next magic number, returns FALSE if more bytes are needed.
+ */
+static gboolean
+_tensor_depay_resync (NnsExTensorDepay * self)
+{
+  gsize avail, skip;
+  gssize offset = -1;
+
+  /* the magic number of the invalid frame */
+  gst_adapter_flush (self->adapter, 1);
+  avail = gst_adapter_available (self->adapter);
+
+  if (avail >= 4)
+    offset = gst_adapter_masked_scan_uint32 (self->adapter, 0xffffffff,
+        NNS_EX_TRANSPORT_MAGIC, 0, avail);
+
+  /* keep the last 3 bytes, the start of the next magic number */
+  if (offset >= 0)
+    skip = (gsize) offset;
+  else
+    skip = (avail > 3) ? avail - 3 : 0;
+
+  gst_adapter_flush (self->adapter, skip);
+
+  GST_OBJECT_LOCK (self);
+  self->resync += skip + 1;
+  GST_OBJECT_UNLOCK (self);
+
+  GST_WARNING_OBJECT (self, "skipped %" G_GSIZE_FORMAT " bytes", skip + 1);
+  self->discont = TRUE;
+  return (offset >= 0);
+}
+
+/**
+ * @brief Check the sizes in the header, the payload of a corrupted header would never complete.
+ */
+static gboolean
+_tensor_depay_check_header (NnsExTensorDepay * self,
+    const nns_ex_transport_header_s * header)
+{
+  guint max_frame_size;
+
+  GST_OBJECT_LOCK (self);
+  max_frame_size = self->max_frame_size;
+  GST_OBJECT_UNLOCK (self);
+
+  if (header->caps_size == 0 || header->caps_size > DEPAY_MAX_CAPS_SIZE)
+    return FALSE;
+
+  if (header->raw_size > max_frame_size)
+    return FALSE;
+
+  /* the compressed payload is smaller than the raw size (sent raw if not) */
+  if (header->codec == NNS_EX_TRANSPORT_CODEC_NONE)
+    return (header->payload_size == header->raw_size);
+
+  return (header->payload_size <= header->raw_size);
+}
+
+/**
+ * @brief Set the caps of the frame if they are changed.
+ */
+static gboolean
+_tensor_depay_set_caps (NnsExTensorDepay * self, guint32 caps_size)
+{
+  const gchar *str;
+  GstCaps *caps;
+  gboolean ret = TRUE;
+
+  str = (const gchar *) gst_adapter_map (self->adapter, caps_size);
+
+  if (str[caps_size - 1] != '\0') {
+    gst_adapter_unmap (self->adapter);
+    return FALSE;
+  }
+
+  if (g_strcmp0 (str, self->caps_str) != 0) {
+    caps = gst_caps_from_string (str);
+
+    if (caps && gst_caps_is_fixed (caps)) {
+      GST_DEBUG_OBJECT (self, "caps of the frames %" GST_PTR_FORMAT, caps);
+      ret = gst_pad_set_caps (self->srcpad, caps);
+
+      g_free (self->caps_str);
+      self->caps_str = g_strdup (str);
+    } else {
+      ret = FALSE;
+    }
+
+    if (caps)
+      gst_caps_unref (caps);
+  }
+
+  gst_adapter_unmap (self->adapter);
+  return ret;
+}
+
+/**
+ * @brief Get the payload of the frame.
+ */
+static GstBuffer *
+_tensor_depay_payload (NnsExTensorDepay * self,
+    const nns_ex_transport_header_s * header)
+{
+  GstBuffer *buffer;
+  GstMapInfo map;
+  const guint8 *data;
+  gboolean ret;
+
+  /* the raw payload is not copied if it is in a single memory */
+  if (header->codec == NNS_EX_TRANSPORT_CODEC_NONE)
+    return gst_adapter_take_buffer (self->adapter, header->payload_size);
+
+  buffer = gst_buffer_new_allocate (NULL, header->raw_size, NULL);
+  if (!gst_buffer_map (buffer, &map, GST_MAP_WRITE)) {
+    gst_buffer_unref (buffer);
+    return NULL;
+  }
+
+  data = gst_adapter_map (self->adapter, header->payload_size);
+  ret = nns_ex_transport_decompress (header->codec, data,
+      header->payload_size, map.data, header->raw_size);
+  gst_adapter_unmap (self->adapter);
+  gst_adapter_flush (self->adapter, header->payload_size);
+  gst_buffer_unmap (buffer, &map);
+
+  if (!ret) {
+    GST_WARNING_OBJECT (self, "failed to decompress the payload (%s)",
+        nns_ex_transport_codec_to_string (header->codec));
+    gst_buffer_unref (buffer);
+    return NULL;
+  }
+
+  return buffer;
+}
+
+/**
+ * @brief Push the time segment, the timestamps of the frames are of the sender.
+ */
+static void
+_tensor_depay_push_segment (NnsExTensorDepay * self)
+{
+  GstSegment segment;
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (self->srcpad, gst_event_new_segment (&segment));
+  self->need_segment = FALSE;
+}
+
+/**
+ * @brief Get the frames from the bytes of the stream.
+ */
+static GstFlowReturn
+nns_ex_tensor_depay_chain (GstPad * pad, GstObject * parent,
+    GstBuffer * buffer)
+{
+  NnsExTensorDepay *self = (NnsExTensorDepay *) parent;
+  nns_ex_transport_header_s header;
+  GstBuffer *outbuf;
+  const guint8 *data;
+  gsize total;
+  gboolean valid;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  if (GST_BUFFER_IS_DISCONT (buffer)) {
+    gst_adapter_clear (self->adapter);
+    self->discont = TRUE;
+  }
+
+  gst_adapter_push (self->adapter, buffer);
+
+  while (ret == GST_FLOW_OK &&
+      gst_adapter_available (self->adapter) >= NNS_EX_TRANSPORT_HEADER_SIZE) {
+    data = gst_adapter_map (self->adapter, NNS_EX_TRANSPORT_HEADER_SIZE);
+    valid = nns_ex_transport_header_read (data, &header);
+    gst_adapter_unmap (self->adapter);
+
+    if (valid && !_tensor_depay_check_header (self, &header)) {
+      GST_WARNING_OBJECT (self, "invalid header of the frame %u (caps %u, "
+          "raw %u, payload %u bytes)", header.seq, header.caps_size,
+          header.raw_size, header.payload_size);
+      valid = FALSE;
+    }
+
+    if (!valid) {
+      if (!_tensor_depay_resync (self))
+        break;
+      continue;
+    }
+
+    total = NNS_EX_TRANSPORT_HEADER_SIZE + header.caps_size +
+        (gsize) header.payload_size;
+    if (gst_adapter_available (self->adapter) < total)
+      break;
+
+    gst_adapter_flush (self->adapter, NNS_EX_TRANSPORT_HEADER_SIZE);
+
+    if (!_tensor_depay_set_caps (self, header.caps_size)) {
+      GST_ELEMENT_ERROR (self, STREAM, FORMAT, (NULL),
+          ("invalid caps in the frame %u", header.seq));
+      return GST_FLOW_NOT_NEGOTIATED;
+    }
+
+    gst_adapter_flush (self->adapter, header.caps_size);
+
+    outbuf = _tensor_depay_payload (self, &header);
+    if (outbuf == NULL) {
+      self->discont = TRUE;
+      continue;
+    }
+
+    /* the gap of the sequence number (the sender restarts from 0) */
+    if (self->have_seq && header.seq != self->next_seq && !(header.seq == 0 &&
+            (header.flags & NNS_EX_TRANSPORT_FLAG_DISCONT))) {
+      GST_OBJECT_LOCK (self);
+      self->lost += (guint32) (header.seq - self->next_seq);
+      GST_OBJECT_UNLOCK (self);
+      self->discont = TRUE;
+    }
+
+    self->have_seq = TRUE;
+    self->next_seq = header.seq + 1;
+
+    GST_BUFFER_PTS (outbuf) = header.pts;
+    GST_BUFFER_DTS (outbuf) = GST_CLOCK_TIME_NONE;
+    GST_BUFFER_DURATION (outbuf) = header.duration;
+    GST_BUFFER_OFFSET (outbuf) = header.seq;
+
+    if (self->discont || (header.flags & NNS_EX_TRANSPORT_FLAG_DISCONT))
+      GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_DISCONT);
+    if (header.flags & NNS_EX_TRANSPORT_FLAG_DELTA_UNIT)
+      GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_DELTA_UNIT);
+    self->discont = FALSE;
+
+    GST_OBJECT_LOCK (self);
+    self->frames++;
+    GST_OBJECT_UNLOCK (self);
+
+    if (self->need_segment)
+      _tensor_depay_push_segment (self);
+
+    ret = gst_pad_push (self->srcpad, outbuf);
+  }
+
+  return ret;
+}
+
+/**
+ * @brief Handle the events of the sink pad.
+ */
+static gboolean
+nns_ex_tensor_depay_sink_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  NnsExTensorDepay *self = (NnsExTensorDepay *) parent;
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_CAPS:
+    case GST_EVENT_SEGMENT:
+      /* the caps are in the frames, and the segment of the bytes is not for the frames */
+      gst_event_unref (event);
+      return TRUE;
+    case GST_EVENT_FLUSH_STOP:
+      gst_adapter_clear (self->adapter);
+      self->need_segment = TRUE;
+      self->discont = TRUE;
+      break;
+    default:
+      break;
+  }
+
+  return gst_pad_event_default (pad, parent, event);
+}
+
+/**
+ * @brief Clear the stream when the element starts or stops.
+ */
+static GstStateChangeReturn
+nns_ex_tensor_depay_change_state (GstElement * element,
+    GstStateChange transition)
+{
+  NnsExTensorDepay *self = (NnsExTensorDepay *) element;
+
+  if (transition == GST_STATE_CHANGE_READY_TO_PAUSED)
+    _tensor_depay_reset (self);
+
+  return GST_ELEMENT_CLASS (nns_ex_tensor_depay_parent_class)->change_state
+      (element, transition);
+}
+
+/**
+ * @brief Set the property.
+ */
+static void
+nns_ex_tensor_depay_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  NnsExTensorDepay *self = (NnsExTensorDepay *) object;
+
+  switch (prop_id) {
+    case PROP_MAX_FRAME_SIZE:
+      GST_OBJECT_LOCK (self);
+      self->max_frame_size = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+/**
+ * @brief Get the property.
+ */
+static void
+nns_ex_tensor_depay_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  NnsExTensorDepay *self = (NnsExTensorDepay *) object;
+
+  GST_OBJECT_LOCK (self);
+
+  switch (prop_id) {
+    case PROP_MAX_FRAME_SIZE:
+      g_value_set_uint (value, self->max_frame_size);
+      break;
+    case PROP_FRAMES:
+      g_value_set_uint64 (value, self->frames);
+      break;
+    case PROP_LOST:
+      g_value_set_uint64 (value, self->lost);
+      break;
+    case PROP_RESYNC:
+      g_value_set_uint64 (value, self->resync);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+
+  GST_OBJECT_UNLOCK (self);
+}
+
+/**
+ * @brief Finalize the element.
+ */
+static void
+nns_ex_tensor_depay_finalize (GObject * object)
+{
+  NnsExTensorDepay *self = (NnsExTensorDepay *) object;
+
+  g_free (self->caps_str);
+  g_object_unref (self->adapter);
+
+  G_OBJECT_CLASS (nns_ex_tensor_depay_parent_class)->finalize (object);
+}
+
+/**
+ * @brief Initialize the element class.
+ */
+static void
+nns_ex_tensor_depay_class_init (NnsExTensorDepayClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+
+  GST_DEBUG_CATEGORY_INIT (nns_ex_tensor_depay_debug,
+      NNS_EX_TENSOR_DEPAY_NAME, 0, "Framing of the tensors for TCP");
+
+  gobject_class->set_property = nns_ex_tensor_depay_set_property;
+  gobject_class->get_property = nns_ex_tensor_depay_get_property;
+  gobject_class->finalize = nns_ex_tensor_depay_finalize;
+
+  g_object_class_install_property (gobject_class, PROP_MAX_FRAME_SIZE,
+      g_param_spec_uint ("max-frame-size", "Max frame size",
+          "Max size of the frame in bytes, the larger frame is invalid",
+          1, G_MAXUINT32, DEPAY_DEFAULT_MAX_FRAME_SIZE,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_FRAMES,
+      g_param_spec_uint64 ("frames", "Frames", "Count of the received frames",
+          0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_LOST,
+      g_param_spec_uint64 ("lost", "Lost",
+          "Count of the lost frames (gap of the sequence number)",
+          0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_RESYNC,
+      g_param_spec_uint64 ("resync", "Resync",
+          "Bytes skipped to find the next frame",
+          0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  gst_element_class_set_static_metadata (element_class,
+      "NNStreamer example tensor depayloader", "Codec/Depayloader/Network",
+      "Gets the buffers with the caps and timestamp from the framed stream "
+      "of tcpclientsrc", "agent <agent@local>");
+
+  gst_element_class_add_static_pad_template (element_class, &sink_template);
+  gst_element_class_add_static_pad_template (element_class, &src_template);
+
+  element_class->change_state =
+      GST_DEBUG_FUNCPTR (nns_ex_tensor_depay_change_state);
+}
+
+/**
+ * @brief Initialize the element.
+ */
+static void
+nns_ex_tensor_depay_init (NnsExTensorDepay * self)
+{
+  self->sinkpad = gst_pad_new_from_static_template (&sink_template, "sink");
+  gst_pad_set_chain_function (self->sinkpad,
+      GST_DEBUG_FUNCPTR (nns_ex_tensor_depay_chain));
+  gst_pad_set_event_function (self->sinkpad,
+      GST_DEBUG_FUNCPTR (nns_ex_tensor_depay_sink_event));
+  gst_element_add_pad (GST_ELEMENT (self), self->sinkpad);
+
+  self->srcpad = gst_pad_new_from_static_template (&src_template, "src");
+  gst_pad_use_fixed_caps (self->srcpad);
+  gst_element_add_pad (GST_ELEMENT (self), self->srcpad);
+
+  self->adapter = gst_adapter_new ();
+  self->caps_str = NULL;
+  self->max_frame_size = DEPAY_DEFAULT_MAX_FRAME_SIZE;
+  _tensor_depay_reset (self);
+}
+
+/**
+ * @brief Register the element 'nns_ex_tensor_depay' to the application.
+ */
+gboolean
+nns_ex_tensor_depay_register (void)
+{
+  return gst_element_register (NULL, NNS_EX_TENSOR_DEPAY_NAME, GST_RANK_NONE,
+      nns_ex_tensor_depay_get_type ());
+}
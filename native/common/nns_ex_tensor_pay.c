@@ -0,0 +1,411 @@
+/**
+ * @file	nns_ex_tensor_pay.c
+ * @date	19 October 2026
+ * @brief	Element to frame the buffers with the caps, sequence number and timestamp for TCP
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ */
+
+#include <string.h>
+
+#include "nns_ex_transport.h"
+
+GST_DEBUG_CATEGORY_STATIC (nns_ex_tensor_pay_debug);
+#define GST_CAT_DEFAULT nns_ex_tensor_pay_debug
+
+/**
+ * @brief Default compression level (acceleration of LZ4, level of zstd).
+ */
+#define DEFAULT_LEVEL 1
+
+/**
+ * @brief Properties.
+ */
+enum
+{
+  PROP_0,
+  PROP_COMPRESSION,
+  PROP_LEVEL
+};
+
+/**
+ * @brief Data structure for the element.
+ */
+typedef struct
+{
+  GstElement parent; /**< parent object */
+
+  GstPad *sinkpad; /**< sink pad */
+  GstPad *srcpad; /**< src pad */
+
+  nns_ex_transport_codec_e codec; /**< compression of the payload */
+  gint level; /**< compression level */
+
+  gchar *caps_str; /**< caps of the sink pad, sent in each frame */
+  guint32 caps_size; /**< size of the caps string (with the terminating null) */
+  guint32 seq; /**< sequence number of the next frame */
+  gboolean discont; /**< the next frame is discontinuous */
+} NnsExTensorPay;
+
+/**
+ * @brief Data structure for the element class.
+ */
+typedef struct
+{
+  GstElementClass parent_class; /**< parent class */
+} NnsExTensorPayClass;
+
+G_DEFINE_TYPE (NnsExTensorPay, nns_ex_tensor_pay, GST_TYPE_ELEMENT);
+
+static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (NNS_EX_TRANSPORT_CAPS));
+
+/**
+ * @brief Clear the caps and the sequence number.
+ */
+static void
+_tensor_pay_reset (NnsExTensorPay * self)
+{
+  g_free (self->caps_str);
+  self->caps_str = NULL;
+  self->caps_size = 0;
+  self->seq = 0;
+  self->discont = TRUE;
+}
+
+/**
+ * @brief Make the header and the caps of the frame.
+ */
+static GstMemory *
+_tensor_pay_header (NnsExTensorPay * self, GstBuffer * buffer,
+    nns_ex_transport_codec_e codec, gsize raw_size, gsize payload_size)
+{
+  nns_ex_transport_header_s header;
+  GstMemory *mem;
+  GstMapInfo map;
+
+  mem = gst_allocator_alloc (NULL, NNS_EX_TRANSPORT_HEADER_SIZE +
+      self->caps_size, NULL);
+  if (!gst_memory_map (mem, &map, GST_MAP_WRITE)) {
+    gst_memory_unref (mem);
+    return NULL;
+  }
+
+  header.codec = codec;
+  header.flags = 0;
+  if (self->discont || GST_BUFFER_IS_DISCONT (buffer))
+    header.flags |= NNS_EX_TRANSPORT_FLAG_DISCONT;
+  if (GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT))
+    header.flags |= NNS_EX_TRANSPORT_FLAG_DELTA_UNIT;
+  header.seq = self->seq++;
+  header.pts = GST_BUFFER_PTS (buffer);
+  header.duration = GST_BUFFER_DURATION (buffer);
+  header.caps_size = self->caps_size;
+  header.raw_size = (guint32) raw_size;
+  header.payload_size = (guint32) payload_size;
+
+  nns_ex_transport_header_write (&header, map.data);
+  memcpy (map.data + NNS_EX_TRANSPORT_HEADER_SIZE, self->caps_str,
+      self->caps_size);
+
+  gst_memory_unmap (mem, &map);
+  self->discont = FALSE;
+  return mem;
+}
+
+/**
+ * @brief Compress the buffer, returns NULL if the payload is not smaller.
+ */
+static GstMemory *
+_tensor_pay_compress (NnsExTensorPay * self, GstBuffer * buffer,
+    gsize * payload_size)
+{
+  GstMemory *mem = NULL;
+  GstMapInfo in, out;
+  gsize bound, size = 0;
+
+  if (!gst_buffer_map (buffer, &in, GST_MAP_READ))
+    return NULL;
+
+  bound = nns_ex_transport_compress_bound (self->codec, in.size);
+  if (bound > 0) {
+    mem = gst_allocator_alloc (NULL, bound, NULL);
+
+    if (gst_memory_map (mem, &out, GST_MAP_WRITE)) {
+      size = nns_ex_transport_compress (self->codec, self->level, in.data,
+          in.size, out.data, bound);
+      gst_memory_unmap (mem, &out);
+    }
+  }
+
+  gst_buffer_unmap (buffer, &in);
+
+  if (size == 0) {
+    if (mem)
+      gst_memory_unref (mem);
+    return NULL;
+  }
+
+  gst_memory_resize (mem, 0, size);
+  *payload_size = size;
+  return mem;
+}
+
+/**
+ * @brief Frame the buffer.
+ */
+static GstFlowReturn
+nns_ex_tensor_pay_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  NnsExTensorPay *self = (NnsExTensorPay *) parent;
+  GstBuffer *outbuf;
+  GstMemory *header, *payload = NULL;
+  nns_ex_transport_codec_e codec = NNS_EX_TRANSPORT_CODEC_NONE;
+  gsize raw_size, payload_size;
+
+  if (self->caps_str == NULL) {
+    GST_ELEMENT_ERROR (self, CORE, NEGOTIATION, (NULL),
+        ("the caps are not negotiated"));
+    gst_buffer_unref (buffer);
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+
+  raw_size = payload_size = gst_buffer_get_size (buffer);
+  if (raw_size > G_MAXUINT32) {
+    GST_ELEMENT_ERROR (self, STREAM, FORMAT, (NULL),
+        ("the buffer is too large (%" G_GSIZE_FORMAT ")", raw_size));
+    gst_buffer_unref (buffer);
+    return GST_FLOW_ERROR;
+  }
+
+  if (self->codec != NNS_EX_TRANSPORT_CODEC_NONE) {
+    payload = _tensor_pay_compress (self, buffer, &payload_size);
+    if (payload)
+      codec = self->codec;
+  }
+
+  header = _tensor_pay_header (self, buffer, codec, raw_size, payload_size);
+  if (header == NULL) {
+    if (payload)
+      gst_memory_unref (payload);
+    gst_buffer_unref (buffer);
+    return GST_FLOW_ERROR;
+  }
+
+  outbuf = gst_buffer_new ();
+  gst_buffer_append_memory (outbuf, header);
+
+  if (payload) {
+    gst_buffer_append_memory (outbuf, payload);
+  } else {
+    /* the raw payload is not copied, the sink writes the memories of the input */
+    gst_buffer_copy_into (outbuf, buffer, GST_BUFFER_COPY_MEMORY, 0, -1);
+  }
+
+  gst_buffer_copy_into (outbuf, buffer, GST_BUFFER_COPY_TIMESTAMPS, 0, -1);
+  gst_buffer_unref (buffer);
+
+  return gst_pad_push (self->srcpad, outbuf);
+}
+
+/**
+ * @brief Handle the events of the sink pad.
+ */
+static gboolean
+nns_ex_tensor_pay_sink_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  NnsExTensorPay *self = (NnsExTensorPay *) parent;
+  GstCaps *caps, *outcaps;
+  gboolean ret;
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_CAPS:
+      gst_event_parse_caps (event, &caps);
+
+      g_free (self->caps_str);
+      self->caps_str = gst_caps_to_string (caps);
+      self->caps_size = (guint32) strlen (self->caps_str) + 1;
+      GST_DEBUG_OBJECT (self, "caps of the frames %s", self->caps_str);
+      gst_event_unref (event);
+
+      /* the caps of the frames are in each frame */
+      outcaps = gst_caps_from_string (NNS_EX_TRANSPORT_CAPS);
+      ret = gst_pad_set_caps (self->srcpad, outcaps);
+      gst_caps_unref (outcaps);
+      return ret;
+    case GST_EVENT_FLUSH_STOP:
+      self->discont = TRUE;
+      break;
+    default:
+      break;
+  }
+
+  return gst_pad_event_default (pad, parent, event);
+}
+
+/**
+ * @brief Clear the state when the element starts or stops.
+ */
+static GstStateChangeReturn
+nns_ex_tensor_pay_change_state (GstElement * element,
+    GstStateChange transition)
+{
+  NnsExTensorPay *self = (NnsExTensorPay *) element;
+
+  if (transition == GST_STATE_CHANGE_READY_TO_PAUSED)
+    _tensor_pay_reset (self);
+
+  return GST_ELEMENT_CLASS (nns_ex_tensor_pay_parent_class)->change_state
+      (element, transition);
+}
+
+/**
+ * @brief Set the property.
+ */
+static void
+nns_ex_tensor_pay_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  NnsExTensorPay *self = (NnsExTensorPay *) object;
+  nns_ex_transport_codec_e codec;
+  const gchar *name;
+
+  switch (prop_id) {
+    case PROP_COMPRESSION:
+      name = g_value_get_string (value);
+      codec = nns_ex_transport_codec_from_string (name);
+
+      if (codec == NNS_EX_TRANSPORT_CODEC_UNKNOWN) {
+        GST_WARNING_OBJECT (self, "unknown compression %s (none, lz4, zstd)",
+            name);
+      } else if (!nns_ex_transport_codec_supported (codec)) {
+        GST_WARNING_OBJECT (self, "%s is not built, no compression", name);
+        self->codec = NNS_EX_TRANSPORT_CODEC_NONE;
+      } else {
+        self->codec = codec;
+      }
+      break;
+    case PROP_LEVEL:
+      self->level = g_value_get_int (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+/**
+ * @brief Get the property.
+ */
+static void
+nns_ex_tensor_pay_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  NnsExTensorPay *self = (NnsExTensorPay *) object;
+
+  switch (prop_id) {
+    case PROP_COMPRESSION:
+      g_value_set_string (value,
+          nns_ex_transport_codec_to_string (self->codec));
+      break;
+    case PROP_LEVEL:
+      g_value_set_int (value, self->level);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+/**
+ * @brief Finalize the element.
+ */
+static void
+nns_ex_tensor_pay_finalize (GObject * object)
+{
+  _tensor_pay_reset ((NnsExTensorPay *) object);
+
+  G_OBJECT_CLASS (nns_ex_tensor_pay_parent_class)->finalize (object);
+}
+
+/**
+ * @brief Initialize the element class.
+ */
+static void
+nns_ex_tensor_pay_class_init (NnsExTensorPayClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+
+  GST_DEBUG_CATEGORY_INIT (nns_ex_tensor_pay_debug, NNS_EX_TENSOR_PAY_NAME, 0,
+      "Framing of the tensors for TCP");
+
+  gobject_class->set_property = nns_ex_tensor_pay_set_property;
+  gobject_class->get_property = nns_ex_tensor_pay_get_property;
+  gobject_class->finalize = nns_ex_tensor_pay_finalize;
+
+  g_object_class_install_property (gobject_class, PROP_COMPRESSION,
+      g_param_spec_string ("compression", "Compression",
+          "Compression of the payload (none, lz4 or zstd)", "none",
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_LEVEL,
+      g_param_spec_int ("level", "Level",
+          "Compression level (acceleration of LZ4, level of zstd)",
+          1, 65537, DEFAULT_LEVEL,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+
+  gst_element_class_set_static_metadata (element_class,
+      "NNStreamer example tensor payloader", "Codec/Payloader/Network",
+      "Frames the buffers with the caps, sequence number and timestamp "
+      "(optionally compressed) for tcpserversink",
+      "agent <agent@local>");
+
+  gst_element_class_add_static_pad_template (element_class, &sink_template);
+  gst_element_class_add_static_pad_template (element_class, &src_template);
+
+  element_class->change_state =
+      GST_DEBUG_FUNCPTR (nns_ex_tensor_pay_change_state);
+}
+
+/**
+ * @brief Initialize the element.
+ */
+static void
+nns_ex_tensor_pay_init (NnsExTensorPay * self)
+{
+  self->sinkpad = gst_pad_new_from_static_template (&sink_template, "sink");
+  gst_pad_set_chain_function (self->sinkpad,
+      GST_DEBUG_FUNCPTR (nns_ex_tensor_pay_chain));
+  gst_pad_set_event_function (self->sinkpad,
+      GST_DEBUG_FUNCPTR (nns_ex_tensor_pay_sink_event));
+  gst_element_add_pad (GST_ELEMENT (self), self->sinkpad);
+
+  self->srcpad = gst_pad_new_from_static_template (&src_template, "src");
+  gst_pad_use_fixed_caps (self->srcpad);
+  gst_element_add_pad (GST_ELEMENT (self), self->srcpad);
+
+  self->codec = NNS_EX_TRANSPORT_CODEC_NONE;
+  self->level = DEFAULT_LEVEL;
+  self->caps_str = NULL;
+  _tensor_pay_reset (self);
+}
+
+/**
+ * @brief Register the element 'nns_ex_tensor_pay' to the application.
+ */
+gboolean
+nns_ex_tensor_pay_register (void)
+{
+  return gst_element_register (NULL, NNS_EX_TENSOR_PAY_NAME, GST_RANK_NONE,
+      nns_ex_tensor_pay_get_type ());
+}
@@ -0,0 +1,315 @@
+/**
+ * @file	nns_ex_tensor_ring.c
+ * @date	19 October 2026
+ * @brief	Pull-mode consumer of tensor_sink with a bounded ring of buffers
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ */
+
+#include "nns_ex_tensor_ring.h"
+
+/**
+ * @brief Data structure for the ring.
+ *
+ * 'head' is written by the producer only. 'tail' is advanced by the consumer,
+ * and by the producer when it drops the oldest buffer, so both advance 'tail' with compare-and-exchange.
+ * The mutex and condition are used only when a thread has to wait.
+ */
+struct _nns_ex_tensor_ring_s
+{
+  gpointer *slots; /**< buffers */
+  guint capacity; /**< number of slots (power of 2) */
+  guint mask; /**< capacity - 1 */
+  volatile gint head; /**< total count of enqueued buffers */
+  volatile gint tail; /**< total count of dequeued or dropped buffers */
+  nns_ex_tensor_ring_policy_e policy; /**< policy when the ring is full */
+  volatile gint flushing; /**< true to stop the ring */
+
+  volatile gint waiting; /**< count of waiting threads */
+  GMutex lock; /**< lock to wait */
+  GCond cond; /**< condition to wait */
+
+  GstElement *sink; /**< tensor_sink attached */
+  gulong signal_id; /**< new-data signal handler */
+
+  volatile gint pushed; /**< count of enqueued buffers */
+  volatile gint popped; /**< count of dequeued buffers */
+  volatile gint dropped; /**< count of dropped buffers */
+  volatile gint max_occupancy; /**< max number of buffers observed */
+};
+
+/**
+ * @brief Get the number of buffers in the ring.
+ */
+static inline guint
+_ring_occupancy (nns_ex_tensor_ring_s * ring)
+{
+  return (guint) g_atomic_int_get (&ring->head) -
+      (guint) g_atomic_int_get (&ring->tail);
+}
+
+/**
+ * @brief Wake up the waiting threads.
+ */
+static void
+_ring_wake (nns_ex_tensor_ring_s * ring)
+{
+  if (g_atomic_int_get (&ring->waiting) > 0) {
+    g_mutex_lock (&ring->lock);
+    g_cond_broadcast (&ring->cond);
+    g_mutex_unlock (&ring->lock);
+  }
+}
+
+/**
+ * @brief Callback for signal new-data, enqueue the buffer.
+ */
+static void
+_ring_new_data_cb (GstElement * element, GstBuffer * buffer,
+    gpointer user_data)
+{
+  nns_ex_tensor_ring_push ((nns_ex_tensor_ring_s *) user_data,
+      gst_buffer_ref (buffer));
+}
+
+/**
+ * @brief Create new ring.
+ */
+nns_ex_tensor_ring_s *
+nns_ex_tensor_ring_new (guint capacity, nns_ex_tensor_ring_policy_e policy)
+{
+  nns_ex_tensor_ring_s *ring;
+  guint size = 1;
+
+  g_return_val_if_fail (capacity > 0 && capacity <= (1U << 16), NULL);
+
+  while (size < capacity)
+    size <<= 1;
+
+  ring = g_new0 (nns_ex_tensor_ring_s, 1);
+  ring->slots = g_new0 (gpointer, size);
+  ring->capacity = size;
+  ring->mask = size - 1;
+  ring->policy = policy;
+
+  g_mutex_init (&ring->lock);
+  g_cond_init (&ring->cond);
+
+  return ring;
+}
+
+/**
+ * @brief Free the ring and release the remaining buffers.
+ */
+void
+nns_ex_tensor_ring_free (nns_ex_tensor_ring_s * ring)
+{
+  GstBuffer *buffer;
+
+  g_return_if_fail (ring != NULL);
+
+  if (ring->sink) {
+    if (ring->signal_id > 0)
+      g_signal_handler_disconnect (ring->sink, ring->signal_id);
+    gst_object_unref (ring->sink);
+  }
+
+  while (nns_ex_tensor_ring_pop_batch (ring, &buffer, 1, 0) > 0)
+    gst_buffer_unref (buffer);
+
+  g_mutex_clear (&ring->lock);
+  g_cond_clear (&ring->cond);
+  g_free (ring->slots);
+  g_free (ring);
+}
+
+/**
+ * @brief Enqueue the buffers from the 'new-data' signal of tensor_sink.
+ */
+gboolean
+nns_ex_tensor_ring_attach (nns_ex_tensor_ring_s * ring, GstElement * sink)
+{
+  g_return_val_if_fail (ring != NULL, FALSE);
+  g_return_val_if_fail (GST_IS_ELEMENT (sink), FALSE);
+  g_return_val_if_fail (ring->sink == NULL, FALSE);
+
+  ring->signal_id = g_signal_connect (sink, "new-data",
+      G_CALLBACK (_ring_new_data_cb), ring);
+  if (ring->signal_id == 0)
+    return FALSE;
+
+  ring->sink = gst_object_ref (sink);
+  return TRUE;
+}
+
+/**
+ * @brief Enqueue the buffer (producer).
+ */
+gboolean
+nns_ex_tensor_ring_push (nns_ex_tensor_ring_s * ring, GstBuffer * buffer)
+{
+  gpointer oldest;
+  guint head, tail, occupancy;
+
+  g_return_val_if_fail (ring != NULL, FALSE);
+  g_return_val_if_fail (buffer != NULL, FALSE);
+
+  while (TRUE) {
+    if (g_atomic_int_get (&ring->flushing)) {
+      g_atomic_int_inc (&ring->dropped);
+      gst_buffer_unref (buffer);
+      return FALSE;
+    }
+
+    head = (guint) g_atomic_int_get (&ring->head);
+    tail = (guint) g_atomic_int_get (&ring->tail);
+
+    if (head - tail < ring->capacity)
+      break;
+
+    if (ring->policy == NNS_EX_TENSOR_RING_DROP_OLDEST) {
+      /* the consumer may take the oldest at the same time */
+      oldest = g_atomic_pointer_get (&ring->slots[tail & ring->mask]);
+
+      if (g_atomic_int_compare_and_exchange (&ring->tail, (gint) tail,
+              (gint) (tail + 1))) {
+        g_atomic_int_inc (&ring->dropped);
+        gst_buffer_unref (GST_BUFFER_CAST (oldest));
+      }
+    } else {
+      /* wait until the consumer takes a buffer */
+      g_mutex_lock (&ring->lock);
+      g_atomic_int_inc (&ring->waiting);
+
+      while (_ring_occupancy (ring) >= ring->capacity &&
+          !g_atomic_int_get (&ring->flushing)) {
+        g_cond_wait (&ring->cond, &ring->lock);
+      }
+
+      g_atomic_int_add (&ring->waiting, -1);
+      g_mutex_unlock (&ring->lock);
+    }
+  }
+
+  g_atomic_pointer_set (&ring->slots[head & ring->mask], buffer);
+  g_atomic_int_set (&ring->head, (gint) (head + 1));
+  g_atomic_int_inc (&ring->pushed);
+
+  occupancy = head + 1 - tail;
+  if (occupancy > (guint) g_atomic_int_get (&ring->max_occupancy))
+    g_atomic_int_set (&ring->max_occupancy, (gint) occupancy);
+
+  _ring_wake (ring);
+  return TRUE;
+}
+
+/**
+ * @brief Dequeue the buffers (consumer).
+ */
+guint
+nns_ex_tensor_ring_pop_batch (nns_ex_tensor_ring_s * ring,
+    GstBuffer ** buffers, guint max, gint64 timeout)
+{
+  gpointer buffer;
+  gint64 end_time = 0;
+  guint head, tail;
+  guint n = 0;
+
+  g_return_val_if_fail (ring != NULL, 0);
+  g_return_val_if_fail (buffers != NULL && max > 0, 0);
+
+  if (timeout > 0)
+    end_time = g_get_monotonic_time () + timeout;
+
+  while (n < max) {
+    head = (guint) g_atomic_int_get (&ring->head);
+    tail = (guint) g_atomic_int_get (&ring->tail);
+
+    if (head == tail) {
+      /* empty, wait only if nothing is dequeued */
+      if (n > 0 || timeout == 0 || g_atomic_int_get (&ring->flushing))
+        break;
+
+      g_mutex_lock (&ring->lock);
+      g_atomic_int_inc (&ring->waiting);
+
+      while (_ring_occupancy (ring) == 0 &&
+          !g_atomic_int_get (&ring->flushing)) {
+        if (timeout < 0) {
+          g_cond_wait (&ring->cond, &ring->lock);
+        } else if (!g_cond_wait_until (&ring->cond, &ring->lock, end_time)) {
+          break;
+        }
+      }
+
+      g_atomic_int_add (&ring->waiting, -1);
+      g_mutex_unlock (&ring->lock);
+
+      if (_ring_occupancy (ring) == 0)
+        break;
+
+      continue;
+    }
+
+    buffer = g_atomic_pointer_get (&ring->slots[tail & ring->mask]);
+
+    /* the producer may drop the oldest at the same time */
+    if (g_atomic_int_compare_and_exchange (&ring->tail, (gint) tail,
+            (gint) (tail + 1))) {
+      buffers[n++] = GST_BUFFER_CAST (buffer);
+    }
+  }
+
+  if (n > 0) {
+    g_atomic_int_add (&ring->popped, (gint) n);
+
+    if (ring->policy == NNS_EX_TENSOR_RING_BLOCK)
+      _ring_wake (ring);
+  }
+
+  return n;
+}
+
+/**
+ * @brief Set the flushing state, wake up the waiting threads.
+ */
+void
+nns_ex_tensor_ring_set_flushing (nns_ex_tensor_ring_s * ring,
+    gboolean flushing)
+{
+  g_return_if_fail (ring != NULL);
+
+  g_mutex_lock (&ring->lock);
+  g_atomic_int_set (&ring->flushing, flushing ? 1 : 0);
+  g_cond_broadcast (&ring->cond);
+  g_mutex_unlock (&ring->lock);
+}
+
+/**
+ * @brief Check the ring is flushing.
+ */
+gboolean
+nns_ex_tensor_ring_is_flushing (nns_ex_tensor_ring_s * ring)
+{
+  g_return_val_if_fail (ring != NULL, TRUE);
+
+  return g_atomic_int_get (&ring->flushing) ? TRUE : FALSE;
+}
+
+/**
+ * @brief Get the occupancy metrics of the ring.
+ */
+void
+nns_ex_tensor_ring_get_stats (nns_ex_tensor_ring_s * ring,
+    nns_ex_tensor_ring_stats_s * stats)
+{
+  g_return_if_fail (ring != NULL);
+  g_return_if_fail (stats != NULL);
+
+  stats->capacity = ring->capacity;
+  stats->occupancy = _ring_occupancy (ring);
+  stats->max_occupancy = (guint) g_atomic_int_get (&ring->max_occupancy);
+  stats->pushed = (guint) g_atomic_int_get (&ring->pushed);
+  stats->popped = (guint) g_atomic_int_get (&ring->popped);
+  stats->dropped = (guint) g_atomic_int_get (&ring->dropped);
+}
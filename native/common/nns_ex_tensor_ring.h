@@ -0,0 +1,129 @@
+/**
+ * @file	nns_ex_tensor_ring.h
+ * @date	19 October 2026
+ * @brief	Pull-mode consumer of tensor_sink with a bounded ring of buffers
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * The 'new-data' callback of tensor_sink only enqueues a reference of the buffer,
+ * and the application drains the buffers in batches from its own thread.
+ * The ring has a single producer (tensor_sink streaming thread) and a single consumer.
+ *
+ * When the ring is full, the producer drops the oldest buffer (NNS_EX_TENSOR_RING_DROP_OLDEST)
+ * or waits until the consumer takes a buffer (NNS_EX_TENSOR_RING_BLOCK).
+ * With the blocking policy, set the ring flushing before stopping the pipeline,
+ * otherwise the streaming thread may wait forever.
+ *
+ * Usage :
+ *
+ * ring = nns_ex_tensor_ring_new (4, NNS_EX_TENSOR_RING_DROP_OLDEST);
+ * nns_ex_tensor_ring_attach (ring, tensor_sink);
+ *
+ * (in worker thread)
+ * while (!nns_ex_tensor_ring_is_flushing (ring)) {
+ *   n = nns_ex_tensor_ring_pop_batch (ring, buffers, 4, timeout);
+ *   (process and unref the buffers)
+ * }
+ *
+ * (to stop)
+ * nns_ex_tensor_ring_set_flushing (ring, TRUE);
+ */
+
+#ifndef __NNS_EX_TENSOR_RING_H__
+#define __NNS_EX_TENSOR_RING_H__
+
+#include <glib.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Policy when the ring is full.
+ */
+typedef enum
+{
+  NNS_EX_TENSOR_RING_DROP_OLDEST = 0,
+  NNS_EX_TENSOR_RING_BLOCK
+} nns_ex_tensor_ring_policy_e;
+
+/**
+ * @brief Occupancy metrics of the ring.
+ */
+typedef struct
+{
+  guint capacity; /**< max number of buffers in the ring */
+  guint occupancy; /**< current number of buffers in the ring */
+  guint max_occupancy; /**< max number of buffers observed in the ring */
+  guint pushed; /**< count of enqueued buffers */
+  guint popped; /**< count of dequeued buffers */
+  guint dropped; /**< count of dropped buffers */
+} nns_ex_tensor_ring_stats_s;
+
+/**
+ * @brief Handle of the ring.
+ */
+typedef struct _nns_ex_tensor_ring_s nns_ex_tensor_ring_s;
+
+/**
+ * @brief Create new ring.
+ * @param capacity max number of buffers (rounded up to power of 2)
+ * @param policy policy when the ring is full
+ */
+extern nns_ex_tensor_ring_s *
+nns_ex_tensor_ring_new (guint capacity, nns_ex_tensor_ring_policy_e policy);
+
+/**
+ * @brief Free the ring and release the remaining buffers.
+ * @note Call this after the pipeline is stopped.
+ */
+extern void
+nns_ex_tensor_ring_free (nns_ex_tensor_ring_s * ring);
+
+/**
+ * @brief Enqueue the buffers from the 'new-data' signal of tensor_sink.
+ */
+extern gboolean
+nns_ex_tensor_ring_attach (nns_ex_tensor_ring_s * ring, GstElement * sink);
+
+/**
+ * @brief Enqueue the buffer (producer).
+ * @note The ring takes the ownership of the buffer.
+ * @return FALSE if the buffer is dropped because the ring is flushing
+ */
+extern gboolean
+nns_ex_tensor_ring_push (nns_ex_tensor_ring_s * ring, GstBuffer * buffer);
+
+/**
+ * @brief Dequeue the buffers (consumer).
+ * @param buffers array to get the buffers, oldest first (caller should unref the buffers)
+ * @param max max number of buffers to dequeue
+ * @param timeout max time to wait in microseconds (0 not to wait, -1 to wait until the buffer is available)
+ * @return number of dequeued buffers, 0 if timed out or flushing
+ */
+extern guint
+nns_ex_tensor_ring_pop_batch (nns_ex_tensor_ring_s * ring,
+    GstBuffer ** buffers, guint max, gint64 timeout);
+
+/**
+ * @brief Set the flushing state, wake up the waiting threads.
+ */
+extern void
+nns_ex_tensor_ring_set_flushing (nns_ex_tensor_ring_s * ring,
+    gboolean flushing);
+
+/**
+ * @brief Check the ring is flushing.
+ */
+extern gboolean
+nns_ex_tensor_ring_is_flushing (nns_ex_tensor_ring_s * ring);
+
+/**
+ * @brief Get the occupancy metrics of the ring.
+ */
+extern void
+nns_ex_tensor_ring_get_stats (nns_ex_tensor_ring_s * ring,
+    nns_ex_tensor_ring_stats_s * stats);
+
+G_END_DECLS
+
+#endif /* __NNS_EX_TENSOR_RING_H__ */
@@ -0,0 +1,352 @@
+/**
+ * @file	nns_ex_tensor_sink.c
+ * @date	19 October 2026
+ * @brief	Helper to consume the tensors from tensor_sink with cached tensor info
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "nns_ex_tensor_sink.h"
+
+/**
+ * @brief Data structure for the tensor sink consumer.
+ */
+struct _nns_ex_tensor_sink_s
+{
+  GstPad *sink_pad; /**< sink pad of tensor sink */
+  gulong probe_id; /**< probe to watch the caps event */
+  gboolean configured; /**< true if the tensor info is parsed */
+  guint caps_seq; /**< count of negotiation */
+  nns_ex_tensors_info_s info; /**< cached tensor info */
+};
+
+/**
+ * @brief String of the element type (same order as nns_ex_tensor_type_e).
+ */
+static const gchar *tensor_type_str[] = {
+  "int32", "uint32", "int16", "uint16", "int8", "uint8",
+  "float64", "float32", "int64", "uint64", NULL
+};
+
+/**
+ * @brief Size of the element type (same order as nns_ex_tensor_type_e).
+ */
+static const gsize tensor_type_size[] = {
+  4, 4, 2, 2, 1, 1, 8, 4, 8, 8, 0
+};
+
+/**
+ * @brief Get the size of element type.
+ */
+gsize
+nns_ex_tensor_type_size (nns_ex_tensor_type_e type)
+{
+  if ((guint) type > NNS_EX_TENSOR_TYPE_UNKNOWN)
+    return 0;
+
+  return tensor_type_size[type];
+}
+
+/**
+ * @brief Get the element type from the string (e.g., 'uint8').
+ */
+nns_ex_tensor_type_e
+nns_ex_tensor_type_from_string (const gchar * str)
+{
+  gint i;
+
+  if (str == NULL)
+    return NNS_EX_TENSOR_TYPE_UNKNOWN;
+
+  for (i = 0; tensor_type_str[i] != NULL; i++) {
+    if (g_ascii_strcasecmp (str, tensor_type_str[i]) == 0)
+      return (nns_ex_tensor_type_e) i;
+  }
+
+  return NNS_EX_TENSOR_TYPE_UNKNOWN;
+}
+
+/**
+ * @brief Parse the dimension string (e.g., '3:640:480:1') and update the strides.
+ */
+static gboolean
+_tensor_info_set_dimension (nns_ex_tensor_info_s * info, const gchar * str)
+{
+  gchar **tokens;
+  gchar *end;
+  guint i, n;
+  gulong dim;
+  gboolean ret = TRUE;
+
+  tokens = g_strsplit (str, ":", NNS_EX_TENSOR_RANK_LIMIT);
+  n = g_strv_length (tokens);
+
+  for (i = 0; i < NNS_EX_TENSOR_RANK_LIMIT; i++) {
+    /* remained dimension is 1 */
+    dim = 1;
+
+    if (i < n) {
+      dim = strtoul (g_strstrip (tokens[i]), &end, 10);
+      if (*end != '\0' || dim == 0) {
+        ret = FALSE;
+        break;
+      }
+    }
+
+    info->dims[i] = (guint) dim;
+  }
+  g_strfreev (tokens);
+
+  if (!ret || n == 0)
+    return FALSE;
+
+  info->strides[0] = nns_ex_tensor_type_size (info->type);
+  for (i = 1; i < NNS_EX_TENSOR_RANK_LIMIT; i++)
+    info->strides[i] = info->strides[i - 1] * info->dims[i - 1];
+
+  info->size = info->strides[NNS_EX_TENSOR_RANK_LIMIT - 1] *
+      info->dims[NNS_EX_TENSOR_RANK_LIMIT - 1];
+  return (info->size > 0);
+}
+
+/**
+ * @brief Parse the tensor caps (other/tensor or other/tensors).
+ */
+gboolean
+nns_ex_tensors_info_from_caps (const GstCaps * caps,
+    nns_ex_tensors_info_s * info)
+{
+  GstStructure *structure;
+  const gchar *name;
+  gchar **types = NULL;
+  gchar **dims = NULL;
+  gint num = 0;
+  guint i;
+  gboolean ret = FALSE;
+
+  g_return_val_if_fail (caps != NULL, FALSE);
+  g_return_val_if_fail (info != NULL, FALSE);
+
+  if (!gst_caps_is_fixed (caps))
+    return FALSE;
+
+  memset (info, 0, sizeof (nns_ex_tensors_info_s));
+
+  structure = gst_caps_get_structure (caps, 0);
+  name = gst_structure_get_name (structure);
+
+  if (!gst_structure_get_fraction (structure, "framerate", &info->rate_n,
+          &info->rate_d)) {
+    info->rate_n = 0;
+    info->rate_d = 1;
+  }
+
+  if (g_str_equal (name, "other/tensor")) {
+    info->num_tensors = 1;
+    info->info[0].type = nns_ex_tensor_type_from_string
+        (gst_structure_get_string (structure, "type"));
+
+    name = gst_structure_get_string (structure, "dimension");
+    return (info->info[0].type != NNS_EX_TENSOR_TYPE_UNKNOWN && name &&
+        _tensor_info_set_dimension (&info->info[0], name));
+  }
+
+  if (!g_str_equal (name, "other/tensors") ||
+      !gst_structure_get_int (structure, "num_tensors", &num) ||
+      num <= 0 || num > NNS_EX_TENSOR_SIZE_LIMIT)
+    return FALSE;
+
+  info->num_tensors = (guint) num;
+
+  name = gst_structure_get_string (structure, "types");
+  if (name)
+    types = g_strsplit (name, ",", -1);
+
+  name = gst_structure_get_string (structure, "dimensions");
+  if (name)
+    dims = g_strsplit (name, ",", -1);
+
+  if (types == NULL || dims == NULL ||
+      g_strv_length (types) < info->num_tensors ||
+      g_strv_length (dims) < info->num_tensors)
+    goto done;
+
+  for (i = 0; i < info->num_tensors; i++) {
+    info->info[i].type =
+        nns_ex_tensor_type_from_string (g_strstrip (types[i]));
+
+    if (info->info[i].type == NNS_EX_TENSOR_TYPE_UNKNOWN ||
+        !_tensor_info_set_dimension (&info->info[i], dims[i]))
+      goto done;
+  }
+
+  ret = TRUE;
+
+done:
+  g_strfreev (types);
+  g_strfreev (dims);
+  return ret;
+}
+
+/**
+ * @brief Update the cached info with the caps.
+ */
+static void
+_tensor_sink_set_caps (nns_ex_tensor_sink_s * consumer, GstCaps * caps)
+{
+  consumer->configured =
+      nns_ex_tensors_info_from_caps (caps, &consumer->info);
+  consumer->caps_seq++;
+}
+
+/**
+ * @brief Pad probe to watch the caps event.
+ */
+static GstPadProbeReturn
+_tensor_sink_event_probe (GstPad * pad, GstPadProbeInfo * info,
+    gpointer user_data)
+{
+  nns_ex_tensor_sink_s *consumer = (nns_ex_tensor_sink_s *) user_data;
+  GstEvent *event = GST_PAD_PROBE_INFO_EVENT (info);
+  GstCaps *caps;
+
+  if (GST_EVENT_TYPE (event) == GST_EVENT_CAPS) {
+    gst_event_parse_caps (event, &caps);
+    _tensor_sink_set_caps (consumer, caps);
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Create the consumer of the tensor sink.
+ */
+nns_ex_tensor_sink_s *
+nns_ex_tensor_sink_new (GstElement * sink)
+{
+  nns_ex_tensor_sink_s *consumer;
+  GstCaps *caps;
+
+  g_return_val_if_fail (GST_IS_ELEMENT (sink), NULL);
+
+  consumer = g_new0 (nns_ex_tensor_sink_s, 1);
+
+  consumer->sink_pad = gst_element_get_static_pad (sink, "sink");
+  if (consumer->sink_pad == NULL) {
+    g_free (consumer);
+    return NULL;
+  }
+
+  consumer->probe_id = gst_pad_add_probe (consumer->sink_pad,
+      GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM, _tensor_sink_event_probe, consumer,
+      NULL);
+
+  /* already negotiated */
+  caps = gst_pad_get_current_caps (consumer->sink_pad);
+  if (caps) {
+    _tensor_sink_set_caps (consumer, caps);
+    gst_caps_unref (caps);
+  }
+
+  return consumer;
+}
+
+/**
+ * @brief Free the consumer.
+ */
+void
+nns_ex_tensor_sink_free (nns_ex_tensor_sink_s * consumer)
+{
+  g_return_if_fail (consumer != NULL);
+
+  if (consumer->sink_pad) {
+    if (consumer->probe_id > 0)
+      gst_pad_remove_probe (consumer->sink_pad, consumer->probe_id);
+    gst_object_unref (consumer->sink_pad);
+  }
+
+  g_free (consumer);
+}
+
+/**
+ * @brief Get the cached tensor info.
+ */
+const nns_ex_tensors_info_s *
+nns_ex_tensor_sink_peek_info (nns_ex_tensor_sink_s * consumer)
+{
+  g_return_val_if_fail (consumer != NULL, NULL);
+
+  return consumer->configured ? &consumer->info : NULL;
+}
+
+/**
+ * @brief Get the count of negotiation, to check the renegotiation.
+ */
+guint
+nns_ex_tensor_sink_get_caps_seq (nns_ex_tensor_sink_s * consumer)
+{
+  g_return_val_if_fail (consumer != NULL, 0);
+
+  return consumer->caps_seq;
+}
+
+/**
+ * @brief Map the tensors in the buffer.
+ */
+gboolean
+nns_ex_tensor_sink_map (nns_ex_tensor_sink_s * consumer, GstBuffer * buffer,
+    nns_ex_tensor_sink_map_s * map)
+{
+  guint i;
+
+  g_return_val_if_fail (consumer != NULL, FALSE);
+  g_return_val_if_fail (GST_IS_BUFFER (buffer), FALSE);
+  g_return_val_if_fail (map != NULL, FALSE);
+
+  map->num_tensors = 0;
+
+  /* tensor_sink passes a memory block for each tensor */
+  if (!consumer->configured ||
+      gst_buffer_n_memory (buffer) != consumer->info.num_tensors)
+    return FALSE;
+
+  for (i = 0; i < consumer->info.num_tensors; i++) {
+    map->mem[i] = gst_buffer_peek_memory (buffer, i);
+
+    if (!gst_memory_map (map->mem[i], &map->map[i], GST_MAP_READ))
+      goto error;
+
+    map->num_tensors++;
+
+    if (map->map[i].size != consumer->info.info[i].size)
+      goto error;
+
+    map->data[i] = map->map[i].data;
+    map->size[i] = map->map[i].size;
+  }
+
+  return TRUE;
+
+error:
+  nns_ex_tensor_sink_unmap (map);
+  return FALSE;
+}
+
+/**
+ * @brief Unmap the tensors.
+ */
+void
+nns_ex_tensor_sink_unmap (nns_ex_tensor_sink_map_s * map)
+{
+  guint i;
+
+  g_return_if_fail (map != NULL);
+
+  for (i = 0; i < map->num_tensors; i++)
+    gst_memory_unmap (map->mem[i], &map->map[i]);
+
+  map->num_tensors = 0;
+}
@@ -0,0 +1,163 @@
+/**
+ * @file	nns_ex_tensor_sink.h
+ * @date	19 October 2026
+ * @brief	Helper to consume the tensors from tensor_sink with cached tensor info
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * The helper parses the tensor caps only when the caps event arrives (negotiation or renegotiation),
+ * and keeps the typed tensor info (count, types, dimensions and strides).
+ * Then the per-buffer work in 'new-data' callback is mapping the memories.
+ *
+ * Usage :
+ *
+ * consumer = nns_ex_tensor_sink_new (tensor_sink);
+ *
+ * (in new-data callback)
+ * if (nns_ex_tensor_sink_map (consumer, buffer, &map)) {
+ *   info = nns_ex_tensor_sink_peek_info (consumer);
+ *   (use map.data[i] with info->info[i])
+ *   nns_ex_tensor_sink_unmap (&map);
+ * }
+ */
+
+#ifndef __NNS_EX_TENSOR_SINK_H__
+#define __NNS_EX_TENSOR_SINK_H__
+
+#include <glib.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Max rank of a tensor (same as nnstreamer).
+ */
+#define NNS_EX_TENSOR_RANK_LIMIT 4
+
+/**
+ * @brief Max number of tensors in a buffer (same as nnstreamer).
+ */
+#define NNS_EX_TENSOR_SIZE_LIMIT 16
+
+/**
+ * @brief Tensor element type (same order as nnstreamer tensor_type).
+ */
+typedef enum
+{
+  NNS_EX_TENSOR_TYPE_INT32 = 0,
+  NNS_EX_TENSOR_TYPE_UINT32,
+  NNS_EX_TENSOR_TYPE_INT16,
+  NNS_EX_TENSOR_TYPE_UINT16,
+  NNS_EX_TENSOR_TYPE_INT8,
+  NNS_EX_TENSOR_TYPE_UINT8,
+  NNS_EX_TENSOR_TYPE_FLOAT64,
+  NNS_EX_TENSOR_TYPE_FLOAT32,
+  NNS_EX_TENSOR_TYPE_INT64,
+  NNS_EX_TENSOR_TYPE_UINT64,
+  NNS_EX_TENSOR_TYPE_UNKNOWN
+} nns_ex_tensor_type_e;
+
+/**
+ * @brief Data structure for a tensor.
+ */
+typedef struct
+{
+  nns_ex_tensor_type_e type; /**< element type */
+  guint dims[NNS_EX_TENSOR_RANK_LIMIT]; /**< dimension, innermost first */
+  gsize strides[NNS_EX_TENSOR_RANK_LIMIT]; /**< bytes to the next element of each dimension */
+  gsize size; /**< total bytes of the tensor */
+} nns_ex_tensor_info_s;
+
+/**
+ * @brief Data structure for the tensors in a buffer.
+ */
+typedef struct
+{
+  guint num_tensors; /**< count of tensors */
+  nns_ex_tensor_info_s info[NNS_EX_TENSOR_SIZE_LIMIT]; /**< tensor info */
+  gint rate_n; /**< framerate numerator */
+  gint rate_d; /**< framerate denominator */
+} nns_ex_tensors_info_s;
+
+/**
+ * @brief Data structure for the mapped tensors.
+ */
+typedef struct
+{
+  guint num_tensors; /**< count of mapped tensors */
+  guint8 *data[NNS_EX_TENSOR_SIZE_LIMIT]; /**< data of each tensor */
+  gsize size[NNS_EX_TENSOR_SIZE_LIMIT]; /**< size of each tensor */
+  GstMemory *mem[NNS_EX_TENSOR_SIZE_LIMIT]; /**< memory of each tensor */
+  GstMapInfo map[NNS_EX_TENSOR_SIZE_LIMIT]; /**< map info of each memory */
+} nns_ex_tensor_sink_map_s;
+
+/**
+ * @brief Handle of the tensor sink consumer.
+ */
+typedef struct _nns_ex_tensor_sink_s nns_ex_tensor_sink_s;
+
+/**
+ * @brief Get the size of element type.
+ * @return size in bytes, 0 if the type is unknown
+ */
+extern gsize
+nns_ex_tensor_type_size (nns_ex_tensor_type_e type);
+
+/**
+ * @brief Get the element type from the string (e.g., 'uint8').
+ */
+extern nns_ex_tensor_type_e
+nns_ex_tensor_type_from_string (const gchar * str);
+
+/**
+ * @brief Parse the tensor caps (other/tensor or other/tensors).
+ * @return TRUE if the caps is fixed tensor caps
+ */
+extern gboolean
+nns_ex_tensors_info_from_caps (const GstCaps * caps,
+    nns_ex_tensors_info_s * info);
+
+/**
+ * @brief Create the consumer of the tensor sink.
+ * @note The consumer watches the caps event on the sink pad of given element.
+ */
+extern nns_ex_tensor_sink_s *
+nns_ex_tensor_sink_new (GstElement * sink);
+
+/**
+ * @brief Free the consumer.
+ */
+extern void
+nns_ex_tensor_sink_free (nns_ex_tensor_sink_s * consumer);
+
+/**
+ * @brief Get the cached tensor info.
+ * @note Call this in the streaming thread (e.g., new-data callback), the info is updated with the caps event.
+ * @return NULL if not negotiated
+ */
+extern const nns_ex_tensors_info_s *
+nns_ex_tensor_sink_peek_info (nns_ex_tensor_sink_s * consumer);
+
+/**
+ * @brief Get the count of negotiation, to check the renegotiation.
+ */
+extern guint
+nns_ex_tensor_sink_get_caps_seq (nns_ex_tensor_sink_s * consumer);
+
+/**
+ * @brief Map the tensors in the buffer.
+ * @return TRUE if all tensors are mapped and the sizes are matched with the cached info
+ */
+extern gboolean
+nns_ex_tensor_sink_map (nns_ex_tensor_sink_s * consumer, GstBuffer * buffer,
+    nns_ex_tensor_sink_map_s * map);
+
+/**
+ * @brief Unmap the tensors.
+ */
+extern void
+nns_ex_tensor_sink_unmap (nns_ex_tensor_sink_map_s * map);
+
+G_END_DECLS
+
+#endif /* __NNS_EX_TENSOR_SINK_H__ */
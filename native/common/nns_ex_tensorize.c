@@ -0,0 +1,582 @@
+/**
+ * @file	nns_ex_tensorize.c
+ * @date	19 October 2026
+ * @brief	Element to convert video frames to the model input tensor in a single pass
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ */
+
+#include <string.h>
+#include <gst/base/gstbasetransform.h>
+#include <gst/video/video.h>
+
+#include "nns_ex_preprocess.h"
+#include "nns_ex_tensorize.h"
+
+GST_DEBUG_CATEGORY_STATIC (nns_ex_tensorize_debug);
+#define GST_CAT_DEFAULT nns_ex_tensorize_debug
+
+/**
+ * @brief Default dimension of the output tensor.
+ */
+#define DEFAULT_WIDTH 224
+#define DEFAULT_HEIGHT 224
+
+/**
+ * @brief Video formats of the sink pad.
+ */
+#define TENSORIZE_VIDEO_FORMATS \
+    "{ RGB, BGR, RGBx, BGRx, xRGB, xBGR, RGBA, BGRA, I420, YV12, NV12, NV21, YUY2, UYVY }"
+
+/**
+ * @brief Properties.
+ */
+enum
+{
+  PROP_0,
+  PROP_WIDTH,
+  PROP_HEIGHT,
+  PROP_TYPE,
+  PROP_LETTERBOX,
+  PROP_NORMALIZE,
+  PROP_CROP
+};
+
+/**
+ * @brief Data structure for the element.
+ */
+typedef struct
+{
+  GstBaseTransform parent; /**< parent object */
+
+  guint width; /**< width of the output tensor */
+  guint height; /**< height of the output tensor */
+  gboolean to_float; /**< true if the output type is float32 */
+  gboolean letterbox; /**< keep the aspect ratio */
+  gchar *normalize; /**< normalization option */
+  gchar *crop; /**< region of the frame to convert, NULL for the full frame */
+  gfloat crop_rect[4]; /**< parsed region (left, top, width, height), ratio to the frame size */
+  gboolean crop_changed; /**< true if the region is changed (protected by the object lock) */
+
+  GstVideoInfo in_info; /**< negotiated video info */
+  nns_ex_video_format_e format; /**< negotiated pixel format */
+  nns_ex_normalize_s norm; /**< parsed normalization */
+  nns_ex_frame_converter_s *conv; /**< frame converter for the negotiated video */
+} NnsExTensorize;
+
+/**
+ * @brief Data structure for the element class.
+ */
+typedef struct
+{
+  GstBaseTransformClass parent_class; /**< parent class */
+} NnsExTensorizeClass;
+
+G_DEFINE_TYPE (NnsExTensorize, nns_ex_tensorize, GST_TYPE_BASE_TRANSFORM);
+
+static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (TENSORIZE_VIDEO_FORMATS)));
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("other/tensor"));
+
+/**
+ * @brief Get the size of the output tensor.
+ */
+static gsize
+_tensorize_out_size (NnsExTensorize * self)
+{
+  return (gsize) self->width * self->height * 3 *
+      (self->to_float ? sizeof (gfloat) : sizeof (guint8));
+}
+
+/**
+ * @brief Release the frame converter.
+ */
+static void
+_tensorize_reset (NnsExTensorize * self)
+{
+  if (self->conv) {
+    nns_ex_frame_converter_free (self->conv);
+    self->conv = NULL;
+  }
+}
+
+/**
+ * @brief Parse the region (e.g., '0.25,0.1,0.5,0.5'), NULL or empty string for the full frame.
+ */
+static gboolean
+_tensorize_parse_crop (const gchar * str, gfloat * rect)
+{
+  gchar **values;
+  gchar *end;
+  gdouble v[4];
+  guint i;
+  gboolean ret = TRUE;
+
+  rect[0] = rect[1] = 0.0f;
+  rect[2] = rect[3] = 1.0f;
+
+  if (str == NULL || *str == '\0')
+    return TRUE;
+
+  values = g_strsplit (str, ",", -1);
+  if (g_strv_length (values) != 4) {
+    g_strfreev (values);
+    return FALSE;
+  }
+
+  for (i = 0; i < 4 && ret; i++) {
+    v[i] = g_ascii_strtod (values[i], &end);
+    if (end == values[i] || v[i] < 0.0 || v[i] > 1.0)
+      ret = FALSE;
+  }
+
+  g_strfreev (values);
+
+  if (!ret || v[2] <= 0.0 || v[3] <= 0.0)
+    return FALSE;
+
+  /* keep the size, move the region into the frame */
+  for (i = 0; i < 2; i++) {
+    rect[i + 2] = (gfloat) v[i + 2];
+    rect[i] = (gfloat) MIN (v[i], 1.0 - v[i + 2]);
+  }
+
+  return TRUE;
+}
+
+/**
+ * @brief Create the frame converter for the negotiated video and the region.
+ */
+static gboolean
+_tensorize_build_converter (NnsExTensorize * self, const gfloat * rect)
+{
+  guint in_width, in_height, x0, y0, x1, y1;
+
+  in_width = GST_VIDEO_INFO_WIDTH (&self->in_info);
+  in_height = GST_VIDEO_INFO_HEIGHT (&self->in_info);
+
+  x0 = MIN ((guint) (rect[0] * in_width + 0.5f), in_width - 1);
+  y0 = MIN ((guint) (rect[1] * in_height + 0.5f), in_height - 1);
+  x1 = CLAMP ((guint) ((rect[0] + rect[2]) * in_width + 0.5f), x0 + 1,
+      in_width);
+  y1 = CLAMP ((guint) ((rect[1] + rect[3]) * in_height + 0.5f), y0 + 1,
+      in_height);
+
+  _tensorize_reset (self);
+  self->conv = nns_ex_frame_converter_new_crop (self->format, in_width,
+      in_height, x0, y0, x1 - x0, y1 - y0, self->width, self->height,
+      self->letterbox);
+
+  return (self->conv != NULL);
+}
+
+/**
+ * @brief Set the property.
+ */
+static void
+nns_ex_tensorize_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  NnsExTensorize *self = (NnsExTensorize *) object;
+  const gchar *type, *str;
+  gfloat rect[4];
+
+  switch (prop_id) {
+    case PROP_WIDTH:
+      self->width = g_value_get_uint (value);
+      break;
+    case PROP_HEIGHT:
+      self->height = g_value_get_uint (value);
+      break;
+    case PROP_TYPE:
+      type = g_value_get_string (value);
+      if (g_strcmp0 (type, "float32") == 0) {
+        self->to_float = TRUE;
+      } else if (g_strcmp0 (type, "uint8") == 0) {
+        self->to_float = FALSE;
+      } else {
+        GST_WARNING_OBJECT (self, "unsupported type %s (uint8 or float32)",
+            GST_STR_NULL (type));
+      }
+      break;
+    case PROP_LETTERBOX:
+      self->letterbox = g_value_get_boolean (value);
+      break;
+    case PROP_NORMALIZE:
+      g_free (self->normalize);
+      self->normalize = g_value_dup_string (value);
+      break;
+    case PROP_CROP:
+      str = g_value_get_string (value);
+      if (!_tensorize_parse_crop (str, rect)) {
+        GST_WARNING_OBJECT (self, "invalid crop %s (left,top,width,height)",
+            str);
+        break;
+      }
+
+      /* applied to the next frame */
+      GST_OBJECT_LOCK (self);
+      g_free (self->crop);
+      self->crop = g_strdup (str);
+      memcpy (self->crop_rect, rect, sizeof (rect));
+      self->crop_changed = TRUE;
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+/**
+ * @brief Get the property.
+ */
+static void
+nns_ex_tensorize_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  NnsExTensorize *self = (NnsExTensorize *) object;
+
+  switch (prop_id) {
+    case PROP_WIDTH:
+      g_value_set_uint (value, self->width);
+      break;
+    case PROP_HEIGHT:
+      g_value_set_uint (value, self->height);
+      break;
+    case PROP_TYPE:
+      g_value_set_string (value, self->to_float ? "float32" : "uint8");
+      break;
+    case PROP_LETTERBOX:
+      g_value_set_boolean (value, self->letterbox);
+      break;
+    case PROP_NORMALIZE:
+      g_value_set_string (value, self->normalize);
+      break;
+    case PROP_CROP:
+      GST_OBJECT_LOCK (self);
+      g_value_set_string (value, self->crop);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+/**
+ * @brief Finalize the element.
+ */
+static void
+nns_ex_tensorize_finalize (GObject * object)
+{
+  NnsExTensorize *self = (NnsExTensorize *) object;
+
+  _tensorize_reset (self);
+  g_free (self->normalize);
+  g_free (self->crop);
+
+  G_OBJECT_CLASS (nns_ex_tensorize_parent_class)->finalize (object);
+}
+
+/**
+ * @brief Get the caps of the other pad (video to tensor, or tensor to video), keeping the framerate.
+ */
+static GstCaps *
+nns_ex_tensorize_transform_caps (GstBaseTransform * trans,
+    GstPadDirection direction, GstCaps * caps, GstCaps * filter)
+{
+  NnsExTensorize *self = (NnsExTensorize *) trans;
+  GstCaps *result, *tmp;
+  GstStructure *structure;
+  const GValue *rate;
+  gchar *dimension;
+  guint i;
+
+  result = gst_caps_new_empty ();
+
+  if (direction == GST_PAD_SINK) {
+    dimension = g_strdup_printf ("3:%u:%u:1", self->width, self->height);
+
+    for (i = 0; i < gst_caps_get_size (caps); i++) {
+      structure = gst_structure_new ("other/tensor",
+          "dimension", G_TYPE_STRING, dimension,
+          "type", G_TYPE_STRING, self->to_float ? "float32" : "uint8", NULL);
+
+      rate = gst_structure_get_value (gst_caps_get_structure (caps, i),
+          "framerate");
+      if (rate)
+        gst_structure_set_value (structure, "framerate", rate);
+
+      result = gst_caps_merge_structure (result, structure);
+    }
+
+    g_free (dimension);
+  } else {
+    for (i = 0; i < gst_caps_get_size (caps); i++) {
+      tmp = gst_static_pad_template_get_caps (&sink_template);
+      tmp = gst_caps_make_writable (tmp);
+
+      rate = gst_structure_get_value (gst_caps_get_structure (caps, i),
+          "framerate");
+      if (rate)
+        gst_caps_set_value (tmp, "framerate", rate);
+
+      result = gst_caps_merge (result, tmp);
+    }
+  }
+
+  if (filter) {
+    tmp = gst_caps_intersect_full (filter, result, GST_CAPS_INTERSECT_FIRST);
+    gst_caps_unref (result);
+    result = tmp;
+  }
+
+  GST_DEBUG_OBJECT (self, "transformed %" GST_PTR_FORMAT " into %"
+      GST_PTR_FORMAT, caps, result);
+  return result;
+}
+
+/**
+ * @brief Prepare the frame converter for the negotiated video.
+ */
+static gboolean
+nns_ex_tensorize_set_caps (GstBaseTransform * trans, GstCaps * incaps,
+    GstCaps * outcaps)
+{
+  NnsExTensorize *self = (NnsExTensorize *) trans;
+  gfloat rect[4];
+
+  if (!gst_video_info_from_caps (&self->in_info, incaps)) {
+    GST_ERROR_OBJECT (self, "invalid caps %" GST_PTR_FORMAT, incaps);
+    return FALSE;
+  }
+
+  self->format = nns_ex_video_format_from_string (gst_video_format_to_string
+      (GST_VIDEO_INFO_FORMAT (&self->in_info)));
+  if (self->format == NNS_EX_VIDEO_FORMAT_UNKNOWN) {
+    GST_ERROR_OBJECT (self, "unsupported format %s",
+        GST_VIDEO_INFO_NAME (&self->in_info));
+    return FALSE;
+  }
+
+  nns_ex_normalize_init (&self->norm, 3, 0.0f, 1.0f);
+  if (!nns_ex_normalize_parse (&self->norm, self->normalize)) {
+    GST_ERROR_OBJECT (self, "invalid normalize option %s", self->normalize);
+    return FALSE;
+  }
+
+  GST_OBJECT_LOCK (self);
+  memcpy (rect, self->crop_rect, sizeof (rect));
+  self->crop_changed = FALSE;
+  GST_OBJECT_UNLOCK (self);
+
+  return _tensorize_build_converter (self, rect);
+}
+
+/**
+ * @brief Get the size of a frame or a tensor.
+ */
+static gboolean
+nns_ex_tensorize_get_unit_size (GstBaseTransform * trans, GstCaps * caps,
+    gsize * size)
+{
+  NnsExTensorize *self = (NnsExTensorize *) trans;
+  GstStructure *structure = gst_caps_get_structure (caps, 0);
+  GstVideoInfo info;
+
+  if (gst_structure_has_name (structure, "other/tensor")) {
+    *size = _tensorize_out_size (self);
+    return TRUE;
+  }
+
+  if (!gst_video_info_from_caps (&info, caps))
+    return FALSE;
+
+  *size = GST_VIDEO_INFO_SIZE (&info);
+  return TRUE;
+}
+
+/**
+ * @brief Convert a frame to the tensor.
+ */
+static GstFlowReturn
+nns_ex_tensorize_transform (GstBaseTransform * trans, GstBuffer * inbuf,
+    GstBuffer * outbuf)
+{
+  NnsExTensorize *self = (NnsExTensorize *) trans;
+  const guint8 *planes[NNS_EX_VIDEO_MAX_PLANES] = { NULL, };
+  gint strides[NNS_EX_VIDEO_MAX_PLANES] = { 0, };
+  GstVideoFrame frame;
+  GstMapInfo map;
+  gfloat rect[4];
+  gboolean crop_changed;
+  guint p;
+
+  GST_OBJECT_LOCK (self);
+  crop_changed = self->crop_changed;
+  memcpy (rect, self->crop_rect, sizeof (rect));
+  self->crop_changed = FALSE;
+  GST_OBJECT_UNLOCK (self);
+
+  /* the tables are small (output width and height), rebuild for the new region */
+  if (crop_changed && self->conv && !_tensorize_build_converter (self, rect)) {
+    GST_ELEMENT_ERROR (self, CORE, FAILED, (NULL),
+        ("failed to set the crop region"));
+    return GST_FLOW_ERROR;
+  }
+
+  if (self->conv == NULL) {
+    GST_ELEMENT_ERROR (self, CORE, NEGOTIATION, (NULL),
+        ("the caps are not negotiated"));
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+
+  if (!gst_video_frame_map (&frame, &self->in_info, inbuf, GST_MAP_READ)) {
+    GST_ERROR_OBJECT (self, "failed to map the input frame");
+    return GST_FLOW_ERROR;
+  }
+
+  if (!gst_buffer_map (outbuf, &map, GST_MAP_WRITE)) {
+    GST_ERROR_OBJECT (self, "failed to map the output buffer");
+    gst_video_frame_unmap (&frame);
+    return GST_FLOW_ERROR;
+  }
+
+  if (map.size < _tensorize_out_size (self)) {
+    GST_ERROR_OBJECT (self, "invalid output size %" G_GSIZE_FORMAT, map.size);
+    gst_buffer_unmap (outbuf, &map);
+    gst_video_frame_unmap (&frame);
+    return GST_FLOW_ERROR;
+  }
+
+  for (p = 0; p < GST_VIDEO_FRAME_N_PLANES (&frame) &&
+      p < NNS_EX_VIDEO_MAX_PLANES; p++) {
+    planes[p] = GST_VIDEO_FRAME_PLANE_DATA (&frame, p);
+    strides[p] = GST_VIDEO_FRAME_PLANE_STRIDE (&frame, p);
+  }
+
+  if (self->to_float) {
+    nns_ex_frame_converter_to_float32 (self->conv, planes, strides,
+        (gfloat *) map.data, &self->norm);
+  } else {
+    nns_ex_frame_converter_to_uint8 (self->conv, planes, strides, map.data);
+  }
+
+  gst_buffer_unmap (outbuf, &map);
+  gst_video_frame_unmap (&frame);
+  return GST_FLOW_OK;
+}
+
+/**
+ * @brief Release the resources when the element stops.
+ */
+static gboolean
+nns_ex_tensorize_stop (GstBaseTransform * trans)
+{
+  _tensorize_reset ((NnsExTensorize *) trans);
+  return TRUE;
+}
+
+/**
+ * @brief Initialize the element class.
+ */
+static void
+nns_ex_tensorize_class_init (NnsExTensorizeClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  GstBaseTransformClass *trans_class = GST_BASE_TRANSFORM_CLASS (klass);
+
+  GST_DEBUG_CATEGORY_INIT (nns_ex_tensorize_debug, NNS_EX_TENSORIZE_NAME, 0,
+      "Single-pass video to tensor conversion");
+
+  gobject_class->set_property = nns_ex_tensorize_set_property;
+  gobject_class->get_property = nns_ex_tensorize_get_property;
+  gobject_class->finalize = nns_ex_tensorize_finalize;
+
+  g_object_class_install_property (gobject_class, PROP_WIDTH,
+      g_param_spec_uint ("width", "Width", "Width of the output tensor",
+          1, G_MAXUINT16, DEFAULT_WIDTH,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_HEIGHT,
+      g_param_spec_uint ("height", "Height", "Height of the output tensor",
+          1, G_MAXUINT16, DEFAULT_HEIGHT,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_TYPE,
+      g_param_spec_string ("type", "Type",
+          "Type of the output tensor (uint8 or float32)", "uint8",
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_LETTERBOX,
+      g_param_spec_boolean ("letterbox", "Letterbox",
+          "Keep the aspect ratio and pad the borders with black", FALSE,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_NORMALIZE,
+      g_param_spec_string ("normalize", "Normalize",
+          "Per-channel normalization of float32 tensor (e.g., mean:127.5,std:127.5)",
+          NULL,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_CROP,
+      g_param_spec_string ("crop", "Crop",
+          "Region of the frame to convert, left,top,width,height in ratio to "
+          "the frame size (e.g., 0.25,0.1,0.5,0.5), empty for the full frame",
+          NULL,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
+  gst_element_class_set_static_metadata (element_class,
+      "NNStreamer example tensorize", "Filter/Converter/Video",
+      "Converts video frames to the model input tensor in a single pass "
+      "(color conversion, scaling, letterbox and normalization)",
+      "agent <agent@local>");
+
+  gst_element_class_add_static_pad_template (element_class, &sink_template);
+  gst_element_class_add_static_pad_template (element_class, &src_template);
+
+  trans_class->passthrough_on_same_caps = FALSE;
+  trans_class->transform_caps =
+      GST_DEBUG_FUNCPTR (nns_ex_tensorize_transform_caps);
+  trans_class->set_caps = GST_DEBUG_FUNCPTR (nns_ex_tensorize_set_caps);
+  trans_class->get_unit_size =
+      GST_DEBUG_FUNCPTR (nns_ex_tensorize_get_unit_size);
+  trans_class->transform = GST_DEBUG_FUNCPTR (nns_ex_tensorize_transform);
+  trans_class->stop = GST_DEBUG_FUNCPTR (nns_ex_tensorize_stop);
+}
+
+/**
+ * @brief Initialize the element.
+ */
+static void
+nns_ex_tensorize_init (NnsExTensorize * self)
+{
+  self->width = DEFAULT_WIDTH;
+  self->height = DEFAULT_HEIGHT;
+  self->to_float = FALSE;
+  self->letterbox = FALSE;
+  self->normalize = NULL;
+  self->crop = NULL;
+  _tensorize_parse_crop (NULL, self->crop_rect);
+  self->crop_changed = FALSE;
+  self->conv = NULL;
+}
+
+/**
+ * @brief Register the element 'nns_ex_tensorize' to the application.
+ */
+gboolean
+nns_ex_tensorize_register (void)
+{
+  return gst_element_register (NULL, NNS_EX_TENSORIZE_NAME, GST_RANK_NONE,
+      nns_ex_tensorize_get_type ());
+}
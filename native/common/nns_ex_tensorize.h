@@ -0,0 +1,58 @@
+/**
+ * @file	nns_ex_tensorize.h
+ * @date	19 October 2026
+ * @brief	Element to convert video frames to the model input tensor in a single pass
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * The element 'nns_ex_tensorize' replaces the chain
+ * 'videoconvert ! videoscale ! video/x-raw,width=W,height=H,format=RGB ! tensor_converter ! tensor_transform mode=arithmetic ...'.
+ * It takes the camera format (RGB variants, I420, YV12, NV12, NV21, YUY2 or UYVY) and does
+ * the color conversion, bilinear scaling, letterbox and normalization at once.
+ *
+ * Usage :
+ *
+ * gst_init (&argc, &argv);
+ * nns_ex_tensorize_register ();
+ *
+ * v4l2src ! nns_ex_tensorize width=300 height=300 type=float32 normalize=mean:127.5,std:127.5 ! tensor_filter ...
+ *
+ * Properties :
+ * width, height : dimension of the output tensor (3:width:height:1)
+ * type : uint8 or float32
+ * letterbox : keep the aspect ratio and pad the borders with black
+ * normalize : per-channel normalization of float32 tensor (e.g., 'mean:123:117:104,std:58:57:57')
+ * crop : region of the frame to convert, 'left,top,width,height' in ratio to the frame size
+ *        (e.g., '0.25,0.1,0.5,0.5'), empty for the full frame. It can be changed in PLAYING state,
+ *        the next frame is converted with the new region.
+ */
+
+#ifndef __NNS_EX_TENSORIZE_H__
+#define __NNS_EX_TENSORIZE_H__
+
+#include <glib.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Name of the element.
+ */
+#define NNS_EX_TENSORIZE_NAME "nns_ex_tensorize"
+
+/**
+ * @brief Get the type of the element.
+ */
+extern GType
+nns_ex_tensorize_get_type (void);
+
+/**
+ * @brief Register the element 'nns_ex_tensorize' to the application.
+ * @return TRUE if the element is registered
+ */
+extern gboolean
+nns_ex_tensorize_register (void);
+
+G_END_DECLS
+
+#endif /* __NNS_EX_TENSORIZE_H__ */
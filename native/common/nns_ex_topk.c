@@ -0,0 +1,245 @@
+/**
+ * @file	nns_ex_topk.c
+ * @date	19 October 2026
+ * @brief	Top-K decoder of the classification scores (uint8 and float32)
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ */
+
+#include <string.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define NNS_EX_HAVE_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define NNS_EX_HAVE_SSE2 1
+#endif
+
+#include "nns_ex_topk.h"
+
+/**
+ * @brief Number of scores compared at once.
+ */
+#define TOPK_BLOCK 16
+
+/**
+ * @brief Insert the entry, keep the entries sorted (the earlier one first if the scores are same).
+ * @return number of the entries
+ */
+static inline guint
+_topk_insert (nns_ex_topk_entry_s * top, guint n, guint k, guint index,
+    gfloat score)
+{
+  guint pos = n;
+
+  while (pos > 0 && top[pos - 1].score < score)
+    pos--;
+
+  if (pos >= k)
+    return n;
+
+  if (n < k)
+    n++;
+
+  memmove (&top[pos + 1], &top[pos], (n - 1 - pos) * sizeof (*top));
+  top[pos].index = index;
+  top[pos].score = score;
+  return n;
+}
+
+/**
+ * @brief Convert the real threshold to the quantized value.
+ * @return quantized threshold, -1 if all scores are greater than threshold
+ */
+static gint
+_quant_threshold (const nns_ex_quant_s * quant, gfloat threshold)
+{
+  gdouble q = threshold;
+
+  if (quant && quant->scale > 0.0f)
+    q = threshold / quant->scale + quant->zero_point;
+
+  if (q < 0.0)
+    return -1;
+
+  /* q is not negative, truncation is floor */
+  return (q >= 255.0) ? 255 : (gint) q;
+}
+
+#ifdef NNS_EX_HAVE_NEON
+/**
+ * @brief Check any lane of the mask is set.
+ */
+static inline gboolean
+_neon_any (uint8x16_t mask)
+{
+  uint64x2_t m = vreinterpretq_u64_u8 (mask);
+
+  return (vgetq_lane_u64 (m, 0) | vgetq_lane_u64 (m, 1)) != 0;
+}
+#endif
+
+/**
+ * @brief Get the entries with the K highest scores greater than the threshold (float32 scores).
+ */
+guint
+nns_ex_topk_float32 (const gfloat * scores, guint len, guint k,
+    gfloat threshold, nns_ex_topk_entry_s * top)
+{
+  gfloat limit = threshold;
+  guint i = 0, n = 0;
+  guint end;
+
+  g_return_val_if_fail (scores != NULL && top != NULL, 0);
+  g_return_val_if_fail (k > 0 && k <= NNS_EX_TOPK_MAX, 0);
+
+  end = len - (len % TOPK_BLOCK);
+
+  for (; i < end; i += TOPK_BLOCK) {
+    guint j;
+
+    /* skip the block if no score is greater than the current limit */
+#ifdef NNS_EX_HAVE_NEON
+    {
+      const float32x4_t t = vdupq_n_f32 (limit);
+      uint32x4_t m;
+
+      m = vorrq_u32 (vcgtq_f32 (vld1q_f32 (scores + i), t),
+          vcgtq_f32 (vld1q_f32 (scores + i + 4), t));
+      m = vorrq_u32 (m, vcgtq_f32 (vld1q_f32 (scores + i + 8), t));
+      m = vorrq_u32 (m, vcgtq_f32 (vld1q_f32 (scores + i + 12), t));
+
+      if (!_neon_any (vreinterpretq_u8_u32 (m)))
+        continue;
+    }
+#elif defined(NNS_EX_HAVE_SSE2)
+    {
+      const __m128 t = _mm_set1_ps (limit);
+      gint mask;
+
+      mask = _mm_movemask_ps (_mm_cmpgt_ps (_mm_loadu_ps (scores + i), t));
+      mask |= _mm_movemask_ps (_mm_cmpgt_ps (_mm_loadu_ps (scores + i + 4),
+              t)) << 4;
+      mask |= _mm_movemask_ps (_mm_cmpgt_ps (_mm_loadu_ps (scores + i + 8),
+              t)) << 8;
+      mask |= _mm_movemask_ps (_mm_cmpgt_ps (_mm_loadu_ps (scores + i + 12),
+              t)) << 12;
+
+      if (mask == 0)
+        continue;
+    }
+#endif
+
+    for (j = i; j < i + TOPK_BLOCK; j++) {
+      if (scores[j] > limit) {
+        n = _topk_insert (top, n, k, j, scores[j]);
+        if (n == k)
+          limit = top[k - 1].score;
+      }
+    }
+  }
+
+  /* remained scores */
+  for (; i < len; i++) {
+    if (scores[i] > limit) {
+      n = _topk_insert (top, n, k, i, scores[i]);
+      if (n == k)
+        limit = top[k - 1].score;
+    }
+  }
+
+  return n;
+}
+
+/**
+ * @brief Get the entries with the K highest scores greater than the threshold (uint8 scores).
+ */
+guint
+nns_ex_topk_uint8 (const guint8 * scores, guint len, guint k,
+    const nns_ex_quant_s * quant, gfloat threshold, nns_ex_topk_entry_s * top)
+{
+  gint limit;
+  guint i = 0, n = 0, c;
+  guint end;
+
+  g_return_val_if_fail (scores != NULL && top != NULL, 0);
+  g_return_val_if_fail (k > 0 && k <= NNS_EX_TOPK_MAX, 0);
+
+  limit = _quant_threshold (quant, threshold);
+  end = len - (len % TOPK_BLOCK);
+
+  for (; i < end && limit < 255; i += TOPK_BLOCK) {
+    guint j;
+
+    /* skip the block if no score is greater than the current limit */
+    if (limit >= 0) {
+#ifdef NNS_EX_HAVE_NEON
+      if (!_neon_any (vcgtq_u8 (vld1q_u8 (scores + i),
+                  vdupq_n_u8 ((guint8) limit))))
+        continue;
+#elif defined(NNS_EX_HAVE_SSE2)
+      /* unsigned v > limit, max (v, limit + 1) == v */
+      const __m128i v = _mm_loadu_si128 ((const __m128i *) (scores + i));
+      const __m128i t = _mm_set1_epi8 ((gchar) (limit + 1));
+
+      if (_mm_movemask_epi8 (_mm_cmpeq_epi8 (_mm_max_epu8 (v, t), v)) == 0)
+        continue;
+#endif
+    }
+
+    for (j = i; j < i + TOPK_BLOCK; j++) {
+      if ((gint) scores[j] > limit) {
+        n = _topk_insert (top, n, k, j, scores[j]);
+        if (n == k)
+          limit = (gint) top[k - 1].score;
+      }
+    }
+  }
+
+  /* remained scores */
+  for (; i < len && limit < 255; i++) {
+    if ((gint) scores[i] > limit) {
+      n = _topk_insert (top, n, k, i, scores[i]);
+      if (n == k)
+        limit = (gint) top[k - 1].score;
+    }
+  }
+
+  /* dequantize */
+  if (quant && quant->scale > 0.0f) {
+    for (c = 0; c < n; c++)
+      top[c].score = quant->scale * (top[c].score - quant->zero_point);
+  }
+
+  return n;
+}
+
+/**
+ * @brief Get the index of the highest score greater than the threshold (float32 scores).
+ */
+gint
+nns_ex_argmax_float32 (const gfloat * scores, guint len, gfloat threshold)
+{
+  nns_ex_topk_entry_s top;
+
+  if (nns_ex_topk_float32 (scores, len, 1, threshold, &top) == 0)
+    return -1;
+
+  return (gint) top.index;
+}
+
+/**
+ * @brief Get the index of the highest score greater than the threshold (uint8 scores).
+ */
+gint
+nns_ex_argmax_uint8 (const guint8 * scores, guint len,
+    const nns_ex_quant_s * quant, gfloat threshold)
+{
+  nns_ex_topk_entry_s top;
+
+  if (nns_ex_topk_uint8 (scores, len, 1, quant, threshold, &top) == 0)
+    return -1;
+
+  return (gint) top.index;
+}
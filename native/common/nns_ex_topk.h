@@ -0,0 +1,95 @@
+/**
+ * @file	nns_ex_topk.h
+ * @date	19 October 2026
+ * @brief	Top-K decoder of the classification scores (uint8 and float32)
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * The scores are compared with the threshold (and the current K-th score) in blocks of 16 values
+ * with NEON or SSE2, so only the blocks having a candidate are scanned.
+ *
+ * The threshold of uint8 scores is given in the real value, and converted once to the quantized value
+ * with the output quantization of the model (real = scale * (quantized - zero_point)).
+ *
+ * Usage :
+ *
+ * nns_ex_topk_entry_s top[5];
+ * guint n = nns_ex_topk_float32 (scores, 1001, 5, 0.5f, top);
+ * (top[0 ~ n-1], the highest score first)
+ */
+
+#ifndef __NNS_EX_TOPK_H__
+#define __NNS_EX_TOPK_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Max number of the entries.
+ */
+#define NNS_EX_TOPK_MAX 32
+
+/**
+ * @brief Data structure for a classification result.
+ */
+typedef struct
+{
+  guint index; /**< index of the class */
+  gfloat score; /**< score of the class (dequantized if uint8) */
+} nns_ex_topk_entry_s;
+
+/**
+ * @brief Quantization of the uint8 scores, real = scale * (quantized - zero_point).
+ */
+typedef struct
+{
+  gfloat scale; /**< quantization scale */
+  gint zero_point; /**< quantization zero point */
+} nns_ex_quant_s;
+
+/**
+ * @brief Get the entries with the K highest scores greater than the threshold (float32 scores).
+ * @param scores array of scores
+ * @param len number of scores
+ * @param k max number of the entries (1 ~ NNS_EX_TOPK_MAX)
+ * @param threshold the scores greater than threshold are valid
+ * @param top the entries, sorted by score (the lower index first if the scores are same)
+ * @return number of the entries
+ */
+extern guint
+nns_ex_topk_float32 (const gfloat * scores, guint len, guint k,
+    gfloat threshold, nns_ex_topk_entry_s * top);
+
+/**
+ * @brief Get the entries with the K highest scores greater than the threshold (uint8 scores).
+ * @param scores array of quantized scores
+ * @param len number of scores
+ * @param k max number of the entries (1 ~ NNS_EX_TOPK_MAX)
+ * @param quant quantization of the scores, NULL to use the raw value (scale 1, zero point 0)
+ * @param threshold the scores greater than threshold (real value) are valid
+ * @param top the entries, sorted by score (the lower index first if the scores are same)
+ * @return number of the entries
+ */
+extern guint
+nns_ex_topk_uint8 (const guint8 * scores, guint len, guint k,
+    const nns_ex_quant_s * quant, gfloat threshold, nns_ex_topk_entry_s * top);
+
+/**
+ * @brief Get the index of the highest score greater than the threshold (float32 scores).
+ * @return index of the class, -1 if no score is greater than the threshold
+ */
+extern gint
+nns_ex_argmax_float32 (const gfloat * scores, guint len, gfloat threshold);
+
+/**
+ * @brief Get the index of the highest score greater than the threshold (uint8 scores).
+ * @return index of the class, -1 if no score is greater than the threshold
+ */
+extern gint
+nns_ex_argmax_uint8 (const guint8 * scores, guint len,
+    const nns_ex_quant_s * quant, gfloat threshold);
+
+G_END_DECLS
+
+#endif /* __NNS_EX_TOPK_H__ */
@@ -0,0 +1,288 @@
+/**
+ * @file	nns_ex_track_sched.c
+ * @date	19 October 2026
+ * @brief	Detector runs at an adaptive stride, with the tracker filling the frames in between
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ */
+
+#include <string.h>
+
+#include "nns_ex_track_sched.h"
+
+/**
+ * @brief Data structure for the scheduler of the detector.
+ */
+struct _nns_ex_track_sched_s
+{
+  GMutex lock; /**< lock of the tracker and the metrics */
+  nns_ex_tracker_s *tracker; /**< tracker to fill the frames between the detections */
+  guint min_stride; /**< min stride of the detector */
+  guint max_stride; /**< max stride of the detector */
+  guint stride; /**< current stride of the detector */
+  GstClockTime frame_duration; /**< duration of a frame on the detector branch */
+  guint frames_waited; /**< count of the frames since the last detection */
+
+  GstClockTime result_pts; /**< timestamp of the frame detected last */
+  gint64 result_time; /**< monotonic time when the result is updated */
+  gboolean result_drawn; /**< true if the result is drawn */
+
+  nns_ex_track_sched_stats_s stats; /**< statistics */
+};
+
+/**
+ * @brief Add a sample to the latency metrics.
+ */
+void
+nns_ex_latency_stats_add (nns_ex_latency_stats_s * stats, GstClockTime latency)
+{
+  g_return_if_fail (stats != NULL);
+
+  stats->count++;
+  stats->total += latency;
+  stats->max = MAX (stats->max, latency);
+}
+
+/**
+ * @brief Print the average and max of the latency metrics.
+ */
+void
+nns_ex_latency_stats_print (const gchar * name,
+    const nns_ex_latency_stats_s * stats)
+{
+  g_return_if_fail (stats != NULL);
+
+  g_print ("%s : avg %.1f ms, max %.1f ms (%u samples)\n", name,
+      stats->count ? (gdouble) stats->total / stats->count / GST_MSECOND : 0.0,
+      (gdouble) stats->max / GST_MSECOND, stats->count);
+}
+
+/**
+ * @brief Create the scheduler of the detector.
+ */
+nns_ex_track_sched_s *
+nns_ex_track_sched_new (guint min_stride, guint max_stride, guint max_tracks,
+    gfloat iou_threshold, guint max_missed)
+{
+  nns_ex_track_sched_s *sched;
+  nns_ex_tracker_s *tracker;
+
+  g_return_val_if_fail (min_stride > 0, NULL);
+  g_return_val_if_fail (max_stride >= min_stride, NULL);
+
+  tracker = nns_ex_tracker_new (max_tracks, iou_threshold, max_missed);
+  if (tracker == NULL)
+    return NULL;
+
+  sched = g_new0 (nns_ex_track_sched_s, 1);
+  g_mutex_init (&sched->lock);
+  sched->tracker = tracker;
+  sched->min_stride = min_stride;
+  sched->max_stride = max_stride;
+  sched->stride = min_stride;
+  sched->frame_duration = NNS_EX_TRACK_SCHED_FRAME_DURATION;
+
+  /* no result to measure the age until the first detection */
+  sched->result_pts = GST_CLOCK_TIME_NONE;
+  sched->result_drawn = TRUE;
+  sched->stats.stride = min_stride;
+
+  return sched;
+}
+
+/**
+ * @brief Free the scheduler.
+ */
+void
+nns_ex_track_sched_free (nns_ex_track_sched_s * sched)
+{
+  g_return_if_fail (sched != NULL);
+
+  nns_ex_tracker_free (sched->tracker);
+  g_mutex_clear (&sched->lock);
+  g_free (sched);
+}
+
+/**
+ * @brief Check the frame on the detector branch.
+ */
+gboolean
+nns_ex_track_sched_pass_frame (nns_ex_track_sched_s * sched,
+    GstBuffer * buffer, guint min_stride)
+{
+  gboolean pass = FALSE;
+  guint stride;
+
+  g_return_val_if_fail (sched != NULL, TRUE);
+  g_return_val_if_fail (GST_IS_BUFFER (buffer), TRUE);
+
+  g_mutex_lock (&sched->lock);
+
+  if (GST_BUFFER_DURATION_IS_VALID (buffer) && GST_BUFFER_DURATION (buffer) > 0)
+    sched->frame_duration = GST_BUFFER_DURATION (buffer);
+
+  stride = MAX (sched->stride, min_stride);
+  sched->stats.frames_total++;
+
+  /* the tracker predicts the boxes of the skipped frames */
+  if (++sched->frames_waited >= stride) {
+    sched->frames_waited = 0;
+    sched->stats.frames_detected++;
+    pass = TRUE;
+  }
+
+  g_mutex_unlock (&sched->lock);
+
+  return pass;
+}
+
+/**
+ * @brief Update the tracks with the result of the detector, and the stride for the motion.
+ */
+void
+nns_ex_track_sched_update (nns_ex_track_sched_s * sched,
+    const nns_ex_box_s * boxes, guint num_boxes, GstClockTime timestamp)
+{
+  g_return_if_fail (sched != NULL);
+  g_return_if_fail (boxes != NULL || num_boxes == 0);
+
+  g_mutex_lock (&sched->lock);
+
+  nns_ex_tracker_update (sched->tracker, boxes, num_boxes, timestamp);
+
+  /* snapshot of the result, the overlay measures the age */
+  sched->result_pts = timestamp;
+  sched->result_time = g_get_monotonic_time ();
+  sched->result_drawn = FALSE;
+
+  sched->stride = nns_ex_tracker_get_stride (sched->tracker,
+      sched->frame_duration, sched->min_stride, sched->max_stride);
+  sched->stats.stride = sched->stride;
+
+  g_mutex_unlock (&sched->lock);
+}
+
+/**
+ * @brief Get the tracks predicted at the timestamp, without the metrics.
+ */
+guint
+nns_ex_track_sched_predict (nns_ex_track_sched_s * sched,
+    GstClockTime timestamp, nns_ex_track_s * tracks, guint max_tracks)
+{
+  guint n;
+
+  g_return_val_if_fail (sched != NULL, 0);
+  g_return_val_if_fail (tracks != NULL || max_tracks == 0, 0);
+
+  g_mutex_lock (&sched->lock);
+  n = nns_ex_tracker_predict (sched->tracker, timestamp, tracks, max_tracks);
+  g_mutex_unlock (&sched->lock);
+
+  return n;
+}
+
+/**
+ * @brief Get the tracks predicted at the timestamp of the frame to draw, and measure the result age.
+ */
+guint
+nns_ex_track_sched_predict_frame (nns_ex_track_sched_s * sched,
+    GstClockTime timestamp, GstClockTime running_time,
+    nns_ex_track_s * tracks, guint max_tracks, GstClockTime * age)
+{
+  nns_ex_track_sched_stats_s *stats;
+  GstClockTime result_age = GST_CLOCK_TIME_NONE;
+  guint n;
+
+  g_return_val_if_fail (sched != NULL, 0);
+  g_return_val_if_fail (tracks != NULL || max_tracks == 0, 0);
+
+  stats = &sched->stats;
+
+  g_mutex_lock (&sched->lock);
+  n = nns_ex_tracker_predict (sched->tracker, timestamp, tracks, max_tracks);
+
+  if (GST_CLOCK_TIME_IS_VALID (sched->result_pts) &&
+      timestamp >= sched->result_pts) {
+    result_age = timestamp - sched->result_pts;
+    nns_ex_latency_stats_add (&stats->result_age, result_age);
+
+    if (!sched->result_drawn) {
+      nns_ex_latency_stats_add (&stats->display_delay,
+          (g_get_monotonic_time () - sched->result_time) * GST_USECOND);
+      sched->result_drawn = TRUE;
+    }
+  }
+
+  if (GST_CLOCK_TIME_IS_VALID (running_time) && running_time >= timestamp)
+    nns_ex_latency_stats_add (&stats->overlay_latency, running_time - timestamp);
+
+  stats->frames_drawn++;
+  g_mutex_unlock (&sched->lock);
+
+  if (age)
+    *age = result_age;
+
+  return n;
+}
+
+/**
+ * @brief Get the text of the frame counter, the timestamp and the age of the result.
+ */
+gchar *
+nns_ex_track_sched_get_burn_in (nns_ex_track_sched_s * sched,
+    GstClockTime timestamp, GstClockTime age)
+{
+  gchar age_str[16];
+  guint frames_drawn;
+
+  g_return_val_if_fail (sched != NULL, NULL);
+
+  if (GST_CLOCK_TIME_IS_VALID (age))
+    g_snprintf (age_str, sizeof (age_str), "%.0f ms",
+        (gdouble) age / GST_MSECOND);
+  else
+    g_strlcpy (age_str, "-", sizeof (age_str));
+
+  g_mutex_lock (&sched->lock);
+  frames_drawn = sched->stats.frames_drawn;
+  g_mutex_unlock (&sched->lock);
+
+  return g_strdup_printf ("#%06u %" GST_TIME_FORMAT " age %s",
+      frames_drawn, GST_TIME_ARGS (timestamp), age_str);
+}
+
+/**
+ * @brief Get the statistics of the scheduler.
+ */
+void
+nns_ex_track_sched_get_stats (nns_ex_track_sched_s * sched,
+    nns_ex_track_sched_stats_s * stats)
+{
+  g_return_if_fail (sched != NULL);
+  g_return_if_fail (stats != NULL);
+
+  g_mutex_lock (&sched->lock);
+  memcpy (stats, &sched->stats, sizeof (nns_ex_track_sched_stats_s));
+  g_mutex_unlock (&sched->lock);
+}
+
+/**
+ * @brief Print the count of the detector runs and the latency metrics.
+ */
+void
+nns_ex_track_sched_print_stats (nns_ex_track_sched_s * sched, guint skipped)
+{
+  nns_ex_track_sched_stats_s stats;
+
+  g_return_if_fail (sched != NULL);
+
+  nns_ex_track_sched_get_stats (sched, &stats);
+
+  g_print ("detector ran on %u of %u frames\n",
+      stats.frames_detected - MIN (skipped, stats.frames_detected),
+      stats.frames_total);
+
+  nns_ex_latency_stats_print ("result age", &stats.result_age);
+  nns_ex_latency_stats_print ("inference to display", &stats.display_delay);
+  nns_ex_latency_stats_print ("capture to overlay", &stats.overlay_latency);
+}
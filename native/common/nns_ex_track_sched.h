@@ -0,0 +1,178 @@
+/**
+ * @file	nns_ex_track_sched.h
+ * @date	19 October 2026
+ * @brief	Detector runs at an adaptive stride, with the tracker filling the frames in between
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * The detection examples share the same glue around the tracker (see nns_ex_tracker.h) :
+ * - the detector branch passes a frame every stride, the stride is adapted to the motion of the tracks
+ * - the result of the detector updates the tracks, and is kept as the snapshot with its timestamp
+ * - the overlay draws the tracks predicted at the timestamp of each frame, and measures the age of the result
+ *   (timestamp of the frame - timestamp of the result), the delay from the result to the first frame showing it,
+ *   and the latency from the capture to the overlay
+ *
+ * The functions are called from the different threads, the scheduler has its own lock.
+ *
+ * Usage :
+ *
+ * sched = nns_ex_track_sched_new (min_stride, max_stride, 32, .3f, 2);
+ *
+ * (the pad probe before the detector)
+ * if (!nns_ex_track_sched_pass_frame (sched, buffer, qos_stride))
+ *   return GST_PAD_PROBE_DROP;
+ *
+ * (the worker, with the result of the detector)
+ * nns_ex_track_sched_update (sched, boxes, n, GST_BUFFER_PTS (buffer));
+ *
+ * (the overlay, for each frame)
+ * n = nns_ex_track_sched_predict_frame (sched, timestamp, running_time, tracks, MAX_OBJECT_DETECTION, &age);
+ *
+ * (at exit)
+ * nns_ex_track_sched_print_stats (sched, 0);
+ */
+
+#ifndef __NNS_EX_TRACK_SCHED_H__
+#define __NNS_EX_TRACK_SCHED_H__
+
+#include <glib.h>
+#include <gst/gst.h>
+
+#include "nns_ex_tracker.h"
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Frame duration (in nanoseconds) until the frames on the detector branch set it.
+ */
+#define NNS_EX_TRACK_SCHED_FRAME_DURATION (GST_SECOND / 30)
+
+/**
+ * @brief Data structure for latency metrics.
+ */
+typedef struct
+{
+  guint count; /**< count of the samples */
+  GstClockTime total; /**< sum of the latency */
+  GstClockTime max; /**< max latency */
+} nns_ex_latency_stats_s;
+
+/**
+ * @brief Statistics of the detector runs and the results drawn.
+ */
+typedef struct
+{
+  guint stride; /**< current stride of the detector */
+  guint frames_total; /**< count of the frames to the detector branch */
+  guint frames_detected; /**< count of the frames passed to the detector */
+  guint frames_drawn; /**< count of the frames drawn */
+  nns_ex_latency_stats_s result_age; /**< timestamp of the frame drawn - timestamp of the result */
+  nns_ex_latency_stats_s display_delay; /**< time from the result to the first frame showing it */
+  nns_ex_latency_stats_s overlay_latency; /**< running time at the overlay - timestamp of the frame */
+} nns_ex_track_sched_stats_s;
+
+/**
+ * @brief Opaque data structure for the scheduler of the detector.
+ */
+typedef struct _nns_ex_track_sched_s nns_ex_track_sched_s;
+
+/**
+ * @brief Add a sample to the latency metrics.
+ */
+extern void
+nns_ex_latency_stats_add (nns_ex_latency_stats_s * stats, GstClockTime latency);
+
+/**
+ * @brief Print the average and max of the latency metrics.
+ */
+extern void
+nns_ex_latency_stats_print (const gchar * name,
+    const nns_ex_latency_stats_s * stats);
+
+/**
+ * @brief Create the scheduler of the detector.
+ * @param min_stride stride when the objects move fast, appear or disappear
+ * @param max_stride stride when the scene is steady (1 to run the detector on every frame)
+ * @param max_tracks max number of the tracks
+ * @param iou_threshold min IoU to associate a detection with a track
+ * @param max_missed count of the detector runs to keep a track without the detection
+ * @return newly allocated scheduler, NULL if the parameters are invalid
+ */
+extern nns_ex_track_sched_s *
+nns_ex_track_sched_new (guint min_stride, guint max_stride, guint max_tracks,
+    gfloat iou_threshold, guint max_missed);
+
+/**
+ * @brief Free the scheduler.
+ */
+extern void
+nns_ex_track_sched_free (nns_ex_track_sched_s * sched);
+
+/**
+ * @brief Check the frame on the detector branch (the streaming thread of the branch).
+ * @param buffer the frame, its duration updates the frame duration of the stride
+ * @param min_stride the stride is at least this (e.g., raised by the QoS controller), 0 to ignore
+ * @return TRUE to pass the frame to the detector, FALSE to drop it (the tracker predicts the boxes)
+ */
+extern gboolean
+nns_ex_track_sched_pass_frame (nns_ex_track_sched_s * sched,
+    GstBuffer * buffer, guint min_stride);
+
+/**
+ * @brief Update the tracks with the result of the detector, and the stride for the motion.
+ * @param boxes detected boxes (the higher score first, e.g., after NMS)
+ * @param num_boxes number of the boxes
+ * @param timestamp timestamp of the frame given to the detector
+ */
+extern void
+nns_ex_track_sched_update (nns_ex_track_sched_s * sched,
+    const nns_ex_box_s * boxes, guint num_boxes, GstClockTime timestamp);
+
+/**
+ * @brief Get the tracks predicted at the timestamp, without the metrics (e.g., to select the region to detect).
+ * @return number of the tracks
+ */
+extern guint
+nns_ex_track_sched_predict (nns_ex_track_sched_s * sched,
+    GstClockTime timestamp, nns_ex_track_s * tracks, guint max_tracks);
+
+/**
+ * @brief Get the tracks predicted at the timestamp of the frame to draw, and measure the result age.
+ * @param timestamp timestamp of the frame to draw
+ * @param running_time running time at the overlay (GST_CLOCK_TIME_NONE if unknown)
+ * @param tracks the tracks, the higher score first
+ * @param max_tracks max number of the tracks to get
+ * @param age age of the result shown on the frame (GST_CLOCK_TIME_NONE if no result yet), can be NULL
+ * @return number of the tracks
+ */
+extern guint
+nns_ex_track_sched_predict_frame (nns_ex_track_sched_s * sched,
+    GstClockTime timestamp, GstClockTime running_time,
+    nns_ex_track_s * tracks, guint max_tracks, GstClockTime * age);
+
+/**
+ * @brief Get the text of the frame counter, the timestamp and the age of the result
+ * to draw on the frame, to measure the capture-to-display latency from the recordings.
+ * @return newly allocated text, free it with g_free()
+ */
+extern gchar *
+nns_ex_track_sched_get_burn_in (nns_ex_track_sched_s * sched,
+    GstClockTime timestamp, GstClockTime age);
+
+/**
+ * @brief Get the statistics of the scheduler.
+ */
+extern void
+nns_ex_track_sched_get_stats (nns_ex_track_sched_s * sched,
+    nns_ex_track_sched_stats_s * stats);
+
+/**
+ * @brief Print the count of the detector runs and the latency metrics.
+ * @param skipped count of the frames passed by the stride and skipped before the detector (e.g., by the motion gate)
+ */
+extern void
+nns_ex_track_sched_print_stats (nns_ex_track_sched_s * sched, guint skipped);
+
+G_END_DECLS
+
+#endif /* __NNS_EX_TRACK_SCHED_H__ */
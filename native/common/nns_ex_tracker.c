@@ -0,0 +1,449 @@
+/**
+ * @file	nns_ex_tracker.c
+ * @date	19 October 2026
+ * @brief	Multi-object tracker to fill the frames between the detector runs
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "nns_ex_tracker.h"
+
+/**
+ * @brief Standard deviation of the measurement (ratio to the box size).
+ */
+#define TRACKER_MEASURE_NOISE 0.05f
+
+/**
+ * @brief Standard deviation of the acceleration (ratio to the box size, per second^2).
+ */
+#define TRACKER_ACCEL_NOISE 2.0f
+
+/**
+ * @brief Standard deviation of the initial velocity (ratio to the box size, per second).
+ */
+#define TRACKER_INIT_VEL_NOISE 1.0f
+
+/**
+ * @brief Index of the filtered values (center and size of the box).
+ */
+enum
+{
+  AXIS_CX = 0,
+  AXIS_CY,
+  AXIS_W,
+  AXIS_H,
+  AXIS_MAX
+};
+
+/**
+ * @brief Constant-velocity Kalman filter of a value.
+ */
+typedef struct
+{
+  gfloat pos; /**< value */
+  gfloat vel; /**< velocity (per second) */
+  gfloat p00; /**< covariance of the value */
+  gfloat p01; /**< covariance of the value and velocity */
+  gfloat p11; /**< covariance of the velocity */
+} _kalman_s;
+
+/**
+ * @brief Data structure for a track.
+ */
+typedef struct
+{
+  guint id; /**< unique id */
+  gint class_id; /**< class of the object */
+  gfloat prob; /**< score of the last detection */
+  _kalman_s kf[AXIS_MAX]; /**< filters of the box */
+  guint hits; /**< count of the associated detections */
+  guint missed; /**< count of the detector runs without the object */
+} _track_s;
+
+/**
+ * @brief Data structure for the tracker.
+ */
+struct _nns_ex_tracker_s
+{
+  _track_s *tracks; /**< tracks */
+  guint num_tracks; /**< number of the tracks */
+  guint max_tracks; /**< max number of the tracks */
+  gboolean *matched; /**< true if the detection is associated (max_tracks) */
+  gfloat iou_threshold; /**< min IoU to associate */
+  guint max_missed; /**< count of the detector runs to keep a track */
+  guint next_id; /**< id of the next track */
+  guint64 timestamp; /**< timestamp of the last update */
+  gboolean updated; /**< true after the first update */
+  gboolean changed; /**< true if a track is created or lost in the last update */
+};
+
+/**
+ * @brief Get the time (in seconds) from the last update, clamped to the max prediction.
+ */
+static gfloat
+_tracker_elapsed (nns_ex_tracker_s * tracker, guint64 timestamp)
+{
+  guint64 diff;
+
+  if (!tracker->updated)
+    return 0.0f;
+
+  if (timestamp >= tracker->timestamp) {
+    diff = MIN (timestamp - tracker->timestamp, NNS_EX_TRACKER_MAX_PREDICTION);
+    return diff / 1e9f;
+  }
+
+  diff = MIN (tracker->timestamp - timestamp, NNS_EX_TRACKER_MAX_PREDICTION);
+  return -(diff / 1e9f);
+}
+
+/**
+ * @brief Get the size of the track to scale the noise.
+ */
+static inline gfloat
+_track_size (const _track_s * track)
+{
+  return MAX (MAX (track->kf[AXIS_W].pos, track->kf[AXIS_H].pos), 1.0f);
+}
+
+/**
+ * @brief Init the filter with the measurement.
+ */
+static void
+_kalman_init (_kalman_s * kf, gfloat value, gfloat size)
+{
+  gfloat r = TRACKER_MEASURE_NOISE * size;
+  gfloat v = TRACKER_INIT_VEL_NOISE * size;
+
+  kf->pos = value;
+  kf->vel = 0.0f;
+  kf->p00 = r * r;
+  kf->p01 = 0.0f;
+  kf->p11 = v * v;
+}
+
+/**
+ * @brief Predict the filter after dt seconds.
+ */
+static void
+_kalman_predict (_kalman_s * kf, gfloat dt, gfloat size)
+{
+  gfloat q = TRACKER_ACCEL_NOISE * size;
+  gfloat dt2 = dt * dt;
+
+  q = q * q;
+
+  kf->pos += kf->vel * dt;
+
+  /* P = F P F' + Q, F = [1 dt; 0 1] */
+  kf->p00 += dt * (2.0f * kf->p01 + dt * kf->p11) + q * dt2 * dt / 3.0f;
+  kf->p01 += dt * kf->p11 + q * dt2 / 2.0f;
+  kf->p11 += q * dt;
+}
+
+/**
+ * @brief Correct the filter with the measurement.
+ */
+static void
+_kalman_correct (_kalman_s * kf, gfloat value, gfloat size)
+{
+  gfloat r = TRACKER_MEASURE_NOISE * size;
+  gfloat s, k0, k1, residual;
+
+  s = kf->p00 + r * r;
+  k0 = kf->p00 / s;
+  k1 = kf->p01 / s;
+  residual = value - kf->pos;
+
+  kf->pos += k0 * residual;
+  kf->vel += k1 * residual;
+
+  kf->p11 -= k1 * kf->p01;
+  kf->p01 -= k0 * kf->p01;
+  kf->p00 -= k0 * kf->p00;
+}
+
+/**
+ * @brief Get the box of the track after dt seconds.
+ */
+static void
+_track_get_box (const _track_s * track, gfloat dt, nns_ex_box_s * box)
+{
+  gfloat cx, cy, w, h;
+
+  cx = track->kf[AXIS_CX].pos + track->kf[AXIS_CX].vel * dt;
+  cy = track->kf[AXIS_CY].pos + track->kf[AXIS_CY].vel * dt;
+  w = MAX (track->kf[AXIS_W].pos + track->kf[AXIS_W].vel * dt, 1.0f);
+  h = MAX (track->kf[AXIS_H].pos + track->kf[AXIS_H].vel * dt, 1.0f);
+
+  box->x = cx - w / 2.0f;
+  box->y = cy - h / 2.0f;
+  box->width = w;
+  box->height = h;
+  box->class_id = track->class_id;
+  box->prob = track->prob;
+}
+
+/**
+ * @brief Get the intersection over union of the boxes.
+ */
+static gfloat
+_box_iou (const nns_ex_box_s * a, const nns_ex_box_s * b)
+{
+  gfloat x1, y1, x2, y2, inter, area;
+
+  x1 = MAX (a->x, b->x);
+  y1 = MAX (a->y, b->y);
+  x2 = MIN (a->x + a->width, b->x + b->width);
+  y2 = MIN (a->y + a->height, b->y + b->height);
+
+  if (x2 <= x1 || y2 <= y1)
+    return 0.0f;
+
+  inter = (x2 - x1) * (y2 - y1);
+  area = a->width * a->height + b->width * b->height - inter;
+
+  return (area > 0.0f) ? inter / area : 0.0f;
+}
+
+/**
+ * @brief Create the tracker.
+ */
+nns_ex_tracker_s *
+nns_ex_tracker_new (guint max_tracks, gfloat iou_threshold, guint max_missed)
+{
+  nns_ex_tracker_s *tracker;
+
+  g_return_val_if_fail (max_tracks > 0, NULL);
+  g_return_val_if_fail (iou_threshold > 0.0f && iou_threshold <= 1.0f, NULL);
+
+  tracker = g_new0 (nns_ex_tracker_s, 1);
+  tracker->tracks = g_new0 (_track_s, max_tracks);
+  tracker->matched = g_new0 (gboolean, max_tracks);
+  tracker->max_tracks = max_tracks;
+  tracker->iou_threshold = iou_threshold;
+  tracker->max_missed = max_missed;
+  tracker->next_id = 1;
+
+  return tracker;
+}
+
+/**
+ * @brief Free the tracker.
+ */
+void
+nns_ex_tracker_free (nns_ex_tracker_s * tracker)
+{
+  g_return_if_fail (tracker != NULL);
+
+  g_free (tracker->tracks);
+  g_free (tracker->matched);
+  g_free (tracker);
+}
+
+/**
+ * @brief Update the tracks with the result of the detector.
+ */
+void
+nns_ex_tracker_update (nns_ex_tracker_s * tracker, const nns_ex_box_s * boxes,
+    guint num_boxes, guint64 timestamp)
+{
+  _track_s *track;
+  nns_ex_box_s box;
+  gfloat dt, size, iou, best_iou;
+  guint i, j, a, best_track, best_box, num_matched;
+
+  g_return_if_fail (tracker != NULL);
+  g_return_if_fail (boxes != NULL || num_boxes == 0);
+
+  /* the boxes after max_tracks cannot be tracked */
+  num_boxes = MIN (num_boxes, tracker->max_tracks);
+
+  /* the outputs of the detector are in order, the older timestamp is unexpected */
+  dt = MAX (_tracker_elapsed (tracker, timestamp), 0.0f);
+  tracker->changed = FALSE;
+
+  /* predict the tracks at the timestamp of the detection */
+  for (i = 0; i < tracker->num_tracks; i++) {
+    track = &tracker->tracks[i];
+    size = _track_size (track);
+
+    for (a = 0; a < AXIS_MAX; a++)
+      _kalman_predict (&track->kf[a], dt, size);
+
+    track->missed++;
+  }
+
+  memset (tracker->matched, 0, sizeof (gboolean) * tracker->max_tracks);
+
+  /* greedy association, the pair with the highest IoU first */
+  for (num_matched = 0; num_matched < MIN (num_boxes, tracker->num_tracks);
+      num_matched++) {
+    best_iou = 0.0f;
+    best_track = best_box = 0;
+
+    for (i = 0; i < tracker->num_tracks; i++) {
+      track = &tracker->tracks[i];
+
+      /* already associated in this update */
+      if (track->missed == 0)
+        continue;
+
+      _track_get_box (track, 0.0f, &box);
+
+      for (j = 0; j < num_boxes; j++) {
+        if (tracker->matched[j] || boxes[j].class_id != track->class_id)
+          continue;
+
+        iou = _box_iou (&box, &boxes[j]);
+        if (iou > best_iou) {
+          best_iou = iou;
+          best_track = i;
+          best_box = j;
+        }
+      }
+    }
+
+    if (best_iou < tracker->iou_threshold)
+      break;
+
+    track = &tracker->tracks[best_track];
+    size = _track_size (track);
+
+    _kalman_correct (&track->kf[AXIS_CX],
+        boxes[best_box].x + boxes[best_box].width / 2.0f, size);
+    _kalman_correct (&track->kf[AXIS_CY],
+        boxes[best_box].y + boxes[best_box].height / 2.0f, size);
+    _kalman_correct (&track->kf[AXIS_W], boxes[best_box].width, size);
+    _kalman_correct (&track->kf[AXIS_H], boxes[best_box].height, size);
+
+    track->prob = boxes[best_box].prob;
+    track->hits++;
+    track->missed = 0;
+    tracker->matched[best_box] = TRUE;
+  }
+
+  /* remove the lost tracks */
+  for (i = 0, j = 0; i < tracker->num_tracks; i++) {
+    if (tracker->tracks[i].missed > tracker->max_missed) {
+      tracker->changed = TRUE;
+      continue;
+    }
+
+    if (i != j)
+      tracker->tracks[j] = tracker->tracks[i];
+    j++;
+  }
+  tracker->num_tracks = j;
+
+  /* new tracks with the detections not associated */
+  for (j = 0; j < num_boxes; j++) {
+    if (tracker->matched[j] || tracker->num_tracks >= tracker->max_tracks)
+      continue;
+
+    track = &tracker->tracks[tracker->num_tracks++];
+    size = MAX (MAX (boxes[j].width, boxes[j].height), 1.0f);
+
+    track->id = tracker->next_id++;
+    track->class_id = boxes[j].class_id;
+    track->prob = boxes[j].prob;
+    track->hits = 1;
+    track->missed = 0;
+
+    _kalman_init (&track->kf[AXIS_CX], boxes[j].x + boxes[j].width / 2.0f,
+        size);
+    _kalman_init (&track->kf[AXIS_CY], boxes[j].y + boxes[j].height / 2.0f,
+        size);
+    _kalman_init (&track->kf[AXIS_W], boxes[j].width, size);
+    _kalman_init (&track->kf[AXIS_H], boxes[j].height, size);
+
+    tracker->changed = TRUE;
+  }
+
+  tracker->timestamp = timestamp;
+  tracker->updated = TRUE;
+}
+
+/**
+ * @brief Get the tracks predicted at the timestamp.
+ */
+guint
+nns_ex_tracker_predict (nns_ex_tracker_s * tracker, guint64 timestamp,
+    nns_ex_track_s * tracks, guint max_tracks)
+{
+  const _track_s *track;
+  gfloat dt;
+  guint i, n, pos;
+
+  g_return_val_if_fail (tracker != NULL, 0);
+  g_return_val_if_fail (tracks != NULL || max_tracks == 0, 0);
+
+  dt = _tracker_elapsed (tracker, timestamp);
+
+  /* insertion by score, the list is short */
+  for (i = 0, n = 0; i < tracker->num_tracks; i++) {
+    track = &tracker->tracks[i];
+
+    for (pos = n; pos > 0 && tracks[pos - 1].box.prob < track->prob; pos--) {
+      if (pos < max_tracks)
+        tracks[pos] = tracks[pos - 1];
+    }
+
+    if (pos >= max_tracks)
+      continue;
+
+    tracks[pos].id = track->id;
+    tracks[pos].hits = track->hits;
+    tracks[pos].missed = track->missed;
+    _track_get_box (track, dt, &tracks[pos].box);
+
+    if (n < max_tracks)
+      n++;
+  }
+
+  return n;
+}
+
+/**
+ * @brief Get the stride of the detector for the current motion.
+ */
+guint
+nns_ex_tracker_get_stride (nns_ex_tracker_s * tracker, guint64 frame_duration,
+    guint min_stride, guint max_stride)
+{
+  const _track_s *track;
+  gfloat speed, max_speed = 0.0f;
+  gfloat frame_sec, stride;
+  guint i;
+
+  g_return_val_if_fail (tracker != NULL, 1);
+
+  min_stride = MAX (min_stride, 1);
+  max_stride = MAX (max_stride, min_stride);
+
+  if (tracker->changed || frame_duration == 0)
+    return min_stride;
+
+  /* speed of the tracks, box sizes per second */
+  for (i = 0; i < tracker->num_tracks; i++) {
+    track = &tracker->tracks[i];
+
+    /* velocity is not estimated yet */
+    if (track->hits < 2)
+      return min_stride;
+
+    speed = sqrtf (track->kf[AXIS_CX].vel * track->kf[AXIS_CX].vel +
+        track->kf[AXIS_CY].vel * track->kf[AXIS_CY].vel) / _track_size (track);
+    max_speed = MAX (max_speed, speed);
+  }
+
+  frame_sec = frame_duration / 1e9f;
+  if (max_speed * frame_sec * max_stride <= NNS_EX_TRACKER_MOTION_TOLERANCE)
+    return max_stride;
+
+  stride = NNS_EX_TRACKER_MOTION_TOLERANCE / (max_speed * frame_sec);
+  return CLAMP ((guint) stride, min_stride, max_stride);
+}
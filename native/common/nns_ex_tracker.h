@@ -0,0 +1,123 @@
+/**
+ * @file	nns_ex_tracker.h
+ * @date	19 October 2026
+ * @brief	Multi-object tracker to fill the frames between the detector runs
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * The detections are associated with the tracks by IoU (same class, greedy with the highest IoU first),
+ * and each track has a constant-velocity Kalman filter for the center and size of the box.
+ * The app can run the detector every Nth frame, and draw the boxes predicted at the timestamp
+ * of each frame in between.
+ *
+ * The stride of the detector is adapted to the motion: the tracks move less than
+ * NNS_EX_TRACKER_MOTION_TOLERANCE of the box size between the detector runs.
+ * When a track is created or lost, the stride is reset to the minimum.
+ *
+ * Usage :
+ *
+ * (the worker, with the result of the detector)
+ * nns_ex_tracker_update (tracker, boxes, n, GST_BUFFER_PTS (buffer));
+ * stride = nns_ex_tracker_get_stride (tracker, frame_duration, 1, 6);
+ *
+ * (the overlay, for each frame)
+ * n = nns_ex_tracker_predict (tracker, timestamp, tracks, MAX_OBJECT_DETECTION);
+ */
+
+#ifndef __NNS_EX_TRACKER_H__
+#define __NNS_EX_TRACKER_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Max displacement of a track (ratio to the box size) between the detector runs.
+ */
+#define NNS_EX_TRACKER_MOTION_TOLERANCE 0.25f
+
+/**
+ * @brief Max time (in nanoseconds) to extrapolate the tracks.
+ */
+#define NNS_EX_TRACKER_MAX_PREDICTION (G_GUINT64_CONSTANT (1000000000))
+
+/**
+ * @brief Data structure for a box.
+ */
+typedef struct
+{
+  gfloat x; /**< left */
+  gfloat y; /**< top */
+  gfloat width; /**< width */
+  gfloat height; /**< height */
+  gint class_id; /**< class of the object */
+  gfloat prob; /**< score of the object */
+} nns_ex_box_s;
+
+/**
+ * @brief Data structure for a track.
+ */
+typedef struct
+{
+  guint id; /**< unique id of the track */
+  nns_ex_box_s box; /**< box of the object (predicted) */
+  guint hits; /**< count of the associated detections */
+  guint missed; /**< count of the detector runs without the object */
+} nns_ex_track_s;
+
+/**
+ * @brief Opaque data structure for the tracker.
+ */
+typedef struct _nns_ex_tracker_s nns_ex_tracker_s;
+
+/**
+ * @brief Create the tracker.
+ * @param max_tracks max number of the tracks
+ * @param iou_threshold min IoU to associate a detection with a track
+ * @param max_missed count of the detector runs to keep a track without the detection
+ * @return newly allocated tracker, NULL if the parameters are invalid
+ */
+extern nns_ex_tracker_s *
+nns_ex_tracker_new (guint max_tracks, gfloat iou_threshold, guint max_missed);
+
+/**
+ * @brief Free the tracker.
+ */
+extern void
+nns_ex_tracker_free (nns_ex_tracker_s * tracker);
+
+/**
+ * @brief Update the tracks with the result of the detector.
+ * @param boxes detected boxes (the higher score first, e.g., after NMS)
+ * @param num_boxes number of the boxes
+ * @param timestamp timestamp (in nanoseconds) of the frame given to the detector
+ */
+extern void
+nns_ex_tracker_update (nns_ex_tracker_s * tracker, const nns_ex_box_s * boxes,
+    guint num_boxes, guint64 timestamp);
+
+/**
+ * @brief Get the tracks predicted at the timestamp. The tracker is not changed.
+ * @param timestamp timestamp (in nanoseconds) of the frame to draw
+ * @param tracks the tracks, the higher score first
+ * @param max_tracks max number of the tracks to get
+ * @return number of the tracks
+ */
+extern guint
+nns_ex_tracker_predict (nns_ex_tracker_s * tracker, guint64 timestamp,
+    nns_ex_track_s * tracks, guint max_tracks);
+
+/**
+ * @brief Get the stride of the detector for the current motion.
+ * @param frame_duration duration (in nanoseconds) of a frame
+ * @param min_stride stride when the objects move fast, appear or disappear
+ * @param max_stride stride when the scene is steady
+ * @return the stride, run the detector every stride-th frame
+ */
+extern guint
+nns_ex_tracker_get_stride (nns_ex_tracker_s * tracker, guint64 frame_duration,
+    guint min_stride, guint max_stride);
+
+G_END_DECLS
+
+#endif /* __NNS_EX_TRACKER_H__ */
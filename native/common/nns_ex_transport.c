@@ -0,0 +1,264 @@
+/**
+ * @file	nns_ex_transport.c
+ * @date	19 October 2026
+ * @brief	Framing of the raw frames and tensors between the devices (TCP)
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ */
+
+#include <string.h>
+
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#endif
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "nns_ex_transport.h"
+
+/**
+ * @brief Get the codec from the name (none, lz4 or zstd).
+ */
+nns_ex_transport_codec_e
+nns_ex_transport_codec_from_string (const gchar * name)
+{
+  if (name == NULL || g_ascii_strcasecmp (name, "none") == 0)
+    return NNS_EX_TRANSPORT_CODEC_NONE;
+
+  if (g_ascii_strcasecmp (name, "lz4") == 0)
+    return NNS_EX_TRANSPORT_CODEC_LZ4;
+
+  if (g_ascii_strcasecmp (name, "zstd") == 0)
+    return NNS_EX_TRANSPORT_CODEC_ZSTD;
+
+  return NNS_EX_TRANSPORT_CODEC_UNKNOWN;
+}
+
+/**
+ * @brief Get the name of the codec.
+ */
+const gchar *
+nns_ex_transport_codec_to_string (nns_ex_transport_codec_e codec)
+{
+  switch (codec) {
+    case NNS_EX_TRANSPORT_CODEC_NONE:
+      return "none";
+    case NNS_EX_TRANSPORT_CODEC_LZ4:
+      return "lz4";
+    case NNS_EX_TRANSPORT_CODEC_ZSTD:
+      return "zstd";
+    default:
+      break;
+  }
+
+  return "unknown";
+}
+
+/**
+ * @brief Check the codec is built (the library is found).
+ */
+gboolean
+nns_ex_transport_codec_supported (nns_ex_transport_codec_e codec)
+{
+  switch (codec) {
+    case NNS_EX_TRANSPORT_CODEC_NONE:
+      return TRUE;
+#ifdef HAVE_LZ4
+    case NNS_EX_TRANSPORT_CODEC_LZ4:
+      return TRUE;
+#endif
+#ifdef HAVE_ZSTD
+    case NNS_EX_TRANSPORT_CODEC_ZSTD:
+      return TRUE;
+#endif
+    default:
+      break;
+  }
+
+  return FALSE;
+}
+
+/**
+ * @brief Write the header of the frame.
+ */
+void
+nns_ex_transport_header_write (const nns_ex_transport_header_s * header,
+    guint8 * data)
+{
+  guint32 v32;
+  guint64 v64;
+  guint16 v16;
+
+  g_return_if_fail (header != NULL && data != NULL);
+
+  v32 = GUINT32_TO_BE (NNS_EX_TRANSPORT_MAGIC);
+  memcpy (data, &v32, 4);
+  data[4] = NNS_EX_TRANSPORT_VERSION;
+  data[5] = (guint8) header->codec;
+  v16 = GUINT16_TO_BE (header->flags);
+  memcpy (data + 6, &v16, 2);
+  v32 = GUINT32_TO_BE (header->seq);
+  memcpy (data + 8, &v32, 4);
+  v64 = GUINT64_TO_BE (header->pts);
+  memcpy (data + 12, &v64, 8);
+  v64 = GUINT64_TO_BE (header->duration);
+  memcpy (data + 20, &v64, 8);
+  v32 = GUINT32_TO_BE (header->caps_size);
+  memcpy (data + 28, &v32, 4);
+  v32 = GUINT32_TO_BE (header->raw_size);
+  memcpy (data + 32, &v32, 4);
+  v32 = GUINT32_TO_BE (header->payload_size);
+  memcpy (data + 36, &v32, 4);
+}
+
+/**
+ * @brief Read the header of the frame.
+ */
+gboolean
+nns_ex_transport_header_read (const guint8 * data,
+    nns_ex_transport_header_s * header)
+{
+  guint32 v32;
+  guint64 v64;
+  guint16 v16;
+
+  g_return_val_if_fail (data != NULL && header != NULL, FALSE);
+
+  memcpy (&v32, data, 4);
+  if (GUINT32_FROM_BE (v32) != NNS_EX_TRANSPORT_MAGIC ||
+      data[4] != NNS_EX_TRANSPORT_VERSION ||
+      data[5] >= NNS_EX_TRANSPORT_CODEC_UNKNOWN)
+    return FALSE;
+
+  header->codec = (nns_ex_transport_codec_e) data[5];
+  memcpy (&v16, data + 6, 2);
+  header->flags = GUINT16_FROM_BE (v16);
+  memcpy (&v32, data + 8, 4);
+  header->seq = GUINT32_FROM_BE (v32);
+  memcpy (&v64, data + 12, 8);
+  header->pts = GUINT64_FROM_BE (v64);
+  memcpy (&v64, data + 20, 8);
+  header->duration = GUINT64_FROM_BE (v64);
+  memcpy (&v32, data + 28, 4);
+  header->caps_size = GUINT32_FROM_BE (v32);
+  memcpy (&v32, data + 32, 4);
+  header->raw_size = GUINT32_FROM_BE (v32);
+  memcpy (&v32, data + 36, 4);
+  header->payload_size = GUINT32_FROM_BE (v32);
+
+  /* the raw payload is not compressed */
+  if (header->codec == NNS_EX_TRANSPORT_CODEC_NONE &&
+      header->payload_size != header->raw_size)
+    return FALSE;
+
+  return TRUE;
+}
+
+/**
+ * @brief Get the max size of the compressed payload.
+ */
+gsize
+nns_ex_transport_compress_bound (nns_ex_transport_codec_e codec, gsize size)
+{
+  switch (codec) {
+#ifdef HAVE_LZ4
+    case NNS_EX_TRANSPORT_CODEC_LZ4:
+      return (size <= LZ4_MAX_INPUT_SIZE) ?
+          (gsize) LZ4_compressBound ((int) size) : 0;
+#endif
+#ifdef HAVE_ZSTD
+    case NNS_EX_TRANSPORT_CODEC_ZSTD:
+      return ZSTD_compressBound (size);
+#endif
+    default:
+      break;
+  }
+
+  return size;
+}
+
+/**
+ * @brief Compress the payload.
+ */
+gsize
+nns_ex_transport_compress (nns_ex_transport_codec_e codec, gint level,
+    const guint8 * src, gsize size, guint8 * dst, gsize dst_size)
+{
+  gsize out = 0;
+
+  g_return_val_if_fail (src != NULL && dst != NULL, 0);
+
+  switch (codec) {
+#ifdef HAVE_LZ4
+    case NNS_EX_TRANSPORT_CODEC_LZ4:
+    {
+      int ret;
+
+      if (size > LZ4_MAX_INPUT_SIZE || dst_size > G_MAXINT)
+        break;
+
+      ret = LZ4_compress_fast ((const char *) src, (char *) dst, (int) size,
+          (int) dst_size, MAX (level, 1));
+      out = (ret > 0) ? (gsize) ret : 0;
+      break;
+    }
+#endif
+#ifdef HAVE_ZSTD
+    case NNS_EX_TRANSPORT_CODEC_ZSTD:
+    {
+      size_t ret;
+
+      ret = ZSTD_compress (dst, dst_size, src, size,
+          CLAMP (level, 1, ZSTD_maxCLevel ()));
+      out = ZSTD_isError (ret) ? 0 : ret;
+      break;
+    }
+#endif
+    default:
+      break;
+  }
+
+  /* send the raw payload if it is not smaller */
+  return (out < size) ? out : 0;
+}
+
+/**
+ * @brief Decompress the payload.
+ */
+gboolean
+nns_ex_transport_decompress (nns_ex_transport_codec_e codec,
+    const guint8 * src, gsize size, guint8 * dst, gsize raw_size)
+{
+  g_return_val_if_fail (src != NULL && dst != NULL, FALSE);
+
+  switch (codec) {
+    case NNS_EX_TRANSPORT_CODEC_NONE:
+      if (size != raw_size)
+        return FALSE;
+
+      memcpy (dst, src, size);
+      return TRUE;
+#ifdef HAVE_LZ4
+    case NNS_EX_TRANSPORT_CODEC_LZ4:
+      if (size > G_MAXINT || raw_size > G_MAXINT)
+        return FALSE;
+
+      return (LZ4_decompress_safe ((const char *) src, (char *) dst,
+              (int) size, (int) raw_size) == (int) raw_size);
+#endif
+#ifdef HAVE_ZSTD
+    case NNS_EX_TRANSPORT_CODEC_ZSTD:
+    {
+      size_t ret = ZSTD_decompress (dst, raw_size, src, size);
+
+      return (!ZSTD_isError (ret) && ret == raw_size);
+    }
+#endif
+    default:
+      break;
+  }
+
+  return FALSE;
+}
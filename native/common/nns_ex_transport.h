@@ -0,0 +1,195 @@
+/**
+ * @file	nns_ex_transport.h
+ * @date	19 October 2026
+ * @brief	Framing of the raw frames and tensors between the devices (TCP)
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * The elements 'nns_ex_tensor_pay' and 'nns_ex_tensor_depay' send the buffers (other/tensor, video/x-raw, ...)
+ * over the byte stream of tcpserversink and tcpclientsrc, without the JPEG encoding and decoding
+ * in each hop. Each buffer is a frame of the header, the caps string and the payload.
+ *
+ * Header (network byte order, NNS_EX_TRANSPORT_HEADER_SIZE bytes) :
+ * magic 'NNSX' (4), version (1), codec (1), flags (2), sequence number (4), pts (8), duration (8),
+ * size of the caps string (4), size of the raw payload (4), size of the payload (4)
+ *
+ * The caps are in every frame, so that the client connected later gets the caps,
+ * and the receiver parses the caps only when they are changed. The payload is compressed
+ * with LZ4 or zstd if the library is found in the build (HAVE_LZ4, HAVE_ZSTD),
+ * and sent raw if the compressed payload is not smaller. The raw video frames are sent with the default strides
+ * of the caps (the elements before the payloader do not add the video meta).
+ *
+ * Usage :
+ *
+ * gst_init (&argc, &argv);
+ * nns_ex_tensor_pay_register ();
+ * nns_ex_tensor_depay_register ();
+ *
+ * (device 1) v4l2src ! video/x-raw,format=RGB,width=640,height=480 ! nns_ex_tensor_pay compression=lz4 ! tcpserversink port=5001
+ * (device 2) tcpclientsrc host=<device 1> port=5001 ! nns_ex_tensor_depay ! tee ...
+ *
+ * Properties of nns_ex_tensor_pay :
+ * compression : none, lz4 or zstd (none if the library is not found)
+ * level : compression level (acceleration of LZ4, level of zstd)
+ *
+ * Properties of nns_ex_tensor_depay :
+ * max-frame-size : max size of the frame in bytes (64 MiB by default), the header with the larger size,
+ *   or with the payload size not matching the raw size, is invalid and the depayloader looks for the next frame
+ * frames, lost, resync (read only) : count of the received frames, the frames lost (gap of the sequence number),
+ * and the bytes skipped to find the next frame
+ */
+
+#ifndef __NNS_EX_TRANSPORT_H__
+#define __NNS_EX_TRANSPORT_H__
+
+#include <glib.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @brief Name of the elements.
+ */
+#define NNS_EX_TENSOR_PAY_NAME "nns_ex_tensor_pay"
+#define NNS_EX_TENSOR_DEPAY_NAME "nns_ex_tensor_depay"
+
+/**
+ * @brief Caps of the framed stream.
+ */
+#define NNS_EX_TRANSPORT_CAPS "application/x-nns-ex-tensor"
+
+/**
+ * @brief Magic number and version of the frame.
+ */
+#define NNS_EX_TRANSPORT_MAGIC 0x4e4e5358 /* 'NNSX' */
+#define NNS_EX_TRANSPORT_VERSION 1
+
+/**
+ * @brief Size of the frame header.
+ */
+#define NNS_EX_TRANSPORT_HEADER_SIZE 40
+
+/**
+ * @brief Flags of the frame.
+ */
+#define NNS_EX_TRANSPORT_FLAG_DISCONT (1 << 0)
+#define NNS_EX_TRANSPORT_FLAG_DELTA_UNIT (1 << 1)
+
+/**
+ * @brief Compression of the payload.
+ */
+typedef enum
+{
+  NNS_EX_TRANSPORT_CODEC_NONE = 0,
+  NNS_EX_TRANSPORT_CODEC_LZ4 = 1,
+  NNS_EX_TRANSPORT_CODEC_ZSTD = 2,
+
+  NNS_EX_TRANSPORT_CODEC_UNKNOWN
+} nns_ex_transport_codec_e;
+
+/**
+ * @brief Data structure for the frame header.
+ */
+typedef struct
+{
+  nns_ex_transport_codec_e codec; /**< compression of the payload */
+  guint16 flags; /**< NNS_EX_TRANSPORT_FLAG_* */
+  guint32 seq; /**< sequence number of the frame */
+  GstClockTime pts; /**< timestamp of the buffer */
+  GstClockTime duration; /**< duration of the buffer */
+  guint32 caps_size; /**< size of the caps string (with the terminating null) */
+  guint32 raw_size; /**< size of the buffer */
+  guint32 payload_size; /**< size of the payload (raw_size if not compressed) */
+} nns_ex_transport_header_s;
+
+/**
+ * @brief Get the codec from the name (none, lz4 or zstd).
+ * @return the codec, NNS_EX_TRANSPORT_CODEC_UNKNOWN if the name is invalid
+ */
+extern nns_ex_transport_codec_e
+nns_ex_transport_codec_from_string (const gchar * name);
+
+/**
+ * @brief Get the name of the codec.
+ */
+extern const gchar *
+nns_ex_transport_codec_to_string (nns_ex_transport_codec_e codec);
+
+/**
+ * @brief Check the codec is built (the library is found).
+ */
+extern gboolean
+nns_ex_transport_codec_supported (nns_ex_transport_codec_e codec);
+
+/**
+ * @brief Write the header of the frame.
+ * @param header the header
+ * @param data NNS_EX_TRANSPORT_HEADER_SIZE bytes to write
+ */
+extern void
+nns_ex_transport_header_write (const nns_ex_transport_header_s * header,
+    guint8 * data);
+
+/**
+ * @brief Read the header of the frame.
+ * @param data NNS_EX_TRANSPORT_HEADER_SIZE bytes
+ * @param header the header
+ * @return TRUE if the magic number and version are valid
+ */
+extern gboolean
+nns_ex_transport_header_read (const guint8 * data,
+    nns_ex_transport_header_s * header);
+
+/**
+ * @brief Get the max size of the compressed payload.
+ */
+extern gsize
+nns_ex_transport_compress_bound (nns_ex_transport_codec_e codec, gsize size);
+
+/**
+ * @brief Compress the payload.
+ * @param codec LZ4 or zstd
+ * @param level acceleration of LZ4 (1 ~), level of zstd (1 ~ 22)
+ * @return size of the compressed payload, 0 if failed or not smaller than the raw payload
+ */
+extern gsize
+nns_ex_transport_compress (nns_ex_transport_codec_e codec, gint level,
+    const guint8 * src, gsize size, guint8 * dst, gsize dst_size);
+
+/**
+ * @brief Decompress the payload.
+ * @return TRUE if the payload is decompressed to raw_size bytes
+ */
+extern gboolean
+nns_ex_transport_decompress (nns_ex_transport_codec_e codec,
+    const guint8 * src, gsize size, guint8 * dst, gsize raw_size);
+
+/**
+ * @brief Get the type of the element 'nns_ex_tensor_pay'.
+ */
+extern GType
+nns_ex_tensor_pay_get_type (void);
+
+/**
+ * @brief Get the type of the element 'nns_ex_tensor_depay'.
+ */
+extern GType
+nns_ex_tensor_depay_get_type (void);
+
+/**
+ * @brief Register the element 'nns_ex_tensor_pay' to the application.
+ * @return TRUE if the element is registered
+ */
+extern gboolean
+nns_ex_tensor_pay_register (void);
+
+/**
+ * @brief Register the element 'nns_ex_tensor_depay' to the application.
+ * @return TRUE if the element is registered
+ */
+extern gboolean
+nns_ex_tensor_depay_register (void);
+
+G_END_DECLS
+
+#endif /* __NNS_EX_TRANSPORT_H__ */
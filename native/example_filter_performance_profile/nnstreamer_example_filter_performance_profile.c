@@ -13,7 +13,10 @@
  * Pipeline :
  * v4l2src -- videoconvert -- tee (optional) -- queue -- textoverlay -- fpsdisplaysink
  *                             |
- *                              -- queue -- videoscale -- videoconvert -- tensor_converter -- tensor_filter -- tensor_sink
+ *                              -- queue -- nns_ex_tensorize -- tensor_filter -- tensor_sink
+ *
+ * 'nns_ex_tensorize' converts the input frames to the uint8 RGB tensor of the model size in a single pass,
+ * instead of 'videoscale -- videoconvert -- capsfilter -- tensor_converter'.
  *
  * This example application currently only supports MOBINET for Tensorflow Lite via 'tensor_filter'.
  * Get model by
@@ -56,6 +59,9 @@
 #include <string.h>
 #include <gst/gst.h>
 
+#include "nns_ex_tensorize.h"
+#include "nns_ex_topk.h"
+
 /**
  * @brief A data type definition for the command line option, -c/--capture
  */
@@ -87,7 +93,6 @@ enum constant_values
   DEFAULT_HEIGHT_TFLITE_MOBINET = 224,
 };
 static const char DEFAULT_FRAME_RATES_INPUT_SRC[] = "5/1";
-static const char DEFAULT_FORMAT_TENSOR_CONVERTER[] = "RGB";
 static const char DEFAULT_PATH_MODEL_TENSOR_FILTER[] = "./tflite_model_img/";
 static const char NAME_APP_PIPELINE[] = "NNStreamer Pipeline";
 static const char NAME_PROP_DEVICE_V4L2SRC[] = "device";
@@ -102,14 +107,8 @@ static const char NAME_V4L2_PIPELINE_OUTPUT_SINK[] = "Xv-based image sink";
 static const char NAME_V4L2_PIPELINE_OUTPUT_TEXTOVERLAY[] =
     "Textoverlay to display the inference result";
 static const char NAME_NN_TFLITE_PIPELINE_QUEUE[] = "Queue for NN-TFlite";
-static const char NAME_NN_TFLITE_PIPELINE_VIDEOSCALE[] =
-    "Video scaler for NN-TFlite";
-static const char NAME_NN_TFLITE_PIPELINE_VIDEOCONVERT[] =
-    "Colorspace converter  for NN-TFlite";
-static const char NAME_NN_TFLITE_PIPELINE_INPUT_CAPSFILTER[] =
-    "CAPS filter for input source of NN-TFlite";
-static const char NAME_NN_TFLITE_PIPELINE_TENSOR_CONVERTER[] =
-    "Tensor converter for NN-TFlite";
+static const char NAME_NN_TFLITE_PIPELINE_TENSORIZE[] =
+    "Video to tensor converter for NN-TFlite";
 static const char NAME_NN_TFLITE_PIPELINE_TENSOR_FILTER[] =
     "Tensor filter for NN-TFlite";
 static const char NAME_NN_TFLITE_PIPELINE_TENSOR_SINK[] =
@@ -127,6 +126,13 @@ static const char *FRAMEWORK_LIST_TENSOR_FILTER[] = {
   NULL,
 };
 
+/**
+ * @brief Output quantization of the models (scale 1/256, zero point 0 for mobilenet_v1_1.0_224_quant).
+ */
+static const nns_ex_quant_s QUANT_LIST_OF_OUTPUT_TENSOR_FILTER[] = {
+  [TF_LITE_MOBINET] = {1.0f / 256.0f, 0},
+};
+
 static const char *NAME_LIST_OF_MODEL_FILE_TENSOR_FILTER[] = {
   [TF_LITE_MOBINET] = "mobilenet_v1_1.0_224_quant.tflite",
   /* sentinel */
@@ -182,10 +188,7 @@ typedef struct _v4l2src_pipeline_container_t
 typedef struct _nn_tflite_pipeline_container_t
 {
   GstElement *nn_tflite_queue;
-  GstElement *nn_tflite_videoscale;
-  GstElement *nn_tflite_videoconvert;
-  GstElement *nn_tflite_capsfilter;
-  GstElement *nn_tflite_tensor_converter;
+  GstElement *nn_tflite_tensorize;
   GstElement *nn_tflite_tensor_filter;
   GstElement *nn_tflite_tensor_sink;
 } nn_tflite_pipeline_container_t;
@@ -636,25 +639,14 @@ _construct_nn_tflite_pipeline (nnstrmr_app_context_t * ctx)
   GstElement *pipeline = ctx->pipeline;
   nn_tflite_pipeline_container_t *pipeline_cntnr =
       &((ctx->pipeline_container).nn_tflite_pipeline_container);
-  GstCaps *caps;
-  gchar *str_caps;
   gboolean ret;
   GstPad *pad;
 
   pipeline_cntnr->nn_tflite_queue =
       gst_element_factory_make ("queue", NAME_NN_TFLITE_PIPELINE_QUEUE);
-  pipeline_cntnr->nn_tflite_videoscale =
-      gst_element_factory_make ("videoscale",
-      NAME_NN_TFLITE_PIPELINE_VIDEOSCALE);
-  pipeline_cntnr->nn_tflite_videoconvert =
-      gst_element_factory_make ("videoconvert",
-      NAME_NN_TFLITE_PIPELINE_VIDEOCONVERT);
-  pipeline_cntnr->nn_tflite_capsfilter =
-      gst_element_factory_make ("capsfilter",
-      NAME_NN_TFLITE_PIPELINE_INPUT_CAPSFILTER);
-  pipeline_cntnr->nn_tflite_tensor_converter =
-      gst_element_factory_make ("tensor_converter",
-      NAME_NN_TFLITE_PIPELINE_TENSOR_CONVERTER);
+  pipeline_cntnr->nn_tflite_tensorize =
+      gst_element_factory_make (NNS_EX_TENSORIZE_NAME,
+      NAME_NN_TFLITE_PIPELINE_TENSORIZE);
   pipeline_cntnr->nn_tflite_tensor_filter =
       gst_element_factory_make ("tensor_filter",
       NAME_NN_TFLITE_PIPELINE_TENSOR_FILTER);
@@ -670,29 +662,17 @@ _construct_nn_tflite_pipeline (nnstrmr_app_context_t * ctx)
       ctx->nn_tensor_filter_model_path, NULL);
   g_free (ctx->nn_tensor_filter_model_path);
 
-  str_caps =
-      g_strdup_printf ("video/x-raw,width=%d,height=%d,format=%s",
-      DEFAULT_WIDTH_TFLITE_MOBINET, DEFAULT_HEIGHT_TFLITE_MOBINET,
-      DEFAULT_FORMAT_TENSOR_CONVERTER);
-  caps = gst_caps_from_string (str_caps);
-  g_object_set (G_OBJECT (pipeline_cntnr->nn_tflite_capsfilter), "caps", caps,
-      NULL);
-  g_free (str_caps);
-  gst_caps_unref (caps);
+  g_object_set (G_OBJECT (pipeline_cntnr->nn_tflite_tensorize),
+      "width", DEFAULT_WIDTH_TFLITE_MOBINET,
+      "height", DEFAULT_HEIGHT_TFLITE_MOBINET, "type", "uint8", NULL);
 
   gst_bin_add_many (GST_BIN (pipeline), pipeline_cntnr->nn_tflite_queue,
-      pipeline_cntnr->nn_tflite_videoscale,
-      pipeline_cntnr->nn_tflite_videoconvert,
-      pipeline_cntnr->nn_tflite_capsfilter,
-      pipeline_cntnr->nn_tflite_tensor_converter,
+      pipeline_cntnr->nn_tflite_tensorize,
       pipeline_cntnr->nn_tflite_tensor_filter,
       pipeline_cntnr->nn_tflite_tensor_sink, NULL);
 
   ret = gst_element_link_many (pipeline_cntnr->nn_tflite_queue,
-      pipeline_cntnr->nn_tflite_videoscale,
-      pipeline_cntnr->nn_tflite_videoconvert,
-      pipeline_cntnr->nn_tflite_capsfilter,
-      pipeline_cntnr->nn_tflite_tensor_converter,
+      pipeline_cntnr->nn_tflite_tensorize,
       pipeline_cntnr->nn_tflite_tensor_filter,
       pipeline_cntnr->nn_tflite_tensor_sink, NULL);
   if (ret == FALSE) {
@@ -863,21 +843,18 @@ _handle_tensor_sink_new_data_output (GstElement * object, GstBuffer * buffer,
     {
       v4l2src_pipeline_container_t *v4l2src_pipeline_cntnr =
           &((ctx->pipeline_container).v4l2src_pipeline_container);
-      GstMemory *mem = gst_buffer_get_all_memory (buffer);
+      /* single tensor, peek the memory instead of merging all memories */
+      GstMemory *mem = gst_buffer_peek_memory (buffer, 0);
       GstMapInfo map_info;
 
       if (gst_memory_map (mem, &map_info, GST_MAP_READ)) {
-        int max_score_idx = -1;
-        guint8 max_score = 0;
-        int i;
+        gint max_score_idx;
         gchar *class_result;
 
-        for (i = 0; i < map_info.size; i++) {
-          if ((guint8) map_info.data[i] > max_score) {
-            max_score = (guint8) map_info.data[i];
-            max_score_idx = i;
-          }
-        }
+        max_score_idx = nns_ex_argmax_uint8 (map_info.data,
+            (guint) map_info.size,
+            &QUANT_LIST_OF_OUTPUT_TENSOR_FILTER[ctx->nn_tensorfilter_desc],
+            0.0f);
         class_result = "UNKNOWN";
         if (max_score_idx != -1) {
           class_result =
@@ -971,6 +948,11 @@ main (int argc, char *argv[])
 
   /* Initailization */
   gst_init (&argc, &argv);
+  if (!nns_ex_tensorize_register ()) {
+    g_printerr ("ERR: cannot register the element, %s\n",
+        NNS_EX_TENSORIZE_NAME);
+    return -1;
+  }
   app_ctx.mainloop = g_main_loop_new (NULL, FALSE);
   _set_and_parse_option_info (argc, argv, &app_ctx);
 
@@ -0,0 +1,149 @@
+/**
+ * NNStreamer custom filter for image preprocessing
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * LICENSE: LGPL-2.1
+ *
+ * @file	nnscustom_transpose_normalize.c
+ * @date	19 October 2026
+ * @author	agent <agent@local>
+ * @brief	Custom filter to transpose uint8 HWC image to float32 CHW tensor and normalize each channel in a single pass.
+ * @bug		No known bugs
+ *
+ * This replaces the chain of two tensor_transform elements :
+ * tensor_transform mode=transpose option=1:2:0:3 ! tensor_transform mode=arithmetic option=typecast:float32,add:-123,div:63
+ *
+ * Usage :
+ * tensor_filter framework=custom model=libnnscustom_transpose_normalize.so custom=mean:123,std:63
+ *
+ * 'mean' and 'std' have a value for all channels, or a value for each channel (e.g., mean:123:117:104).
+ * The default is mean 0 and std 1 (typecast only).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <nnstreamer/tensor_filter_custom.h>
+
+#include "nns_ex_preprocess.h"
+
+/**
+ * @brief nnstreamer custom filter private data
+ */
+typedef struct _pt_data
+{
+  nns_ex_normalize_s norm; /**< per-channel normalization */
+  unsigned int width; /**< image width */
+  unsigned int height; /**< image height */
+  unsigned int batch; /**< number of images in a tensor */
+} pt_data;
+
+/**
+ * @brief nnstreamer custom filter standard vmethod
+ * Refer tensor_filter_custom.h
+ */
+static void *
+pt_init (const GstTensorFilterProperties * prop)
+{
+  pt_data *data = (pt_data *) malloc (sizeof (pt_data));
+
+  assert (data);
+  memset (data, 0, sizeof (pt_data));
+
+  return data;
+}
+
+/**
+ * @brief nnstreamer custom filter standard vmethod
+ * Refer tensor_filter_custom.h
+ */
+static void
+pt_exit (void *_data, const GstTensorFilterProperties * prop)
+{
+  pt_data *data = _data;
+
+  assert (data);
+  free (data);
+}
+
+/**
+ * @brief nnstreamer custom filter standard vmethod
+ * Refer tensor_filter_custom.h
+ */
+static int
+set_inputDim (void *_data, const GstTensorFilterProperties * prop,
+    const GstTensorsInfo * in_info, GstTensorsInfo * out_info)
+{
+  pt_data *data = _data;
+  unsigned int channels;
+
+  assert (data);
+  assert (in_info);
+  assert (out_info);
+
+  /* uint8 image, dimension channel:width:height:batch */
+  if (in_info->num_tensors != 1 || in_info->info[0].type != _NNS_UINT8)
+    return -1;
+
+  channels = in_info->info[0].dimension[0];
+  if (channels == 0 || channels > NNS_EX_PREPROCESS_MAX_CHANNELS)
+    return -1;
+
+  nns_ex_normalize_init (&data->norm, channels, 0.0f, 1.0f);
+  if (!nns_ex_normalize_parse (&data->norm, prop->custom_properties)) {
+    fprintf (stderr, "Invalid option [%s], e.g., mean:123,std:63\n",
+        prop->custom_properties);
+    return -1;
+  }
+
+  data->width = in_info->info[0].dimension[1];
+  data->height = in_info->info[0].dimension[2];
+  data->batch = in_info->info[0].dimension[3];
+
+  /* float32 planes, dimension width:height:channel:batch */
+  out_info->num_tensors = 1;
+  out_info->info[0].name = NULL;
+  out_info->info[0].type = _NNS_FLOAT32;
+  out_info->info[0].dimension[0] = data->width;
+  out_info->info[0].dimension[1] = data->height;
+  out_info->info[0].dimension[2] = channels;
+  out_info->info[0].dimension[3] = data->batch;
+
+  return 0;
+}
+
+/**
+ * @brief nnstreamer custom filter standard vmethod
+ * Refer tensor_filter_custom.h
+ */
+static int
+invoke (void *_data, const GstTensorFilterProperties * prop,
+    const GstTensorMemory * input, GstTensorMemory * output)
+{
+  pt_data *data = _data;
+  size_t image_size;
+  unsigned int b;
+
+  assert (data);
+
+  image_size = (size_t) data->width * data->height * data->norm.channels;
+
+  for (b = 0; b < data->batch; b++) {
+    nns_ex_hwc_to_chw_normalize ((const guint8 *) input[0].data + image_size * b,
+        (gfloat *) output[0].data + image_size * b, data->width, data->height,
+        &data->norm);
+  }
+
+  return 0;
+}
+
+static NNStreamer_custom_class NNStreamer_custom_body = {
+  .initfunc = pt_init,
+  .exitfunc = pt_exit,
+  .setInputDim = set_inputDim,
+  .invoke = invoke,
+};
+
+/* The dyn-loaded object */
+NNStreamer_custom_class *NNStreamer_custom = &NNStreamer_custom_body;
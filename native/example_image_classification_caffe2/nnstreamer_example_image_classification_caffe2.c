@@ -8,7 +8,10 @@
  ** Run example :
  * Before running this example, GST_PLUGIN_PATH should be updated for nnstreamer plug-in.
  * $ export GST_PLUGIN_PATH=$GST_PLUGIN_PATH:<nnstreamer plugin path>
- * $ ./nnstreamer_example_image_classification_caffe2
+ * $ ./nnstreamer_example_image_classification_caffe2 [--fused-preprocess]
+ *
+ * With '--fused-preprocess', the custom filter (libnnscustom_transpose_normalize.so) transposes,
+ * typecasts and normalizes the image in a single pass, instead of two tensor_transform elements.
  *
  * Required model and resources are stored at below link
  * https://github.com/caffe2/models/tree/master/mobilenet_v2
@@ -24,6 +27,8 @@
 #include <glib.h>
 #include <gst/gst.h>
 
+#include "nns_ex_topk.h"
+
 /**
  * @brief Macro for debug mode.
  */
@@ -54,6 +59,11 @@
 #define VIDEO_WIDTH     640
 #define VIDEO_HEIGHT    480
 
+/**
+ * @brief Name of the application message to notify the new result.
+ */
+#define RESULT_MESSAGE_NAME "image-classification-result"
+
 /**
  * @brief Data structure for caffe2 model info.
  */
@@ -74,6 +84,7 @@ typedef struct
   GMainLoop *loop; /**< main event loop */
   GstElement *pipeline; /**< gst pipeline for data stream */
   GstBus *bus; /**< gst bus for data pipeline */
+  GstElement *overlay; /**< textoverlay to show the result */
 
   gboolean running; /**< true when app is running */
   guint received; /**< received buffer count */
@@ -210,23 +221,13 @@ _caffe2_get_label (caffe2_info_s * caffe2_info, gint index)
 static void
 _update_top_label_index (float *scores, guint len)
 {
-  gint i;
-  gint index = -1;
-  float max_score = 0;
-
   /* -1 if failed to get max score index */
   g_app.new_label_index = -1;
 
   g_return_if_fail (scores != NULL);
   g_return_if_fail (len / 4 == g_app.caffe2_info.total_labels);
 
-  for (i = 0; i < len / 4; i++) {
-    if (scores[i] > 0 && scores[i] > max_score) {
-      index = i;
-      max_score = scores[i];
-    }
-  }
-  g_app.new_label_index = index;
+  g_app.new_label_index = nns_ex_argmax_float32 (scores, len / 4, 0.0f);
 }
 
 /**
@@ -240,6 +241,11 @@ _free_app_data (void)
     g_app.loop = NULL;
   }
 
+  if (g_app.overlay) {
+    gst_object_unref (g_app.overlay);
+    g_app.overlay = NULL;
+  }
+
   if (g_app.bus) {
     gst_bus_remove_signal_watch (g_app.bus);
     gst_object_unref (g_app.bus);
@@ -298,6 +304,46 @@ _parse_qos_message (GstMessage * message)
       G_GUINT64_FORMAT "]", format, processed, dropped);
 }
 
+/**
+ * @brief Update the label in textoverlay with the result message.
+ * @note This is called in the main loop, the overlay is updated only when the label is changed.
+ */
+static void
+_update_result (GstMessage * message)
+{
+  const GstStructure *s;
+  gchar *label_with_code;
+  gchar **labels = NULL;
+  gchar **label = NULL;
+  gint index;
+
+  s = gst_message_get_structure (message);
+  if (!gst_structure_has_name (s, RESULT_MESSAGE_NAME))
+    return;
+
+  if (!g_app.running || !gst_structure_get_int (s, "label-index", &index))
+    return;
+
+  if (index == g_app.current_label_index)
+    return;
+
+  g_app.current_label_index = index;
+
+  /* label format : 'code label1, label2, ...' */
+  label_with_code = (index >= 0) ?
+      _caffe2_get_label (&g_app.caffe2_info, index) : NULL;
+  if (label_with_code) {
+    labels = g_strsplit (label_with_code, " ", 2);
+    if (labels[0] && labels[1])
+      label = g_strsplit (labels[1], ",", -1);
+  }
+
+  g_object_set (g_app.overlay, "text", (label != NULL) ? label[0] : "", NULL);
+
+  g_strfreev (label);
+  g_strfreev (labels);
+}
+
 /**
  * @brief Callback for message.
  */
@@ -329,6 +375,10 @@ _message_cb (GstBus * bus, GstMessage * message, gpointer user_data)
       _parse_qos_message (message);
       break;
 
+    case GST_MESSAGE_APPLICATION:
+      _update_result (message);
+      break;
+
     default:
       break;
   }
@@ -336,6 +386,9 @@ _message_cb (GstBus * bus, GstMessage * message, gpointer user_data)
 
 /**
  * @brief Callback for tensor sink signal.
+ *
+ * This is called in the streaming thread. Instead of polling the result with a timer,
+ * post an application message to the bus only when the label index is changed.
  */
 static void
 _new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
@@ -349,6 +402,9 @@ _new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
     GstMapInfo info;
     guint i;
     guint num_mems;
+    gint prev_index;
+
+    prev_index = g_app.new_label_index;
 
     num_mems = gst_buffer_n_memory (buffer);
     for (i = 0; i < num_mems; i++) {
@@ -361,6 +417,15 @@ _new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
         gst_memory_unmap (mem, &info);
       }
     }
+
+    if (g_app.new_label_index != prev_index) {
+      GstStructure *s;
+
+      s = gst_structure_new (RESULT_MESSAGE_NAME,
+          "label-index", G_TYPE_INT, g_app.new_label_index, NULL);
+      gst_element_post_message (element,
+          gst_message_new_application (GST_OBJECT (element), s));
+    }
   }
 }
 
@@ -391,37 +456,6 @@ _set_window_title (const gchar * name, const gchar * title)
   gst_object_unref (element);
 }
 
-/**
- * @brief Timer callback for textoverlay.
- * @return True to ensure the timer continues
- */
-static gboolean
-_timer_update_result_cb (gpointer user_data)
-{
-  if (g_app.running) {
-    GstElement *overlay;
-    gchar *labelWithCode = NULL;
-    gchar **labels = NULL;
-    gchar **label = NULL;
-
-    if (g_app.current_label_index != g_app.new_label_index) {
-      g_app.current_label_index = g_app.new_label_index;
-
-      overlay = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "tensor_res");
-
-      labelWithCode =
-          _caffe2_get_label (&g_app.caffe2_info, g_app.current_label_index);
-      labels = g_strsplit (labelWithCode, " ", 2);
-      label = g_strsplit (labels[1], ",", -1);
-      g_object_set (overlay, "text", (label != NULL) ? label[0] : "", NULL);
-
-      gst_object_unref (overlay);
-    }
-  }
-
-  return TRUE;
-}
-
 /**
  * @brief Main function.
  */
@@ -431,12 +465,35 @@ main (int argc, char **argv)
   const gchar caffe2_model_path[] = "./caffe2_model";
 
   gchar *str_pipeline;
+  gchar *str_preprocess;
   gulong handle_id;
-  guint timer_id = 0;
   GstElement *element;
+  gboolean fused_preprocess = FALSE;
+  GOptionContext *optionctx;
+  GError *error = NULL;
+
+  const GOptionEntry main_entries[] = {
+    {"fused-preprocess", 'f', G_OPTION_FLAG_NONE, G_OPTION_ARG_NONE,
+          &fused_preprocess,
+          "Transpose and normalize the image with a custom filter in a single pass",
+        NULL},
+    {NULL}
+  };
 
   _print_log ("start app..");
 
+  optionctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (optionctx, main_entries, NULL);
+
+  if (!g_option_context_parse (optionctx, &argc, &argv, &error)) {
+    g_printerr ("option parsing failed: %s\n", error->message);
+    g_error_free (error);
+    g_option_context_free (optionctx);
+    return -1;
+  }
+
+  g_option_context_free (optionctx);
+
   /* init app variable */
   g_app.running = FALSE;
   g_app.received = 0;
@@ -452,6 +509,17 @@ main (int argc, char **argv)
   g_app.loop = g_main_loop_new (NULL, FALSE);
   _check_cond_err (g_app.loop != NULL);
 
+  /* HWC uint8 to CHW float32, (x - 123) / 63 */
+  if (fused_preprocess) {
+    str_preprocess =
+        g_strdup ("tensor_filter framework=custom "
+        "model=./libnnscustom_transpose_normalize.so custom=mean:123,std:63 ! ");
+  } else {
+    str_preprocess =
+        g_strdup ("tensor_transform mode=transpose option=1:2:0:3 ! "
+        "tensor_transform mode=arithmetic option=typecast:float32,add:-123,div:63 ! ");
+  }
+
   /* init pipeline */
   str_pipeline =
       g_strdup_printf
@@ -461,14 +529,14 @@ main (int argc, char **argv)
       "videoconvert ! ximagesink name=img_tensor "
       "t_raw. ! queue leaky=2 max-size-buffers=2 ! "
       "videoscale ! video/x-raw,width=224,height=224,format=RGB ! tensor_converter ! "
-      "tensor_transform mode=transpose option=1:2:0:3 ! "
-      "tensor_transform mode=arithmetic option=typecast:float32,add:-123,div:63 ! "
+      "%s"
       "tensor_filter framework=caffe2 model=\"%s,%s\" "
       "inputname=data input=224:224:3:1 inputtype=float32 "
       "output=1000:1:1:1 outputtype=float32 outputname=softmax ! "
       "tensor_sink name=tensor_sink",
-      VIDEO_WIDTH, VIDEO_HEIGHT,
+      VIDEO_WIDTH, VIDEO_HEIGHT, str_preprocess,
       g_app.caffe2_info.init_model_path, g_app.caffe2_info.pred_model_path);
+  g_free (str_preprocess);
 
   _print_log ("%s\n", str_pipeline);
 
@@ -492,9 +560,9 @@ main (int argc, char **argv)
   gst_object_unref (element);
   _check_cond_err (handle_id > 0);
 
-  /* timer to update result */
-  timer_id = g_timeout_add (500, _timer_update_result_cb, NULL);
-  _check_cond_err (timer_id > 0);
+  /* textoverlay to update result, get the element once */
+  g_app.overlay = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "tensor_res");
+  _check_cond_err (g_app.overlay != NULL);
 
   /* start pipeline */
   gst_element_set_state (g_app.pipeline, GST_STATE_PLAYING);
@@ -527,10 +595,6 @@ main (int argc, char **argv)
 error:
   _print_log ("close app..");
 
-  if (timer_id > 0) {
-    g_source_remove (timer_id);
-  }
-
   _free_app_data ();
   return 0;
 }
@@ -8,12 +8,15 @@
  * NNStreamer example for image classification using tensorflow-lite.
  *
  * Pipeline :
- * v4l2src -- tee -- textoverlay -- videoconvert -- ximagesink
- *             |
- *             --- videoscale -- tensor_converter -- tensor_filter -- tensor_sink
+ * v4l2src -- videorate -- capsfilter -- tee -- videoconvert -- videoscale -- textoverlay -- videoconvert -- ximagesink
+ *                                          |
+ *                                          --- nns_ex_tensorize -- tensor_filter -- tensor_sink
  *
  * This app displays video sink.
  *
+ * 'nns_ex_tensorize' converts the camera frames (camera format) to the uint8 RGB tensor in a single pass,
+ * instead of 'videoconvert ! videoscale ! tensor_converter'.
+ *
  * 'tensor_filter' for image classification.
  * Get model by
  * $ cd $NNST_ROOT/bin
@@ -21,10 +24,20 @@
  *
  * 'tensor_sink' updates classification result to display in textoverlay.
  *
+ * The motion gate (see nns_ex_motion_gate.h) drops the frames to nns_ex_tensorize
+ * if the scene is not changed from the last frame classified, and the label is kept.
+ * '--gate' sets the ratio (in percent) of the changed area to run the model, 0 to run on every frame.
+ * The skipped inferences and the estimated CPU time saved are printed at exit.
+ *
+ * The QoS controller (see nns_ex_qos.h) handles the QoS messages of the sinks. When the frames are late
+ * under the load, it lowers the inference frequency, then the camera resolution and framerate
+ * (capsfilter 'qos_caps'), and restores them when the pipeline has the headroom.
+ * '--target-latency' sets the max lateness (in milliseconds) of the display, 0 to disable the controller.
+ *
  * Run example :
  * Before running this example, GST_PLUGIN_PATH should be updated for nnstreamer plug-in.
  * $ export GST_PLUGIN_PATH=$GST_PLUGIN_PATH:<nnstreamer plugin path>
- * $ ./nnstreamer_example_image_classification_tflite
+ * $ ./nnstreamer_example_image_classification_tflite [--gate=1.0] [--target-latency=100]
  */
 
 #ifndef _GNU_SOURCE
@@ -37,6 +50,11 @@
 #include <glib.h>
 #include <gst/gst.h>
 
+#include "nns_ex_motion_gate.h"
+#include "nns_ex_qos.h"
+#include "nns_ex_tensorize.h"
+#include "nns_ex_topk.h"
+
 /**
  * @brief Macro for debug mode.
  */
@@ -60,6 +78,28 @@
     } \
   } while (0)
 
+/**
+ * @brief Parameters of the motion gate.
+ */
+#define GATE_CELL_THRESHOLD 12
+#define GATE_DEFAULT_AREA 1.0
+#define GATE_MAX_SKIP 30
+
+/**
+ * @brief Default max lateness (in milliseconds) of the display.
+ */
+#define QOS_DEFAULT_TARGET 100
+
+/**
+ * @brief Levels of the QoS controller, the inference frequency first.
+ */
+static const nns_ex_qos_level_s qos_levels[] = {
+  {2, 0, 0, 0, 0},
+  {4, 0, 0, 0, 0},
+  {4, 320, 240, 0, 0},
+  {4, 320, 240, 15, 1},
+};
+
 /**
  * @brief Data structure for tflite model info.
  */
@@ -85,6 +125,8 @@ typedef struct
   gint current_label_index; /**< current label index */
   gint new_label_index; /**< new label index */
   tflite_info_s tflite_info; /**< tflite model info */
+  nns_ex_motion_gate_s *gate; /**< motion gate to skip the static frames */
+  nns_ex_qos_s *qos; /**< QoS controller */
 } AppData;
 
 /**
@@ -92,6 +134,11 @@ typedef struct
  */
 static AppData g_app;
 
+/**
+ * @brief Output quantization of mobilenet_v1_1.0_224_quant (scale 1/256, zero point 0).
+ */
+static const nns_ex_quant_s tflite_output_quant = { 1.0f / 256.0f, 0 };
+
 /**
  * @brief Free data in tflite info structure.
  */
@@ -198,24 +245,14 @@ _tflite_get_label (tflite_info_s * tflite_info, gint index)
 static void
 _update_top_label_index (guint8 * scores, guint len)
 {
-  gint i;
-  gint index = -1;
-  guint8 max_score = 0;
-
   /* -1 if failed to get max score index */
   g_app.new_label_index = -1;
 
   g_return_if_fail (scores != NULL);
   g_return_if_fail (len == g_app.tflite_info.total_labels);
 
-  for (i = 0; i < len; i++) {
-    if (scores[i] > 0 && scores[i] > max_score) {
-      index = i;
-      max_score = scores[i];
-    }
-  }
-
-  g_app.new_label_index = index;
+  g_app.new_label_index =
+      nns_ex_argmax_uint8 (scores, len, &tflite_output_quant, 0.0f);
 }
 
 /**
@@ -235,6 +272,16 @@ _free_app_data (void)
     g_app.bus = NULL;
   }
 
+  if (g_app.gate) {
+    nns_ex_motion_gate_free (g_app.gate);
+    g_app.gate = NULL;
+  }
+
+  if (g_app.qos) {
+    nns_ex_qos_free (g_app.qos);
+    g_app.qos = NULL;
+  }
+
   if (g_app.pipeline) {
     gst_object_unref (g_app.pipeline);
     g_app.pipeline = NULL;
@@ -273,7 +320,7 @@ _parse_err_message (GstMessage * message)
 }
 
 /**
- * @brief Function to print qos message.
+ * @brief Function to print qos message, and adapt the pipeline to the load.
  */
 static void
 _parse_qos_message (GstMessage * message)
@@ -285,6 +332,9 @@ _parse_qos_message (GstMessage * message)
   gst_message_parse_qos_stats (message, &format, &processed, &dropped);
   _print_log ("format[%d] processed[%" G_GUINT64_FORMAT "] dropped[%"
       G_GUINT64_FORMAT "]", format, processed, dropped);
+
+  if (g_app.qos)
+    nns_ex_qos_handle_message (g_app.qos, message);
 }
 
 /**
@@ -417,20 +467,52 @@ main (int argc, char **argv)
   gchar *str_pipeline;
   gulong handle_id;
   guint timer_id = 0;
-  GstElement *element;
+  GstElement *element, *filter;
+  gboolean attached;
+  gdouble gate_area = GATE_DEFAULT_AREA;
+  gint target_latency = QOS_DEFAULT_TARGET;
+  nns_ex_motion_gate_stats_s stats;
+  nns_ex_qos_stats_s qos_stats;
+  GOptionContext *optionctx;
+  GError *error = NULL;
+
+  const GOptionEntry main_entries[] = {
+    {"gate", 'g', G_OPTION_FLAG_NONE, G_OPTION_ARG_DOUBLE, &gate_area,
+        "Changed area (percent) to run the model, 0 to run on every frame",
+        "1.0"},
+    {"target-latency", 't', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &target_latency,
+        "Max lateness (ms) of the display, 0 to disable the QoS controller",
+        "100"},
+    {NULL}
+  };
 
   _print_log ("start app..");
 
+  optionctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (optionctx, main_entries, NULL);
+
+  if (!g_option_context_parse (optionctx, &argc, &argv, &error)) {
+    g_printerr ("option parsing failed: %s\n", error->message);
+    g_error_free (error);
+    g_option_context_free (optionctx);
+    return -1;
+  }
+
+  g_option_context_free (optionctx);
+
   /* init app variable */
   g_app.running = FALSE;
   g_app.received = 0;
   g_app.current_label_index = -1;
   g_app.new_label_index = -1;
+  g_app.gate = NULL;
+  g_app.qos = NULL;
 
   _check_cond_err (_tflite_init_info (&g_app.tflite_info, tflite_model_path));
 
   /* init gstreamer */
   gst_init (&argc, &argv);
+  _check_cond_err (nns_ex_tensorize_register ());
 
   /* main loop */
   g_app.loop = g_main_loop_new (NULL, FALSE);
@@ -439,12 +521,15 @@ main (int argc, char **argv)
   /* init pipeline */
   str_pipeline =
       g_strdup_printf
-      ("v4l2src name=cam_src ! videoconvert ! videoscale ! "
-      "video/x-raw,width=640,height=480,format=RGB ! tee name=t_raw "
-      "t_raw. ! queue ! textoverlay name=tensor_res font-desc=Sans,24 ! "
+      ("v4l2src name=cam_src ! videorate drop-only=true ! videoscale ! "
+      "capsfilter name=qos_caps ! tee name=t_raw "
+      "t_raw. ! queue ! videoconvert ! videoscale ! "
+      "video/x-raw,width=640,height=480 ! "
+      "textoverlay name=tensor_res font-desc=Sans,24 ! "
       "videoconvert ! ximagesink name=img_tensor "
-      "t_raw. ! queue leaky=2 max-size-buffers=2 ! videoscale ! tensor_converter ! "
-      "tensor_filter framework=tensorflow-lite model=%s ! "
+      "t_raw. ! queue leaky=2 max-size-buffers=2 ! "
+      "nns_ex_tensorize name=tensorize width=224 height=224 type=uint8 ! "
+      "tensor_filter name=tensor_filter framework=tensorflow-lite model=%s ! "
       "tensor_sink name=tensor_sink", g_app.tflite_info.model_path);
 
   _print_log ("%s\n", str_pipeline);
@@ -469,6 +554,33 @@ main (int argc, char **argv)
   gst_object_unref (element);
   _check_cond_err (handle_id > 0);
 
+  /* lower the inference frequency and the camera caps under the load, before the gate */
+  if (target_latency > 0) {
+    g_app.qos = nns_ex_qos_new (target_latency * GST_MSECOND, qos_levels,
+        G_N_ELEMENTS (qos_levels));
+    _check_cond_err (g_app.qos != NULL);
+
+    element = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "tensorize");
+    filter = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "qos_caps");
+    attached = nns_ex_qos_attach (g_app.qos, filter, element);
+    gst_object_unref (element);
+    gst_object_unref (filter);
+    _check_cond_err (attached);
+  }
+
+  /* skip the static frames, tensorize and tensor_filter run in the same thread */
+  if (gate_area > 0.0) {
+    g_app.gate = nns_ex_motion_gate_new (GATE_CELL_THRESHOLD,
+        (gfloat) (gate_area / 100.0), GATE_MAX_SKIP);
+
+    element = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "tensorize");
+    filter = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "tensor_filter");
+    attached = nns_ex_motion_gate_attach (g_app.gate, element, filter);
+    gst_object_unref (element);
+    gst_object_unref (filter);
+    _check_cond_err (attached);
+  }
+
   /* timer to update result */
   timer_id = g_timeout_add (500, _timer_update_result_cb, NULL);
   _check_cond_err (timer_id > 0);
@@ -501,6 +613,26 @@ main (int argc, char **argv)
   g_usleep (200 * 1000);
   gst_object_unref (element);
 
+  if (g_app.gate) {
+    nns_ex_motion_gate_get_stats (g_app.gate, &stats);
+    g_print ("motion gate : skipped %u of %u inferences (%.1f%%), "
+        "gate %.1f us/frame, estimated CPU time saved %.1f ms\n",
+        stats.skipped, stats.frames,
+        stats.frames ? 100.0 * stats.skipped / stats.frames : 0.0,
+        stats.frames ? (gdouble) stats.gate_time / stats.frames : 0.0,
+        stats.saved_time / 1000.0);
+  }
+
+  if (g_app.qos) {
+    nns_ex_qos_get_stats (g_app.qos, &qos_stats);
+    g_print ("qos : level %u (lowest %u), %u steps down, %u steps up, "
+        "%u late frames (max %.1f ms), skipped %u of %u inferences\n",
+        qos_stats.level, qos_stats.max_level, qos_stats.degraded,
+        qos_stats.recovered, qos_stats.messages,
+        (gdouble) qos_stats.max_jitter / GST_MSECOND, qos_stats.skipped,
+        qos_stats.frames);
+  }
+
 error:
   _print_log ("close app..");
 
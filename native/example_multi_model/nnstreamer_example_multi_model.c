@@ -0,0 +1,581 @@
+/**
+ * @file	nnstreamer_example_multi_model.c
+ * @date	19 October 2026
+ * @brief	Tensor stream example running several models on a stream with the per-model frame rate
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * NNStreamer example of the models sharing the input tensor (e.g., face, hand and object detection
+ * of the multi-model android app). The tensor is given to each model through a tee,
+ * and nns_ex_model_sched admits the models on each frame with the target rate and priority of each model,
+ * on a bounded number of workers, staggering the invocations of the models across the frames.
+ *
+ * Pipeline :
+ * videotestsrc -- tensor_converter -- tensor_transform -- tee -- queue -- model -- tensor_sink
+ *                                                           |
+ *                                                           -- queue -- model -- tensor_sink
+ *                                                           ...
+ *
+ * The model is synthetic by default (identity, busy for the cost of the model in the CPU time of the branch thread),
+ * or tensor_filter with the tflite model of 3:300:300:1 float32 input (e.g., ssd_mobilenet_v2_coco.tflite).
+ * The app reports the target and achieved rate of each model.
+ *
+ * Run example :
+ * Before running this example, GST_PLUGIN_PATH should be updated for nnstreamer plug-in.
+ * $ export GST_PLUGIN_PATH=$GST_PLUGIN_PATH:<nnstreamer plugin path>
+ * $ taskset -c 0-1 ./nnstreamer_example_multi_model --models=face:10:3:25,hand:10:2:25,obj:5:1:60 --workers=2
+ * $ taskset -c 0-1 ./nnstreamer_example_multi_model --baseline
+ * $ ./nnstreamer_example_multi_model --tflite=./tflite_model/ssd_mobilenet_v2_coco.tflite
+ *
+ * The model is 'name:fps:priority:cost-ms', fps 0 to run the model on every frame.
+ * With --baseline, every frame is given to every model as the leaky queues allow (the pipeline without the scheduler).
+ * Compare the summary lines with and without --baseline.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <glib.h>
+#include <gst/gst.h>
+
+#include "nns_ex_model_sched.h"
+
+/**
+ * @brief Macro for debug mode.
+ */
+#ifndef DBG
+#define DBG FALSE
+#endif
+
+/**
+ * @brief Macro for debug message.
+ */
+#define _print_log(...) if (DBG) g_message (__VA_ARGS__)
+
+/**
+ * @brief Macro to check error case.
+ */
+#define _check_cond_err(cond) \
+  do { \
+    if (!(cond)) { \
+      _print_log ("app failed! [line : %d]", __LINE__); \
+      goto error; \
+    } \
+  } while (0)
+
+/**
+ * @brief Max number of models.
+ */
+#define MAX_MODELS 8
+
+/**
+ * @brief Default values of the options.
+ */
+#define DEFAULT_MODELS "face:10:3:25,hand:10:2:25,obj:5:1:60"
+#define DEFAULT_WORKERS 2
+#define DEFAULT_PER_FRAME 1
+#define DEFAULT_FRAMERATE 30
+#define DEFAULT_DURATION 10
+
+/**
+ * @brief Input dimension of the model.
+ */
+#define MODEL_WIDTH 300
+#define MODEL_HEIGHT 300
+
+/**
+ * @brief Data structure for a model.
+ */
+typedef struct
+{
+  gchar *name; /**< model name */
+  gdouble fps; /**< target rate, 0 for every frame */
+  gint priority; /**< priority of the model */
+  gint cost_ms; /**< CPU time of the synthetic model */
+} model_info_s;
+
+/**
+ * @brief Data structure for app.
+ */
+typedef struct
+{
+  GMainLoop *loop; /**< main event loop */
+  GstElement *pipeline; /**< gst pipeline for data stream */
+  GstBus *bus; /**< gst bus for data pipeline */
+
+  gboolean running; /**< true when app is running */
+  guint num_models; /**< number of models */
+  model_info_s models[MAX_MODELS]; /**< info of each model */
+  nns_ex_model_sched_s *sched; /**< model scheduler */
+  guint quit_timer_id; /**< timer to stop the app */
+} AppData;
+
+/**
+ * @brief Data for pipeline and result.
+ */
+static AppData g_app;
+
+/**
+ * @brief Parse the models (e.g., 'face:10:3:25,obj:5:1:60').
+ */
+static gboolean
+_parse_models (const gchar * str)
+{
+  model_info_s *model;
+  gchar **tokens, **fields;
+  guint i, n;
+  gboolean ret = TRUE;
+
+  tokens = g_strsplit (str, ",", -1);
+  for (i = 0; tokens[i] != NULL && ret; i++) {
+    if (g_app.num_models >= MAX_MODELS) {
+      ret = FALSE;
+      break;
+    }
+
+    fields = g_strsplit (g_strstrip (tokens[i]), ":", -1);
+    n = g_strv_length (fields);
+
+    if (n < 2 || n > 4 || *fields[0] == '\0') {
+      g_strfreev (fields);
+      ret = FALSE;
+      break;
+    }
+
+    model = &g_app.models[g_app.num_models++];
+    model->name = g_strdup (fields[0]);
+    model->fps = g_ascii_strtod (fields[1], NULL);
+    model->priority = (n > 2) ? (gint) g_ascii_strtoll (fields[2], NULL, 10) : 0;
+    model->cost_ms = (n > 3) ? (gint) g_ascii_strtoll (fields[3], NULL, 10) : 20;
+
+    if (model->fps < 0.0 || model->cost_ms < 0)
+      ret = FALSE;
+
+    g_strfreev (fields);
+  }
+  g_strfreev (tokens);
+
+  return ret && g_app.num_models > 0;
+}
+
+/**
+ * @brief Free resources in app data.
+ */
+static void
+_free_app_data (void)
+{
+  guint i;
+
+  if (g_app.loop) {
+    g_main_loop_unref (g_app.loop);
+    g_app.loop = NULL;
+  }
+
+  if (g_app.bus) {
+    gst_bus_remove_signal_watch (g_app.bus);
+    gst_object_unref (g_app.bus);
+    g_app.bus = NULL;
+  }
+
+  /* after the pipeline is stopped */
+  if (g_app.sched) {
+    nns_ex_model_sched_free (g_app.sched);
+    g_app.sched = NULL;
+  }
+
+  if (g_app.pipeline) {
+    gst_object_unref (g_app.pipeline);
+    g_app.pipeline = NULL;
+  }
+
+  for (i = 0; i < g_app.num_models; i++) {
+    g_free (g_app.models[i].name);
+    g_app.models[i].name = NULL;
+  }
+}
+
+/**
+ * @brief Function to print error message.
+ */
+static void
+_parse_err_message (GstMessage * message)
+{
+  gchar *debug;
+  GError *error;
+
+  g_return_if_fail (message != NULL);
+
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_ERROR:
+      gst_message_parse_error (message, &error, &debug);
+      break;
+
+    case GST_MESSAGE_WARNING:
+      gst_message_parse_warning (message, &error, &debug);
+      break;
+
+    default:
+      return;
+  }
+
+  gst_object_default_error (GST_MESSAGE_SRC (message), error, debug);
+  g_error_free (error);
+  g_free (debug);
+}
+
+/**
+ * @brief Callback for message.
+ */
+static void
+_message_cb (GstBus * bus, GstMessage * message, gpointer user_data)
+{
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_EOS:
+      _print_log ("received eos message");
+      g_main_loop_quit (g_app.loop);
+      break;
+
+    case GST_MESSAGE_ERROR:
+      _print_log ("received error message");
+      _parse_err_message (message);
+      g_main_loop_quit (g_app.loop);
+      break;
+
+    case GST_MESSAGE_WARNING:
+      _print_log ("received warning message");
+      _parse_err_message (message);
+      break;
+
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief Get the CPU time of the current thread in microseconds.
+ */
+static gint64
+_get_thread_time (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_THREAD_CPUTIME_ID, &ts);
+  return (gint64) ts.tv_sec * G_USEC_PER_SEC + ts.tv_nsec / 1000;
+}
+
+/**
+ * @brief Callback for identity handoff signal, the synthetic model keeps the core busy for its cost.
+ * @note The cost is the CPU time of the branch thread, so the models run longer when they share the cores.
+ */
+static void
+_synthetic_model_cb (GstElement * element, GstBuffer * buffer,
+    gpointer user_data)
+{
+  model_info_s *model = (model_info_s *) user_data;
+  volatile guint64 work = 0;
+  gint64 end;
+
+  end = _get_thread_time () + (gint64) model->cost_ms * 1000;
+
+  while (_get_thread_time () < end)
+    work++;
+}
+
+/**
+ * @brief Print the target and achieved rate of each model.
+ */
+static void
+_print_stats (gboolean summary)
+{
+  nns_ex_model_sched_stats_s stats;
+  model_info_s *model;
+  guint64 invoked = 0, completed = 0, lost = 0;
+  gdouble target = 0.0, achieved = 0.0;
+  guint i;
+
+  for (i = 0; i < g_app.num_models; i++) {
+    model = &g_app.models[i];
+
+    if (!nns_ex_model_sched_get_stats (g_app.sched, model->name, &stats))
+      continue;
+
+    invoked += stats.invoked;
+    completed += stats.completed;
+    lost += stats.lost;
+    target += stats.target_fps;
+    achieved += stats.achieved_fps;
+
+    g_print ("  %-8s: priority %d, target %5.1f fps, achieved %5.1f fps, "
+        "skipped %" G_GUINT64_FORMAT ", deferred %" G_GUINT64_FORMAT
+        ", lost %" G_GUINT64_FORMAT ", latency avg %6.1f ms max %6.1f ms\n",
+        model->name, model->priority, stats.target_fps, stats.achieved_fps,
+        stats.skipped, stats.deferred, stats.lost,
+        stats.completed ? (gdouble) stats.total_latency / stats.completed /
+        GST_MSECOND : 0.0, (gdouble) stats.max_latency / GST_MSECOND);
+  }
+
+  g_print ("%s models %u, invoked %" G_GUINT64_FORMAT ", completed %"
+      G_GUINT64_FORMAT ", lost %" G_GUINT64_FORMAT
+      ", target %.1f fps, achieved %.1f fps\n",
+      summary ? "[summary]" : "[stats]", g_app.num_models, invoked, completed,
+      lost, target, achieved);
+}
+
+/**
+ * @brief Timer callback to print the stats.
+ */
+static gboolean
+_timer_stats_cb (gpointer user_data)
+{
+  if (g_app.running)
+    _print_stats (FALSE);
+
+  return TRUE;
+}
+
+/**
+ * @brief Timer callback to stop the app.
+ */
+static gboolean
+_timer_quit_cb (gpointer user_data)
+{
+  g_app.quit_timer_id = 0;
+  g_main_loop_quit (g_app.loop);
+  return FALSE;
+}
+
+/**
+ * @brief Make the pipeline description.
+ */
+static gchar *
+_make_pipeline_description (gint framerate, const gchar * tflite)
+{
+  GString *desc = g_string_new (NULL);
+  const gchar *name;
+  guint i;
+
+  /* live source at the camera rate, the input tensor of ssd (3:300:300:1 float32) */
+  g_string_append_printf (desc,
+      "videotestsrc is-live=true ! "
+      "video/x-raw,format=RGB,width=%d,height=%d,framerate=%d/1 ! "
+      "tensor_converter ! "
+      "tensor_transform mode=arithmetic option=typecast:float32,add:-127.5,div:127.5 ! "
+      "tee name=tssd ", MODEL_WIDTH, MODEL_HEIGHT, framerate);
+
+  for (i = 0; i < g_app.num_models; i++) {
+    name = g_app.models[i].name;
+
+    g_string_append_printf (desc,
+        "tssd. ! queue name=q_%s leaky=2 max-size-buffers=2 ! ", name);
+
+    if (tflite) {
+      g_string_append_printf (desc,
+          "tensor_filter name=filter_%s framework=tensorflow-lite model=%s ! ",
+          name, tflite);
+    } else {
+      g_string_append_printf (desc,
+          "identity name=filter_%s signal-handoffs=true ! ", name);
+    }
+
+    g_string_append_printf (desc, "tensor_sink name=res_%s ", name);
+  }
+
+  return g_string_free (desc, FALSE);
+}
+
+/**
+ * @brief Connect the synthetic models and set the model scheduler.
+ */
+static gboolean
+_set_models (gboolean synthetic, gint workers, gint per_frame,
+    gboolean baseline)
+{
+  model_info_s *model;
+  GstElement *element;
+  gchar *entry, *end;
+  guint i;
+  gboolean ret = TRUE;
+
+  g_app.sched = baseline ? nns_ex_model_sched_new (0, 0) :
+      nns_ex_model_sched_new ((guint) workers, (guint) per_frame);
+
+  for (i = 0; i < g_app.num_models && ret; i++) {
+    model = &g_app.models[i];
+
+    entry = g_strdup_printf ("q_%s", model->name);
+    end = g_strdup_printf ("filter_%s", model->name);
+
+    if (synthetic) {
+      element = gst_bin_get_by_name (GST_BIN (g_app.pipeline), end);
+      if (element) {
+        g_signal_connect (element, "handoff",
+            G_CALLBACK (_synthetic_model_cb), model);
+        gst_object_unref (element);
+      } else {
+        ret = FALSE;
+      }
+    }
+
+    /* the baseline gives every frame to every model, to measure the achieved rate */
+    ret = ret && nns_ex_model_sched_add_model (g_app.sched, model->name,
+        entry, end, baseline ? 0.0 : model->fps, model->priority);
+
+    g_free (entry);
+    g_free (end);
+  }
+
+  return ret && nns_ex_model_sched_attach (g_app.sched, g_app.pipeline,
+      "tssd");
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  gint workers = DEFAULT_WORKERS;
+  gint per_frame = DEFAULT_PER_FRAME;
+  gint framerate = DEFAULT_FRAMERATE;
+  gint duration = DEFAULT_DURATION;
+  gboolean baseline = FALSE;
+  gchar *models = NULL;
+  gchar *tflite = NULL;
+
+  gchar *str_pipeline;
+  gulong handle_id;
+  guint timer_id = 0;
+  GOptionContext *optionctx;
+  GError *error = NULL;
+
+  const GOptionEntry main_entries[] = {
+    {"models", 'm', G_OPTION_FLAG_NONE, G_OPTION_ARG_STRING, &models,
+        "Models, name:fps:priority:cost-ms separated by comma", DEFAULT_MODELS},
+    {"workers", 'w', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &workers,
+        "Max number of the models running at once (0 for unbounded)", "2"},
+    {"per-frame", 'p', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &per_frame,
+        "Max number of the models started on a frame (0 for unbounded)", "1"},
+    {"framerate", 'r', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &framerate,
+        "Frame rate of the test source", "30"},
+    {"duration", 'd', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &duration,
+        "Seconds to run (0 to run until EOS)", "10"},
+    {"baseline", 'b', G_OPTION_FLAG_NONE, G_OPTION_ARG_NONE, &baseline,
+        "Give every frame to every model (no scheduling)", NULL},
+    {"tflite", 't', G_OPTION_FLAG_NONE, G_OPTION_ARG_FILENAME, &tflite,
+        "tflite model of 3:300:300:1 float32 input for all models, instead of the synthetic models",
+        "file"},
+    {NULL}
+  };
+
+  _print_log ("start app..");
+
+  optionctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (optionctx, main_entries, NULL);
+
+  if (!g_option_context_parse (optionctx, &argc, &argv, &error)) {
+    g_printerr ("option parsing failed: %s\n", error->message);
+    g_error_free (error);
+    g_option_context_free (optionctx);
+    return -1;
+  }
+
+  g_option_context_free (optionctx);
+
+  /* init app variable */
+  g_app.running = FALSE;
+  g_app.num_models = 0;
+  g_app.quit_timer_id = 0;
+
+  if (!_parse_models (models ? models : DEFAULT_MODELS) || workers < 0 ||
+      per_frame < 0 || framerate <= 0) {
+    g_printerr ("invalid models (1 ~ %d, name:fps:priority:cost-ms), "
+        "workers, per-frame or frame rate\n", MAX_MODELS);
+    goto error;
+  }
+
+  if (tflite && access (tflite, F_OK) != 0) {
+    g_printerr ("cannot find tflite model [%s]\n", tflite);
+    goto error;
+  }
+
+  /* init gstreamer */
+  gst_init (&argc, &argv);
+
+  /* main loop */
+  g_app.loop = g_main_loop_new (NULL, FALSE);
+  _check_cond_err (g_app.loop != NULL);
+
+  /* init pipeline */
+  str_pipeline = _make_pipeline_description (framerate, tflite);
+  _print_log ("%s\n", str_pipeline);
+
+  g_app.pipeline = gst_parse_launch (str_pipeline, NULL);
+  g_free (str_pipeline);
+  _check_cond_err (g_app.pipeline != NULL);
+
+  /* bus and message callback */
+  g_app.bus = gst_element_get_bus (g_app.pipeline);
+  _check_cond_err (g_app.bus != NULL);
+
+  gst_bus_add_signal_watch (g_app.bus);
+  handle_id = g_signal_connect (g_app.bus, "message",
+      (GCallback) _message_cb, NULL);
+  _check_cond_err (handle_id > 0);
+
+  /* models and scheduler, before the pipeline starts */
+  _check_cond_err (_set_models (tflite == NULL, workers, per_frame,
+          baseline));
+
+  g_print ("%s, models %u, workers %d, per-frame %d, %d fps\n",
+      baseline ? "baseline" : "scheduled", g_app.num_models,
+      baseline ? 0 : workers, baseline ? 0 : per_frame, framerate);
+
+  /* timer to print the stats */
+  timer_id = g_timeout_add_seconds (1, _timer_stats_cb, NULL);
+  _check_cond_err (timer_id > 0);
+
+  if (duration > 0) {
+    g_app.quit_timer_id =
+        g_timeout_add_seconds (duration, _timer_quit_cb, NULL);
+    _check_cond_err (g_app.quit_timer_id > 0);
+  }
+
+  /* start pipeline */
+  gst_element_set_state (g_app.pipeline, GST_STATE_PLAYING);
+
+  g_app.running = TRUE;
+
+  /* run main loop */
+  g_main_loop_run (g_app.loop);
+
+  /* quit when received eos or error message, or the duration is over */
+  g_app.running = FALSE;
+
+  gst_element_set_state (g_app.pipeline, GST_STATE_NULL);
+
+  _print_stats (FALSE);
+  _print_stats (TRUE);
+
+error:
+  _print_log ("close app..");
+
+  if (timer_id > 0) {
+    g_source_remove (timer_id);
+  }
+
+  if (g_app.quit_timer_id > 0) {
+    g_source_remove (g_app.quit_timer_id);
+    g_app.quit_timer_id = 0;
+  }
+
+  g_free (models);
+  g_free (tflite);
+  _free_app_data ();
+  return 0;
+}
@@ -0,0 +1,259 @@
+/**
+ * NNStreamer custom filter standing in for a batched classification model
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * LICENSE: LGPL-2.1
+ *
+ * @file	nnscustom_batch_stand_in.c
+ * @date	19 October 2026
+ * @author	agent <agent@local>
+ * @brief	Custom filter to classify a batch of uint8 images with a fixed random linear layer, used for multi stream batch example.
+ * @bug		No known bugs
+ *
+ * The example needs a model with the batch size of the number of streams,
+ * and the example models are converted with the batch size 1.
+ * This filter accepts any batch, so the pipeline runs out of the box with 1, 2, 4 or 8 streams.
+ * It is not a model : the scores come from the pooled pixels and random weights,
+ * and the work grows linearly with the batch, so use a batched model to measure the gain of batching.
+ *
+ * Usage :
+ * tensor_filter framework=custom model=libnnscustom_batch_stand_in.so custom=labels:1001
+ *
+ * Input uint8 channel:width:height:batch, output uint8 labels:batch (the default is 1001 labels).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <nnstreamer/tensor_filter_custom.h>
+
+/**
+ * @brief Default number of labels (mobilenet_v1).
+ */
+#define DEFAULT_LABELS 1001
+
+/**
+ * @brief Max number of channels.
+ */
+#define MAX_CHANNELS 4
+
+/**
+ * @brief The image is pooled into the grid of GRID_SIZE x GRID_SIZE cells.
+ */
+#define GRID_SIZE 8
+
+/**
+ * @brief Number of the features (pooled cells of each channel).
+ */
+#define MAX_FEATURES (GRID_SIZE * GRID_SIZE * MAX_CHANNELS)
+
+/**
+ * @brief nnstreamer custom filter private data
+ */
+typedef struct _pt_data
+{
+  unsigned int channels; /**< number of channels */
+  unsigned int width; /**< image width */
+  unsigned int height; /**< image height */
+  unsigned int batch; /**< number of images in a tensor */
+  unsigned int labels; /**< number of labels */
+  unsigned int features; /**< number of features */
+  unsigned char *weights; /**< weights, labels x features */
+} pt_data;
+
+/**
+ * @brief nnstreamer custom filter standard vmethod
+ * Refer tensor_filter_custom.h
+ */
+static void *
+pt_init (const GstTensorFilterProperties * prop)
+{
+  pt_data *data = (pt_data *) malloc (sizeof (pt_data));
+
+  assert (data);
+  memset (data, 0, sizeof (pt_data));
+
+  return data;
+}
+
+/**
+ * @brief nnstreamer custom filter standard vmethod
+ * Refer tensor_filter_custom.h
+ */
+static void
+pt_exit (void *_data, const GstTensorFilterProperties * prop)
+{
+  pt_data *data = _data;
+
+  assert (data);
+  free (data->weights);
+  free (data);
+}
+
+/**
+ * @brief Parse the number of labels from the custom option (labels:N).
+ * @return number of labels, 0 if the option is invalid
+ */
+static unsigned int
+parse_labels (const char *option)
+{
+  const char *str;
+  char *end;
+  unsigned long labels;
+
+  if (option == NULL || *option == '\0')
+    return DEFAULT_LABELS;
+
+  str = strstr (option, "labels:");
+  if (str == NULL)
+    return 0;
+
+  labels = strtoul (str + strlen ("labels:"), &end, 10);
+  if (end == str + strlen ("labels:") || labels == 0 || labels > 65536)
+    return 0;
+
+  return (unsigned int) labels;
+}
+
+/**
+ * @brief nnstreamer custom filter standard vmethod
+ * Refer tensor_filter_custom.h
+ */
+static int
+set_inputDim (void *_data, const GstTensorFilterProperties * prop,
+    const GstTensorsInfo * in_info, GstTensorsInfo * out_info)
+{
+  pt_data *data = _data;
+  unsigned int i, seed;
+
+  assert (data);
+  assert (in_info);
+  assert (out_info);
+
+  /* uint8 image, dimension channel:width:height:batch */
+  if (in_info->num_tensors != 1 || in_info->info[0].type != _NNS_UINT8)
+    return -1;
+
+  data->channels = in_info->info[0].dimension[0];
+  data->width = in_info->info[0].dimension[1];
+  data->height = in_info->info[0].dimension[2];
+  data->batch = in_info->info[0].dimension[3];
+
+  if (data->channels == 0 || data->channels > MAX_CHANNELS ||
+      data->width < GRID_SIZE || data->height < GRID_SIZE || data->batch == 0)
+    return -1;
+
+  data->labels = parse_labels (prop->custom_properties);
+  if (data->labels == 0) {
+    fprintf (stderr, "Invalid option [%s], e.g., labels:1001\n",
+        prop->custom_properties);
+    return -1;
+  }
+
+  /* fixed random weights, the same scores for the same image */
+  data->features = GRID_SIZE * GRID_SIZE * data->channels;
+  free (data->weights);
+  data->weights = (unsigned char *) malloc (data->labels * data->features);
+  assert (data->weights);
+
+  seed = 1U;
+  for (i = 0; i < data->labels * data->features; i++) {
+    seed = seed * 1103515245U + 12345U;
+    data->weights[i] = (unsigned char) (seed >> 24);
+  }
+
+  /* uint8 scores, dimension labels:batch */
+  out_info->num_tensors = 1;
+  out_info->info[0].name = NULL;
+  out_info->info[0].type = _NNS_UINT8;
+  out_info->info[0].dimension[0] = data->labels;
+  out_info->info[0].dimension[1] = data->batch;
+
+  for (i = 2; i < NNS_TENSOR_RANK_LIMIT; i++)
+    out_info->info[0].dimension[i] = 1;
+
+  return 0;
+}
+
+/**
+ * @brief Pool the image into the grid, the average of each cell and channel.
+ */
+static void
+pool_image (const pt_data * data, const unsigned char *image,
+    unsigned char *features)
+{
+  unsigned int sums[MAX_FEATURES] = { 0 };
+  unsigned int counts[GRID_SIZE * GRID_SIZE] = { 0 };
+  unsigned int x, y, c, cell;
+  const unsigned char *pixel = image;
+
+  for (y = 0; y < data->height; y++) {
+    for (x = 0; x < data->width; x++) {
+      cell = (y * GRID_SIZE / data->height) * GRID_SIZE +
+          x * GRID_SIZE / data->width;
+
+      for (c = 0; c < data->channels; c++)
+        sums[cell * data->channels + c] += pixel[c];
+
+      counts[cell]++;
+      pixel += data->channels;
+    }
+  }
+
+  for (cell = 0; cell < GRID_SIZE * GRID_SIZE; cell++) {
+    for (c = 0; c < data->channels; c++) {
+      features[cell * data->channels + c] =
+          (unsigned char) (sums[cell * data->channels + c] / counts[cell]);
+    }
+  }
+}
+
+/**
+ * @brief nnstreamer custom filter standard vmethod
+ * Refer tensor_filter_custom.h
+ */
+static int
+invoke (void *_data, const GstTensorFilterProperties * prop,
+    const GstTensorMemory * input, GstTensorMemory * output)
+{
+  pt_data *data = _data;
+  unsigned char features[MAX_FEATURES];
+  const unsigned char *weights;
+  unsigned char *scores;
+  size_t image_size;
+  unsigned int b, l, f, sum;
+
+  assert (data);
+
+  image_size = (size_t) data->width * data->height * data->channels;
+
+  for (b = 0; b < data->batch; b++) {
+    pool_image (data, (const unsigned char *) input[0].data + image_size * b,
+        features);
+
+    /* linear layer, the score is the weighted sum scaled to uint8 */
+    scores = (unsigned char *) output[0].data + (size_t) data->labels * b;
+    for (l = 0; l < data->labels; l++) {
+      weights = data->weights + (size_t) l * data->features;
+
+      sum = 0;
+      for (f = 0; f < data->features; f++)
+        sum += (unsigned int) features[f] * weights[f];
+
+      scores[l] = (unsigned char) (sum / (255U * data->features));
+    }
+  }
+
+  return 0;
+}
+
+static NNStreamer_custom_class NNStreamer_custom_body = {
+  .initfunc = pt_init,
+  .exitfunc = pt_exit,
+  .setInputDim = set_inputDim,
+  .invoke = invoke,
+};
+
+/* The dyn-loaded object */
+NNStreamer_custom_class *NNStreamer_custom = &NNStreamer_custom_body;
@@ -0,0 +1,770 @@
+/**
+ * @file	nnstreamer_example_multi_stream_batch.c
+ * @date	19 October 2026
+ * @brief	Tensor stream example serving N video streams with a single batched model
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * NNStreamer example for image classification of N streams using tensorflow-lite.
+ * The frames of all streams are merged into a batched tensor (3:224:224:N),
+ * then a single tensor_filter runs the model once for N frames.
+ *
+ * Pipeline :
+ * videotestsrc (or filesrc) -- nns_ex_tensorize -- queue --
+ *   ...                                                    |
+ * videotestsrc (or filesrc) -- nns_ex_tensorize -- queue -- tensor_merge -- tensor_filter -- tensor_sink
+ *
+ * The output (1001:N) is split back per stream, and the app reports the aggregate throughput
+ * and the latency of each stream (running time when the result arrives - timestamp of the merged frame).
+ *
+ * The model should accept the batch of N images (input 3:224:224:N, output 1001:N, uint8),
+ * e.g., mobilenet_v1_1.0_224_quant converted with the batch size N.
+ * 'mobilenet_v1_1.0_224_quant.tflite' from get-model-image-classification-tflite.sh
+ * has the batch size 1, so it serves only 1 stream.
+ * With --model, the app checks the batch size of the model input before running, and fails if it is not N.
+ *
+ * Without --model, the custom filter 'libnnscustom_batch_stand_in.so' stands in for the model.
+ * It accepts any batch (3:224:224:N to 1001:N), so the pipeline runs out of the box with any N,
+ * but its cost grows linearly with N (see nnscustom_batch_stand_in.c).
+ * The labels are optional with the stand-in, the app prints the label index if the label file is not found.
+ *
+ * Run example :
+ * Before running this example, GST_PLUGIN_PATH should be updated for nnstreamer plug-in.
+ * $ export GST_PLUGIN_PATH=$GST_PLUGIN_PATH:<nnstreamer plugin path>
+ * $ ./nnstreamer_example_multi_stream_batch --streams=4
+ * $ ./nnstreamer_example_multi_stream_batch --streams=4 --model=./tflite_model_img/mobilenet_batch4.tflite
+ * $ ./nnstreamer_example_multi_stream_batch --file=a.mp4 --file=b.mp4 --model=<batch 2 model>
+ *
+ * To see how the throughput and latency change as N grows, run with --streams=1, 2, 4, 8
+ * and compare the summary lines (with the stand-in, or the model of each batch size).
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <glib.h>
+#include <gst/gst.h>
+
+#include "nns_ex_tensorize.h"
+#include "nns_ex_topk.h"
+
+/**
+ * @brief Macro for debug mode.
+ */
+#ifndef DBG
+#define DBG FALSE
+#endif
+
+/**
+ * @brief Macro for debug message.
+ */
+#define _print_log(...) if (DBG) g_message (__VA_ARGS__)
+
+/**
+ * @brief Macro to check error case.
+ */
+#define _check_cond_err(cond) \
+  do { \
+    if (!(cond)) { \
+      _print_log ("app failed! [line : %d]", __LINE__); \
+      goto error; \
+    } \
+  } while (0)
+
+/**
+ * @brief Max number of streams.
+ */
+#define MAX_STREAMS 16
+
+/**
+ * @brief Default values of the options.
+ */
+#define DEFAULT_STREAMS 1
+#define DEFAULT_FRAMERATE 30
+#define DEFAULT_DURATION 10
+#define DEFAULT_LABEL "./tflite_model_img/labels.txt"
+
+/**
+ * @brief Custom filter standing in for the batched model, and its number of labels.
+ */
+#define STAND_IN_FILTER "./libnnscustom_batch_stand_in.so"
+#define STAND_IN_LABELS 1001
+
+/**
+ * @brief Input dimension of the model.
+ */
+#define MODEL_WIDTH 224
+#define MODEL_HEIGHT 224
+
+/**
+ * @brief Data structure for a stream.
+ */
+typedef struct
+{
+  GstClockTime last_pts; /**< timestamp of the latest frame into tensor_merge */
+  GstClockTime batch_pts; /**< timestamp of the frame in the current batch */
+  gint label_index; /**< latest label index */
+  guint64 results; /**< count of results */
+  GstClockTime total_latency; /**< sum of latency */
+  GstClockTime max_latency; /**< max latency */
+} stream_info_s;
+
+/**
+ * @brief Data structure for app.
+ */
+typedef struct
+{
+  GMainLoop *loop; /**< main event loop */
+  GstElement *pipeline; /**< gst pipeline for data stream */
+  GstBus *bus; /**< gst bus for data pipeline */
+
+  gboolean running; /**< true when app is running */
+  guint num_streams; /**< number of streams */
+  stream_info_s streams[MAX_STREAMS]; /**< info of each stream */
+  GMutex lock; /**< lock for the stream info */
+
+  guint64 batches; /**< count of batches */
+  gint64 start_time; /**< monotonic time of the first batch */
+  gint64 last_time; /**< monotonic time of the last batch */
+  guint quit_timer_id; /**< timer to stop the app */
+
+  GList *labels; /**< list of loaded labels */
+  guint total_labels; /**< count of labels */
+  nns_ex_quant_s quant; /**< output quantization of the model */
+} AppData;
+
+/**
+ * @brief Data for pipeline and result.
+ */
+static AppData g_app;
+
+/**
+ * @brief Load labels.
+ */
+static gboolean
+_load_labels (const gchar * path)
+{
+  FILE *fp;
+  char *line = NULL;
+  size_t len = 0;
+
+  if ((fp = fopen (path, "r")) == NULL) {
+    g_printerr ("cannot find label [%s]\n", path);
+    return FALSE;
+  }
+
+  while (getline (&line, &len, fp) != -1) {
+    g_app.labels = g_list_append (g_app.labels, g_strstrip (g_strdup (line)));
+  }
+
+  if (line) {
+    free (line);
+  }
+
+  fclose (fp);
+
+  g_app.total_labels = g_list_length (g_app.labels);
+  _print_log ("finished to load labels, total %d", g_app.total_labels);
+  return (g_app.total_labels > 0);
+}
+
+/**
+ * @brief Free resources in app data.
+ */
+static void
+_free_app_data (void)
+{
+  if (g_app.loop) {
+    g_main_loop_unref (g_app.loop);
+    g_app.loop = NULL;
+  }
+
+  if (g_app.bus) {
+    gst_bus_remove_signal_watch (g_app.bus);
+    gst_object_unref (g_app.bus);
+    g_app.bus = NULL;
+  }
+
+  if (g_app.pipeline) {
+    gst_object_unref (g_app.pipeline);
+    g_app.pipeline = NULL;
+  }
+
+  if (g_app.labels) {
+    g_list_free_full (g_app.labels, g_free);
+    g_app.labels = NULL;
+  }
+
+  g_mutex_clear (&g_app.lock);
+}
+
+/**
+ * @brief Function to print error message.
+ */
+static void
+_parse_err_message (GstMessage * message)
+{
+  gchar *debug;
+  GError *error;
+
+  g_return_if_fail (message != NULL);
+
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_ERROR:
+      gst_message_parse_error (message, &error, &debug);
+      break;
+
+    case GST_MESSAGE_WARNING:
+      gst_message_parse_warning (message, &error, &debug);
+      break;
+
+    default:
+      return;
+  }
+
+  gst_object_default_error (GST_MESSAGE_SRC (message), error, debug);
+  g_error_free (error);
+  g_free (debug);
+}
+
+/**
+ * @brief Callback for message.
+ */
+static void
+_message_cb (GstBus * bus, GstMessage * message, gpointer user_data)
+{
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_EOS:
+      _print_log ("received eos message");
+      g_main_loop_quit (g_app.loop);
+      break;
+
+    case GST_MESSAGE_ERROR:
+      _print_log ("received error message");
+      _parse_err_message (message);
+      g_main_loop_quit (g_app.loop);
+      break;
+
+    case GST_MESSAGE_WARNING:
+      _print_log ("received warning message");
+      _parse_err_message (message);
+      break;
+
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief Pad probe on the sink pads of tensor_merge, keep the timestamp of the latest frame of the stream.
+ */
+static GstPadProbeReturn
+_merge_sink_probe_cb (GstPad * pad, GstPadProbeInfo * info,
+    gpointer user_data)
+{
+  stream_info_s *stream = (stream_info_s *) user_data;
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+
+  g_mutex_lock (&g_app.lock);
+  stream->last_pts = GST_BUFFER_PTS (buffer);
+  g_mutex_unlock (&g_app.lock);
+
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Pad probe on the src pad of tensor_merge, keep the timestamps of the frames in the batch.
+ *
+ * tensor_merge, tensor_filter and tensor_sink run in the same thread,
+ * so the next 'new-data' signal is for this batch.
+ */
+static GstPadProbeReturn
+_merge_src_probe_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  guint i;
+
+  g_mutex_lock (&g_app.lock);
+  for (i = 0; i < g_app.num_streams; i++)
+    g_app.streams[i].batch_pts = g_app.streams[i].last_pts;
+  g_mutex_unlock (&g_app.lock);
+
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Get the running time of the element.
+ */
+static GstClockTime
+_get_running_time (GstElement * element)
+{
+  GstClock *clock;
+  GstClockTime now;
+
+  clock = gst_element_get_clock (element);
+  if (clock == NULL)
+    return GST_CLOCK_TIME_NONE;
+
+  now = gst_clock_get_time (clock) - gst_element_get_base_time (element);
+  gst_object_unref (clock);
+  return now;
+}
+
+/**
+ * @brief Callback for tensor sink signal, split the batched output per stream.
+ */
+static void
+_new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
+{
+  GstMemory *mem;
+  GstMapInfo info;
+  GstClockTime now, latency;
+  stream_info_s *stream;
+  gint index;
+  guint i;
+
+  if (!g_app.running || gst_buffer_n_memory (buffer) != 1)
+    return;
+
+  now = _get_running_time (element);
+  mem = gst_buffer_peek_memory (buffer, 0);
+
+  if (!gst_memory_map (mem, &info, GST_MAP_READ))
+    return;
+
+  if (info.size != (gsize) g_app.total_labels * g_app.num_streams) {
+    _print_log ("invalid output size %" G_GSIZE_FORMAT, info.size);
+    gst_memory_unmap (mem, &info);
+    return;
+  }
+
+  g_mutex_lock (&g_app.lock);
+  for (i = 0; i < g_app.num_streams; i++) {
+    stream = &g_app.streams[i];
+
+    /* scores of stream i */
+    index = nns_ex_argmax_uint8 (info.data + (gsize) i * g_app.total_labels,
+        g_app.total_labels, &g_app.quant, 0.0f);
+
+    stream->label_index = index;
+    stream->results++;
+
+    if (GST_CLOCK_TIME_IS_VALID (now) &&
+        GST_CLOCK_TIME_IS_VALID (stream->batch_pts) &&
+        now > stream->batch_pts) {
+      latency = now - stream->batch_pts;
+
+      stream->total_latency += latency;
+      stream->max_latency = MAX (stream->max_latency, latency);
+    }
+  }
+
+  g_app.last_time = g_get_monotonic_time ();
+  if (g_app.batches == 0)
+    g_app.start_time = g_app.last_time;
+  g_app.batches++;
+  g_mutex_unlock (&g_app.lock);
+
+  gst_memory_unmap (mem, &info);
+}
+
+/**
+ * @brief Print the throughput and latency of each stream.
+ */
+static void
+_print_stats (gboolean summary)
+{
+  stream_info_s *stream;
+  GstClockTime total_latency = 0, max_latency = 0;
+  guint64 results = 0;
+  gdouble elapsed, fps = 0.0;
+  const gchar *label;
+  guint i;
+
+  g_mutex_lock (&g_app.lock);
+
+  elapsed = (g_app.last_time - g_app.start_time) / (gdouble) G_USEC_PER_SEC;
+  if (g_app.batches > 1 && elapsed > 0.0)
+    fps = (g_app.batches - 1) / elapsed;
+
+  for (i = 0; i < g_app.num_streams; i++) {
+    stream = &g_app.streams[i];
+
+    total_latency += stream->total_latency;
+    max_latency = MAX (max_latency, stream->max_latency);
+    results += stream->results;
+
+    if (summary)
+      continue;
+
+    label = (stream->label_index >= 0) ?
+        (const gchar *) g_list_nth_data (g_app.labels, stream->label_index) :
+        NULL;
+
+    g_print ("  stream %2u: latency avg %6.1f ms max %6.1f ms, label %s (%d)\n",
+        i, stream->results ? (gdouble) stream->total_latency / stream->results /
+        GST_MSECOND : 0.0, (gdouble) stream->max_latency / GST_MSECOND,
+        label ? label : "-", stream->label_index);
+  }
+
+  g_print ("%s streams %u, batches %" G_GUINT64_FORMAT
+      ", %.1f batches/s, %.1f frames/s, latency avg %.1f ms max %.1f ms\n",
+      summary ? "[summary]" : "[stats]", g_app.num_streams, g_app.batches,
+      fps, fps * g_app.num_streams,
+      results ? (gdouble) total_latency / results / GST_MSECOND : 0.0,
+      (gdouble) max_latency / GST_MSECOND);
+
+  g_mutex_unlock (&g_app.lock);
+}
+
+/**
+ * @brief Timer callback to print the stats.
+ */
+static gboolean
+_timer_stats_cb (gpointer user_data)
+{
+  if (g_app.running)
+    _print_stats (FALSE);
+
+  return TRUE;
+}
+
+/**
+ * @brief Timer callback to stop the app.
+ */
+static gboolean
+_timer_quit_cb (gpointer user_data)
+{
+  g_app.quit_timer_id = 0;
+  g_main_loop_quit (g_app.loop);
+  return FALSE;
+}
+
+/**
+ * @brief Add the pad probes to tensor_merge.
+ */
+static gboolean
+_add_merge_probes (void)
+{
+  GstElement *merge;
+  GstPad *pad;
+  gchar *name;
+  guint i;
+  gboolean ret = TRUE;
+
+  merge = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "merge");
+  if (merge == NULL)
+    return FALSE;
+
+  for (i = 0; i < g_app.num_streams && ret; i++) {
+    name = g_strdup_printf ("sink_%u", i);
+    pad = gst_element_get_static_pad (merge, name);
+    g_free (name);
+
+    if (pad) {
+      gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+          _merge_sink_probe_cb, &g_app.streams[i], NULL);
+      gst_object_unref (pad);
+    } else {
+      ret = FALSE;
+    }
+  }
+
+  pad = gst_element_get_static_pad (merge, "src");
+  if (pad) {
+    gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, _merge_src_probe_cb,
+        NULL, NULL);
+    gst_object_unref (pad);
+  } else {
+    ret = FALSE;
+  }
+
+  gst_object_unref (merge);
+  return ret;
+}
+
+/**
+ * @brief Make the pipeline description.
+ * @param model tflite model, NULL to run the custom filter standing in for the model
+ */
+static gchar *
+_make_pipeline_description (gchar ** files, gint framerate,
+    const gchar * model)
+{
+  GString *desc = g_string_new (NULL);
+  guint i;
+
+  for (i = 0; i < g_app.num_streams; i++) {
+    if (files) {
+      g_string_append_printf (desc,
+          "filesrc location=\"%s\" ! decodebin ! videoconvert ! ", files[i]);
+    } else {
+      /* live sources at the camera rate, different pattern for each stream */
+      g_string_append_printf (desc,
+          "videotestsrc pattern=%u is-live=true ! "
+          "video/x-raw,format=I420,width=640,height=480,framerate=%d/1 ! ",
+          i % 19, framerate);
+    }
+
+    g_string_append_printf (desc,
+        "nns_ex_tensorize width=%d height=%d type=uint8 ! "
+        "queue leaky=2 max-size-buffers=2 ! merge.sink_%u ",
+        MODEL_WIDTH, MODEL_HEIGHT, i);
+  }
+
+  /* merge the frames along the batch dimension (3:224:224:N) */
+  g_string_append (desc, "tensor_merge name=merge mode=linear option=3 ! ");
+
+  if (model) {
+    g_string_append_printf (desc,
+        "tensor_filter name=filter framework=tensorflow-lite model=%s ! ",
+        model);
+  } else {
+    g_string_append_printf (desc,
+        "tensor_filter name=filter framework=custom model=%s custom=labels:%u ! ",
+        STAND_IN_FILTER, g_app.total_labels);
+  }
+
+  g_string_append (desc, "tensor_sink name=tensor_sink");
+
+  return g_string_free (desc, FALSE);
+}
+
+/**
+ * @brief Check the batch size of the model input is the number of streams.
+ * @note tensor_filter opens the model when the pipeline goes to PAUSED.
+ */
+static gboolean
+_check_model_batch (void)
+{
+  GstElement *filter;
+  gchar *input = NULL;
+  gchar **dims;
+  guint n;
+  guint64 batch;
+  gboolean ret = TRUE;
+
+  filter = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "filter");
+  if (filter == NULL)
+    return FALSE;
+
+  g_object_get (filter, "input", &input, NULL);
+  gst_object_unref (filter);
+
+  if (input == NULL || *input == '\0') {
+    /* the framework does not report the input dimension */
+    _print_log ("cannot get the input dimension of the model");
+    g_free (input);
+    return TRUE;
+  }
+
+  /* 3:224:224:N, the batch is the 4th dimension (1 if omitted) */
+  dims = g_strsplit (input, ":", -1);
+  n = g_strv_length (dims);
+  batch = (n >= 4) ? g_ascii_strtoull (dims[3], NULL, 10) : 1;
+  g_strfreev (dims);
+
+  if (batch != g_app.num_streams) {
+    g_printerr ("the model input %s has the batch size %" G_GUINT64_FORMAT
+        ", but %u streams are given (use the model converted with the batch size %u)\n",
+        input, batch, g_app.num_streams, g_app.num_streams);
+    ret = FALSE;
+  }
+
+  g_free (input);
+  return ret;
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  gint num_streams = DEFAULT_STREAMS;
+  gint framerate = DEFAULT_FRAMERATE;
+  gint duration = DEFAULT_DURATION;
+  gchar *model = NULL;
+  gchar *label = NULL;
+  gchar **files = NULL;
+
+  gchar *str_pipeline;
+  gulong handle_id;
+  guint timer_id = 0;
+  guint i;
+  GstElement *element;
+  GOptionContext *optionctx;
+  GError *error = NULL;
+
+  const GOptionEntry main_entries[] = {
+    {"streams", 'n', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &num_streams,
+        "Number of test sources (ignored with --file)", "1"},
+    {"file", 'f', G_OPTION_FLAG_NONE, G_OPTION_ARG_FILENAME_ARRAY, &files,
+        "Video file of a stream (repeat for each stream)", "file"},
+    {"framerate", 'r', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &framerate,
+        "Frame rate of the test sources", "30"},
+    {"duration", 'd', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &duration,
+        "Seconds to run (0 to run until EOS)", "10"},
+    {"model", 'm', G_OPTION_FLAG_NONE, G_OPTION_ARG_FILENAME, &model,
+        "tflite model with the batch size of the number of streams (the custom filter stands in for the model if not given)",
+        "file"},
+    {"label", 'l', G_OPTION_FLAG_NONE, G_OPTION_ARG_FILENAME, &label,
+        "Label file", "file"},
+    {NULL}
+  };
+
+  _print_log ("start app..");
+
+  optionctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (optionctx, main_entries, NULL);
+
+  if (!g_option_context_parse (optionctx, &argc, &argv, &error)) {
+    g_printerr ("option parsing failed: %s\n", error->message);
+    g_error_free (error);
+    g_option_context_free (optionctx);
+    return -1;
+  }
+
+  g_option_context_free (optionctx);
+
+  if (files)
+    num_streams = (gint) g_strv_length (files);
+
+  if (num_streams <= 0 || num_streams > MAX_STREAMS || framerate <= 0) {
+    g_printerr ("invalid number of streams (1 ~ %d) or frame rate\n",
+        MAX_STREAMS);
+    g_strfreev (files);
+    g_free (model);
+    g_free (label);
+    return -1;
+  }
+
+  /* init app variable */
+  g_app.running = FALSE;
+  g_app.num_streams = (guint) num_streams;
+  g_app.batches = 0;
+  g_app.quit_timer_id = 0;
+  g_mutex_init (&g_app.lock);
+
+  for (i = 0; i < g_app.num_streams; i++) {
+    g_app.streams[i].last_pts = GST_CLOCK_TIME_NONE;
+    g_app.streams[i].batch_pts = GST_CLOCK_TIME_NONE;
+    g_app.streams[i].label_index = -1;
+  }
+
+  /* output quantization of mobilenet_v1_1.0_224_quant */
+  g_app.quant.scale = 1.0f / 256.0f;
+  g_app.quant.zero_point = 0;
+
+  if (model) {
+    if (access (model, F_OK) != 0) {
+      g_printerr ("cannot find tflite model [%s]\n", model);
+      goto error;
+    }
+
+    _check_cond_err (_load_labels (label ? label : DEFAULT_LABEL));
+  } else {
+    if (access (STAND_IN_FILTER, F_OK) != 0) {
+      g_printerr ("cannot find the custom filter [%s]\n", STAND_IN_FILTER);
+      goto error;
+    }
+
+    /* the stand-in does not need the labels */
+    if (label || access (DEFAULT_LABEL, F_OK) == 0)
+      _check_cond_err (_load_labels (label ? label : DEFAULT_LABEL));
+    else
+      g_app.total_labels = STAND_IN_LABELS;
+
+    g_print ("no model given, the custom filter stands in for the model "
+        "with the batch size %u\n", g_app.num_streams);
+  }
+
+  /* init gstreamer */
+  gst_init (&argc, &argv);
+  _check_cond_err (nns_ex_tensorize_register ());
+
+  /* main loop */
+  g_app.loop = g_main_loop_new (NULL, FALSE);
+  _check_cond_err (g_app.loop != NULL);
+
+  /* init pipeline */
+  str_pipeline = _make_pipeline_description (files, framerate, model);
+  _print_log ("%s\n", str_pipeline);
+
+  g_app.pipeline = gst_parse_launch (str_pipeline, NULL);
+  g_free (str_pipeline);
+  _check_cond_err (g_app.pipeline != NULL);
+
+  /* bus and message callback */
+  g_app.bus = gst_element_get_bus (g_app.pipeline);
+  _check_cond_err (g_app.bus != NULL);
+
+  gst_bus_add_signal_watch (g_app.bus);
+  handle_id = g_signal_connect (g_app.bus, "message",
+      (GCallback) _message_cb, NULL);
+  _check_cond_err (handle_id > 0);
+
+  /* timestamps of the frames in each batch */
+  _check_cond_err (_add_merge_probes ());
+
+  /* tensor sink signal : new data callback */
+  element = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "tensor_sink");
+  handle_id = g_signal_connect (element, "new-data",
+      (GCallback) _new_data_cb, NULL);
+  gst_object_unref (element);
+  _check_cond_err (handle_id > 0);
+
+  /* timer to print the stats */
+  timer_id = g_timeout_add_seconds (1, _timer_stats_cb, NULL);
+  _check_cond_err (timer_id > 0);
+
+  if (duration > 0) {
+    g_app.quit_timer_id =
+        g_timeout_add_seconds (duration, _timer_quit_cb, NULL);
+    _check_cond_err (g_app.quit_timer_id > 0);
+  }
+
+  /* open the model and check the batch size before running (the stand-in accepts any batch) */
+  gst_element_set_state (g_app.pipeline, GST_STATE_PAUSED);
+  if (model && !_check_model_batch ()) {
+    gst_element_set_state (g_app.pipeline, GST_STATE_NULL);
+    goto error;
+  }
+
+  /* start pipeline */
+  gst_element_set_state (g_app.pipeline, GST_STATE_PLAYING);
+
+  g_app.running = TRUE;
+
+  /* run main loop */
+  g_main_loop_run (g_app.loop);
+
+  /* quit when received eos or error message, or the duration is over */
+  g_app.running = FALSE;
+
+  gst_element_set_state (g_app.pipeline, GST_STATE_NULL);
+
+  _print_stats (FALSE);
+  _print_stats (TRUE);
+
+error:
+  _print_log ("close app..");
+
+  if (timer_id > 0) {
+    g_source_remove (timer_id);
+  }
+
+  if (g_app.quit_timer_id > 0) {
+    g_source_remove (g_app.quit_timer_id);
+    g_app.quit_timer_id = 0;
+  }
+
+  g_strfreev (files);
+  g_free (model);
+  g_free (label);
+  _free_app_data ();
+  return 0;
+}
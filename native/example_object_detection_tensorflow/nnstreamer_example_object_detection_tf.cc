@@ -13,6 +13,38 @@
  * Before running this example, GST_PLUGIN_PATH should be updated for nnstreamer plug-in.
  * $ export GST_PLUGIN_PATH=$GST_PLUGIN_PATH:<nnstreamer plugin path>
  * $ ./nnstreamer_example_object_detection_tf
+ *
+ * The detector runs every Nth frame, and a tracker (see nns_ex_track_sched.h) predicts the boxes
+ * of the frames in between for the overlay. The stride is adapted to the motion of the objects,
+ * from --min-stride (objects moving fast, appearing or disappearing) to --max-stride (steady scene).
+ * $ ./nnstreamer_example_object_detection_tf --min-stride=1 --max-stride=6
+ * '--max-stride=1' runs the detector on every frame.
+ *
+ * The motion gate (see nns_ex_motion_gate.h) also drops the frames to the detector
+ * if the scene is not changed from the last frame detected, and the tracks are kept.
+ * '--gate' sets the ratio (in percent) of the changed area to run the detector, 0 to disable the gate.
+ *
+ * The QoS controller (see nns_ex_qos.h) handles the QoS messages of the sinks. When the frames are late
+ * under the load, it raises the stride of the detector, then lowers the camera framerate
+ * (capsfilter 'qos_caps', the model takes the fixed resolution), and restores them when the pipeline
+ * has the headroom.
+ * '--target-latency' sets the max lateness (in milliseconds) of the display, 0 to disable the controller.
+ *
+ * The result keeps the timestamp of the frame detected. For each frame drawn, the overlay measures
+ * the age of the result (timestamp of the frame - timestamp of the result), the delay from the result
+ * to the first frame showing it, and the latency from the capture to the overlay, printed at exit.
+ * '--burn-in' draws the frame counter, the timestamp and the age on the video, to measure
+ * the capture-to-display latency from the recordings (e.g., the camera and the display with a clock).
+ *
+ * '--batch=N' runs the model for N frames in a session call (input 3:640:480:N, see nns_ex_batch.h),
+ * to use the intra-op parallelism of TF on the multi-core servers. The element 'nns_ex_batch' pushes
+ * the batch when N frames arrive, or when the first frame has waited '--batch-latency' milliseconds
+ * (the empty slots are zero), and the outputs are split back per frame in order.
+ * The stride would leave the slots of the batches empty, so the detector runs on every frame
+ * (--min-stride and --max-stride are 1) with '--batch' 2 or more.
+ * The throughput and the latency from the batch to the result are printed at exit.
+ * $ ./nnstreamer_example_object_detection_tf --batch=4 --batch-latency=100
+ * nnstreamer_benchmark_batch measures the throughput vs latency for N=1..8 with the test sources.
  */
 
 #ifndef _GNU_SOURCE
@@ -36,6 +68,11 @@
 #include <cairo.h>
 #include <cairo-gobject.h>
 
+#include "nns_ex_batch.h"
+#include "nns_ex_motion_gate.h"
+#include "nns_ex_qos.h"
+#include "nns_ex_track_sched.h"
+
 /**
  * @brief Macro for debug mode.
  */
@@ -71,6 +108,47 @@
  */
 #define MAX_OBJECT_DETECTION 5
 
+/**
+ * @brief Default stride of the detector.
+ */
+#define DEFAULT_MIN_STRIDE 1
+#define DEFAULT_MAX_STRIDE 6
+
+/**
+ * @brief Parameters of the tracker.
+ */
+#define TRACKER_MAX_TRACKS 32
+#define TRACKER_IOU_THRESHOLD .3f
+#define TRACKER_MAX_MISSED 2
+
+/**
+ * @brief Parameters of the motion gate.
+ */
+#define GATE_CELL_THRESHOLD 12
+#define GATE_DEFAULT_AREA 1.0
+#define GATE_MAX_SKIP 30
+
+/**
+ * @brief Default max lateness (in milliseconds) of the display.
+ */
+#define QOS_DEFAULT_TARGET 100
+
+/**
+ * @brief Default batch of the detector, and max time (in milliseconds) to wait for the batch.
+ */
+#define DEFAULT_BATCH_SIZE 1
+#define DEFAULT_BATCH_LATENCY 50
+
+/**
+ * @brief Levels of the QoS controller, the stride of the detector first.
+ */
+static const nns_ex_qos_level_s qos_levels[] = {
+  {2, 0, 0, 0, 0},
+  {4, 0, 0, 0, 0},
+  {4, 0, 0, 15, 1},
+  {6, 0, 0, 10, 1},
+};
+
 typedef struct
 {
   gint x;
@@ -110,6 +188,17 @@ typedef struct
   TFModelInfo tf_info; /**< tf model info */
   CairoOverlayState overlay_state;
   std::vector<DetectedObject> detected_objects;
+  nns_ex_track_sched_s *track_sched; /**< stride of the detector and tracks between the detections */
+  gboolean burn_in; /**< true to draw the frame counter */
+  nns_ex_motion_gate_s *gate; /**< motion gate to skip the static frames */
+  nns_ex_qos_s *qos; /**< QoS controller */
+  guint batch_size; /**< count of the frames in a session call */
+  GstElement *batch; /**< element to collect the frames, NULL if batch_size is 1 */
+  nns_ex_latency_stats_s batch_latency; /**< time from the frame into the batch to the result */
+  guint frames_batched; /**< count of the frames detected in the batches */
+  gint64 first_batch_time; /**< monotonic time of the first result */
+  guint first_batch_frames; /**< count of the frames in the first result */
+  gint64 last_batch_time; /**< monotonic time of the last result */
 } AppData;
 
 /**
@@ -226,6 +315,26 @@ free_app_data (void)
 
   g_app.detected_objects.clear ();
 
+  if (g_app.track_sched) {
+    nns_ex_track_sched_free (g_app.track_sched);
+    g_app.track_sched = NULL;
+  }
+
+  if (g_app.gate) {
+    nns_ex_motion_gate_free (g_app.gate);
+    g_app.gate = NULL;
+  }
+
+  if (g_app.qos) {
+    nns_ex_qos_free (g_app.qos);
+    g_app.qos = NULL;
+  }
+
+  if (g_app.batch) {
+    gst_object_unref (g_app.batch);
+    g_app.batch = NULL;
+  }
+
   tf_free_info (&g_app.tf_info);
   g_mutex_clear (&g_app.mutex);
 }
@@ -260,7 +369,7 @@ parse_err_message (GstMessage * message)
 }
 
 /**
- * @brief Function to print qos message.
+ * @brief Function to print qos message, and adapt the pipeline to the load.
  */
 static void
 parse_qos_message (GstMessage * message)
@@ -272,6 +381,9 @@ parse_qos_message (GstMessage * message)
   gst_message_parse_qos_stats (message, &format, &processed, &dropped);
   _print_log ("format[%d] processed[%" G_GUINT64_FORMAT "] dropped[%"
       G_GUINT64_FORMAT "]", format, processed, dropped);
+
+  if (g_app.qos)
+    nns_ex_qos_handle_message (g_app.qos, message);
 }
 
 /**
@@ -351,6 +463,55 @@ get_detected_objects (
   g_mutex_unlock (&g_app.mutex);
 }
 
+/**
+ * @brief Update the tracker with the detected objects, and the stride of the detector.
+ */
+static void
+update_tracker (GstClockTime timestamp)
+{
+  std::vector<nns_ex_box_s> boxes;
+  std::vector<DetectedObject>::iterator iter;
+
+  g_mutex_lock (&g_app.mutex);
+
+  for (iter = g_app.detected_objects.begin ();
+      iter != g_app.detected_objects.end (); ++iter) {
+    nns_ex_box_s box;
+
+    box.x = iter->x;
+    box.y = iter->y;
+    box.width = iter->width;
+    box.height = iter->height;
+    box.class_id = iter->class_id;
+    box.prob = iter->prob;
+
+    boxes.push_back (box);
+  }
+
+  g_mutex_unlock (&g_app.mutex);
+
+  nns_ex_track_sched_update (g_app.track_sched,
+      boxes.empty () ? NULL : &boxes[0], boxes.size (), timestamp);
+}
+
+/**
+ * @brief Add the frame of the batch to the throughput and latency metrics.
+ */
+static void
+add_batch_frame (nns_ex_batch_info_s * info, guint i, gint64 now)
+{
+  g_app.frames_batched++;
+  nns_ex_latency_stats_add (&g_app.batch_latency,
+      (GstClockTime) (now - info->arrival[i]) * GST_USECOND);
+
+  /* the first result starts the measurement, its frames are not counted */
+  if (g_app.first_batch_time == 0) {
+    g_app.first_batch_time = now;
+    g_app.first_batch_frames = info->frames;
+  }
+  g_app.last_batch_time = now;
+}
+
 /**
  * @brief Callback for tensor sink signal.
  */
@@ -360,44 +521,66 @@ new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
   GstMemory *mem_num, *mem_classes, *mem_scores, *mem_boxes;
   GstMapInfo info_num, info_classes, info_scores, info_boxes;
   gfloat *num_detections, *detection_classes, *detection_scores, *detection_boxes;
+  nns_ex_batch_info_s batch;
+  guint i, n = g_app.batch_size;
+  gint64 now;
 
   g_return_if_fail (g_app.running);
 
   /**
-   * tensor type is float32.
-   * [0] dim of num_detections    > 1
-   * [1] dim of detection_classes > 1: 100
-   * [2] dim of detection_scores  > 1: 100
-   * [3] dim of detection_boxes   > 1: 100: 4 (top, left, bottom, right)
+   * tensor type is float32, N is the batch size.
+   * [0] dim of num_detections    > N
+   * [1] dim of detection_classes > N: 100
+   * [2] dim of detection_scores  > N: 100
+   * [3] dim of detection_boxes   > N: 100: 4 (top, left, bottom, right)
    */
   g_assert (gst_buffer_n_memory (buffer) == 4);
 
   /* num_detections */
   mem_num = gst_buffer_get_memory (buffer, 0);
   g_assert (gst_memory_map (mem_num, &info_num, GST_MAP_READ));
-  g_assert (info_num.size == 4);
+  g_assert (info_num.size == n * 4);
   num_detections = (gfloat *) info_num.data;
 
   /* detection_classes */
   mem_classes = gst_buffer_get_memory (buffer, 1);
   g_assert (gst_memory_map (mem_classes, &info_classes, GST_MAP_READ));
-  g_assert (info_classes.size == DETECTION_MAX * 4);
+  g_assert (info_classes.size == n * DETECTION_MAX * 4);
   detection_classes = (gfloat *) info_classes.data;
 
   /* detection_scores */
   mem_scores = gst_buffer_get_memory (buffer, 2);
   g_assert (gst_memory_map (mem_scores, &info_scores, GST_MAP_READ));
-  g_assert (info_scores.size == DETECTION_MAX * 4);
+  g_assert (info_scores.size == n * DETECTION_MAX * 4);
   detection_scores = (gfloat *) info_scores.data;
 
   /* detection_boxes */
   mem_boxes = gst_buffer_get_memory (buffer, 3);
   g_assert (gst_memory_map (mem_boxes, &info_boxes, GST_MAP_READ));
-  g_assert (info_boxes.size == DETECTION_MAX * BOX_SIZE * 4);
+  g_assert (info_boxes.size == n * DETECTION_MAX * BOX_SIZE * 4);
   detection_boxes = (gfloat *) info_boxes.data;
 
-  get_detected_objects (
-    num_detections, detection_classes, detection_scores, detection_boxes);
+  if (g_app.batch == NULL) {
+    get_detected_objects (
+      num_detections, detection_classes, detection_scores, detection_boxes);
+    update_tracker (GST_BUFFER_PTS (buffer));
+  } else if (nns_ex_batch_lookup (g_app.batch, GST_BUFFER_PTS (buffer),
+          &batch)) {
+    now = g_get_monotonic_time ();
+
+    /* the frames in order, the rest of the slots are padding */
+    for (i = 0; i < batch.frames; i++) {
+      get_detected_objects (num_detections + i,
+          detection_classes + i * DETECTION_MAX,
+          detection_scores + i * DETECTION_MAX,
+          detection_boxes + i * DETECTION_MAX * BOX_SIZE);
+      update_tracker (batch.pts[i]);
+      add_batch_frame (&batch, i, now);
+    }
+  } else {
+    _print_log ("unknown batch %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (GST_BUFFER_PTS (buffer)));
+  }
 
   gst_memory_unmap (mem_num, &info_num);
   gst_memory_unmap (mem_classes, &info_classes);
@@ -410,6 +593,25 @@ new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
   gst_memory_unref (mem_boxes);
 }
 
+/**
+ * @brief Pad probe on the detector branch, pass a frame every stride.
+ */
+static GstPadProbeReturn
+detector_probe_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  guint qos_stride = 0;
+
+  /* the QoS controller raises the stride under the load */
+  if (g_app.qos)
+    qos_stride = nns_ex_qos_get_stride (g_app.qos);
+
+  /* the tracker predicts the boxes of the skipped frames */
+  if (!nns_ex_track_sched_pass_frame (g_app.track_sched, buffer, qos_stride))
+    return GST_PAD_PROBE_DROP;
+  return GST_PAD_PROBE_OK;
+}
+
 /**
  * @brief Set window title.
  * @param name GstXImageSink element name
@@ -448,6 +650,29 @@ prepare_overlay_cb (GstElement * overlay, GstCaps * caps, gpointer user_data)
   state->valid = gst_video_info_from_caps (&state->vinfo, caps);
 }
 
+/**
+ * @brief Draw the frame counter, the timestamp and the age of the result.
+ */
+static void
+draw_burn_in (cairo_t * cr, GstClockTime timestamp, GstClockTime age)
+{
+  gchar *text;
+
+  text = nns_ex_track_sched_get_burn_in (g_app.track_sched, timestamp, age);
+
+  /* white text on black, readable in the recordings */
+  cairo_set_font_size (cr, 24.0);
+  cairo_rectangle (cr, 0, VIDEO_HEIGHT - 36, VIDEO_WIDTH, 36);
+  cairo_set_source_rgb (cr, 0, 0, 0);
+  cairo_fill (cr);
+
+  cairo_move_to (cr, 8, VIDEO_HEIGHT - 10);
+  cairo_set_source_rgb (cr, 1, 1, 1);
+  cairo_show_text (cr, text);
+
+  g_free (text);
+}
+
 /**
  * @brief Callback to draw the overlay.
  */
@@ -456,33 +681,41 @@ draw_overlay_cb (GstElement * overlay, cairo_t * cr, guint64 timestamp,
     guint64 duration, gpointer user_data)
 {
   CairoOverlayState *state = &g_app.overlay_state;
+  nns_ex_track_s tracks[MAX_OBJECT_DETECTION];
   gfloat x, y, width, height;
   gchar *label;
-  guint drawed = 0;
+  guint i, n;
+  GstClock *clock;
+  GstClockTime now = GST_CLOCK_TIME_NONE;
+  GstClockTime age;
 
   g_return_if_fail (state->valid);
   g_return_if_fail (g_app.running);
 
-  std::vector<DetectedObject> detected;
-  std::vector<DetectedObject>::iterator iter;
+  /* running time of this frame at the overlay */
+  clock = gst_element_get_clock (overlay);
+  if (clock) {
+    now = gst_clock_get_time (clock) - gst_element_get_base_time (overlay);
+    gst_object_unref (clock);
+  }
 
-  g_mutex_lock (&g_app.mutex);
-  detected = g_app.detected_objects;
-  g_mutex_unlock (&g_app.mutex);
+  /* boxes at the timestamp of this frame (max objects to draw), and the age of the result */
+  n = nns_ex_track_sched_predict_frame (g_app.track_sched, timestamp, now,
+      tracks, MAX_OBJECT_DETECTION, &age);
 
   /* set font props */
   cairo_select_font_face (cr, "Sans", CAIRO_FONT_SLANT_NORMAL,
       CAIRO_FONT_WEIGHT_BOLD);
   cairo_set_font_size (cr, 20.0);
 
-  for (iter = detected.begin (); iter != detected.end (); ++iter) {
-    label =
-        (gchar *) g_list_nth_data (g_app.tf_info.labels, iter->class_id);
+  for (i = 0; i < n; i++) {
+    label = (gchar *) g_list_nth_data (g_app.tf_info.labels,
+        tracks[i].box.class_id);
 
-    x = iter->x;
-    y = iter->y;
-    width = iter->width;
-    height = iter->height;
+    x = tracks[i].box.x;
+    y = tracks[i].box.y;
+    width = tracks[i].box.width;
+    height = tracks[i].box.height;
 
     /* draw rectangle */
     cairo_rectangle (cr, x, y, width, height);
@@ -500,12 +733,10 @@ draw_overlay_cb (GstElement * overlay, cairo_t * cr, guint64 timestamp,
     cairo_set_line_width (cr, .3);
     cairo_stroke (cr);
     cairo_fill_preserve (cr);
-
-    if (++drawed >= MAX_OBJECT_DETECTION) {
-      /* max objects drawed */
-      break;
-    }
   }
+
+  if (g_app.burn_in)
+    draw_burn_in (cr, timestamp, age);
 }
 
 /**
@@ -518,39 +749,134 @@ main (int argc, char ** argv)
 
   gchar *str_pipeline;
   GstElement *element;
+  GstElement *filter;
+  GstPad *pad;
+  gboolean attached;
+  gdouble gate_area = GATE_DEFAULT_AREA;
+  nns_ex_motion_gate_stats_s stats;
+  guint gate_skipped = 0;
+  gint min_stride = DEFAULT_MIN_STRIDE;
+  gint max_stride = DEFAULT_MAX_STRIDE;
+  gint target_latency = QOS_DEFAULT_TARGET;
+  gint batch_size = DEFAULT_BATCH_SIZE;
+  gint batch_latency = DEFAULT_BATCH_LATENCY;
+  gchar *str_batch;
+  nns_ex_batch_stats_s batch_stats;
+  gdouble elapsed;
+  gboolean burn_in = FALSE;
+  nns_ex_qos_stats_s qos_stats;
+  GOptionContext *optionctx;
+  GError *error = NULL;
+
+  const GOptionEntry main_entries[] = {
+    {"min-stride", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &min_stride,
+        "Min stride of the detector (moving objects)", "1"},
+    {"max-stride", 's', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &max_stride,
+        "Max stride of the detector (steady scene), 1 to run on every frame",
+        "6"},
+    {"gate", 'g', G_OPTION_FLAG_NONE, G_OPTION_ARG_DOUBLE, &gate_area,
+        "Changed area (percent) to run the detector, 0 to disable the gate",
+        "1.0"},
+    {"target-latency", 't', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &target_latency,
+        "Max lateness (ms) of the display, 0 to disable the QoS controller",
+        "100"},
+    {"burn-in", 'b', G_OPTION_FLAG_NONE, G_OPTION_ARG_NONE, &burn_in,
+        "Draw the frame counter and the timestamp to measure the latency", NULL},
+    {"batch", 'n', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &batch_size,
+        "Count of the frames in a session call of the model (1 ~ 8)", "1"},
+    {"batch-latency", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &batch_latency,
+        "Max time (ms) the first frame waits for the batch", "50"},
+    {NULL}
+  };
 
   _print_log ("start app..");
 
+  optionctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (optionctx, main_entries, NULL);
+
+  if (!g_option_context_parse (optionctx, &argc, &argv, &error)) {
+    g_printerr ("option parsing failed: %s\n", error->message);
+    g_error_free (error);
+    g_option_context_free (optionctx);
+    return -1;
+  }
+
+  g_option_context_free (optionctx);
+
+  if (min_stride <= 0 || max_stride < min_stride) {
+    g_printerr ("invalid stride, 1 <= min-stride <= max-stride\n");
+    return -1;
+  }
+
+  if (batch_size <= 0 || batch_size > NNS_EX_BATCH_MAX || batch_latency < 0) {
+    g_printerr ("invalid batch, 1 <= batch <= %d\n", NNS_EX_BATCH_MAX);
+    return -1;
+  }
+
+  /* the frames dropped by the stride would be the padding of the batches */
+  if (batch_size > 1 && max_stride > 1) {
+    g_print ("batch %d : the detector runs on every frame (stride 1)\n",
+        batch_size);
+    min_stride = max_stride = 1;
+  }
+
   /* init app variable */
   g_app.running = FALSE;
   g_app.loop = NULL;
   g_app.bus = NULL;
   g_app.pipeline = NULL;
   g_app.detected_objects.clear ();
+  g_app.track_sched = NULL;
+  g_app.burn_in = burn_in;
+  g_app.gate = NULL;
+  g_app.qos = NULL;
+  g_app.batch_size = (guint) batch_size;
+  g_app.batch = NULL;
+  memset (&g_app.batch_latency, 0, sizeof (nns_ex_latency_stats_s));
+  g_app.frames_batched = 0;
+  g_app.first_batch_time = g_app.last_batch_time = 0;
+  g_app.first_batch_frames = 0;
   g_mutex_init (&g_app.mutex);
 
+  g_app.track_sched = nns_ex_track_sched_new ((guint) min_stride,
+      (guint) max_stride, TRACKER_MAX_TRACKS, TRACKER_IOU_THRESHOLD,
+      TRACKER_MAX_MISSED);
+  _check_cond_err (g_app.track_sched != NULL);
+
   _check_cond_err (tf_init_info (&g_app.tf_info, tf_model_path));
 
   /* init gstreamer */
   gst_init (&argc, &argv);
+  _check_cond_err (nns_ex_batch_register ());
 
   /* main loop */
   g_app.loop = g_main_loop_new (NULL, FALSE);
   _check_cond_err (g_app.loop != NULL);
 
+  /* collect the frames for the batch */
+  if (g_app.batch_size > 1)
+    str_batch = g_strdup_printf ("nns_ex_batch name=batch batch-size=%u "
+        "max-latency=%d ! ", g_app.batch_size, batch_latency);
+  else
+    str_batch = g_strdup ("");
+
   /* init pipeline */
   str_pipeline =
       g_strdup_printf
-      ("v4l2src name=src ! videoconvert ! videoscale ! video/x-raw,width=%d,height=%d,format=RGB ! tee name=t_raw "
+      ("v4l2src name=src ! videorate drop-only=true ! videoconvert ! videoscale ! "
+      "capsfilter name=qos_caps caps=\"video/x-raw,width=%d,height=%d,format=RGB\" ! tee name=t_raw "
       "t_raw. ! queue ! videoconvert ! cairooverlay name=tensor_res ! ximagesink name=img_tensor "
-      "t_raw. ! queue leaky=2 max-size-buffers=2 ! videoscale ! tensor_converter ! "
-      "tensor_filter framework=tensorflow model=%s "
-      "input=3:640:480:1 inputname=image_tensor inputtype=uint8 "
-      "output=1:1:1:1,100:1:1:1,100:1:1:1,4:100:1:1 "
+      "t_raw. ! queue leaky=2 max-size-buffers=%u ! videoscale ! tensor_converter name=tensor_conv ! "
+      "%stensor_filter name=tensor_filter framework=tensorflow model=%s "
+      "input=3:640:480:%u inputname=image_tensor inputtype=uint8 "
+      "output=%u:1:1:1,100:%u:1:1,100:%u:1:1,4:100:%u:1 "
       "outputname=num_detections,detection_classes,detection_scores,detection_boxes "
       "outputtype=float32,float32,float32,float32 ! "
       "tensor_sink name=tensor_sink ",
-      VIDEO_WIDTH, VIDEO_HEIGHT, g_app.tf_info.model_path);
+      VIDEO_WIDTH, VIDEO_HEIGHT, MAX (2U, g_app.batch_size), str_batch,
+      g_app.tf_info.model_path, g_app.batch_size, g_app.batch_size,
+      g_app.batch_size, g_app.batch_size, g_app.batch_size);
+  g_free (str_batch);
 
   _print_log ("%s\n", str_pipeline);
 
@@ -558,6 +884,11 @@ main (int argc, char ** argv)
   g_free (str_pipeline);
   _check_cond_err (g_app.pipeline != NULL);
 
+  if (g_app.batch_size > 1) {
+    g_app.batch = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "batch");
+    _check_cond_err (g_app.batch != NULL);
+  }
+
   /* bus and message callback */
   g_app.bus = gst_element_get_bus (g_app.pipeline);
   _check_cond_err (g_app.bus != NULL);
@@ -570,6 +901,42 @@ main (int argc, char ** argv)
   g_signal_connect (element, "new-data", G_CALLBACK (new_data_cb), NULL);
   gst_object_unref (element);
 
+  /* run the detector every stride */
+  element = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "tensor_conv");
+  pad = gst_element_get_static_pad (element, "sink");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, detector_probe_cb, NULL,
+      NULL);
+  gst_object_unref (pad);
+  gst_object_unref (element);
+
+  /* the probe of the detector reads the stride of the controller */
+  if (target_latency > 0) {
+    g_app.qos = nns_ex_qos_new (target_latency * GST_MSECOND, qos_levels,
+        G_N_ELEMENTS (qos_levels));
+    _check_cond_err (g_app.qos != NULL);
+
+    filter = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "qos_caps");
+    attached = nns_ex_qos_attach (g_app.qos, filter, NULL);
+    gst_object_unref (filter);
+    _check_cond_err (attached);
+  }
+
+  /* skip the static frames, checked only if the stride passes the frame */
+  if (gate_area > 0.0) {
+    g_app.gate = nns_ex_motion_gate_new (GATE_CELL_THRESHOLD,
+        (gfloat) (gate_area / 100.0), GATE_MAX_SKIP);
+
+    /* tensor_filter runs in the thread of the batch, not measured */
+    element = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "tensor_conv");
+    filter = g_app.batch ? NULL :
+        gst_bin_get_by_name (GST_BIN (g_app.pipeline), "tensor_filter");
+    attached = nns_ex_motion_gate_attach (g_app.gate, element, filter);
+    gst_object_unref (element);
+    if (filter)
+      gst_object_unref (filter);
+    _check_cond_err (attached);
+  }
+
   /* cairo overlay */
   element = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "tensor_res");
   g_signal_connect (element, "draw", G_CALLBACK (draw_overlay_cb), NULL);
@@ -604,6 +971,48 @@ main (int argc, char ** argv)
   g_usleep (200 * 1000);
   gst_object_unref (element);
 
+  if (g_app.gate) {
+    nns_ex_motion_gate_get_stats (g_app.gate, &stats);
+
+    /* the gate checks the frames passed by the stride */
+    gate_skipped = stats.skipped;
+
+    g_print ("motion gate : skipped %u of %u inferences (%.1f%%), "
+        "gate %.1f us/frame, estimated CPU time saved %.1f ms\n",
+        stats.skipped, stats.frames,
+        stats.frames ? 100.0 * stats.skipped / stats.frames : 0.0,
+        stats.frames ? (gdouble) stats.gate_time / stats.frames : 0.0,
+        stats.saved_time / 1000.0);
+  }
+
+  nns_ex_track_sched_print_stats (g_app.track_sched, gate_skipped);
+
+  if (g_app.batch) {
+    nns_ex_batch_get_stats (g_app.batch, &batch_stats);
+    elapsed = (g_app.last_batch_time - g_app.first_batch_time) / 1000000.0;
+
+    g_print ("batch %u : %" G_GUINT64_FORMAT " batches, %.2f frames/batch, "
+        "%.1f%% padded, %" G_GUINT64_FORMAT " pushed by the latency budget\n",
+        g_app.batch_size, batch_stats.batches,
+        batch_stats.batches ? (gdouble) batch_stats.frames / batch_stats.batches : 0.0,
+        batch_stats.batches ?
+            100.0 * batch_stats.padded / (batch_stats.batches * g_app.batch_size) : 0.0,
+        batch_stats.timeouts);
+    g_print ("batch %u : %.1f frames/s\n", g_app.batch_size,
+        (elapsed > 0.0) ?
+            (g_app.frames_batched - g_app.first_batch_frames) / elapsed : 0.0);
+    nns_ex_latency_stats_print ("frame to result", &g_app.batch_latency);
+  }
+
+  if (g_app.qos) {
+    nns_ex_qos_get_stats (g_app.qos, &qos_stats);
+    g_print ("qos : level %u (lowest %u), %u steps down, %u steps up, "
+        "%u late frames (max %.1f ms)\n",
+        qos_stats.level, qos_stats.max_level, qos_stats.degraded,
+        qos_stats.recovered, qos_stats.messages,
+        (gdouble) qos_stats.max_jitter / GST_MSECOND);
+  }
+
 error:
   _print_log ("close app..");
 
@@ -16,6 +16,37 @@
  *
  * Required model and resources are stored at below link
  * https://github.com/nnsuite/testcases/tree/master/DeepLearningModels/tensorflow-lite/ssd_mobilenet_v2_coco
+ *
+ * tensor_sink only enqueues the output buffers into a ring (see nns_ex_tensor_ring.h),
+ * and a worker thread drains the ring and decodes the latest output.
+ *
+ * 'nns_ex_tensorize' converts the camera frames to the normalized float32 tensor in a single pass
+ * (see nns_ex_tensorize.h), instead of 'videoscale ! tensor_converter ! tensor_transform'.
+ *
+ * The detector runs every Nth frame, and a tracker (see nns_ex_track_sched.h) predicts the boxes
+ * of the frames in between for the overlay. The stride is adapted to the motion of the objects,
+ * from --min-stride (objects moving fast, appearing or disappearing) to --max-stride (steady scene).
+ * $ ./nnstreamer_example_object_detection_tflite --min-stride=1 --max-stride=6
+ * '--max-stride=1' runs the detector on every frame.
+ *
+ * The motion gate (see nns_ex_motion_gate.h) also drops the frames to the detector
+ * if the scene is not changed from the last frame detected, and the tracks are kept.
+ * '--gate' sets the ratio (in percent) of the changed area to run the detector, 0 to disable the gate.
+ *
+ * The QoS controller (see nns_ex_qos.h) handles the QoS messages of the sinks. When the frames are late
+ * under the load, it raises the stride of the detector, then lowers the camera resolution and framerate
+ * (capsfilter 'qos_caps'), and restores them when the pipeline has the headroom.
+ * '--target-latency' sets the max lateness (in milliseconds) of the display, 0 to disable the controller.
+ *
+ * The result keeps the timestamp of the frame detected. For each frame drawn, the overlay measures
+ * the age of the result (timestamp of the frame - timestamp of the result), the delay from the result
+ * to the first frame showing it, and the latency from the capture to the overlay, printed at exit.
+ * '--burn-in' draws the frame counter, the timestamp and the age on the video, to measure
+ * the capture-to-display latency from the recordings (e.g., the camera and the display with a clock).
+ *
+ * With the tracks, the detector runs on the region around the objects (see nns_ex_roi.h),
+ * cropped from the camera frame, and the full frame is scanned every Nth detection to find the new objects.
+ * '--roi-refresh' sets the interval of the full frame scan, 0 to run the detector on the full frame always.
  */
 
 #ifndef _GNU_SOURCE
@@ -39,6 +70,13 @@
 #include <cairo.h>
 #include <cairo-gobject.h>
 
+#include "nns_ex_motion_gate.h"
+#include "nns_ex_qos.h"
+#include "nns_ex_roi.h"
+#include "nns_ex_tensor_ring.h"
+#include "nns_ex_tensorize.h"
+#include "nns_ex_track_sched.h"
+
 /**
  * @brief Macro for debug mode.
  */
@@ -81,6 +119,58 @@
  */
 #define MAX_OBJECT_DETECTION 5
 
+/**
+ * @brief Max number of output buffers queued for the worker.
+ */
+#define TENSOR_RING_SIZE 4
+
+/**
+ * @brief Time (in microseconds) the worker waits for new output.
+ */
+#define TENSOR_WAIT_TIMEOUT (100 * G_TIME_SPAN_MILLISECOND)
+
+/**
+ * @brief Default stride of the detector.
+ */
+#define DEFAULT_MIN_STRIDE 1
+#define DEFAULT_MAX_STRIDE 6
+
+/**
+ * @brief Parameters of the tracker.
+ */
+#define TRACKER_MAX_TRACKS 32
+#define TRACKER_IOU_THRESHOLD .3f
+#define TRACKER_MAX_MISSED 2
+
+/**
+ * @brief Parameters of the motion gate.
+ */
+#define GATE_CELL_THRESHOLD 12
+#define GATE_DEFAULT_AREA 1.0
+#define GATE_MAX_SKIP 30
+
+/**
+ * @brief Default max lateness (in milliseconds) of the display.
+ */
+#define QOS_DEFAULT_TARGET 100
+
+/**
+ * @brief Levels of the QoS controller, the stride of the detector first.
+ */
+static const nns_ex_qos_level_s qos_levels[] = {
+  {2, 0, 0, 0, 0},
+  {4, 0, 0, 0, 0},
+  {4, 320, 240, 0, 0},
+  {4, 320, 240, 15, 1},
+};
+
+/**
+ * @brief Parameters of the region of interest.
+ */
+#define ROI_DEFAULT_REFRESH 8
+#define ROI_MIN_SIZE .3f
+#define ROI_MARGIN .25f
+
 typedef struct
 {
   gint x;
@@ -119,9 +209,17 @@ typedef struct
   GstBus *bus; /**< gst bus for data pipeline */
   gboolean running; /**< true when app is running */
   GMutex mutex; /**< mutex for processing */
+  nns_ex_tensor_ring_s *ring; /**< output buffers from tensor sink */
+  GThread *worker; /**< thread to process the output buffers */
   TFLiteModelInfo tflite_info; /**< tflite model info */
   CairoOverlayState overlay_state;
   std::vector<DetectedObject> detected_objects;
+  nns_ex_track_sched_s *track_sched; /**< stride of the detector and tracks between the detections */
+  gboolean burn_in; /**< true to draw the frame counter */
+  nns_ex_motion_gate_s *gate; /**< motion gate to skip the static frames */
+  nns_ex_qos_s *qos; /**< QoS controller */
+  nns_ex_roi_scheduler_s *roi; /**< scheduler of the region to detect */
+  nns_ex_roi_s last_roi; /**< region given to the detector last */
 } AppData;
 
 /**
@@ -286,6 +384,17 @@ free_app_data (void)
     g_app.bus = NULL;
   }
 
+  if (g_app.worker) {
+    nns_ex_tensor_ring_set_flushing (g_app.ring, TRUE);
+    g_thread_join (g_app.worker);
+    g_app.worker = NULL;
+  }
+
+  if (g_app.ring) {
+    nns_ex_tensor_ring_free (g_app.ring);
+    g_app.ring = NULL;
+  }
+
   if (g_app.pipeline) {
     gst_object_unref (g_app.pipeline);
     g_app.pipeline = NULL;
@@ -293,6 +402,26 @@ free_app_data (void)
 
   g_app.detected_objects.clear ();
 
+  if (g_app.track_sched) {
+    nns_ex_track_sched_free (g_app.track_sched);
+    g_app.track_sched = NULL;
+  }
+
+  if (g_app.gate) {
+    nns_ex_motion_gate_free (g_app.gate);
+    g_app.gate = NULL;
+  }
+
+  if (g_app.qos) {
+    nns_ex_qos_free (g_app.qos);
+    g_app.qos = NULL;
+  }
+
+  if (g_app.roi) {
+    nns_ex_roi_scheduler_free (g_app.roi);
+    g_app.roi = NULL;
+  }
+
   tflite_free_info (&g_app.tflite_info);
   g_mutex_clear (&g_app.mutex);
 }
@@ -327,7 +456,7 @@ parse_err_message (GstMessage * message)
 }
 
 /**
- * @brief Function to print qos message.
+ * @brief Function to print qos message, and adapt the pipeline to the load.
  */
 static void
 parse_qos_message (GstMessage * message)
@@ -339,6 +468,9 @@ parse_qos_message (GstMessage * message)
   gst_message_parse_qos_stats (message, &format, &processed, &dropped);
   _print_log ("format[%d] processed[%" G_GUINT64_FORMAT "] dropped[%"
       G_GUINT64_FORMAT "]", format, processed, dropped);
+
+  if (g_app.qos)
+    nns_ex_qos_handle_message (g_app.qos, message);
 }
 
 /**
@@ -459,9 +591,11 @@ nms (std::vector<DetectedObject> &detected)
 
 /**
  * @brief Get detected objects.
+ * @param roi region of the frame given to the detector, the boxes are mapped to the frame
  */
 static void
-get_detected_objects (gfloat * detections, gfloat * boxes)
+get_detected_objects (gfloat * detections, gfloat * boxes,
+    const nns_ex_roi_s * roi)
 {
   const float threshold_score = .5f;
   std::vector<DetectedObject> detected;
@@ -483,10 +617,10 @@ get_detected_objects (gfloat * detections, gfloat * boxes)
     float ymax = ycenter + h / 2.f;
     float xmax = xcenter + w / 2.f;
 
-    int x = xmin * MODEL_WIDTH;
-    int y = ymin * MODEL_HEIGHT;
-    int width = (xmax - xmin) * MODEL_WIDTH;
-    int height = (ymax - ymin) * MODEL_HEIGHT;
+    int x = (roi->x + xmin * roi->width) * VIDEO_WIDTH;
+    int y = (roi->y + ymin * roi->height) * VIDEO_HEIGHT;
+    int width = (xmax - xmin) * roi->width * VIDEO_WIDTH;
+    int height = (ymax - ymin) * roi->height * VIDEO_HEIGHT;
 
     for (int c = 1; c < LABEL_SIZE; c++) {
       gfloat score = _expit (detections[c]);
@@ -519,14 +653,46 @@ get_detected_objects (gfloat * detections, gfloat * boxes)
 }
 
 /**
- * @brief Callback for tensor sink signal.
+ * @brief Update the tracker with the detected objects, and the stride of the detector.
+ */
+static void
+update_tracker (GstClockTime timestamp)
+{
+  std::vector<nns_ex_box_s> boxes;
+  std::vector<DetectedObject>::iterator iter;
+
+  g_mutex_lock (&g_app.mutex);
+
+  for (iter = g_app.detected_objects.begin ();
+      iter != g_app.detected_objects.end (); ++iter) {
+    nns_ex_box_s box;
+
+    box.x = iter->x;
+    box.y = iter->y;
+    box.width = iter->width;
+    box.height = iter->height;
+    box.class_id = iter->class_id;
+    box.prob = iter->prob;
+
+    boxes.push_back (box);
+  }
+
+  g_mutex_unlock (&g_app.mutex);
+
+  nns_ex_track_sched_update (g_app.track_sched,
+      boxes.empty () ? NULL : &boxes[0], boxes.size (), timestamp);
+}
+
+/**
+ * @brief Process the output buffer of tensor filter.
  */
 static void
-new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
+process_output (GstBuffer * buffer)
 {
   GstMemory *mem_boxes, *mem_detections;
   GstMapInfo info_boxes, info_detections;
   gfloat *boxes, *detections;
+  nns_ex_roi_s roi;
 
   g_return_if_fail (g_app.running);
 
@@ -549,7 +715,16 @@ new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
   g_assert (info_detections.size == LABEL_SIZE * DETECTION_MAX * 4);
   detections = (gfloat *) info_detections.data;
 
-  get_detected_objects (detections, boxes);
+  /* the full frame if the region is not used */
+  if (g_app.roi) {
+    nns_ex_roi_scheduler_lookup (g_app.roi, GST_BUFFER_PTS (buffer), &roi);
+  } else {
+    roi.x = roi.y = 0.0f;
+    roi.width = roi.height = 1.0f;
+  }
+
+  get_detected_objects (detections, boxes, &roi);
+  update_tracker (GST_BUFFER_PTS (buffer));
 
   gst_memory_unmap (mem_boxes, &info_boxes);
   gst_memory_unmap (mem_detections, &info_detections);
@@ -558,6 +733,96 @@ new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
   gst_memory_unref (mem_detections);
 }
 
+/**
+ * @brief Worker thread to drain the output buffers from tensor sink.
+ */
+static gpointer
+tensor_worker_func (gpointer user_data)
+{
+  GstBuffer *buffers[TENSOR_RING_SIZE];
+  guint i, n;
+
+  while (!nns_ex_tensor_ring_is_flushing (g_app.ring)) {
+    n = nns_ex_tensor_ring_pop_batch (g_app.ring, buffers, TENSOR_RING_SIZE,
+        TENSOR_WAIT_TIMEOUT);
+    if (n == 0)
+      continue;
+
+    /* the overlay shows the latest result only, skip the stale outputs */
+    process_output (buffers[n - 1]);
+
+    for (i = 0; i < n; i++)
+      gst_buffer_unref (buffers[i]);
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief Select the region to detect around the tracks, and set it to the element converting the frame.
+ */
+static void
+set_detector_roi (GstElement * tensorize, GstClockTime timestamp)
+{
+  nns_ex_track_s tracks[TRACKER_MAX_TRACKS];
+  nns_ex_box_s boxes[TRACKER_MAX_TRACKS];
+  nns_ex_roi_s roi;
+  gchar x[G_ASCII_DTOSTR_BUF_SIZE], y[G_ASCII_DTOSTR_BUF_SIZE];
+  gchar w[G_ASCII_DTOSTR_BUF_SIZE], h[G_ASCII_DTOSTR_BUF_SIZE];
+  gchar *crop;
+  guint i, n;
+
+  n = nns_ex_track_sched_predict (g_app.track_sched, timestamp, tracks,
+      TRACKER_MAX_TRACKS);
+
+  for (i = 0; i < n; i++) {
+    boxes[i] = tracks[i].box;
+    boxes[i].x /= VIDEO_WIDTH;
+    boxes[i].y /= VIDEO_HEIGHT;
+    boxes[i].width /= VIDEO_WIDTH;
+    boxes[i].height /= VIDEO_HEIGHT;
+  }
+
+  nns_ex_roi_scheduler_next (g_app.roi, boxes, n, timestamp, &roi);
+
+  /* the element rebuilds the converter if the region is changed */
+  if (memcmp (&roi, &g_app.last_roi, sizeof (roi)) == 0)
+    return;
+
+  g_app.last_roi = roi;
+
+  crop = g_strdup_printf ("%s,%s,%s,%s",
+      g_ascii_formatd (x, sizeof (x), "%.4f", roi.x),
+      g_ascii_formatd (y, sizeof (y), "%.4f", roi.y),
+      g_ascii_formatd (w, sizeof (w), "%.4f", roi.width),
+      g_ascii_formatd (h, sizeof (h), "%.4f", roi.height));
+  g_object_set (tensorize, "crop", crop, NULL);
+  g_free (crop);
+}
+
+/**
+ * @brief Pad probe on the detector branch, pass a frame every stride.
+ */
+static GstPadProbeReturn
+detector_probe_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  guint qos_stride = 0;
+
+  /* the QoS controller raises the stride under the load */
+  if (g_app.qos)
+    qos_stride = nns_ex_qos_get_stride (g_app.qos);
+
+  /* the tracker predicts the boxes of the skipped frames */
+  if (!nns_ex_track_sched_pass_frame (g_app.track_sched, buffer, qos_stride))
+    return GST_PAD_PROBE_DROP;
+
+  if (g_app.roi)
+    set_detector_roi (GST_ELEMENT (user_data), GST_BUFFER_PTS (buffer));
+
+  return GST_PAD_PROBE_OK;
+}
+
 /**
  * @brief Set window title.
  * @param name GstXImageSink element name
@@ -596,6 +861,29 @@ prepare_overlay_cb (GstElement * overlay, GstCaps * caps, gpointer user_data)
   state->valid = gst_video_info_from_caps (&state->vinfo, caps);
 }
 
+/**
+ * @brief Draw the frame counter, the timestamp and the age of the result.
+ */
+static void
+draw_burn_in (cairo_t * cr, GstClockTime timestamp, GstClockTime age)
+{
+  gchar *text;
+
+  text = nns_ex_track_sched_get_burn_in (g_app.track_sched, timestamp, age);
+
+  /* white text on black, readable in the recordings */
+  cairo_set_font_size (cr, 24.0);
+  cairo_rectangle (cr, 0, VIDEO_HEIGHT - 36, VIDEO_WIDTH, 36);
+  cairo_set_source_rgb (cr, 0, 0, 0);
+  cairo_fill (cr);
+
+  cairo_move_to (cr, 8, VIDEO_HEIGHT - 10);
+  cairo_set_source_rgb (cr, 1, 1, 1);
+  cairo_show_text (cr, text);
+
+  g_free (text);
+}
+
 /**
  * @brief Callback to draw the overlay.
  */
@@ -604,33 +892,41 @@ draw_overlay_cb (GstElement * overlay, cairo_t * cr, guint64 timestamp,
     guint64 duration, gpointer user_data)
 {
   CairoOverlayState *state = &g_app.overlay_state;
+  nns_ex_track_s tracks[MAX_OBJECT_DETECTION];
   gfloat x, y, width, height;
   gchar *label;
-  guint drawed = 0;
+  guint i, n;
+  GstClock *clock;
+  GstClockTime now = GST_CLOCK_TIME_NONE;
+  GstClockTime age;
 
   g_return_if_fail (state->valid);
   g_return_if_fail (g_app.running);
 
-  std::vector<DetectedObject> detected;
-  std::vector<DetectedObject>::iterator iter;
+  /* running time of this frame at the overlay */
+  clock = gst_element_get_clock (overlay);
+  if (clock) {
+    now = gst_clock_get_time (clock) - gst_element_get_base_time (overlay);
+    gst_object_unref (clock);
+  }
 
-  g_mutex_lock (&g_app.mutex);
-  detected = g_app.detected_objects;
-  g_mutex_unlock (&g_app.mutex);
+  /* boxes at the timestamp of this frame (max objects to draw), and the age of the result */
+  n = nns_ex_track_sched_predict_frame (g_app.track_sched, timestamp, now,
+      tracks, MAX_OBJECT_DETECTION, &age);
 
   /* set font props */
   cairo_select_font_face (cr, "Sans", CAIRO_FONT_SLANT_NORMAL,
       CAIRO_FONT_WEIGHT_BOLD);
   cairo_set_font_size (cr, 20.0);
 
-  for (iter = detected.begin (); iter != detected.end (); ++iter) {
-    label =
-        (gchar *) g_list_nth_data (g_app.tflite_info.labels, iter->class_id);
+  for (i = 0; i < n; i++) {
+    label = (gchar *) g_list_nth_data (g_app.tflite_info.labels,
+        tracks[i].box.class_id);
 
-    x = iter->x * VIDEO_WIDTH / MODEL_WIDTH;
-    y = iter->y * VIDEO_HEIGHT / MODEL_HEIGHT;
-    width = iter->width * VIDEO_WIDTH / MODEL_WIDTH;
-    height = iter->height * VIDEO_HEIGHT / MODEL_HEIGHT;
+    x = tracks[i].box.x;
+    y = tracks[i].box.y;
+    width = tracks[i].box.width;
+    height = tracks[i].box.height;
 
     /* draw rectangle */
     cairo_rectangle (cr, x, y, width, height);
@@ -648,12 +944,10 @@ draw_overlay_cb (GstElement * overlay, cairo_t * cr, guint64 timestamp,
     cairo_set_line_width (cr, .3);
     cairo_stroke (cr);
     cairo_fill_preserve (cr);
-
-    if (++drawed >= MAX_OBJECT_DETECTION) {
-      /* max objects drawed */
-      break;
-    }
   }
+
+  if (g_app.burn_in)
+    draw_burn_in (cr, timestamp, age);
 }
 
 /**
@@ -666,21 +960,99 @@ main (int argc, char ** argv)
 
   gchar *str_pipeline;
   GstElement *element;
+  GstElement *filter;
+  GstPad *pad;
+  gboolean attached;
+  gdouble gate_area = GATE_DEFAULT_AREA;
+  nns_ex_motion_gate_stats_s stats;
+  guint gate_skipped = 0;
+  gint min_stride = DEFAULT_MIN_STRIDE;
+  gint max_stride = DEFAULT_MAX_STRIDE;
+  gint target_latency = QOS_DEFAULT_TARGET;
+  gboolean burn_in = FALSE;
+  nns_ex_qos_stats_s qos_stats;
+  gint roi_refresh = ROI_DEFAULT_REFRESH;
+  guint roi_cropped, roi_full;
+  GOptionContext *optionctx;
+  GError *error = NULL;
+
+  const GOptionEntry main_entries[] = {
+    {"min-stride", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &min_stride,
+        "Min stride of the detector (moving objects)", "1"},
+    {"max-stride", 's', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &max_stride,
+        "Max stride of the detector (steady scene), 1 to run on every frame",
+        "6"},
+    {"gate", 'g', G_OPTION_FLAG_NONE, G_OPTION_ARG_DOUBLE, &gate_area,
+        "Changed area (percent) to run the detector, 0 to disable the gate",
+        "1.0"},
+    {"target-latency", 't', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &target_latency,
+        "Max lateness (ms) of the display, 0 to disable the QoS controller",
+        "100"},
+    {"burn-in", 'b', G_OPTION_FLAG_NONE, G_OPTION_ARG_NONE, &burn_in,
+        "Draw the frame counter and the timestamp to measure the latency", NULL},
+    {"roi-refresh", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &roi_refresh,
+        "Scan the full frame every Nth detection, 0 to disable the region of interest",
+        "8"},
+    {NULL}
+  };
 
   _print_log ("start app..");
 
+  optionctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (optionctx, main_entries, NULL);
+
+  if (!g_option_context_parse (optionctx, &argc, &argv, &error)) {
+    g_printerr ("option parsing failed: %s\n", error->message);
+    g_error_free (error);
+    g_option_context_free (optionctx);
+    return -1;
+  }
+
+  g_option_context_free (optionctx);
+
+  if (min_stride <= 0 || max_stride < min_stride) {
+    g_printerr ("invalid stride, 1 <= min-stride <= max-stride\n");
+    return -1;
+  }
+
+  if (roi_refresh < 0) {
+    g_printerr ("invalid roi-refresh, 0 or greater\n");
+    return -1;
+  }
+
   /* init app variable */
   g_app.running = FALSE;
   g_app.loop = NULL;
   g_app.bus = NULL;
   g_app.pipeline = NULL;
+  g_app.ring = NULL;
+  g_app.worker = NULL;
   g_app.detected_objects.clear ();
+  g_app.track_sched = NULL;
+  g_app.burn_in = burn_in;
+  g_app.gate = NULL;
+  g_app.qos = NULL;
+  g_app.roi = NULL;
+  g_app.last_roi.x = g_app.last_roi.y = 0.0f;
+  g_app.last_roi.width = g_app.last_roi.height = 1.0f;
   g_mutex_init (&g_app.mutex);
 
+  g_app.track_sched = nns_ex_track_sched_new ((guint) min_stride,
+      (guint) max_stride, TRACKER_MAX_TRACKS, TRACKER_IOU_THRESHOLD,
+      TRACKER_MAX_MISSED);
+  _check_cond_err (g_app.track_sched != NULL);
+
+  if (roi_refresh > 0) {
+    g_app.roi = nns_ex_roi_scheduler_new (ROI_MIN_SIZE, ROI_MARGIN,
+        (guint) roi_refresh);
+    _check_cond_err (g_app.roi != NULL);
+  }
+
   _check_cond_err (tflite_init_info (&g_app.tflite_info, tflite_model_path));
 
   /* init gstreamer */
   gst_init (&argc, &argv);
+  _check_cond_err (nns_ex_tensorize_register ());
 
   /* main loop */
   g_app.loop = g_main_loop_new (NULL, FALSE);
@@ -689,12 +1061,13 @@ main (int argc, char ** argv)
   /* init pipeline */
   str_pipeline =
       g_strdup_printf
-      ("v4l2src name=src ! videoconvert ! videoscale ! "
-      "video/x-raw,width=%d,height=%d,format=RGB ! tee name=t_raw "
-      "t_raw. ! queue ! videoconvert ! cairooverlay name=tensor_res ! ximagesink name=img_tensor "
-      "t_raw. ! queue leaky=2 max-size-buffers=2 ! videoscale ! video/x-raw,width=%d,height=%d ! tensor_converter ! "
-      "tensor_transform mode=arithmetic option=typecast:float32,add:-127.5,div:127.5 ! "
-      "tensor_filter framework=tensorflow-lite model=%s ! "
+      ("v4l2src name=src ! videorate drop-only=true ! videoscale ! "
+      "capsfilter name=qos_caps ! tee name=t_raw "
+      "t_raw. ! queue ! videoscale ! video/x-raw,width=%d,height=%d ! "
+      "videoconvert ! cairooverlay name=tensor_res ! ximagesink name=img_tensor "
+      "t_raw. ! queue leaky=2 max-size-buffers=2 ! "
+      "nns_ex_tensorize name=tensorize width=%d height=%d type=float32 normalize=mean:127.5,std:127.5 ! "
+      "tensor_filter name=tensor_filter framework=tensorflow-lite model=%s ! "
       "tensor_sink name=tensor_sink",
       VIDEO_WIDTH, VIDEO_HEIGHT, MODEL_WIDTH, MODEL_HEIGHT,
       g_app.tflite_info.model_path);
@@ -712,11 +1085,51 @@ main (int argc, char ** argv)
   gst_bus_add_signal_watch (g_app.bus);
   g_signal_connect (g_app.bus, "message", G_CALLBACK (bus_message_cb), NULL);
 
-  /* tensor sink signal : new data callback */
+  /* tensor sink enqueues the output, the worker drains it */
+  g_app.ring = nns_ex_tensor_ring_new (TENSOR_RING_SIZE,
+      NNS_EX_TENSOR_RING_DROP_OLDEST);
+  _check_cond_err (g_app.ring != NULL);
+
   element = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "tensor_sink");
-  g_signal_connect (element, "new-data", G_CALLBACK (new_data_cb), NULL);
+  attached = nns_ex_tensor_ring_attach (g_app.ring, element);
+  gst_object_unref (element);
+  _check_cond_err (attached);
+
+  g_app.worker = g_thread_new ("tensor_worker", tensor_worker_func, NULL);
+
+  /* run the detector every stride, the probe sets the region to the element (the pipeline holds it) */
+  element = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "tensorize");
+  pad = gst_element_get_static_pad (element, "sink");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, detector_probe_cb,
+      element, NULL);
+  gst_object_unref (pad);
   gst_object_unref (element);
 
+  /* the probe of the detector reads the stride of the controller */
+  if (target_latency > 0) {
+    g_app.qos = nns_ex_qos_new (target_latency * GST_MSECOND, qos_levels,
+        G_N_ELEMENTS (qos_levels));
+    _check_cond_err (g_app.qos != NULL);
+
+    filter = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "qos_caps");
+    attached = nns_ex_qos_attach (g_app.qos, filter, NULL);
+    gst_object_unref (filter);
+    _check_cond_err (attached);
+  }
+
+  /* skip the static frames, checked only if the stride passes the frame */
+  if (gate_area > 0.0) {
+    g_app.gate = nns_ex_motion_gate_new (GATE_CELL_THRESHOLD,
+        (gfloat) (gate_area / 100.0), GATE_MAX_SKIP);
+
+    element = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "tensorize");
+    filter = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "tensor_filter");
+    attached = nns_ex_motion_gate_attach (g_app.gate, element, filter);
+    gst_object_unref (element);
+    gst_object_unref (filter);
+    _check_cond_err (attached);
+  }
+
   /* cairo overlay */
   element = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "tensor_res");
   g_signal_connect (element, "draw", G_CALLBACK (draw_overlay_cb), NULL);
@@ -751,6 +1164,46 @@ main (int argc, char ** argv)
   g_usleep (200 * 1000);
   gst_object_unref (element);
 
+  if (g_app.gate) {
+    nns_ex_motion_gate_get_stats (g_app.gate, &stats);
+
+    /* the gate checks the frames passed by the stride */
+    gate_skipped = stats.skipped;
+
+    g_print ("motion gate : skipped %u of %u inferences (%.1f%%), "
+        "gate %.1f us/frame, estimated CPU time saved %.1f ms\n",
+        stats.skipped, stats.frames,
+        stats.frames ? 100.0 * stats.skipped / stats.frames : 0.0,
+        stats.frames ? (gdouble) stats.gate_time / stats.frames : 0.0,
+        stats.saved_time / 1000.0);
+  }
+
+  nns_ex_track_sched_print_stats (g_app.track_sched, gate_skipped);
+
+  if (g_app.qos) {
+    nns_ex_qos_get_stats (g_app.qos, &qos_stats);
+    g_print ("qos : level %u (lowest %u), %u steps down, %u steps up, "
+        "%u late frames (max %.1f ms)\n",
+        qos_stats.level, qos_stats.max_level, qos_stats.degraded,
+        qos_stats.recovered, qos_stats.messages,
+        (gdouble) qos_stats.max_jitter / GST_MSECOND);
+  }
+
+  if (g_app.roi) {
+    nns_ex_roi_scheduler_get_stats (g_app.roi, &roi_cropped, &roi_full);
+    g_print ("region of interest : cropped %u, full frame %u\n",
+        roi_cropped, roi_full);
+  }
+
+  if (DBG) {
+    nns_ex_tensor_ring_stats_s stats;
+
+    nns_ex_tensor_ring_get_stats (g_app.ring, &stats);
+    _print_log ("tensor ring pushed %u popped %u dropped %u max occupancy %u/%u",
+        stats.pushed, stats.popped, stats.dropped, stats.max_occupancy,
+        stats.capacity);
+  }
+
 error:
   _print_log ("close app..");
 
@@ -0,0 +1,670 @@
+/**
+ * @file	nnstreamer_example_offload.c
+ * @date	19 October 2026
+ * @brief	Tensor stream example routing the frames to the local or remote inference by the latency
+ * @author	agent <agent@local>
+ * @bug		No known bugs.
+ *
+ * NNStreamer example for image classification using tensorflow-lite, with the inference offloading.
+ * The client runs the model in the device, or sends the frames to the server (remote device)
+ * and receives the results. The offload controller (nns_ex_offload) measures the latency of both routes
+ * and chooses the route meeting the target latency for each window of frames.
+ * If the remote path degrades (no response or late), the client falls back to the local inference.
+ *
+ * Pipeline (client) :
+ * videotestsrc -- nns_ex_tensorize -- output-selector -- queue -- tensor_filter -- tensor_sink (local)
+ *                                                     |
+ *                                                      -- queue -- nns_ex_tensor_pay -- tcpclientsink (port)
+ * tcpclientsrc (port + 1) -- nns_ex_tensor_depay -- tensor_sink (remote)
+ *
+ * Pipeline (server) :
+ * tcpserversrc (port) -- nns_ex_tensor_depay -- identity (delay) -- tensor_filter -- nns_ex_tensor_pay -- tcpserversink (port + 1)
+ *
+ * The results of the server keep the timestamp of the frame,
+ * and the client matches the result and the frame with the timestamp.
+ *
+ * Run example :
+ * Before running this example, GST_PLUGIN_PATH should be updated for nnstreamer plug-in.
+ * $ export GST_PLUGIN_PATH=$GST_PLUGIN_PATH:<nnstreamer plugin path>
+ *
+ * (client and the stand-in server in localhost, the server is delayed for 10 seconds after 10 seconds)
+ * $ ./nnstreamer_example_offload --delay=10 --degrade-after=10 --degrade-for=10 --degrade-delay=300
+ *
+ * (two devices)
+ * $ ./nnstreamer_example_offload --mode=server --port=5001
+ * $ ./nnstreamer_example_offload --mode=client --host=<server address> --port=5001 --target=100
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <glib.h>
+#include <gst/gst.h>
+
+#include "nns_ex_offload.h"
+#include "nns_ex_tensorize.h"
+#include "nns_ex_transport.h"
+
+/**
+ * @brief Macro for debug mode.
+ */
+#ifndef DBG
+#define DBG FALSE
+#endif
+
+/**
+ * @brief Macro for debug message.
+ */
+#define _print_log(...) if (DBG) g_message (__VA_ARGS__)
+
+/**
+ * @brief Macro to check error case.
+ */
+#define _check_cond_err(cond) \
+  do { \
+    if (!(cond)) { \
+      _print_log ("app failed! [line : %d]", __LINE__); \
+      goto error; \
+    } \
+  } while (0)
+
+/**
+ * @brief Default values of the options.
+ */
+#define DEFAULT_HOST "127.0.0.1"
+#define DEFAULT_PORT 5001
+#define DEFAULT_FRAMERATE 30
+#define DEFAULT_DURATION 30
+#define DEFAULT_TARGET 100
+#define DEFAULT_WINDOW 8
+#define DEFAULT_MODEL "./tflite_model_img/mobilenet_v1_1.0_224_quant.tflite"
+
+/**
+ * @brief Input dimension of the model.
+ */
+#define MODEL_WIDTH 224
+#define MODEL_HEIGHT 224
+
+/**
+ * @brief Data structure for app.
+ */
+typedef struct
+{
+  GMainLoop *loop; /**< main event loop */
+  GstElement *pipeline; /**< gst pipeline of the client */
+  GstElement *server; /**< gst pipeline of the server */
+  GstElement *selector; /**< output-selector to route the frames */
+  GstPad *route_pads[NNS_EX_OFFLOAD_ROUTES]; /**< src pads of output-selector for each route */
+  nns_ex_offload_route_e active; /**< active route of output-selector */
+
+  gboolean running; /**< true when app is running */
+  nns_ex_offload_s *offload; /**< offload controller */
+  volatile gint late; /**< count of the results after the timeout */
+
+  gint delay; /**< delay (in milliseconds) of the server */
+  gint degrade_delay; /**< delay (in milliseconds) of the server while degraded */
+  guint degrade_timer_id; /**< timer to change the delay of the server */
+  guint quit_timer_id; /**< timer to stop the app */
+} AppData;
+
+/**
+ * @brief Data for pipeline and result.
+ */
+static AppData g_app;
+
+/**
+ * @brief Get the current time for the offload controller.
+ */
+static GstClockTime
+_get_monotonic_time (void)
+{
+  return (GstClockTime) g_get_monotonic_time () * GST_USECOND;
+}
+
+/**
+ * @brief Free resources in app data.
+ */
+static void
+_free_app_data (void)
+{
+  guint r;
+
+  if (g_app.loop) {
+    g_main_loop_unref (g_app.loop);
+    g_app.loop = NULL;
+  }
+
+  for (r = 0; r < NNS_EX_OFFLOAD_ROUTES; r++) {
+    if (g_app.route_pads[r]) {
+      gst_object_unref (g_app.route_pads[r]);
+      g_app.route_pads[r] = NULL;
+    }
+  }
+
+  if (g_app.selector) {
+    gst_object_unref (g_app.selector);
+    g_app.selector = NULL;
+  }
+
+  if (g_app.pipeline) {
+    gst_object_unref (g_app.pipeline);
+    g_app.pipeline = NULL;
+  }
+
+  if (g_app.server) {
+    gst_object_unref (g_app.server);
+    g_app.server = NULL;
+  }
+
+  if (g_app.offload) {
+    nns_ex_offload_free (g_app.offload);
+    g_app.offload = NULL;
+  }
+}
+
+/**
+ * @brief Function to print error message.
+ */
+static void
+_parse_err_message (GstMessage * message)
+{
+  gchar *debug;
+  GError *error;
+
+  g_return_if_fail (message != NULL);
+
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_ERROR:
+      gst_message_parse_error (message, &error, &debug);
+      break;
+
+    case GST_MESSAGE_WARNING:
+      gst_message_parse_warning (message, &error, &debug);
+      break;
+
+    default:
+      return;
+  }
+
+  gst_object_default_error (GST_MESSAGE_SRC (message), error, debug);
+  g_error_free (error);
+  g_free (debug);
+}
+
+/**
+ * @brief Callback for message.
+ */
+static gboolean
+_message_cb (GstBus * bus, GstMessage * message, gpointer user_data)
+{
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_EOS:
+      _print_log ("received eos message");
+      g_main_loop_quit (g_app.loop);
+      break;
+
+    case GST_MESSAGE_ERROR:
+      _print_log ("received error message");
+      _parse_err_message (message);
+      g_main_loop_quit (g_app.loop);
+      break;
+
+    case GST_MESSAGE_WARNING:
+      _print_log ("received warning message");
+      _parse_err_message (message);
+      break;
+
+    default:
+      break;
+  }
+
+  return TRUE;
+}
+
+/**
+ * @brief Pad probe on the sink pad of output-selector, choose the route of the frame.
+ */
+static GstPadProbeReturn
+_route_probe_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  nns_ex_offload_route_e route;
+
+  route = nns_ex_offload_route (g_app.offload, GST_BUFFER_PTS (buffer),
+      _get_monotonic_time ());
+
+  /* output-selector pushes the buffer to the active pad */
+  if (route != g_app.active) {
+    g_object_set (g_app.selector, "active-pad", g_app.route_pads[route], NULL);
+    g_app.active = route;
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief Callback for tensor sink signal, the result of the local or remote inference.
+ */
+static void
+_new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
+{
+  /* the result after the timeout is already counted as a failure */
+  if (!nns_ex_offload_complete (g_app.offload, GST_BUFFER_PTS (buffer),
+          _get_monotonic_time ()))
+    g_atomic_int_inc (&g_app.late);
+}
+
+/**
+ * @brief Print the frames and latency of each route.
+ */
+static void
+_print_stats (gboolean summary)
+{
+  nns_ex_offload_stats_s stats;
+  guint r;
+
+  nns_ex_offload_get_stats (g_app.offload, &stats);
+
+  g_print ("%s route %s, switches %u, fallbacks %u, probes %u, late %d\n",
+      summary ? "[summary]" : "[stats]",
+      nns_ex_offload_route_to_string (stats.route), stats.switches,
+      stats.fallbacks, stats.probes, g_atomic_int_get (&g_app.late));
+
+  for (r = 0; r < NNS_EX_OFFLOAD_ROUTES; r++) {
+    g_print ("  %-6s: frames %u, results %u, timeouts %u, latency %6.1f ms"
+        " max %6.1f ms\n", nns_ex_offload_route_to_string (r),
+        stats.frames[r], stats.completed[r], stats.timeouts[r],
+        GST_CLOCK_TIME_IS_VALID (stats.latency[r]) ?
+        (gdouble) stats.latency[r] / GST_MSECOND : 0.0,
+        (gdouble) stats.max_latency[r] / GST_MSECOND);
+  }
+}
+
+/**
+ * @brief Timer callback to print the stats.
+ */
+static gboolean
+_timer_stats_cb (gpointer user_data)
+{
+  if (g_app.running && g_app.offload)
+    _print_stats (FALSE);
+
+  return TRUE;
+}
+
+/**
+ * @brief Timer callback to stop the app.
+ */
+static gboolean
+_timer_quit_cb (gpointer user_data)
+{
+  g_app.quit_timer_id = 0;
+  g_main_loop_quit (g_app.loop);
+  return FALSE;
+}
+
+/**
+ * @brief Set the delay of the server (emulate the slow network or the busy server).
+ */
+static void
+_set_server_delay (gint delay)
+{
+  GstElement *element;
+
+  element = gst_bin_get_by_name (GST_BIN (g_app.server), "delay");
+  if (element) {
+    g_object_set (element, "sleep-time", (guint) MAX (delay, 0) * 1000U, NULL);
+    gst_object_unref (element);
+  }
+
+  g_print ("server delay %d ms\n", delay);
+}
+
+/**
+ * @brief Timer callback to restore the delay of the server.
+ */
+static gboolean
+_timer_recover_cb (gpointer user_data)
+{
+  g_app.degrade_timer_id = 0;
+  _set_server_delay (g_app.delay);
+  return FALSE;
+}
+
+/**
+ * @brief Timer callback to degrade the server.
+ */
+static gboolean
+_timer_degrade_cb (gpointer user_data)
+{
+  gint duration = GPOINTER_TO_INT (user_data);
+
+  g_app.degrade_timer_id = 0;
+  _set_server_delay (g_app.degrade_delay);
+
+  if (duration > 0)
+    g_app.degrade_timer_id =
+        g_timeout_add_seconds (duration, _timer_recover_cb, NULL);
+
+  return FALSE;
+}
+
+/**
+ * @brief Make the pipeline description of the server.
+ */
+static gchar *
+_make_server_description (const gchar * model, gint port)
+{
+  return g_strdup_printf
+      ("tcpserversrc host=0.0.0.0 port=%d caps=" NNS_EX_TRANSPORT_CAPS " ! "
+      "nns_ex_tensor_depay ! identity name=delay sleep-time=%u ! "
+      "tensor_filter framework=tensorflow-lite model=%s ! "
+      "nns_ex_tensor_pay ! tcpserversink host=0.0.0.0 port=%d sync=false",
+      port, (guint) MAX (g_app.delay, 0) * 1000U, model, port + 1);
+}
+
+/**
+ * @brief Make the pipeline description of the client.
+ */
+static gchar *
+_make_client_description (const gchar * model, const gchar * host, gint port,
+    gint framerate)
+{
+  return g_strdup_printf
+      ("videotestsrc is-live=true ! "
+      "video/x-raw,format=I420,width=640,height=480,framerate=%d/1 ! "
+      "nns_ex_tensorize width=%d height=%d type=uint8 ! "
+      "output-selector name=route pad-negotiation-mode=all "
+      "route.src_0 ! queue leaky=2 max-size-buffers=2 ! "
+      "tensor_filter framework=tensorflow-lite model=%s ! "
+      "tensor_sink name=sink_local sync=false "
+      "route.src_1 ! queue leaky=2 max-size-buffers=2 ! "
+      "nns_ex_tensor_pay ! tcpclientsink host=%s port=%d sync=false "
+      "tcpclientsrc host=%s port=%d caps=" NNS_EX_TRANSPORT_CAPS " ! "
+      "nns_ex_tensor_depay ! tensor_sink name=sink_remote sync=false",
+      framerate, MODEL_WIDTH, MODEL_HEIGHT, model, host, port, host, port + 1);
+}
+
+/**
+ * @brief Connect the callbacks of the client pipeline.
+ */
+static gboolean
+_setup_client (void)
+{
+  GstElement *element;
+  GstPad *pad;
+  gchar *name;
+  gulong handle_id;
+  guint r;
+
+  g_app.selector = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "route");
+  if (g_app.selector == NULL)
+    return FALSE;
+
+  /* src_0 is the local inference, src_1 is the remote device */
+  for (r = 0; r < NNS_EX_OFFLOAD_ROUTES; r++) {
+    name = g_strdup_printf ("src_%u", r);
+    g_app.route_pads[r] = gst_element_get_static_pad (g_app.selector, name);
+    g_free (name);
+
+    if (g_app.route_pads[r] == NULL)
+      return FALSE;
+  }
+
+  g_app.active = NNS_EX_OFFLOAD_LOCAL;
+  g_object_set (g_app.selector, "active-pad",
+      g_app.route_pads[g_app.active], NULL);
+
+  pad = gst_element_get_static_pad (g_app.selector, "sink");
+  if (pad == NULL)
+    return FALSE;
+
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, _route_probe_cb, NULL,
+      NULL);
+  gst_object_unref (pad);
+
+  /* tensor sink signal : new data callback of each route (sink_local, sink_remote) */
+  for (r = 0; r < NNS_EX_OFFLOAD_ROUTES; r++) {
+    name = g_strdup_printf ("sink_%s", nns_ex_offload_route_to_string (r));
+    element = gst_bin_get_by_name (GST_BIN (g_app.pipeline), name);
+    g_free (name);
+
+    if (element == NULL)
+      return FALSE;
+
+    handle_id = g_signal_connect (element, "new-data",
+        (GCallback) _new_data_cb, NULL);
+    gst_object_unref (element);
+
+    if (handle_id == 0)
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+/**
+ * @brief Add the message callback to the bus of the pipeline.
+ */
+static gboolean
+_add_bus_watch (GstElement * pipeline)
+{
+  GstBus *bus;
+  guint watch_id;
+
+  bus = gst_element_get_bus (pipeline);
+  if (bus == NULL)
+    return FALSE;
+
+  watch_id = gst_bus_add_watch (bus, _message_cb, NULL);
+  gst_object_unref (bus);
+
+  return (watch_id > 0);
+}
+
+/**
+ * @brief Main function.
+ */
+int
+main (int argc, char **argv)
+{
+  gchar *mode = NULL;
+  gchar *host = NULL;
+  gchar *model = NULL;
+  gchar *prefer = NULL;
+  gint port = DEFAULT_PORT;
+  gint framerate = DEFAULT_FRAMERATE;
+  gint duration = DEFAULT_DURATION;
+  gint target = DEFAULT_TARGET;
+  gint timeout = 0;
+  gint window = DEFAULT_WINDOW;
+  gint degrade_after = 0;
+  gint degrade_for = 0;
+  gboolean run_server, run_client;
+  nns_ex_offload_route_e prefer_route;
+
+  gchar *str_pipeline;
+  guint timer_id = 0;
+  GOptionContext *optionctx;
+  GError *error = NULL;
+
+  const GOptionEntry main_entries[] = {
+    {"mode", 'M', G_OPTION_FLAG_NONE, G_OPTION_ARG_STRING, &mode,
+        "client, server, or both in localhost (stand-in server)", "both"},
+    {"host", 'H', G_OPTION_FLAG_NONE, G_OPTION_ARG_STRING, &host,
+        "Address of the server", DEFAULT_HOST},
+    {"port", 'p', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &port,
+        "Port of the frames (the results are sent to port + 1)", "5001"},
+    {"model", 'm', G_OPTION_FLAG_NONE, G_OPTION_ARG_FILENAME, &model,
+        "tflite model of the client and server", "file"},
+    {"framerate", 'r', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &framerate,
+        "Frame rate of the test source", "30"},
+    {"duration", 'd', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &duration,
+        "Seconds to run (0 to run until EOS)", "30"},
+    {"target", 't', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &target,
+        "Target latency (ms) of the result", "100"},
+    {"timeout", 'T', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &timeout,
+        "Max time (ms) to wait for the result (0 for the double of the target)",
+        "0"},
+    {"window", 'w', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &window,
+        "Frames to keep the route (1 to choose the route every frame)", "8"},
+    {"prefer", 'P', G_OPTION_FLAG_NONE, G_OPTION_ARG_STRING, &prefer,
+        "Route if both meet the target (local or remote)", "remote"},
+    {"delay", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &g_app.delay,
+        "Delay (ms) of the server for each frame", "0"},
+    {"degrade-after", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &degrade_after,
+        "Seconds to degrade the server (0 not to degrade)", "0"},
+    {"degrade-for", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &degrade_for,
+        "Seconds to keep the server degraded (0 until the end)", "0"},
+    {"degrade-delay", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_INT,
+        &g_app.degrade_delay,
+        "Delay (ms) of the server for each frame while degraded", "300"},
+    {NULL}
+  };
+
+  _print_log ("start app..");
+
+  g_app.delay = 0;
+  g_app.degrade_delay = 300;
+
+  optionctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (optionctx, main_entries, NULL);
+
+  if (!g_option_context_parse (optionctx, &argc, &argv, &error)) {
+    g_printerr ("option parsing failed: %s\n", error->message);
+    g_error_free (error);
+    g_option_context_free (optionctx);
+    return -1;
+  }
+
+  g_option_context_free (optionctx);
+
+  run_server = run_client = TRUE;
+  if (mode && g_ascii_strcasecmp (mode, "server") == 0)
+    run_client = FALSE;
+  else if (mode && g_ascii_strcasecmp (mode, "client") == 0)
+    run_server = FALSE;
+  else if (mode && g_ascii_strcasecmp (mode, "both") != 0)
+    run_server = run_client = FALSE;
+
+  prefer_route = (prefer && g_ascii_strcasecmp (prefer, "local") == 0) ?
+      NNS_EX_OFFLOAD_LOCAL : NNS_EX_OFFLOAD_REMOTE;
+
+  if (!(run_server || run_client) || port <= 0 || port >= 65535 ||
+      framerate <= 0 || target <= 0 || timeout < 0 || window <= 0) {
+    g_printerr ("invalid mode (client, server or both) or parameters\n");
+    goto error;
+  }
+
+  if (host == NULL)
+    host = g_strdup (DEFAULT_HOST);
+
+  if (model == NULL)
+    model = g_strdup (DEFAULT_MODEL);
+
+  if (access (model, F_OK) != 0) {
+    g_printerr ("cannot find tflite model [%s]\n", model);
+    goto error;
+  }
+
+  /* init gstreamer */
+  gst_init (&argc, &argv);
+  _check_cond_err (nns_ex_tensorize_register ());
+  _check_cond_err (nns_ex_tensor_pay_register ());
+  _check_cond_err (nns_ex_tensor_depay_register ());
+
+  /* main loop */
+  g_app.loop = g_main_loop_new (NULL, FALSE);
+  _check_cond_err (g_app.loop != NULL);
+
+  if (run_server) {
+    str_pipeline = _make_server_description (model, port);
+    _print_log ("%s\n", str_pipeline);
+
+    g_app.server = gst_parse_launch (str_pipeline, NULL);
+    g_free (str_pipeline);
+    _check_cond_err (g_app.server != NULL);
+    _check_cond_err (_add_bus_watch (g_app.server));
+
+    /* the server listens before the client connects */
+    gst_element_set_state (g_app.server, GST_STATE_PLAYING);
+
+    if (degrade_after > 0) {
+      g_app.degrade_timer_id = g_timeout_add_seconds (degrade_after,
+          _timer_degrade_cb, GINT_TO_POINTER (degrade_for));
+      _check_cond_err (g_app.degrade_timer_id > 0);
+    }
+  }
+
+  if (run_client) {
+    g_app.offload = nns_ex_offload_new (target * GST_MSECOND,
+        timeout * GST_MSECOND, (guint) window, prefer_route);
+    _check_cond_err (g_app.offload != NULL);
+
+    str_pipeline = _make_client_description (model, host, port, framerate);
+    _print_log ("%s\n", str_pipeline);
+
+    g_app.pipeline = gst_parse_launch (str_pipeline, NULL);
+    g_free (str_pipeline);
+    _check_cond_err (g_app.pipeline != NULL);
+    _check_cond_err (_add_bus_watch (g_app.pipeline));
+    _check_cond_err (_setup_client ());
+
+    /* timer to print the stats */
+    timer_id = g_timeout_add_seconds (1, _timer_stats_cb, NULL);
+    _check_cond_err (timer_id > 0);
+
+    gst_element_set_state (g_app.pipeline, GST_STATE_PLAYING);
+  }
+
+  if (duration > 0) {
+    g_app.quit_timer_id =
+        g_timeout_add_seconds (duration, _timer_quit_cb, NULL);
+    _check_cond_err (g_app.quit_timer_id > 0);
+  }
+
+  g_app.running = TRUE;
+
+  /* run main loop */
+  g_main_loop_run (g_app.loop);
+
+  /* quit when received eos or error message, or the duration is over */
+  g_app.running = FALSE;
+
+  if (g_app.pipeline)
+    gst_element_set_state (g_app.pipeline, GST_STATE_NULL);
+
+  if (g_app.server)
+    gst_element_set_state (g_app.server, GST_STATE_NULL);
+
+  if (g_app.offload)
+    _print_stats (TRUE);
+
+error:
+  _print_log ("close app..");
+
+  if (timer_id > 0) {
+    g_source_remove (timer_id);
+  }
+
+  if (g_app.degrade_timer_id > 0) {
+    g_source_remove (g_app.degrade_timer_id);
+    g_app.degrade_timer_id = 0;
+  }
+
+  if (g_app.quit_timer_id > 0) {
+    g_source_remove (g_app.quit_timer_id);
+    g_app.quit_timer_id = 0;
+  }
+
+  g_free (mode);
+  g_free (host);
+  g_free (model);
+  g_free (prefer);
+  _free_app_data ();
+  return 0;
+}
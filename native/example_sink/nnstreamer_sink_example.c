@@ -7,6 +7,8 @@
  * @bug		No known bugs.
  *
  * Simple example to init tensor sink element and get data.
+ * The tensor info is parsed once when the caps is negotiated (see nns_ex_tensor_sink.h),
+ * so the new-data callback only maps the memories.
  *
  * Run example :
  * Before running this example, GST_PLUGIN_PATH should be updated for nnstreamer plug-in.
@@ -19,6 +21,8 @@
 #include <gst/gst.h>
 #include <gst/app/gstappsrc.h>
 
+#include "nns_ex_tensor_sink.h"
+
 /**
  * @brief Macro for debug mode.
  */
@@ -63,6 +67,9 @@ typedef struct
 
   guint received; /**< received buffer count */
   test_media_type media_type; /**< test media type */
+
+  nns_ex_tensor_sink_s *consumer; /**< tensor sink consumer with cached tensor info */
+  guint caps_seq; /**< last negotiation count printed */
 } AppData;
 
 /**
@@ -85,6 +92,11 @@ _free_app_data (void)
     g_app.loop = NULL;
   }
 
+  if (g_app.consumer) {
+    nns_ex_tensor_sink_free (g_app.consumer);
+    g_app.consumer = NULL;
+  }
+
   if (g_app.bus) {
     gst_bus_remove_signal_watch (g_app.bus);
     gst_object_unref (g_app.bus);
@@ -147,6 +159,29 @@ _parse_caps (GstCaps * caps)
   }
 }
 
+/**
+ * @brief Function to print tensor info.
+ */
+static void
+_parse_tensors_info (const nns_ex_tensors_info_s * info)
+{
+  const nns_ex_tensor_info_s *tensor;
+  guint i;
+
+  g_return_if_fail (info != NULL);
+
+  _print_log ("num tensors %u, framerate %d/%d", info->num_tensors,
+      info->rate_n, info->rate_d);
+
+  for (i = 0; i < info->num_tensors; i++) {
+    tensor = &info->info[i];
+
+    _print_log ("[%u] type %d dim %u:%u:%u:%u size %zd", i, tensor->type,
+        tensor->dims[0], tensor->dims[1], tensor->dims[2], tensor->dims[3],
+        tensor->size);
+  }
+}
+
 /**
  * @brief Callback for message.
  */
@@ -190,56 +225,38 @@ _new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
     _print_log ("receiving new data [%d]", g_app.received);
   }
 
-  /* example to get data */
-  {
-    GstMemory *mem;
-    GstMapInfo info;
-    guint i;
-    guint num_mems;
-
-    num_mems = gst_buffer_n_memory (buffer);
-    for (i = 0; i < num_mems; i++) {
-      mem = gst_buffer_peek_memory (buffer, i);
-
-      if (gst_memory_map (mem, &info, GST_MAP_READ)) {
-        /* check data (info.data, info.size) */
-        if (g_app.media_type == TEST_TYPE_TEXT) {
-          _print_log ("received %zd [%s]", info.size, (gchar *) info.data);
-        } else {
-          _print_log ("received %zd", info.size);
-        }
+  /* tensor info is updated only when the caps is negotiated */
+  if (g_app.caps_seq != nns_ex_tensor_sink_get_caps_seq (g_app.consumer)) {
+    const nns_ex_tensors_info_s *tensors_info;
 
-        gst_memory_unmap (mem, &info);
-      }
+    g_app.caps_seq = nns_ex_tensor_sink_get_caps_seq (g_app.consumer);
+    tensors_info = nns_ex_tensor_sink_peek_info (g_app.consumer);
+
+    if (tensors_info) {
+      _parse_tensors_info (tensors_info);
     }
   }
 
-  /* example to get caps */
+  /* example to get data */
   {
-    GstPad *sink_pad;
-    GstCaps *caps;
-
-    sink_pad = gst_element_get_static_pad (element, "sink");
-
-    if (sink_pad) {
-      /* negotiated */
-      caps = gst_pad_get_current_caps (sink_pad);
-
-      if (caps) {
-        _parse_caps (caps);
-        gst_caps_unref (caps);
-      }
+    nns_ex_tensor_sink_map_s map;
+    guint i;
 
-      /* template */
-      caps = gst_pad_get_pad_template_caps (sink_pad);
+    if (!nns_ex_tensor_sink_map (g_app.consumer, buffer, &map)) {
+      _print_log ("failed to map the tensors [%d]", g_app.received);
+      return;
+    }
 
-      if (caps) {
-        _parse_caps (caps);
-        gst_caps_unref (caps);
+    for (i = 0; i < map.num_tensors; i++) {
+      /* check data (map.data[i], map.size[i]) */
+      if (g_app.media_type == TEST_TYPE_TEXT) {
+        _print_log ("received %zd [%s]", map.size[i], (gchar *) map.data[i]);
+      } else {
+        _print_log ("received %zd", map.size[i]);
       }
-
-      gst_object_unref (sink_pad);
     }
+
+    nns_ex_tensor_sink_unmap (&map);
   }
 }
 
@@ -371,6 +388,7 @@ main (int argc, char **argv)
   /* init app variable */
   g_app.received = 0;
   g_app.media_type = test_type;
+  g_app.caps_seq = 0;
 
   /* main loop and pipeline */
   g_app.loop = g_main_loop_new (NULL, FALSE);
@@ -402,6 +420,32 @@ main (int argc, char **argv)
   /* enable emit-signal, default TRUE */
   g_object_set (element, "emit-signal", (gboolean) TRUE, NULL);
 
+  /* template caps */
+  {
+    GstPad *sink_pad;
+    GstCaps *caps;
+
+    sink_pad = gst_element_get_static_pad (element, "sink");
+
+    if (sink_pad) {
+      caps = gst_pad_get_pad_template_caps (sink_pad);
+
+      if (caps) {
+        _parse_caps (caps);
+        gst_caps_unref (caps);
+      }
+
+      gst_object_unref (sink_pad);
+    }
+  }
+
+  /* parse the tensor info when the caps is negotiated */
+  g_app.consumer = nns_ex_tensor_sink_new (element);
+  if (g_app.consumer == NULL) {
+    gst_object_unref (element);
+    goto error;
+  }
+
   /* tensor sink signal : new data callback */
   handle_id = g_signal_connect (element, "new-data",
       (GCallback) _new_data_cb, NULL);
@@ -11,6 +11,9 @@
  * push buffer to appsrc
  * [2nd pipeline : appsrc-tensor_decoder-videoconvert-ximagesink]
  *
+ * The buffer from tensor_sink is forwarded to appsrc by reference (no copy).
+ * appsrc queues at most PLAYER_MAX_FRAMES frames, the new frame is dropped while the player is slow.
+ *
  * Run example :
  * Before running this example, GST_PLUGIN_PATH should be updated for nnstreamer plug-in.
  * $ export GST_PLUGIN_PATH=$GST_PLUGIN_PATH:<nnstreamer plugin path>
@@ -43,6 +46,11 @@
     } \
   } while (0)
 
+/**
+ * @brief Max number of frames queued in appsrc of player pipeline.
+ */
+#define PLAYER_MAX_FRAMES 3
+
 /**
  * @brief Data structure for app.
  */
@@ -53,9 +61,12 @@ typedef struct
   GstBus *data_bus; /**< gst bus for data pipeline */
   GstElement *player_pipeline; /**< gst pipeline for player */
   GstBus *player_bus; /**< gst bus for player pipeline */
+  GstElement *player_src; /**< appsrc of player pipeline */
 
   gboolean set_caps; /**< caps passed to player pipeline */
   guint received; /**< received buffer count */
+  guint dropped; /**< dropped buffer count while player is slow */
+  volatile gint player_full; /**< true when appsrc emits enough-data */
 } AppData;
 
 /**
@@ -74,6 +85,11 @@ _free_app_data (void)
     g_app.loop = NULL;
   }
 
+  if (g_app.player_src) {
+    gst_object_unref (g_app.player_src);
+    g_app.player_src = NULL;
+  }
+
   if (g_app.data_bus) {
     gst_bus_remove_signal_watch (g_app.data_bus);
     gst_object_unref (g_app.data_bus);
@@ -132,15 +148,10 @@ _parse_err_message (GstMessage * message)
 static void
 _data_message_cb (GstBus * bus, GstMessage * message, gpointer user_data)
 {
-  GstElement *player_src;
-
   switch (GST_MESSAGE_TYPE (message)) {
     case GST_MESSAGE_EOS:
       _print_log ("[data] received eos message");
-      player_src = gst_bin_get_by_name (GST_BIN (g_app.player_pipeline),
-          "player_src");
-      gst_app_src_end_of_stream (GST_APP_SRC (player_src));
-      gst_object_unref (player_src);
+      gst_app_src_end_of_stream (GST_APP_SRC (g_app.player_src));
       break;
 
     case GST_MESSAGE_ERROR:
@@ -201,16 +212,13 @@ _player_message_cb (GstBus * bus, GstMessage * message, gpointer user_data)
 static void
 _new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
 {
-  GstElement *player_src;
+  GstAppSrc *player_src = GST_APP_SRC (g_app.player_src);
 
   g_app.received++;
   if (g_app.received % 150 == 0) {
     _print_log ("receiving new data [%d]", g_app.received);
   }
 
-  player_src =
-      gst_bin_get_by_name (GST_BIN (g_app.player_pipeline), "player_src");
-
   if (!g_app.set_caps) {
     GstPad *sink_pad;
     GstCaps *caps;
@@ -221,7 +229,7 @@ _new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
       caps = gst_pad_get_current_caps (sink_pad);
 
       if (caps) {
-        gst_app_src_set_caps (GST_APP_SRC (player_src), caps);
+        gst_app_src_set_caps (player_src, caps);
 
         gst_caps_unref (caps);
         g_app.set_caps = TRUE;
@@ -231,8 +239,35 @@ _new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
     }
   }
 
-  gst_app_src_push_buffer (GST_APP_SRC (player_src), gst_buffer_copy (buffer));
-  gst_object_unref (player_src);
+  /* drop the frame instead of growing the queue while the player is slow */
+  if (g_atomic_int_get (&g_app.player_full)) {
+    g_app.dropped++;
+    return;
+  }
+
+  /* appsrc takes the ownership, pass a new reference of the buffer */
+  if (gst_app_src_push_buffer (player_src, gst_buffer_ref (buffer)) !=
+      GST_FLOW_OK) {
+    _print_log ("failed to push buffer [%d]", g_app.received);
+  }
+}
+
+/**
+ * @brief Callback for signal need-data, appsrc queue is drained.
+ */
+static void
+_player_need_data_cb (GstElement * element, guint length, gpointer user_data)
+{
+  g_atomic_int_set (&g_app.player_full, FALSE);
+}
+
+/**
+ * @brief Callback for signal enough-data, appsrc queue is full.
+ */
+static void
+_player_enough_data_cb (GstElement * element, gpointer user_data)
+{
+  g_atomic_int_set (&g_app.player_full, TRUE);
 }
 
 /**
@@ -254,6 +289,8 @@ main (int argc, char **argv)
   /* init app variable */
   g_app.set_caps = FALSE;
   g_app.received = 0;
+  g_app.dropped = 0;
+  g_app.player_full = FALSE;
 
   /* main loop and pipeline */
   g_app.loop = g_main_loop_new (NULL, FALSE);
@@ -303,6 +340,24 @@ main (int argc, char **argv)
   g_free (str_pipeline);
   _check_cond_err (g_app.player_pipeline != NULL);
 
+  /* appsrc to push the buffers, get the element once */
+  g_app.player_src =
+      gst_bin_get_by_name (GST_BIN (g_app.player_pipeline), "player_src");
+  _check_cond_err (g_app.player_src != NULL);
+
+  /* limit the queue of appsrc, the data pipeline is live so do not block it */
+  g_object_set (g_app.player_src,
+      "max-bytes", (guint64) width * height * 3 * PLAYER_MAX_FRAMES,
+      "block", (gboolean) FALSE, NULL);
+
+  handle_id = g_signal_connect (g_app.player_src, "need-data",
+      (GCallback) _player_need_data_cb, NULL);
+  _check_cond_err (handle_id > 0);
+
+  handle_id = g_signal_connect (g_app.player_src, "enough-data",
+      (GCallback) _player_enough_data_cb, NULL);
+  _check_cond_err (handle_id > 0);
+
   /* player message callback */
   g_app.player_bus = gst_element_get_bus (g_app.player_pipeline);
   _check_cond_err (g_app.player_bus != NULL);
@@ -323,6 +378,8 @@ main (int argc, char **argv)
   gst_element_set_state (g_app.data_pipeline, GST_STATE_NULL);
   gst_element_set_state (g_app.player_pipeline, GST_STATE_NULL);
 
+  _print_log ("total received %d, dropped %d", g_app.received, g_app.dropped);
+
 error:
   _free_app_data ();
   return 0;
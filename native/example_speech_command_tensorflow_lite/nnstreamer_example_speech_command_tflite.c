@@ -27,6 +27,8 @@
 #include <glib.h>
 #include <gst/gst.h>
 
+#include "nns_ex_topk.h"
+
 /**
  * @brief Macro for debug mode.
  */
@@ -50,6 +52,11 @@
     } \
   } while (0)
 
+/**
+ * @brief Name of the application message to notify the new result.
+ */
+#define RESULT_MESSAGE_NAME "speech-command-result"
+
 /**
  * @brief Data structure for tflite model info.
  */
@@ -69,6 +76,7 @@ typedef struct
   GMainLoop *loop; /**< main event loop */
   GstElement *pipeline; /**< gst pipeline for data stream */
   GstBus *bus; /**< gst bus for data pipeline */
+  GstElement *overlay; /**< textoverlay to show the result */
 
   gboolean running; /**< true when app is running */
   guint received; /**< received buffer count */
@@ -186,24 +194,19 @@ tflite_get_label (tflite_info_s * tflite_info, gint index)
 static void
 update_top_label_index (float *scores, guint len)
 {
-  gint i;
-  gint index = -1;
-  float max_score = .0;
+  nns_ex_topk_entry_s top;
 
   g_return_if_fail (scores != NULL);
   g_return_if_fail ((len / sizeof (float)) == g_app.tflite_info.total_labels);
 
-  for (i = 0; i < g_app.tflite_info.total_labels; i++) {
-    if (scores[i] > 0 && scores[i] > max_score) {
-      index = i;
-      max_score = scores[i];
-    }
-  }
+  if (nns_ex_topk_float32 (scores, g_app.tflite_info.total_labels, 1, 0.0f,
+          &top) == 0)
+    return;
 
   /* score threshold */
-  _print_log ("max score %f", max_score);
-  if (max_score > 0.50f) {
-    g_app.new_label_index = index;
+  _print_log ("max score %f", top.score);
+  if (top.score > 0.50f) {
+    g_app.new_label_index = top.index;
   }
 }
 
@@ -218,6 +221,11 @@ free_app_data (void)
     g_app.loop = NULL;
   }
 
+  if (g_app.overlay) {
+    gst_object_unref (g_app.overlay);
+    g_app.overlay = NULL;
+  }
+
   if (g_app.bus) {
     gst_bus_remove_signal_watch (g_app.bus);
     gst_object_unref (g_app.bus);
@@ -276,6 +284,35 @@ parse_qos_message (GstMessage * message)
       G_GUINT64_FORMAT "]", format, processed, dropped);
 }
 
+/**
+ * @brief Update the label in textoverlay with the result message.
+ * @note This is called in the main loop, the overlay is updated only when the label is changed.
+ */
+static void
+update_result (GstMessage * message)
+{
+  const GstStructure *s;
+  gchar *label;
+  gint index;
+
+  s = gst_message_get_structure (message);
+  if (!gst_structure_has_name (s, RESULT_MESSAGE_NAME))
+    return;
+
+  if (!g_app.running || !gst_structure_get_int (s, "label-index", &index))
+    return;
+
+  if (index < 0 || index == g_app.current_label_index)
+    return;
+
+  label = tflite_get_label (&g_app.tflite_info, index);
+  _print_log ("label %s", label);
+
+  /* update label */
+  g_app.current_label_index = index;
+  g_object_set (g_app.overlay, "text", (label != NULL) ? label : "", NULL);
+}
+
 /**
  * @brief Callback for message.
  */
@@ -307,6 +344,10 @@ bus_message_cb (GstBus * bus, GstMessage * message, gpointer user_data)
       parse_qos_message (message);
       break;
 
+    case GST_MESSAGE_APPLICATION:
+      update_result (message);
+      break;
+
     default:
       break;
   }
@@ -314,6 +355,9 @@ bus_message_cb (GstBus * bus, GstMessage * message, gpointer user_data)
 
 /**
  * @brief Callback for tensor sink signal.
+ *
+ * This is called in the streaming thread. Instead of polling the result with a timer,
+ * post an application message to the bus only when the label index is changed.
  */
 static void
 new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
@@ -327,6 +371,9 @@ new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
     GstMapInfo info;
     guint i;
     guint num_mems;
+    gint prev_index;
+
+    prev_index = g_app.new_label_index;
 
     num_mems = gst_buffer_n_memory (buffer);
     for (i = 0; i < num_mems; i++) {
@@ -341,35 +388,16 @@ new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
         gst_memory_unmap (mem, &info);
       }
     }
-  }
-}
-
-/**
- * @brief Timer callback to update result.
- * @return True to ensure the timer continues
- */
-static gboolean
-timer_update_result_cb (gpointer user_data)
-{
-  gchar *label = NULL;
-  GstElement *overlay;
-
-  if (g_app.running) {
-    if (g_app.new_label_index >= 0 &&
-        g_app.current_label_index != g_app.new_label_index) {
-      label = tflite_get_label (&g_app.tflite_info, g_app.new_label_index);
-      _print_log ("label %s", label);
 
-      /* update label */
-      g_app.current_label_index = g_app.new_label_index;
+    if (g_app.new_label_index != prev_index) {
+      GstStructure *s;
 
-      overlay = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "tensor_res");
-      g_object_set (overlay, "text", (label != NULL) ? label : "", NULL);
-      gst_object_unref (overlay);
+      s = gst_structure_new (RESULT_MESSAGE_NAME,
+          "label-index", G_TYPE_INT, g_app.new_label_index, NULL);
+      gst_element_post_message (element,
+          gst_message_new_application (GST_OBJECT (element), s));
     }
   }
-
-  return TRUE;
 }
 
 /**
@@ -384,7 +412,6 @@ main (int argc, char **argv)
 
   gchar *str_pipeline;
   gulong handle_id;
-  guint timer_id = 0;
   GstElement *element;
 
   _print_log ("start app..");
@@ -442,9 +469,9 @@ main (int argc, char **argv)
   gst_object_unref (element);
   _check_cond_err (handle_id > 0);
 
-  /* timer to update result */
-  timer_id = g_timeout_add (500, timer_update_result_cb, NULL);
-  _check_cond_err (timer_id > 0);
+  /* textoverlay to update result, get the element once */
+  g_app.overlay = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "tensor_res");
+  _check_cond_err (g_app.overlay != NULL);
 
   /* start pipeline */
   gst_element_set_state (g_app.pipeline, GST_STATE_PLAYING);
@@ -481,10 +508,6 @@ main (int argc, char **argv)
 error:
   _print_log ("close app..");
 
-  if (timer_id > 0) {
-    g_source_remove (timer_id);
-  }
-
   free_app_data ();
   return 0;
 }
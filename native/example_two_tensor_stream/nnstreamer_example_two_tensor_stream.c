@@ -13,10 +13,18 @@
  * $ bash get-model-image-classification-tflite.sh
  * $ bash get-model-speech-command.sh
  *
+ * The results of two streams are fused by timestamp. Each image result is paired with
+ * the speech result of which PTS is nearest within the fusion window.
+ *
  * Run example :
  * Before running this example, GST_PLUGIN_PATH should be updated for nnstreamer plug-in.
  * $ export GST_PLUGIN_PATH=$GST_PLUGIN_PATH:<nnstreamer plugin path>
- * $ ./nnstreamer_example_two_tensor_stream
+ * $ ./nnstreamer_example_two_tensor_stream [--fusion-window=<ms>] [--sched-config=<file>]
+ *
+ * The streaming thread of each branch (audio inference, image inference, display) is scheduled
+ * with its own priority, so that the display cannot starve the inference branches.
+ * The default priorities are replaced with the config file (see nns_ex_sched.h).
+ * The deadline misses of each branch are printed when the app is closed.
  */
 
 #ifndef _GNU_SOURCE
@@ -29,6 +37,9 @@
 #include <glib.h>
 #include <gst/gst.h>
 
+#include "nns_ex_sched.h"
+#include "nns_ex_topk.h"
+
 /**
  * @brief Macro for debug mode.
  */
@@ -52,6 +63,26 @@
     } \
   } while (0)
 
+/**
+ * @brief Name of the application message to notify the new result.
+ */
+#define RESULT_MESSAGE_NAME "two-tensor-stream-result"
+
+/**
+ * @brief Name of the application message to notify the fused result.
+ */
+#define FUSED_MESSAGE_NAME "two-tensor-stream-fused"
+
+/**
+ * @brief Default max distance of PTS (in milliseconds) to fuse the results.
+ */
+#define DEFAULT_FUSION_WINDOW_MS 1000
+
+/**
+ * @brief Number of recent results kept to fuse the streams (power of 2).
+ */
+#define FUSION_RING_SIZE 8
+
 /**
  * @brief Data structure for tflite model info.
  */
@@ -71,8 +102,40 @@ typedef struct
   guint received; /**< received buffer count */
   gint current_label_index; /**< current label index */
   gint new_label_index; /**< new label index */
+  GstElement *overlay; /**< textoverlay to show the result */
 } stream_info_s;
 
+/**
+ * @brief Data structure for timestamped result.
+ */
+typedef struct
+{
+  GstClockTime pts; /**< timestamp of the result */
+  gint label_index; /**< label index of the result */
+} fusion_slot_s;
+
+/**
+ * @brief Ring of recent results, written by one streaming thread and read by another.
+ * @note The ring is in the static app data, the lock does not need g_mutex_init().
+ */
+typedef struct
+{
+  GMutex lock; /**< lock of the slots and head, held only to copy a few results */
+  fusion_slot_s slots[FUSION_RING_SIZE]; /**< recent results */
+  guint head; /**< total count of written results */
+} fusion_ring_s;
+
+/**
+ * @brief Data structure for fusion of two result streams.
+ */
+typedef struct
+{
+  GstClockTime window; /**< max distance of PTS to fuse the results */
+  fusion_ring_s speech; /**< recent results of speech stream */
+  guint fused; /**< count of image results fused with speech result */
+  guint unmatched; /**< count of image results without speech result in window */
+} fusion_info_s;
+
 /**
  * @brief Data structure for app.
  */
@@ -88,6 +151,10 @@ typedef struct
 
   tflite_info_s tflite_info_img; /**< tflite model info for img */
   tflite_info_s tflite_info_speech; /**< tflite model info for speech */
+
+  fusion_info_s fusion; /**< timestamp fusion of image and speech results */
+
+  nns_ex_sched_s *sched; /**< thread scheduling of each branch */
 } AppData;
 
 /**
@@ -95,6 +162,11 @@ typedef struct
  */
 static AppData g_app;
 
+/**
+ * @brief Output quantization of the image classification model (scale 1/256, zero point 0).
+ */
+static const nns_ex_quant_s tflite_output_quant_img = { 1.0f / 256.0f, 0 };
+
 /**
  * @brief Free data in tflite info structure.
  */
@@ -208,25 +280,20 @@ _tflite_get_label (tflite_info_s * tflite_info, gint index)
 static void
 _update_top_label_index_speech (float *scores, guint len)
 {
-  gint i;
-  gint index = -1;
-  float max_score = .0;
+  nns_ex_topk_entry_s top;
 
   g_return_if_fail (scores != NULL);
   g_return_if_fail ((len / sizeof (float)) ==
       g_app.tflite_info_speech.total_labels);
 
-  for (i = 0; i < g_app.tflite_info_speech.total_labels; i++) {
-    if (scores[i] > 0 && scores[i] > max_score) {
-      index = i;
-      max_score = scores[i];
-    }
-  }
+  if (nns_ex_topk_float32 (scores, g_app.tflite_info_speech.total_labels, 1,
+          0.0f, &top) == 0)
+    return;
 
   /* score threshold */
-  _print_log ("max score %f", max_score);
-  if (max_score > 0.50f) {
-    g_app.stream_info_speech.new_label_index = index;
+  _print_log ("max score %f", top.score);
+  if (top.score > 0.50f) {
+    g_app.stream_info_speech.new_label_index = top.index;
   }
 }
 
@@ -239,24 +306,14 @@ _update_top_label_index_speech (float *scores, guint len)
 static void
 _update_top_label_index_img (guint8 * scores, guint len)
 {
-  gint i;
-  gint index = -1;
-  guint8 max_score = 0;
-
   /* -1 if failed to get max score index */
   g_app.stream_info_img.new_label_index = -1;
 
   g_return_if_fail (scores != NULL);
   g_return_if_fail (len == g_app.tflite_info_img.total_labels);
 
-  for (i = 0; i < len; i++) {
-    if (scores[i] > 0 && scores[i] > max_score) {
-      index = i;
-      max_score = scores[i];
-    }
-  }
-
-  g_app.stream_info_img.new_label_index = index;
+  g_app.stream_info_img.new_label_index =
+      nns_ex_argmax_uint8 (scores, len, &tflite_output_quant_img, 0.0f);
 }
 
 /**
@@ -270,6 +327,21 @@ _free_app_data (void)
     g_app.loop = NULL;
   }
 
+  if (g_app.stream_info_img.overlay) {
+    gst_object_unref (g_app.stream_info_img.overlay);
+    g_app.stream_info_img.overlay = NULL;
+  }
+
+  if (g_app.stream_info_speech.overlay) {
+    gst_object_unref (g_app.stream_info_speech.overlay);
+    g_app.stream_info_speech.overlay = NULL;
+  }
+
+  if (g_app.sched) {
+    nns_ex_sched_free (g_app.sched);
+    g_app.sched = NULL;
+  }
+
   if (g_app.bus) {
     gst_bus_remove_signal_watch (g_app.bus);
     gst_object_unref (g_app.bus);
@@ -329,6 +401,166 @@ _parse_qos_message (GstMessage * message)
       G_GUINT64_FORMAT "]", format, processed, dropped);
 }
 
+/**
+ * @brief Push new result into the ring.
+ * @note Only one thread (the streaming thread of a sink) writes the ring.
+ */
+static void
+_fusion_ring_push (fusion_ring_s * ring, GstClockTime pts, gint label_index)
+{
+  fusion_slot_s *slot;
+
+  g_mutex_lock (&ring->lock);
+  slot = &ring->slots[ring->head & (FUSION_RING_SIZE - 1)];
+  slot->pts = pts;
+  slot->label_index = label_index;
+  ring->head++;
+  g_mutex_unlock (&ring->lock);
+}
+
+/**
+ * @brief Find the result of which PTS is nearest to given PTS within the window.
+ * @return TRUE if found
+ */
+static gboolean
+_fusion_ring_find (fusion_ring_s * ring, GstClockTime pts,
+    GstClockTime window, gint * label_index, GstClockTimeDiff * diff)
+{
+  fusion_slot_s slots[FUSION_RING_SIZE];
+  GstClockTimeDiff d;
+  guint head, i, n;
+  gboolean found = FALSE;
+
+  /* copy the recent results, not to block the writer while searching */
+  g_mutex_lock (&ring->lock);
+  head = ring->head;
+  n = MIN (head, FUSION_RING_SIZE);
+  for (i = 1; i <= n; i++)
+    slots[i - 1] = ring->slots[(head - i) & (FUSION_RING_SIZE - 1)];
+  g_mutex_unlock (&ring->lock);
+
+  for (i = 0; i < n; i++) {
+    if (!GST_CLOCK_TIME_IS_VALID (slots[i].pts))
+      continue;
+
+    d = GST_CLOCK_DIFF (slots[i].pts, pts);
+    if ((GstClockTime) ABS (d) > window)
+      continue;
+
+    if (!found || ABS (d) < ABS (*diff)) {
+      *label_index = slots[i].label_index;
+      *diff = d;
+      found = TRUE;
+    }
+  }
+
+  return found;
+}
+
+/**
+ * @brief Fuse the image result with speech result and post the combined result.
+ * @note This is called in the streaming thread of image stream, for each image result.
+ */
+static void
+_fusion_post_result (GstElement * element, GstClockTime pts, gint img_index)
+{
+  GstStructure *s;
+  GstClockTimeDiff diff = 0;
+  gint speech_index = -1;
+
+  if (!GST_CLOCK_TIME_IS_VALID (pts))
+    return;
+
+  if (_fusion_ring_find (&g_app.fusion.speech, pts, g_app.fusion.window,
+          &speech_index, &diff)) {
+    g_app.fusion.fused++;
+  } else {
+    g_app.fusion.unmatched++;
+  }
+
+  s = gst_structure_new (FUSED_MESSAGE_NAME,
+      "pts", G_TYPE_UINT64, pts,
+      "image-index", G_TYPE_INT, img_index,
+      "speech-index", G_TYPE_INT, speech_index,
+      "diff", G_TYPE_INT64, diff, NULL);
+  gst_element_post_message (element,
+      gst_message_new_application (GST_OBJECT (element), s));
+}
+
+/**
+ * @brief Handle the fused result of image and speech.
+ * @note This is called in the main loop. Add the multimodal trigger here.
+ */
+static void
+_update_fused_result (const GstStructure * s)
+{
+  guint64 pts;
+  GstClockTimeDiff diff;
+  gint img_index, speech_index;
+  gchar *img_label, *speech_label;
+
+  if (!gst_structure_get_uint64 (s, "pts", &pts) ||
+      !gst_structure_get_int (s, "image-index", &img_index) ||
+      !gst_structure_get_int (s, "speech-index", &speech_index) ||
+      !gst_structure_get_int64 (s, "diff", &diff))
+    return;
+
+  img_label = (img_index >= 0) ?
+      _tflite_get_label (&g_app.tflite_info_img, img_index) : NULL;
+  speech_label = (speech_index >= 0) ?
+      _tflite_get_label (&g_app.tflite_info_speech, speech_index) : NULL;
+
+  _print_log ("fused [%" GST_TIME_FORMAT "] image [%s] speech [%s] diff %"
+      G_GINT64_FORMAT " ms", GST_TIME_ARGS (pts), GST_STR_NULL (img_label),
+      GST_STR_NULL (speech_label), GST_TIME_AS_MSECONDS (diff));
+}
+
+/**
+ * @brief Update the label in textoverlay with the result message.
+ * @note This is called in the main loop, the overlay is updated only when the label is changed.
+ */
+static void
+_update_result (GstMessage * message)
+{
+  const GstStructure *s;
+  stream_info_s *stream_info;
+  tflite_info_s *tflite_info;
+  gchar *label;
+  gboolean is_img;
+  gint index;
+
+  s = gst_message_get_structure (message);
+  if (gst_structure_has_name (s, FUSED_MESSAGE_NAME)) {
+    if (g_app.running)
+      _update_fused_result (s);
+    return;
+  }
+
+  if (!gst_structure_has_name (s, RESULT_MESSAGE_NAME))
+    return;
+
+  if (!g_app.running ||
+      !gst_structure_get_boolean (s, "is-image", &is_img) ||
+      !gst_structure_get_int (s, "label-index", &index))
+    return;
+
+  if (is_img) {
+    stream_info = &g_app.stream_info_img;
+    tflite_info = &g_app.tflite_info_img;
+  } else {
+    stream_info = &g_app.stream_info_speech;
+    tflite_info = &g_app.tflite_info_speech;
+  }
+
+  if (index < 0 || index == stream_info->current_label_index)
+    return;
+
+  stream_info->current_label_index = index;
+  label = _tflite_get_label (tflite_info, index);
+  g_object_set (stream_info->overlay, "text", (label != NULL) ? label : "",
+      NULL);
+}
+
 /**
  * @brief Callback for message.
  */
@@ -360,6 +592,10 @@ _message_cb (GstBus * bus, GstMessage * message, gpointer user_data)
       _parse_qos_message (message);
       break;
 
+    case GST_MESSAGE_APPLICATION:
+      _update_result (message);
+      break;
+
     default:
       break;
   }
@@ -367,25 +603,30 @@ _message_cb (GstBus * bus, GstMessage * message, gpointer user_data)
 
 /**
  * @brief Callback for tensor sink signal.
+ *
+ * This is called in the streaming thread. Instead of polling the result with a timer,
+ * post an application message to the bus only when the label index is changed.
  */
 static void
 _new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
 {
   gboolean isImg = GPOINTER_TO_INT (user_data);
+  stream_info_s *stream_info;
+
+  stream_info = (isImg) ? &g_app.stream_info_img : &g_app.stream_info_speech;
 
   /* print progress */
-  if (isImg) {
-    g_app.stream_info_img.received++;
-    _print_log ("receiving new data [%d]", g_app.stream_info_img.received);
-  } else {
-    g_app.stream_info_speech.received++;
-    _print_log ("receiving new data [%d]", g_app.stream_info_speech.received);
-  }
+  stream_info->received++;
+  _print_log ("receiving new data [%d]", stream_info->received);
+
   if (g_app.running) {
     GstMemory *mem;
     GstMapInfo info;
     guint i;
     guint num_mems;
+    gint prev_index;
+
+    prev_index = stream_info->new_label_index;
 
     num_mems = gst_buffer_n_memory (buffer);
     for (i = 0; i < num_mems; i++) {
@@ -403,44 +644,58 @@ _new_data_cb (GstElement * element, GstBuffer * buffer, gpointer user_data)
         gst_memory_unmap (mem, &info);
       }
     }
+
+    /* keep speech results with timestamp, fuse with image result per frame */
+    if (isImg) {
+      _fusion_post_result (element, GST_BUFFER_PTS (buffer),
+          stream_info->new_label_index);
+    } else if (stream_info->new_label_index >= 0) {
+      _fusion_ring_push (&g_app.fusion.speech, GST_BUFFER_PTS (buffer),
+          stream_info->new_label_index);
+    }
+
+    if (stream_info->new_label_index != prev_index) {
+      GstStructure *s;
+
+      s = gst_structure_new (RESULT_MESSAGE_NAME,
+          "is-image", G_TYPE_BOOLEAN, isImg,
+          "label-index", G_TYPE_INT, stream_info->new_label_index, NULL);
+      gst_element_post_message (element,
+          gst_message_new_application (GST_OBJECT (element), s));
+    }
   }
 }
 
 /**
- * @brief Timer callback for textoverlay.
- * @return True to ensure the timer continues
+ * @brief Set the default scheduling of each branch.
+ * @note Lower nice value (higher priority) needs the privilege, so the default only lowers the display.
  */
 static gboolean
-_timer_update_result_cb (gpointer user_data)
+_sched_init_default (nns_ex_sched_s * sched)
 {
-  gboolean isImg = GPOINTER_TO_INT (user_data);
-  if (g_app.running) {
-    GstElement *overlay;
-    gchar *label = NULL;
-    gchar *bin_name = NULL;
-    stream_info_s stream_info;
-    tflite_info_s tflite_info;
+  /* audio inference, the result is updated every 200ms with 1s of samples */
+  if (!nns_ex_sched_add_branch (sched, "audio", "q_audio",
+          "tensor_sink_speech", NULL, NNS_EX_SCHED_POLICY_OTHER, 0,
+          1000 * GST_MSECOND))
+    return FALSE;
 
-    if (isImg) {
-      stream_info = g_app.stream_info_img;
-      tflite_info = g_app.tflite_info_img;
-      bin_name = "tensor_res";
-    } else {
-      stream_info = g_app.stream_info_speech;
-      tflite_info = g_app.tflite_info_speech;
-      bin_name = "overlay";
-    }
-    if (stream_info.new_label_index >= 0 &&
-        stream_info.current_label_index != stream_info.new_label_index) {
-      stream_info.current_label_index = stream_info.new_label_index;
-      label = _tflite_get_label (&tflite_info, stream_info.current_label_index);
-      overlay = gst_bin_get_by_name (GST_BIN (g_app.pipeline), bin_name);
-      g_object_set (overlay, "text", (label != NULL) ? label : "", NULL);
-      gst_object_unref (overlay);
-    }
-  }
+  /* image inference */
+  if (!nns_ex_sched_add_branch (sched, "image", "q_image", "tensor_sink",
+          NULL, NNS_EX_SCHED_POLICY_OTHER, 5, 200 * GST_MSECOND))
+    return FALSE;
 
-  return TRUE;
+  /* display, compositor thread renders the frames */
+  if (!nns_ex_sched_add_branch (sched, "display", "mix", "img_sink", NULL,
+          NNS_EX_SCHED_POLICY_OTHER, 10, 100 * GST_MSECOND))
+    return FALSE;
+
+  /* video and audio visualization to the compositor */
+  if (!nns_ex_sched_add_branch (sched, "overlay", "q_display", NULL, NULL,
+          NNS_EX_SCHED_POLICY_OTHER, 10, GST_CLOCK_TIME_NONE))
+    return FALSE;
+
+  return nns_ex_sched_add_branch (sched, "visualizer", "q_audio_display",
+      NULL, NULL, NNS_EX_SCHED_POLICY_OTHER, 10, GST_CLOCK_TIME_NONE);
 }
 
 /**
@@ -455,12 +710,38 @@ main (int argc, char **argv)
 
   gchar *str_pipeline;
   gulong handle_id;
-  guint timer_id = 0;
-  guint timer_id_speech = 0;
   GstElement *element;
+  gint fusion_window = DEFAULT_FUSION_WINDOW_MS;
+  gchar *sched_config = NULL;
+  GOptionContext *optionctx;
+  GError *error = NULL;
+
+  const GOptionEntry main_entries[] = {
+    {"fusion-window", 'w', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT,
+          &fusion_window,
+          "Max distance of timestamp (ms) to fuse image and speech results",
+        "ms"},
+    {"sched-config", 's', G_OPTION_FLAG_NONE, G_OPTION_ARG_FILENAME,
+          &sched_config,
+          "Config file for thread scheduling of each branch",
+        "file"},
+    {NULL}
+  };
 
   _print_log ("start app..");
 
+  optionctx = g_option_context_new (NULL);
+  g_option_context_add_main_entries (optionctx, main_entries, NULL);
+
+  if (!g_option_context_parse (optionctx, &argc, &argv, &error)) {
+    g_printerr ("option parsing failed: %s\n", error->message);
+    g_error_free (error);
+    g_option_context_free (optionctx);
+    return -1;
+  }
+
+  g_option_context_free (optionctx);
+
   /* init app variable */
   g_app.running = FALSE;
   g_app.stream_info_img.received = 0;
@@ -469,6 +750,24 @@ main (int argc, char **argv)
   g_app.stream_info_speech.received = 0;
   g_app.stream_info_speech.current_label_index = -1;
   g_app.stream_info_speech.new_label_index = -1;
+  g_app.fusion.window = MAX (fusion_window, 0) * GST_MSECOND;
+  g_app.fusion.fused = 0;
+  g_app.fusion.unmatched = 0;
+
+  /* thread scheduling of each branch */
+  g_app.sched = nns_ex_sched_new ();
+  if (sched_config) {
+    if (!nns_ex_sched_load_config (g_app.sched, sched_config, &error)) {
+      g_printerr ("failed to load %s: %s\n", sched_config,
+          error ? error->message : "invalid config");
+      g_clear_error (&error);
+      g_free (sched_config);
+      goto error;
+    }
+    g_free (sched_config);
+  } else {
+    _check_cond_err (_sched_init_default (g_app.sched));
+  }
 
   _check_cond_err (_tflite_init_info (&g_app.tflite_info_img, tflite_model_path,
           IS_IMG));
@@ -487,13 +786,13 @@ main (int argc, char **argv)
       g_strdup_printf
       ("v4l2src name=cam_src ! videoconvert ! videorate ! videoscale ! "
       "video/x-raw,width=600,height=450,format=RGB,framerate=25/1 ! tee name=t_raw "
-      "t_raw. ! queue ! textoverlay name=tensor_res font-desc=Sans,24 ! "
-      "compositor name=mix ! videoconvert ! videoscale ! ximagesink "
-      "t_raw. ! queue leaky=2 max-size-buffers=2 ! videoscale ! tensor_converter ! "
+      "t_raw. ! queue name=q_display ! textoverlay name=tensor_res font-desc=Sans,24 ! "
+      "compositor name=mix ! videoconvert ! videoscale ! ximagesink name=img_sink "
+      "t_raw. ! queue name=q_image leaky=2 max-size-buffers=2 ! videoscale ! tensor_converter ! "
       "tensor_filter framework=tensorflow-lite model=%s ! tensor_sink name=tensor_sink "
       "alsasrc name=audio_src ! audioconvert ! audio/x-raw,rate=16000,format=S16LE,channels=1 ! tee name=t_r "
-      "t_r. ! queue ! goom ! textoverlay name=overlay font-desc=Sans,24 ! mix. "
-      "t_r. ! queue ! tensor_converter frames-per-tensor=1600 ! "
+      "t_r. ! queue name=q_audio_display ! goom ! textoverlay name=overlay font-desc=Sans,24 ! mix. "
+      "t_r. ! queue name=q_audio ! tensor_converter frames-per-tensor=1600 ! "
       "tensor_aggregator frames-in=1600 frames-out=16000 frames-flush=3200 frames-dim=1 ! "
       "tensor_transform mode=arithmetic option=typecast:float32,div:32767.0 ! "
       "tensor_filter framework=custom model=./libnnscustom_speech_command_tflite.so ! "
@@ -537,13 +836,17 @@ main (int argc, char **argv)
   gst_object_unref (element);
   _check_cond_err (handle_id > 0);
 
-  /* timer to update result */
-  timer_id =
-      g_timeout_add (500, _timer_update_result_cb, GINT_TO_POINTER (IS_IMG));
-  _check_cond_err (timer_id > 0);
-  timer_id_speech =
-      g_timeout_add (500, _timer_update_result_cb, GINT_TO_POINTER (!IS_IMG));
-  _check_cond_err (timer_id_speech > 0);
+  /* textoverlay to update result, get the elements once */
+  g_app.stream_info_img.overlay =
+      gst_bin_get_by_name (GST_BIN (g_app.pipeline), "tensor_res");
+  _check_cond_err (g_app.stream_info_img.overlay != NULL);
+
+  g_app.stream_info_speech.overlay =
+      gst_bin_get_by_name (GST_BIN (g_app.pipeline), "overlay");
+  _check_cond_err (g_app.stream_info_speech.overlay != NULL);
+
+  /* attach the scheduler before the streaming threads start */
+  _check_cond_err (nns_ex_sched_attach (g_app.sched, g_app.pipeline));
 
   /* start pipeline */
   gst_element_set_state (g_app.pipeline, GST_STATE_PLAYING);
@@ -575,6 +878,11 @@ main (int argc, char **argv)
   /* quit when received eos or error message */
   g_app.running = FALSE;
 
+  _print_log ("fused results %u, image results without speech %u",
+      g_app.fusion.fused, g_app.fusion.unmatched);
+
+  nns_ex_sched_print_stats (g_app.sched);
+
   /* cam source element */
   element = gst_bin_get_by_name (GST_BIN (g_app.pipeline), "cam_src");
 
@@ -592,10 +900,6 @@ main (int argc, char **argv)
 error:
   _print_log ("close app..");
 
-  if (timer_id > 0) {
-    g_source_remove (timer_id);
-  }
-
   _free_app_data ();
   return 0;
 }